@@ -0,0 +1,590 @@
+﻿#include "D3D11GraphicsDevice.h"
+
+#ifdef _WIN32
+
+#include <iostream>
+
+#include <dxgi1_5.h>
+
+
+//-----------------------------------------------//
+//-------------------SWAPCHAIN-------------------//
+//-----------------------------------------------//
+D3D11GraphicsSwapChain::D3D11GraphicsSwapChain(IDXGISwapChain* _swapChain) : swapChain{ _swapChain }
+{
+    DXGI_SWAP_CHAIN_DESC desc{};
+    swapChain->GetDesc(&desc);
+    if ((desc.Flags & DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT) && FAILED(swapChain->QueryInterface(IID_PPV_ARGS(&swapChain2))))
+    {
+        swapChain2 = nullptr;
+    }
+}
+
+D3D11GraphicsSwapChain::~D3D11GraphicsSwapChain()
+{
+    if (swapChain2) { swapChain2->Release(); }
+    if (swapChain) { swapChain->Release(); }
+}
+
+HRESULT D3D11GraphicsSwapChain::GetBuffer(UINT buffer, ID3D11Texture2D** texture)
+{
+    return swapChain->GetBuffer(buffer, IID_PPV_ARGS(texture));
+}
+
+HRESULT D3D11GraphicsSwapChain::Present(UINT syncInterval, UINT flags)
+{
+    return swapChain->Present(syncInterval, flags);
+}
+
+HRESULT D3D11GraphicsSwapChain::ResizeBuffers(UINT bufferCount, UINT width, UINT height, DXGI_FORMAT format, UINT flags)
+{
+    return swapChain->ResizeBuffers(bufferCount, width, height, format, flags);
+}
+
+HANDLE D3D11GraphicsSwapChain::GetFrameLatencyWaitableObject()
+{
+    return (swapChain2) ? (swapChain2->GetFrameLatencyWaitableObject()) : (nullptr);
+}
+
+HRESULT D3D11GraphicsSwapChain::SetMaximumFrameLatency(UINT maxLatency)
+{
+    return (swapChain2) ? (swapChain2->SetMaximumFrameLatency(maxLatency)) : (DXGI_ERROR_INVALID_CALL);
+}
+//-----------------------------------------------//
+//---------------END OF SWAPCHAIN----------------//
+//-----------------------------------------------//
+
+
+
+//-----------------------------------------------//
+//--------------------CONTEXT--------------------//
+//-----------------------------------------------//
+D3D11GraphicsContext::D3D11GraphicsContext(ID3D11DeviceContext* _context) : context{ _context }
+{
+    if (FAILED(context->QueryInterface(IID_PPV_ARGS(&context1)))) { context1 = nullptr; }
+}
+
+D3D11GraphicsContext::~D3D11GraphicsContext()
+{
+    if (context1) { context1->Release(); }
+    if (context) { context->Release(); }
+}
+
+void D3D11GraphicsContext::ClearState()
+{
+    context->ClearState();
+}
+
+void D3D11GraphicsContext::OMSetRenderTargets(UINT numViews, ID3D11RenderTargetView* const* renderTargetViews, ID3D11DepthStencilView* depthStencilView)
+{
+    context->OMSetRenderTargets(numViews, renderTargetViews, depthStencilView);
+}
+
+void D3D11GraphicsContext::OMSetRenderTargetsAndUnorderedAccessViews(UINT numRTVs, ID3D11RenderTargetView* const* renderTargetViews, ID3D11DepthStencilView* depthStencilView, UINT uavStartSlot, UINT numUAVs, ID3D11UnorderedAccessView* const* unorderedAccessViews, const UINT* initialCounts)
+{
+    context->OMSetRenderTargetsAndUnorderedAccessViews(numRTVs, renderTargetViews, depthStencilView, uavStartSlot, numUAVs, unorderedAccessViews, initialCounts);
+}
+
+void D3D11GraphicsContext::OMSetBlendState(ID3D11BlendState* blendState, const FLOAT blendFactor[4], UINT sampleMask)
+{
+    context->OMSetBlendState(blendState, blendFactor, sampleMask);
+}
+
+void D3D11GraphicsContext::OMSetDepthStencilState(ID3D11DepthStencilState* depthStencilState, UINT stencilRef)
+{
+    context->OMSetDepthStencilState(depthStencilState, stencilRef);
+}
+
+void D3D11GraphicsContext::SetShaderResources(PIPELINE_STAGE stage, UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* shaderResourceViews)
+{
+    switch (stage)
+    {
+    case (PIPELINE_STAGE::VERTEX_SHADER):   context->VSSetShaderResources(startSlot, numViews, shaderResourceViews); break;
+    case (PIPELINE_STAGE::DOMAIN_SHADER):   context->DSSetShaderResources(startSlot, numViews, shaderResourceViews); break;
+    case (PIPELINE_STAGE::HULL_SHADER):     context->HSSetShaderResources(startSlot, numViews, shaderResourceViews); break;
+    case (PIPELINE_STAGE::GEOMETRY_SHADER): context->GSSetShaderResources(startSlot, numViews, shaderResourceViews); break;
+    case (PIPELINE_STAGE::PIXEL_SHADER):    context->PSSetShaderResources(startSlot, numViews, shaderResourceViews); break;
+    case (PIPELINE_STAGE::COMPUTE_SHADER):  context->CSSetShaderResources(startSlot, numViews, shaderResourceViews); break;
+    default:
+    {
+        std::cerr << "ERROR::D3D11_GRAPHICS_CONTEXT::SET_SHADER_RESOURCES::PROVIDED_STAGE_NOT_IN_ENUM" << std::endl;
+    }
+    }
+}
+
+void D3D11GraphicsContext::SetConstantBuffers(PIPELINE_STAGE stage, UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers)
+{
+    switch (stage)
+    {
+    case (PIPELINE_STAGE::VERTEX_SHADER):   context->VSSetConstantBuffers(startSlot, numBuffers, constantBuffers); break;
+    case (PIPELINE_STAGE::DOMAIN_SHADER):   context->DSSetConstantBuffers(startSlot, numBuffers, constantBuffers); break;
+    case (PIPELINE_STAGE::HULL_SHADER):     context->HSSetConstantBuffers(startSlot, numBuffers, constantBuffers); break;
+    case (PIPELINE_STAGE::GEOMETRY_SHADER): context->GSSetConstantBuffers(startSlot, numBuffers, constantBuffers); break;
+    case (PIPELINE_STAGE::PIXEL_SHADER):    context->PSSetConstantBuffers(startSlot, numBuffers, constantBuffers); break;
+    case (PIPELINE_STAGE::COMPUTE_SHADER):  context->CSSetConstantBuffers(startSlot, numBuffers, constantBuffers); break;
+    default:
+    {
+        std::cerr << "ERROR::D3D11_GRAPHICS_CONTEXT::SET_CONSTANT_BUFFERS::PROVIDED_STAGE_NOT_IN_ENUM" << std::endl;
+    }
+    }
+}
+
+void D3D11GraphicsContext::SetConstantBuffers1(PIPELINE_STAGE stage, UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers, const UINT* firstConstants, const UINT* numConstants)
+{
+    if (!context1)
+    {
+        std::cerr << "ERROR::D3D11_GRAPHICS_CONTEXT::SET_CONSTANT_BUFFERS_1::REQUIRES_D3D11_1_RUNTIME" << std::endl;
+        return;
+    }
+
+    switch (stage)
+    {
+    case (PIPELINE_STAGE::VERTEX_SHADER):   context1->VSSetConstantBuffers1(startSlot, numBuffers, constantBuffers, firstConstants, numConstants); break;
+    case (PIPELINE_STAGE::DOMAIN_SHADER):   context1->DSSetConstantBuffers1(startSlot, numBuffers, constantBuffers, firstConstants, numConstants); break;
+    case (PIPELINE_STAGE::HULL_SHADER):     context1->HSSetConstantBuffers1(startSlot, numBuffers, constantBuffers, firstConstants, numConstants); break;
+    case (PIPELINE_STAGE::GEOMETRY_SHADER): context1->GSSetConstantBuffers1(startSlot, numBuffers, constantBuffers, firstConstants, numConstants); break;
+    case (PIPELINE_STAGE::PIXEL_SHADER):    context1->PSSetConstantBuffers1(startSlot, numBuffers, constantBuffers, firstConstants, numConstants); break;
+    case (PIPELINE_STAGE::COMPUTE_SHADER):  context1->CSSetConstantBuffers1(startSlot, numBuffers, constantBuffers, firstConstants, numConstants); break;
+    default:
+    {
+        std::cerr << "ERROR::D3D11_GRAPHICS_CONTEXT::SET_CONSTANT_BUFFERS_1::PROVIDED_STAGE_NOT_IN_ENUM" << std::endl;
+    }
+    }
+}
+
+void D3D11GraphicsContext::SetSamplers(PIPELINE_STAGE stage, UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* samplerStates)
+{
+    switch (stage)
+    {
+    case (PIPELINE_STAGE::VERTEX_SHADER):   context->VSSetSamplers(startSlot, numSamplers, samplerStates); break;
+    case (PIPELINE_STAGE::DOMAIN_SHADER):   context->DSSetSamplers(startSlot, numSamplers, samplerStates); break;
+    case (PIPELINE_STAGE::HULL_SHADER):     context->HSSetSamplers(startSlot, numSamplers, samplerStates); break;
+    case (PIPELINE_STAGE::GEOMETRY_SHADER): context->GSSetSamplers(startSlot, numSamplers, samplerStates); break;
+    case (PIPELINE_STAGE::PIXEL_SHADER):    context->PSSetSamplers(startSlot, numSamplers, samplerStates); break;
+    case (PIPELINE_STAGE::COMPUTE_SHADER):  context->CSSetSamplers(startSlot, numSamplers, samplerStates); break;
+    default:
+    {
+        std::cerr << "ERROR::D3D11_GRAPHICS_CONTEXT::SET_SAMPLERS::PROVIDED_STAGE_NOT_IN_ENUM" << std::endl;
+    }
+    }
+}
+
+void D3D11GraphicsContext::CSSetUnorderedAccessViews(UINT startSlot, UINT numUAVs, ID3D11UnorderedAccessView* const* unorderedAccessViews, const UINT* initialCounts)
+{
+    context->CSSetUnorderedAccessViews(startSlot, numUAVs, unorderedAccessViews, initialCounts);
+}
+
+void D3D11GraphicsContext::VSSetShader(ID3D11VertexShader* vertexShader)
+{
+    context->VSSetShader(vertexShader, nullptr, 0);
+}
+
+void D3D11GraphicsContext::PSSetShader(ID3D11PixelShader* pixelShader)
+{
+    context->PSSetShader(pixelShader, nullptr, 0);
+}
+
+void D3D11GraphicsContext::CSSetShader(ID3D11ComputeShader* computeShader)
+{
+    context->CSSetShader(computeShader, nullptr, 0);
+}
+
+void D3D11GraphicsContext::IASetVertexBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* vertexBuffers, const UINT* strides, const UINT* offsets)
+{
+    context->IASetVertexBuffers(startSlot, numBuffers, vertexBuffers, strides, offsets);
+}
+
+void D3D11GraphicsContext::IASetIndexBuffer(ID3D11Buffer* indexBuffer, DXGI_FORMAT format, UINT offset)
+{
+    context->IASetIndexBuffer(indexBuffer, format, offset);
+}
+
+void D3D11GraphicsContext::IASetInputLayout(ID3D11InputLayout* inputLayout)
+{
+    context->IASetInputLayout(inputLayout);
+}
+
+void D3D11GraphicsContext::IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology)
+{
+    context->IASetPrimitiveTopology(topology);
+}
+
+void D3D11GraphicsContext::RSSetViewports(UINT numViewports, const D3D11_VIEWPORT* viewports)
+{
+    context->RSSetViewports(numViewports, viewports);
+}
+
+void D3D11GraphicsContext::RSSetState(ID3D11RasterizerState* rasterizerState)
+{
+    context->RSSetState(rasterizerState);
+}
+
+void D3D11GraphicsContext::Draw(UINT vertexCount, UINT startVertexLocation)
+{
+    context->Draw(vertexCount, startVertexLocation);
+}
+
+void D3D11GraphicsContext::DrawIndexed(UINT indexCount, UINT startIndexLocation, INT baseVertexLocation)
+{
+    context->DrawIndexed(indexCount, startIndexLocation, baseVertexLocation);
+}
+
+void D3D11GraphicsContext::DrawInstanced(UINT vertexCountPerInstance, UINT instanceCount, UINT startVertexLocation, UINT startInstanceLocation)
+{
+    context->DrawInstanced(vertexCountPerInstance, instanceCount, startVertexLocation, startInstanceLocation);
+}
+
+void D3D11GraphicsContext::DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount, UINT startIndexLocation, INT baseVertexLocation, UINT startInstanceLocation)
+{
+    context->DrawIndexedInstanced(indexCountPerInstance, instanceCount, startIndexLocation, baseVertexLocation, startInstanceLocation);
+}
+
+void D3D11GraphicsContext::DrawInstancedIndirect(ID3D11Buffer* argsBuffer, UINT alignedByteOffset)
+{
+    context->DrawInstancedIndirect(argsBuffer, alignedByteOffset);
+}
+
+void D3D11GraphicsContext::DrawIndexedInstancedIndirect(ID3D11Buffer* argsBuffer, UINT alignedByteOffset)
+{
+    context->DrawIndexedInstancedIndirect(argsBuffer, alignedByteOffset);
+}
+
+void D3D11GraphicsContext::Dispatch(UINT threadGroupCountX, UINT threadGroupCountY, UINT threadGroupCountZ)
+{
+    context->Dispatch(threadGroupCountX, threadGroupCountY, threadGroupCountZ);
+}
+
+void D3D11GraphicsContext::DispatchIndirect(ID3D11Buffer* argsBuffer, UINT alignedByteOffset)
+{
+    context->DispatchIndirect(argsBuffer, alignedByteOffset);
+}
+
+void D3D11GraphicsContext::CopyStructureCount(ID3D11Buffer* destinationBuffer, UINT destinationAlignedByteOffset, ID3D11UnorderedAccessView* sourceView)
+{
+    context->CopyStructureCount(destinationBuffer, destinationAlignedByteOffset, sourceView);
+}
+
+void D3D11GraphicsContext::CopySubresourceRegion(ID3D11Resource* destination, UINT destinationSubresource, UINT destinationX, UINT destinationY, UINT destinationZ, ID3D11Resource* source, UINT sourceSubresource, const D3D11_BOX* sourceBox)
+{
+    context->CopySubresourceRegion(destination, destinationSubresource, destinationX, destinationY, destinationZ, source, sourceSubresource, sourceBox);
+}
+
+void D3D11GraphicsContext::UpdateSubresource(ID3D11Resource* destination, UINT destinationSubresource, const D3D11_BOX* destinationBox, const void* sourceData, UINT sourceRowPitch, UINT sourceDepthPitch)
+{
+    context->UpdateSubresource(destination, destinationSubresource, destinationBox, sourceData, sourceRowPitch, sourceDepthPitch);
+}
+
+void D3D11GraphicsContext::SetResourceMinLOD(ID3D11Resource* resource, FLOAT minLOD)
+{
+    context->SetResourceMinLOD(resource, minLOD);
+}
+
+HRESULT D3D11GraphicsContext::Map(ID3D11Resource* resource, UINT subresource, D3D11_MAP mapType, UINT mapFlags, D3D11_MAPPED_SUBRESOURCE* mappedResource)
+{
+    return context->Map(resource, subresource, mapType, mapFlags, mappedResource);
+}
+
+void D3D11GraphicsContext::Unmap(ID3D11Resource* resource, UINT subresource)
+{
+    context->Unmap(resource, subresource);
+}
+
+HRESULT D3D11GraphicsContext::FinishCommandList(ID3D11CommandList** commandList)
+{
+    return context->FinishCommandList(FALSE, commandList);
+}
+
+void D3D11GraphicsContext::ExecuteCommandList(ID3D11CommandList* commandList)
+{
+    context->ExecuteCommandList(commandList, FALSE);
+}
+
+void D3D11GraphicsContext::Begin(ID3D11Asynchronous* async)
+{
+    context->Begin(async);
+}
+
+void D3D11GraphicsContext::End(ID3D11Asynchronous* async)
+{
+    context->End(async);
+}
+
+HRESULT D3D11GraphicsContext::GetData(ID3D11Asynchronous* async, void* data, UINT dataSize, UINT getDataFlags)
+{
+    return context->GetData(async, data, dataSize, getDataFlags);
+}
+
+void D3D11GraphicsContext::ClearRenderTargetView(ID3D11RenderTargetView* renderTargetView, const FLOAT colour[4])
+{
+    context->ClearRenderTargetView(renderTargetView, colour);
+}
+
+void D3D11GraphicsContext::ClearDepthStencilView(ID3D11DepthStencilView* depthStencilView, UINT clearFlags, FLOAT depth, UINT8 stencil)
+{
+    context->ClearDepthStencilView(depthStencilView, clearFlags, depth, stencil);
+}
+
+void D3D11GraphicsContext::ClearUnorderedAccessViewFloat(ID3D11UnorderedAccessView* unorderedAccessView, const FLOAT values[4])
+{
+    context->ClearUnorderedAccessViewFloat(unorderedAccessView, values);
+}
+
+void D3D11GraphicsContext::ClearUnorderedAccessViewUint(ID3D11UnorderedAccessView* unorderedAccessView, const UINT values[4])
+{
+    context->ClearUnorderedAccessViewUint(unorderedAccessView, values);
+}
+//-----------------------------------------------//
+//----------------END OF CONTEXT-----------------//
+//-----------------------------------------------//
+
+
+
+//-----------------------------------------------//
+//--------------------DEVICE---------------------//
+//-----------------------------------------------//
+D3D11GraphicsDevice::~D3D11GraphicsDevice()
+{
+    delete immediateContext;
+    if (device) { device->Release(); }
+}
+
+bool D3D11GraphicsDevice::Initialise()
+{
+    constexpr D3D_FEATURE_LEVEL featureLevels[] = {
+        D3D_FEATURE_LEVEL_11_0,
+        D3D_FEATURE_LEVEL_10_1,
+        D3D_FEATURE_LEVEL_10_0
+    };
+    ID3D11DeviceContext* context{};
+    const auto createDevice{ [&](UINT flags) {
+        return D3D11CreateDevice(
+            NULL,
+            D3D_DRIVER_TYPE_HARDWARE,
+            NULL,
+            flags,
+            featureLevels,
+            ARRAYSIZE(featureLevels),
+            D3D11_SDK_VERSION,
+            &device,
+            &featureLevel,
+            &context
+        );
+    } };
+    HRESULT hr{ createDevice(D3D11_CREATE_DEVICE_DEBUG) };
+    //The debug layer only exists where the SDK or the Graphics Tools optional feature is installed
+    if (FAILED(hr)) {
+        std::cerr << "ERROR::D3D11_GRAPHICS_DEVICE::INITIALISE::FAILED_TO_CREATE_DEBUG_DEVICE::RETRYING_WITHOUT_DEBUG_LAYER" << std::endl;
+        hr = createDevice(0);
+    }
+    if (FAILED(hr)) {
+        std::cerr << "ERROR::D3D11_GRAPHICS_DEVICE::INITIALISE::FAILED_TO_CREATE_DEVICE" << std::hex << hr << std::endl;
+        return false;
+    }
+    immediateContext = new D3D11GraphicsContext(context);
+
+    if (featureLevel < D3D_FEATURE_LEVEL_11_0) {
+        std::cerr << "ERROR::D3D11_GRAPHICS_DEVICE::INITIALISE::DEVICE_DOES_NOT_SUPPORT_DX11" << std::endl;
+        return false;
+    }
+
+    //Both are reported as false by Direct3D 11.0 runtimes
+    D3D11_FEATURE_DATA_D3D11_OPTIONS options{};
+    if (SUCCEEDED(device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options))))
+    {
+        constantBufferOffsets = options.ConstantBufferOffsetting && options.MapNoOverwriteOnDynamicConstantBuffer;
+    }
+
+    //Tearing needs DXGI 1.5 (Windows 10) as well as driver and display support
+    IDXGIDevice* dxgiDevice{};
+    IDXGIAdapter* dxgiAdapter{};
+    IDXGIFactory5* dxgiFactory{};
+    if (SUCCEEDED(device->QueryInterface(IID_PPV_ARGS(&dxgiDevice))) && SUCCEEDED(dxgiDevice->GetAdapter(&dxgiAdapter)) && SUCCEEDED(dxgiAdapter->GetParent(IID_PPV_ARGS(&dxgiFactory))))
+    {
+        BOOL allowTearing{ FALSE };
+        tearing = SUCCEEDED(dxgiFactory->CheckFeatureSupport(DXGI_FEATURE_PRESENT_ALLOW_TEARING, &allowTearing, sizeof(allowTearing))) && allowTearing;
+    }
+    if (dxgiFactory) { dxgiFactory->Release(); }
+    if (dxgiAdapter) { dxgiAdapter->Release(); }
+    if (dxgiDevice) { dxgiDevice->Release(); }
+    return true;
+}
+
+HRESULT D3D11GraphicsDevice::CreateBuffer(const D3D11_BUFFER_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Buffer** buffer)
+{
+    return device->CreateBuffer(desc, initialData, buffer);
+}
+
+HRESULT D3D11GraphicsDevice::CreateTexture1D(const D3D11_TEXTURE1D_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Texture1D** texture)
+{
+    return device->CreateTexture1D(desc, initialData, texture);
+}
+
+HRESULT D3D11GraphicsDevice::CreateTexture2D(const D3D11_TEXTURE2D_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Texture2D** texture)
+{
+    return device->CreateTexture2D(desc, initialData, texture);
+}
+
+HRESULT D3D11GraphicsDevice::CreateTexture3D(const D3D11_TEXTURE3D_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Texture3D** texture)
+{
+    return device->CreateTexture3D(desc, initialData, texture);
+}
+
+void D3D11GraphicsDevice::GetBufferDesc(ID3D11Buffer* buffer, D3D11_BUFFER_DESC* desc)
+{
+    buffer->GetDesc(desc);
+}
+
+void D3D11GraphicsDevice::GetTexture2DDesc(ID3D11Texture2D* texture, D3D11_TEXTURE2D_DESC* desc)
+{
+    texture->GetDesc(desc);
+}
+
+HRESULT D3D11GraphicsDevice::CreateShaderResourceView(ID3D11Resource* resource, const D3D11_SHADER_RESOURCE_VIEW_DESC* desc, ID3D11ShaderResourceView** view)
+{
+    return device->CreateShaderResourceView(resource, desc, view);
+}
+
+HRESULT D3D11GraphicsDevice::CreateUnorderedAccessView(ID3D11Resource* resource, const D3D11_UNORDERED_ACCESS_VIEW_DESC* desc, ID3D11UnorderedAccessView** view)
+{
+    return device->CreateUnorderedAccessView(resource, desc, view);
+}
+
+HRESULT D3D11GraphicsDevice::CreateRenderTargetView(ID3D11Resource* resource, const D3D11_RENDER_TARGET_VIEW_DESC* desc, ID3D11RenderTargetView** view)
+{
+    return device->CreateRenderTargetView(resource, desc, view);
+}
+
+HRESULT D3D11GraphicsDevice::CreateDepthStencilView(ID3D11Resource* resource, const D3D11_DEPTH_STENCIL_VIEW_DESC* desc, ID3D11DepthStencilView** view)
+{
+    return device->CreateDepthStencilView(resource, desc, view);
+}
+
+ID3D11Resource* D3D11GraphicsDevice::GetViewResource(ID3D11View* view)
+{
+    //GetResource() adds a reference, which the view's own reference makes safe to drop straight away
+    if (!view) { return nullptr; }
+    ID3D11Resource* resource{};
+    view->GetResource(&resource);
+    resource->Release();
+    return resource;
+}
+
+HRESULT D3D11GraphicsDevice::CreateDeferredContext(GraphicsContext** context)
+{
+    ID3D11DeviceContext* deferredContext{};
+    const HRESULT hr{ device->CreateDeferredContext(0, &deferredContext) };
+    if (FAILED(hr)) { return hr; }
+    *context = new D3D11GraphicsContext(deferredContext);
+    return S_OK;
+}
+
+HRESULT D3D11GraphicsDevice::CreateSamplerState(const D3D11_SAMPLER_DESC* desc, ID3D11SamplerState** samplerState)
+{
+    return device->CreateSamplerState(desc, samplerState);
+}
+
+HRESULT D3D11GraphicsDevice::CreateBlendState(const D3D11_BLEND_DESC* desc, ID3D11BlendState** blendState)
+{
+    return device->CreateBlendState(desc, blendState);
+}
+
+HRESULT D3D11GraphicsDevice::CreateRasterizerState(const D3D11_RASTERIZER_DESC* desc, ID3D11RasterizerState** rasterizerState)
+{
+    return device->CreateRasterizerState(desc, rasterizerState);
+}
+
+HRESULT D3D11GraphicsDevice::CreateDepthStencilState(const D3D11_DEPTH_STENCIL_DESC* desc, ID3D11DepthStencilState** depthStencilState)
+{
+    return device->CreateDepthStencilState(desc, depthStencilState);
+}
+
+HRESULT D3D11GraphicsDevice::CreateVertexShader(const void* bytecode, SIZE_T bytecodeLength, ID3D11VertexShader** vertexShader)
+{
+    return device->CreateVertexShader(bytecode, bytecodeLength, nullptr, vertexShader);
+}
+
+HRESULT D3D11GraphicsDevice::CreatePixelShader(const void* bytecode, SIZE_T bytecodeLength, ID3D11PixelShader** pixelShader)
+{
+    return device->CreatePixelShader(bytecode, bytecodeLength, nullptr, pixelShader);
+}
+
+HRESULT D3D11GraphicsDevice::CreateComputeShader(const void* bytecode, SIZE_T bytecodeLength, ID3D11ComputeShader** computeShader)
+{
+    return device->CreateComputeShader(bytecode, bytecodeLength, nullptr, computeShader);
+}
+
+HRESULT D3D11GraphicsDevice::CreateInputLayout(const D3D11_INPUT_ELEMENT_DESC* elements, UINT numElements, const void* bytecode, SIZE_T bytecodeLength, ID3D11InputLayout** inputLayout)
+{
+    return device->CreateInputLayout(elements, numElements, bytecode, bytecodeLength, inputLayout);
+}
+
+HRESULT D3D11GraphicsDevice::CreateQuery(const D3D11_QUERY_DESC* desc, ID3D11Query** query)
+{
+    return device->CreateQuery(desc, query);
+}
+
+HRESULT D3D11GraphicsDevice::SetMaximumFrameLatency(UINT maxLatency)
+{
+    IDXGIDevice1* dxgiDevice;
+    HRESULT hr{ device->QueryInterface(IID_PPV_ARGS(&dxgiDevice)) };
+    if (FAILED(hr)) { return hr; }
+    hr = dxgiDevice->SetMaximumFrameLatency(maxLatency);
+    dxgiDevice->Release();
+    return hr;
+}
+
+HRESULT D3D11GraphicsDevice::CreateSwapChain(HWND hwnd, const DXGI_SWAP_CHAIN_DESC* desc, GraphicsSwapChain** swapChain)
+{
+    //Setup DXGI Factory
+    IDXGIDevice* dxgiDevice;
+    HRESULT hr{ device->QueryInterface(IID_PPV_ARGS(&dxgiDevice)) };
+    if (FAILED(hr))
+    {
+        std::cerr << "ERROR::D3D11_GRAPHICS_DEVICE::CREATE_SWAP_CHAIN::FAILED_TO_GET_DXGI_DEVICE" << std::endl;
+        return hr;
+    }
+    IDXGIAdapter* dxgiAdapter;
+    hr = dxgiDevice->GetAdapter(&dxgiAdapter);
+    if (FAILED(hr))
+    {
+        std::cerr << "ERROR::D3D11_GRAPHICS_DEVICE::CREATE_SWAP_CHAIN::FAILED_TO_GET_DXGI_ADAPTER" << std::endl;
+        dxgiDevice->Release();
+        return hr;
+    }
+    IDXGIFactory* dxgiFactory;
+    hr = dxgiAdapter->GetParent(IID_PPV_ARGS(&dxgiFactory));
+    if (FAILED(hr))
+    {
+        std::cerr << "ERROR::D3D11_GRAPHICS_DEVICE::CREATE_SWAP_CHAIN::FAILED_TO_GET_DXGI_FACTORY" << std::endl;
+        dxgiDevice->Release();
+        dxgiAdapter->Release();
+        return hr;
+    }
+
+    //Setup Swapchain
+    DXGI_SWAP_CHAIN_DESC swapChainDesc{ *desc };
+    swapChainDesc.OutputWindow = hwnd;
+    IDXGISwapChain* dxgiSwapChain{};
+    hr = dxgiFactory->CreateSwapChain(dxgiDevice, &swapChainDesc, &dxgiSwapChain);
+    dxgiFactory->Release();
+    dxgiAdapter->Release();
+    dxgiDevice->Release();
+    if (FAILED(hr))
+    {
+        std::cerr << "ERROR::D3D11_GRAPHICS_DEVICE::CREATE_SWAP_CHAIN::FAILED_TO_CREATE_SWAP_CHAIN" << std::endl;
+        return hr;
+    }
+
+    *swapChain = new D3D11GraphicsSwapChain(dxgiSwapChain);
+    return hr;
+}
+
+void D3D11GraphicsDevice::ReleaseObject(IUnknown* object)
+{
+    if (object) { object->Release(); }
+}
+//-----------------------------------------------//
+//-----------------END OF DEVICE-----------------//
+//-----------------------------------------------//
+
+#endif
\ No newline at end of file
@@ -0,0 +1,147 @@
+﻿#pragma once
+
+#include <d3d11_1.h>
+#include <dxgi1_3.h>
+
+#include "GraphicsDevice.h"
+
+//Hardware implementation - a straight pass-through to Direct3D 11
+
+class D3D11GraphicsSwapChain : public GraphicsSwapChain
+{
+public:
+    explicit D3D11GraphicsSwapChain(IDXGISwapChain* _swapChain);
+    ~D3D11GraphicsSwapChain() override;
+
+    HRESULT GetBuffer(UINT buffer, ID3D11Texture2D** texture) override;
+    HRESULT Present(UINT syncInterval, UINT flags) override;
+    HRESULT ResizeBuffers(UINT bufferCount, UINT width, UINT height, DXGI_FORMAT format, UINT flags) override;
+
+    [[nodiscard]] HANDLE GetFrameLatencyWaitableObject() override;
+    HRESULT SetMaximumFrameLatency(UINT maxLatency) override;
+
+private:
+    IDXGISwapChain* swapChain;
+    IDXGISwapChain2* swapChain2{}; //Only queried for swapchains with a waitable object
+};
+
+
+class D3D11GraphicsContext : public GraphicsContext
+{
+public:
+    explicit D3D11GraphicsContext(ID3D11DeviceContext* _context);
+    ~D3D11GraphicsContext() override;
+
+    void ClearState() override;
+
+    void OMSetRenderTargets(UINT numViews, ID3D11RenderTargetView* const* renderTargetViews, ID3D11DepthStencilView* depthStencilView) override;
+    void OMSetRenderTargetsAndUnorderedAccessViews(UINT numRTVs, ID3D11RenderTargetView* const* renderTargetViews, ID3D11DepthStencilView* depthStencilView, UINT uavStartSlot, UINT numUAVs, ID3D11UnorderedAccessView* const* unorderedAccessViews, const UINT* initialCounts) override;
+    void OMSetBlendState(ID3D11BlendState* blendState, const FLOAT blendFactor[4], UINT sampleMask) override;
+    void OMSetDepthStencilState(ID3D11DepthStencilState* depthStencilState, UINT stencilRef) override;
+
+    void SetShaderResources(PIPELINE_STAGE stage, UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* shaderResourceViews) override;
+    void SetConstantBuffers(PIPELINE_STAGE stage, UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers) override;
+    void SetConstantBuffers1(PIPELINE_STAGE stage, UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers, const UINT* firstConstants, const UINT* numConstants) override;
+    void SetSamplers(PIPELINE_STAGE stage, UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* samplerStates) override;
+    void CSSetUnorderedAccessViews(UINT startSlot, UINT numUAVs, ID3D11UnorderedAccessView* const* unorderedAccessViews, const UINT* initialCounts) override;
+    void VSSetShader(ID3D11VertexShader* vertexShader) override;
+    void PSSetShader(ID3D11PixelShader* pixelShader) override;
+    void CSSetShader(ID3D11ComputeShader* computeShader) override;
+
+    void IASetVertexBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* vertexBuffers, const UINT* strides, const UINT* offsets) override;
+    void IASetIndexBuffer(ID3D11Buffer* indexBuffer, DXGI_FORMAT format, UINT offset) override;
+    void IASetInputLayout(ID3D11InputLayout* inputLayout) override;
+    void IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology) override;
+
+    void RSSetViewports(UINT numViewports, const D3D11_VIEWPORT* viewports) override;
+    void RSSetState(ID3D11RasterizerState* rasterizerState) override;
+
+    void Draw(UINT vertexCount, UINT startVertexLocation) override;
+    void DrawIndexed(UINT indexCount, UINT startIndexLocation, INT baseVertexLocation) override;
+    void DrawInstanced(UINT vertexCountPerInstance, UINT instanceCount, UINT startVertexLocation, UINT startInstanceLocation) override;
+    void DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount, UINT startIndexLocation, INT baseVertexLocation, UINT startInstanceLocation) override;
+    void DrawInstancedIndirect(ID3D11Buffer* argsBuffer, UINT alignedByteOffset) override;
+    void DrawIndexedInstancedIndirect(ID3D11Buffer* argsBuffer, UINT alignedByteOffset) override;
+
+    void Dispatch(UINT threadGroupCountX, UINT threadGroupCountY, UINT threadGroupCountZ) override;
+    void DispatchIndirect(ID3D11Buffer* argsBuffer, UINT alignedByteOffset) override;
+
+    void CopyStructureCount(ID3D11Buffer* destinationBuffer, UINT destinationAlignedByteOffset, ID3D11UnorderedAccessView* sourceView) override;
+    void CopySubresourceRegion(ID3D11Resource* destination, UINT destinationSubresource, UINT destinationX, UINT destinationY, UINT destinationZ, ID3D11Resource* source, UINT sourceSubresource, const D3D11_BOX* sourceBox) override;
+    void UpdateSubresource(ID3D11Resource* destination, UINT destinationSubresource, const D3D11_BOX* destinationBox, const void* sourceData, UINT sourceRowPitch, UINT sourceDepthPitch) override;
+    void SetResourceMinLOD(ID3D11Resource* resource, FLOAT minLOD) override;
+
+    HRESULT Map(ID3D11Resource* resource, UINT subresource, D3D11_MAP mapType, UINT mapFlags, D3D11_MAPPED_SUBRESOURCE* mappedResource) override;
+    void Unmap(ID3D11Resource* resource, UINT subresource) override;
+
+    HRESULT FinishCommandList(ID3D11CommandList** commandList) override;
+    void ExecuteCommandList(ID3D11CommandList* commandList) override;
+
+    void Begin(ID3D11Asynchronous* async) override;
+    void End(ID3D11Asynchronous* async) override;
+    HRESULT GetData(ID3D11Asynchronous* async, void* data, UINT dataSize, UINT getDataFlags) override;
+
+    void ClearRenderTargetView(ID3D11RenderTargetView* renderTargetView, const FLOAT colour[4]) override;
+    void ClearDepthStencilView(ID3D11DepthStencilView* depthStencilView, UINT clearFlags, FLOAT depth, UINT8 stencil) override;
+    void ClearUnorderedAccessViewFloat(ID3D11UnorderedAccessView* unorderedAccessView, const FLOAT values[4]) override;
+    void ClearUnorderedAccessViewUint(ID3D11UnorderedAccessView* unorderedAccessView, const UINT values[4]) override;
+
+private:
+    ID3D11DeviceContext* context;
+    ID3D11DeviceContext1* context1{}; //Null on runtimes without Direct3D 11.1
+};
+
+
+class D3D11GraphicsDevice : public GraphicsDevice
+{
+public:
+    D3D11GraphicsDevice() = default;
+    ~D3D11GraphicsDevice() override;
+
+    //Creates the underlying ID3D11Device - returns false if no feature level 11 hardware device could be created
+    [[nodiscard]] bool Initialise();
+
+    [[nodiscard]] GRAPHICS_BACKEND GetBackend() const override { return D3D11_BACKEND; }
+    [[nodiscard]] D3D_FEATURE_LEVEL GetFeatureLevel() const override { return featureLevel; }
+    [[nodiscard]] GraphicsContext* GetImmediateContext() override { return immediateContext; }
+    HRESULT CreateDeferredContext(GraphicsContext** context) override;
+    [[nodiscard]] bool SupportsConstantBufferOffsets() const override { return constantBufferOffsets; }
+    [[nodiscard]] bool SupportsTearing() const override { return tearing; }
+    HRESULT SetMaximumFrameLatency(UINT maxLatency) override;
+
+    HRESULT CreateBuffer(const D3D11_BUFFER_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Buffer** buffer) override;
+    HRESULT CreateTexture1D(const D3D11_TEXTURE1D_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Texture1D** texture) override;
+    HRESULT CreateTexture2D(const D3D11_TEXTURE2D_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Texture2D** texture) override;
+    HRESULT CreateTexture3D(const D3D11_TEXTURE3D_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Texture3D** texture) override;
+    void GetBufferDesc(ID3D11Buffer* buffer, D3D11_BUFFER_DESC* desc) override;
+    void GetTexture2DDesc(ID3D11Texture2D* texture, D3D11_TEXTURE2D_DESC* desc) override;
+
+    HRESULT CreateShaderResourceView(ID3D11Resource* resource, const D3D11_SHADER_RESOURCE_VIEW_DESC* desc, ID3D11ShaderResourceView** view) override;
+    HRESULT CreateUnorderedAccessView(ID3D11Resource* resource, const D3D11_UNORDERED_ACCESS_VIEW_DESC* desc, ID3D11UnorderedAccessView** view) override;
+    HRESULT CreateRenderTargetView(ID3D11Resource* resource, const D3D11_RENDER_TARGET_VIEW_DESC* desc, ID3D11RenderTargetView** view) override;
+    HRESULT CreateDepthStencilView(ID3D11Resource* resource, const D3D11_DEPTH_STENCIL_VIEW_DESC* desc, ID3D11DepthStencilView** view) override;
+    [[nodiscard]] ID3D11Resource* GetViewResource(ID3D11View* view) override;
+
+    HRESULT CreateSamplerState(const D3D11_SAMPLER_DESC* desc, ID3D11SamplerState** samplerState) override;
+    HRESULT CreateBlendState(const D3D11_BLEND_DESC* desc, ID3D11BlendState** blendState) override;
+    HRESULT CreateRasterizerState(const D3D11_RASTERIZER_DESC* desc, ID3D11RasterizerState** rasterizerState) override;
+    HRESULT CreateDepthStencilState(const D3D11_DEPTH_STENCIL_DESC* desc, ID3D11DepthStencilState** depthStencilState) override;
+
+    HRESULT CreateVertexShader(const void* bytecode, SIZE_T bytecodeLength, ID3D11VertexShader** vertexShader) override;
+    HRESULT CreatePixelShader(const void* bytecode, SIZE_T bytecodeLength, ID3D11PixelShader** pixelShader) override;
+    HRESULT CreateComputeShader(const void* bytecode, SIZE_T bytecodeLength, ID3D11ComputeShader** computeShader) override;
+    HRESULT CreateInputLayout(const D3D11_INPUT_ELEMENT_DESC* elements, UINT numElements, const void* bytecode, SIZE_T bytecodeLength, ID3D11InputLayout** inputLayout) override;
+
+    HRESULT CreateQuery(const D3D11_QUERY_DESC* desc, ID3D11Query** query) override;
+
+    HRESULT CreateSwapChain(HWND hwnd, const DXGI_SWAP_CHAIN_DESC* desc, GraphicsSwapChain** swapChain) override;
+
+    void ReleaseObject(IUnknown* object) override;
+
+private:
+    ID3D11Device* device{};
+    D3D11GraphicsContext* immediateContext{};
+    D3D_FEATURE_LEVEL featureLevel{};
+    bool constantBufferOffsets{};
+    bool tearing{};
+};
@@ -0,0 +1,175 @@
+﻿#pragma once
+
+#include <dxgi.h>
+#include <d3d11.h>
+
+#include "../Managers/PipelineManager.h"
+
+
+enum GRAPHICS_BACKEND
+{
+    D3D11_BACKEND, //Hardware device through Direct3D 11
+    NULL_BACKEND,  //Headless device that records every call and never touches a GPU
+};
+
+
+//Thin interfaces over the parts of ID3D11Device/ID3D11DeviceContext/IDXGISwapChain the engine uses
+//Methods mirror their D3D11 counterparts; per-stage calls are folded into a single method taking a PIPELINE_STAGE
+//Objects handed out by a GraphicsDevice must only ever be passed back to that device (never called directly),
+//since the null backend hands out opaque placeholders rather than real COM objects
+
+class GraphicsSwapChain
+{
+public:
+    virtual ~GraphicsSwapChain() = default;
+
+    virtual HRESULT GetBuffer(UINT buffer, ID3D11Texture2D** texture) = 0;
+    virtual HRESULT Present(UINT syncInterval, UINT flags) = 0;
+    //Every reference to the buffers (including views and bindings) must have been released first
+    //A bufferCount of 0 and DXGI_FORMAT_UNKNOWN keep the current count and format - flags must repeat the creation flags
+    virtual HRESULT ResizeBuffers(UINT bufferCount, UINT width, UINT height, DXGI_FORMAT format, UINT flags) = 0;
+
+    //Only available on swapchains created with DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT, null otherwise
+    //The handle is signalled once the swapchain can accept another frame, and must be closed by the caller
+    [[nodiscard]] virtual HANDLE GetFrameLatencyWaitableObject() = 0;
+    virtual HRESULT SetMaximumFrameLatency(UINT maxLatency) = 0;
+};
+
+
+class GraphicsContext
+{
+public:
+    virtual ~GraphicsContext() = default;
+
+    virtual void ClearState() = 0;
+
+    //----Output Merger----//
+    virtual void OMSetRenderTargets(UINT numViews, ID3D11RenderTargetView* const* renderTargetViews, ID3D11DepthStencilView* depthStencilView) = 0;
+    virtual void OMSetRenderTargetsAndUnorderedAccessViews(UINT numRTVs, ID3D11RenderTargetView* const* renderTargetViews, ID3D11DepthStencilView* depthStencilView, UINT uavStartSlot, UINT numUAVs, ID3D11UnorderedAccessView* const* unorderedAccessViews, const UINT* initialCounts) = 0;
+    virtual void OMSetBlendState(ID3D11BlendState* blendState, const FLOAT blendFactor[4], UINT sampleMask) = 0;
+    virtual void OMSetDepthStencilState(ID3D11DepthStencilState* depthStencilState, UINT stencilRef) = 0;
+
+    //----Shader Stages----//
+    virtual void SetShaderResources(PIPELINE_STAGE stage, UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* shaderResourceViews) = 0;
+    virtual void SetConstantBuffers(PIPELINE_STAGE stage, UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers) = 0;
+    //Binds a window of each buffer, in units of 16-byte constants - requires GraphicsDevice::SupportsConstantBufferOffsets()
+    virtual void SetConstantBuffers1(PIPELINE_STAGE stage, UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers, const UINT* firstConstants, const UINT* numConstants) = 0;
+    virtual void SetSamplers(PIPELINE_STAGE stage, UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* samplerStates) = 0;
+    virtual void CSSetUnorderedAccessViews(UINT startSlot, UINT numUAVs, ID3D11UnorderedAccessView* const* unorderedAccessViews, const UINT* initialCounts) = 0;
+    virtual void VSSetShader(ID3D11VertexShader* vertexShader) = 0;
+    virtual void PSSetShader(ID3D11PixelShader* pixelShader) = 0;
+    virtual void CSSetShader(ID3D11ComputeShader* computeShader) = 0;
+
+    //----Input Assembler----//
+    virtual void IASetVertexBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* vertexBuffers, const UINT* strides, const UINT* offsets) = 0;
+    virtual void IASetIndexBuffer(ID3D11Buffer* indexBuffer, DXGI_FORMAT format, UINT offset) = 0;
+    virtual void IASetInputLayout(ID3D11InputLayout* inputLayout) = 0;
+    virtual void IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology) = 0;
+
+    //----Rasteriser----//
+    virtual void RSSetViewports(UINT numViewports, const D3D11_VIEWPORT* viewports) = 0;
+    virtual void RSSetState(ID3D11RasterizerState* rasterizerState) = 0;
+
+    //----Draws----//
+    virtual void Draw(UINT vertexCount, UINT startVertexLocation) = 0;
+    virtual void DrawIndexed(UINT indexCount, UINT startIndexLocation, INT baseVertexLocation) = 0;
+    virtual void DrawInstanced(UINT vertexCountPerInstance, UINT instanceCount, UINT startVertexLocation, UINT startInstanceLocation) = 0;
+    virtual void DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount, UINT startIndexLocation, INT baseVertexLocation, UINT startInstanceLocation) = 0;
+    //Read D3D11_DRAW_INSTANCED_INDIRECT_ARGS / D3D11_DRAW_INDEXED_INSTANCED_INDIRECT_ARGS from the buffer at the given byte offset
+    virtual void DrawInstancedIndirect(ID3D11Buffer* argsBuffer, UINT alignedByteOffset) = 0;
+    virtual void DrawIndexedInstancedIndirect(ID3D11Buffer* argsBuffer, UINT alignedByteOffset) = 0;
+
+    //----Dispatches----//
+    virtual void Dispatch(UINT threadGroupCountX, UINT threadGroupCountY, UINT threadGroupCountZ) = 0;
+    //Reads the three thread group counts from the buffer at the given byte offset
+    virtual void DispatchIndirect(ID3D11Buffer* argsBuffer, UINT alignedByteOffset) = 0;
+
+    //----Resource Access----//
+    //Writes the hidden counter of an append/counter UAV into the buffer as a UINT
+    virtual void CopyStructureCount(ID3D11Buffer* destinationBuffer, UINT destinationAlignedByteOffset, ID3D11UnorderedAccessView* sourceView) = 0;
+    //Copies between resources of the same (or a compatible) format on the GPU - a null sourceBox copies the whole subresource
+    virtual void CopySubresourceRegion(ID3D11Resource* destination, UINT destinationSubresource, UINT destinationX, UINT destinationY, UINT destinationZ, ID3D11Resource* source, UINT sourceSubresource, const D3D11_BOX* sourceBox) = 0;
+    //Default usage resources only - for block compressed formats the pitches are of rows of 4x4 blocks
+    virtual void UpdateSubresource(ID3D11Resource* destination, UINT destinationSubresource, const D3D11_BOX* destinationBox, const void* sourceData, UINT sourceRowPitch, UINT sourceDepthPitch) = 0;
+    //Resources created with D3D11_RESOURCE_MISC_RESOURCE_CLAMP only - sampling never reads mips finer than minLOD, whatever the views and samplers ask for
+    virtual void SetResourceMinLOD(ID3D11Resource* resource, FLOAT minLOD) = 0;
+
+    virtual HRESULT Map(ID3D11Resource* resource, UINT subresource, D3D11_MAP mapType, UINT mapFlags, D3D11_MAPPED_SUBRESOURCE* mappedResource) = 0;
+    virtual void Unmap(ID3D11Resource* resource, UINT subresource) = 0;
+
+    //----Command Lists----//
+    //Deferred contexts only - bakes everything recorded since the last call into a command list and resets the context to its default state
+    virtual HRESULT FinishCommandList(ID3D11CommandList** commandList) = 0;
+    //Immediate context only - plays the list back, then resets the context to its default state
+    virtual void ExecuteCommandList(ID3D11CommandList* commandList) = 0;
+
+    //----Queries----//
+    virtual void Begin(ID3D11Asynchronous* async) = 0;
+    virtual void End(ID3D11Asynchronous* async) = 0;
+    //Returns S_FALSE while the result isn't available yet - pass D3D11_ASYNC_GETDATA_DONOTFLUSH to poll without forcing a flush
+    virtual HRESULT GetData(ID3D11Asynchronous* async, void* data, UINT dataSize, UINT getDataFlags) = 0;
+
+    //----Clears----//
+    virtual void ClearRenderTargetView(ID3D11RenderTargetView* renderTargetView, const FLOAT colour[4]) = 0;
+    virtual void ClearDepthStencilView(ID3D11DepthStencilView* depthStencilView, UINT clearFlags, FLOAT depth, UINT8 stencil) = 0;
+    virtual void ClearUnorderedAccessViewFloat(ID3D11UnorderedAccessView* unorderedAccessView, const FLOAT values[4]) = 0;
+    virtual void ClearUnorderedAccessViewUint(ID3D11UnorderedAccessView* unorderedAccessView, const UINT values[4]) = 0;
+};
+
+
+class GraphicsDevice
+{
+public:
+    virtual ~GraphicsDevice() = default;
+
+    [[nodiscard]] virtual GRAPHICS_BACKEND GetBackend() const = 0;
+    [[nodiscard]] virtual D3D_FEATURE_LEVEL GetFeatureLevel() const = 0;
+    [[nodiscard]] virtual GraphicsContext* GetImmediateContext() = 0;
+    //Context for recording a command list on another thread - the caller owns it and deletes it when done
+    virtual HRESULT CreateDeferredContext(GraphicsContext** context) = 0;
+    //Direct3D 11.1 constant buffer offsetting together with NO_OVERWRITE maps of dynamic constant buffers
+    [[nodiscard]] virtual bool SupportsConstantBufferOffsets() const = 0;
+    //Whether flip model swapchains can be created with DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING (variable refresh rate displays)
+    [[nodiscard]] virtual bool SupportsTearing() const = 0;
+    //Frames the CPU may queue ahead of the GPU when presenting (swapchains with a waitable object set their own)
+    virtual HRESULT SetMaximumFrameLatency(UINT maxLatency) = 0;
+
+    //----Resources----//
+    virtual HRESULT CreateBuffer(const D3D11_BUFFER_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Buffer** buffer) = 0;
+    virtual HRESULT CreateTexture1D(const D3D11_TEXTURE1D_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Texture1D** texture) = 0;
+    virtual HRESULT CreateTexture2D(const D3D11_TEXTURE2D_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Texture2D** texture) = 0;
+    virtual HRESULT CreateTexture3D(const D3D11_TEXTURE3D_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Texture3D** texture) = 0;
+    virtual void GetBufferDesc(ID3D11Buffer* buffer, D3D11_BUFFER_DESC* desc) = 0;
+    virtual void GetTexture2DDesc(ID3D11Texture2D* texture, D3D11_TEXTURE2D_DESC* desc) = 0;
+
+    //----Views----//
+    virtual HRESULT CreateShaderResourceView(ID3D11Resource* resource, const D3D11_SHADER_RESOURCE_VIEW_DESC* desc, ID3D11ShaderResourceView** view) = 0;
+    virtual HRESULT CreateUnorderedAccessView(ID3D11Resource* resource, const D3D11_UNORDERED_ACCESS_VIEW_DESC* desc, ID3D11UnorderedAccessView** view) = 0;
+    virtual HRESULT CreateRenderTargetView(ID3D11Resource* resource, const D3D11_RENDER_TARGET_VIEW_DESC* desc, ID3D11RenderTargetView** view) = 0;
+    virtual HRESULT CreateDepthStencilView(ID3D11Resource* resource, const D3D11_DEPTH_STENCIL_VIEW_DESC* desc, ID3D11DepthStencilView** view) = 0;
+    //Resource the view was created on - no reference is added, so it is only valid for as long as the view is
+    [[nodiscard]] virtual ID3D11Resource* GetViewResource(ID3D11View* view) = 0;
+
+    //----States----//
+    //Direct3D 11 allows at most 4096 unique objects of each state type per device
+    virtual HRESULT CreateSamplerState(const D3D11_SAMPLER_DESC* desc, ID3D11SamplerState** samplerState) = 0;
+    virtual HRESULT CreateBlendState(const D3D11_BLEND_DESC* desc, ID3D11BlendState** blendState) = 0;
+    virtual HRESULT CreateRasterizerState(const D3D11_RASTERIZER_DESC* desc, ID3D11RasterizerState** rasterizerState) = 0;
+    virtual HRESULT CreateDepthStencilState(const D3D11_DEPTH_STENCIL_DESC* desc, ID3D11DepthStencilState** depthStencilState) = 0;
+
+    //----Shaders----//
+    //Bytecode as produced by D3DCompile() - an input layout is validated against the vertex shader bytecode it is created with
+    virtual HRESULT CreateVertexShader(const void* bytecode, SIZE_T bytecodeLength, ID3D11VertexShader** vertexShader) = 0;
+    virtual HRESULT CreatePixelShader(const void* bytecode, SIZE_T bytecodeLength, ID3D11PixelShader** pixelShader) = 0;
+    virtual HRESULT CreateComputeShader(const void* bytecode, SIZE_T bytecodeLength, ID3D11ComputeShader** computeShader) = 0;
+    virtual HRESULT CreateInputLayout(const D3D11_INPUT_ELEMENT_DESC* elements, UINT numElements, const void* bytecode, SIZE_T bytecodeLength, ID3D11InputLayout** inputLayout) = 0;
+
+    //----Queries----//
+    virtual HRESULT CreateQuery(const D3D11_QUERY_DESC* desc, ID3D11Query** query) = 0;
+
+    //----Swapchain----//
+    virtual HRESULT CreateSwapChain(HWND hwnd, const DXGI_SWAP_CHAIN_DESC* desc, GraphicsSwapChain** swapChain) = 0;
+
+    //Drops one reference to any object created by (or retrieved through) this device
+    virtual void ReleaseObject(IUnknown* object) = 0;
+};
@@ -0,0 +1,726 @@
+﻿#include "NullGraphicsDevice.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+
+//Placeholders are handed out disguised as COM interface pointers and come back either as that interface or as one of its bases
+//All D3D11/DXGI interfaces use single inheritance, so those conversions never adjust the address and it always identifies the NullObject
+template<typename T>
+static T* Disguise(NullObject* object) { return reinterpret_cast<T*>(object); }
+static NullObject* Reveal(const void* pointer) { return static_cast<NullObject*>(const_cast<void*>(pointer)); }
+
+
+//-----------------------------------------------//
+//------------------COMMAND LOG------------------//
+//-----------------------------------------------//
+void NullCommandLog::Record(NULL_COMMAND_TYPE type, const void* object, UINT stage, UINT arg0, UINT arg1, UINT arg2)
+{
+    ++counts[type];
+    const bool draw{ type == NULL_COMMAND_DRAW || type == NULL_COMMAND_DRAW_INDEXED || type == NULL_COMMAND_DRAW_INSTANCED || type == NULL_COMMAND_DRAW_INDEXED_INSTANCED
+                  || type == NULL_COMMAND_DRAW_INSTANCED_INDIRECT || type == NULL_COMMAND_DRAW_INDEXED_INSTANCED_INDIRECT
+                  || type == NULL_COMMAND_DISPATCH || type == NULL_COMMAND_DISPATCH_INDIRECT };
+    syntheticTime += (draw) ? drawTicks : commandTicks;
+    if (keepCommands)
+    {
+        commands.push_back(NullCommand{ object, static_cast<UINT16>(type), static_cast<UINT16>(stage), { arg0, arg1, arg2 } });
+    }
+}
+
+void NullCommandLog::Clear()
+{
+    commands.clear();
+    std::fill_n(counts, NULL_COMMAND_TYPE_COUNT, 0);
+}
+
+UINT64 NullCommandLog::GetTotalCount() const
+{
+    return std::accumulate(counts, counts + NULL_COMMAND_TYPE_COUNT, UINT64{ 0 });
+}
+//-----------------------------------------------//
+//--------------END OF COMMAND LOG---------------//
+//-----------------------------------------------//
+
+
+
+//-----------------------------------------------//
+//-------------------SWAPCHAIN-------------------//
+//-----------------------------------------------//
+NullGraphicsSwapChain::NullGraphicsSwapChain(NullGraphicsDevice* _device, NullObject* _backBuffer) : device{ _device }, backBuffer{ _backBuffer }
+{
+}
+
+NullGraphicsSwapChain::~NullGraphicsSwapChain()
+{
+    device->ReleaseObject(Disguise<IUnknown>(backBuffer));
+}
+
+HRESULT NullGraphicsSwapChain::GetBuffer(UINT /*buffer*/, ID3D11Texture2D** texture)
+{
+    std::lock_guard<std::mutex> lock{ device->mutex };
+    ++backBuffer->refCount;
+    *texture = Disguise<ID3D11Texture2D>(backBuffer);
+    return S_OK;
+}
+
+HRESULT NullGraphicsSwapChain::Present(UINT syncInterval, UINT flags)
+{
+    std::lock_guard<std::mutex> lock{ device->mutex };
+    device->log.Record(NULL_COMMAND_PRESENT, this, 0, syncInterval, flags);
+    ++device->presentCount;
+    return S_OK;
+}
+
+HRESULT NullGraphicsSwapChain::ResizeBuffers(UINT bufferCount, UINT width, UINT height, DXGI_FORMAT format, UINT /*flags*/)
+{
+    std::lock_guard<std::mutex> lock{ device->mutex };
+    //As with DXGI, nothing but the swapchain itself may still hold the back buffer
+    if (backBuffer->refCount != 1)
+    {
+        std::cerr << "ERROR::NULL_GRAPHICS_SWAP_CHAIN::RESIZE_BUFFERS::BACK_BUFFER_STILL_REFERENCED" << std::endl;
+        return DXGI_ERROR_INVALID_CALL;
+    }
+    backBuffer->desc.texture2D.Width = width;
+    backBuffer->desc.texture2D.Height = height;
+    if (format != DXGI_FORMAT_UNKNOWN) { backBuffer->desc.texture2D.Format = format; }
+    device->log.Record(NULL_COMMAND_RESIZE_BUFFERS, this, 0, width, height, bufferCount);
+    return S_OK;
+}
+//-----------------------------------------------//
+//---------------END OF SWAPCHAIN----------------//
+//-----------------------------------------------//
+
+
+
+//-----------------------------------------------//
+//--------------------CONTEXT--------------------//
+//-----------------------------------------------//
+void NullGraphicsContext::ClearState()
+{
+    log.Record(NULL_COMMAND_CLEAR_STATE, nullptr);
+}
+
+void NullGraphicsContext::OMSetRenderTargets(UINT numViews, ID3D11RenderTargetView* const* renderTargetViews, ID3D11DepthStencilView* depthStencilView)
+{
+    log.Record(NULL_COMMAND_OM_SET_RENDER_TARGETS, (numViews > 0) ? (renderTargetViews[0]) : (nullptr), 0, numViews, depthStencilView != nullptr);
+}
+
+void NullGraphicsContext::OMSetRenderTargetsAndUnorderedAccessViews(UINT numRTVs, ID3D11RenderTargetView* const* renderTargetViews, ID3D11DepthStencilView* /*depthStencilView*/, UINT uavStartSlot, UINT numUAVs, ID3D11UnorderedAccessView* const* /*unorderedAccessViews*/, const UINT* /*initialCounts*/)
+{
+    log.Record(NULL_COMMAND_OM_SET_RENDER_TARGETS_AND_UNORDERED_ACCESS_VIEWS, (numRTVs > 0) ? (renderTargetViews[0]) : (nullptr), PIPELINE_STAGE::PIXEL_SHADER, numRTVs, uavStartSlot, numUAVs);
+}
+
+void NullGraphicsContext::OMSetBlendState(ID3D11BlendState* blendState, const FLOAT /*blendFactor*/[4], UINT sampleMask)
+{
+    log.Record(NULL_COMMAND_OM_SET_BLEND_STATE, blendState, 0, sampleMask);
+}
+
+void NullGraphicsContext::OMSetDepthStencilState(ID3D11DepthStencilState* depthStencilState, UINT stencilRef)
+{
+    log.Record(NULL_COMMAND_OM_SET_DEPTH_STENCIL_STATE, depthStencilState, 0, stencilRef);
+}
+
+void NullGraphicsContext::SetShaderResources(PIPELINE_STAGE stage, UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* shaderResourceViews)
+{
+    log.Record(NULL_COMMAND_SET_SHADER_RESOURCES, (numViews > 0) ? (shaderResourceViews[0]) : (nullptr), stage, startSlot, numViews);
+}
+
+void NullGraphicsContext::SetConstantBuffers(PIPELINE_STAGE stage, UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers)
+{
+    log.Record(NULL_COMMAND_SET_CONSTANT_BUFFERS, (numBuffers > 0) ? (constantBuffers[0]) : (nullptr), stage, startSlot, numBuffers);
+}
+
+void NullGraphicsContext::SetConstantBuffers1(PIPELINE_STAGE stage, UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers, const UINT* firstConstants, const UINT* /*numConstants*/)
+{
+    log.Record(NULL_COMMAND_SET_CONSTANT_BUFFERS_1, (numBuffers > 0) ? (constantBuffers[0]) : (nullptr), stage, startSlot, numBuffers, (numBuffers > 0 && firstConstants) ? (firstConstants[0]) : (0));
+}
+
+void NullGraphicsContext::SetSamplers(PIPELINE_STAGE stage, UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* samplerStates)
+{
+    log.Record(NULL_COMMAND_SET_SAMPLERS, (numSamplers > 0) ? (samplerStates[0]) : (nullptr), stage, startSlot, numSamplers);
+}
+
+void NullGraphicsContext::CSSetUnorderedAccessViews(UINT startSlot, UINT numUAVs, ID3D11UnorderedAccessView* const* unorderedAccessViews, const UINT* /*initialCounts*/)
+{
+    log.Record(NULL_COMMAND_CS_SET_UNORDERED_ACCESS_VIEWS, (numUAVs > 0) ? (unorderedAccessViews[0]) : (nullptr), PIPELINE_STAGE::COMPUTE_SHADER, startSlot, numUAVs);
+}
+
+void NullGraphicsContext::VSSetShader(ID3D11VertexShader* vertexShader)
+{
+    log.Record(NULL_COMMAND_VS_SET_SHADER, vertexShader, PIPELINE_STAGE::VERTEX_SHADER);
+}
+
+void NullGraphicsContext::PSSetShader(ID3D11PixelShader* pixelShader)
+{
+    log.Record(NULL_COMMAND_PS_SET_SHADER, pixelShader, PIPELINE_STAGE::PIXEL_SHADER);
+}
+
+void NullGraphicsContext::CSSetShader(ID3D11ComputeShader* computeShader)
+{
+    log.Record(NULL_COMMAND_CS_SET_SHADER, computeShader, PIPELINE_STAGE::COMPUTE_SHADER);
+}
+
+void NullGraphicsContext::IASetVertexBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* vertexBuffers, const UINT* /*strides*/, const UINT* /*offsets*/)
+{
+    log.Record(NULL_COMMAND_IA_SET_VERTEX_BUFFERS, (numBuffers > 0) ? (vertexBuffers[0]) : (nullptr), 0, startSlot, numBuffers);
+}
+
+void NullGraphicsContext::IASetIndexBuffer(ID3D11Buffer* indexBuffer, DXGI_FORMAT format, UINT offset)
+{
+    log.Record(NULL_COMMAND_IA_SET_INDEX_BUFFER, indexBuffer, 0, format, offset);
+}
+
+void NullGraphicsContext::IASetInputLayout(ID3D11InputLayout* inputLayout)
+{
+    log.Record(NULL_COMMAND_IA_SET_INPUT_LAYOUT, inputLayout);
+}
+
+void NullGraphicsContext::IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology)
+{
+    log.Record(NULL_COMMAND_IA_SET_PRIMITIVE_TOPOLOGY, nullptr, 0, topology);
+}
+
+void NullGraphicsContext::RSSetViewports(UINT numViewports, const D3D11_VIEWPORT* viewports)
+{
+    log.Record(NULL_COMMAND_RS_SET_VIEWPORTS, nullptr, 0, numViewports, (numViewports > 0) ? (static_cast<UINT>(viewports[0].Width)) : (0), (numViewports > 0) ? (static_cast<UINT>(viewports[0].Height)) : (0));
+}
+
+void NullGraphicsContext::RSSetState(ID3D11RasterizerState* rasterizerState)
+{
+    log.Record(NULL_COMMAND_RS_SET_STATE, rasterizerState);
+}
+
+void NullGraphicsContext::Draw(UINT vertexCount, UINT startVertexLocation)
+{
+    log.Record(NULL_COMMAND_DRAW, nullptr, 0, vertexCount, startVertexLocation);
+}
+
+void NullGraphicsContext::DrawIndexed(UINT indexCount, UINT startIndexLocation, INT baseVertexLocation)
+{
+    log.Record(NULL_COMMAND_DRAW_INDEXED, nullptr, 0, indexCount, startIndexLocation, static_cast<UINT>(baseVertexLocation));
+}
+
+void NullGraphicsContext::DrawInstanced(UINT vertexCountPerInstance, UINT instanceCount, UINT startVertexLocation, UINT /*startInstanceLocation*/)
+{
+    log.Record(NULL_COMMAND_DRAW_INSTANCED, nullptr, 0, vertexCountPerInstance, instanceCount, startVertexLocation);
+}
+
+void NullGraphicsContext::DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount, UINT startIndexLocation, INT /*baseVertexLocation*/, UINT /*startInstanceLocation*/)
+{
+    log.Record(NULL_COMMAND_DRAW_INDEXED_INSTANCED, nullptr, 0, indexCountPerInstance, instanceCount, startIndexLocation);
+}
+
+void NullGraphicsContext::DrawInstancedIndirect(ID3D11Buffer* argsBuffer, UINT alignedByteOffset)
+{
+    log.Record(NULL_COMMAND_DRAW_INSTANCED_INDIRECT, argsBuffer, 0, alignedByteOffset);
+}
+
+void NullGraphicsContext::DrawIndexedInstancedIndirect(ID3D11Buffer* argsBuffer, UINT alignedByteOffset)
+{
+    log.Record(NULL_COMMAND_DRAW_INDEXED_INSTANCED_INDIRECT, argsBuffer, 0, alignedByteOffset);
+}
+
+void NullGraphicsContext::Dispatch(UINT threadGroupCountX, UINT threadGroupCountY, UINT threadGroupCountZ)
+{
+    log.Record(NULL_COMMAND_DISPATCH, nullptr, PIPELINE_STAGE::COMPUTE_SHADER, threadGroupCountX, threadGroupCountY, threadGroupCountZ);
+}
+
+void NullGraphicsContext::DispatchIndirect(ID3D11Buffer* argsBuffer, UINT alignedByteOffset)
+{
+    log.Record(NULL_COMMAND_DISPATCH_INDIRECT, argsBuffer, PIPELINE_STAGE::COMPUTE_SHADER, alignedByteOffset);
+}
+
+void NullGraphicsContext::CopyStructureCount(ID3D11Buffer* destinationBuffer, UINT destinationAlignedByteOffset, ID3D11UnorderedAccessView* /*sourceView*/)
+{
+    log.Record(NULL_COMMAND_COPY_STRUCTURE_COUNT, destinationBuffer, 0, destinationAlignedByteOffset);
+}
+
+void NullGraphicsContext::CopySubresourceRegion(ID3D11Resource* destination, UINT destinationSubresource, UINT destinationX, UINT /*destinationY*/, UINT /*destinationZ*/, ID3D11Resource* source, UINT sourceSubresource, const D3D11_BOX* sourceBox)
+{
+    log.Record(NULL_COMMAND_COPY_SUBRESOURCE_REGION, destination, 0, destinationSubresource, sourceSubresource, (sourceBox) ? (1) : (0));
+    if (!destination || !source) { return; }
+
+    //Buffer contents are carried across, so reading back a buffer created with data (or mapped) returns it
+    NullObject* d{ Reveal(destination) };
+    const NullObject* s{ Reveal(source) };
+    if (d->type != NULL_OBJECT_BUFFER || s->type != NULL_OBJECT_BUFFER || s->storage.empty()) { return; }
+    const UINT begin{ (sourceBox) ? (sourceBox->left) : (0) };
+    const UINT end{ (std::min)((sourceBox) ? (sourceBox->right) : (s->desc.buffer.ByteWidth), static_cast<UINT>(s->storage.size())) };
+    if (begin >= end || destinationX + (end - begin) > d->desc.buffer.ByteWidth) { return; }
+    if (d->storage.size() < d->desc.buffer.ByteWidth) { d->storage.resize(d->desc.buffer.ByteWidth); }
+    std::memcpy(d->storage.data() + destinationX, s->storage.data() + begin, end - begin);
+}
+
+void NullGraphicsContext::UpdateSubresource(ID3D11Resource* destination, UINT destinationSubresource, const D3D11_BOX* /*destinationBox*/, const void* /*sourceData*/, UINT sourceRowPitch, UINT sourceDepthPitch)
+{
+    log.Record(NULL_COMMAND_UPDATE_SUBRESOURCE, destination, 0, destinationSubresource, sourceRowPitch, sourceDepthPitch);
+}
+
+void NullGraphicsContext::SetResourceMinLOD(ID3D11Resource* resource, FLOAT minLOD)
+{
+    //Recorded in 1/256ths of a level
+    log.Record(NULL_COMMAND_SET_RESOURCE_MIN_LOD, resource, 0, static_cast<UINT>(minLOD * 256.0f));
+}
+
+HRESULT NullGraphicsContext::Map(ID3D11Resource* resource, UINT subresource, D3D11_MAP mapType, UINT mapFlags, D3D11_MAPPED_SUBRESOURCE* mappedResource)
+{
+    if (!resource || !mappedResource) { return E_INVALIDARG; }
+    NullObject* o{ Reveal(resource) };
+
+    //Mirror the runtime's validation of the map type against the resource's usage
+    D3D11_USAGE usage;
+    UINT rowPitch{ 0 };
+    UINT depthPitch{ 0 };
+    size_t size{ 0 };
+    switch (o->type)
+    {
+    case (NULL_OBJECT_BUFFER):     usage = o->desc.buffer.Usage;    size = o->desc.buffer.ByteWidth; break;
+    case (NULL_OBJECT_TEXTURE_1D): usage = o->desc.texture1D.Usage; rowPitch = o->desc.texture1D.Width * 16; size = rowPitch; break;
+    case (NULL_OBJECT_TEXTURE_2D): usage = o->desc.texture2D.Usage; rowPitch = o->desc.texture2D.Width * 16; depthPitch = rowPitch * o->desc.texture2D.Height; size = depthPitch; break;
+    case (NULL_OBJECT_TEXTURE_3D): usage = o->desc.texture3D.Usage; rowPitch = o->desc.texture3D.Width * 16; depthPitch = rowPitch * o->desc.texture3D.Height; size = static_cast<size_t>(depthPitch) * o->desc.texture3D.Depth; break;
+    default: return E_INVALIDARG;
+    }
+    const bool discardOrNoOverwrite{ mapType == D3D11_MAP_WRITE_DISCARD || mapType == D3D11_MAP_WRITE_NO_OVERWRITE };
+    if (discardOrNoOverwrite && usage != D3D11_USAGE_DYNAMIC) { return E_INVALIDARG; }
+    if (!discardOrNoOverwrite && usage != D3D11_USAGE_STAGING) { return E_INVALIDARG; }
+    //Deferred contexts can only map dynamic resources for writing
+    if (deferred && !discardOrNoOverwrite) { return E_INVALIDARG; }
+
+    //Texels are assumed to be at most 16 bytes, which over-allocates but never under-allocates
+    if (o->storage.size() < size) { o->storage.resize(size); }
+    mappedResource->pData = o->storage.data();
+    mappedResource->RowPitch = rowPitch;
+    mappedResource->DepthPitch = depthPitch;
+    log.Record(NULL_COMMAND_MAP, resource, 0, subresource, mapType, mapFlags);
+    return S_OK;
+}
+
+void NullGraphicsContext::Unmap(ID3D11Resource* resource, UINT subresource)
+{
+    log.Record(NULL_COMMAND_UNMAP, resource, 0, subresource);
+}
+
+HRESULT NullGraphicsContext::FinishCommandList(ID3D11CommandList** commandList)
+{
+    if (!deferred || !commandList) { return E_INVALIDARG; }
+
+    std::lock_guard<std::mutex> lock{ device->mutex };
+    NullObject* o{ device->CreateObject(NULL_OBJECT_COMMAND_LIST, nullptr) };
+    o->commands = log.GetCommands();
+    log.Clear();
+    log.Record(NULL_COMMAND_FINISH_COMMAND_LIST, o, 0, static_cast<UINT>(o->commands.size()));
+    *commandList = Disguise<ID3D11CommandList>(o);
+    return S_OK;
+}
+
+void NullGraphicsContext::ExecuteCommandList(ID3D11CommandList* commandList)
+{
+    if (deferred || !commandList) { return; }
+
+    const NullObject* o{ Reveal(commandList) };
+    log.Record(NULL_COMMAND_EXECUTE_COMMAND_LIST, commandList, 0, static_cast<UINT>(o->commands.size()));
+    for (const NullCommand& c : o->commands)
+    {
+        log.Record(static_cast<NULL_COMMAND_TYPE>(c.type), c.object, c.stage, c.args[0], c.args[1], c.args[2]);
+        //Queries ended in a command list take their result from when the list runs, not when it was recorded
+        if (c.type == NULL_COMMAND_END_QUERY) { ResolveQuery(Reveal(c.object)); }
+    }
+    //The immediate context is left in its default state afterwards
+    log.Record(NULL_COMMAND_CLEAR_STATE, nullptr);
+}
+
+void NullGraphicsContext::Begin(ID3D11Asynchronous* async)
+{
+    log.Record(NULL_COMMAND_BEGIN_QUERY, async);
+}
+
+void NullGraphicsContext::End(ID3D11Asynchronous* async)
+{
+    log.Record(NULL_COMMAND_END_QUERY, async);
+    if (!deferred) { ResolveQuery(Reveal(async)); }
+}
+
+HRESULT NullGraphicsContext::GetData(ID3D11Asynchronous* async, void* data, UINT dataSize, UINT /*getDataFlags*/)
+{
+    //Results can only be read on the immediate context
+    if (deferred || !async) { return E_INVALIDARG; }
+    const NullObject* o{ Reveal(async) };
+    if (o->type != NULL_OBJECT_QUERY) { return E_INVALIDARG; }
+    if (data && !o->storage.empty() && dataSize != o->storage.size()) { return E_INVALIDARG; }
+
+    {
+        std::lock_guard<std::mutex> lock{ device->mutex };
+        if (o->storage.empty() || device->presentCount < o->availablePresent) { return S_FALSE; }
+    }
+    if (data) { std::memcpy(data, o->storage.data(), dataSize); }
+    return S_OK;
+}
+
+void NullGraphicsContext::ResolveQuery(NullObject* query)
+{
+    std::lock_guard<std::mutex> lock{ device->mutex };
+    query->availablePresent = device->presentCount + device->queryLatency;
+    switch (query->desc.query.Query)
+    {
+    case (D3D11_QUERY_TIMESTAMP):
+    {
+        const UINT64 timestamp{ log.GetSyntheticTime() };
+        query->storage.resize(sizeof(timestamp));
+        std::memcpy(query->storage.data(), &timestamp, sizeof(timestamp));
+        break;
+    }
+    case (D3D11_QUERY_TIMESTAMP_DISJOINT):
+    {
+        const D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint{ NULL_TIMESTAMP_FREQUENCY, device->timestampsDisjoint };
+        query->storage.resize(sizeof(disjoint));
+        std::memcpy(query->storage.data(), &disjoint, sizeof(disjoint));
+        break;
+    }
+    default:
+    {
+        //Event queries - and anything else, which is only ever checked for completion
+        const BOOL done{ TRUE };
+        query->storage.resize(sizeof(done));
+        std::memcpy(query->storage.data(), &done, sizeof(done));
+        break;
+    }
+    }
+}
+
+void NullGraphicsContext::ClearRenderTargetView(ID3D11RenderTargetView* renderTargetView, const FLOAT /*colour*/[4])
+{
+    log.Record(NULL_COMMAND_CLEAR_RENDER_TARGET_VIEW, renderTargetView);
+}
+
+void NullGraphicsContext::ClearDepthStencilView(ID3D11DepthStencilView* depthStencilView, UINT clearFlags, FLOAT /*depth*/, UINT8 stencil)
+{
+    log.Record(NULL_COMMAND_CLEAR_DEPTH_STENCIL_VIEW, depthStencilView, 0, clearFlags, stencil);
+}
+
+void NullGraphicsContext::ClearUnorderedAccessViewFloat(ID3D11UnorderedAccessView* unorderedAccessView, const FLOAT /*values*/[4])
+{
+    log.Record(NULL_COMMAND_CLEAR_UNORDERED_ACCESS_VIEW_FLOAT, unorderedAccessView);
+}
+
+void NullGraphicsContext::ClearUnorderedAccessViewUint(ID3D11UnorderedAccessView* unorderedAccessView, const UINT /*values*/[4])
+{
+    log.Record(NULL_COMMAND_CLEAR_UNORDERED_ACCESS_VIEW_UINT, unorderedAccessView);
+}
+//-----------------------------------------------//
+//----------------END OF CONTEXT-----------------//
+//-----------------------------------------------//
+
+
+
+//-----------------------------------------------//
+//--------------------DEVICE---------------------//
+//-----------------------------------------------//
+NullGraphicsDevice::~NullGraphicsDevice()
+{
+    if (!liveObjects.empty())
+    {
+        std::cerr << "ERROR::NULL_GRAPHICS_DEVICE::DESTRUCTOR::" << liveObjects.size() << "_OBJECTS_WERE_NEVER_RELEASED" << std::endl;
+    }
+    for (NullObject* o : liveObjects)
+    {
+        delete o;
+    }
+}
+
+NullObject* NullGraphicsDevice::CreateObject(NULL_OBJECT_TYPE type, const void* resource)
+{
+    NullObject* o{ new NullObject{} };
+    o->type = type;
+    o->refCount = 1;
+    o->resource = resource;
+    if (resource) { ++Reveal(resource)->refCount; }
+    liveObjects.insert(o);
+    return o;
+}
+
+HRESULT NullGraphicsDevice::CreateBuffer(const D3D11_BUFFER_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Buffer** buffer)
+{
+    if (!desc || (desc->Usage == D3D11_USAGE_IMMUTABLE && !initialData)) { return E_INVALIDARG; }
+
+    std::lock_guard<std::mutex> lock{ mutex };
+    NullObject* o{ CreateObject(NULL_OBJECT_BUFFER, nullptr) };
+    o->desc.buffer = *desc;
+    if (initialData && initialData->pSysMem)
+    {
+        const BYTE* data{ static_cast<const BYTE*>(initialData->pSysMem) };
+        o->storage.assign(data, data + desc->ByteWidth);
+    }
+    log.Record(NULL_COMMAND_CREATE_BUFFER, o, 0, desc->ByteWidth, desc->BindFlags, desc->Usage);
+    *buffer = Disguise<ID3D11Buffer>(o);
+    return S_OK;
+}
+
+HRESULT NullGraphicsDevice::CreateTexture1D(const D3D11_TEXTURE1D_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Texture1D** texture)
+{
+    if (!desc || (desc->Usage == D3D11_USAGE_IMMUTABLE && !initialData)) { return E_INVALIDARG; }
+
+    std::lock_guard<std::mutex> lock{ mutex };
+    NullObject* o{ CreateObject(NULL_OBJECT_TEXTURE_1D, nullptr) };
+    o->desc.texture1D = *desc;
+    log.Record(NULL_COMMAND_CREATE_TEXTURE_1D, o, 0, desc->Width, desc->BindFlags, desc->Format);
+    *texture = Disguise<ID3D11Texture1D>(o);
+    return S_OK;
+}
+
+HRESULT NullGraphicsDevice::CreateTexture2D(const D3D11_TEXTURE2D_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Texture2D** texture)
+{
+    if (!desc || (desc->Usage == D3D11_USAGE_IMMUTABLE && !initialData)) { return E_INVALIDARG; }
+
+    std::lock_guard<std::mutex> lock{ mutex };
+    NullObject* o{ CreateObject(NULL_OBJECT_TEXTURE_2D, nullptr) };
+    o->desc.texture2D = *desc;
+    log.Record(NULL_COMMAND_CREATE_TEXTURE_2D, o, 0, desc->Width, desc->Height, desc->Format);
+    *texture = Disguise<ID3D11Texture2D>(o);
+    return S_OK;
+}
+
+HRESULT NullGraphicsDevice::CreateTexture3D(const D3D11_TEXTURE3D_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Texture3D** texture)
+{
+    if (!desc || (desc->Usage == D3D11_USAGE_IMMUTABLE && !initialData)) { return E_INVALIDARG; }
+
+    std::lock_guard<std::mutex> lock{ mutex };
+    NullObject* o{ CreateObject(NULL_OBJECT_TEXTURE_3D, nullptr) };
+    o->desc.texture3D = *desc;
+    log.Record(NULL_COMMAND_CREATE_TEXTURE_3D, o, 0, desc->Width, desc->Height, desc->Depth);
+    *texture = Disguise<ID3D11Texture3D>(o);
+    return S_OK;
+}
+
+void NullGraphicsDevice::GetBufferDesc(ID3D11Buffer* buffer, D3D11_BUFFER_DESC* desc)
+{
+    *desc = Reveal(buffer)->desc.buffer;
+}
+
+void NullGraphicsDevice::GetTexture2DDesc(ID3D11Texture2D* texture, D3D11_TEXTURE2D_DESC* desc)
+{
+    *desc = Reveal(texture)->desc.texture2D;
+    //As D3D11 reports it, a full mip chain requested with 0 levels has its actual count
+    if (desc->MipLevels == 0)
+    {
+        for (UINT size{ (std::max)(desc->Width, desc->Height) }; size > 0; size >>= 1) { ++desc->MipLevels; }
+    }
+}
+
+HRESULT NullGraphicsDevice::CreateShaderResourceView(ID3D11Resource* resource, const D3D11_SHADER_RESOURCE_VIEW_DESC* desc, ID3D11ShaderResourceView** view)
+{
+    if (!resource) { return E_INVALIDARG; }
+
+    std::lock_guard<std::mutex> lock{ mutex };
+    NullObject* o{ CreateObject(NULL_OBJECT_VIEW, resource) };
+    log.Record(NULL_COMMAND_CREATE_SHADER_RESOURCE_VIEW, o, 0, (desc) ? (desc->ViewDimension) : (0));
+    *view = Disguise<ID3D11ShaderResourceView>(o);
+    return S_OK;
+}
+
+HRESULT NullGraphicsDevice::CreateUnorderedAccessView(ID3D11Resource* resource, const D3D11_UNORDERED_ACCESS_VIEW_DESC* desc, ID3D11UnorderedAccessView** view)
+{
+    if (!resource) { return E_INVALIDARG; }
+
+    std::lock_guard<std::mutex> lock{ mutex };
+    NullObject* o{ CreateObject(NULL_OBJECT_VIEW, resource) };
+    log.Record(NULL_COMMAND_CREATE_UNORDERED_ACCESS_VIEW, o, 0, (desc) ? (desc->ViewDimension) : (0));
+    *view = Disguise<ID3D11UnorderedAccessView>(o);
+    return S_OK;
+}
+
+HRESULT NullGraphicsDevice::CreateRenderTargetView(ID3D11Resource* resource, const D3D11_RENDER_TARGET_VIEW_DESC* desc, ID3D11RenderTargetView** view)
+{
+    if (!resource) { return E_INVALIDARG; }
+
+    std::lock_guard<std::mutex> lock{ mutex };
+    NullObject* o{ CreateObject(NULL_OBJECT_VIEW, resource) };
+    log.Record(NULL_COMMAND_CREATE_RENDER_TARGET_VIEW, o, 0, (desc) ? (desc->ViewDimension) : (0));
+    *view = Disguise<ID3D11RenderTargetView>(o);
+    return S_OK;
+}
+
+HRESULT NullGraphicsDevice::CreateDepthStencilView(ID3D11Resource* resource, const D3D11_DEPTH_STENCIL_VIEW_DESC* desc, ID3D11DepthStencilView** view)
+{
+    if (!resource) { return E_INVALIDARG; }
+
+    std::lock_guard<std::mutex> lock{ mutex };
+    NullObject* o{ CreateObject(NULL_OBJECT_VIEW, resource) };
+    log.Record(NULL_COMMAND_CREATE_DEPTH_STENCIL_VIEW, o, 0, (desc) ? (desc->ViewDimension) : (0));
+    *view = Disguise<ID3D11DepthStencilView>(o);
+    return S_OK;
+}
+
+ID3D11Resource* NullGraphicsDevice::GetViewResource(ID3D11View* view)
+{
+    //A view's resource never changes after creation, so there is nothing to lock
+    return (view) ? (Disguise<ID3D11Resource>(Reveal(Reveal(view)->resource))) : (nullptr);
+}
+
+HRESULT NullGraphicsDevice::CreateDeferredContext(GraphicsContext** context)
+{
+    if (!context) { return E_INVALIDARG; }
+
+    std::lock_guard<std::mutex> lock{ mutex };
+    NullGraphicsContext* deferredContext{ new NullGraphicsContext(this, true) };
+    log.Record(NULL_COMMAND_CREATE_DEFERRED_CONTEXT, deferredContext);
+    *context = deferredContext;
+    return S_OK;
+}
+
+HRESULT NullGraphicsDevice::CreateSamplerState(const D3D11_SAMPLER_DESC* desc, ID3D11SamplerState** samplerState)
+{
+    if (!desc) { return E_INVALIDARG; }
+
+    std::lock_guard<std::mutex> lock{ mutex };
+    NullObject* o{ CreateObject(NULL_OBJECT_STATE, nullptr) };
+    log.Record(NULL_COMMAND_CREATE_SAMPLER_STATE, o, 0, desc->Filter);
+    *samplerState = Disguise<ID3D11SamplerState>(o);
+    return S_OK;
+}
+
+HRESULT NullGraphicsDevice::CreateBlendState(const D3D11_BLEND_DESC* desc, ID3D11BlendState** blendState)
+{
+    if (!desc) { return E_INVALIDARG; }
+
+    std::lock_guard<std::mutex> lock{ mutex };
+    NullObject* o{ CreateObject(NULL_OBJECT_STATE, nullptr) };
+    log.Record(NULL_COMMAND_CREATE_BLEND_STATE, o, 0, desc->RenderTarget[0].BlendEnable);
+    *blendState = Disguise<ID3D11BlendState>(o);
+    return S_OK;
+}
+
+HRESULT NullGraphicsDevice::CreateRasterizerState(const D3D11_RASTERIZER_DESC* desc, ID3D11RasterizerState** rasterizerState)
+{
+    if (!desc) { return E_INVALIDARG; }
+
+    std::lock_guard<std::mutex> lock{ mutex };
+    NullObject* o{ CreateObject(NULL_OBJECT_STATE, nullptr) };
+    log.Record(NULL_COMMAND_CREATE_RASTERIZER_STATE, o, 0, desc->FillMode, desc->CullMode);
+    *rasterizerState = Disguise<ID3D11RasterizerState>(o);
+    return S_OK;
+}
+
+HRESULT NullGraphicsDevice::CreateDepthStencilState(const D3D11_DEPTH_STENCIL_DESC* desc, ID3D11DepthStencilState** depthStencilState)
+{
+    if (!desc) { return E_INVALIDARG; }
+
+    std::lock_guard<std::mutex> lock{ mutex };
+    NullObject* o{ CreateObject(NULL_OBJECT_STATE, nullptr) };
+    log.Record(NULL_COMMAND_CREATE_DEPTH_STENCIL_STATE, o, 0, desc->DepthEnable, desc->DepthFunc);
+    *depthStencilState = Disguise<ID3D11DepthStencilState>(o);
+    return S_OK;
+}
+
+HRESULT NullGraphicsDevice::CreateVertexShader(const void* bytecode, SIZE_T bytecodeLength, ID3D11VertexShader** vertexShader)
+{
+    if (!bytecode || bytecodeLength == 0) { return E_INVALIDARG; }
+
+    std::lock_guard<std::mutex> lock{ mutex };
+    NullObject* o{ CreateObject(NULL_OBJECT_SHADER, nullptr) };
+    log.Record(NULL_COMMAND_CREATE_VERTEX_SHADER, o, 0, static_cast<UINT>(bytecodeLength));
+    *vertexShader = Disguise<ID3D11VertexShader>(o);
+    return S_OK;
+}
+
+HRESULT NullGraphicsDevice::CreatePixelShader(const void* bytecode, SIZE_T bytecodeLength, ID3D11PixelShader** pixelShader)
+{
+    if (!bytecode || bytecodeLength == 0) { return E_INVALIDARG; }
+
+    std::lock_guard<std::mutex> lock{ mutex };
+    NullObject* o{ CreateObject(NULL_OBJECT_SHADER, nullptr) };
+    log.Record(NULL_COMMAND_CREATE_PIXEL_SHADER, o, 0, static_cast<UINT>(bytecodeLength));
+    *pixelShader = Disguise<ID3D11PixelShader>(o);
+    return S_OK;
+}
+
+HRESULT NullGraphicsDevice::CreateComputeShader(const void* bytecode, SIZE_T bytecodeLength, ID3D11ComputeShader** computeShader)
+{
+    if (!bytecode || bytecodeLength == 0) { return E_INVALIDARG; }
+
+    std::lock_guard<std::mutex> lock{ mutex };
+    NullObject* o{ CreateObject(NULL_OBJECT_SHADER, nullptr) };
+    log.Record(NULL_COMMAND_CREATE_COMPUTE_SHADER, o, 0, static_cast<UINT>(bytecodeLength));
+    *computeShader = Disguise<ID3D11ComputeShader>(o);
+    return S_OK;
+}
+
+HRESULT NullGraphicsDevice::CreateInputLayout(const D3D11_INPUT_ELEMENT_DESC* elements, UINT numElements, const void* bytecode, SIZE_T bytecodeLength, ID3D11InputLayout** inputLayout)
+{
+    if (!elements || numElements == 0 || !bytecode || bytecodeLength == 0) { return E_INVALIDARG; }
+
+    std::lock_guard<std::mutex> lock{ mutex };
+    NullObject* o{ CreateObject(NULL_OBJECT_INPUT_LAYOUT, nullptr) };
+    log.Record(NULL_COMMAND_CREATE_INPUT_LAYOUT, o, 0, numElements);
+    *inputLayout = Disguise<ID3D11InputLayout>(o);
+    return S_OK;
+}
+
+HRESULT NullGraphicsDevice::CreateQuery(const D3D11_QUERY_DESC* desc, ID3D11Query** query)
+{
+    if (!desc) { return E_INVALIDARG; }
+
+    std::lock_guard<std::mutex> lock{ mutex };
+    NullObject* o{ CreateObject(NULL_OBJECT_QUERY, nullptr) };
+    o->desc.query = *desc;
+    log.Record(NULL_COMMAND_CREATE_QUERY, o, 0, desc->Query);
+    *query = Disguise<ID3D11Query>(o);
+    return S_OK;
+}
+
+HRESULT NullGraphicsDevice::CreateSwapChain(HWND /*hwnd*/, const DXGI_SWAP_CHAIN_DESC* desc, GraphicsSwapChain** swapChain)
+{
+    if (!desc) { return E_INVALIDARG; }
+
+    //Same restrictions as DXGI
+    const bool flipModel{ desc->SwapEffect == DXGI_SWAP_EFFECT_FLIP_DISCARD || desc->SwapEffect == DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL };
+    if (flipModel && (desc->BufferCount < 2 || desc->SampleDesc.Count != 1)) { return E_INVALIDARG; }
+    if (!flipModel && (desc->Flags & (DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING | DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT))) { return E_INVALIDARG; }
+
+    std::lock_guard<std::mutex> lock{ mutex };
+    NullObject* backBuffer{ CreateObject(NULL_OBJECT_TEXTURE_2D, nullptr) };
+    D3D11_TEXTURE2D_DESC& td{ backBuffer->desc.texture2D };
+    td.Width = desc->BufferDesc.Width;
+    td.Height = desc->BufferDesc.Height;
+    td.MipLevels = 1;
+    td.ArraySize = 1;
+    td.Format = desc->BufferDesc.Format;
+    td.SampleDesc = desc->SampleDesc;
+    td.Usage = D3D11_USAGE_DEFAULT;
+    td.BindFlags = D3D11_BIND_RENDER_TARGET;
+
+    *swapChain = new NullGraphicsSwapChain(this, backBuffer);
+    log.Record(NULL_COMMAND_CREATE_SWAP_CHAIN, *swapChain, 0, td.Width, td.Height, desc->BufferCount);
+    return S_OK;
+}
+
+void NullGraphicsDevice::ReleaseObject(IUnknown* object)
+{
+    if (!object) { return; }
+
+    std::lock_guard<std::mutex> lock{ mutex };
+    NullObject* o{ Reveal(object) };
+    if (liveObjects.find(o) == liveObjects.end())
+    {
+        std::cerr << "ERROR::NULL_GRAPHICS_DEVICE::RELEASE_OBJECT::OBJECT_NOT_CREATED_BY_THIS_DEVICE_OR_ALREADY_DESTROYED" << std::endl;
+        return;
+    }
+    log.Record(NULL_COMMAND_RELEASE_OBJECT, o, 0, o->refCount - 1);
+    //Destroying a view drops its reference to the resource, which may destroy that in turn
+    while (o && --o->refCount == 0)
+    {
+        NullObject* resource{ (o->resource) ? (Reveal(o->resource)) : (nullptr) };
+        liveObjects.erase(o);
+        delete o;
+        o = resource;
+    }
+}
+
+size_t NullGraphicsDevice::GetLiveObjectCount()
+{
+    std::lock_guard<std::mutex> lock{ mutex };
+    return liveObjects.size();
+}
+//-----------------------------------------------//
+//-----------------END OF DEVICE-----------------//
+//-----------------------------------------------//
\ No newline at end of file
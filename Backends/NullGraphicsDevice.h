@@ -0,0 +1,333 @@
+﻿#pragma once
+
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include "GraphicsDevice.h"
+
+//Headless implementation - no GPU, no window
+//Every call is appended to a compact command log so CPU-side engine cost can be measured and verified on machines without D3D11 hardware
+//Created objects are small placeholder records (tracking their description and reference count) disguised as the requested interface pointer
+
+
+enum NULL_COMMAND_TYPE
+{
+    //Device
+    NULL_COMMAND_CREATE_BUFFER,
+    NULL_COMMAND_CREATE_TEXTURE_1D,
+    NULL_COMMAND_CREATE_TEXTURE_2D,
+    NULL_COMMAND_CREATE_TEXTURE_3D,
+    NULL_COMMAND_CREATE_SHADER_RESOURCE_VIEW,
+    NULL_COMMAND_CREATE_UNORDERED_ACCESS_VIEW,
+    NULL_COMMAND_CREATE_RENDER_TARGET_VIEW,
+    NULL_COMMAND_CREATE_DEPTH_STENCIL_VIEW,
+    NULL_COMMAND_CREATE_SAMPLER_STATE,
+    NULL_COMMAND_CREATE_BLEND_STATE,
+    NULL_COMMAND_CREATE_RASTERIZER_STATE,
+    NULL_COMMAND_CREATE_DEPTH_STENCIL_STATE,
+    NULL_COMMAND_CREATE_VERTEX_SHADER,
+    NULL_COMMAND_CREATE_PIXEL_SHADER,
+    NULL_COMMAND_CREATE_COMPUTE_SHADER,
+    NULL_COMMAND_CREATE_INPUT_LAYOUT,
+    NULL_COMMAND_CREATE_QUERY,
+    NULL_COMMAND_CREATE_SWAP_CHAIN,
+    NULL_COMMAND_CREATE_DEFERRED_CONTEXT,
+    NULL_COMMAND_RELEASE_OBJECT,
+
+    //Context
+    NULL_COMMAND_CLEAR_STATE,
+    NULL_COMMAND_OM_SET_RENDER_TARGETS,
+    NULL_COMMAND_OM_SET_RENDER_TARGETS_AND_UNORDERED_ACCESS_VIEWS,
+    NULL_COMMAND_OM_SET_BLEND_STATE,
+    NULL_COMMAND_OM_SET_DEPTH_STENCIL_STATE,
+    NULL_COMMAND_SET_SHADER_RESOURCES,
+    NULL_COMMAND_SET_CONSTANT_BUFFERS,
+    NULL_COMMAND_SET_CONSTANT_BUFFERS_1,
+    NULL_COMMAND_SET_SAMPLERS,
+    NULL_COMMAND_CS_SET_UNORDERED_ACCESS_VIEWS,
+    NULL_COMMAND_VS_SET_SHADER,
+    NULL_COMMAND_PS_SET_SHADER,
+    NULL_COMMAND_CS_SET_SHADER,
+    NULL_COMMAND_IA_SET_VERTEX_BUFFERS,
+    NULL_COMMAND_IA_SET_INDEX_BUFFER,
+    NULL_COMMAND_IA_SET_INPUT_LAYOUT,
+    NULL_COMMAND_IA_SET_PRIMITIVE_TOPOLOGY,
+    NULL_COMMAND_RS_SET_VIEWPORTS,
+    NULL_COMMAND_RS_SET_STATE,
+    NULL_COMMAND_DRAW,
+    NULL_COMMAND_DRAW_INDEXED,
+    NULL_COMMAND_DRAW_INSTANCED,
+    NULL_COMMAND_DRAW_INDEXED_INSTANCED,
+    NULL_COMMAND_DRAW_INSTANCED_INDIRECT,
+    NULL_COMMAND_DRAW_INDEXED_INSTANCED_INDIRECT,
+    NULL_COMMAND_DISPATCH,
+    NULL_COMMAND_DISPATCH_INDIRECT,
+    NULL_COMMAND_COPY_STRUCTURE_COUNT,
+    NULL_COMMAND_COPY_SUBRESOURCE_REGION,
+    NULL_COMMAND_UPDATE_SUBRESOURCE,
+    NULL_COMMAND_SET_RESOURCE_MIN_LOD,
+    NULL_COMMAND_MAP,
+    NULL_COMMAND_UNMAP,
+    NULL_COMMAND_FINISH_COMMAND_LIST,
+    NULL_COMMAND_EXECUTE_COMMAND_LIST,
+    NULL_COMMAND_BEGIN_QUERY,
+    NULL_COMMAND_END_QUERY,
+    NULL_COMMAND_CLEAR_RENDER_TARGET_VIEW,
+    NULL_COMMAND_CLEAR_DEPTH_STENCIL_VIEW,
+    NULL_COMMAND_CLEAR_UNORDERED_ACCESS_VIEW_FLOAT,
+    NULL_COMMAND_CLEAR_UNORDERED_ACCESS_VIEW_UINT,
+
+    //Swapchain
+    NULL_COMMAND_PRESENT,
+    NULL_COMMAND_RESIZE_BUFFERS,
+
+    NULL_COMMAND_TYPE_COUNT,
+};
+
+//One recorded call
+struct NullCommand
+{
+    const void* object; //Primary object the call operated on (created object, first bound view/buffer, ...)
+    UINT16 type;        //NULL_COMMAND_TYPE
+    UINT16 stage;       //PIPELINE_STAGE for per-stage calls
+    UINT args[3];       //Call-specific arguments, typically start slot and count
+};
+
+
+//Ticks per second of the synthetic GPU clock, so one tick is one nanosecond
+constexpr UINT64 NULL_TIMESTAMP_FREQUENCY{ 1000000000 };
+
+class NullCommandLog
+{
+public:
+    void Record(NULL_COMMAND_TYPE type, const void* object, UINT stage=0, UINT arg0=0, UINT arg1=0, UINT arg2=0);
+    void Clear();
+
+    //When disabled only the per-type counters are kept, so long benchmark runs don't grow the log without bound
+    void SetKeepCommands(bool _keepCommands) { keepCommands = _keepCommands; }
+
+    //Every recorded call advances a synthetic GPU clock (which Clear() leaves alone) by a fixed cost - draws and dispatches by drawTicks, anything else by commandTicks
+    //Timestamp queries read this clock, so GPU timings are deterministic on machines without a GPU
+    void SetSyntheticCosts(UINT64 _commandTicks, UINT64 _drawTicks) { commandTicks = _commandTicks; drawTicks = _drawTicks; }
+
+    [[nodiscard]] const std::vector<NullCommand>& GetCommands() const { return commands; }
+    [[nodiscard]] UINT64 GetCount(NULL_COMMAND_TYPE type) const { return counts[type]; }
+    [[nodiscard]] UINT64 GetTotalCount() const;
+    [[nodiscard]] UINT64 GetSyntheticTime() const { return syntheticTime; }
+
+private:
+    std::vector<NullCommand> commands;
+    UINT64 counts[NULL_COMMAND_TYPE_COUNT]{};
+    bool keepCommands{ true };
+
+    UINT64 syntheticTime{ 0 };
+    UINT64 commandTicks{ 100 };
+    UINT64 drawTicks{ 10000 };
+};
+
+
+enum NULL_OBJECT_TYPE
+{
+    NULL_OBJECT_BUFFER,
+    NULL_OBJECT_TEXTURE_1D,
+    NULL_OBJECT_TEXTURE_2D,
+    NULL_OBJECT_TEXTURE_3D,
+    NULL_OBJECT_VIEW,
+    NULL_OBJECT_STATE,
+    NULL_OBJECT_SHADER,
+    NULL_OBJECT_INPUT_LAYOUT,
+    NULL_OBJECT_COMMAND_LIST,
+    NULL_OBJECT_QUERY,
+};
+
+struct NullObject
+{
+    NULL_OBJECT_TYPE type;
+    UINT refCount;
+    const void* resource; //Resource a view was created on - the view holds a reference to it, as in D3D11
+    union
+    {
+        D3D11_BUFFER_DESC buffer;
+        D3D11_TEXTURE1D_DESC texture1D;
+        D3D11_TEXTURE2D_DESC texture2D;
+        D3D11_TEXTURE3D_DESC texture3D;
+        D3D11_QUERY_DESC query;
+    } desc;
+    std::vector<BYTE> storage; //CPU copy of the contents, allocated on the first Map (or from initial data) - only the top level of a texture is backed
+                               //For queries, the result written when the query ends
+    std::vector<NullCommand> commands; //Calls baked into a command list
+    UINT64 availablePresent; //Queries - the result can be read back once the device has presented this many times
+};
+
+
+class NullGraphicsDevice;
+
+class NullGraphicsSwapChain : public GraphicsSwapChain
+{
+public:
+    NullGraphicsSwapChain(NullGraphicsDevice* _device, NullObject* _backBuffer);
+    ~NullGraphicsSwapChain() override;
+
+    HRESULT GetBuffer(UINT buffer, ID3D11Texture2D** texture) override;
+    HRESULT Present(UINT syncInterval, UINT flags) override;
+    HRESULT ResizeBuffers(UINT bufferCount, UINT width, UINT height, DXGI_FORMAT format, UINT flags) override;
+
+    //There is no display to wait on, so no waitable object is ever handed out
+    [[nodiscard]] HANDLE GetFrameLatencyWaitableObject() override { return nullptr; }
+    HRESULT SetMaximumFrameLatency(UINT /*maxLatency*/) override { return DXGI_ERROR_INVALID_CALL; }
+
+private:
+    NullGraphicsDevice* device;
+    NullObject* backBuffer;
+};
+
+
+//Deferred contexts always keep their commands, since finishing a command list moves them into it - executing the list
+//on the immediate context then appends them to the immediate log, so the log shows exactly what the GPU would run and in what order
+class NullGraphicsContext : public GraphicsContext
+{
+public:
+    NullGraphicsContext(NullGraphicsDevice* _device, bool _deferred) : device{ _device }, deferred{ _deferred } {}
+    ~NullGraphicsContext() override = default;
+
+    void ClearState() override;
+
+    void OMSetRenderTargets(UINT numViews, ID3D11RenderTargetView* const* renderTargetViews, ID3D11DepthStencilView* depthStencilView) override;
+    void OMSetRenderTargetsAndUnorderedAccessViews(UINT numRTVs, ID3D11RenderTargetView* const* renderTargetViews, ID3D11DepthStencilView* depthStencilView, UINT uavStartSlot, UINT numUAVs, ID3D11UnorderedAccessView* const* unorderedAccessViews, const UINT* initialCounts) override;
+    void OMSetBlendState(ID3D11BlendState* blendState, const FLOAT blendFactor[4], UINT sampleMask) override;
+    void OMSetDepthStencilState(ID3D11DepthStencilState* depthStencilState, UINT stencilRef) override;
+
+    void SetShaderResources(PIPELINE_STAGE stage, UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* shaderResourceViews) override;
+    void SetConstantBuffers(PIPELINE_STAGE stage, UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers) override;
+    void SetConstantBuffers1(PIPELINE_STAGE stage, UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers, const UINT* firstConstants, const UINT* numConstants) override;
+    void SetSamplers(PIPELINE_STAGE stage, UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* samplerStates) override;
+    void CSSetUnorderedAccessViews(UINT startSlot, UINT numUAVs, ID3D11UnorderedAccessView* const* unorderedAccessViews, const UINT* initialCounts) override;
+    void VSSetShader(ID3D11VertexShader* vertexShader) override;
+    void PSSetShader(ID3D11PixelShader* pixelShader) override;
+    void CSSetShader(ID3D11ComputeShader* computeShader) override;
+
+    void IASetVertexBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* vertexBuffers, const UINT* strides, const UINT* offsets) override;
+    void IASetIndexBuffer(ID3D11Buffer* indexBuffer, DXGI_FORMAT format, UINT offset) override;
+    void IASetInputLayout(ID3D11InputLayout* inputLayout) override;
+    void IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology) override;
+
+    void RSSetViewports(UINT numViewports, const D3D11_VIEWPORT* viewports) override;
+    void RSSetState(ID3D11RasterizerState* rasterizerState) override;
+
+    void Draw(UINT vertexCount, UINT startVertexLocation) override;
+    void DrawIndexed(UINT indexCount, UINT startIndexLocation, INT baseVertexLocation) override;
+    void DrawInstanced(UINT vertexCountPerInstance, UINT instanceCount, UINT startVertexLocation, UINT startInstanceLocation) override;
+    void DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount, UINT startIndexLocation, INT baseVertexLocation, UINT startInstanceLocation) override;
+    void DrawInstancedIndirect(ID3D11Buffer* argsBuffer, UINT alignedByteOffset) override;
+    void DrawIndexedInstancedIndirect(ID3D11Buffer* argsBuffer, UINT alignedByteOffset) override;
+
+    void Dispatch(UINT threadGroupCountX, UINT threadGroupCountY, UINT threadGroupCountZ) override;
+    void DispatchIndirect(ID3D11Buffer* argsBuffer, UINT alignedByteOffset) override;
+
+    void CopyStructureCount(ID3D11Buffer* destinationBuffer, UINT destinationAlignedByteOffset, ID3D11UnorderedAccessView* sourceView) override;
+    void CopySubresourceRegion(ID3D11Resource* destination, UINT destinationSubresource, UINT destinationX, UINT destinationY, UINT destinationZ, ID3D11Resource* source, UINT sourceSubresource, const D3D11_BOX* sourceBox) override;
+    void UpdateSubresource(ID3D11Resource* destination, UINT destinationSubresource, const D3D11_BOX* destinationBox, const void* sourceData, UINT sourceRowPitch, UINT sourceDepthPitch) override;
+    void SetResourceMinLOD(ID3D11Resource* resource, FLOAT minLOD) override;
+
+    HRESULT Map(ID3D11Resource* resource, UINT subresource, D3D11_MAP mapType, UINT mapFlags, D3D11_MAPPED_SUBRESOURCE* mappedResource) override;
+    void Unmap(ID3D11Resource* resource, UINT subresource) override;
+
+    HRESULT FinishCommandList(ID3D11CommandList** commandList) override;
+    void ExecuteCommandList(ID3D11CommandList* commandList) override;
+
+    void Begin(ID3D11Asynchronous* async) override;
+    void End(ID3D11Asynchronous* async) override;
+    HRESULT GetData(ID3D11Asynchronous* async, void* data, UINT dataSize, UINT getDataFlags) override;
+
+    void ClearRenderTargetView(ID3D11RenderTargetView* renderTargetView, const FLOAT colour[4]) override;
+    void ClearDepthStencilView(ID3D11DepthStencilView* depthStencilView, UINT clearFlags, FLOAT depth, UINT8 stencil) override;
+    void ClearUnorderedAccessViewFloat(ID3D11UnorderedAccessView* unorderedAccessView, const FLOAT values[4]) override;
+    void ClearUnorderedAccessViewUint(ID3D11UnorderedAccessView* unorderedAccessView, const UINT values[4]) override;
+
+    [[nodiscard]] NullCommandLog& GetCommandLog() { return log; }
+    [[nodiscard]] bool IsDeferred() const { return deferred; }
+
+private:
+    //Writes an ended query's result - on the immediate context when End() is called, or when a command list containing the End() is executed
+    void ResolveQuery(NullObject* query);
+
+    NullGraphicsDevice* device;
+    bool deferred;
+    NullCommandLog log;
+};
+
+
+class NullGraphicsDevice : public GraphicsDevice
+{
+    friend class NullGraphicsSwapChain;
+    friend class NullGraphicsContext;
+
+public:
+    NullGraphicsDevice() = default;
+    ~NullGraphicsDevice() override;
+
+    [[nodiscard]] GRAPHICS_BACKEND GetBackend() const override { return NULL_BACKEND; }
+    [[nodiscard]] D3D_FEATURE_LEVEL GetFeatureLevel() const override { return D3D_FEATURE_LEVEL_11_0; }
+    [[nodiscard]] GraphicsContext* GetImmediateContext() override { return &immediateContext; }
+    HRESULT CreateDeferredContext(GraphicsContext** context) override;
+    [[nodiscard]] bool SupportsConstantBufferOffsets() const override { return constantBufferOffsets; }
+    [[nodiscard]] bool SupportsTearing() const override { return true; }
+    HRESULT SetMaximumFrameLatency(UINT maxLatency) override { maximumFrameLatency = maxLatency; return S_OK; }
+
+    HRESULT CreateBuffer(const D3D11_BUFFER_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Buffer** buffer) override;
+    HRESULT CreateTexture1D(const D3D11_TEXTURE1D_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Texture1D** texture) override;
+    HRESULT CreateTexture2D(const D3D11_TEXTURE2D_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Texture2D** texture) override;
+    HRESULT CreateTexture3D(const D3D11_TEXTURE3D_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Texture3D** texture) override;
+    void GetBufferDesc(ID3D11Buffer* buffer, D3D11_BUFFER_DESC* desc) override;
+    void GetTexture2DDesc(ID3D11Texture2D* texture, D3D11_TEXTURE2D_DESC* desc) override;
+
+    HRESULT CreateShaderResourceView(ID3D11Resource* resource, const D3D11_SHADER_RESOURCE_VIEW_DESC* desc, ID3D11ShaderResourceView** view) override;
+    HRESULT CreateUnorderedAccessView(ID3D11Resource* resource, const D3D11_UNORDERED_ACCESS_VIEW_DESC* desc, ID3D11UnorderedAccessView** view) override;
+    HRESULT CreateRenderTargetView(ID3D11Resource* resource, const D3D11_RENDER_TARGET_VIEW_DESC* desc, ID3D11RenderTargetView** view) override;
+    HRESULT CreateDepthStencilView(ID3D11Resource* resource, const D3D11_DEPTH_STENCIL_VIEW_DESC* desc, ID3D11DepthStencilView** view) override;
+    [[nodiscard]] ID3D11Resource* GetViewResource(ID3D11View* view) override;
+
+    HRESULT CreateSamplerState(const D3D11_SAMPLER_DESC* desc, ID3D11SamplerState** samplerState) override;
+    HRESULT CreateBlendState(const D3D11_BLEND_DESC* desc, ID3D11BlendState** blendState) override;
+    HRESULT CreateRasterizerState(const D3D11_RASTERIZER_DESC* desc, ID3D11RasterizerState** rasterizerState) override;
+    HRESULT CreateDepthStencilState(const D3D11_DEPTH_STENCIL_DESC* desc, ID3D11DepthStencilState** depthStencilState) override;
+
+    HRESULT CreateVertexShader(const void* bytecode, SIZE_T bytecodeLength, ID3D11VertexShader** vertexShader) override;
+    HRESULT CreatePixelShader(const void* bytecode, SIZE_T bytecodeLength, ID3D11PixelShader** pixelShader) override;
+    HRESULT CreateComputeShader(const void* bytecode, SIZE_T bytecodeLength, ID3D11ComputeShader** computeShader) override;
+    HRESULT CreateInputLayout(const D3D11_INPUT_ELEMENT_DESC* elements, UINT numElements, const void* bytecode, SIZE_T bytecodeLength, ID3D11InputLayout** inputLayout) override;
+
+    HRESULT CreateQuery(const D3D11_QUERY_DESC* desc, ID3D11Query** query) override;
+
+    HRESULT CreateSwapChain(HWND hwnd, const DXGI_SWAP_CHAIN_DESC* desc, GraphicsSwapChain** swapChain) override;
+
+    void ReleaseObject(IUnknown* object) override;
+
+    //Device-level calls (creation, release, present) - context calls are logged on the context
+    [[nodiscard]] NullCommandLog& GetCommandLog() { return log; }
+    [[nodiscard]] NullGraphicsContext& GetNullImmediateContext() { return immediateContext; }
+    //Objects created and not yet released, for leak checks
+    [[nodiscard]] size_t GetLiveObjectCount();
+    //Pretend to be a Direct3D 11.0 runtime, e.g. to exercise fallback paths
+    void SetConstantBufferOffsetsSupported(bool supported) { constantBufferOffsets = supported; }
+    [[nodiscard]] UINT GetMaximumFrameLatency() const { return maximumFrameLatency; }
+    //Presents that have to happen after a query ends before its result can be read back, to mimic the GPU running frames behind the CPU
+    void SetQueryLatency(UINT presents) { queryLatency = presents; }
+    //Make timestamp disjoint queries report an unreliable clock, as a GPU does when its clock frequency changes mid-frame
+    void SetTimestampsDisjoint(bool disjoint) { timestampsDisjoint = disjoint; }
+
+private:
+    [[nodiscard]] NullObject* CreateObject(NULL_OBJECT_TYPE type, const void* resource);
+
+    NullGraphicsContext immediateContext{ this, false };
+    NullCommandLog log;
+
+    std::mutex mutex; //ID3D11Device is free-threaded, so the placeholder bookkeeping has to be as well
+    std::unordered_set<NullObject*> liveObjects;
+    bool constantBufferOffsets{ true };
+    UINT maximumFrameLatency{ 3 };
+    UINT64 presentCount{ 0 };
+    UINT queryLatency{ 1 };
+    bool timestampsDisjoint{ false };
+};
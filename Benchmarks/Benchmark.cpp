@@ -0,0 +1,593 @@
+﻿//Headless frame loop benchmarks
+//Each scenario runs the whole engine against the null backend - no window, no GPU - so what is measured is the engine's own CPU cost:
+//wall time per frame, heap allocations per frame (counted by the global operator new below) and graphics API calls per frame
+//(read from the null device's command logs)
+//Results are written as JSON for CI to compare against a baseline - allocation and API call counts are deterministic,
+//so any change in them is a real change in behaviour
+//
+//Usage: Benchmarks [--frames N] [--warmup N] [--filter substring] [--output path]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "../Backends/NullGraphicsDevice.h"
+#include "../Managers/DeviceManager.h"
+#include "../Managers/EngineManager.h"
+#include "../Managers/PipelineManager.h"
+#include "../Managers/RenderManager.h"
+#include "../Managers/ResourceManager.h"
+#include "../Managers/UploadManager.h"
+
+
+//-----------------------------------------------//
+//-------------ALLOCATION COUNTING---------------//
+//-----------------------------------------------//
+static std::atomic<UINT64> allocationCount{ 0 };
+
+void* operator new(size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p{ std::malloc((size > 0) ? (size) : (1)) }) { return p; }
+    throw std::bad_alloc{};
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+//The nothrow forms have to be replaced too, or memory they allocate would be freed by the replaced delete (e.g. std::stable_sort's buffer)
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc((size > 0) ? (size) : (1));
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+//-----------------------------------------------//
+//----------END OF ALLOCATION COUNTING-----------//
+//-----------------------------------------------//
+
+
+
+//-----------------------------------------------//
+//-------------------SCENARIOS-------------------//
+//-----------------------------------------------//
+struct Scenario
+{
+    const char* name;
+    UINT recordingJobs;
+    std::function<void()> setup;            //After the engine is initialised
+    std::function<void(UINT frame)> frame;  //Before each EngineManager::Update()
+    std::function<void()> teardown;         //Before the engine shuts down
+};
+
+//Shared resources the draw scenarios pick from, so consecutive draws differ in what they bind
+struct SceneResources
+{
+    std::vector<BufferHandle> vertexBuffers;
+    std::vector<BufferHandle> constantBuffers;
+    std::vector<Texture2DHandle> textures;
+    std::vector<ShaderResourceViewHandle> shaderResourceViews;
+    std::vector<SamplerStateHandle> samplerStates;
+};
+
+static SceneResources scene;
+
+//Immutable resources need initial data - zeros do, for up to 64KB buffers and 128x128 RGBA8 textures
+static D3D11_SUBRESOURCE_DATA* GetInitialData(UINT rowPitch)
+{
+    static std::vector<BYTE> zeros(64 * 1024);
+    static D3D11_SUBRESOURCE_DATA data;
+    data = D3D11_SUBRESOURCE_DATA{ zeros.data(), rowPitch, 0 };
+    return &data;
+}
+
+static void CreateSceneResources(UINT variety)
+{
+    for (UINT i{ 0 }; i < variety; ++i)
+    {
+        scene.vertexBuffers.push_back(ResourceManager::CreateVertexBuffer(64 * 1024, false, false, GetInitialData(0)));
+        scene.constantBuffers.push_back(ResourceManager::CreateConstantBuffer(256, true, false, nullptr));
+        scene.textures.push_back(ResourceManager::CreateTexture2D(128, 128, 1, DXGI_FORMAT_R8G8B8A8_UNORM, false, false, GetInitialData(128 * 4)));
+        scene.shaderResourceViews.push_back(ResourceManager::CreateTexture2DShaderResourceView(scene.textures.back(), 0, 1, DXGI_FORMAT_R8G8B8A8_UNORM));
+        D3D11_SAMPLER_DESC sd{};
+        sd.Filter = (i % 2 == 0) ? (D3D11_FILTER_MIN_MAG_MIP_LINEAR) : (D3D11_FILTER_MIN_MAG_MIP_POINT);
+        sd.AddressU = sd.AddressV = sd.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
+        scene.samplerStates.push_back(ResourceManager::CreateSamplerState(sd));
+    }
+}
+
+static void ReleaseSceneResources()
+{
+    for (ShaderResourceViewHandle h : scene.shaderResourceViews) { ResourceManager::Release(h); }
+    for (Texture2DHandle h : scene.textures) { ResourceManager::Release(h); }
+    for (BufferHandle h : scene.vertexBuffers) { ResourceManager::Release(h); }
+    for (BufferHandle h : scene.constantBuffers) { ResourceManager::Release(h); }
+    for (SamplerStateHandle h : scene.samplerStates) { ResourceManager::Release(h); }
+    scene = {};
+}
+
+//Draws spread over a few passes, shaders and materials, submitted out of order so the queue has sorting to do
+//Instanced draws carry a transform each, so the queue merges every material's draws into one instanced draw
+static void SubmitSceneDraws(UINT count, bool instanced=false)
+{
+    const UINT variety{ static_cast<UINT>(scene.vertexBuffers.size()) };
+    for (UINT i{ 0 }; i < count; ++i)
+    {
+        const UINT material{ (i * 7919u) % variety };
+        DrawItem item{};
+        item.sortKey = DrawQueue::MakeSortKey(0, material % 8, material, static_cast<float>((i * 2654435761u) % 1000) / 1000.0f);
+        item.primitiveTopology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+        item.vertexBuffer = ResourceManager::Get(scene.vertexBuffers[material]);
+        item.vertexStride = 32;
+        item.constantBuffers[0] = ResourceManager::Get(scene.constantBuffers[material]);
+        item.shaderResourceViews[0] = ResourceManager::Get(scene.shaderResourceViews[material]);
+        item.samplerStates[0] = ResourceManager::Get(scene.samplerStates[material % 2]);
+        item.count = 36;
+        float transform[16]{ 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, static_cast<float>(i), 0.0f, 0.0f, 1.0f };
+        if (instanced)
+        {
+            item.instanceData = transform;
+            item.instanceDataSize = sizeof(transform);
+        }
+        RenderManager::SubmitDraw(item);
+    }
+}
+
+static Scenario MakeDrawScenario(const char* name, UINT draws, UINT recordingJobs, bool instanced=false)
+{
+    return Scenario
+    {
+        name, recordingJobs,
+        []() { CreateSceneResources(64); },
+        [draws, instanced](UINT) { SubmitSceneDraws(draws, instanced); },
+        []() { ReleaseSceneResources(); },
+    };
+}
+
+//Creates and releases a set of resources and views every frame, e.g. streaming or per-frame render targets done wrong
+static Scenario MakeResourceChurnScenario(const char* name, UINT resources)
+{
+    return Scenario
+    {
+        name, 0,
+        nullptr,
+        [resources](UINT)
+        {
+            for (UINT i{ 0 }; i < resources; ++i)
+            {
+                const BufferHandle buffer{ ResourceManager::CreateVertexBuffer(4096, false, false, GetInitialData(0)) };
+                const Texture2DHandle texture{ ResourceManager::CreateTexture2D(128, 128, 1, DXGI_FORMAT_R8G8B8A8_UNORM, false, false, GetInitialData(128 * 4)) };
+                const ShaderResourceViewHandle view{ ResourceManager::CreateTexture2DShaderResourceView(texture, 0, 1, DXGI_FORMAT_R8G8B8A8_UNORM) };
+                ResourceManager::Release(view);
+                ResourceManager::Release(texture);
+                ResourceManager::Release(buffer);
+            }
+        },
+        nullptr,
+    };
+}
+
+//As MakeResourceChurnScenario(), but with render targets and GPU written buffers, which are recycled through the resource pool
+static Scenario MakeRenderTargetChurnScenario(const char* name, UINT resources)
+{
+    return Scenario
+    {
+        name, 0,
+        nullptr,
+        [resources](UINT)
+        {
+            for (UINT i{ 0 }; i < resources; ++i)
+            {
+                const BufferHandle buffer{ ResourceManager::CreateStructuredBuffer(256, 16, false, true, nullptr) };
+                const Texture2DHandle texture{ ResourceManager::CreateRenderTexture2D(256, 256, DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE) };
+                const RenderTargetViewHandle view{ ResourceManager::CreateRenderTargetView(texture) };
+                ResourceManager::Release(view);
+                ResourceManager::Release(texture);
+                ResourceManager::Release(buffer);
+            }
+        },
+        []() { ResourceManager::TrimPool(); },
+    };
+}
+
+//Views rebuilt from their textures every frame rather than kept, which the view cache turns into lookups
+static Scenario MakeViewRebuildScenario(const char* name, UINT views)
+{
+    return Scenario
+    {
+        name, 0,
+        []() { CreateSceneResources(64); },
+        [views](UINT)
+        {
+            static std::vector<ShaderResourceViewHandle> frameViews;
+            const UINT variety{ static_cast<UINT>(scene.textures.size()) };
+            for (UINT i{ 0 }; i < views; ++i)
+            {
+                frameViews.push_back(ResourceManager::CreateTexture2DShaderResourceView(scene.textures[i % variety], 0, 1, DXGI_FORMAT_R8G8B8A8_UNORM));
+            }
+            for (ShaderResourceViewHandle view : frameViews) { ResourceManager::Release(view); }
+            frameViews.clear();
+        },
+        []() { ReleaseSceneResources(); },
+    };
+}
+
+//Fixed function states rebuilt from their descriptions for every draw, alternating between two sets - only the first of each per frame should reach the device
+static Scenario MakeStateRebuildScenario(const char* name, UINT draws)
+{
+    return Scenario
+    {
+        name, 0,
+        []() { CreateSceneResources(64); },
+        [draws](UINT)
+        {
+            static std::vector<BlendStateHandle> blendStates;
+            static std::vector<RasterizerStateHandle> rasterizerStates;
+            static std::vector<DepthStencilStateHandle> depthStencilStates;
+            for (UINT i{ 0 }; i < draws; ++i)
+            {
+                const bool odd{ (i & 1) != 0 };
+                D3D11_BLEND_DESC bd{};
+                bd.RenderTarget[0].BlendEnable = odd;
+                bd.RenderTarget[0].SrcBlend = odd ? D3D11_BLEND_SRC_ALPHA : D3D11_BLEND_ONE;
+                bd.RenderTarget[0].DestBlend = odd ? D3D11_BLEND_INV_SRC_ALPHA : D3D11_BLEND_ZERO;
+                bd.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
+                bd.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ONE;
+                bd.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ZERO;
+                bd.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
+                bd.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+                D3D11_RASTERIZER_DESC rd{};
+                rd.FillMode = D3D11_FILL_SOLID;
+                rd.CullMode = odd ? D3D11_CULL_NONE : D3D11_CULL_BACK;
+                rd.DepthClipEnable = TRUE;
+                D3D11_DEPTH_STENCIL_DESC dd{};
+                dd.DepthEnable = TRUE;
+                dd.DepthWriteMask = odd ? D3D11_DEPTH_WRITE_MASK_ZERO : D3D11_DEPTH_WRITE_MASK_ALL;
+                dd.DepthFunc = D3D11_COMPARISON_LESS;
+
+                blendStates.push_back(ResourceManager::CreateBlendState(bd));
+                rasterizerStates.push_back(ResourceManager::CreateRasterizerState(rd));
+                depthStencilStates.push_back(ResourceManager::CreateDepthStencilState(dd));
+                PipelineManager::BindBlendState(ResourceManager::Get(blendStates.back()));
+                PipelineManager::BindRasterizerState(ResourceManager::Get(rasterizerStates.back()));
+                PipelineManager::BindDepthStencilState(ResourceManager::Get(depthStencilStates.back()));
+                PipelineManager::Draw(36);
+            }
+            //Unbind before releasing, so the context never holds a state the cache has freed
+            PipelineManager::BindBlendState(nullptr);
+            PipelineManager::BindRasterizerState(nullptr);
+            PipelineManager::BindDepthStencilState(nullptr);
+            PipelineManager::FlushBindings();
+            for (BlendStateHandle state : blendStates) { ResourceManager::Release(state); }
+            for (RasterizerStateHandle state : rasterizerStates) { ResourceManager::Release(state); }
+            for (DepthStencilStateHandle state : depthStencilStates) { ResourceManager::Release(state); }
+            blendStates.clear();
+            rasterizerStates.clear();
+            depthStencilStates.clear();
+        },
+        []() { ReleaseSceneResources(); },
+    };
+}
+
+//Direct PipelineManager binds that change most slots on every draw, defeating as much of the binding cache as possible
+static Scenario MakeBindingChurnScenario(const char* name, UINT draws)
+{
+    return Scenario
+    {
+        name, 0,
+        []() { CreateSceneResources(64); },
+        [draws](UINT frame)
+        {
+            const UINT variety{ static_cast<UINT>(scene.vertexBuffers.size()) };
+            for (UINT i{ 0 }; i < draws; ++i)
+            {
+                const UINT a{ (frame + i) % variety };
+                const UINT b{ (frame + i * 3 + 1) % variety };
+                ID3D11ShaderResourceView* views[2]{ ResourceManager::Get(scene.shaderResourceViews[a]), ResourceManager::Get(scene.shaderResourceViews[b]) };
+                ID3D11Buffer* constantBuffers[2]{ ResourceManager::Get(scene.constantBuffers[a]), ResourceManager::Get(scene.constantBuffers[b]) };
+                ID3D11Buffer* vertexBuffer{ ResourceManager::Get(scene.vertexBuffers[a]) };
+                ID3D11SamplerState* sampler{ ResourceManager::Get(scene.samplerStates[i % 2]) };
+                PipelineManager::BindShaderResourceViews(views, PIXEL_SHADER, 0, 2);
+                PipelineManager::BindShaderResourceViews(views, VERTEX_SHADER, 0, 1);
+                PipelineManager::BindConstantBuffers(VERTEX_SHADER, 0, 2, constantBuffers);
+                PipelineManager::BindConstantBuffers(PIXEL_SHADER, 0, 2, constantBuffers);
+                PipelineManager::BindSamplerStates(&sampler, PIXEL_SHADER, 0, 1);
+                PipelineManager::BindVertexBuffers(&vertexBuffer, 0, 1, 32);
+                PipelineManager::Draw(36);
+            }
+        },
+        []() { ReleaseSceneResources(); },
+    };
+}
+
+//Simulation steps that each read one particle buffer and write the other, then a draw reading the result in the vertex shader
+//Every step swaps the buffers between SRV and UAV, so each one relies on the binding cache unbinding the previous step's views
+static Scenario MakeComputePingPongScenario(const char* name, UINT steps)
+{
+    static BufferHandle buffers[2];
+    static ShaderResourceViewHandle shaderResourceViews[2];
+    static UnorderedAccessViewHandle unorderedAccessViews[2];
+    return Scenario
+    {
+        name, 0,
+        []()
+        {
+            for (UINT i{ 0 }; i < 2; ++i)
+            {
+                buffers[i] = ResourceManager::CreateStructuredBuffer(16384, 32, false, true, nullptr);
+                shaderResourceViews[i] = ResourceManager::CreateBufferShaderResourceView(buffers[i], 0, 16384, DXGI_FORMAT_UNKNOWN);
+                unorderedAccessViews[i] = ResourceManager::CreateBufferUnorderedAccessView(buffers[i], 0, 16384, DXGI_FORMAT_UNKNOWN);
+            }
+        },
+        [steps](UINT)
+        {
+            for (UINT i{ 0 }; i < steps; ++i)
+            {
+                ID3D11ShaderResourceView* source{ ResourceManager::Get(shaderResourceViews[i % 2]) };
+                ID3D11UnorderedAccessView* destination{ ResourceManager::Get(unorderedAccessViews[(i + 1) % 2]) };
+                PipelineManager::BindShaderResourceViews(&source, COMPUTE_SHADER, 0, 1);
+                PipelineManager::BindUnorderedAccessViews(&destination, COMPUTE_SHADER, 0, 1);
+                PipelineManager::Dispatch(16384 / 64);
+            }
+            ID3D11ShaderResourceView* particles{ ResourceManager::Get(shaderResourceViews[steps % 2]) };
+            PipelineManager::BindShaderResourceViews(&particles, VERTEX_SHADER, 0, 1);
+            PipelineManager::Draw(16384 * 6);
+        },
+        []()
+        {
+            //Unbind before releasing, so the context never holds a view the cache has freed
+            ID3D11ShaderResourceView* const nullViews[1]{};
+            ID3D11UnorderedAccessView* const nullUnorderedAccessViews[1]{};
+            PipelineManager::BindShaderResourceViews(nullViews, COMPUTE_SHADER, 0, 1);
+            PipelineManager::BindShaderResourceViews(nullViews, VERTEX_SHADER, 0, 1);
+            PipelineManager::BindUnorderedAccessViews(nullUnorderedAccessViews, COMPUTE_SHADER, 0, 1);
+            PipelineManager::FlushBindings();
+            for (UINT i{ 0 }; i < 2; ++i)
+            {
+                ResourceManager::Release(unorderedAccessViews[i]);
+                ResourceManager::Release(shaderResourceViews[i]);
+                ResourceManager::Release(buffers[i]);
+            }
+        },
+    };
+}
+
+//Per-draw constants and dynamic vertex data through the UploadManager
+static Scenario MakeUploadScenario(const char* name, UINT draws, UINT vertexBytesPerDraw)
+{
+    return Scenario
+    {
+        name, 0,
+        []() { CreateSceneResources(64); },
+        [draws, vertexBytesPerDraw](UINT frame)
+        {
+            static std::vector<BYTE> data;
+            data.resize((std::max)(vertexBytesPerDraw, 256u), static_cast<BYTE>(frame));
+            for (UINT i{ 0 }; i < draws; ++i)
+            {
+                const UploadAllocation constants{ UploadManager::UploadConstantData(data.data(), 256) };
+                const UploadAllocation vertices{ UploadManager::UploadVertexData(data.data(), vertexBytesPerDraw) };
+                DrawItem item{};
+                item.sortKey = DrawQueue::MakeSortKey(0, 0, i % 64, 0.5f);
+                item.primitiveTopology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+                item.vertexBuffer = vertices.buffer;
+                item.vertexStride = 32;
+                item.vertexOffset = vertices.offset;
+                item.constantBuffers[0] = constants.buffer;
+                item.constantBufferFirstConstants[0] = constants.firstConstant;
+                item.constantBufferNumConstants[0] = constants.numConstants;
+                item.shaderResourceViews[0] = ResourceManager::Get(scene.shaderResourceViews[i % 64]);
+                item.count = vertexBytesPerDraw / 32;
+                RenderManager::SubmitDraw(item);
+            }
+        },
+        []() { ReleaseSceneResources(); },
+    };
+}
+
+static std::vector<Scenario> MakeScenarios()
+{
+    return
+    {
+        MakeDrawScenario("draws_1k", 1000, 0),
+        MakeDrawScenario("draws_10k", 10000, 0),
+        MakeDrawScenario("draws_10k_parallel_4", 10000, 4),
+        MakeDrawScenario("instanced_draws_10k", 10000, 0, true),
+        MakeResourceChurnScenario("resource_churn_100", 100),
+        MakeRenderTargetChurnScenario("render_target_churn_100", 100),
+        MakeViewRebuildScenario("view_rebuild_1k", 1000),
+        MakeStateRebuildScenario("state_rebuild_1k", 1000),
+        MakeBindingChurnScenario("binding_churn_2k", 2000),
+        MakeComputePingPongScenario("compute_ping_pong_256", 256),
+        MakeUploadScenario("upload_2k_draws_1kb", 2000, 1024),
+    };
+}
+//-----------------------------------------------//
+//---------------END OF SCENARIOS----------------//
+//-----------------------------------------------//
+
+
+
+//-----------------------------------------------//
+//--------------------RUNNING--------------------//
+//-----------------------------------------------//
+struct Result
+{
+    std::string name;
+    UINT frames;
+    double nsPerFrameMean;
+    double nsPerFrameMedian;
+    double nsPerFrameP95;
+    double nsPerFrameMin;
+    double allocationsPerFrame;
+    double apiCallsPerFrame;
+    double drawCallsPerFrame; //Dispatches included
+};
+
+static UINT64 CountApiCalls(NullGraphicsDevice* device)
+{
+    //Deferred context commands are replayed into the immediate log when their command lists execute, so they are counted there
+    return device->GetCommandLog().GetTotalCount() + device->GetNullImmediateContext().GetCommandLog().GetTotalCount();
+}
+
+static UINT64 CountDrawCalls(NullGraphicsDevice* device)
+{
+    const NullCommandLog& log{ device->GetNullImmediateContext().GetCommandLog() };
+    return log.GetCount(NULL_COMMAND_DRAW) + log.GetCount(NULL_COMMAND_DRAW_INDEXED)
+         + log.GetCount(NULL_COMMAND_DRAW_INSTANCED) + log.GetCount(NULL_COMMAND_DRAW_INDEXED_INSTANCED)
+         + log.GetCount(NULL_COMMAND_DRAW_INSTANCED_INDIRECT) + log.GetCount(NULL_COMMAND_DRAW_INDEXED_INSTANCED_INDIRECT)
+         + log.GetCount(NULL_COMMAND_DISPATCH) + log.GetCount(NULL_COMMAND_DISPATCH_INDIRECT);
+}
+
+static Result Run(const Scenario& scenario, UINT warmupFrames, UINT frames)
+{
+    float clearColour[4]{ 0.0f, 0.0f, 0.0f, 1.0f };
+    EngineDescription ed{};
+    ed.wd.winWidth = 1280;
+    ed.wd.winHeight = 720;
+    ed.wd.swapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+    ed.wd.bufferCount = 2;
+    ed.rd.clearColour = clearColour;
+    ed.rd.recordingJobs = scenario.recordingJobs;
+    ed.dd.backend = NULL_BACKEND;
+    ed.sd.cacheDirectory = ""; //No scenario compiles shaders, so don't leave a cache directory behind
+    EngineManager::Initialise(ed);
+
+    NullGraphicsDevice* device{ static_cast<NullGraphicsDevice*>(DeviceManager::GetDevice()) };
+    device->GetCommandLog().SetKeepCommands(false);
+    device->GetNullImmediateContext().GetCommandLog().SetKeepCommands(false);
+
+    if (scenario.setup) { scenario.setup(); }
+
+    std::vector<double> frameTimes;
+    frameTimes.reserve(frames);
+    UINT64 allocations{ 0 };
+    UINT64 apiCalls{ 0 };
+    UINT64 drawCalls{ 0 };
+    for (UINT frame{ 0 }; frame < warmupFrames + frames; ++frame)
+    {
+        const UINT64 allocationsBefore{ allocationCount.load(std::memory_order_relaxed) };
+        const UINT64 apiCallsBefore{ CountApiCalls(device) };
+        const UINT64 drawCallsBefore{ CountDrawCalls(device) };
+        const auto begin{ std::chrono::steady_clock::now() };
+
+        if (scenario.frame) { scenario.frame(frame); }
+        EngineManager::Update();
+
+        const auto end{ std::chrono::steady_clock::now() };
+        if (frame < warmupFrames) { continue; }
+        frameTimes.push_back(static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()));
+        allocations += allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+        apiCalls += CountApiCalls(device) - apiCallsBefore;
+        drawCalls += CountDrawCalls(device) - drawCallsBefore;
+    }
+
+    if (scenario.teardown) { scenario.teardown(); }
+    EngineManager::Shutdown();
+
+    Result result{};
+    result.name = scenario.name;
+    result.frames = frames;
+    if (frames == 0) { return result; }
+    std::sort(frameTimes.begin(), frameTimes.end());
+    result.nsPerFrameMean = std::accumulate(frameTimes.begin(), frameTimes.end(), 0.0) / frames;
+    result.nsPerFrameMedian = frameTimes[frames / 2];
+    result.nsPerFrameP95 = frameTimes[(std::min)(static_cast<size_t>(frames * 0.95), frameTimes.size() - 1)];
+    result.nsPerFrameMin = frameTimes.front();
+    result.allocationsPerFrame = static_cast<double>(allocations) / frames;
+    result.apiCallsPerFrame = static_cast<double>(apiCalls) / frames;
+    result.drawCallsPerFrame = static_cast<double>(drawCalls) / frames;
+    return result;
+}
+
+static void WriteJson(std::ostream& out, const std::vector<Result>& results)
+{
+    out << std::fixed << std::setprecision(1) << "{\n  \"benchmarks\": [";
+    for (size_t i{ 0 }; i < results.size(); ++i)
+    {
+        const Result& r{ results[i] };
+        out << ((i == 0) ? ("\n") : (",\n"))
+            << "    { \"name\": \"" << r.name << "\", \"frames\": " << r.frames
+            << ", \"ns_per_frame_mean\": " << r.nsPerFrameMean
+            << ", \"ns_per_frame_median\": " << r.nsPerFrameMedian
+            << ", \"ns_per_frame_p95\": " << r.nsPerFrameP95
+            << ", \"ns_per_frame_min\": " << r.nsPerFrameMin
+            << ", \"allocations_per_frame\": " << r.allocationsPerFrame
+            << ", \"api_calls_per_frame\": " << r.apiCallsPerFrame
+            << ", \"draw_calls_per_frame\": " << r.drawCallsPerFrame << " }";
+    }
+    out << "\n  ]\n}\n";
+}
+//-----------------------------------------------//
+//----------------END OF RUNNING-----------------//
+//-----------------------------------------------//
+
+
+
+int main(int argc, char** argv)
+{
+    UINT frames{ 200 };
+    UINT warmupFrames{ 20 };
+    const char* filter{ nullptr };
+    const char* outputPath{ nullptr };
+    for (int i{ 1 }; i < argc; ++i)
+    {
+        const bool hasValue{ i + 1 < argc };
+        if (hasValue && std::strcmp(argv[i], "--frames") == 0)      { frames = static_cast<UINT>(std::strtoul(argv[++i], nullptr, 10)); }
+        else if (hasValue && std::strcmp(argv[i], "--warmup") == 0) { warmupFrames = static_cast<UINT>(std::strtoul(argv[++i], nullptr, 10)); }
+        else if (hasValue && std::strcmp(argv[i], "--filter") == 0) { filter = argv[++i]; }
+        else if (hasValue && std::strcmp(argv[i], "--output") == 0) { outputPath = argv[++i]; }
+        else
+        {
+            std::cerr << "Usage: Benchmarks [--frames N] [--warmup N] [--filter substring] [--output path]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Result> results;
+    for (const Scenario& scenario : MakeScenarios())
+    {
+        if (filter && !std::strstr(scenario.name, filter)) { continue; }
+        std::cerr << "Running " << scenario.name << "..." << std::endl;
+        results.push_back(Run(scenario, warmupFrames, frames));
+    }
+
+    if (outputPath)
+    {
+        std::ofstream file{ outputPath };
+        if (!file)
+        {
+            std::cerr << "ERROR::BENCHMARKS::MAIN::FAILED_TO_OPEN_OUTPUT_FILE" << std::endl;
+            return 1;
+        }
+        WriteJson(file, results);
+    }
+    else
+    {
+        WriteJson(std::cout, results);
+    }
+    return 0;
+}
\ No newline at end of file
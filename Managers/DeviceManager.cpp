@@ -2,47 +2,90 @@
 
 #include <iostream>
 
-ID3D11Device* DeviceManager::device{};
-ID3D11DeviceContext* DeviceManager::context{};
+#include "../Backends/D3D11GraphicsDevice.h"
+#include "../Backends/NullGraphicsDevice.h"
+
+GraphicsDevice* DeviceManager::device{};
+GraphicsContext* DeviceManager::context{};
 D3D_FEATURE_LEVEL DeviceManager::featureLevel{};
+std::vector<GraphicsContext*> DeviceManager::deferredContexts{};
 
-void DeviceManager::Initialise()
+bool DeviceManager::Initialise(GRAPHICS_BACKEND backend)
 {
 
     if (device != nullptr)
     {
         std::cerr << "ERROR::DEVICE_MANAGER::INITIALISE::DEVICE_ALREADY_INITIALISED" << std::endl;
-        return;
+        return false;
+    }
+
+    switch (backend)
+    {
+    case (GRAPHICS_BACKEND::D3D11_BACKEND):
+    {
+#ifdef _WIN32
+        D3D11GraphicsDevice* d3d11Device{ new D3D11GraphicsDevice() };
+        if (!d3d11Device->Initialise())
+        {
+            //Falling back to the null backend here would leave a process with no window running forever
+            std::cerr << "ERROR::DEVICE_MANAGER::INITIALISE::FAILED_TO_CREATE_DEVICE" << std::endl;
+            delete d3d11Device;
+            return false;
+        }
+        device = d3d11Device;
+#else
+        std::cerr << "ERROR::DEVICE_MANAGER::INITIALISE::D3D11_BACKEND_ONLY_AVAILABLE_ON_WINDOWS::FALLING_BACK_TO_NULL_BACKEND" << std::endl;
+        device = new NullGraphicsDevice();
+#endif
+        break;
     }
-    
-    constexpr D3D_FEATURE_LEVEL featureLevels[] = {
-        D3D_FEATURE_LEVEL_11_0,
-        D3D_FEATURE_LEVEL_10_1,
-        D3D_FEATURE_LEVEL_10_0
-    };
-    const HRESULT hr{ D3D11CreateDevice(
-        NULL,
-        D3D_DRIVER_TYPE_HARDWARE,
-        NULL,
-        D3D11_CREATE_DEVICE_DEBUG,
-        featureLevels,
-        ARRAYSIZE(featureLevels),
-        D3D11_SDK_VERSION,
-        &device,
-        &featureLevel,
-        &context
-    ) };
-    if (FAILED(hr)) {
-        std::cerr << "ERROR::DEVICE_MANAGER::INITIALISE::FAILED_TO_CREATE_DEVICE" << std::hex << hr << std::endl;
+    case (GRAPHICS_BACKEND::NULL_BACKEND):
+    {
+        device = new NullGraphicsDevice();
+        break;
+    }
+    default:
+    {
+        std::cerr << "ERROR::DEVICE_MANAGER::INITIALISE::PROVIDED_BACKEND_NOT_IN_ENUM" << std::endl;
+        return false;
     }
-    if (featureLevel < D3D_FEATURE_LEVEL_11_0) {
-        std::cerr << "ERROR::DEVICE_MANAGER::INITIALISE::DEVICE_DOES_NOT_SUPPORT_DX11" << std::endl;
     }
+
+    context = device->GetImmediateContext();
+    featureLevel = device->GetFeatureLevel();
+    return true;
 }
 
 void DeviceManager::Shutdown()
 {
+    for (GraphicsContext* deferredContext : deferredContexts)
+    {
+        delete deferredContext;
+    }
+    deferredContexts.clear();
+
     context->ClearState();
-    device->Release();
-    context->Release();
+    delete device;
+    device = nullptr;
+    context = nullptr;
+}
+
+GraphicsDevice* DeviceManager::GetDevice()
+{
+    return device;
+}
+
+GraphicsContext* DeviceManager::GetDeferredContext(UINT index)
+{
+    while (deferredContexts.size() <= index)
+    {
+        GraphicsContext* deferredContext{};
+        if (FAILED(device->CreateDeferredContext(&deferredContext)))
+        {
+            std::cerr << "ERROR::DEVICE_MANAGER::GET_DEFERRED_CONTEXT::FAILED_TO_CREATE_DEFERRED_CONTEXT" << std::endl;
+            return nullptr;
+        }
+        deferredContexts.push_back(deferredContext);
+    }
+    return deferredContexts[index];
 }
\ No newline at end of file
@@ -1,6 +1,9 @@
 ﻿#pragma once
 
 #include <d3d11.h>
+#include <vector>
+
+#include "../Backends/GraphicsDevice.h"
 
 //This class is only accessible to EngineManager
 //EngineManager is responsible for injecting dependencies into any other classes' constructors
@@ -11,16 +14,27 @@ class DeviceManager
     friend class WindowManager;
     friend class ResourceManager;
     friend class PipelineManager;
+    friend class UploadManager;
+    friend class RenderManager;
+    friend class ShaderManager;
 
 public:
     DeviceManager() = default;
     ~DeviceManager() = default;
 
+    //The active backend, e.g. for pulling the command log out of a NullGraphicsDevice
+    [[nodiscard]] static GraphicsDevice* GetDevice();
+
 private:
-    static void Initialise();
+    //Returns false if the backend could not be created, in which case there is no device
+    [[nodiscard]] static bool Initialise(GRAPHICS_BACKEND backend);
     static void Shutdown();
+
+    //Deferred contexts are created on first use and kept for the lifetime of the device, one per recording job
+    [[nodiscard]] static GraphicsContext* GetDeferredContext(UINT index);
     
-    static ID3D11Device* device;
-    static ID3D11DeviceContext* context;
+    static GraphicsDevice* device;
+    static GraphicsContext* context;
     static D3D_FEATURE_LEVEL featureLevel;
+    static std::vector<GraphicsContext*> deferredContexts;
 };
\ No newline at end of file
@@ -1,10 +1,16 @@
 ﻿#include "EngineManager.h"
 
+#include <iostream>
+
 #include "DeviceManager.h"
+#include "JobManager.h"
 #include "PipelineManager.h"
 #include "RenderManager.h"
 #include "ResourceManager.h"
+#include "ShaderManager.h"
+#include "UploadManager.h"
 #include "WindowManager.h"
+#include "../Utility/CpuProfiler.h"
 
 bool EngineManager::applicationRunning{};
 EngineDescription EngineManager::ed{};
@@ -13,25 +19,44 @@ void EngineManager::Initialise(const EngineDescription& _ed)
 {
     ed = _ed;
     applicationRunning = true;
+    PROFILE_THREAD_NAME("Main");
 
-    DeviceManager::Initialise();
-    WindowManager::Initialise(ed.wd.winWidth, ed.wd.winHeight);
-    ResourceManager::Initialise();
+    JobManager::Initialise(ed.jd);
+    if (!DeviceManager::Initialise(ed.dd.backend))
+    {
+        std::cerr << "ERROR::ENGINE_MANAGER::INITIALISE::FAILED_TO_INITIALISE_DEVICE" << std::endl;
+        applicationRunning = false;
+        return;
+    }
+    WindowManager::Initialise(ed.wd);
+    ResourceManager::Initialise(ed.rsd);
+    ShaderManager::Initialise(ed.sd);
+    UploadManager::Initialise(ed.ud);
     PipelineManager::Initialise();
-    RenderManager::Initialise();
+    RenderManager::Initialise(ed.rd);
 }
 
 void EngineManager::Update()
 {
+    PROFILE_FUNCTION();
     WindowManager::Update();
+    ShaderManager::Update();
     RenderManager::Render(ed.rd.clearColour);
 }
 
 void EngineManager::Shutdown()
 {
-    DeviceManager::Shutdown();
-    WindowManager::Shutdown();
-    ResourceManager::Shutdown();
-    PipelineManager::Shutdown();
-    RenderManager::Shutdown();
+    //Reverse order of initialisation - the device has to outlive everything created through it
+    //Initialise stops at the device if it cannot be created, so nothing after it needs shutting down
+    if (DeviceManager::device != nullptr)
+    {
+        RenderManager::Shutdown();
+        PipelineManager::Shutdown();
+        UploadManager::Shutdown();
+        ShaderManager::Shutdown();
+        ResourceManager::Shutdown();
+        WindowManager::Shutdown();
+        DeviceManager::Shutdown();
+    }
+    JobManager::Shutdown();
 }
\ No newline at end of file
@@ -3,28 +3,32 @@
 
 #include <d3d11.h>
 
+#include "../Backends/GraphicsDevice.h"
+#include "JobManager.h"
+#include "RenderManager.h"
+#include "ResourceManager.h"
+#include "ShaderManager.h"
+#include "UploadManager.h"
+#include "WindowManager.h"
+
 class DeviceManager;
-class WindowManager;
-class ResourceManager;
 class PipelineManager;
-class RenderManager;
-
 
-struct WindowDescription
-{
-    UINT winWidth;
-    UINT winHeight;
-};
 
-struct RenderDescription
+struct DeviceDescription
 {
-    float* clearColour;
+    GRAPHICS_BACKEND backend; //NULL_BACKEND runs the engine headless (no window, no GPU) for CI and benchmarking
 };
 
 struct EngineDescription
 {
     WindowDescription wd;
     RenderDescription rd;
+    DeviceDescription dd;
+    ResourceDescription rsd;
+    ShaderDescription sd;
+    UploadDescription ud;
+    JobDescription jd;
 };
 
 
@@ -35,6 +39,9 @@ class EngineManager
     friend class ResourceManager;
     friend class PipelineManager;
     friend class RenderManager;
+    friend class ShaderManager;
+    friend class UploadManager;
+    friend class JobManager;
 
 public:
     static void Initialise(const EngineDescription& _ed);
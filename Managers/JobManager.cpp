@@ -0,0 +1,222 @@
+﻿#include "JobManager.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+#include "../Utility/CpuProfiler.h"
+
+std::vector<std::thread> JobManager::workers{};
+std::vector<std::unique_ptr<JobManager::WorkerQueue>> JobManager::queues{};
+std::atomic<UINT> JobManager::queuedJobs{ 0 };
+std::atomic<UINT> JobManager::sleepingWorkers{ 0 };
+std::mutex JobManager::sleepMutex{};
+std::condition_variable JobManager::wakeCondition{};
+bool JobManager::running{};
+
+thread_local UINT JobManager::threadIndex{ 0 };
+
+
+void JobManager::Initialise(const JobDescription& jd)
+{
+    if (!queues.empty())
+    {
+        std::cerr << "ERROR::JOB_MANAGER::INITIALISE::JOB_MANAGER_ALREADY_INITIALISED" << std::endl;
+        return;
+    }
+
+    const UINT hardwareThreads{ std::thread::hardware_concurrency() };
+    const UINT workerCount{ (jd.workerCount != 0) ? (jd.workerCount) : ((hardwareThreads > 1) ? (hardwareThreads - 1) : (0)) };
+
+    for (UINT i{ 0 }; i < workerCount + 1; ++i)
+    {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    running = true;
+    threadIndex = 0;
+    for (UINT i{ 1 }; i < workerCount + 1; ++i)
+    {
+        workers.emplace_back(WorkerMain, i);
+    }
+}
+
+void JobManager::Shutdown()
+{
+    //Workers drain the queues before exiting
+    {
+        std::lock_guard<std::mutex> lock{ sleepMutex };
+        running = false;
+    }
+    wakeCondition.notify_all();
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+    workers.clear();
+
+    //Only possible without workers, or with continuations scheduled from the last jobs to finish
+    while (RunJob()) {}
+    queues.clear();
+}
+
+
+
+void JobManager::Schedule(const JobFunction& function, JobCounter* counter)
+{
+    if (counter) { counter->pending.fetch_add(1, std::memory_order_relaxed); }
+
+    if (queues.empty())
+    {
+        //Not initialised (or already shut down) - run the job in place
+        function();
+        Complete(counter);
+        return;
+    }
+    Push(Job{ function, counter });
+}
+
+void JobManager::ScheduleAfter(JobCounter& dependency, const JobFunction& function, JobCounter* counter)
+{
+    if (counter) { counter->pending.fetch_add(1, std::memory_order_relaxed); }
+
+    {
+        std::lock_guard<std::mutex> lock{ dependency.continuationMutex };
+        if (!dependency.IsComplete())
+        {
+            //Complete() takes the same lock before releasing the continuations, so this can't be missed
+            dependency.continuations.push_back(Job{ function, counter });
+            return;
+        }
+    }
+
+    if (queues.empty())
+    {
+        function();
+        Complete(counter);
+        return;
+    }
+    Push(Job{ function, counter });
+}
+
+void JobManager::Wait(JobCounter& counter)
+{
+    while (!counter.IsComplete())
+    {
+        if (!RunJob())
+        {
+            std::this_thread::yield();
+        }
+    }
+    //The last job to finish may still hold the counter's lock
+    std::lock_guard<std::mutex> lock{ counter.continuationMutex };
+}
+
+void JobManager::ParallelFor(UINT begin, UINT end, UINT batchSize, const ParallelForFunction& function)
+{
+    if (begin >= end) { return; }
+    batchSize = (std::max)(batchSize, 1u);
+
+    JobCounter counter;
+    for (UINT batchBegin{ begin }; batchBegin < end; batchBegin += (std::min)(batchSize, end - batchBegin))
+    {
+        const UINT batchEnd{ batchBegin + (std::min)(batchSize, end - batchBegin) };
+        Schedule([&function, batchBegin, batchEnd]() { function(batchBegin, batchEnd); }, &counter);
+    }
+    Wait(counter);
+}
+
+UINT JobManager::GetThreadCount()
+{
+    return static_cast<UINT>(workers.size()) + 1;
+}
+
+UINT JobManager::GetThreadIndex()
+{
+    return threadIndex;
+}
+
+
+
+void JobManager::WorkerMain(UINT index)
+{
+    threadIndex = index;
+    PROFILE_THREAD_NAME(("Job Worker " + std::to_string(index)).c_str());
+
+    while (true)
+    {
+        if (RunJob()) { continue; }
+
+        std::unique_lock<std::mutex> lock{ sleepMutex };
+        sleepingWorkers.fetch_add(1);
+        wakeCondition.wait(lock, []() { return queuedJobs.load() > 0 || !running; });
+        sleepingWorkers.fetch_sub(1);
+        if (!running && queuedJobs.load() == 0) { return; }
+    }
+}
+
+void JobManager::Push(Job&& job)
+{
+    WorkerQueue& queue{ *queues[threadIndex] };
+    {
+        std::lock_guard<std::mutex> lock{ queue.mutex };
+        queue.jobs.push_back(std::move(job));
+        queuedJobs.fetch_add(1);
+    }
+
+    //A worker registers as sleeping before re-checking queuedJobs, so one of the two always sees the other
+    if (sleepingWorkers.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock{ sleepMutex };
+        wakeCondition.notify_one();
+    }
+}
+
+bool JobManager::RunJob()
+{
+    const UINT queueCount{ static_cast<UINT>(queues.size()) };
+    Job job{};
+    bool found{ false };
+
+    //Newest job from the calling thread's own queue first, then the oldest job of each other queue in turn
+    for (UINT i{ 0 }; i < queueCount && !found; ++i)
+    {
+        WorkerQueue& queue{ *queues[(threadIndex + i) % queueCount] };
+        std::lock_guard<std::mutex> lock{ queue.mutex };
+        if (queue.jobs.empty()) { continue; }
+
+        if (i == 0) { job = std::move(queue.jobs.back()); queue.jobs.pop_back(); }
+        else        { job = std::move(queue.jobs.front()); queue.jobs.pop_front(); }
+        queuedJobs.fetch_sub(1);
+        found = true;
+    }
+    if (!found) { return false; }
+
+    job.function();
+    Complete(job.counter);
+    return true;
+}
+
+void JobManager::Complete(JobCounter* counter)
+{
+    if (!counter) { return; }
+
+    //The counter is only touched under its lock, which Wait() takes before returning, so it can't be destroyed mid-release
+    std::vector<Job> continuations;
+    {
+        std::lock_guard<std::mutex> lock{ counter->continuationMutex };
+        if (counter->pending.fetch_sub(1, std::memory_order_acq_rel) != 1) { return; }
+        continuations.swap(counter->continuations);
+    }
+    for (Job& continuation : continuations)
+    {
+        if (queues.empty())
+        {
+            continuation.function();
+            Complete(continuation.counter);
+        }
+        else
+        {
+            Push(std::move(continuation));
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+﻿#pragma once
+#include <d3d11.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Work-stealing job scheduler shared by every manager
+//Each worker thread owns a queue - it pushes and pops its own jobs at the back, so the most recently queued (cache-warm) work
+//runs first, and once that runs dry it steals the oldest jobs from the front of the other queues. The main thread, and any
+//other thread that isn't a worker, owns queue 0
+//
+//Dependencies are continuation based rather than fiber based: a job can be held back until a JobCounter reaches zero, and a
+//thread waiting on a counter runs queued jobs itself instead of blocking, so waiting inside a job never starves the pool
+
+
+using JobFunction = std::function<void()>;
+//Called with one batch [begin, end) of a ParallelFor() range
+using ParallelForFunction = std::function<void(UINT begin, UINT end)>;
+
+struct JobDescription
+{
+    UINT workerCount; //Worker threads besides the main thread - 0 for one per remaining hardware thread
+};
+
+
+class JobCounter;
+
+struct Job
+{
+    JobFunction function;
+    JobCounter* counter; //Decremented once the function has returned, may be null
+};
+
+//Tracks a group of jobs - it is incremented when a job is scheduled against it and decremented when that job finishes
+//Must outlive the jobs scheduled against it, so wait on it (or see IsComplete()) before it goes out of scope
+class JobCounter
+{
+    friend class JobManager;
+
+public:
+    JobCounter() = default;
+    //The last job to finish may still hold the lock just after IsComplete() turns true
+    ~JobCounter() { std::lock_guard<std::mutex> lock{ continuationMutex }; }
+
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    [[nodiscard]] bool IsComplete() const { return pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    std::atomic<UINT> pending{ 0 };
+    std::mutex continuationMutex;
+    std::vector<Job> continuations; //Jobs held back until pending reaches zero
+};
+
+
+class JobManager
+{
+    friend class EngineManager;
+
+public:
+    JobManager() = default;
+    ~JobManager() = default;
+
+    //Queue a job - counter (if provided) is incremented immediately
+    static void Schedule(const JobFunction& function, JobCounter* counter=nullptr);
+    //Queue a job that only starts once every job scheduled against dependency has finished
+    static void ScheduleAfter(JobCounter& dependency, const JobFunction& function, JobCounter* counter=nullptr);
+    //Run queued jobs on the calling thread until every job scheduled against counter has finished
+    static void Wait(JobCounter& counter);
+
+    //Split [begin, end) into batches of batchSize, run them across the pool and return once they have all finished
+    static void ParallelFor(UINT begin, UINT end, UINT batchSize, const ParallelForFunction& function);
+
+    //Threads that run jobs, including the main thread
+    [[nodiscard]] static UINT GetThreadCount();
+    //Index of the calling thread in [0, GetThreadCount()) - 0 for the main thread, e.g. for indexing per-thread scratch memory
+    [[nodiscard]] static UINT GetThreadIndex();
+
+private:
+    static void Initialise(const JobDescription& jd);
+    static void Shutdown();
+
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    static std::vector<std::thread> workers;
+    static std::vector<std::unique_ptr<WorkerQueue>> queues;
+    static std::atomic<UINT> queuedJobs;
+    static std::atomic<UINT> sleepingWorkers;
+    static std::mutex sleepMutex;
+    static std::condition_variable wakeCondition;
+    static bool running;
+
+    static thread_local UINT threadIndex;
+
+
+    //Utility functions
+    static void WorkerMain(UINT index);
+    static void Push(Job&& job);
+    [[nodiscard]] static bool RunJob();
+    static void Complete(JobCounter* counter);
+};
\ No newline at end of file
@@ -1,16 +1,61 @@
 ﻿#include "PipelineManager.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include "DeviceManager.h"
 #include "EngineManager.h"
+#include "../Utility/CpuProfiler.h"
+
+thread_local GraphicsContext* PipelineManager::context{};
+
+thread_local PipelineManager::BindingSlots<PipelineManager::ShaderResourceViewBinding, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT> PipelineManager::shaderResourceViews[PIPELINE_STAGE_COUNT]{};
+thread_local PipelineManager::BindingSlots<PipelineManager::ConstantBufferBinding, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT> PipelineManager::constantBuffers[PIPELINE_STAGE_COUNT]{};
+thread_local PipelineManager::BindingSlots<ID3D11SamplerState*, D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT> PipelineManager::samplerStates[PIPELINE_STAGE_COUNT]{};
+thread_local PipelineManager::BindingSlots<PipelineManager::UnorderedAccessViewBinding, D3D11_PS_CS_UAV_REGISTER_COUNT> PipelineManager::computeUnorderedAccessViews{};
+thread_local UINT PipelineManager::computeInitialCounts[D3D11_PS_CS_UAV_REGISTER_COUNT]{};
+thread_local UINT PipelineManager::computeReissueMask{};
+static_assert(D3D11_PS_CS_UAV_REGISTER_COUNT <= 32, "computeReissueMask needs a bit per compute UAV slot");
+thread_local PipelineManager::BindingSlots<PipelineManager::VertexBufferBinding, D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT> PipelineManager::vertexBuffers{};
+
+thread_local PipelineManager::IndexBufferBinding PipelineManager::boundIndexBuffer{};
+thread_local PipelineManager::IndexBufferBinding PipelineManager::pendingIndexBuffer{};
+
+thread_local PipelineManager::ShaderBinding PipelineManager::boundShaders{};
+thread_local PipelineManager::ShaderBinding PipelineManager::pendingShaders{};
+
+thread_local D3D11_VIEWPORT PipelineManager::boundViewport{};
+thread_local D3D11_VIEWPORT PipelineManager::pendingViewport{};
+
+thread_local PipelineManager::FixedFunctionBinding PipelineManager::boundFixedFunction{};
+thread_local PipelineManager::FixedFunctionBinding PipelineManager::pendingFixedFunction{};
+
+thread_local PipelineManager::OutputMergerBinding PipelineManager::boundOutputMerger{};
+thread_local PipelineManager::OutputMergerBinding PipelineManager::pendingOutputMerger{};
+thread_local UINT PipelineManager::pixelInitialCounts[D3D11_PS_CS_UAV_REGISTER_COUNT]{};
+thread_local bool PipelineManager::outputMergerDirty{};
+
+thread_local PipelineStatistics PipelineManager::frameStatistics{};
+PipelineStatistics PipelineManager::lastFrameStatistics{};
+PipelineStatistics PipelineManager::recordedStatistics{};
+std::mutex PipelineManager::recordedStatisticsMutex{};
+thread_local std::vector<PipelineManager::SuspendedState> PipelineManager::suspendedStates{};
+
 
 void PipelineManager::Initialise()
 {
+    //Initialise() is called on the main thread, which records to the immediate context
+    context = DeviceManager::context;
+    InvalidateBindingCache();
+    frameStatistics = {};
+    lastFrameStatistics = {};
+    recordedStatistics = {};
 }
 
 void PipelineManager::Shutdown()
 {
+    InvalidateBindingCache();
+    context = nullptr;
 }
 
 
@@ -20,82 +65,182 @@ void PipelineManager::Shutdown()
 //--------------------------------//
 ID3D11DepthStencilView* PipelineManager::GetCurrentDepthStencilView()
 {
-    std::vector<ID3D11RenderTargetView*> rtv{ D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT, nullptr };
-    ID3D11DepthStencilView* dsv;
-    DeviceManager::context->OMGetRenderTargets(D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT, rtv.data(), &dsv);
-
-    return dsv;
+    PROFILE_FUNCTION();
+    return pendingOutputMerger.depthStencilView;
 }
 
 std::vector<ID3D11RenderTargetView*> PipelineManager::GetCurrentRenderTargetViews()
 {
+    PROFILE_FUNCTION();
     std::vector<ID3D11RenderTargetView*> rtv{ D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT, nullptr };
-    ID3D11DepthStencilView* dsv;
-    DeviceManager::context->OMGetRenderTargets(D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT, rtv.data(), &dsv);
+    std::copy_n(pendingOutputMerger.renderTargetViews, pendingOutputMerger.numRenderTargetViews, rtv.begin());
 
     return rtv;
 }
 
 void PipelineManager::BindDepthStencilView(ID3D11DepthStencilView* depthStencilView)
 {
-    std::vector<ID3D11RenderTargetView*> rtv{ GetCurrentRenderTargetViews() };
-    DeviceManager::context->OMSetRenderTargets(rtv.size(), rtv.data(), depthStencilView);
-}
+    PROFILE_FUNCTION();
+    ++frameStatistics.bindCalls;
+    if (pendingOutputMerger.depthStencilView == depthStencilView)
+    {
+        ++frameStatistics.elidedBindCalls;
+        return;
+    }
+    pendingOutputMerger.depthStencilView = depthStencilView;
+    pendingOutputMerger.depthStencilViewResource = DeviceManager::device->GetViewResource(depthStencilView);
+    outputMergerDirty = true;
 
-void PipelineManager::BindRenderTargetViews(const std::vector<ID3D11RenderTargetView*>& renderTargetViews)
-{
-    ID3D11DepthStencilView* dsv{ GetCurrentDepthStencilView() };
-    DeviceManager::context->OMSetRenderTargets(renderTargetViews.size(), renderTargetViews.data(), dsv);
+    //A resource being written can't stay bound for reading
+    if (pendingOutputMerger.depthStencilViewResource) { UnbindResourceShaderResourceViews(pendingOutputMerger.depthStencilViewResource); }
 }
 
-void PipelineManager::BindShaderResourceViews(ID3D11ShaderResourceView* shaderResourceViews, PIPELINE_STAGE stage, UINT startSlot, UINT numViews)
+void PipelineManager::BindRenderTargetViews(const std::vector<ID3D11RenderTargetView*>& renderTargetViews)
 {
-    switch (stage)
+    PROFILE_FUNCTION();
+    ++frameStatistics.bindCalls;
+    if (renderTargetViews.size() > D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT)
     {
-    case (PIPELINE_STAGE::VERTEX_SHADER):
+        std::cerr << "ERROR::PIPELINE_MANAGER::BIND_RENDER_TARGET_VIEWS::TOO_MANY_RENDER_TARGET_VIEWS" << std::endl;
+        return;
+    }
+
+    //Trailing null views don't occupy a slot
+    UINT numViews{ static_cast<UINT>(renderTargetViews.size()) };
+    while (numViews > 0 && renderTargetViews[numViews - 1] == nullptr) { --numViews; }
+
+    if (numViews == pendingOutputMerger.numRenderTargetViews && std::equal(renderTargetViews.begin(), renderTargetViews.begin() + numViews, pendingOutputMerger.renderTargetViews))
     {
-        DeviceManager::context->VSSetShaderResources(startSlot, numViews, &shaderResourceViews);
+        ++frameStatistics.elidedBindCalls;
+        return;
     }
-    case (PIPELINE_STAGE::DOMAIN_SHADER):
+    //Resources are only looked up for the slots that change
+    for (UINT i{ 0 }; i < D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT; ++i)
     {
-        DeviceManager::context->DSSetShaderResources(startSlot, numViews, &shaderResourceViews);
+        ID3D11RenderTargetView* const view{ (i < numViews) ? (renderTargetViews[i]) : (nullptr) };
+        if (pendingOutputMerger.renderTargetViews[i] == view) { continue; }
+        pendingOutputMerger.renderTargetViews[i] = view;
+        pendingOutputMerger.renderTargetViewResources[i] = DeviceManager::device->GetViewResource(view);
     }
-    case (PIPELINE_STAGE::HULL_SHADER):
+    pendingOutputMerger.numRenderTargetViews = numViews;
+    outputMergerDirty = true;
+
+    //A resource being written can't stay bound for reading
+    for (UINT i{ 0 }; i < numViews; ++i)
     {
-        DeviceManager::context->HSSetShaderResources(startSlot, numViews, &shaderResourceViews);
+        if (pendingOutputMerger.renderTargetViewResources[i]) { UnbindResourceShaderResourceViews(pendingOutputMerger.renderTargetViewResources[i]); }
     }
-    case (PIPELINE_STAGE::GEOMETRY_SHADER):
+}
+
+void PipelineManager::BindShaderResourceViews(ID3D11ShaderResourceView* const* shaderResourceViews, PIPELINE_STAGE stage, UINT startSlot, UINT numViews)
+{
+    PROFILE_FUNCTION();
+    ++frameStatistics.bindCalls;
+    if (stage >= PIPELINE_STAGE_COUNT)
     {
-        DeviceManager::context->GSSetShaderResources(startSlot, numViews, &shaderResourceViews);
+        std::cerr << "ERROR::PIPELINE_MANAGER::BIND_SHADER_RESOURCE_VIEW::PROVIDED_STAGE_NOT_IN_ENUM" << std::endl;
+        return;
     }
-    case (PIPELINE_STAGE::PIXEL_SHADER):
+    if (startSlot + numViews > D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT)
     {
-        DeviceManager::context->PSSetShaderResources(startSlot, numViews, &shaderResourceViews);
+        std::cerr << "ERROR::PIPELINE_MANAGER::BIND_SHADER_RESOURCE_VIEW::SLOT_OUT_OF_RANGE" << std::endl;
+        return;
     }
-    case (PIPELINE_STAGE::COMPUTE_SHADER):
+
+    //Resources are only looked up for the slots that change
+    BindingSlots<ShaderResourceViewBinding, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT>& slots{ PipelineManager::shaderResourceViews[stage] };
+    ShaderResourceViewBinding bindings[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT];
+    for (UINT i{ 0 }; i < numViews; ++i)
     {
-        DeviceManager::context->CSSetShaderResources(startSlot, numViews, &shaderResourceViews);
+        const ShaderResourceViewBinding& pending{ slots.pending[startSlot + i] };
+        bindings[i] = (pending.view == shaderResourceViews[i]) ? (pending) : (ShaderResourceViewBinding{ shaderResourceViews[i], DeviceManager::device->GetViewResource(shaderResourceViews[i]) });
     }
-    default:
+    if (!StageSlots(slots, startSlot, numViews, bindings, "BIND_SHADER_RESOURCE_VIEW"))
     {
-        std::cerr << "ERROR::PIPELINE_MANAGER::BIND_SHADER_RESOURCE_VIEW::PROVIDED_STAGE_NOT_IN_ENUM" << std::endl;
+        ++frameStatistics.elidedBindCalls;
+        return;
     }
+
+    //A resource being read can't stay bound for writing
+    const bool hasUnorderedAccessViews{ HasPendingUnorderedAccessViews() };
+    for (UINT i{ 0 }; i < numViews; ++i)
+    {
+        if (!bindings[i].resource) { continue; }
+        UnbindResourceTargetViews(bindings[i].resource);
+        if (hasUnorderedAccessViews) { UnbindResourceUnorderedAccessViews(bindings[i].resource, true, true); }
     }
 }
 
-void PipelineManager::BindUnorderedAccessViews(ID3D11UnorderedAccessView* unorderedAccessViews, PIPELINE_STAGE stage, UINT startSlot, UINT numViews, UINT* initialCounts)
+void PipelineManager::BindUnorderedAccessViews(ID3D11UnorderedAccessView* const* unorderedAccessViews, PIPELINE_STAGE stage, UINT startSlot, UINT numViews, UINT* initialCounts)
 {
+    PROFILE_FUNCTION();
+    ++frameStatistics.bindCalls;
+    if (startSlot + numViews > D3D11_PS_CS_UAV_REGISTER_COUNT)
+    {
+        std::cerr << "ERROR::PIPELINE_MANAGER::BIND_UNORDERED_ACCESS_VIEW::SLOT_OUT_OF_RANGE" << std::endl;
+        return;
+    }
+
     switch (stage)
     {
     case (PIPELINE_STAGE::PIXEL_SHADER):
     {
-        std::vector<ID3D11RenderTargetView*> rtvs{ GetCurrentRenderTargetViews() };
-        ID3D11DepthStencilView* dsv{ GetCurrentDepthStencilView() };
-        DeviceManager::context->OMSetRenderTargetsAndUnorderedAccessViews(rtvs.size(), rtvs.data(), dsv, startSlot, numViews, &unorderedAccessViews, initialCounts);
+        bool changed{ false };
+        for (UINT i{ 0 }; i < numViews; ++i)
+        {
+            if (pendingOutputMerger.unorderedAccessViews[startSlot + i] != unorderedAccessViews[i])
+            {
+                pendingOutputMerger.unorderedAccessViews[startSlot + i] = unorderedAccessViews[i];
+                pendingOutputMerger.unorderedAccessViewResources[startSlot + i] = DeviceManager::device->GetViewResource(unorderedAccessViews[i]);
+                changed = true;
+            }
+            //A provided initial count always has to reach the context since it resets the hidden counter
+            pixelInitialCounts[startSlot + i] = (initialCounts) ? (initialCounts[i]) : (static_cast<UINT>(-1));
+        }
+        if (initialCounts) { changed = true; }
+
+        if (!changed) { ++frameStatistics.elidedBindCalls; }
+        outputMergerDirty = outputMergerDirty || changed;
+        //A resource being written can't stay bound anywhere else
+        for (UINT i{ 0 }; i < numViews && changed; ++i)
+        {
+            ID3D11Resource* const resource{ pendingOutputMerger.unorderedAccessViewResources[startSlot + i] };
+            if (!resource) { continue; }
+            UnbindResourceShaderResourceViews(resource);
+            UnbindResourceUnorderedAccessViews(resource, false, true);
+        }
+        break;
     }
     case (PIPELINE_STAGE::COMPUTE_SHADER):
     {
-        DeviceManager::context->CSSetUnorderedAccessViews(startSlot, numViews, &unorderedAccessViews, initialCounts);
+        UnorderedAccessViewBinding bindings[D3D11_PS_CS_UAV_REGISTER_COUNT];
+        for (UINT i{ 0 }; i < numViews; ++i)
+        {
+            const UnorderedAccessViewBinding& pending{ computeUnorderedAccessViews.pending[startSlot + i] };
+            bindings[i] = (pending.view == unorderedAccessViews[i]) ? (pending) : (UnorderedAccessViewBinding{ unorderedAccessViews[i], DeviceManager::device->GetViewResource(unorderedAccessViews[i]) });
+        }
+        bool changed{ StageSlots(computeUnorderedAccessViews, startSlot, numViews, bindings, "BIND_UNORDERED_ACCESS_VIEW") };
+        for (UINT i{ 0 }; i < numViews; ++i)
+        {
+            computeInitialCounts[startSlot + i] = (initialCounts) ? (initialCounts[i]) : (static_cast<UINT>(-1));
+        }
+        if (initialCounts && numViews > 0)
+        {
+            //As for the pixel shader, the slots are re-issued even if the views are already bound
+            computeReissueMask |= ((1u << numViews) - 1) << startSlot;
+            computeUnorderedAccessViews.dirtyMin = (std::min)(computeUnorderedAccessViews.dirtyMin, startSlot);
+            computeUnorderedAccessViews.dirtyMax = (std::max)(computeUnorderedAccessViews.dirtyMax, startSlot + numViews - 1);
+            changed = true;
+        }
+
+        if (!changed) { ++frameStatistics.elidedBindCalls; }
+        for (UINT i{ 0 }; i < numViews && changed; ++i)
+        {
+            if (!bindings[i].resource) { continue; }
+            UnbindResourceShaderResourceViews(bindings[i].resource);
+            UnbindResourceUnorderedAccessViews(bindings[i].resource, true, false);
+        }
+        break;
     }
     default:
     {
@@ -104,24 +249,47 @@ void PipelineManager::BindUnorderedAccessViews(ID3D11UnorderedAccessView* unorde
     }
 }
 
+void PipelineManager::UnbindShaderResourceView(ID3D11ShaderResourceView* shaderResourceView)
+{
+    PROFILE_FUNCTION();
+    if (!shaderResourceView) { return; }
+
+    const ShaderResourceViewBinding nullBinding{};
+    for (UINT s{ 0 }; s < PIPELINE_STAGE_COUNT; ++s)
+    {
+        BindingSlots<ShaderResourceViewBinding, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT>& slots{ shaderResourceViews[s] };
+        for (UINT i{ 0 }; i < D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT; ++i)
+        {
+            if (slots.pending[i].view == shaderResourceView)
+            {
+                StageSlots(slots, i, 1, &nullBinding, "UNBIND_SHADER_RESOURCE_VIEW");
+            }
+        }
+    }
+}
+
 void PipelineManager::ClearRenderTargetView(ID3D11RenderTargetView* renderTargetView, FLOAT* clearColour)
 {
-    DeviceManager::context->ClearRenderTargetView(renderTargetView, clearColour);
+    PROFILE_FUNCTION();
+    context->ClearRenderTargetView(renderTargetView, clearColour);
 }
 
 void PipelineManager::ClearDepthStencilView(ID3D11DepthStencilView* depthStencilView, FLOAT clearDepth, UINT8 clearStencil)
 {
-    DeviceManager::context->ClearDepthStencilView(depthStencilView, D3D11_CLEAR_DEPTH, clearDepth, clearStencil);
+    PROFILE_FUNCTION();
+    context->ClearDepthStencilView(depthStencilView, D3D11_CLEAR_DEPTH, clearDepth, clearStencil);
 }
 
 void PipelineManager::ClearUnorderedAccessViewFloat(ID3D11UnorderedAccessView* unorderedAccessView, FLOAT clearValue[4])
 {
-    DeviceManager::context->ClearUnorderedAccessViewFloat(unorderedAccessView, clearValue);
+    PROFILE_FUNCTION();
+    context->ClearUnorderedAccessViewFloat(unorderedAccessView, clearValue);
 }
 
 void PipelineManager::ClearUnorderedAccessViewUint(ID3D11UnorderedAccessView* unorderedAccessView, UINT clearValue[4])
 {
-    DeviceManager::context->ClearUnorderedAccessViewUint(unorderedAccessView, clearValue);
+    PROFILE_FUNCTION();
+    context->ClearUnorderedAccessViewUint(unorderedAccessView, clearValue);
 }
 
 //---------------------------------//
@@ -133,113 +301,887 @@ void PipelineManager::ClearUnorderedAccessViewUint(ID3D11UnorderedAccessView* un
 //--------------------------------//
 //---------Buffer Methods---------//
 //--------------------------------//
-void PipelineManager::BindVertexBuffers(ID3D11Buffer* vertexBuffers, UINT startSlot, UINT numBuffers, UINT stride, UINT offset)
+void PipelineManager::BindVertexBuffers(ID3D11Buffer* const* vertexBuffers, UINT startSlot, UINT numBuffers, UINT stride, UINT offset)
 {
-    DeviceManager::context->IASetVertexBuffers(startSlot, numBuffers, &vertexBuffers, &stride, &offset);
+    PROFILE_FUNCTION();
+    ++frameStatistics.bindCalls;
+    if (startSlot + numBuffers > D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT)
+    {
+        std::cerr << "ERROR::PIPELINE_MANAGER::BIND_VERTEX_BUFFERS::SLOT_OUT_OF_RANGE" << std::endl;
+        return;
+    }
+    VertexBufferBinding bindings[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+    for (UINT i{ 0 }; i < numBuffers; ++i)
+    {
+        bindings[i] = { vertexBuffers[i], stride, offset };
+    }
+    if (!StageSlots(PipelineManager::vertexBuffers, startSlot, numBuffers, bindings, "BIND_VERTEX_BUFFERS"))
+    {
+        ++frameStatistics.elidedBindCalls;
+    }
 }
 
-void PipelineManager::BindIndexBuffer(ID3D11Buffer* indexBuffer, DXGI_FORMAT format, UINT offset)
+void PipelineManager::BindVertexBuffers(ID3D11Buffer* const* vertexBuffers, UINT startSlot, UINT numBuffers, const UINT* strides, const UINT* offsets)
 {
-    DeviceManager::context->IASetIndexBuffer(indexBuffer, format, offset);
+    PROFILE_FUNCTION();
+    ++frameStatistics.bindCalls;
+    if (startSlot + numBuffers > D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT)
+    {
+        std::cerr << "ERROR::PIPELINE_MANAGER::BIND_VERTEX_BUFFERS::SLOT_OUT_OF_RANGE" << std::endl;
+        return;
+    }
+    VertexBufferBinding bindings[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+    for (UINT i{ 0 }; i < numBuffers; ++i)
+    {
+        bindings[i] = { vertexBuffers[i], strides[i], offsets[i] };
+    }
+    if (!StageSlots(PipelineManager::vertexBuffers, startSlot, numBuffers, bindings, "BIND_VERTEX_BUFFERS"))
+    {
+        ++frameStatistics.elidedBindCalls;
+    }
 }
 
-void PipelineManager::BindConstantBuffers(PIPELINE_STAGE stage, UINT startSlot, UINT numBuffers, ID3D11Buffer* constantBuffer)
+void PipelineManager::BindIndexBuffer(ID3D11Buffer* indexBuffer, DXGI_FORMAT format, UINT offset)
 {
-    switch (stage)
+    PROFILE_FUNCTION();
+    ++frameStatistics.bindCalls;
+    const IndexBufferBinding binding{ indexBuffer, format, offset };
+    if (pendingIndexBuffer == binding)
     {
-    case (PIPELINE_STAGE::VERTEX_SHADER):
+        ++frameStatistics.elidedBindCalls;
+        return;
+    }
+    pendingIndexBuffer = binding;
+}
+
+void PipelineManager::BindConstantBuffers(PIPELINE_STAGE stage, UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers)
+{
+    PROFILE_FUNCTION();
+    BindConstantBufferRanges(stage, startSlot, numBuffers, constantBuffers, nullptr, nullptr);
+}
+
+void PipelineManager::BindConstantBufferRanges(PIPELINE_STAGE stage, UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers, const UINT* firstConstants, const UINT* numConstants)
+{
+    PROFILE_FUNCTION();
+    ++frameStatistics.bindCalls;
+    if (stage >= PIPELINE_STAGE_COUNT)
     {
-        DeviceManager::context->VSSetConstantBuffers(startSlot, numBuffers, &constantBuffer);
+        std::cerr << "ERROR::PIPELINE_MANAGER::BIND_CONSTANT_BUFFER::PROVIDED_STAGE_NOT_IN_ENUM" << std::endl;
+        return;
     }
-    case (PIPELINE_STAGE::PIXEL_SHADER):
+    if (startSlot + numBuffers > D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT)
     {
-        DeviceManager::context->PSSetConstantBuffers(startSlot, numBuffers, &constantBuffer);
+        std::cerr << "ERROR::PIPELINE_MANAGER::BIND_CONSTANT_BUFFER::SLOT_OUT_OF_RANGE" << std::endl;
+        return;
     }
-    default:
+
+    ConstantBufferBinding bindings[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
+    for (UINT i{ 0 }; i < numBuffers; ++i)
     {
-        std::cerr << "ERROR::PIPELINE_MANAGER::BIND_CONSTANT_BUFFER::STAGE_MUST_BE_VERTEX_OR_PIXEL" << std::endl;
+        bindings[i] = { constantBuffers[i], (firstConstants) ? (firstConstants[i]) : (0), (numConstants) ? (numConstants[i]) : (0) };
+        if (bindings[i].numConstants != 0 && !DeviceManager::device->SupportsConstantBufferOffsets())
+        {
+            std::cerr << "ERROR::PIPELINE_MANAGER::BIND_CONSTANT_BUFFER::CONSTANT_BUFFER_OFFSETS_NOT_SUPPORTED_BY_DEVICE" << std::endl;
+            return;
+        }
     }
+    if (!StageSlots(PipelineManager::constantBuffers[stage], startSlot, numBuffers, bindings, "BIND_CONSTANT_BUFFER"))
+    {
+        ++frameStatistics.elidedBindCalls;
     }
 }
+
+void PipelineManager::BindInputLayout(ID3D11InputLayout* inputLayout)
+{
+    PROFILE_FUNCTION();
+    ++frameStatistics.bindCalls;
+    if (pendingShaders.inputLayout == inputLayout) { ++frameStatistics.elidedBindCalls; }
+    pendingShaders.inputLayout = inputLayout;
+}
+
+void PipelineManager::BindPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology)
+{
+    PROFILE_FUNCTION();
+    ++frameStatistics.bindCalls;
+    if (pendingShaders.primitiveTopology == topology) { ++frameStatistics.elidedBindCalls; }
+    pendingShaders.primitiveTopology = topology;
+}
 //---------------------------------//
 //------End of Buffer Methods------//
 //---------------------------------//
 
 
 
+//--------------------------------//
+//---------Shader Methods---------//
+//--------------------------------//
+void PipelineManager::BindVertexShader(ID3D11VertexShader* vertexShader)
+{
+    PROFILE_FUNCTION();
+    ++frameStatistics.bindCalls;
+    if (pendingShaders.vertexShader == vertexShader) { ++frameStatistics.elidedBindCalls; }
+    pendingShaders.vertexShader = vertexShader;
+}
+
+void PipelineManager::BindPixelShader(ID3D11PixelShader* pixelShader)
+{
+    PROFILE_FUNCTION();
+    ++frameStatistics.bindCalls;
+    if (pendingShaders.pixelShader == pixelShader) { ++frameStatistics.elidedBindCalls; }
+    pendingShaders.pixelShader = pixelShader;
+}
+
+void PipelineManager::BindComputeShader(ID3D11ComputeShader* computeShader)
+{
+    PROFILE_FUNCTION();
+    ++frameStatistics.bindCalls;
+    if (pendingShaders.computeShader == computeShader) { ++frameStatistics.elidedBindCalls; }
+    pendingShaders.computeShader = computeShader;
+}
+//---------------------------------//
+//------End of Shader Methods------//
+//---------------------------------//
+
+
+
+//--------------------------------//
+//-------Rasteriser Methods-------//
+//--------------------------------//
+void PipelineManager::BindViewport(const D3D11_VIEWPORT& viewport)
+{
+    PROFILE_FUNCTION();
+    ++frameStatistics.bindCalls;
+    if (ViewportEqual(pendingViewport, viewport)) { ++frameStatistics.elidedBindCalls; }
+    pendingViewport = viewport;
+}
+//---------------------------------//
+//----End of Rasteriser Methods----//
+//---------------------------------//
+
+
+
 //---------------------------------//
 //---------Sampler Methods---------//
 //---------------------------------//
-void PipelineManager::BindSamplerStates(ID3D11SamplerState* samplerState, PIPELINE_STAGE stage, UINT startSlot, UINT numSamplerStates)
+void PipelineManager::BindSamplerStates(ID3D11SamplerState* const* samplerStates, PIPELINE_STAGE stage, UINT startSlot, UINT numSamplerStates)
 {
-    switch (stage)
+    PROFILE_FUNCTION();
+    ++frameStatistics.bindCalls;
+    if (stage >= PIPELINE_STAGE_COUNT)
     {
-    case (PIPELINE_STAGE::VERTEX_SHADER):
+        std::cerr << "ERROR::PIPELINE_MANAGER::BIND_SAMPLER_STATE::PROVIDED_STAGE_NOT_IN_ENUM" << std::endl;
+        return;
+    }
+    if (!StageSlots(PipelineManager::samplerStates[stage], startSlot, numSamplerStates, samplerStates, "BIND_SAMPLER_STATE"))
     {
-        DeviceManager::context->VSSetSamplers(startSlot, numSamplerStates, &samplerState);
+        ++frameStatistics.elidedBindCalls;
     }
-    case (PIPELINE_STAGE::DOMAIN_SHADER):
+}
+ID3D11SamplerState* PipelineManager::GetSamplerStates(PIPELINE_STAGE stage, UINT startSlot, UINT numSamplerStates)
+{
+    PROFILE_FUNCTION();
+    if (stage >= PIPELINE_STAGE_COUNT)
     {
-        DeviceManager::context->DSSetSamplers(startSlot, numSamplerStates, &samplerState);
+        std::cerr << "ERROR::PIPELINE_MANAGER::GET_SAMPLER_STATE::PROVIDED_STAGE_NOT_IN_ENUM" << std::endl;
+        return nullptr;
     }
-    case (PIPELINE_STAGE::HULL_SHADER):
+    if (startSlot + numSamplerStates > D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT)
     {
-        DeviceManager::context->HSSetSamplers(startSlot, numSamplerStates, &samplerState);
+        std::cerr << "ERROR::PIPELINE_MANAGER::GET_SAMPLER_STATE::SLOT_OUT_OF_RANGE" << std::endl;
+        return nullptr;
     }
-    case (PIPELINE_STAGE::GEOMETRY_SHADER):
+    return samplerStates[stage].pending[startSlot];
+}
+//----------------------------------//
+//------End of Sampler Methods------//
+//----------------------------------//
+
+
+
+//----------------------------------//
+//----Fixed Function State Methods--//
+//----------------------------------//
+void PipelineManager::BindBlendState(ID3D11BlendState* blendState, const FLOAT* blendFactor, UINT sampleMask)
+{
+    PROFILE_FUNCTION();
+    ++frameStatistics.bindCalls;
+    const FLOAT defaultBlendFactor[4]{ 1.0f, 1.0f, 1.0f, 1.0f };
+    if (!blendFactor) { blendFactor = defaultBlendFactor; }
+
+    if (pendingFixedFunction.blendState == blendState && pendingFixedFunction.sampleMask == sampleMask && std::equal(blendFactor, blendFactor + 4, pendingFixedFunction.blendFactor))
     {
-        DeviceManager::context->GSSetSamplers(startSlot, numSamplerStates, &samplerState);
+        ++frameStatistics.elidedBindCalls;
+        return;
     }
-    case (PIPELINE_STAGE::PIXEL_SHADER):
+    pendingFixedFunction.blendState = blendState;
+    std::copy_n(blendFactor, 4, pendingFixedFunction.blendFactor);
+    pendingFixedFunction.sampleMask = sampleMask;
+}
+
+void PipelineManager::BindDepthStencilState(ID3D11DepthStencilState* depthStencilState, UINT stencilRef)
+{
+    PROFILE_FUNCTION();
+    ++frameStatistics.bindCalls;
+    if (pendingFixedFunction.depthStencilState == depthStencilState && pendingFixedFunction.stencilRef == stencilRef) { ++frameStatistics.elidedBindCalls; }
+    pendingFixedFunction.depthStencilState = depthStencilState;
+    pendingFixedFunction.stencilRef = stencilRef;
+}
+
+void PipelineManager::BindRasterizerState(ID3D11RasterizerState* rasterizerState)
+{
+    PROFILE_FUNCTION();
+    ++frameStatistics.bindCalls;
+    if (pendingFixedFunction.rasterizerState == rasterizerState) { ++frameStatistics.elidedBindCalls; }
+    pendingFixedFunction.rasterizerState = rasterizerState;
+}
+//----------------------------------//
+//-End of Fixed Function State Meth-//
+//----------------------------------//
+
+
+
+//--------------------------------//
+//----------Draw Methods----------//
+//--------------------------------//
+void PipelineManager::Draw(UINT vertexCount, UINT startVertexLocation)
+{
+    PROFILE_FUNCTION();
+    FlushBindings();
+    context->Draw(vertexCount, startVertexLocation);
+    ++frameStatistics.drawCalls;
+}
+
+void PipelineManager::DrawIndexed(UINT indexCount, UINT startIndexLocation, INT baseVertexLocation)
+{
+    PROFILE_FUNCTION();
+    FlushBindings();
+    context->DrawIndexed(indexCount, startIndexLocation, baseVertexLocation);
+    ++frameStatistics.drawCalls;
+}
+
+void PipelineManager::DrawInstanced(UINT vertexCountPerInstance, UINT instanceCount, UINT startVertexLocation, UINT startInstanceLocation)
+{
+    PROFILE_FUNCTION();
+    FlushBindings();
+    context->DrawInstanced(vertexCountPerInstance, instanceCount, startVertexLocation, startInstanceLocation);
+    ++frameStatistics.drawCalls;
+}
+
+void PipelineManager::DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount, UINT startIndexLocation, INT baseVertexLocation, UINT startInstanceLocation)
+{
+    PROFILE_FUNCTION();
+    FlushBindings();
+    context->DrawIndexedInstanced(indexCountPerInstance, instanceCount, startIndexLocation, baseVertexLocation, startInstanceLocation);
+    ++frameStatistics.drawCalls;
+}
+
+void PipelineManager::DrawInstancedIndirect(ID3D11Buffer* argsBuffer, UINT byteOffset)
+{
+    PROFILE_FUNCTION();
+    if (!argsBuffer || byteOffset % 4 != 0)
     {
-        DeviceManager::context->PSSetSamplers(startSlot, numSamplerStates, &samplerState);
+        std::cerr << "ERROR::PIPELINE_MANAGER::DRAW_INSTANCED_INDIRECT::INVALID_ARGS_BUFFER_OR_OFFSET" << std::endl;
+        return;
     }
-    case (PIPELINE_STAGE::COMPUTE_SHADER):
+    FlushBindings();
+    context->DrawInstancedIndirect(argsBuffer, byteOffset);
+    ++frameStatistics.drawCalls;
+}
+
+void PipelineManager::DrawIndexedInstancedIndirect(ID3D11Buffer* argsBuffer, UINT byteOffset)
+{
+    PROFILE_FUNCTION();
+    if (!argsBuffer || byteOffset % 4 != 0)
     {
-        DeviceManager::context->CSSetSamplers(startSlot, numSamplerStates, &samplerState);
+        std::cerr << "ERROR::PIPELINE_MANAGER::DRAW_INDEXED_INSTANCED_INDIRECT::INVALID_ARGS_BUFFER_OR_OFFSET" << std::endl;
+        return;
     }
-    default:
+    FlushBindings();
+    context->DrawIndexedInstancedIndirect(argsBuffer, byteOffset);
+    ++frameStatistics.drawCalls;
+}
+//---------------------------------//
+//-------End of Draw Methods-------//
+//---------------------------------//
+
+
+
+//--------------------------------//
+//---------Compute Methods--------//
+//--------------------------------//
+void PipelineManager::Dispatch(UINT threadGroupCountX, UINT threadGroupCountY, UINT threadGroupCountZ)
+{
+    PROFILE_FUNCTION();
+    FlushBindings();
+    context->Dispatch(threadGroupCountX, threadGroupCountY, threadGroupCountZ);
+    ++frameStatistics.dispatchCalls;
+}
+
+void PipelineManager::DispatchIndirect(ID3D11Buffer* argsBuffer, UINT byteOffset)
+{
+    PROFILE_FUNCTION();
+    if (!argsBuffer || byteOffset % 4 != 0)
     {
-        std::cerr << "ERROR::PIPELINE_MANAGER::BIND_SAMPLER_STATE::PROVIDED_STAGE_NOT_IN_ENUM" << std::endl;
+        std::cerr << "ERROR::PIPELINE_MANAGER::DISPATCH_INDIRECT::INVALID_ARGS_BUFFER_OR_OFFSET" << std::endl;
+        return;
     }
+    FlushBindings();
+    context->DispatchIndirect(argsBuffer, byteOffset);
+    ++frameStatistics.dispatchCalls;
+}
+
+void PipelineManager::CopyStructureCount(ID3D11Buffer* destinationBuffer, UINT byteOffset, ID3D11UnorderedAccessView* sourceView)
+{
+    PROFILE_FUNCTION();
+    if (!destinationBuffer || !sourceView || byteOffset % 4 != 0)
+    {
+        std::cerr << "ERROR::PIPELINE_MANAGER::COPY_STRUCTURE_COUNT::INVALID_BUFFER_VIEW_OR_OFFSET" << std::endl;
+        return;
     }
+    context->CopyStructureCount(destinationBuffer, byteOffset, sourceView);
 }
-ID3D11SamplerState* PipelineManager::GetSamplerStates(PIPELINE_STAGE stage, UINT startSlot, UINT numSamplerStates)
+//---------------------------------//
+//------End of Compute Methods-----//
+//---------------------------------//
+
+
+
+//---------------------------------//
+//------Binding Cache Methods------//
+//---------------------------------//
+void PipelineManager::FlushBindings()
 {
-    ID3D11SamplerState* samplerStates;
-    switch (stage)
+    PROFILE_FUNCTION();
+    UINT issued{ 0 };
+
+    //A resource going from being read to being written has its SRVs nulled before it is bound as a render target, depth
+    //stencil view or UAV, rather than leaving the runtime to unbind them behind the cache's back
+    if (outputMergerDirty || computeUnorderedAccessViews.dirtyMin <= computeUnorderedAccessViews.dirtyMax)
+    {
+        const OutputMergerBinding& om{ pendingOutputMerger };
+        const UnorderedAccessViewBinding* const uavs{ computeUnorderedAccessViews.pending };
+        const auto pendingWrite{ [&](ID3D11Resource* resource)
+        {
+            return std::any_of(uavs, uavs + D3D11_PS_CS_UAV_REGISTER_COUNT, [resource](const UnorderedAccessViewBinding& b) { return b.view && b.resource == resource; })
+                || std::find(om.renderTargetViewResources, om.renderTargetViewResources + om.numRenderTargetViews, resource) != om.renderTargetViewResources + om.numRenderTargetViews
+                || (om.depthStencilView && om.depthStencilViewResource == resource)
+                || std::find(om.unorderedAccessViewResources, om.unorderedAccessViewResources + D3D11_PS_CS_UAV_REGISTER_COUNT, resource) != om.unorderedAccessViewResources + D3D11_PS_CS_UAV_REGISTER_COUNT;
+        } };
+        ID3D11ShaderResourceView* const nullView{ nullptr };
+        for (UINT s{ 0 }; s < PIPELINE_STAGE_COUNT; ++s)
+        {
+            BindingSlots<ShaderResourceViewBinding, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT>& slots{ shaderResourceViews[s] };
+            for (UINT i{ slots.dirtyMin }; i <= slots.dirtyMax && i < D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT; ++i)
+            {
+                if (slots.pending[i].view || !slots.bound[i].view) { continue; }
+                if (!pendingWrite(slots.bound[i].resource)) { continue; }
+                context->SetShaderResources(static_cast<PIPELINE_STAGE>(s), i, 1, &nullView);
+                slots.bound[i] = slots.pending[i];
+                ++issued;
+            }
+        }
+    }
+
+    //Output merger
+    if (outputMergerDirty)
+    {
+        //Pixel shader UAVs share register space with the render targets and so start after them - any below the last render
+        //target can't be bound, and are dropped so the cache doesn't believe they are
+        const UINT uavStart{ pendingOutputMerger.numRenderTargetViews };
+        if (std::any_of(pendingOutputMerger.unorderedAccessViews, pendingOutputMerger.unorderedAccessViews + uavStart, [](ID3D11UnorderedAccessView* v) { return v != nullptr; }))
+        {
+            std::cerr << "ERROR::PIPELINE_MANAGER::FLUSH_BINDINGS::UNORDERED_ACCESS_VIEW_SLOT_OVERLAPS_RENDER_TARGET_VIEWS" << std::endl;
+            std::fill_n(pendingOutputMerger.unorderedAccessViews, uavStart, nullptr);
+            std::fill_n(pendingOutputMerger.unorderedAccessViewResources, uavStart, nullptr);
+            std::fill_n(pixelInitialCounts, uavStart, static_cast<UINT>(-1));
+        }
+
+        if (!OutputMergerEqual(pendingOutputMerger, boundOutputMerger) || std::any_of(pixelInitialCounts, pixelInitialCounts + D3D11_PS_CS_UAV_REGISTER_COUNT, [](UINT c) { return c != static_cast<UINT>(-1); }))
+        {
+            const OutputMergerBinding& om{ pendingOutputMerger };
+            const bool hasUnorderedAccessViews{ std::any_of(om.unorderedAccessViews, om.unorderedAccessViews + D3D11_PS_CS_UAV_REGISTER_COUNT, [](ID3D11UnorderedAccessView* v) { return v != nullptr; }) };
+            const bool hadUnorderedAccessViews{ std::any_of(boundOutputMerger.unorderedAccessViews, boundOutputMerger.unorderedAccessViews + D3D11_PS_CS_UAV_REGISTER_COUNT, [](ID3D11UnorderedAccessView* v) { return v != nullptr; }) };
+            if (hasUnorderedAccessViews || hadUnorderedAccessViews)
+            {
+                context->OMSetRenderTargetsAndUnorderedAccessViews(om.numRenderTargetViews, om.renderTargetViews, om.depthStencilView, uavStart, D3D11_PS_CS_UAV_REGISTER_COUNT - uavStart, om.unorderedAccessViews + uavStart, pixelInitialCounts + uavStart);
+            }
+            else
+            {
+                context->OMSetRenderTargets(om.numRenderTargetViews, om.renderTargetViews, om.depthStencilView);
+            }
+            boundOutputMerger = pendingOutputMerger;
+            ++issued;
+        }
+        std::fill_n(pixelInitialCounts, D3D11_PS_CS_UAV_REGISTER_COUNT, static_cast<UINT>(-1));
+        outputMergerDirty = false;
+    }
+
+    //Compute UAVs - issued before the remaining SRVs, so a resource going from being written to being read is unbound as a UAV first
+    issued += FlushSlots(computeUnorderedAccessViews, [&](UINT start, UINT count, const UnorderedAccessViewBinding* bindings)
+    {
+        ID3D11UnorderedAccessView* views[D3D11_PS_CS_UAV_REGISTER_COUNT];
+        for (UINT i{ 0 }; i < count; ++i) { views[i] = bindings[i].view; }
+        context->CSSetUnorderedAccessViews(start, count, views, computeInitialCounts + start);
+    }, computeReissueMask);
+    computeReissueMask = 0;
+    std::fill_n(computeInitialCounts, D3D11_PS_CS_UAV_REGISTER_COUNT, static_cast<UINT>(-1));
+
+    //Per-stage slots
+    for (UINT s{ 0 }; s < PIPELINE_STAGE_COUNT; ++s)
+    {
+        const PIPELINE_STAGE stage{ static_cast<PIPELINE_STAGE>(s) };
+
+        issued += FlushSlots(shaderResourceViews[s], [&](UINT start, UINT count, const ShaderResourceViewBinding* bindings)
+        {
+            ID3D11ShaderResourceView* views[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT];
+            for (UINT i{ 0 }; i < count; ++i) { views[i] = bindings[i].view; }
+            context->SetShaderResources(stage, start, count, views);
+        });
+
+        issued += FlushSlots(constantBuffers[s], [&](UINT start, UINT count, const ConstantBufferBinding* bindings)
+        {
+            ID3D11Buffer* buffers[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
+            UINT firstConstants[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
+            UINT numConstants[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
+            bool windowed{ false };
+            for (UINT i{ 0 }; i < count; ++i)
+            {
+                buffers[i] = bindings[i].buffer;
+                windowed = windowed || bindings[i].numConstants != 0;
+                //Whole-buffer bindings in a windowed run are expressed as the largest window a constant buffer can have
+                firstConstants[i] = (bindings[i].numConstants != 0) ? (bindings[i].firstConstant) : (0);
+                numConstants[i] = (bindings[i].numConstants != 0) ? (bindings[i].numConstants) : (D3D11_REQ_CONSTANT_BUFFER_ELEMENT_COUNT);
+            }
+            if (windowed) { context->SetConstantBuffers1(stage, start, count, buffers, firstConstants, numConstants); }
+            else          { context->SetConstantBuffers(stage, start, count, buffers); }
+        });
+
+        issued += FlushSlots(samplerStates[s], [&](UINT start, UINT count, ID3D11SamplerState* const* samplers)
+        {
+            context->SetSamplers(stage, start, count, samplers);
+        });
+    }
+
+    //Input assembler
+    issued += FlushSlots(vertexBuffers, [&](UINT start, UINT count, const VertexBufferBinding* bindings)
     {
-    case (PIPELINE_STAGE::VERTEX_SHADER):
+        ID3D11Buffer* buffers[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+        UINT strides[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+        UINT offsets[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+        for (UINT i{ 0 }; i < count; ++i)
+        {
+            buffers[i] = bindings[i].buffer;
+            strides[i] = bindings[i].stride;
+            offsets[i] = bindings[i].offset;
+        }
+        context->IASetVertexBuffers(start, count, buffers, strides, offsets);
+    });
+    if (!(pendingIndexBuffer == boundIndexBuffer))
     {
-        DeviceManager::context->VSGetSamplers(startSlot, numSamplerStates, &samplerStates);
+        context->IASetIndexBuffer(pendingIndexBuffer.buffer, pendingIndexBuffer.format, pendingIndexBuffer.offset);
+        boundIndexBuffer = pendingIndexBuffer;
+        ++issued;
     }
-    case (PIPELINE_STAGE::DOMAIN_SHADER):
+    if (pendingShaders.inputLayout != boundShaders.inputLayout)
     {
-        DeviceManager::context->DSGetSamplers(startSlot, numSamplerStates, &samplerStates);
+        context->IASetInputLayout(pendingShaders.inputLayout);
+        ++issued;
     }
-    case (PIPELINE_STAGE::HULL_SHADER):
+    if (pendingShaders.primitiveTopology != boundShaders.primitiveTopology)
     {
-        DeviceManager::context->HSGetSamplers(startSlot, numSamplerStates, &samplerStates);
+        context->IASetPrimitiveTopology(pendingShaders.primitiveTopology);
+        ++issued;
     }
-    case (PIPELINE_STAGE::GEOMETRY_SHADER):
+
+    //Rasteriser
+    if (!ViewportEqual(pendingViewport, boundViewport))
     {
-        DeviceManager::context->GSGetSamplers(startSlot, numSamplerStates, &samplerStates);
+        context->RSSetViewports(1, &pendingViewport);
+        boundViewport = pendingViewport;
+        ++issued;
     }
-    case (PIPELINE_STAGE::PIXEL_SHADER):
+
+    //Fixed function states
+    const FixedFunctionBinding& ff{ pendingFixedFunction };
+    if (ff.blendState != boundFixedFunction.blendState || ff.sampleMask != boundFixedFunction.sampleMask || !std::equal(ff.blendFactor, ff.blendFactor + 4, boundFixedFunction.blendFactor))
     {
-        DeviceManager::context->PSGetSamplers(startSlot, numSamplerStates, &samplerStates);
+        context->OMSetBlendState(ff.blendState, ff.blendFactor, ff.sampleMask);
+        ++issued;
     }
-    case (PIPELINE_STAGE::COMPUTE_SHADER):
+    if (ff.depthStencilState != boundFixedFunction.depthStencilState || ff.stencilRef != boundFixedFunction.stencilRef)
     {
-        DeviceManager::context->CSGetSamplers(startSlot, numSamplerStates, &samplerStates);
+        context->OMSetDepthStencilState(ff.depthStencilState, ff.stencilRef);
+        ++issued;
     }
-    default:
+    if (ff.rasterizerState != boundFixedFunction.rasterizerState)
     {
-        std::cerr << "ERROR::PIPELINE_MANAGER::GET_SAMPLER_STATE::PROVIDED_STAGE_NOT_IN_ENUM" << std::endl;
+        context->RSSetState(ff.rasterizerState);
+        ++issued;
     }
+    boundFixedFunction = pendingFixedFunction;
+
+    //Shaders
+    if (pendingShaders.vertexShader != boundShaders.vertexShader)
+    {
+        context->VSSetShader(pendingShaders.vertexShader);
+        ++issued;
+    }
+    if (pendingShaders.pixelShader != boundShaders.pixelShader)
+    {
+        context->PSSetShader(pendingShaders.pixelShader);
+        ++issued;
+    }
+    if (pendingShaders.computeShader != boundShaders.computeShader)
+    {
+        context->CSSetShader(pendingShaders.computeShader);
+        ++issued;
+    }
+    boundShaders = pendingShaders;
+
+    frameStatistics.issuedContextCalls += issued;
+}
+
+void PipelineManager::InvalidateBindingCache()
+{
+    PROFILE_FUNCTION();
+    //The context is assumed to be in its default (cleared) state, so everything still pending gets re-issued on the next flush
+    for (UINT s{ 0 }; s < PIPELINE_STAGE_COUNT; ++s)
+    {
+        shaderResourceViews[s].dirtyMin = 0; shaderResourceViews[s].dirtyMax = D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT - 1;
+        constantBuffers[s].dirtyMin = 0;     constantBuffers[s].dirtyMax = D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT - 1;
+        samplerStates[s].dirtyMin = 0;       samplerStates[s].dirtyMax = D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT - 1;
+        std::fill_n(shaderResourceViews[s].bound, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT, ShaderResourceViewBinding{});
+        std::fill_n(constantBuffers[s].bound, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT, ConstantBufferBinding{});
+        std::fill_n(samplerStates[s].bound, D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT, nullptr);
     }
-    return samplerStates;
+    computeUnorderedAccessViews.dirtyMin = 0;
+    computeUnorderedAccessViews.dirtyMax = D3D11_PS_CS_UAV_REGISTER_COUNT - 1;
+    std::fill_n(computeUnorderedAccessViews.bound, D3D11_PS_CS_UAV_REGISTER_COUNT, UnorderedAccessViewBinding{});
+    std::fill_n(computeInitialCounts, D3D11_PS_CS_UAV_REGISTER_COUNT, static_cast<UINT>(-1));
+
+    vertexBuffers.dirtyMin = 0;
+    vertexBuffers.dirtyMax = D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT - 1;
+    std::fill_n(vertexBuffers.bound, D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT, VertexBufferBinding{});
+    boundIndexBuffer = {};
+    boundShaders = {};
+    boundViewport = {};
+    boundFixedFunction = {};
+
+    boundOutputMerger = {};
+    std::fill_n(pixelInitialCounts, D3D11_PS_CS_UAV_REGISTER_COUNT, static_cast<UINT>(-1));
+    outputMergerDirty = true;
+}
+
+void PipelineManager::InvalidateOutputMergerBinding()
+{
+    PROFILE_FUNCTION();
+    boundOutputMerger = {};
+    outputMergerDirty = true;
+}
+
+PipelineStatistics PipelineManager::GetFrameStatistics()
+{
+    return lastFrameStatistics;
+}
+
+void PipelineManager::EndFrame()
+{
+    PROFILE_FUNCTION();
+    std::lock_guard<std::mutex> lock{ recordedStatisticsMutex };
+    lastFrameStatistics = frameStatistics;
+    lastFrameStatistics.bindCalls += recordedStatistics.bindCalls;
+    lastFrameStatistics.elidedBindCalls += recordedStatistics.elidedBindCalls;
+    lastFrameStatistics.issuedContextCalls += recordedStatistics.issuedContextCalls;
+    lastFrameStatistics.drawCalls += recordedStatistics.drawCalls;
+    lastFrameStatistics.dispatchCalls += recordedStatistics.dispatchCalls;
+    lastFrameStatistics.hazardUnbinds += recordedStatistics.hazardUnbinds;
+    frameStatistics = {};
+    recordedStatistics = {};
+}
+
+PipelineManager::InheritedState PipelineManager::CaptureInheritedState()
+{
+    return InheritedState{ pendingOutputMerger, pendingViewport, pendingFixedFunction };
+}
+
+void PipelineManager::BeginRecording(GraphicsContext* deferredContext, const InheritedState& inheritedState)
+{
+    PROFILE_FUNCTION();
+    if (context)
+    {
+        suspendedStates.emplace_back();
+        SuspendBindingState(suspendedStates.back());
+    }
+
+    //A deferred context starts every command list in the default state, which is exactly what a reset cache believes is bound
+    context = deferredContext;
+    ResetBindingState();
+    frameStatistics = {};
+
+    pendingOutputMerger = inheritedState.outputMerger;
+    outputMergerDirty = true;
+    pendingViewport = inheritedState.viewport;
+    pendingFixedFunction = inheritedState.fixedFunction;
+}
+
+ID3D11CommandList* PipelineManager::EndRecording()
+{
+    PROFILE_FUNCTION();
+    ID3D11CommandList* commandList{};
+    if (FAILED(context->FinishCommandList(&commandList)))
+    {
+        std::cerr << "ERROR::PIPELINE_MANAGER::END_RECORDING::FAILED_TO_FINISH_COMMAND_LIST" << std::endl;
+        commandList = nullptr;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{ recordedStatisticsMutex };
+        recordedStatistics.bindCalls += frameStatistics.bindCalls;
+        recordedStatistics.elidedBindCalls += frameStatistics.elidedBindCalls;
+        recordedStatistics.issuedContextCalls += frameStatistics.issuedContextCalls;
+        recordedStatistics.drawCalls += frameStatistics.drawCalls;
+        recordedStatistics.dispatchCalls += frameStatistics.dispatchCalls;
+        recordedStatistics.hazardUnbinds += frameStatistics.hazardUnbinds;
+    }
+    frameStatistics = {};
+    context = nullptr;
+    if (!suspendedStates.empty())
+    {
+        ResumeBindingState(suspendedStates.back());
+        suspendedStates.pop_back();
+    }
+    return commandList;
 }
 //----------------------------------//
-//------End of Sampler Methods------//
-//----------------------------------//
\ No newline at end of file
+//---End of Binding Cache Methods---//
+//----------------------------------//
+
+
+
+//Returns the calling thread's pending and bound state to the context defaults, with nothing left to flush
+void PipelineManager::ResetBindingState()
+{
+    for (UINT s{ 0 }; s < PIPELINE_STAGE_COUNT; ++s)
+    {
+        shaderResourceViews[s] = {};
+        constantBuffers[s] = {};
+        samplerStates[s] = {};
+    }
+    computeUnorderedAccessViews = {};
+    std::fill_n(computeInitialCounts, D3D11_PS_CS_UAV_REGISTER_COUNT, static_cast<UINT>(-1));
+    computeReissueMask = 0;
+    vertexBuffers = {};
+
+    boundIndexBuffer = {};
+    pendingIndexBuffer = {};
+    boundShaders = {};
+    pendingShaders = {};
+    boundViewport = {};
+    pendingViewport = {};
+    boundFixedFunction = {};
+    pendingFixedFunction = {};
+
+    boundOutputMerger = {};
+    pendingOutputMerger = {};
+    std::fill_n(pixelInitialCounts, D3D11_PS_CS_UAV_REGISTER_COUNT, static_cast<UINT>(-1));
+    outputMergerDirty = false;
+}
+
+void PipelineManager::SuspendBindingState(SuspendedState& state)
+{
+    state.context = context;
+    std::copy_n(shaderResourceViews, PIPELINE_STAGE_COUNT, state.shaderResourceViews);
+    std::copy_n(constantBuffers, PIPELINE_STAGE_COUNT, state.constantBuffers);
+    std::copy_n(samplerStates, PIPELINE_STAGE_COUNT, state.samplerStates);
+    state.computeUnorderedAccessViews = computeUnorderedAccessViews;
+    std::copy_n(computeInitialCounts, D3D11_PS_CS_UAV_REGISTER_COUNT, state.computeInitialCounts);
+    state.computeReissueMask = computeReissueMask;
+    state.vertexBuffers = vertexBuffers;
+    state.boundIndexBuffer = boundIndexBuffer;
+    state.pendingIndexBuffer = pendingIndexBuffer;
+    state.boundShaders = boundShaders;
+    state.pendingShaders = pendingShaders;
+    state.boundViewport = boundViewport;
+    state.pendingViewport = pendingViewport;
+    state.boundFixedFunction = boundFixedFunction;
+    state.pendingFixedFunction = pendingFixedFunction;
+    state.boundOutputMerger = boundOutputMerger;
+    state.pendingOutputMerger = pendingOutputMerger;
+    std::copy_n(pixelInitialCounts, D3D11_PS_CS_UAV_REGISTER_COUNT, state.pixelInitialCounts);
+    state.outputMergerDirty = outputMergerDirty;
+    state.frameStatistics = frameStatistics;
+}
+
+void PipelineManager::ResumeBindingState(const SuspendedState& state)
+{
+    context = state.context;
+    std::copy_n(state.shaderResourceViews, PIPELINE_STAGE_COUNT, shaderResourceViews);
+    std::copy_n(state.constantBuffers, PIPELINE_STAGE_COUNT, constantBuffers);
+    std::copy_n(state.samplerStates, PIPELINE_STAGE_COUNT, samplerStates);
+    computeUnorderedAccessViews = state.computeUnorderedAccessViews;
+    std::copy_n(state.computeInitialCounts, D3D11_PS_CS_UAV_REGISTER_COUNT, computeInitialCounts);
+    computeReissueMask = state.computeReissueMask;
+    vertexBuffers = state.vertexBuffers;
+    boundIndexBuffer = state.boundIndexBuffer;
+    pendingIndexBuffer = state.pendingIndexBuffer;
+    boundShaders = state.boundShaders;
+    pendingShaders = state.pendingShaders;
+    boundViewport = state.boundViewport;
+    pendingViewport = state.pendingViewport;
+    boundFixedFunction = state.boundFixedFunction;
+    pendingFixedFunction = state.pendingFixedFunction;
+    boundOutputMerger = state.boundOutputMerger;
+    pendingOutputMerger = state.pendingOutputMerger;
+    std::copy_n(state.pixelInitialCounts, D3D11_PS_CS_UAV_REGISTER_COUNT, pixelInitialCounts);
+    outputMergerDirty = state.outputMergerDirty;
+    frameStatistics = state.frameStatistics;
+}
+
+//Copies values into the pending state of the given slots and widens the dirty range
+//Returns false if every requested slot already held the requested value
+template<typename T, UINT N>
+bool PipelineManager::StageSlots(BindingSlots<T, N>& slots, UINT startSlot, UINT numSlots, const T* values, const char* caller)
+{
+    if (numSlots == 0) { return false; }
+    if (startSlot + numSlots > N)
+    {
+        std::cerr << "ERROR::PIPELINE_MANAGER::" << caller << "::SLOT_OUT_OF_RANGE" << std::endl;
+        return true; //Not a redundant call, just an invalid one
+    }
+
+    bool changed{ false };
+    for (UINT i{ 0 }; i < numSlots; ++i)
+    {
+        if (!(slots.pending[startSlot + i] == values[i]))
+        {
+            slots.pending[startSlot + i] = values[i];
+            changed = true;
+        }
+    }
+    if (changed)
+    {
+        slots.dirtyMin = (std::min)(slots.dirtyMin, startSlot);
+        slots.dirtyMax = (std::max)(slots.dirtyMax, startSlot + numSlots - 1);
+    }
+    return changed;
+}
+
+//Issues one call per contiguous run of slots whose pending value differs from the bound value
+//Returns the number of calls issued
+template<typename T, UINT N, typename IssueFunction>
+UINT PipelineManager::FlushSlots(BindingSlots<T, N>& slots, IssueFunction issue, UINT reissueMask)
+{
+    const auto current{ [&](UINT s) { return slots.pending[s] == slots.bound[s] && (s >= 32 || (reissueMask & (1u << s)) == 0); } };
+    UINT issued{ 0 };
+    UINT slot{ slots.dirtyMin };
+    while (slot <= slots.dirtyMax && slot < N)
+    {
+        if (current(slot))
+        {
+            ++slot;
+            continue;
+        }
+
+        const UINT runStart{ slot };
+        while (slot <= slots.dirtyMax && !current(slot))
+        {
+            slots.bound[slot] = slots.pending[slot];
+            ++slot;
+        }
+        issue(runStart, slot - runStart, slots.bound + runStart);
+        ++issued;
+    }
+
+    slots.dirtyMin = N;
+    slots.dirtyMax = 0;
+    return issued;
+}
+
+bool PipelineManager::HasPendingUnorderedAccessViews()
+{
+    return std::any_of(computeUnorderedAccessViews.pending, computeUnorderedAccessViews.pending + D3D11_PS_CS_UAV_REGISTER_COUNT, [](const UnorderedAccessViewBinding& b) { return b.view != nullptr; })
+        || std::any_of(pendingOutputMerger.unorderedAccessViews, pendingOutputMerger.unorderedAccessViews + D3D11_PS_CS_UAV_REGISTER_COUNT, [](ID3D11UnorderedAccessView* v) { return v != nullptr; });
+}
+
+//Unbinds every SRV of the resource, on every stage
+void PipelineManager::UnbindResourceShaderResourceViews(ID3D11Resource* resource)
+{
+    const ShaderResourceViewBinding nullBinding{};
+    for (UINT s{ 0 }; s < PIPELINE_STAGE_COUNT; ++s)
+    {
+        BindingSlots<ShaderResourceViewBinding, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT>& slots{ shaderResourceViews[s] };
+        for (UINT i{ 0 }; i < D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT; ++i)
+        {
+            if (slots.pending[i].resource == resource)
+            {
+                StageSlots(slots, i, 1, &nullBinding, "UNBIND_RESOURCE_SHADER_RESOURCE_VIEWS");
+                ++frameStatistics.hazardUnbinds;
+            }
+        }
+    }
+}
+
+//Unbinds the resource's UAVs from the output merger and/or the compute stage
+void PipelineManager::UnbindResourceUnorderedAccessViews(ID3D11Resource* resource, bool pixelSlots, bool computeSlots)
+{
+    const UnorderedAccessViewBinding nullBinding{};
+    for (UINT i{ 0 }; i < D3D11_PS_CS_UAV_REGISTER_COUNT; ++i)
+    {
+        if (pixelSlots && pendingOutputMerger.unorderedAccessViews[i] && pendingOutputMerger.unorderedAccessViewResources[i] == resource)
+        {
+            pendingOutputMerger.unorderedAccessViews[i] = nullptr;
+            pendingOutputMerger.unorderedAccessViewResources[i] = nullptr;
+            pixelInitialCounts[i] = static_cast<UINT>(-1);
+            outputMergerDirty = true;
+            ++frameStatistics.hazardUnbinds;
+        }
+        if (computeSlots && computeUnorderedAccessViews.pending[i].view && computeUnorderedAccessViews.pending[i].resource == resource)
+        {
+            StageSlots(computeUnorderedAccessViews, i, 1, &nullBinding, "UNBIND_RESOURCE_UNORDERED_ACCESS_VIEWS");
+            computeInitialCounts[i] = static_cast<UINT>(-1);
+            computeReissueMask &= ~(1u << i);
+            ++frameStatistics.hazardUnbinds;
+        }
+    }
+}
+
+//Unbinds the resource's render targets and depth stencil view from the output merger
+void PipelineManager::UnbindResourceTargetViews(ID3D11Resource* resource)
+{
+    OutputMergerBinding& om{ pendingOutputMerger };
+    for (UINT i{ 0 }; i < om.numRenderTargetViews; ++i)
+    {
+        if (om.renderTargetViews[i] && om.renderTargetViewResources[i] == resource)
+        {
+            om.renderTargetViews[i] = nullptr;
+            om.renderTargetViewResources[i] = nullptr;
+            outputMergerDirty = true;
+            ++frameStatistics.hazardUnbinds;
+        }
+    }
+    //Trailing null views don't occupy a slot
+    while (om.numRenderTargetViews > 0 && om.renderTargetViews[om.numRenderTargetViews - 1] == nullptr) { --om.numRenderTargetViews; }
+
+    if (om.depthStencilView && om.depthStencilViewResource == resource)
+    {
+        om.depthStencilView = nullptr;
+        om.depthStencilViewResource = nullptr;
+        outputMergerDirty = true;
+        ++frameStatistics.hazardUnbinds;
+    }
+}
+
+bool PipelineManager::OutputMergerEqual(const OutputMergerBinding& a, const OutputMergerBinding& b)
+{
+    return a.numRenderTargetViews == b.numRenderTargetViews
+        && a.depthStencilView == b.depthStencilView
+        && std::equal(a.renderTargetViews, a.renderTargetViews + D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT, b.renderTargetViews)
+        && std::equal(a.unorderedAccessViews, a.unorderedAccessViews + D3D11_PS_CS_UAV_REGISTER_COUNT, b.unorderedAccessViews);
+}
+
+bool PipelineManager::ViewportEqual(const D3D11_VIEWPORT& a, const D3D11_VIEWPORT& b)
+{
+    return a.TopLeftX == b.TopLeftX && a.TopLeftY == b.TopLeftY
+        && a.Width == b.Width && a.Height == b.Height
+        && a.MinDepth == b.MinDepth && a.MaxDepth == b.MaxDepth;
+}
\ No newline at end of file
@@ -1,7 +1,10 @@
 ﻿#pragma once
 #include <d3d11.h>
+#include <mutex>
 #include <vector>
 
+class GraphicsContext;
+
 
 enum PIPELINE_STAGE
 {
@@ -11,43 +14,311 @@ enum PIPELINE_STAGE
     GEOMETRY_SHADER,
     PIXEL_SHADER,
     COMPUTE_SHADER,
+
+    PIPELINE_STAGE_COUNT,
 };
 
 
+//Counters for the binding cache, accumulated over one frame
+struct PipelineStatistics
+{
+    UINT bindCalls;          //Number of Bind* calls made on the PipelineManager
+    UINT elidedBindCalls;    //Bind* calls that were dropped because the requested state was already bound
+    UINT issuedContextCalls; //State-setting calls actually issued to the device context
+    UINT drawCalls;          //Draw* calls issued to the device context
+    UINT dispatchCalls;      //Dispatch* calls issued to the device context
+    UINT hazardUnbinds;      //Bindings dropped because the same resource was bound for reading and writing at once
+};
+
+
+//The binding cache is per thread - the main thread records to the immediate context, while RenderManager::RecordParallel()
+//points the cache of whichever thread runs each recording job at that job's deferred context (see RenderManager.h)
 class PipelineManager
 {
     friend class EngineManager;
-    
+    friend class RenderManager;
+
 public:
     PipelineManager() = default;
     ~PipelineManager() = default;
-    
+
     //----View Methods----//
     [[nodiscard]] static ID3D11DepthStencilView* GetCurrentDepthStencilView();
     [[nodiscard]] static std::vector<ID3D11RenderTargetView*> GetCurrentRenderTargetViews();
-    
+
     static void BindDepthStencilView(ID3D11DepthStencilView* depthStencilView);
     static void BindRenderTargetViews(const std::vector<ID3D11RenderTargetView*>& renderTargetViews);
-    static void BindShaderResourceViews(ID3D11ShaderResourceView* shaderResourceViews, PIPELINE_STAGE stage, UINT startSlot, UINT numViews);
-    static void BindUnorderedAccessViews(ID3D11UnorderedAccessView* unorderedAccessViews, PIPELINE_STAGE stage, UINT startSlot, UINT numViews, UINT* initialCounts=nullptr);
+    //A resource can't be bound for reading and writing at the same time - D3D11 would silently null one of the views - so
+    //binding a view unbinds whatever conflicts with it: an SRV unbinds every render target, depth stencil view and UAV of its
+    //resource, a render target or depth stencil view every SRV of its resource on any stage, and a UAV every SRV of its
+    //resource on any stage as well as its UAVs on the other of the pixel and compute stages
+    //Depth stencil views are always treated as writable, as nothing creates read-only ones
+    static void BindShaderResourceViews(ID3D11ShaderResourceView* const* shaderResourceViews, PIPELINE_STAGE stage, UINT startSlot, UINT numViews);
+    //Pixel shader UAV slots share register space with the render targets, so they must start at or after the last bound render target
+    //UAVs below the last render target when the bindings are flushed are dropped with an error
+    static void BindUnorderedAccessViews(ID3D11UnorderedAccessView* const* unorderedAccessViews, PIPELINE_STAGE stage, UINT startSlot, UINT numViews, UINT* initialCounts=nullptr);
+    //Unbinds the view from every stage and slot it is bound to (e.g. before its texture is bound as a render target)
+    static void UnbindShaderResourceView(ID3D11ShaderResourceView* shaderResourceView);
 
     static void ClearRenderTargetView(ID3D11RenderTargetView* renderTargetView, FLOAT* clearColour);
     static void ClearDepthStencilView(ID3D11DepthStencilView* depthStencilView, FLOAT clearDepth, UINT8 clearStencil);
     static void ClearUnorderedAccessViewFloat(ID3D11UnorderedAccessView* unorderedAccessView, FLOAT clearValue[4]);
     static void ClearUnorderedAccessViewUint(ID3D11UnorderedAccessView* unorderedAccessView, UINT clearValue[4]);
 
-    
+
     //----Buffer Methods----//
-    static void BindVertexBuffers(ID3D11Buffer* vertexBuffers, UINT startSlot, UINT numBuffers, UINT stride, UINT offset=0);
+    static void BindVertexBuffers(ID3D11Buffer* const* vertexBuffers, UINT startSlot, UINT numBuffers, UINT stride, UINT offset=0);
+    //As above, with a stride and offset per buffer, e.g. a mesh in slot 0 and a per-instance stream in slot 1
+    static void BindVertexBuffers(ID3D11Buffer* const* vertexBuffers, UINT startSlot, UINT numBuffers, const UINT* strides, const UINT* offsets);
     static void BindIndexBuffer(ID3D11Buffer* indexBuffer, DXGI_FORMAT format=DXGI_FORMAT_R32_UINT, UINT offset=0);
-    static void BindConstantBuffers(PIPELINE_STAGE stage, UINT startSlot, UINT numBuffers, ID3D11Buffer* constantBuffer);
-    
+    static void BindConstantBuffers(PIPELINE_STAGE stage, UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers);
+    //Binds a window of each buffer in units of 16-byte constants (firstConstant and numConstants multiples of 16), e.g. for UploadManager allocations
+    //A window of 0 constants binds the whole buffer - any other window requires GraphicsDevice::SupportsConstantBufferOffsets()
+    static void BindConstantBufferRanges(PIPELINE_STAGE stage, UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers, const UINT* firstConstants, const UINT* numConstants);
+    static void BindInputLayout(ID3D11InputLayout* inputLayout);
+    static void BindPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology);
+
+
+    //----Shader Methods----//
+    static void BindVertexShader(ID3D11VertexShader* vertexShader);
+    static void BindPixelShader(ID3D11PixelShader* pixelShader);
+    static void BindComputeShader(ID3D11ComputeShader* computeShader);
+
+
+    //----Rasteriser Methods----//
+    static void BindViewport(const D3D11_VIEWPORT& viewport);
+
 
     //----Sampler Methods----//
-    static void BindSamplerStates(ID3D11SamplerState* samplerState, PIPELINE_STAGE stage, UINT startSlot, UINT numSamplerStates);
+    static void BindSamplerStates(ID3D11SamplerState* const* samplerStates, PIPELINE_STAGE stage, UINT startSlot, UINT numSamplerStates);
     [[nodiscard]] static ID3D11SamplerState* GetSamplerStates(PIPELINE_STAGE stage, UINT startSlot, UINT numSamplerStates);
 
+
+    //----Fixed Function State Methods----//
+    //nullptr binds the D3D11 default for each state - blendFactor defaults to all ones
+    static void BindBlendState(ID3D11BlendState* blendState, const FLOAT* blendFactor=nullptr, UINT sampleMask=0xFFFFFFFF);
+    static void BindDepthStencilState(ID3D11DepthStencilState* depthStencilState, UINT stencilRef=0);
+    static void BindRasterizerState(ID3D11RasterizerState* rasterizerState);
+
+
+    //----Draw Methods----//
+    //Flush any pending bindings and issue the draw
+    static void Draw(UINT vertexCount, UINT startVertexLocation=0);
+    static void DrawIndexed(UINT indexCount, UINT startIndexLocation=0, INT baseVertexLocation=0);
+    static void DrawInstanced(UINT vertexCountPerInstance, UINT instanceCount, UINT startVertexLocation=0, UINT startInstanceLocation=0);
+    static void DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount, UINT startIndexLocation=0, INT baseVertexLocation=0, UINT startInstanceLocation=0);
+    //The draw arguments are read from argsBuffer at byteOffset (a multiple of 4) when the GPU runs the draw - five UINTs
+    //(D3D11_DRAW_INDEXED_INSTANCED_INDIRECT_ARGS) for the indexed draw, four (D3D11_DRAW_INSTANCED_INDIRECT_ARGS) otherwise
+    static void DrawInstancedIndirect(ID3D11Buffer* argsBuffer, UINT byteOffset=0);
+    static void DrawIndexedInstancedIndirect(ID3D11Buffer* argsBuffer, UINT byteOffset=0);
+
+
+    //----Compute Methods----//
+    //Flush any pending bindings and issue the dispatch - the compute shader reads through the COMPUTE_SHADER stage's
+    //SRVs, constant buffers and samplers and writes through its UAVs
+    static void Dispatch(UINT threadGroupCountX, UINT threadGroupCountY=1, UINT threadGroupCountZ=1);
+    //The three thread group counts are read from argsBuffer at byteOffset (a multiple of 4) when the GPU runs the dispatch,
+    //so an earlier pass can size the work, e.g. through a UAV of a ResourceManager::CreateIndirectArgsBuffer() buffer
+    static void DispatchIndirect(ID3D11Buffer* argsBuffer, UINT byteOffset=0);
+    //Copy the hidden counter of an append/counter UAV into destinationBuffer at byteOffset (a multiple of 4), e.g. to
+    //turn the number of appended items into the instance count of an indirect draw - no bindings are flushed
+    static void CopyStructureCount(ID3D11Buffer* destinationBuffer, UINT byteOffset, ID3D11UnorderedAccessView* sourceView);
+
+
+    //----Binding Cache Methods----//
+    //Bind* calls only update a shadow copy of the pipeline state - FlushBindings() issues the difference to the context,
+    //coalescing contiguous dirty slots into a single call. It is called automatically once per frame by the RenderManager.
+    static void FlushBindings();
+    //Forget everything the cache believes is bound (e.g. after ClearState or when another context has touched the state)
+    static void InvalidateBindingCache();
+    //Counters for the last completed frame, including the work recorded on deferred contexts
+    [[nodiscard]] static PipelineStatistics GetFrameStatistics();
+
 private:
     static void Initialise();
     static void Shutdown();
+
+    static void EndFrame();
+
+    //Forget the bound render targets only, for when something other than the PipelineManager unbinds them (e.g. Present)
+    static void InvalidateOutputMergerBinding();
+
+    //State a deferred recording starts from, so draws recorded on workers land in the pass that launched them
+    struct InheritedState;
+    [[nodiscard]] static InheritedState CaptureInheritedState();
+    //Point the calling thread's binding cache at a deferred context, starting from the default state plus the inherited targets, viewport and fixed function states
+    //If the thread was already recording (e.g. the main thread running a job while it waits) its state is suspended until EndRecording()
+    static void BeginRecording(GraphicsContext* deferredContext, const InheritedState& inheritedState);
+    //Finish the calling thread's recording and resume whatever it was recording before - the returned command list is released by the caller once executed
+    [[nodiscard]] static ID3D11CommandList* EndRecording();
+
+
+    //Shadow state for one slot-array of the pipeline (e.g. the pixel shader SRV slots)
+    //bound holds what the context currently has, pending holds what the user last requested
+    template<typename T, UINT N>
+    struct BindingSlots
+    {
+        T bound[N]{};
+        T pending[N]{};
+        UINT dirtyMin{ N };
+        UINT dirtyMax{ 0 };
+    };
+
+    struct VertexBufferBinding
+    {
+        ID3D11Buffer* buffer;
+        UINT stride;
+        UINT offset;
+
+        bool operator==(const VertexBufferBinding& other) const { return buffer == other.buffer && stride == other.stride && offset == other.offset; }
+    };
+
+    struct ConstantBufferBinding
+    {
+        ID3D11Buffer* buffer;
+        UINT firstConstant;
+        UINT numConstants; //0 for the whole buffer
+
+        bool operator==(const ConstantBufferBinding& other) const { return buffer == other.buffer && firstConstant == other.firstConstant && numConstants == other.numConstants; }
+    };
+
+    struct IndexBufferBinding
+    {
+        ID3D11Buffer* buffer;
+        DXGI_FORMAT format;
+        UINT offset;
+
+        bool operator==(const IndexBufferBinding& other) const { return buffer == other.buffer && format == other.format && offset == other.offset; }
+    };
+
+    //Views keep the resource they were created on, looked up when they are bound, so hazard checks never have to touch a
+    //view that may have been released since
+    struct ShaderResourceViewBinding
+    {
+        ID3D11ShaderResourceView* view;
+        ID3D11Resource* resource;
+
+        bool operator==(const ShaderResourceViewBinding& other) const { return view == other.view; }
+    };
+
+    struct UnorderedAccessViewBinding
+    {
+        ID3D11UnorderedAccessView* view;
+        ID3D11Resource* resource;
+
+        bool operator==(const UnorderedAccessViewBinding& other) const { return view == other.view; }
+    };
+
+    struct ShaderBinding
+    {
+        ID3D11VertexShader* vertexShader;
+        ID3D11PixelShader* pixelShader;
+        ID3D11ComputeShader* computeShader;
+        ID3D11InputLayout* inputLayout;
+        D3D11_PRIMITIVE_TOPOLOGY primitiveTopology;
+    };
+
+    struct OutputMergerBinding
+    {
+        ID3D11RenderTargetView* renderTargetViews[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT];
+        ID3D11Resource* renderTargetViewResources[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT]; //As in ShaderResourceViewBinding, never compared
+        UINT numRenderTargetViews;
+        ID3D11DepthStencilView* depthStencilView;
+        ID3D11Resource* depthStencilViewResource;
+        ID3D11UnorderedAccessView* unorderedAccessViews[D3D11_PS_CS_UAV_REGISTER_COUNT];
+        ID3D11Resource* unorderedAccessViewResources[D3D11_PS_CS_UAV_REGISTER_COUNT]; //As in UnorderedAccessViewBinding, never compared
+    };
+
+    //Initialised to what the context has after ClearState
+    struct FixedFunctionBinding
+    {
+        ID3D11BlendState* blendState;
+        FLOAT blendFactor[4]{ 1.0f, 1.0f, 1.0f, 1.0f };
+        UINT sampleMask{ 0xFFFFFFFF };
+        ID3D11DepthStencilState* depthStencilState;
+        UINT stencilRef;
+        ID3D11RasterizerState* rasterizerState;
+    };
+
+    struct InheritedState
+    {
+        OutputMergerBinding outputMerger;
+        D3D11_VIEWPORT viewport;
+        FixedFunctionBinding fixedFunction;
+    };
+
+    //Context the calling thread records to
+    static thread_local GraphicsContext* context;
+
+    static thread_local BindingSlots<ShaderResourceViewBinding, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT> shaderResourceViews[PIPELINE_STAGE_COUNT];
+    static thread_local BindingSlots<ConstantBufferBinding, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT> constantBuffers[PIPELINE_STAGE_COUNT];
+    static thread_local BindingSlots<ID3D11SamplerState*, D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT> samplerStates[PIPELINE_STAGE_COUNT];
+    static thread_local BindingSlots<UnorderedAccessViewBinding, D3D11_PS_CS_UAV_REGISTER_COUNT> computeUnorderedAccessViews;
+    static thread_local UINT computeInitialCounts[D3D11_PS_CS_UAV_REGISTER_COUNT];
+    static thread_local UINT computeReissueMask; //Slots issued on the next flush even if unchanged, so their initial counts reach the context
+    static thread_local BindingSlots<VertexBufferBinding, D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT> vertexBuffers;
+
+    static thread_local IndexBufferBinding boundIndexBuffer;
+    static thread_local IndexBufferBinding pendingIndexBuffer;
+
+    static thread_local ShaderBinding boundShaders;
+    static thread_local ShaderBinding pendingShaders;
+
+    static thread_local D3D11_VIEWPORT boundViewport;
+    static thread_local D3D11_VIEWPORT pendingViewport;
+
+    static thread_local FixedFunctionBinding boundFixedFunction;
+    static thread_local FixedFunctionBinding pendingFixedFunction;
+
+    static thread_local OutputMergerBinding boundOutputMerger;
+    static thread_local OutputMergerBinding pendingOutputMerger;
+    static thread_local UINT pixelInitialCounts[D3D11_PS_CS_UAV_REGISTER_COUNT];
+    static thread_local bool outputMergerDirty;
+
+    static thread_local PipelineStatistics frameStatistics;
+    static PipelineStatistics lastFrameStatistics;
+    static PipelineStatistics recordedStatistics; //Accumulated from finished deferred recordings until EndFrame()
+    static std::mutex recordedStatisticsMutex;
+
+    //Everything BeginRecording() replaces on a thread that already has a context
+    struct SuspendedState
+    {
+        GraphicsContext* context;
+        BindingSlots<ShaderResourceViewBinding, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT> shaderResourceViews[PIPELINE_STAGE_COUNT];
+        BindingSlots<ConstantBufferBinding, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT> constantBuffers[PIPELINE_STAGE_COUNT];
+        BindingSlots<ID3D11SamplerState*, D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT> samplerStates[PIPELINE_STAGE_COUNT];
+        BindingSlots<UnorderedAccessViewBinding, D3D11_PS_CS_UAV_REGISTER_COUNT> computeUnorderedAccessViews;
+        UINT computeInitialCounts[D3D11_PS_CS_UAV_REGISTER_COUNT];
+        UINT computeReissueMask;
+        BindingSlots<VertexBufferBinding, D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT> vertexBuffers;
+        IndexBufferBinding boundIndexBuffer;
+        IndexBufferBinding pendingIndexBuffer;
+        ShaderBinding boundShaders;
+        ShaderBinding pendingShaders;
+        D3D11_VIEWPORT boundViewport;
+        D3D11_VIEWPORT pendingViewport;
+        FixedFunctionBinding boundFixedFunction;
+        FixedFunctionBinding pendingFixedFunction;
+        OutputMergerBinding boundOutputMerger;
+        OutputMergerBinding pendingOutputMerger;
+        UINT pixelInitialCounts[D3D11_PS_CS_UAV_REGISTER_COUNT];
+        bool outputMergerDirty;
+        PipelineStatistics frameStatistics;
+    };
+    static thread_local std::vector<SuspendedState> suspendedStates;
+
+
+    //Utility functions
+    static void ResetBindingState();
+    static void SuspendBindingState(SuspendedState& state);
+    static void ResumeBindingState(const SuspendedState& state);
+    template<typename T, UINT N> static bool StageSlots(BindingSlots<T, N>& slots, UINT startSlot, UINT numSlots, const T* values, const char* caller);
+    //Slots set in reissueMask (one bit per slot, so only for N <= 32) are issued even if they match what is bound
+    template<typename T, UINT N, typename IssueFunction> static UINT FlushSlots(BindingSlots<T, N>& slots, IssueFunction issue, UINT reissueMask=0);
+    [[nodiscard]] static bool HasPendingUnorderedAccessViews();
+    static void UnbindResourceShaderResourceViews(ID3D11Resource* resource);
+    static void UnbindResourceUnorderedAccessViews(ID3D11Resource* resource, bool pixelSlots, bool computeSlots);
+    static void UnbindResourceTargetViews(ID3D11Resource* resource);
+    [[nodiscard]] static bool OutputMergerEqual(const OutputMergerBinding& a, const OutputMergerBinding& b);
+    [[nodiscard]] static bool ViewportEqual(const D3D11_VIEWPORT& a, const D3D11_VIEWPORT& b);
 };
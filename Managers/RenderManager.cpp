@@ -1,32 +1,336 @@
 ﻿#include "RenderManager.h"
 
+#include <algorithm>
 #include <iostream>
 
+#include "DeviceManager.h"
 #include "EngineManager.h"
+#include "JobManager.h"
 #include "PipelineManager.h"
+#include "UploadManager.h"
 #include "WindowManager.h"
+#include "../Utility/CpuProfiler.h"
 
-void RenderManager::Initialise()
+DrawQueue RenderManager::drawQueue{};
+FrameGraph RenderManager::frameGraph{};
+FrameGraphBuildFunction RenderManager::frameGraphBuild{};
+GpuProfiler RenderManager::gpuProfiler{};
+GpuScene RenderManager::gpuScene{};
+GpuCullDescription RenderManager::gpuCullView{};
+TextureStreamer RenderManager::textureStreamer{};
+ReadbackQueue RenderManager::readbackQueue{};
+
+Texture2DHandle RenderManager::backBufferTexture{};
+RenderTargetViewHandle RenderManager::backBufferRenderTargetView{};
+float* RenderManager::clearColour{};
+UINT RenderManager::recordingJobs{};
+std::vector<ID3D11CommandList*> RenderManager::commandLists{};
+
+void RenderManager::Initialise(const RenderDescription& rd)
 {
+    recordingJobs = rd.recordingJobs;
+    gpuScene.Initialise(DeviceManager::context, rd.gpuCullingShader);
+    textureStreamer.Initialise(DeviceManager::context, rd.textureStreamingBudget);
+    if (!readbackQueue.Initialise(DeviceManager::device, DeviceManager::context, rd.readbackLatency))
+    {
+        std::cerr << "ERROR::RENDER_MANAGER::INITIALISE::FAILED_TO_INITIALISE_READBACK_QUEUE" << std::endl;
+    }
+
+    if (rd.gpuProfiling)
+    {
+        if (gpuProfiler.Initialise(DeviceManager::device, DeviceManager::context)) { frameGraph.SetProfiler(&gpuProfiler); }
+        else { std::cerr << "ERROR::RENDER_MANAGER::INITIALISE::FAILED_TO_INITIALISE_GPU_PROFILER" << std::endl; }
+    }
+
+    backBufferTexture = ResourceManager::GetActiveSwapchainTexture();
+    backBufferRenderTargetView = ResourceManager::CreateRenderTargetView(backBufferTexture);
+    if (backBufferRenderTargetView.IsNull())
+    {
+        std::cerr << "ERROR::RENDER_MANAGER::INITIALISE::FAILED_TO_CREATE_BACK_BUFFER_RENDER_TARGET_VIEW" << std::endl;
+    }
+
+    BuildFrameGraph(BuildDefaultFrameGraph);
 }
 
 void RenderManager::Shutdown()
 {
+    drawQueue.Clear();
+    gpuScene.Reset();
+    gpuCullView = {};
+    textureStreamer.Reset();
+    readbackQueue.Shutdown();
+    frameGraph.ReleaseTransientTextures();
+    frameGraph.Reset();
+    frameGraphBuild = nullptr;
+    frameGraph.SetProfiler(nullptr);
+    gpuProfiler.Shutdown();
+    ResourceManager::Release(backBufferRenderTargetView);
+    ResourceManager::Release(backBufferTexture);
+    backBufferRenderTargetView = {};
+    backBufferTexture = {};
+}
+
+
+
+void RenderManager::SubmitDraw(const DrawItem& item)
+{
+    drawQueue.Submit(item);
 }
 
+void RenderManager::ExecuteDraws(UINT firstPass, UINT lastPass)
+{
+    PROFILE_FUNCTION();
+    drawQueue.ExecutePasses(firstPass, lastPass);
+}
 
+void RenderManager::ExecuteDrawsParallel(UINT jobCount, UINT firstPass, UINT lastPass)
+{
+    PROFILE_FUNCTION();
+    size_t begin;
+    size_t end;
+    drawQueue.FindPasses(firstPass, lastPass, begin, end);
+    const size_t count{ end - begin };
+    jobCount = static_cast<UINT>((std::min)(static_cast<size_t>(jobCount), count));
+    if (jobCount <= 1)
+    {
+        drawQueue.ExecuteRange(begin, end);
+        return;
+    }
 
-void RenderManager::Render(float* clearColour)
+    //Contiguous chunks keep each job's items in sort order, so executing the lists in job order reproduces the serial order
+    RecordParallel(jobCount, [begin, count, jobCount](UINT job)
+    {
+        drawQueue.ExecuteRange(begin + count * job / jobCount, begin + count * (job + 1) / jobCount);
+    });
+}
+
+void RenderManager::RecordParallel(UINT jobCount, const RecordFunction& record)
 {
-    ID3D11RenderTargetView* rtv{ PipelineManager::GetCurrentRenderTargetViews()[0] };
-    ID3D11DepthStencilView* dsv{ PipelineManager::GetCurrentDepthStencilView() };
-    PipelineManager::ClearRenderTargetView(rtv, clearColour);
-    PipelineManager::ClearDepthStencilView(dsv, 0, 0);
+    PROFILE_FUNCTION();
+    if (jobCount == 0) { return; }
 
-    HRESULT hr{ WindowManager::swapChain->Present(0, NULL) };
+    for (UINT i{ 0 }; i < jobCount; ++i)
+    {
+        if (!DeviceManager::GetDeferredContext(i))
+        {
+            std::cerr << "ERROR::RENDER_MANAGER::RECORD_PARALLEL::DEFERRED_CONTEXT_UNAVAILABLE" << std::endl;
+            return;
+        }
+    }
+
+    const PipelineManager::InheritedState inheritedState{ PipelineManager::CaptureInheritedState() };
+    commandLists.assign(jobCount, nullptr);
+
+    //Contexts belong to jobs rather than threads, so it doesn't matter which thread (the main thread included, while it waits) runs each job
+    JobCounter counter;
+    for (UINT i{ 0 }; i < jobCount; ++i)
+    {
+        JobManager::Schedule([i, &record, &inheritedState]()
+        {
+            PipelineManager::BeginRecording(DeviceManager::deferredContexts[i], inheritedState);
+            record(i);
+            commandLists[i] = PipelineManager::EndRecording();
+        }, &counter);
+    }
+    JobManager::Wait(counter);
+
+    for (ID3D11CommandList* commandList : commandLists)
+    {
+        if (!commandList) { continue; }
+        DeviceManager::context->ExecuteCommandList(commandList);
+        DeviceManager::device->ReleaseObject(commandList);
+    }
+    commandLists.clear();
+
+    //Executing a command list leaves the immediate context in its default state
+    PipelineManager::InvalidateBindingCache();
+}
+
+void RenderManager::BuildFrameGraph(const FrameGraphBuildFunction& build)
+{
+    frameGraphBuild = build;
+    frameGraph.Reset();
+    frameGraph.SetReferenceSize(WindowManager::width, WindowManager::height);
+
+    FrameGraphImportedTexture backBuffer{};
+    backBuffer.texture = ResourceManager::Get(backBufferTexture);
+    backBuffer.width = WindowManager::width;
+    backBuffer.height = WindowManager::height;
+    backBuffer.renderTargetView = ResourceManager::Get(backBufferRenderTargetView);
+    build(frameGraph, frameGraph.ImportTexture("BackBuffer", backBuffer));
+
+    frameGraph.Compile();
+}
+
+FrameGraphStatistics RenderManager::GetFrameGraphStatistics()
+{
+    return frameGraph.GetStatistics();
+}
+
+std::vector<GpuScopeStatistics> RenderManager::GetGpuStatistics()
+{
+    return gpuProfiler.GetStatistics();
+}
+
+GpuProfilerCounters RenderManager::GetGpuProfilerCounters()
+{
+    return gpuProfiler.GetCounters();
+}
+
+UINT RenderManager::BeginGpuScope(const char* name)
+{
+    return gpuProfiler.BeginScope(name);
+}
+
+void RenderManager::EndGpuScope(UINT scope)
+{
+    gpuProfiler.EndScope(scope);
+}
+
+UINT RenderManager::CreateGpuBatch(const GpuBatchDescription& description)
+{
+    return gpuScene.AddBatch(description);
+}
+
+void RenderManager::SetGpuBatchInstances(UINT batch, const GpuInstance* instances, UINT count)
+{
+    gpuScene.SetInstances(batch, instances, count);
+}
+
+void RenderManager::SetGpuCullView(const GpuCullDescription& description)
+{
+    gpuCullView = description;
+}
+
+void RenderManager::ExecuteGpuBatches()
+{
+    PROFILE_FUNCTION();
+    gpuScene.Draw();
+}
+
+GpuSceneStatistics RenderManager::GetGpuSceneStatistics()
+{
+    return gpuScene.GetStatistics();
+}
+
+UINT RenderManager::LoadStreamedTexture(const char* path)
+{
+    return textureStreamer.Load(path);
+}
+
+void RenderManager::ReleaseStreamedTexture(UINT texture)
+{
+    textureStreamer.Release(texture);
+}
+
+void RenderManager::RequestStreamedTextureMip(UINT texture, UINT mip)
+{
+    textureStreamer.Request(texture, mip);
+}
+
+ID3D11ShaderResourceView* RenderManager::GetStreamedTextureView(UINT texture)
+{
+    return textureStreamer.GetView(texture);
+}
+
+TextureStreamerStatistics RenderManager::GetTextureStreamerStatistics()
+{
+    return textureStreamer.GetStatistics();
+}
+
+bool RenderManager::ReadbackBuffer(BufferHandle buffer, UINT offset, UINT size, const ReadbackCallback& callback)
+{
+    return readbackQueue.ReadBuffer(ResourceManager::Get(buffer), offset, size, callback);
+}
+
+bool RenderManager::ReadbackTexture2D(Texture2DHandle texture, UINT subresource, UINT x, UINT y, UINT width, UINT height, const ReadbackCallback& callback)
+{
+    return readbackQueue.ReadTexture2D(ResourceManager::Get(texture), subresource, x, y, width, height, callback);
+}
+
+ReadbackQueueStatistics RenderManager::GetReadbackStatistics()
+{
+    return readbackQueue.GetStatistics();
+}
+
+
+
+void RenderManager::Render(float* _clearColour)
+{
+    PROFILE_FUNCTION();
+    clearColour = _clearColour;
+
+    gpuProfiler.BeginFrame();
+    textureStreamer.Update();
+    readbackQueue.Update();
+    if (!gpuScene.IsEmpty())
+    {
+        const UINT scope{ gpuProfiler.BeginScope("GpuCulling") };
+        gpuScene.Cull(gpuCullView);
+        gpuProfiler.EndScope(scope);
+    }
+    drawQueue.Sort();
+    frameGraph.Execute();
+    drawQueue.Clear();
+    readbackQueue.EndFrame();
+    gpuProfiler.EndFrame();
+
+    HRESULT hr{ WindowManager::swapChain->Present(WindowManager::GetPresentSyncInterval(), WindowManager::GetPresentFlags()) };
+    //Flip model presents unbind the back buffer from the output merger behind the binding cache's back
+    PipelineManager::InvalidateOutputMergerBinding();
+    PipelineManager::EndFrame();
+    UploadManager::EndFrame();
     if (FAILED(hr))
     {
         std::cerr << "ERROR::RENDER_MANAGER::RENDER::FAILED_TO_PRESENT_SWAP_CHAIN" << std::endl;
         return;
     }
 }
+
+void RenderManager::ReleaseSwapChainViews()
+{
+    //Unbind the back buffer before dropping the handles, so the context doesn't keep it alive
+    PipelineManager::BindRenderTargetViews({});
+    PipelineManager::BindDepthStencilView(nullptr);
+    PipelineManager::FlushBindings();
+
+    ResourceManager::Release(backBufferRenderTargetView);
+    ResourceManager::Release(backBufferTexture);
+    backBufferRenderTargetView = {};
+    backBufferTexture = {};
+}
+
+void RenderManager::CreateSwapChainViews()
+{
+    backBufferTexture = ResourceManager::GetActiveSwapchainTexture();
+    backBufferRenderTargetView = ResourceManager::CreateRenderTargetView(backBufferTexture);
+    if (backBufferRenderTargetView.IsNull())
+    {
+        std::cerr << "ERROR::RENDER_MANAGER::CREATE_SWAP_CHAIN_VIEWS::FAILED_TO_CREATE_BACK_BUFFER_RENDER_TARGET_VIEW" << std::endl;
+    }
+
+    //The imported back buffer and every back buffer sized transient texture change with the swapchain
+    if (frameGraphBuild)
+    {
+        BuildFrameGraph(FrameGraphBuildFunction{ frameGraphBuild });
+    }
+}
+
+void RenderManager::BuildDefaultFrameGraph(FrameGraph& graph, FrameGraphResource backBuffer)
+{
+    graph.AddPass("Scene",
+        [backBuffer](FrameGraphBuilder& builder)
+        {
+            const FrameGraphResource depth{ builder.CreateTexture("SceneDepth", FrameGraphTextureDescription{ 0, 0, DXGI_FORMAT_D32_FLOAT, {}, 1.0f, 0 }) };
+            builder.WriteRenderTarget(backBuffer);
+            builder.WriteDepthStencil(depth, true);
+        },
+        [backBuffer](const FrameGraphPassResources& resources)
+        {
+            //The clear colour may change from frame to frame, so the back buffer is cleared here rather than by the graph
+            PipelineManager::ClearRenderTargetView(resources.GetRenderTargetView(backBuffer), clearColour);
+            if (recordingJobs > 1) { ExecuteDrawsParallel(recordingJobs); }
+            else                   { ExecuteDraws(); }
+            ExecuteGpuBatches();
+        });
+}
\ No newline at end of file
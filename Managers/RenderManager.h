@@ -1,16 +1,118 @@
 ﻿#pragma once
 #include <d3d11.h>
+#include <functional>
 #include <vector>
 
+#include "ResourceManager.h"
+#include "../Rendering/DrawQueue.h"
+#include "../Rendering/FrameGraph.h"
+#include "../Rendering/GpuProfiler.h"
+#include "../Rendering/GpuScene.h"
+#include "../Rendering/ReadbackQueue.h"
+#include "../Rendering/TextureStreamer.h"
+
+//Records one job's share of the work - called on a JobManager thread, where PipelineManager calls record to that job's deferred context
+using RecordFunction = std::function<void(UINT job)>;
+
+//Builds the passes of the frame graph - backBuffer is the imported swapchain texture the final pass should write to
+using FrameGraphBuildFunction = std::function<void(FrameGraph& graph, FrameGraphResource backBuffer)>;
+
+struct RenderDescription
+{
+    float* clearColour;
+    UINT recordingJobs;            //Worker threads the default scene pass records its draws on - 0 or 1 records them on the main thread
+    bool gpuProfiling;             //Time the frame and each frame graph pass on the GPU (see RenderManager::GetGpuStatistics())
+    const char* gpuCullingShader;  //HLSL source culling GPU-driven batches (see RenderManager::CreateGpuBatch()) - nullptr selects GPU_SCENE_DEFAULT_CULLING_SHADER
+    UINT64 textureStreamingBudget; //Bytes streamed textures may allocate (see RenderManager::LoadStreamedTexture()) - 0 selects TEXTURE_STREAMER_DEFAULT_BUDGET
+    UINT readbackLatency;          //Frames of readbacks that may wait on the GPU at once (see RenderManager::ReadbackBuffer()) - 0 selects READBACK_QUEUE_DEFAULT_FRAME_LATENCY
+};
+
 class RenderManager
 {
     friend class EngineManager;
+    friend class WindowManager;
+
+public:
+    //Queue a draw for the current frame - items are sorted by DrawItem::sortKey before being issued (see DrawQueue.h)
+    //Items with DrawItem::instanceData that share a mesh and material are merged into instanced draws
+    static void SubmitDraw(const DrawItem& item);
+    //Issue this frame's queued draws whose sort key pass lies in [firstPass, lastPass] - called from inside frame graph passes
+    static void ExecuteDraws(UINT firstPass=0, UINT lastPass=0xFF);
+    //As ExecuteDraws(), but the draws are split into jobCount contiguous chunks recorded in parallel
+    static void ExecuteDrawsParallel(UINT jobCount, UINT firstPass=0, UINT lastPass=0xFF);
+
+    //Run record for each job in [0, jobCount) as a JobManager job with its own deferred context, then execute the resulting
+    //command lists on the immediate context in job order, so the output is the same however the jobs were scheduled
+    //Each job starts with the caller's render targets, viewport and fixed function states bound, and nothing else
+    //Must be called from the main thread - jobs may only use the PipelineManager and read-only data (UploadManager is main thread only)
+    static void RecordParallel(UINT jobCount, const RecordFunction& record);
+
+    //Replace the frame graph
+    //The default graph is a single "Scene" pass drawing every queued item into the back buffer, with a transient depth buffer
+    static void BuildFrameGraph(const FrameGraphBuildFunction& build);
+    [[nodiscard]] static FrameGraphStatistics GetFrameGraphStatistics();
+
+    //GPU time of the whole frame ("Frame") and of each frame graph pass (named after the pass), over the last few seconds of frames
+    //Empty unless RenderDescription::gpuProfiling was set - timings lag a few frames behind, as they are read back without stalling
+    [[nodiscard]] static std::vector<GpuScopeStatistics> GetGpuStatistics();
+    [[nodiscard]] static GpuProfilerCounters GetGpuProfilerCounters();
+    //Time work of your own, e.g. inside a pass - main thread only
+    [[nodiscard]] static UINT BeginGpuScope(const char* name);
+    static void EndGpuScope(UINT scope);
+
+    //GPU-driven batches (see GpuScene.h) - culled on the GPU at the start of every frame, then drawn by the default "Scene" pass after the queued draws
+    //Returns GPU_SCENE_INVALID_BATCH on failure
+    [[nodiscard]] static UINT CreateGpuBatch(const GpuBatchDescription& description);
+    static void SetGpuBatchInstances(UINT batch, const GpuInstance* instances, UINT count);
+    //View the batches are culled against from the next frame on - until one is set nothing is culled
+    static void SetGpuCullView(const GpuCullDescription& description);
+    //Issue the batches' indirect draws - for passes of your own frame graph
+    static void ExecuteGpuBatches();
+    [[nodiscard]] static GpuSceneStatistics GetGpuSceneStatistics();
+
+    //Streamed DDS textures (see TextureStreamer.h) - mips are streamed in and out at the start of every frame, under RenderDescription::textureStreamingBudget
+    //Returns TEXTURE_STREAMER_INVALID_TEXTURE on failure
+    [[nodiscard]] static UINT LoadStreamedTexture(const char* path);
+    static void ReleaseStreamedTexture(UINT texture);
+    //Finest mip to stream in - 0 (the default) streams in every mip
+    static void RequestStreamedTextureMip(UINT texture, UINT mip);
+    //Changes as mips are streamed in and out, so fetch it every frame the texture is used
+    [[nodiscard]] static ID3D11ShaderResourceView* GetStreamedTextureView(UINT texture);
+    [[nodiscard]] static TextureStreamerStatistics GetTextureStreamerStatistics();
+
+    //GPU to CPU readback (see ReadbackQueue.h) - the copy is made now, and the callback called at the start of a later frame, once the GPU
+    //has finished it, without stalling. Returns false if the request was dropped, e.g. while RenderDescription::readbackLatency frames are in flight
+    static bool ReadbackBuffer(BufferHandle buffer, UINT offset, UINT size, const ReadbackCallback& callback);
+    //The data is in the texture's own format
+    static bool ReadbackTexture2D(Texture2DHandle texture, UINT subresource, UINT x, UINT y, UINT width, UINT height, const ReadbackCallback& callback);
+    [[nodiscard]] static ReadbackQueueStatistics GetReadbackStatistics();
     
 private:
     RenderManager() = default;
-    static void Initialise();
+    static void Initialise(const RenderDescription& rd);
     static void Shutdown();
     ~RenderManager() = default;
 
     static void Render(float* clearColour);
+
+    //Around a swapchain resize - every reference to the back buffer has to be dropped before its buffers can be resized
+    static void ReleaseSwapChainViews();
+    static void CreateSwapChainViews();
+
+    static void BuildDefaultFrameGraph(FrameGraph& graph, FrameGraphResource backBuffer);
+
+    static DrawQueue drawQueue;
+    static FrameGraph frameGraph;
+    static FrameGraphBuildFunction frameGraphBuild; //Kept to rebuild the graph when the swapchain is resized
+    static GpuProfiler gpuProfiler;
+    static GpuScene gpuScene;
+    static GpuCullDescription gpuCullView;
+    static TextureStreamer textureStreamer;
+    static ReadbackQueue readbackQueue;
+
+    static Texture2DHandle backBufferTexture;
+    static RenderTargetViewHandle backBufferRenderTargetView;
+    static float* clearColour;
+    static UINT recordingJobs;
+    static std::vector<ID3D11CommandList*> commandLists; //Scratch for RecordParallel()
 };
\ No newline at end of file
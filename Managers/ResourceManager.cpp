@@ -1,52 +1,295 @@
 ﻿#include "ResourceManager.h"
 
+#include <cstring>
 #include <iostream>
 
 #include "DeviceManager.h"
 #include "EngineManager.h"
 #include "WindowManager.h"
+#include "../Utility/CpuProfiler.h"
+#include "../Utility/MappedFile.h"
 
 
-std::vector<ID3D11Resource*> ResourceManager::resources{};
-std::vector<ID3D11View*> ResourceManager::resourceViews{};
+HandlePool<ID3D11Resource> ResourceManager::resources{};
+HandlePool<ID3D11View> ResourceManager::resourceViews{};
+HandlePool<ID3D11DeviceChild> ResourceManager::states{};
 
+ResourcePool ResourceManager::pool{};
+std::unordered_map<ID3D11Resource*, ResourceManager::RecyclableResource> ResourceManager::recyclableResources{};
+ViewCache ResourceManager::viewCache{};
+StateCache ResourceManager::stateCache{};
 
-void ResourceManager::Initialise()
+
+void ResourceManager::Initialise(const ResourceDescription& rd)
 {
+    pool.Initialise(DeviceManager::device, (rd.poolBudget) ? (rd.poolBudget) : (RESOURCE_POOL_DEFAULT_BUDGET));
 }
 
 void ResourceManager::Shutdown()
 {
-    for (ID3D11Resource* r : resources)
+    pool.Shutdown();
+    viewCache.Clear();
+    stateCache.Clear();
+    //Views hold a reference to their resource, so release them first
+    resourceViews.ForEach([](ID3D11View* v) { DeviceManager::device->ReleaseObject(v); });
+    resources.ForEach([](ID3D11Resource* r) { DeviceManager::device->ReleaseObject(r); });
+    //Released resources that were still waiting on their views no longer have a handle
+    for (const auto& recyclable : recyclableResources)
     {
-        r->Release();
+        if (recyclable.second.released) { DeviceManager::device->ReleaseObject(recyclable.first); }
     }
-    for (ID3D11View* v : resourceViews)
+    recyclableResources.clear();
+    states.ForEach([](ID3D11DeviceChild* s) { DeviceManager::device->ReleaseObject(s); });
+    resourceViews.Clear();
+    resources.Clear();
+    states.Clear();
+}
+
+
+
+void ResourceManager::ReleaseObject(IUnknown* object)
+{
+    PROFILE_ZONE("ResourceManager::Release");
+    if (!object)
     {
-        v->Release();
+        std::cerr << "ERROR::RESOURCE_MANAGER::RELEASE::STALE_HANDLE" << std::endl;
+        return;
     }
-    for (ID3D11SamplerState* s : samplerStates)
+    DeviceManager::device->ReleaseObject(object);
+}
+
+void ResourceManager::ReleaseObject(ID3D11Resource* resource)
+{
+    PROFILE_ZONE("ResourceManager::Release");
+    if (!resource)
     {
-        s->Release();
+        std::cerr << "ERROR::RESOURCE_MANAGER::RELEASE::STALE_HANDLE" << std::endl;
+        return;
     }
+
+    const auto recyclable{ recyclableResources.find(resource) };
+    if (recyclable == recyclableResources.end())
+    {
+        DeviceManager::device->ReleaseObject(resource);
+        return;
+    }
+
+    //A live view would see the resource handed out again, so it waits in recyclableResources for the last one
+    if (recyclable->second.views > 0)
+    {
+        recyclable->second.released = true;
+        return;
+    }
+    pool.Add(recyclable->second.key, resource);
+    recyclableResources.erase(recyclable);
+}
+
+void ResourceManager::ReleaseObject(ID3D11View* view)
+{
+    PROFILE_ZONE("ResourceManager::Release");
+    if (!view)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::RELEASE::STALE_HANDLE" << std::endl;
+        return;
+    }
+
+    ID3D11Resource* const resource{ DeviceManager::device->GetViewResource(view) };
+    DeviceManager::device->ReleaseObject(view);
+
+    const auto recyclable{ recyclableResources.find(resource) };
+    if (recyclable == recyclableResources.end()) { return; }
+    if (--recyclable->second.views == 0 && recyclable->second.released)
+    {
+        pool.Add(recyclable->second.key, resource);
+        recyclableResources.erase(recyclable);
+    }
+}
+
+void ResourceManager::SetPoolBudget(UINT64 budget)
+{
+    PROFILE_FUNCTION();
+    pool.SetBudget(budget);
+}
+
+void ResourceManager::TrimPool()
+{
+    PROFILE_FUNCTION();
+    pool.Trim(0);
+}
+
+ResourcePoolStatistics ResourceManager::GetPoolStatistics()
+{
+    return pool.GetStatistics();
+}
+
+ObjectCacheStatistics ResourceManager::GetViewCacheStatistics()
+{
+    return viewCache.GetStatistics();
+}
+
+ObjectCacheStatistics ResourceManager::GetStateCacheStatistics()
+{
+    return stateCache.GetStatistics();
+}
+
+//Device creation by description type, so CreatePooledResource() is written once
+static HRESULT CreateDeviceResource(GraphicsDevice* device, const D3D11_BUFFER_DESC& desc, D3D11_SUBRESOURCE_DATA* pData, ID3D11Buffer** ppResource)
+{
+    return device->CreateBuffer(&desc, pData, ppResource);
+}
+
+static HRESULT CreateDeviceResource(GraphicsDevice* device, const D3D11_TEXTURE1D_DESC& desc, D3D11_SUBRESOURCE_DATA* pData, ID3D11Texture1D** ppResource)
+{
+    return device->CreateTexture1D(&desc, pData, ppResource);
+}
+
+static HRESULT CreateDeviceResource(GraphicsDevice* device, const D3D11_TEXTURE2D_DESC& desc, D3D11_SUBRESOURCE_DATA* pData, ID3D11Texture2D** ppResource)
+{
+    return device->CreateTexture2D(&desc, pData, ppResource);
+}
+
+static HRESULT CreateDeviceResource(GraphicsDevice* device, const D3D11_TEXTURE3D_DESC& desc, D3D11_SUBRESOURCE_DATA* pData, ID3D11Texture3D** ppResource)
+{
+    return device->CreateTexture3D(&desc, pData, ppResource);
+}
+
+template<typename Desc, typename T>
+HRESULT ResourceManager::CreatePooledResource(const Desc& desc, D3D11_SUBRESOURCE_DATA* pData, T** ppResource)
+{
+    //Pooled resources come back with undefined contents, so resources created with initial data (which immutable ones always are) never qualify
+    if (pData || desc.Usage == D3D11_USAGE_IMMUTABLE)
+    {
+        return CreateDeviceResource(DeviceManager::device, desc, pData, ppResource);
+    }
+
+    const ResourcePoolKey key{ ResourcePoolKey::Make(desc) };
+    if (ID3D11Resource* pooled{ pool.Acquire(key) })
+    {
+        *ppResource = static_cast<T*>(pooled);
+        recyclableResources.emplace(pooled, RecyclableResource{ key, 0, false });
+        return S_OK;
+    }
+
+    HRESULT hr{ CreateDeviceResource(DeviceManager::device, desc, pData, ppResource) };
+    if (SUCCEEDED(hr))
+    {
+        recyclableResources.emplace(*ppResource, RecyclableResource{ key, 0, false });
+    }
+    return hr;
+}
+
+template<typename T>
+Handle<T> ResourceManager::AllocateResource(T* resource)
+{
+    const Handle<T> handle{ resources.Allocate(resource) };
+    if (handle.IsNull())
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::ALLOCATE_RESOURCE::NO_FREE_HANDLES" << std::endl;
+        ReleaseObject(static_cast<ID3D11Resource*>(resource));
+    }
+    return handle;
+}
+
+//Device view creation by view type, so CreateView() is written once
+static HRESULT CreateDeviceView(GraphicsDevice* device, ID3D11Resource* resource, const D3D11_SHADER_RESOURCE_VIEW_DESC* pDesc, ID3D11ShaderResourceView** ppView)
+{
+    return device->CreateShaderResourceView(resource, pDesc, ppView);
+}
+
+static HRESULT CreateDeviceView(GraphicsDevice* device, ID3D11Resource* resource, const D3D11_UNORDERED_ACCESS_VIEW_DESC* pDesc, ID3D11UnorderedAccessView** ppView)
+{
+    return device->CreateUnorderedAccessView(resource, pDesc, ppView);
 }
 
+static HRESULT CreateDeviceView(GraphicsDevice* device, ID3D11Resource* resource, const D3D11_RENDER_TARGET_VIEW_DESC* pDesc, ID3D11RenderTargetView** ppView)
+{
+    return device->CreateRenderTargetView(resource, pDesc, ppView);
+}
+
+static HRESULT CreateDeviceView(GraphicsDevice* device, ID3D11Resource* resource, const D3D11_DEPTH_STENCIL_VIEW_DESC* pDesc, ID3D11DepthStencilView** ppView)
+{
+    return device->CreateDepthStencilView(resource, pDesc, ppView);
+}
 
+template<typename T>
+Handle<T> ResourceManager::CreateView(ID3D11Resource* resource, const typename ViewDescription<T>::Type* pDesc)
+{
+    const ViewCacheKey key{ ViewCacheKey::Make(resource, pDesc) };
+    const Handle<ID3D11View> cached{ viewCache.Acquire(key) };
+    if (!cached.IsNull()) { return HandleCast<T>(cached); }
+
+    T* view{};
+    if (FAILED(CreateDeviceView(DeviceManager::device, resource, pDesc, &view))) { return {}; }
+    const Handle<T> handle{ resourceViews.Allocate(view) };
+    //No handle owns the view, so it mustn't count against the resource going back to the pool either
+    if (handle.IsNull())
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_VIEW::NO_FREE_HANDLES" << std::endl;
+        DeviceManager::device->ReleaseObject(view);
+        return {};
+    }
+    viewCache.Add(key, HandleCast<ID3D11View>(handle), view);
+    const auto recyclable{ recyclableResources.find(resource) };
+    if (recyclable != recyclableResources.end()) { ++recyclable->second.views; }
+    return handle;
+}
 
-ID3D11Texture2D* ResourceManager::GetActiveSwapchainTexture()
+//Device state creation by description type, so CreateState() is written once
+static HRESULT CreateDeviceState(GraphicsDevice* device, const D3D11_SAMPLER_DESC& desc, ID3D11SamplerState** ppState)
 {
+    return device->CreateSamplerState(&desc, ppState);
+}
+
+static HRESULT CreateDeviceState(GraphicsDevice* device, const D3D11_BLEND_DESC& desc, ID3D11BlendState** ppState)
+{
+    return device->CreateBlendState(&desc, ppState);
+}
+
+static HRESULT CreateDeviceState(GraphicsDevice* device, const D3D11_RASTERIZER_DESC& desc, ID3D11RasterizerState** ppState)
+{
+    return device->CreateRasterizerState(&desc, ppState);
+}
+
+static HRESULT CreateDeviceState(GraphicsDevice* device, const D3D11_DEPTH_STENCIL_DESC& desc, ID3D11DepthStencilState** ppState)
+{
+    return device->CreateDepthStencilState(&desc, ppState);
+}
+
+template<typename T, typename Desc>
+Handle<T> ResourceManager::CreateState(const Desc& desc)
+{
+    const StateCacheKey key{ StateCacheKey::Make(desc) };
+    const Handle<ID3D11DeviceChild> cached{ stateCache.Acquire(key) };
+    if (!cached.IsNull()) { return HandleCast<T>(cached); }
+
+    T* state{};
+    if (FAILED(CreateDeviceState(DeviceManager::device, desc, &state))) { return {}; }
+    const Handle<T> handle{ states.Allocate(state) };
+    if (handle.IsNull())
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_STATE::NO_FREE_HANDLES" << std::endl;
+        DeviceManager::device->ReleaseObject(state);
+        return {};
+    }
+    stateCache.Add(key, HandleCast<ID3D11DeviceChild>(handle), state);
+    return handle;
+}
+
+Texture2DHandle ResourceManager::GetActiveSwapchainTexture()
+{
+    PROFILE_FUNCTION();
     ID3D11Texture2D* swapChainTexture{};
-    HRESULT hr{ WindowManager::swapChain->GetBuffer(0, IID_PPV_ARGS(&swapChainTexture)) };
+    HRESULT hr{ WindowManager::swapChain->GetBuffer(0, &swapChainTexture) };
     if (FAILED(hr)) {
         std::cerr << "ERROR::RESOURCE_MANAGER::GET_ACTIVE_SWAPCHAIN_TEXTURE::FAILED_TO_GET_ACTIVE_SWAP_CHAIN_TEXTURE" << std::endl;
-        return nullptr;
+        return {};
     }
-    resources.push_back(swapChainTexture);
-    return swapChainTexture;
+    return AllocateResource(swapChainTexture);
 }
 
-ID3D11Texture2D* ResourceManager::CreateDepthStencilTexture()
+Texture2DHandle ResourceManager::CreateDepthStencilTexture()
 {
+    PROFILE_FUNCTION();
     D3D11_TEXTURE2D_DESC td;
     td.Width = WindowManager::width;
     td.Height = WindowManager::height;
@@ -60,35 +303,108 @@ ID3D11Texture2D* ResourceManager::CreateDepthStencilTexture()
     td.MiscFlags = 0;
 
     ID3D11Texture2D* depthStencilTexture{};
-    HRESULT hr{ DeviceManager::device->CreateTexture2D(&td, NULL, &depthStencilTexture) };
+    HRESULT hr{ CreatePooledResource(td, nullptr, &depthStencilTexture) };
     if (FAILED(hr)) {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_DEPTH_STENCIL_TEXTURE::FAILED_TO_CREATE_DEPTH_STENCIL_TEXTURE" << std::endl;
-        return nullptr;
+        return {};
     }
-    resources.push_back(depthStencilTexture);
-    return depthStencilTexture;
+    return AllocateResource(depthStencilTexture);
+}
+
+Texture2DHandle ResourceManager::CreateRenderTexture2D(UINT width, UINT height, DXGI_FORMAT format, UINT bindFlags)
+{
+    PROFILE_FUNCTION();
+    D3D11_TEXTURE2D_DESC td;
+    td.Width = width;
+    td.Height = height;
+    td.MipLevels = 1;
+    td.ArraySize = 1;
+    td.Format = format;
+    td.SampleDesc = {1,0};
+    td.Usage = D3D11_USAGE_DEFAULT;
+    td.BindFlags = bindFlags;
+    td.CPUAccessFlags = 0;
+    td.MiscFlags = 0;
+
+    ID3D11Texture2D* renderTexture{};
+    HRESULT hr{ CreatePooledResource(td, nullptr, &renderTexture) };
+    if (FAILED(hr)) {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_RENDER_TEXTURE_2D::FAILED_TO_CREATE_RENDER_TEXTURE_2D" << std::endl;
+        return {};
+    }
+    return AllocateResource(renderTexture);
+}
+
+Texture2DHandle ResourceManager::CreateStreamingTexture2D(UINT width, UINT height, UINT mipLevels, DXGI_FORMAT format)
+{
+    PROFILE_FUNCTION();
+    D3D11_TEXTURE2D_DESC td;
+    td.Width = width;
+    td.Height = height;
+    td.MipLevels = mipLevels;
+    td.ArraySize = 1;
+    td.Format = format;
+    td.SampleDesc = {1,0};
+    td.Usage = D3D11_USAGE_DEFAULT;
+    td.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    td.CPUAccessFlags = 0;
+    td.MiscFlags = D3D11_RESOURCE_MISC_RESOURCE_CLAMP;
+
+    //No initial data, so evicted and reallocated streaming textures of the same size are recycled through the pool
+    ID3D11Texture2D* streamingTexture{};
+    HRESULT hr{ CreatePooledResource(td, nullptr, &streamingTexture) };
+    if (FAILED(hr)) {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_STREAMING_TEXTURE_2D::FAILED_TO_CREATE_STREAMING_TEXTURE_2D" << std::endl;
+        return {};
+    }
+    return AllocateResource(streamingTexture);
+}
+
+Texture2DHandle ResourceManager::CreateStagingTexture2D(UINT width, UINT height, DXGI_FORMAT format)
+{
+    PROFILE_FUNCTION();
+    D3D11_TEXTURE2D_DESC td;
+    td.Width = width;
+    td.Height = height;
+    td.MipLevels = 1;
+    td.ArraySize = 1;
+    td.Format = format;
+    td.SampleDesc = {1,0};
+    td.Usage = D3D11_USAGE_STAGING;
+    td.BindFlags = 0;
+    td.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+    td.MiscFlags = 0;
+
+    //No initial data, so readbacks of the same size recycle their staging textures through the pool
+    ID3D11Texture2D* stagingTexture{};
+    HRESULT hr{ CreatePooledResource(td, nullptr, &stagingTexture) };
+    if (FAILED(hr)) {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_STAGING_TEXTURE_2D::FAILED_TO_CREATE_STAGING_TEXTURE_2D" << std::endl;
+        return {};
+    }
+    return AllocateResource(stagingTexture);
 }
 
 
 //-----------------------------------------------//
 //----------------BUFFER CREATION----------------//
 //-----------------------------------------------//
-ID3D11Buffer* ResourceManager::CreateBuffer(D3D11_BUFFER_DESC* pDesc, D3D11_SUBRESOURCE_DATA* pData)
+BufferHandle ResourceManager::CreateBuffer(D3D11_BUFFER_DESC* pDesc, D3D11_SUBRESOURCE_DATA* pData)
 {
     ID3D11Buffer* b;
-    HRESULT hr{ DeviceManager::device->CreateBuffer(pDesc, pData, &b) };
+    HRESULT hr{ CreatePooledResource(*pDesc, pData, &b) };
 
     if (FAILED(hr))
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_BUFFER::FAILED_TO_CREATE_BUFFER::CALLED_FROM::";
-        return nullptr;
+        return {};
     }
-    resources.push_back(b);
-    return b;
+    return AllocateResource(b);
 }
 
-ID3D11Buffer* ResourceManager::CreateVertexBuffer(UINT size, bool dynamic, bool streamout, D3D11_SUBRESOURCE_DATA* pData)
+BufferHandle ResourceManager::CreateVertexBuffer(UINT size, bool dynamic, bool streamout, D3D11_SUBRESOURCE_DATA* pData)
 {
+    PROFILE_FUNCTION();
     D3D11_BUFFER_DESC bd;
     bd.ByteWidth = size;
     bd.MiscFlags = 0;
@@ -98,13 +414,14 @@ ID3D11Buffer* ResourceManager::CreateVertexBuffer(UINT size, bool dynamic, bool
     bd.Usage = (dynamic) ? (D3D11_USAGE_DYNAMIC) : (D3D11_USAGE_IMMUTABLE);
     bd.CPUAccessFlags = (dynamic) ? (D3D11_CPU_ACCESS_WRITE) : (0);
 
-    ID3D11Buffer* b{ CreateBuffer(&bd, pData) };
-    if (!b) { std::cerr << "RESOURCE_MANAGER::CREATE_VERTEX_BUFFER" << std::endl; } //Append error message from ResourceManager::CreateBuffer
+    BufferHandle b{ CreateBuffer(&bd, pData) };
+    if (b.IsNull()) { std::cerr << "RESOURCE_MANAGER::CREATE_VERTEX_BUFFER" << std::endl; } //Append error message from ResourceManager::CreateBuffer
     return b;
 }
 
-ID3D11Buffer* ResourceManager::CreateIndexBuffer(UINT size, bool dynamic, D3D11_SUBRESOURCE_DATA* pData)
+BufferHandle ResourceManager::CreateIndexBuffer(UINT size, bool dynamic, D3D11_SUBRESOURCE_DATA* pData)
 {
+    PROFILE_FUNCTION();
     D3D11_BUFFER_DESC bd;
     bd.ByteWidth = size;
     bd.MiscFlags = 0;
@@ -114,13 +431,14 @@ ID3D11Buffer* ResourceManager::CreateIndexBuffer(UINT size, bool dynamic, D3D11_
     bd.Usage = (dynamic) ? (D3D11_USAGE_DYNAMIC) : (D3D11_USAGE_IMMUTABLE);
     bd.CPUAccessFlags = (dynamic) ? (D3D11_CPU_ACCESS_WRITE) : (0);
 
-    ID3D11Buffer* b{ CreateBuffer(&bd, pData) };
-    if (!b) { std::cerr << "RESOURCE_MANAGER::CREATE_INDEX_BUFFER" << std::endl; } //Append error message from ResourceManager::CreateBuffer
+    BufferHandle b{ CreateBuffer(&bd, pData) };
+    if (b.IsNull()) { std::cerr << "RESOURCE_MANAGER::CREATE_INDEX_BUFFER" << std::endl; } //Append error message from ResourceManager::CreateBuffer
     return b;
 }
 
-ID3D11Buffer* ResourceManager::CreateConstantBuffer(UINT size, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData)
+BufferHandle ResourceManager::CreateConstantBuffer(UINT size, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData)
 {
+    PROFILE_FUNCTION();
 
     bool exit{ false };
     
@@ -129,7 +447,7 @@ ID3D11Buffer* ResourceManager::CreateConstantBuffer(UINT size, bool CPUWriteable
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_CONSTANT_BUFFER::CANNOT_HAVE_SIMULTANEOUS_CPU_AND_GPU_WRITES" << std::endl;
         exit = true;
     }
-    if (exit) { return nullptr; }
+    if (exit) { return {}; }
     
     D3D11_BUFFER_DESC bd;
     bd.ByteWidth = size;
@@ -143,13 +461,14 @@ ID3D11Buffer* ResourceManager::CreateConstantBuffer(UINT size, bool CPUWriteable
 
     bd.CPUAccessFlags = (CPUWriteable) ? (D3D11_CPU_ACCESS_WRITE) : (0);
 
-    ID3D11Buffer* b{ CreateBuffer(&bd, pData) };
-    if (!b) { std::cerr << "RESOURCE_MANAGER::CREATE_CONSTANT_BUFFER" << std::endl; } //Append error message from ResourceManager::CreateBuffer
+    BufferHandle b{ CreateBuffer(&bd, pData) };
+    if (b.IsNull()) { std::cerr << "RESOURCE_MANAGER::CREATE_CONSTANT_BUFFER" << std::endl; } //Append error message from ResourceManager::CreateBuffer
     return b;
 }
 
-ID3D11Buffer* ResourceManager::CreateStructuredBuffer(UINT count, UINT structSize, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData)
+BufferHandle ResourceManager::CreateStructuredBuffer(UINT count, UINT structSize, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData)
 {
+    PROFILE_FUNCTION();
     bool exit{ false };
     
     if (CPUWriteable && GPUWriteable)
@@ -157,7 +476,7 @@ ID3D11Buffer* ResourceManager::CreateStructuredBuffer(UINT count, UINT structSiz
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_STRUCTURED_BUFFER::CANNOT_HAVE_SIMULTANEOUS_CPU_AND_GPU_WRITES" << std::endl;
         exit = true;
     }
-    if (exit) { return nullptr; }
+    if (exit) { return {}; }
 
     D3D11_BUFFER_DESC bd;
     bd.ByteWidth = count * structSize;
@@ -182,13 +501,14 @@ ID3D11Buffer* ResourceManager::CreateStructuredBuffer(UINT count, UINT structSiz
 
     bd.CPUAccessFlags = (CPUWriteable) ? (D3D11_CPU_ACCESS_WRITE) : (0);
 
-    ID3D11Buffer* b{ CreateBuffer(&bd, pData) };
-    if (!b) { std::cerr << "RESOURCE_MANAGER::CREATE_STRUCTURED_BUFFER" << std::endl; } //Append error message from ResourceManager::CreateBuffer
+    BufferHandle b{ CreateBuffer(&bd, pData) };
+    if (b.IsNull()) { std::cerr << "RESOURCE_MANAGER::CREATE_STRUCTURED_BUFFER" << std::endl; } //Append error message from ResourceManager::CreateBuffer
     return b;
 }
 
-ID3D11Buffer* ResourceManager::CreateAppendConsumeBuffer(UINT count, UINT structSize, D3D11_SUBRESOURCE_DATA* pData)
+BufferHandle ResourceManager::CreateAppendConsumeBuffer(UINT count, UINT structSize, D3D11_SUBRESOURCE_DATA* pData)
 {
+    PROFILE_FUNCTION();
     D3D11_BUFFER_DESC bd;
     bd.ByteWidth = count * structSize;
     bd.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
@@ -196,13 +516,14 @@ ID3D11Buffer* ResourceManager::CreateAppendConsumeBuffer(UINT count, UINT struct
     bd.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
     bd.Usage = D3D11_USAGE_DEFAULT;
     bd.CPUAccessFlags = 0;
-    ID3D11Buffer* b{ CreateBuffer(&bd, pData) };
-    if (!b) { std::cerr << "RESOURCE_MANAGER::CREATE_APPEND_CONSUME_BUFFER" << std::endl; } //Append error message from ResourceManager::CreateBuffer
+    BufferHandle b{ CreateBuffer(&bd, pData) };
+    if (b.IsNull()) { std::cerr << "RESOURCE_MANAGER::CREATE_APPEND_CONSUME_BUFFER" << std::endl; } //Append error message from ResourceManager::CreateBuffer
     return b;
 }
 
-ID3D11Buffer* ResourceManager::CreateRawBuffer(UINT size, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData)
+BufferHandle ResourceManager::CreateRawBuffer(UINT size, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData)
 {
+    PROFILE_FUNCTION();
     D3D11_BUFFER_DESC bd;
     bd.ByteWidth = size;
     bd.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS;
@@ -210,13 +531,14 @@ ID3D11Buffer* ResourceManager::CreateRawBuffer(UINT size, bool GPUWriteable, D3D
     bd.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
     bd.Usage = (GPUWriteable) ? (D3D11_USAGE_DEFAULT) : (D3D11_USAGE_IMMUTABLE);
     bd.CPUAccessFlags = 0;
-    ID3D11Buffer* b{ CreateBuffer(&bd, pData) };
-    if (!b) { std::cerr << "RESOURCE_MANAGER::CREATE_RAW_BUFFER" << std::endl; } //Append error message from ResourceManager::CreateBuffer
+    BufferHandle b{ CreateBuffer(&bd, pData) };
+    if (b.IsNull()) { std::cerr << "RESOURCE_MANAGER::CREATE_RAW_BUFFER" << std::endl; } //Append error message from ResourceManager::CreateBuffer
     return b;
 }
 
-ID3D11Buffer* ResourceManager::CreateIndirectArgsBuffer(UINT size, D3D11_SUBRESOURCE_DATA* pData)
+BufferHandle ResourceManager::CreateIndirectArgsBuffer(UINT size, D3D11_SUBRESOURCE_DATA* pData)
 {
+    PROFILE_FUNCTION();
 
     if (size % 4 != 0)
     {
@@ -230,8 +552,23 @@ ID3D11Buffer* ResourceManager::CreateIndirectArgsBuffer(UINT size, D3D11_SUBRESO
     bd.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
     bd.Usage = D3D11_USAGE_DEFAULT;
     bd.CPUAccessFlags = 0;
-    ID3D11Buffer* b{ CreateBuffer(&bd, pData) };
-    if (!b) { std::cerr << "RESOURCE_MANAGER::CREATE_INDIRECT_ARGS_BUFFER" << std::endl; } //Append error message from ResourceManager::CreateBuffer
+    BufferHandle b{ CreateBuffer(&bd, pData) };
+    if (b.IsNull()) { std::cerr << "RESOURCE_MANAGER::CREATE_INDIRECT_ARGS_BUFFER" << std::endl; } //Append error message from ResourceManager::CreateBuffer
+    return b;
+}
+
+BufferHandle ResourceManager::CreateStagingBuffer(UINT size)
+{
+    PROFILE_FUNCTION();
+    D3D11_BUFFER_DESC bd;
+    bd.ByteWidth = size;
+    bd.MiscFlags = 0;
+    bd.StructureByteStride = 0;
+    bd.BindFlags = 0;
+    bd.Usage = D3D11_USAGE_STAGING;
+    bd.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+    BufferHandle b{ CreateBuffer(&bd, nullptr) };
+    if (b.IsNull()) { std::cerr << "RESOURCE_MANAGER::CREATE_STAGING_BUFFER" << std::endl; } //Append error message from ResourceManager::CreateBuffer
     return b;
 }
 
@@ -244,12 +581,13 @@ ID3D11Buffer* ResourceManager::CreateIndirectArgsBuffer(UINT size, D3D11_SUBRESO
 //----------------------------------------------//
 //---------------TEXTURE CREATION---------------//
 //----------------------------------------------//
-ID3D11Texture1D* ResourceManager::CreateTexture1D(UINT width, UINT mipLevels, DXGI_FORMAT format, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData)
+Texture1DHandle ResourceManager::CreateTexture1D(UINT width, UINT mipLevels, DXGI_FORMAT format, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData)
 {
+    PROFILE_FUNCTION();
     if (CPUWriteable && GPUWriteable)
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_1D::CANNOT_HAVE_SIMULTANEOUS_CPU_AND_GPU_WRITES" << std::endl;
-        return nullptr;
+        return {};
     }
     
     D3D11_TEXTURE1D_DESC td;
@@ -257,7 +595,7 @@ ID3D11Texture1D* ResourceManager::CreateTexture1D(UINT width, UINT mipLevels, DX
     td.MipLevels = mipLevels;
     td.ArraySize = 1;
     td.Format = format;
-    td.MiscFlags = (mipLevels == 1) ? (D3D11_RESOURCE_MISC_RESOURCE_CLAMP) : (D3D11_RESOURCE_MISC_RESOURCE_CLAMP | D3D11_RESOURCE_MISC_GENERATE_MIPS);
+    td.MiscFlags = D3D11_RESOURCE_MISC_RESOURCE_CLAMP;
 
     if (CPUWriteable && !GPUWriteable)
     {
@@ -276,22 +614,23 @@ ID3D11Texture1D* ResourceManager::CreateTexture1D(UINT width, UINT mipLevels, DX
     }
     td.CPUAccessFlags = (CPUWriteable) ? (D3D11_CPU_ACCESS_WRITE) : (0);
 
-    ID3D11Texture1D* t;
-    DeviceManager::device->CreateTexture1D(&td, pData, &t);
-    if (!t)
+    ID3D11Texture1D* t{};
+    HRESULT hr{ CreatePooledResource(td, pData, &t) };
+    if (FAILED(hr))
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_1D::FAILED_TO_CREATE_TEXTURE_1D" << std::endl;
-        return nullptr;
+        return {};
     }
-    return t;
+    return AllocateResource(t);
 }
 
-ID3D11Texture1D* ResourceManager::CreateTexture1DArray(UINT width, UINT mipLevels, UINT arraySize, DXGI_FORMAT format, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData)
+Texture1DHandle ResourceManager::CreateTexture1DArray(UINT width, UINT mipLevels, UINT arraySize, DXGI_FORMAT format, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData)
 {
+    PROFILE_FUNCTION();
     if (CPUWriteable && GPUWriteable)
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_1D_ARRAY::CANNOT_HAVE_SIMULTANEOUS_CPU_AND_GPU_WRITES" << std::endl;
-        return nullptr;
+        return {};
     }
     
     D3D11_TEXTURE1D_DESC td;
@@ -299,7 +638,7 @@ ID3D11Texture1D* ResourceManager::CreateTexture1DArray(UINT width, UINT mipLevel
     td.MipLevels = mipLevels;
     td.ArraySize = arraySize;
     td.Format = format;
-    td.MiscFlags = (mipLevels == 1) ? (D3D11_RESOURCE_MISC_RESOURCE_CLAMP) : (D3D11_RESOURCE_MISC_RESOURCE_CLAMP | D3D11_RESOURCE_MISC_GENERATE_MIPS);
+    td.MiscFlags = D3D11_RESOURCE_MISC_RESOURCE_CLAMP;
 
     if (CPUWriteable && !GPUWriteable)
     {
@@ -318,30 +657,33 @@ ID3D11Texture1D* ResourceManager::CreateTexture1DArray(UINT width, UINT mipLevel
     }
     td.CPUAccessFlags = (CPUWriteable) ? (D3D11_CPU_ACCESS_WRITE) : (0);
 
-    ID3D11Texture1D* t;
-    DeviceManager::device->CreateTexture1D(&td, pData, &t);
-    if (!t)
+    ID3D11Texture1D* t{};
+    HRESULT hr{ CreatePooledResource(td, pData, &t) };
+    if (FAILED(hr))
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_1D_ARRAY::FAILED_TO_CREATE_TEXTURE_1D" << std::endl;
-        return nullptr;
+        return {};
     }
-    return t;
+    return AllocateResource(t);
 }
 
-ID3D11Texture2D* ResourceManager::CreateTexture2D(UINT width, UINT height, UINT mipLevels, DXGI_FORMAT format, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData)
+Texture2DHandle ResourceManager::CreateTexture2D(UINT width, UINT height, UINT mipLevels, DXGI_FORMAT format, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData)
 {
+    PROFILE_FUNCTION();
     if (CPUWriteable && GPUWriteable)
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_2D::CANNOT_HAVE_SIMULTANEOUS_CPU_AND_GPU_WRITES" << std::endl;
-        return nullptr;
+        return {};
     }
     
     D3D11_TEXTURE2D_DESC td;
     td.Width = width;
+    td.Height = height;
     td.MipLevels = mipLevels;
+    td.SampleDesc = {1,0};
     td.ArraySize = 1;
     td.Format = format;
-    td.MiscFlags = (mipLevels == 1) ? (D3D11_RESOURCE_MISC_RESOURCE_CLAMP) : (D3D11_RESOURCE_MISC_RESOURCE_CLAMP | D3D11_RESOURCE_MISC_GENERATE_MIPS);
+    td.MiscFlags = D3D11_RESOURCE_MISC_RESOURCE_CLAMP;
 
     if (CPUWriteable && !GPUWriteable)
     {
@@ -360,30 +702,33 @@ ID3D11Texture2D* ResourceManager::CreateTexture2D(UINT width, UINT height, UINT
     }
     td.CPUAccessFlags = (CPUWriteable) ? (D3D11_CPU_ACCESS_WRITE) : (0);
 
-    ID3D11Texture2D* t;
-    DeviceManager::device->CreateTexture2D(&td, pData, &t);
-    if (!t)
+    ID3D11Texture2D* t{};
+    HRESULT hr{ CreatePooledResource(td, pData, &t) };
+    if (FAILED(hr))
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_2D::FAILED_TO_CREATE_TEXTURE_2D" << std::endl;
-        return nullptr;
+        return {};
     }
-    return t;
+    return AllocateResource(t);
 }
 
-ID3D11Texture2D* ResourceManager::CreateTexture2DArray(UINT width, UINT height, UINT mipLevels, UINT arraySize, DXGI_FORMAT format, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData)
+Texture2DHandle ResourceManager::CreateTexture2DArray(UINT width, UINT height, UINT mipLevels, UINT arraySize, DXGI_FORMAT format, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData)
 {
+    PROFILE_FUNCTION();
     if (CPUWriteable && GPUWriteable)
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_2D_ARRAY::CANNOT_HAVE_SIMULTANEOUS_CPU_AND_GPU_WRITES" << std::endl;
-        return nullptr;
+        return {};
     }
     
     D3D11_TEXTURE2D_DESC td;
     td.Width = width;
+    td.Height = height;
     td.MipLevels = mipLevels;
+    td.SampleDesc = {1,0};
     td.ArraySize = arraySize;
     td.Format = format;
-    td.MiscFlags = (mipLevels == 1) ? (D3D11_RESOURCE_MISC_RESOURCE_CLAMP) : (D3D11_RESOURCE_MISC_RESOURCE_CLAMP | D3D11_RESOURCE_MISC_GENERATE_MIPS);
+    td.MiscFlags = D3D11_RESOURCE_MISC_RESOURCE_CLAMP;
 
     if (CPUWriteable && !GPUWriteable)
     {
@@ -402,29 +747,32 @@ ID3D11Texture2D* ResourceManager::CreateTexture2DArray(UINT width, UINT height,
     }
     td.CPUAccessFlags = (CPUWriteable) ? (D3D11_CPU_ACCESS_WRITE) : (0);
 
-    ID3D11Texture2D* t;
-    DeviceManager::device->CreateTexture2D(&td, pData, &t);
-    if (!t)
+    ID3D11Texture2D* t{};
+    HRESULT hr{ CreatePooledResource(td, pData, &t) };
+    if (FAILED(hr))
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_2D_ARRAY::FAILED_TO_CREATE_TEXTURE_2D" << std::endl;
-        return nullptr;
+        return {};
     }
-    return t;
+    return AllocateResource(t);
 }
 
-ID3D11Texture3D* ResourceManager::CreateTexture3D(UINT width, UINT height, UINT depth, UINT mipLevels, DXGI_FORMAT format, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData)
+Texture3DHandle ResourceManager::CreateTexture3D(UINT width, UINT height, UINT depth, UINT mipLevels, DXGI_FORMAT format, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData)
 {
+    PROFILE_FUNCTION();
     if (CPUWriteable && GPUWriteable)
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_3D::CANNOT_HAVE_SIMULTANEOUS_CPU_AND_GPU_WRITES" << std::endl;
-        return nullptr;
+        return {};
     }
     
     D3D11_TEXTURE3D_DESC td;
     td.Width = width;
+    td.Height = height;
+    td.Depth = depth;
     td.MipLevels = mipLevels;
     td.Format = format;
-    td.MiscFlags = (mipLevels == 1) ? (D3D11_RESOURCE_MISC_RESOURCE_CLAMP) : (D3D11_RESOURCE_MISC_RESOURCE_CLAMP | D3D11_RESOURCE_MISC_GENERATE_MIPS);
+    td.MiscFlags = D3D11_RESOURCE_MISC_RESOURCE_CLAMP;
 
     if (CPUWriteable && !GPUWriteable)
     {
@@ -443,14 +791,14 @@ ID3D11Texture3D* ResourceManager::CreateTexture3D(UINT width, UINT height, UINT
     }
     td.CPUAccessFlags = (CPUWriteable) ? (D3D11_CPU_ACCESS_WRITE) : (0);
 
-    ID3D11Texture3D* t;
-    DeviceManager::device->CreateTexture3D(&td, pData, &t);
-    if (!t)
+    ID3D11Texture3D* t{};
+    HRESULT hr{ CreatePooledResource(td, pData, &t) };
+    if (FAILED(hr))
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_3D::FAILED_TO_CREATE_TEXTURE_2D" << std::endl;
-        return nullptr;
+        return {};
     }
-    return t;
+    return AllocateResource(t);
 }
 //-----------------------------------------------//
 //------------END OF TEXTURE CREATION------------//
@@ -461,38 +809,58 @@ ID3D11Texture3D* ResourceManager::CreateTexture3D(UINT width, UINT height, UINT
 //-----------------------------------------------//
 //-----------------VIEW CREATION-----------------//
 //-----------------------------------------------//
-ID3D11DepthStencilView* ResourceManager::CreateDepthStencilView(ID3D11Texture2D* texture)
+DepthStencilViewHandle ResourceManager::CreateDepthStencilView(Texture2DHandle textureHandle)
 {
-    ID3D11DepthStencilView* depthStencilView;
-    HRESULT hr{ DeviceManager::device->CreateDepthStencilView(texture, NULL, &depthStencilView) };
-    if (FAILED(hr)) {
+    PROFILE_FUNCTION();
+    ID3D11Texture2D* texture{ Get(textureHandle) };
+    if (!texture)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_DEPTH_STENCIL_VIEW::INVALID_TEXTURE_HANDLE" << std::endl;
+        return {};
+    }
+
+    const DepthStencilViewHandle depthStencilView{ CreateView<ID3D11DepthStencilView>(texture, nullptr) };
+    if (depthStencilView.IsNull()) {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_DEPTH_STENCIL_VIEW::FAILED_TO_CREATE_DEPTH_STENCIL_VIEW" << std::endl;
-        return nullptr;
+        return {};
     }
-    resourceViews.push_back(depthStencilView);
     return depthStencilView;
 }
 
-ID3D11RenderTargetView* ResourceManager::CreateRenderTargetView(ID3D11Texture2D* texture)
+RenderTargetViewHandle ResourceManager::CreateRenderTargetView(Texture2DHandle textureHandle)
 {
-    ID3D11RenderTargetView* renderTargetView;
-    HRESULT hr{ DeviceManager::device->CreateRenderTargetView(texture, NULL, &renderTargetView) };
-    if (FAILED(hr)) {
+    PROFILE_FUNCTION();
+    ID3D11Texture2D* texture{ Get(textureHandle) };
+    if (!texture)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_RENDER_TARGET_VIEW::INVALID_TEXTURE_HANDLE" << std::endl;
+        return {};
+    }
+
+    const RenderTargetViewHandle renderTargetView{ CreateView<ID3D11RenderTargetView>(texture, nullptr) };
+    if (renderTargetView.IsNull()) {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_RENDER_TARGET_VIEW::FAILED_TO_CREATE_RENDER_TARGET_VIEW" << std::endl;
-        return nullptr;
+        return {};
     }
-    resourceViews.push_back(renderTargetView);
     return renderTargetView;
 }
 
-ID3D11ShaderResourceView* ResourceManager::CreateBufferShaderResourceView(ID3D11Buffer* pResource, UINT offset, UINT count, DXGI_FORMAT format, UINT flags)
+ShaderResourceViewHandle ResourceManager::CreateBufferShaderResourceView(BufferHandle buffer, UINT offset, UINT count, DXGI_FORMAT format, UINT flags)
 {
+    PROFILE_FUNCTION();
+    ID3D11Buffer* pResource{ Get(buffer) };
+    if (!pResource)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_SHADER_RESOURCE_VIEW::INVALID_BUFFER_HANDLE" << std::endl;
+        return {};
+    }
+
     bool exit{ false };
     
-    D3D11_SHADER_RESOURCE_VIEW_DESC srvd;
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvd{};
 
     D3D11_BUFFER_DESC bd;
-    pResource->GetDesc(&bd);
+    DeviceManager::device->GetBufferDesc(pResource, &bd);
     if ((bd.BindFlags & D3D11_BIND_SHADER_RESOURCE) == 0)
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_SHADER_RESOURCE_VIEW::SHADER_RESOURCE_VIEWS_REQUIRE_D3D11_BIND_SHADER_RESOURCE_FLAG_ON_RESOURCE" << std::endl;
@@ -521,7 +889,7 @@ ID3D11ShaderResourceView* ResourceManager::CreateBufferShaderResourceView(ID3D11
             exit = true;
         }
     }
-    if (exit) { return nullptr; }
+    if (exit) { return {}; }
     srvd.Format = format;
 
     srvd.ViewDimension = D3D11_SRV_DIMENSION_BUFFEREX;
@@ -529,25 +897,31 @@ ID3D11ShaderResourceView* ResourceManager::CreateBufferShaderResourceView(ID3D11
     srvd.BufferEx.NumElements = count;
     srvd.BufferEx.Flags = flags;
 
-    ID3D11ShaderResourceView* srv;
-    HRESULT hr{ DeviceManager::device->CreateShaderResourceView(pResource, &srvd, &srv) };
-    if (FAILED(hr))
+    const ShaderResourceViewHandle srv{ CreateView<ID3D11ShaderResourceView>(pResource, &srvd) };
+    if (srv.IsNull())
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_SHADER_RESOURCE_VIEW::FAILED_TO_CREATE_SHADER_RESOURCE_VIEW" << std::endl;
-        return nullptr;
+        return {};
     }
-    resourceViews.push_back(srv);
     return srv;
 }
 
-ID3D11UnorderedAccessView* ResourceManager::CreateBufferUnorderedAccessView(ID3D11Buffer* pResource, UINT offset, UINT count, DXGI_FORMAT format, UINT flags)
+UnorderedAccessViewHandle ResourceManager::CreateBufferUnorderedAccessView(BufferHandle buffer, UINT offset, UINT count, DXGI_FORMAT format, UINT flags)
 {
+    PROFILE_FUNCTION();
+    ID3D11Buffer* pResource{ Get(buffer) };
+    if (!pResource)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_UNORDERED_ACCESS_VIEW::INVALID_BUFFER_HANDLE" << std::endl;
+        return {};
+    }
+
     bool exit{ false };
     
-    D3D11_UNORDERED_ACCESS_VIEW_DESC uavd;
+    D3D11_UNORDERED_ACCESS_VIEW_DESC uavd{};
 
     D3D11_BUFFER_DESC bd;
-    pResource->GetDesc(&bd);
+    DeviceManager::device->GetBufferDesc(pResource, &bd);
     if ((bd.BindFlags & D3D11_BIND_UNORDERED_ACCESS) == 0)
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_UNORDERED_ACCESS_VIEW::UNORDERED_ACCESS_VIEWS_REQUIRE_D3D11_BIND_UNORDERED_ACCESS_FLAG_ON_RESOURCE" << std::endl;
@@ -576,7 +950,7 @@ ID3D11UnorderedAccessView* ResourceManager::CreateBufferUnorderedAccessView(ID3D
             exit = true;
         }
     }
-    if (exit) { return nullptr; }
+    if (exit) { return {}; }
     uavd.Format = format;
 
     uavd.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
@@ -584,129 +958,173 @@ ID3D11UnorderedAccessView* ResourceManager::CreateBufferUnorderedAccessView(ID3D
     uavd.Buffer.NumElements = count;
     uavd.Buffer.Flags = flags;
 
-    ID3D11UnorderedAccessView* uav;
-    HRESULT hr{ DeviceManager::device->CreateUnorderedAccessView(pResource, &uavd, &uav) };
-    if (FAILED(hr))
+    const UnorderedAccessViewHandle uav{ CreateView<ID3D11UnorderedAccessView>(pResource, &uavd) };
+    if (uav.IsNull())
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_UNORDERED_ACCESS_VIEW::FAILED_TO_CREATE_UNORDERED_ACCESS_VIEW" << std::endl;
-        return nullptr;
+        return {};
     }
-    resourceViews.push_back(uav);
     return uav;
 }
 
 
 
-ID3D11RenderTargetView* ResourceManager::CreateTexture1DRenderTargetView(ID3D11Texture1D* texture, UINT mipSlice, DXGI_FORMAT format)
+RenderTargetViewHandle ResourceManager::CreateTexture1DRenderTargetView(Texture1DHandle textureHandle, UINT mipSlice, DXGI_FORMAT format)
 {
-    D3D11_RENDER_TARGET_VIEW_DESC rtvd;
+    PROFILE_FUNCTION();
+    ID3D11Texture1D* texture{ Get(textureHandle) };
+    if (!texture)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_1D_RENDER_TARGET_VIEW::INVALID_TEXTURE_HANDLE" << std::endl;
+        return {};
+    }
+
+    D3D11_RENDER_TARGET_VIEW_DESC rtvd{};
     rtvd.Format = format;
     rtvd.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE1D;
     rtvd.Texture1D.MipSlice = mipSlice;
     
-    ID3D11RenderTargetView* rtv;
-    HRESULT hr{ DeviceManager::device->CreateRenderTargetView(texture, &rtvd, &rtv) };
-    if (FAILED(hr)) {
+    const RenderTargetViewHandle rtv{ CreateView<ID3D11RenderTargetView>(texture, &rtvd) };
+    if (rtv.IsNull()) {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_1D_RENDER_TARGET_VIEW::FAILED_TO_CREATE_RENDER_TARGET_VIEW" << std::endl;
-        return nullptr;
+        return {};
     }
-    resourceViews.push_back(rtv);
     return rtv;
 }
 
-ID3D11DepthStencilView* ResourceManager::CreateTexture1DDepthStencilView(ID3D11Texture1D* texture, UINT mipSlice, DXGI_FORMAT format)
+DepthStencilViewHandle ResourceManager::CreateTexture1DDepthStencilView(Texture1DHandle textureHandle, UINT mipSlice, DXGI_FORMAT format)
 {
-    D3D11_DEPTH_STENCIL_VIEW_DESC dsvd;
+    PROFILE_FUNCTION();
+    ID3D11Texture1D* texture{ Get(textureHandle) };
+    if (!texture)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_1D_DEPTH_STENCIL_VIEW::INVALID_TEXTURE_HANDLE" << std::endl;
+        return {};
+    }
+
+    D3D11_DEPTH_STENCIL_VIEW_DESC dsvd{};
     dsvd.Format = format;
     dsvd.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE1D;
     dsvd.Texture1D.MipSlice = mipSlice;
     
-    ID3D11DepthStencilView* dsv;
-    HRESULT hr{ DeviceManager::device->CreateDepthStencilView(texture, &dsvd, &dsv) };
-    if (FAILED(hr)) {
+    const DepthStencilViewHandle dsv{ CreateView<ID3D11DepthStencilView>(texture, &dsvd) };
+    if (dsv.IsNull()) {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_1D_DEPTH_STENCIL_VIEW::FAILED_TO_CREATE_DEPTH_STENCIL_VIEW" << std::endl;
-        return nullptr;
+        return {};
     }
-    resourceViews.push_back(dsv);
     return dsv;
 }
 
-ID3D11ShaderResourceView* ResourceManager::CreateTexture1DShaderResourceView(ID3D11Texture1D* texture, UINT mostDetailedMipSlice, UINT mipLevels, DXGI_FORMAT format)
+ShaderResourceViewHandle ResourceManager::CreateTexture1DShaderResourceView(Texture1DHandle textureHandle, UINT mostDetailedMipSlice, UINT mipLevels, DXGI_FORMAT format)
 {
-    D3D11_SHADER_RESOURCE_VIEW_DESC srvd;
+    PROFILE_FUNCTION();
+    ID3D11Texture1D* texture{ Get(textureHandle) };
+    if (!texture)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_1D_SHADER_RESOURCE_VIEW::INVALID_TEXTURE_HANDLE" << std::endl;
+        return {};
+    }
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvd{};
     srvd.Format = format;
     srvd.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE1D;
     srvd.Texture1D.MostDetailedMip = mostDetailedMipSlice;
     srvd.Texture1D.MipLevels = mipLevels;
 
-    ID3D11ShaderResourceView* srv;
-    HRESULT hr{ DeviceManager::device->CreateShaderResourceView(texture, &srvd, &srv) };
-    if (FAILED(hr))
+    const ShaderResourceViewHandle srv{ CreateView<ID3D11ShaderResourceView>(texture, &srvd) };
+    if (srv.IsNull())
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_1D_SHADER_RESOURCE_VIEW::FAILED_TO_CREATE_SHADER_RESOURCE_VIEW" << std::endl;
-        return nullptr;
+        return {};
     }
-    resourceViews.push_back(srv);
     return srv;
 }
 
-ID3D11UnorderedAccessView* ResourceManager::CreateTexture1DUnorderedAccessView(ID3D11Texture1D* texture, UINT mipSlice, DXGI_FORMAT format)
+UnorderedAccessViewHandle ResourceManager::CreateTexture1DUnorderedAccessView(Texture1DHandle textureHandle, UINT mipSlice, DXGI_FORMAT format)
 {
-    D3D11_UNORDERED_ACCESS_VIEW_DESC uavd;
+    PROFILE_FUNCTION();
+    ID3D11Texture1D* texture{ Get(textureHandle) };
+    if (!texture)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_1D_UNORDERED_ACCESS_VIEW::INVALID_TEXTURE_HANDLE" << std::endl;
+        return {};
+    }
+
+    D3D11_UNORDERED_ACCESS_VIEW_DESC uavd{};
     uavd.Format = format;
     uavd.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE1D;
     uavd.Texture1D.MipSlice = mipSlice;
 
-    ID3D11UnorderedAccessView* uav;
-    HRESULT hr{ DeviceManager::device->CreateUnorderedAccessView(texture, &uavd, &uav) };
-    if (FAILED(hr))
+    const UnorderedAccessViewHandle uav{ CreateView<ID3D11UnorderedAccessView>(texture, &uavd) };
+    if (uav.IsNull())
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_1D_UNORDERED_ACCESS_VIEW::FAILED_TO_CREATE_UNORDERED_ACCESS_VIEW" << std::endl;
-        return nullptr;
+        return {};
     }
-    resourceViews.push_back(uav);
     return uav;
 }
 
-ID3D11RenderTargetView* ResourceManager::CreateTexture1DArrayRenderTargetView(ID3D11Texture1D* texture, UINT mipSlice, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format)
+RenderTargetViewHandle ResourceManager::CreateTexture1DArrayRenderTargetView(Texture1DHandle textureHandle, UINT mipSlice, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format)
 {
-    D3D11_RENDER_TARGET_VIEW_DESC rtvd;
+    PROFILE_FUNCTION();
+    ID3D11Texture1D* texture{ Get(textureHandle) };
+    if (!texture)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_1D_ARRAY_RENDER_TARGET_VIEW::INVALID_TEXTURE_HANDLE" << std::endl;
+        return {};
+    }
+
+    D3D11_RENDER_TARGET_VIEW_DESC rtvd{};
     rtvd.Format = format;
     rtvd.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE1DARRAY;
     rtvd.Texture1DArray.MipSlice = mipSlice;
     rtvd.Texture1DArray.FirstArraySlice = firstArraySlice;
     rtvd.Texture1DArray.ArraySize = arraySlices;
     
-    ID3D11RenderTargetView* rtv;
-    HRESULT hr{ DeviceManager::device->CreateRenderTargetView(texture, &rtvd, &rtv) };
-    if (FAILED(hr)) {
+    const RenderTargetViewHandle rtv{ CreateView<ID3D11RenderTargetView>(texture, &rtvd) };
+    if (rtv.IsNull()) {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_1D_ARRAY_RENDER_TARGET_VIEW::FAILED_TO_CREATE_RENDER_TARGET_VIEW" << std::endl;
-        return nullptr;
+        return {};
     }
-    resourceViews.push_back(rtv);
     return rtv;
 }
 
-ID3D11DepthStencilView* ResourceManager::CreateTexture1DArrayDepthStencilView(ID3D11Texture1D* texture, UINT mipSlice, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format)
+DepthStencilViewHandle ResourceManager::CreateTexture1DArrayDepthStencilView(Texture1DHandle textureHandle, UINT mipSlice, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format)
 {
-    D3D11_DEPTH_STENCIL_VIEW_DESC dsvd;
+    PROFILE_FUNCTION();
+    ID3D11Texture1D* texture{ Get(textureHandle) };
+    if (!texture)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_1D_ARRAY_DEPTH_STENCIL_VIEW::INVALID_TEXTURE_HANDLE" << std::endl;
+        return {};
+    }
+
+    D3D11_DEPTH_STENCIL_VIEW_DESC dsvd{};
     dsvd.Format = format;
     dsvd.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE1DARRAY;
-    dsvd.Texture1D.MipSlice = mipSlice;
+    dsvd.Texture1DArray.MipSlice = mipSlice;
+    dsvd.Texture1DArray.FirstArraySlice = firstArraySlice;
+    dsvd.Texture1DArray.ArraySize = arraySlices;
     
-    ID3D11DepthStencilView* dsv;
-    HRESULT hr{ DeviceManager::device->CreateDepthStencilView(texture, &dsvd, &dsv) };
-    if (FAILED(hr)) {
+    const DepthStencilViewHandle dsv{ CreateView<ID3D11DepthStencilView>(texture, &dsvd) };
+    if (dsv.IsNull()) {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_1D_ARRAY_DEPTH_STENCIL_VIEW::FAILED_TO_CREATE_DEPTH_STENCIL_VIEW" << std::endl;
-        return nullptr;
+        return {};
     }
-    resourceViews.push_back(dsv);
     return dsv;
 }
 
-ID3D11ShaderResourceView* ResourceManager::CreateTexture1DArrayShaderResourceView(ID3D11Texture1D* texture, UINT mostDetailedMipSlice, UINT mipLevels, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format)
+ShaderResourceViewHandle ResourceManager::CreateTexture1DArrayShaderResourceView(Texture1DHandle textureHandle, UINT mostDetailedMipSlice, UINT mipLevels, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format)
 {
-    D3D11_SHADER_RESOURCE_VIEW_DESC srvd;
+    PROFILE_FUNCTION();
+    ID3D11Texture1D* texture{ Get(textureHandle) };
+    if (!texture)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_1D_ARRAY_SHADER_RESOURCE_VIEW::INVALID_TEXTURE_HANDLE" << std::endl;
+        return {};
+    }
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvd{};
     srvd.Format = format;
     srvd.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE1DARRAY;
     srvd.Texture1DArray.MostDetailedMip = mostDetailedMipSlice;
@@ -714,147 +1132,197 @@ ID3D11ShaderResourceView* ResourceManager::CreateTexture1DArrayShaderResourceVie
     srvd.Texture1DArray.FirstArraySlice = firstArraySlice;
     srvd.Texture1DArray.ArraySize = arraySlices;
 
-    ID3D11ShaderResourceView* srv;
-    HRESULT hr{ DeviceManager::device->CreateShaderResourceView(texture, &srvd, &srv) };
-    if (FAILED(hr))
+    const ShaderResourceViewHandle srv{ CreateView<ID3D11ShaderResourceView>(texture, &srvd) };
+    if (srv.IsNull())
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_1D_ARRAY_SHADER_RESOURCE_VIEW::FAILED_TO_CREATE_SHADER_RESOURCE_VIEW" << std::endl;
-        return nullptr;
+        return {};
     }
-    resourceViews.push_back(srv);
     return srv;
 }
 
-ID3D11UnorderedAccessView* ResourceManager::CreateTexture1DArrayUnorderedAccessView(ID3D11Texture1D* texture, UINT mipSlice, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format)
+UnorderedAccessViewHandle ResourceManager::CreateTexture1DArrayUnorderedAccessView(Texture1DHandle textureHandle, UINT mipSlice, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format)
 {
-    D3D11_UNORDERED_ACCESS_VIEW_DESC uavd;
+    PROFILE_FUNCTION();
+    ID3D11Texture1D* texture{ Get(textureHandle) };
+    if (!texture)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_1D_ARRAY_UNORDERED_ACCESS_VIEW::INVALID_TEXTURE_HANDLE" << std::endl;
+        return {};
+    }
+
+    D3D11_UNORDERED_ACCESS_VIEW_DESC uavd{};
     uavd.Format = format;
     uavd.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE1DARRAY;
     uavd.Texture1DArray.MipSlice = mipSlice;
     uavd.Texture1DArray.FirstArraySlice = firstArraySlice;
     uavd.Texture1DArray.ArraySize = arraySlices;
 
-    ID3D11UnorderedAccessView* uav;
-    HRESULT hr{ DeviceManager::device->CreateUnorderedAccessView(texture, &uavd, &uav) };
-    if (FAILED(hr))
+    const UnorderedAccessViewHandle uav{ CreateView<ID3D11UnorderedAccessView>(texture, &uavd) };
+    if (uav.IsNull())
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_1D_ARRAY_UNORDERED_ACCESS_VIEW::FAILED_TO_CREATE_UNORDERED_ACCESS_VIEW" << std::endl;
-        return nullptr;
+        return {};
     }
-    resourceViews.push_back(uav);
     return uav;
 }
 
-ID3D11RenderTargetView* ResourceManager::CreateTexture2DRenderTargetView(ID3D11Texture2D* texture, UINT mipSlice, DXGI_FORMAT format)
+RenderTargetViewHandle ResourceManager::CreateTexture2DRenderTargetView(Texture2DHandle textureHandle, UINT mipSlice, DXGI_FORMAT format)
 {
-    D3D11_RENDER_TARGET_VIEW_DESC rtvd;
+    PROFILE_FUNCTION();
+    ID3D11Texture2D* texture{ Get(textureHandle) };
+    if (!texture)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_2D_RENDER_TARGET_VIEW::INVALID_TEXTURE_HANDLE" << std::endl;
+        return {};
+    }
+
+    D3D11_RENDER_TARGET_VIEW_DESC rtvd{};
     rtvd.Format = format;
     rtvd.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D;
     rtvd.Texture2D.MipSlice = mipSlice;
     
-    ID3D11RenderTargetView* rtv;
-    HRESULT hr{ DeviceManager::device->CreateRenderTargetView(texture, &rtvd, &rtv) };
-    if (FAILED(hr)) {
+    const RenderTargetViewHandle rtv{ CreateView<ID3D11RenderTargetView>(texture, &rtvd) };
+    if (rtv.IsNull()) {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_2D_RENDER_TARGET_VIEW::FAILED_TO_CREATE_RENDER_TARGET_VIEW" << std::endl;
-        return nullptr;
+        return {};
     }
-    resourceViews.push_back(rtv);
     return rtv;
 }
 
-ID3D11DepthStencilView* ResourceManager::CreateTexture2DDepthStencilView(ID3D11Texture2D* texture, UINT mipSlice, DXGI_FORMAT format)
+DepthStencilViewHandle ResourceManager::CreateTexture2DDepthStencilView(Texture2DHandle textureHandle, UINT mipSlice, DXGI_FORMAT format)
 {
-    D3D11_DEPTH_STENCIL_VIEW_DESC dsvd;
+    PROFILE_FUNCTION();
+    ID3D11Texture2D* texture{ Get(textureHandle) };
+    if (!texture)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_2D_DEPTH_STENCIL_VIEW::INVALID_TEXTURE_HANDLE" << std::endl;
+        return {};
+    }
+
+    D3D11_DEPTH_STENCIL_VIEW_DESC dsvd{};
     dsvd.Format = format;
     dsvd.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
     dsvd.Texture2D.MipSlice = mipSlice;
     
-    ID3D11DepthStencilView* dsv;
-    HRESULT hr{ DeviceManager::device->CreateDepthStencilView(texture, &dsvd, &dsv) };
-    if (FAILED(hr)) {
+    const DepthStencilViewHandle dsv{ CreateView<ID3D11DepthStencilView>(texture, &dsvd) };
+    if (dsv.IsNull()) {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_2D_DEPTH_STENCIL_VIEW::FAILED_TO_CREATE_DEPTH_STENCIL_VIEW" << std::endl;
-        return nullptr;
+        return {};
     }
-    resourceViews.push_back(dsv);
     return dsv;
 }
 
-ID3D11ShaderResourceView* ResourceManager::CreateTexture2DShaderResourceView(ID3D11Texture2D* texture, UINT mostDetailedMipSlice, UINT mipLevels, DXGI_FORMAT format)
+ShaderResourceViewHandle ResourceManager::CreateTexture2DShaderResourceView(Texture2DHandle textureHandle, UINT mostDetailedMipSlice, UINT mipLevels, DXGI_FORMAT format)
 {
-    D3D11_SHADER_RESOURCE_VIEW_DESC srvd;
+    PROFILE_FUNCTION();
+    ID3D11Texture2D* texture{ Get(textureHandle) };
+    if (!texture)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_2D_SHADER_RESOURCE_VIEW::INVALID_TEXTURE_HANDLE" << std::endl;
+        return {};
+    }
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvd{};
     srvd.Format = format;
     srvd.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
     srvd.Texture1D.MostDetailedMip = mostDetailedMipSlice;
     srvd.Texture2D.MipLevels = mipLevels;
 
-    ID3D11ShaderResourceView* srv;
-    HRESULT hr{ DeviceManager::device->CreateShaderResourceView(texture, &srvd, &srv) };
-    if (FAILED(hr))
+    const ShaderResourceViewHandle srv{ CreateView<ID3D11ShaderResourceView>(texture, &srvd) };
+    if (srv.IsNull())
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_2D_SHADER_RESOURCE_VIEW::FAILED_TO_CREATE_SHADER_RESOURCE_VIEW" << std::endl;
-        return nullptr;
+        return {};
     }
-    resourceViews.push_back(srv);
     return srv;
 }
 
-ID3D11UnorderedAccessView* ResourceManager::CreateTexture2DUnorderedAccessView(ID3D11Texture2D* texture, UINT mipSlice, DXGI_FORMAT format)
+UnorderedAccessViewHandle ResourceManager::CreateTexture2DUnorderedAccessView(Texture2DHandle textureHandle, UINT mipSlice, DXGI_FORMAT format)
 {
-    D3D11_UNORDERED_ACCESS_VIEW_DESC uavd;
+    PROFILE_FUNCTION();
+    ID3D11Texture2D* texture{ Get(textureHandle) };
+    if (!texture)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_2D_UNORDERED_ACCESS_VIEW::INVALID_TEXTURE_HANDLE" << std::endl;
+        return {};
+    }
+
+    D3D11_UNORDERED_ACCESS_VIEW_DESC uavd{};
     uavd.Format = format;
     uavd.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE2D;
     uavd.Texture2D.MipSlice = mipSlice;
 
-    ID3D11UnorderedAccessView* uav;
-    HRESULT hr{ DeviceManager::device->CreateUnorderedAccessView(texture, &uavd, &uav) };
-    if (FAILED(hr))
+    const UnorderedAccessViewHandle uav{ CreateView<ID3D11UnorderedAccessView>(texture, &uavd) };
+    if (uav.IsNull())
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_2D_UNORDERED_ACCESS_VIEW::FAILED_TO_CREATE_UNORDERED_ACCESS_VIEW" << std::endl;
-        return nullptr;
+        return {};
     }
-    resourceViews.push_back(uav);
     return uav;
 }
 
-ID3D11RenderTargetView* ResourceManager::CreateTexture2DArrayRenderTargetView(ID3D11Texture2D* texture, UINT mipSlice, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format)
+RenderTargetViewHandle ResourceManager::CreateTexture2DArrayRenderTargetView(Texture2DHandle textureHandle, UINT mipSlice, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format)
 {
-    D3D11_RENDER_TARGET_VIEW_DESC rtvd;
+    PROFILE_FUNCTION();
+    ID3D11Texture2D* texture{ Get(textureHandle) };
+    if (!texture)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_2D_ARRAY_RENDER_TARGET_VIEW::INVALID_TEXTURE_HANDLE" << std::endl;
+        return {};
+    }
+
+    D3D11_RENDER_TARGET_VIEW_DESC rtvd{};
     rtvd.Format = format;
     rtvd.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2DARRAY;
     rtvd.Texture2DArray.MipSlice = mipSlice;
     rtvd.Texture2DArray.FirstArraySlice = firstArraySlice;
     rtvd.Texture2DArray.ArraySize = arraySlices;
     
-    ID3D11RenderTargetView* rtv;
-    HRESULT hr{ DeviceManager::device->CreateRenderTargetView(texture, &rtvd, &rtv) };
-    if (FAILED(hr)) {
+    const RenderTargetViewHandle rtv{ CreateView<ID3D11RenderTargetView>(texture, &rtvd) };
+    if (rtv.IsNull()) {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_2D_ARRAY_RENDER_TARGET_VIEW::FAILED_TO_CREATE_RENDER_TARGET_VIEW" << std::endl;
-        return nullptr;
+        return {};
     }
-    resourceViews.push_back(rtv);
     return rtv;
 }
 
-ID3D11DepthStencilView* ResourceManager::CreateTexture2DArrayDepthStencilView(ID3D11Texture2D* texture, UINT mipSlice, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format)
+DepthStencilViewHandle ResourceManager::CreateTexture2DArrayDepthStencilView(Texture2DHandle textureHandle, UINT mipSlice, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format)
 {
-    D3D11_DEPTH_STENCIL_VIEW_DESC dsvd;
+    PROFILE_FUNCTION();
+    ID3D11Texture2D* texture{ Get(textureHandle) };
+    if (!texture)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_2D_ARRAY_DEPTH_STENCIL_VIEW::INVALID_TEXTURE_HANDLE" << std::endl;
+        return {};
+    }
+
+    D3D11_DEPTH_STENCIL_VIEW_DESC dsvd{};
     dsvd.Format = format;
     dsvd.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2DARRAY;
-    dsvd.Texture2D.MipSlice = mipSlice;
+    dsvd.Texture2DArray.MipSlice = mipSlice;
+    dsvd.Texture2DArray.FirstArraySlice = firstArraySlice;
+    dsvd.Texture2DArray.ArraySize = arraySlices;
     
-    ID3D11DepthStencilView* dsv;
-    HRESULT hr{ DeviceManager::device->CreateDepthStencilView(texture, &dsvd, &dsv) };
-    if (FAILED(hr)) {
+    const DepthStencilViewHandle dsv{ CreateView<ID3D11DepthStencilView>(texture, &dsvd) };
+    if (dsv.IsNull()) {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_2D_ARRAY_DEPTH_STENCIL_VIEW::FAILED_TO_CREATE_DEPTH_STENCIL_VIEW" << std::endl;
-        return nullptr;
+        return {};
     }
-    resourceViews.push_back(dsv);
     return dsv;
 }
 
-ID3D11ShaderResourceView* ResourceManager::CreateTexture2DArrayShaderResourceView(ID3D11Texture2D* texture, UINT mostDetailedMipSlice, UINT mipLevels, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format)
+ShaderResourceViewHandle ResourceManager::CreateTexture2DArrayShaderResourceView(Texture2DHandle textureHandle, UINT mostDetailedMipSlice, UINT mipLevels, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format)
 {
-    D3D11_SHADER_RESOURCE_VIEW_DESC srvd;
+    PROFILE_FUNCTION();
+    ID3D11Texture2D* texture{ Get(textureHandle) };
+    if (!texture)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_2D_ARRAY_SHADER_RESOURCE_VIEW::INVALID_TEXTURE_HANDLE" << std::endl;
+        return {};
+    }
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvd{};
     srvd.Format = format;
     srvd.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
     srvd.Texture2DArray.MostDetailedMip = mostDetailedMipSlice;
@@ -862,88 +1330,110 @@ ID3D11ShaderResourceView* ResourceManager::CreateTexture2DArrayShaderResourceVie
     srvd.Texture2DArray.FirstArraySlice = firstArraySlice;
     srvd.Texture2DArray.ArraySize = arraySlices;
 
-    ID3D11ShaderResourceView* srv;
-    HRESULT hr{ DeviceManager::device->CreateShaderResourceView(texture, &srvd, &srv) };
-    if (FAILED(hr))
+    const ShaderResourceViewHandle srv{ CreateView<ID3D11ShaderResourceView>(texture, &srvd) };
+    if (srv.IsNull())
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_2D_ARRAY_SHADER_RESOURCE_VIEW::FAILED_TO_CREATE_SHADER_RESOURCE_VIEW" << std::endl;
-        return nullptr;
+        return {};
     }
-    resourceViews.push_back(srv);
     return srv;
 }
 
-ID3D11UnorderedAccessView* ResourceManager::CreateTexture2DArrayUnorderedAccessView(ID3D11Texture2D* texture, UINT mipSlice, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format)
+UnorderedAccessViewHandle ResourceManager::CreateTexture2DArrayUnorderedAccessView(Texture2DHandle textureHandle, UINT mipSlice, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format)
 {
-    D3D11_UNORDERED_ACCESS_VIEW_DESC uavd;
+    PROFILE_FUNCTION();
+    ID3D11Texture2D* texture{ Get(textureHandle) };
+    if (!texture)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_2D_ARRAY_UNORDERED_ACCESS_VIEW::INVALID_TEXTURE_HANDLE" << std::endl;
+        return {};
+    }
+
+    D3D11_UNORDERED_ACCESS_VIEW_DESC uavd{};
     uavd.Format = format;
     uavd.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE2DARRAY;
     uavd.Texture2DArray.MipSlice = mipSlice;
     uavd.Texture2DArray.FirstArraySlice = firstArraySlice;
     uavd.Texture2DArray.ArraySize = arraySlices;
 
-    ID3D11UnorderedAccessView* uav;
-    HRESULT hr{ DeviceManager::device->CreateUnorderedAccessView(texture, &uavd, &uav) };
-    if (FAILED(hr))
+    const UnorderedAccessViewHandle uav{ CreateView<ID3D11UnorderedAccessView>(texture, &uavd) };
+    if (uav.IsNull())
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_2D_ARRAY_UNORDERED_ACCESS_VIEW::FAILED_TO_CREATE_UNORDERED_ACCESS_VIEW" << std::endl;
-        return nullptr;
+        return {};
     }
-    resourceViews.push_back(uav);
     return uav;
 }
 
-ID3D11RenderTargetView* ResourceManager::CreateTexture3DRenderTargetView(ID3D11Texture3D* texture, UINT mipSlice, DXGI_FORMAT format)
+RenderTargetViewHandle ResourceManager::CreateTexture3DRenderTargetView(Texture3DHandle textureHandle, UINT mipSlice, DXGI_FORMAT format)
 {
-    D3D11_RENDER_TARGET_VIEW_DESC rtvd;
+    PROFILE_FUNCTION();
+    ID3D11Texture3D* texture{ Get(textureHandle) };
+    if (!texture)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_3D_RENDER_TARGET_VIEW::INVALID_TEXTURE_HANDLE" << std::endl;
+        return {};
+    }
+
+    D3D11_RENDER_TARGET_VIEW_DESC rtvd{};
     rtvd.Format = format;
     rtvd.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE3D;
     rtvd.Texture3D.MipSlice = mipSlice;
     
-    ID3D11RenderTargetView* rtv;
-    HRESULT hr{ DeviceManager::device->CreateRenderTargetView(texture, &rtvd, &rtv) };
-    if (FAILED(hr)) {
+    const RenderTargetViewHandle rtv{ CreateView<ID3D11RenderTargetView>(texture, &rtvd) };
+    if (rtv.IsNull()) {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_3D_RENDER_TARGET_VIEW::FAILED_TO_CREATE_RENDER_TARGET_VIEW" << std::endl;
-        return nullptr;
+        return {};
     }
-    resourceViews.push_back(rtv);
     return rtv;
 }
 
-ID3D11ShaderResourceView* ResourceManager::CreateTexture3DShaderResourceView(ID3D11Texture3D* texture, UINT mostDetailedMipSlice, UINT mipLevels, DXGI_FORMAT format)
+ShaderResourceViewHandle ResourceManager::CreateTexture3DShaderResourceView(Texture3DHandle textureHandle, UINT mostDetailedMipSlice, UINT mipLevels, DXGI_FORMAT format)
 {
-    D3D11_SHADER_RESOURCE_VIEW_DESC srvd;
+    PROFILE_FUNCTION();
+    ID3D11Texture3D* texture{ Get(textureHandle) };
+    if (!texture)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_3D_SHADER_RESOURCE_VIEW::INVALID_TEXTURE_HANDLE" << std::endl;
+        return {};
+    }
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvd{};
     srvd.Format = format;
     srvd.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE3D;
     srvd.Texture3D.MostDetailedMip = mostDetailedMipSlice;
     srvd.Texture3D.MipLevels = mipLevels;
 
-    ID3D11ShaderResourceView* srv;
-    HRESULT hr{ DeviceManager::device->CreateShaderResourceView(texture, &srvd, &srv) };
-    if (FAILED(hr))
+    const ShaderResourceViewHandle srv{ CreateView<ID3D11ShaderResourceView>(texture, &srvd) };
+    if (srv.IsNull())
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_3D_SHADER_RESOURCE_VIEW::FAILED_TO_CREATE_SHADER_RESOURCE_VIEW" << std::endl;
-        return nullptr;
+        return {};
     }
-    resourceViews.push_back(srv);
     return srv;
 }
 
-ID3D11UnorderedAccessView* ResourceManager::CreateTexture3DUnorderedAccessView(ID3D11Texture3D* texture, UINT mipSlice, DXGI_FORMAT format)
+UnorderedAccessViewHandle ResourceManager::CreateTexture3DUnorderedAccessView(Texture3DHandle textureHandle, UINT mipSlice, DXGI_FORMAT format)
 {
-    D3D11_UNORDERED_ACCESS_VIEW_DESC uavd;
+    PROFILE_FUNCTION();
+    ID3D11Texture3D* texture{ Get(textureHandle) };
+    if (!texture)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_3D_UNORDERED_ACCESS_VIEW::INVALID_TEXTURE_HANDLE" << std::endl;
+        return {};
+    }
+
+    D3D11_UNORDERED_ACCESS_VIEW_DESC uavd{};
     uavd.Format = format;
     uavd.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE3D;
     uavd.Texture3D.MipSlice = mipSlice;
 
-    ID3D11UnorderedAccessView* uav;
-    HRESULT hr{ DeviceManager::device->CreateUnorderedAccessView(texture, &uavd, &uav) };
-    if (FAILED(hr))
+    const UnorderedAccessViewHandle uav{ CreateView<ID3D11UnorderedAccessView>(texture, &uavd) };
+    if (uav.IsNull())
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_TEXTURE_3D_UNORDERED_ACCESS_VIEW::FAILED_TO_CREATE_UNORDERED_ACCESS_VIEW" << std::endl;
-        return nullptr;
+        return {};
     }
-    resourceViews.push_back(uav);
     return uav;
 }
 //----------------------------------------------//
@@ -952,21 +1442,159 @@ ID3D11UnorderedAccessView* ResourceManager::CreateTexture3DUnorderedAccessView(I
 
 
 
+//-----------------------------------------------//
+//-----------------MESH LOADING------------------//
+//-----------------------------------------------//
+//A stream lies inside the file, is aligned and holds exactly count elements of elementSize bytes
+static bool IsValidMeshStream(const MeshFileStream& stream, UINT64 fileSize, UINT64 count, UINT64 elementSize)
+{
+    return stream.offset % MESH_FILE_ALIGNMENT == 0 && stream.offset <= fileSize && stream.size <= fileSize - stream.offset
+        && stream.size == count * elementSize && stream.size <= 0xFFFFFFFF;
+}
+
+bool ResourceManager::LoadMesh(const char* path, Mesh& mesh)
+{
+    PROFILE_FUNCTION();
+    mesh = {};
+    MappedFile file;
+    if (!path || !file.Open(path))
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::LOAD_MESH::FAILED_TO_MAP_FILE" << std::endl;
+        return false;
+    }
+
+    //The header is copied out, since nothing guarantees the mapping suits its alignment on every platform
+    MeshFileHeader header;
+    if (file.GetSize() < sizeof(header))
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::LOAD_MESH::FILE_TOO_SMALL" << std::endl;
+        return false;
+    }
+    std::memcpy(&header, file.GetData(), sizeof(header));
+
+    const UINT indexSize{ (header.indexFormat == DXGI_FORMAT_R16_UINT) ? (2u) : (4u) };
+    bool valid{ header.magic == MESH_FILE_MAGIC && header.version == MESH_FILE_VERSION };
+    valid = valid && header.lodCount > 0 && header.lodCount <= MESH_MAX_LODS && header.vertexStride > 0 && header.vertexCount > 0 && header.indexCount > 0;
+    valid = valid && (header.indexFormat == DXGI_FORMAT_R16_UINT || header.indexFormat == DXGI_FORMAT_R32_UINT);
+    valid = valid && IsValidMeshStream(header.vertices, file.GetSize(), header.vertexCount, header.vertexStride);
+    valid = valid && IsValidMeshStream(header.indices, file.GetSize(), header.indexCount, indexSize);
+    valid = valid && IsValidMeshStream(header.meshlets, file.GetSize(), header.meshletCount, sizeof(MeshFileMeshlet));
+    valid = valid && IsValidMeshStream(header.meshletVertices, file.GetSize(), header.meshletVertexCount, sizeof(UINT));
+    valid = valid && IsValidMeshStream(header.meshletTriangles, file.GetSize(), header.meshletTriangleCount, sizeof(UINT));
+    for (UINT i{ 0 }; valid && i < header.lodCount; ++i)
+    {
+        const MeshFileLod& lod{ header.lods[i] };
+        valid = static_cast<UINT64>(lod.startIndex) + lod.indexCount <= header.indexCount
+             && static_cast<UINT64>(lod.startMeshlet) + lod.meshletCount <= header.meshletCount
+             && lod.baseVertexLocation >= 0 && static_cast<UINT64>(lod.baseVertexLocation) + lod.vertexCount <= header.vertexCount;
+    }
+    if (!valid)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::LOAD_MESH::INVALID_MESH_FILE" << std::endl;
+        return false;
+    }
+
+    //Immutable buffers copy their initial data on creation, so the mapping can go as soon as they exist
+    const auto streamData{ [&file](const MeshFileStream& stream) { return D3D11_SUBRESOURCE_DATA{ file.GetData() + stream.offset, 0, 0 }; } };
+    D3D11_SUBRESOURCE_DATA vertices{ streamData(header.vertices) };
+    D3D11_SUBRESOURCE_DATA indices{ streamData(header.indices) };
+    mesh.vertexBuffer = CreateVertexBuffer(static_cast<UINT>(header.vertices.size), false, false, &vertices);
+    mesh.indexBuffer = CreateIndexBuffer(static_cast<UINT>(header.indices.size), false, &indices);
+    bool created{ !mesh.vertexBuffer.IsNull() && !mesh.indexBuffer.IsNull() };
+    if (created && header.meshletCount > 0)
+    {
+        D3D11_SUBRESOURCE_DATA meshlets{ streamData(header.meshlets) };
+        D3D11_SUBRESOURCE_DATA meshletVertices{ streamData(header.meshletVertices) };
+        D3D11_SUBRESOURCE_DATA meshletTriangles{ streamData(header.meshletTriangles) };
+        mesh.meshletBuffer = CreateStructuredBuffer(header.meshletCount, sizeof(MeshFileMeshlet), false, false, &meshlets);
+        mesh.meshletVertexBuffer = CreateStructuredBuffer(header.meshletVertexCount, sizeof(UINT), false, false, &meshletVertices);
+        mesh.meshletTriangleBuffer = CreateStructuredBuffer(header.meshletTriangleCount, sizeof(UINT), false, false, &meshletTriangles);
+        created = !mesh.meshletBuffer.IsNull() && !mesh.meshletVertexBuffer.IsNull() && !mesh.meshletTriangleBuffer.IsNull();
+    }
+    if (!created)
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::LOAD_MESH::FAILED_TO_CREATE_BUFFERS" << std::endl;
+        ReleaseMesh(mesh);
+        return false;
+    }
+
+    mesh.vertexAttributes = header.vertexAttributes;
+    mesh.vertexStride = header.vertexStride;
+    mesh.indexFormat = static_cast<DXGI_FORMAT>(header.indexFormat);
+    mesh.lodCount = header.lodCount;
+    std::memcpy(mesh.lods, header.lods, sizeof(mesh.lods));
+    std::memcpy(mesh.boundsMin, header.boundsMin, sizeof(mesh.boundsMin));
+    std::memcpy(mesh.boundsMax, header.boundsMax, sizeof(mesh.boundsMax));
+    std::memcpy(mesh.boundsCentre, header.boundsCentre, sizeof(mesh.boundsCentre));
+    mesh.boundsRadius = header.boundsRadius;
+    return true;
+}
+
+void ResourceManager::ReleaseMesh(Mesh& mesh)
+{
+    Release(mesh.vertexBuffer);
+    Release(mesh.indexBuffer);
+    Release(mesh.meshletBuffer);
+    Release(mesh.meshletVertexBuffer);
+    Release(mesh.meshletTriangleBuffer);
+    mesh = {};
+}
+//-----------------------------------------------//
+//--------------END OF MESH LOADING--------------//
+//-----------------------------------------------//
+
+
+
 //----------------------------------------------//
-//---------------SAMPLER CREATION---------------//
+//----------------STATE CREATION----------------//
 //----------------------------------------------//
-ID3D11SamplerState* ResourceManager::CreateSamplerState(D3D11_SAMPLER_DESC samplerDesc)
+SamplerStateHandle ResourceManager::CreateSamplerState(D3D11_SAMPLER_DESC samplerDesc)
 {
-    ID3D11SamplerState* ss;
-    HRESULT hr{ DeviceManager::device->CreateSamplerState(&samplerDesc, &ss) };
-    if (FAILED(hr))
+    PROFILE_FUNCTION();
+    const SamplerStateHandle ss{ CreateState<ID3D11SamplerState>(samplerDesc) };
+    if (ss.IsNull())
     {
         std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_SAMPLER_STATE::FAILED_TO_CREATE_SAMPLER_STATE" << std::endl;
-        return nullptr;
+        return {};
     }
-    samplerStates.push_back(ss);
     return ss;
 }
-//---------------------------------------------//
-//-----------END OF SAMPLER CREATION-----------//
-//---------------------------------------------//
\ No newline at end of file
+
+BlendStateHandle ResourceManager::CreateBlendState(const D3D11_BLEND_DESC& blendDesc)
+{
+    PROFILE_FUNCTION();
+    const BlendStateHandle bs{ CreateState<ID3D11BlendState>(blendDesc) };
+    if (bs.IsNull())
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_BLEND_STATE::FAILED_TO_CREATE_BLEND_STATE" << std::endl;
+        return {};
+    }
+    return bs;
+}
+
+RasterizerStateHandle ResourceManager::CreateRasterizerState(const D3D11_RASTERIZER_DESC& rasterizerDesc)
+{
+    PROFILE_FUNCTION();
+    const RasterizerStateHandle rs{ CreateState<ID3D11RasterizerState>(rasterizerDesc) };
+    if (rs.IsNull())
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_RASTERIZER_STATE::FAILED_TO_CREATE_RASTERIZER_STATE" << std::endl;
+        return {};
+    }
+    return rs;
+}
+
+DepthStencilStateHandle ResourceManager::CreateDepthStencilState(const D3D11_DEPTH_STENCIL_DESC& depthStencilDesc)
+{
+    PROFILE_FUNCTION();
+    const DepthStencilStateHandle dss{ CreateState<ID3D11DepthStencilState>(depthStencilDesc) };
+    if (dss.IsNull())
+    {
+        std::cerr << "ERROR::RESOURCE_MANAGER::CREATE_DEPTH_STENCIL_STATE::FAILED_TO_CREATE_DEPTH_STENCIL_STATE" << std::endl;
+        return {};
+    }
+    return dss;
+}
+//----------------------------------------------//
+//------------END OF STATE CREATION-------------//
+//----------------------------------------------//
\ No newline at end of file
@@ -1,6 +1,53 @@
 ﻿#pragma once
 #include <d3d11.h>
-#include <vector>
+#include <type_traits>
+#include <unordered_map>
+
+#include "../Utility/Handle.h"
+#include "../Utility/MeshFormat.h"
+#include "../Utility/ResourcePool.h"
+#include "../Utility/StateCache.h"
+#include "../Utility/ViewCache.h"
+
+using BufferHandle = Handle<ID3D11Buffer>;
+using Texture1DHandle = Handle<ID3D11Texture1D>;
+using Texture2DHandle = Handle<ID3D11Texture2D>;
+using Texture3DHandle = Handle<ID3D11Texture3D>;
+using ShaderResourceViewHandle = Handle<ID3D11ShaderResourceView>;
+using UnorderedAccessViewHandle = Handle<ID3D11UnorderedAccessView>;
+using RenderTargetViewHandle = Handle<ID3D11RenderTargetView>;
+using DepthStencilViewHandle = Handle<ID3D11DepthStencilView>;
+using SamplerStateHandle = Handle<ID3D11SamplerState>;
+using BlendStateHandle = Handle<ID3D11BlendState>;
+using RasterizerStateHandle = Handle<ID3D11RasterizerState>;
+using DepthStencilStateHandle = Handle<ID3D11DepthStencilState>;
+
+//Buffers and metadata of a mesh file (see MeshFormat.h) loaded by ResourceManager::LoadMesh()
+struct Mesh
+{
+    BufferHandle vertexBuffer;
+    BufferHandle indexBuffer;
+    //Structured buffers of MeshFileMeshlet, vertex indices and packed triangles for GPU meshlet culling - null if the file has no meshlets
+    BufferHandle meshletBuffer;
+    BufferHandle meshletVertexBuffer;
+    BufferHandle meshletTriangleBuffer;
+
+    UINT vertexAttributes;   //MESH_VERTEX_ATTRIBUTE flags
+    UINT vertexStride;
+    DXGI_FORMAT indexFormat;
+    UINT lodCount;
+    MeshFileLod lods[MESH_MAX_LODS];
+
+    float boundsMin[3];
+    float boundsMax[3];
+    float boundsCentre[3];
+    float boundsRadius;
+};
+
+struct ResourceDescription
+{
+    UINT64 poolBudget; //Bytes of released resources kept for reuse - 0 selects the default (see ResourceManager::SetPoolBudget())
+};
 
 class ResourceManager
 {
@@ -10,67 +57,172 @@ public:
     ResourceManager() = default;
     ~ResourceManager() = default;
 
-    static ID3D11Texture2D* GetActiveSwapchainTexture();
-    static ID3D11Texture2D* CreateDepthStencilTexture();
+    //----Handles----//
+    //Object behind a handle for binding, or nullptr if the handle is null or stale (its object has been released)
+    template<typename T>
+    [[nodiscard]] static T* Get(Handle<T> handle) { return GetPool<T>().Get(handle); }
+    //Releases the object immediately and invalidates the handle (and any copies of it)
+    //Views keep their resource alive, so a released resource is only destroyed once its views are released too
+    //Views and states are shared between identical Create*() calls, so their handles stay valid until each of those calls' handles is released
+    //Buffers and textures created without initial data (and not immutable) go back to the resource pool instead, once every view
+    //created on them has been released too - later creations with an identical description reuse them, with undefined contents
+    template<typename T>
+    static void Release(Handle<T> handle);
+
+    [[nodiscard]] static Texture2DHandle GetActiveSwapchainTexture();
+    [[nodiscard]] static Texture2DHandle CreateDepthStencilTexture();
+    //Single-mip, default-usage texture for render passes - bindFlags may combine RENDER_TARGET, DEPTH_STENCIL, SHADER_RESOURCE and UNORDERED_ACCESS
+    [[nodiscard]] static Texture2DHandle CreateRenderTexture2D(UINT width, UINT height, DXGI_FORMAT format, UINT bindFlags);
+    //Default-usage, shader resource only texture filled with UpdateSubresource()/CopySubresourceRegion() and clamped with SetResourceMinLOD()
+    //Used by the texture streamer (see TextureStreamer.h) - block compressed formats are allowed, so the mip chain may end above 1x1
+    [[nodiscard]] static Texture2DHandle CreateStreamingTexture2D(UINT width, UINT height, UINT mipLevels, DXGI_FORMAT format);
+    //Single-mip, CPU readable copy target - map it with D3D11_MAP_READ only once the GPU has written it (see ReadbackQueue.h)
+    [[nodiscard]] static Texture2DHandle CreateStagingTexture2D(UINT width, UINT height, DXGI_FORMAT format);
 
     
     //----Buffers----//
-    [[nodiscard]] static ID3D11Buffer* CreateVertexBuffer(UINT size, bool dynamic, bool streamout, D3D11_SUBRESOURCE_DATA* pData);
-    [[nodiscard]] static ID3D11Buffer* CreateIndexBuffer(UINT size, bool dynamic, D3D11_SUBRESOURCE_DATA* pData);
-    [[nodiscard]] static ID3D11Buffer* CreateConstantBuffer(UINT size, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData);
-    [[nodiscard]] static ID3D11Buffer* CreateStructuredBuffer(UINT count, UINT structSize, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData);
-    [[nodiscard]] static ID3D11Buffer* CreateAppendConsumeBuffer(UINT count, UINT structSize, D3D11_SUBRESOURCE_DATA* pData);
-    [[nodiscard]] static ID3D11Buffer* CreateRawBuffer(UINT size, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData);
-    [[nodiscard]] static ID3D11Buffer* CreateIndirectArgsBuffer(UINT size, D3D11_SUBRESOURCE_DATA* pData);
+    [[nodiscard]] static BufferHandle CreateVertexBuffer(UINT size, bool dynamic, bool streamout, D3D11_SUBRESOURCE_DATA* pData);
+    [[nodiscard]] static BufferHandle CreateIndexBuffer(UINT size, bool dynamic, D3D11_SUBRESOURCE_DATA* pData);
+    [[nodiscard]] static BufferHandle CreateConstantBuffer(UINT size, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData);
+    [[nodiscard]] static BufferHandle CreateStructuredBuffer(UINT count, UINT structSize, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData);
+    [[nodiscard]] static BufferHandle CreateAppendConsumeBuffer(UINT count, UINT structSize, D3D11_SUBRESOURCE_DATA* pData);
+    [[nodiscard]] static BufferHandle CreateRawBuffer(UINT size, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData);
+    [[nodiscard]] static BufferHandle CreateIndirectArgsBuffer(UINT size, D3D11_SUBRESOURCE_DATA* pData);
+    //CPU readable copy target, as CreateStagingTexture2D()
+    [[nodiscard]] static BufferHandle CreateStagingBuffer(UINT size);
 
-    [[nodiscard]] static ID3D11ShaderResourceView* CreateBufferShaderResourceView(ID3D11Buffer* pResource, UINT offset, UINT count, DXGI_FORMAT format, UINT flags=0);
-    [[nodiscard]] static ID3D11UnorderedAccessView* CreateBufferUnorderedAccessView(ID3D11Buffer* pResource, UINT offset, UINT count, DXGI_FORMAT format, UINT flags=0);
+    [[nodiscard]] static ShaderResourceViewHandle CreateBufferShaderResourceView(BufferHandle buffer, UINT offset, UINT count, DXGI_FORMAT format, UINT flags=0);
+    [[nodiscard]] static UnorderedAccessViewHandle CreateBufferUnorderedAccessView(BufferHandle buffer, UINT offset, UINT count, DXGI_FORMAT format, UINT flags=0);
 
 
     //----Textures----//
-    [[nodiscard]] static ID3D11Texture1D* CreateTexture1D(UINT width, UINT mipLevels, DXGI_FORMAT format, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData);
-    [[nodiscard]] static ID3D11Texture1D* CreateTexture1DArray(UINT width, UINT mipLevels, UINT arraySize, DXGI_FORMAT format, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData);
-    [[nodiscard]] static ID3D11Texture2D* CreateTexture2D(UINT width, UINT height, UINT mipLevels, DXGI_FORMAT format, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData);
-    [[nodiscard]] static ID3D11Texture2D* CreateTexture2DArray(UINT width, UINT height, UINT mipLevels, UINT arraySize, DXGI_FORMAT format, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData);
-    [[nodiscard]] static ID3D11Texture3D* CreateTexture3D(UINT width, UINT height, UINT depth, UINT mipLevels, DXGI_FORMAT format, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData);
+    //pData holds every mip of every slice - chains are generated at import (see Utility/TextureProcessing.h), not at load
+    [[nodiscard]] static Texture1DHandle CreateTexture1D(UINT width, UINT mipLevels, DXGI_FORMAT format, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData);
+    [[nodiscard]] static Texture1DHandle CreateTexture1DArray(UINT width, UINT mipLevels, UINT arraySize, DXGI_FORMAT format, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData);
+    [[nodiscard]] static Texture2DHandle CreateTexture2D(UINT width, UINT height, UINT mipLevels, DXGI_FORMAT format, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData);
+    [[nodiscard]] static Texture2DHandle CreateTexture2DArray(UINT width, UINT height, UINT mipLevels, UINT arraySize, DXGI_FORMAT format, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData);
+    [[nodiscard]] static Texture3DHandle CreateTexture3D(UINT width, UINT height, UINT depth, UINT mipLevels, DXGI_FORMAT format, bool CPUWriteable, bool GPUWriteable, D3D11_SUBRESOURCE_DATA* pData);
     
-    [[nodiscard]] static ID3D11RenderTargetView* CreateTexture1DRenderTargetView(ID3D11Texture1D* texture, UINT mipSlice, DXGI_FORMAT format);
-    [[nodiscard]] static ID3D11DepthStencilView* CreateTexture1DDepthStencilView(ID3D11Texture1D* texture, UINT mipSlice, DXGI_FORMAT format);
-    [[nodiscard]] static ID3D11ShaderResourceView* CreateTexture1DShaderResourceView(ID3D11Texture1D* texture, UINT mostDetailedMipSlice, UINT mipLevels, DXGI_FORMAT format);
-    [[nodiscard]] static ID3D11UnorderedAccessView* CreateTexture1DUnorderedAccessView(ID3D11Texture1D* texture, UINT mipSlice, DXGI_FORMAT format);
-    [[nodiscard]] static ID3D11RenderTargetView* CreateTexture1DArrayRenderTargetView(ID3D11Texture1D* texture, UINT mipSlice, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format);
-    [[nodiscard]] static ID3D11DepthStencilView* CreateTexture1DArrayDepthStencilView(ID3D11Texture1D* texture, UINT mipSlice, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format);
-    [[nodiscard]] static ID3D11ShaderResourceView* CreateTexture1DArrayShaderResourceView(ID3D11Texture1D* texture, UINT mostDetailedMipSlice, UINT mipLevels, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format);
-    [[nodiscard]] static ID3D11UnorderedAccessView* CreateTexture1DArrayUnorderedAccessView(ID3D11Texture1D* texture, UINT mipSlice, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format);
-    [[nodiscard]] static ID3D11RenderTargetView* CreateTexture2DRenderTargetView(ID3D11Texture2D* texture, UINT mipSlice, DXGI_FORMAT format);
-    [[nodiscard]] static ID3D11DepthStencilView* CreateTexture2DDepthStencilView(ID3D11Texture2D* texture, UINT mipSlice, DXGI_FORMAT format);
-    [[nodiscard]] static ID3D11ShaderResourceView* CreateTexture2DShaderResourceView(ID3D11Texture2D* texture, UINT mostDetailedMipSlice, UINT mipLevels, DXGI_FORMAT format);
-    [[nodiscard]] static ID3D11UnorderedAccessView* CreateTexture2DUnorderedAccessView(ID3D11Texture2D* texture, UINT mipSlice, DXGI_FORMAT format);
-    [[nodiscard]] static ID3D11RenderTargetView* CreateTexture2DArrayRenderTargetView(ID3D11Texture2D* texture, UINT mipSlice, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format);
-    [[nodiscard]] static ID3D11DepthStencilView* CreateTexture2DArrayDepthStencilView(ID3D11Texture2D* texture, UINT mipSlice, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format);
-    [[nodiscard]] static ID3D11ShaderResourceView* CreateTexture2DArrayShaderResourceView(ID3D11Texture2D* texture, UINT mostDetailedMipSlice, UINT mipLevels, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format);
-    [[nodiscard]] static ID3D11UnorderedAccessView* CreateTexture2DArrayUnorderedAccessView(ID3D11Texture2D* texture, UINT mipSlice, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format);
-    [[nodiscard]] static ID3D11RenderTargetView* CreateTexture3DRenderTargetView(ID3D11Texture3D* texture, UINT mipSlice, DXGI_FORMAT format);
-    [[nodiscard]] static ID3D11ShaderResourceView* CreateTexture3DShaderResourceView(ID3D11Texture3D* texture, UINT mostDetailedMipSlice, UINT mipLevels, DXGI_FORMAT format);
-    [[nodiscard]] static ID3D11UnorderedAccessView* CreateTexture3DUnorderedAccessView(ID3D11Texture3D* texture, UINT mipSlice, DXGI_FORMAT format);
+    [[nodiscard]] static RenderTargetViewHandle CreateTexture1DRenderTargetView(Texture1DHandle texture, UINT mipSlice, DXGI_FORMAT format);
+    [[nodiscard]] static DepthStencilViewHandle CreateTexture1DDepthStencilView(Texture1DHandle texture, UINT mipSlice, DXGI_FORMAT format);
+    [[nodiscard]] static ShaderResourceViewHandle CreateTexture1DShaderResourceView(Texture1DHandle texture, UINT mostDetailedMipSlice, UINT mipLevels, DXGI_FORMAT format);
+    [[nodiscard]] static UnorderedAccessViewHandle CreateTexture1DUnorderedAccessView(Texture1DHandle texture, UINT mipSlice, DXGI_FORMAT format);
+    [[nodiscard]] static RenderTargetViewHandle CreateTexture1DArrayRenderTargetView(Texture1DHandle texture, UINT mipSlice, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format);
+    [[nodiscard]] static DepthStencilViewHandle CreateTexture1DArrayDepthStencilView(Texture1DHandle texture, UINT mipSlice, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format);
+    [[nodiscard]] static ShaderResourceViewHandle CreateTexture1DArrayShaderResourceView(Texture1DHandle texture, UINT mostDetailedMipSlice, UINT mipLevels, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format);
+    [[nodiscard]] static UnorderedAccessViewHandle CreateTexture1DArrayUnorderedAccessView(Texture1DHandle texture, UINT mipSlice, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format);
+    [[nodiscard]] static RenderTargetViewHandle CreateTexture2DRenderTargetView(Texture2DHandle texture, UINT mipSlice, DXGI_FORMAT format);
+    [[nodiscard]] static DepthStencilViewHandle CreateTexture2DDepthStencilView(Texture2DHandle texture, UINT mipSlice, DXGI_FORMAT format);
+    [[nodiscard]] static ShaderResourceViewHandle CreateTexture2DShaderResourceView(Texture2DHandle texture, UINT mostDetailedMipSlice, UINT mipLevels, DXGI_FORMAT format);
+    [[nodiscard]] static UnorderedAccessViewHandle CreateTexture2DUnorderedAccessView(Texture2DHandle texture, UINT mipSlice, DXGI_FORMAT format);
+    [[nodiscard]] static RenderTargetViewHandle CreateTexture2DArrayRenderTargetView(Texture2DHandle texture, UINT mipSlice, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format);
+    [[nodiscard]] static DepthStencilViewHandle CreateTexture2DArrayDepthStencilView(Texture2DHandle texture, UINT mipSlice, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format);
+    [[nodiscard]] static ShaderResourceViewHandle CreateTexture2DArrayShaderResourceView(Texture2DHandle texture, UINT mostDetailedMipSlice, UINT mipLevels, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format);
+    [[nodiscard]] static UnorderedAccessViewHandle CreateTexture2DArrayUnorderedAccessView(Texture2DHandle texture, UINT mipSlice, UINT firstArraySlice, UINT arraySlices, DXGI_FORMAT format);
+    [[nodiscard]] static RenderTargetViewHandle CreateTexture3DRenderTargetView(Texture3DHandle texture, UINT mipSlice, DXGI_FORMAT format);
+    [[nodiscard]] static ShaderResourceViewHandle CreateTexture3DShaderResourceView(Texture3DHandle texture, UINT mostDetailedMipSlice, UINT mipLevels, DXGI_FORMAT format);
+    [[nodiscard]] static UnorderedAccessViewHandle CreateTexture3DUnorderedAccessView(Texture3DHandle texture, UINT mipSlice, DXGI_FORMAT format);
     
-    [[nodiscard]] static ID3D11DepthStencilView* CreateDepthStencilView(ID3D11Texture2D* texture);
-    [[nodiscard]] static ID3D11RenderTargetView* CreateRenderTargetView(ID3D11Texture2D* texture);
+    [[nodiscard]] static DepthStencilViewHandle CreateDepthStencilView(Texture2DHandle texture);
+    [[nodiscard]] static RenderTargetViewHandle CreateRenderTargetView(Texture2DHandle texture);
+
 
+    //----Meshes----//
+    //Memory-maps the file and creates immutable buffers straight from its streams, so nothing is parsed or copied on the CPU
+    //False if the file is missing or malformed, in which case nothing is created
+    [[nodiscard]] static bool LoadMesh(const char* path, Mesh& mesh);
+    static void ReleaseMesh(Mesh& mesh);
 
-    //----Samplers----//
-    [[nodiscard]] static ID3D11SamplerState* CreateSamplerState(D3D11_SAMPLER_DESC samplerDesc);
+
+    //----Resource Pool----//
+    //Caps the estimated size of the pooled resources, evicting the least recently released first - 0 disables pooling
+    static void SetPoolBudget(UINT64 budget);
+    //Destroy every pooled resource, e.g. after leaving a level
+    static void TrimPool();
+    [[nodiscard]] static ResourcePoolStatistics GetPoolStatistics();
+    [[nodiscard]] static ObjectCacheStatistics GetViewCacheStatistics();
+    [[nodiscard]] static ObjectCacheStatistics GetStateCacheStatistics();
+
+
+    //----States----//
+    //State objects are immutable, so every call with an identical description returns the same object
+    [[nodiscard]] static SamplerStateHandle CreateSamplerState(D3D11_SAMPLER_DESC samplerDesc);
+    [[nodiscard]] static BlendStateHandle CreateBlendState(const D3D11_BLEND_DESC& blendDesc);
+    [[nodiscard]] static RasterizerStateHandle CreateRasterizerState(const D3D11_RASTERIZER_DESC& rasterizerDesc);
+    [[nodiscard]] static DepthStencilStateHandle CreateDepthStencilState(const D3D11_DEPTH_STENCIL_DESC& depthStencilDesc);
     
 private:
-    static void Initialise();
+    static void Initialise(const ResourceDescription& rd);
     static void Shutdown();
 
-    //For cleanup
-    static std::vector<ID3D11Resource*> resources;
-    static std::vector<ID3D11View*> resourceViews;
-    static std::vector<ID3D11SamplerState*> samplerStates;
+    static HandlePool<ID3D11Resource> resources;
+    static HandlePool<ID3D11View> resourceViews;
+    static HandlePool<ID3D11DeviceChild> states;
+
+    //A live resource that goes to the pool once its own handle and the handles of all its views have been released
+    struct RecyclableResource
+    {
+        ResourcePoolKey key;
+        UINT views;    //Live views created on it through CreateView()
+        bool released; //Its own handle has been released, so it goes to the pool with its last view
+    };
+
+    static ResourcePool pool;
+    static std::unordered_map<ID3D11Resource*, RecyclableResource> recyclableResources; //Created through CreatePooledResource()
+    static ViewCache viewCache;
+    static StateCache stateCache;
     
 
     //Utility functions
-    [[nodiscard]] static ID3D11Buffer* CreateBuffer(D3D11_BUFFER_DESC* pDesc, D3D11_SUBRESOURCE_DATA* pData);
-};
\ No newline at end of file
+    [[nodiscard]] static BufferHandle CreateBuffer(D3D11_BUFFER_DESC* pDesc, D3D11_SUBRESOURCE_DATA* pData);
+    //Takes a matching resource from the pool when the description allows it, otherwise creates one through the device
+    template<typename Desc, typename T>
+    [[nodiscard]] static HRESULT CreatePooledResource(const Desc& desc, D3D11_SUBRESOURCE_DATA* pData, T** ppResource);
+    //Hands a new resource to a handle - if every slot is in use the resource is released (to the pool, if it came from it)
+    //and the null handle returned
+    template<typename T>
+    [[nodiscard]] static Handle<T> AllocateResource(T* resource);
+    //Returns the existing view of the resource with this description if there is one, otherwise creates it
+    template<typename T>
+    [[nodiscard]] static Handle<T> CreateView(ID3D11Resource* resource, const typename ViewDescription<T>::Type* pDesc);
+    //As CreateView(), for state objects
+    template<typename T, typename Desc>
+    [[nodiscard]] static Handle<T> CreateState(const Desc& desc);
+    static void ReleaseObject(IUnknown* object);
+    static void ReleaseObject(ID3D11Resource* resource);
+    static void ReleaseObject(ID3D11View* view);
+
+    template<typename T>
+    [[nodiscard]] static constexpr bool IsState()
+    {
+        return std::is_same_v<T, ID3D11SamplerState> || std::is_same_v<T, ID3D11BlendState> || std::is_same_v<T, ID3D11RasterizerState> || std::is_same_v<T, ID3D11DepthStencilState>;
+    }
+
+    template<typename T>
+    [[nodiscard]] static auto& GetPool()
+    {
+        if constexpr (std::is_base_of_v<ID3D11Resource, T>) { return resources; }
+        else if constexpr (std::is_base_of_v<ID3D11View, T>) { return resourceViews; }
+        else
+        {
+            static_assert(IsState<T>(), "Handle type is not managed by the ResourceManager");
+            return states;
+        }
+    }
+};
+
+
+template<typename T>
+void ResourceManager::Release(Handle<T> handle)
+{
+    if (handle.IsNull()) { return; }
+    if constexpr (std::is_base_of_v<ID3D11View, T>)
+    {
+        if (!viewCache.Release(Get(handle))) { return; }
+    }
+    else if constexpr (IsState<T>())
+    {
+        if (!stateCache.Release(Get(handle))) { return; }
+    }
+    ReleaseObject(GetPool<T>().Free(handle));
+}
\ No newline at end of file
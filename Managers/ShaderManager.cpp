@@ -0,0 +1,417 @@
+﻿#include "ShaderManager.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <type_traits>
+
+#include "DeviceManager.h"
+#include "../Utility/CpuProfiler.h"
+#include "../Utility/Hash.h"
+
+UINT ShaderManager::compileFlags{};
+ShaderCache ShaderManager::cache{};
+HandlePool<ID3D11DeviceChild> ShaderManager::shaders{};
+std::unordered_map<UINT64, Handle<ID3D11DeviceChild>> ShaderManager::permutations{};
+std::unordered_map<UINT32, std::vector<BYTE>> ShaderManager::vertexShaderBytecode{};
+std::unordered_map<UINT32, Handle<ID3D11DeviceChild>> ShaderManager::fallbacks{};
+std::vector<std::unique_ptr<ShaderManager::PendingShader>> ShaderManager::pendingShaders{};
+std::mutex ShaderManager::mutex{};
+ShaderStatistics ShaderManager::statistics{};
+
+
+static bool ReadFile(const std::filesystem::path& path, std::vector<char>& contents)
+{
+    std::ifstream file{ path, std::ios::binary };
+    if (!file) { return false; }
+    contents.assign(std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{});
+    return true;
+}
+
+static double MillisecondsSince(std::chrono::steady_clock::time_point begin)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+}
+
+//Device creation for LoadShader() - the device is free threaded, so these may run in jobs
+static HRESULT CreateVertexShader(const std::vector<BYTE>& bytecode, ID3D11VertexShader** shader)
+{
+    return DeviceManager::GetDevice()->CreateVertexShader(bytecode.data(), bytecode.size(), shader);
+}
+
+static HRESULT CreatePixelShader(const std::vector<BYTE>& bytecode, ID3D11PixelShader** shader)
+{
+    return DeviceManager::GetDevice()->CreatePixelShader(bytecode.data(), bytecode.size(), shader);
+}
+
+static HRESULT CreateComputeShader(const std::vector<BYTE>& bytecode, ID3D11ComputeShader** shader)
+{
+    return DeviceManager::GetDevice()->CreateComputeShader(bytecode.data(), bytecode.size(), shader);
+}
+
+//Resolves #includes relative to the including file and records every file it opens, so cache entries can be checked against them
+class ShaderInclude : public ID3DInclude
+{
+public:
+    explicit ShaderInclude(const std::filesystem::path& sourcePath) : rootDirectory{ sourcePath.parent_path() } {}
+
+    HRESULT __stdcall Open(D3D_INCLUDE_TYPE /*includeType*/, LPCSTR fileName, LPCVOID parentData, LPCVOID* data, UINT* bytes) override
+    {
+        std::filesystem::path directory{ rootDirectory };
+        for (const File& file : files)
+        {
+            if (file.contents.data() == parentData) { directory = file.path.parent_path(); }
+        }
+
+        File file{ (directory / fileName).lexically_normal(), {} };
+        if (!ReadFile(file.path, file.contents)) { return E_FAIL; }
+        dependencies.push_back(ShaderCacheDependency{ file.path.string(), HashBytes(file.contents.data(), file.contents.size()) });
+        files.push_back(std::move(file));
+        *data = files.back().contents.data();
+        *bytes = static_cast<UINT>(files.back().contents.size());
+        return S_OK;
+    }
+
+    //Contents stay alive until the include handler is destroyed, after compilation
+    HRESULT __stdcall Close(LPCVOID /*data*/) override { return S_OK; }
+
+    std::vector<ShaderCacheDependency> dependencies;
+
+private:
+    struct File
+    {
+        std::filesystem::path path;
+        std::vector<char> contents;
+    };
+
+    std::filesystem::path rootDirectory;
+    std::list<File> files; //A list, so the contents handed to the compiler never move
+};
+
+
+
+void ShaderManager::Initialise(const ShaderDescription& sd)
+{
+    compileFlags = sd.compileFlags;
+    if (compileFlags == 0)
+    {
+#ifdef _DEBUG
+        compileFlags = D3DCOMPILE_ENABLE_STRICTNESS | D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+#else
+        compileFlags = D3DCOMPILE_ENABLE_STRICTNESS | D3DCOMPILE_OPTIMIZATION_LEVEL3;
+#endif
+    }
+
+    statistics = {};
+    if (!cache.Initialise((sd.cacheDirectory) ? (sd.cacheDirectory) : (SHADER_DEFAULT_CACHE_DIRECTORY)))
+    {
+        std::cerr << "ERROR::SHADER_MANAGER::INITIALISE::SHADER_CACHE_UNAVAILABLE" << std::endl;
+    }
+}
+
+void ShaderManager::Shutdown()
+{
+    //Jobs still compiling write into their requests, so every one has to finish first
+    for (const std::unique_ptr<PendingShader>& pending : pendingShaders)
+    {
+        JobManager::Wait(pending->counter);
+        Publish(*pending);
+    }
+    pendingShaders.clear();
+    fallbacks.clear();
+
+    shaders.ForEach([](ID3D11DeviceChild* shader) { DeviceManager::device->ReleaseObject(shader); });
+    shaders.Clear();
+    permutations.clear();
+    vertexShaderBytecode.clear();
+    cache.Shutdown();
+}
+
+void ShaderManager::Update()
+{
+    PROFILE_FUNCTION();
+    for (size_t i{ 0 }; i < pendingShaders.size();)
+    {
+        if (!pendingShaders[i]->counter.IsComplete())
+        {
+            ++i;
+            continue;
+        }
+        Publish(*pendingShaders[i]);
+        pendingShaders[i] = std::move(pendingShaders.back());
+        pendingShaders.pop_back();
+    }
+}
+
+
+
+//---------------------------------//
+//---------Shader Loading----------//
+//---------------------------------//
+VertexShaderHandle ShaderManager::LoadVertexShader(const char* path, const char* entryPoint, const D3D_SHADER_MACRO* defines)
+{
+    return LoadShader<ID3D11VertexShader>(path, entryPoint, "vs_5_0", defines, false, {}, CreateVertexShader);
+}
+
+PixelShaderHandle ShaderManager::LoadPixelShader(const char* path, const char* entryPoint, const D3D_SHADER_MACRO* defines)
+{
+    return LoadShader<ID3D11PixelShader>(path, entryPoint, "ps_5_0", defines, false, {}, CreatePixelShader);
+}
+
+ComputeShaderHandle ShaderManager::LoadComputeShader(const char* path, const char* entryPoint, const D3D_SHADER_MACRO* defines)
+{
+    return LoadShader<ID3D11ComputeShader>(path, entryPoint, "cs_5_0", defines, false, {}, CreateComputeShader);
+}
+
+VertexShaderHandle ShaderManager::LoadVertexShaderAsync(const char* path, const char* entryPoint, const D3D_SHADER_MACRO* defines, VertexShaderHandle fallback)
+{
+    return LoadShader<ID3D11VertexShader>(path, entryPoint, "vs_5_0", defines, true, fallback, CreateVertexShader);
+}
+
+PixelShaderHandle ShaderManager::LoadPixelShaderAsync(const char* path, const char* entryPoint, const D3D_SHADER_MACRO* defines, PixelShaderHandle fallback)
+{
+    return LoadShader<ID3D11PixelShader>(path, entryPoint, "ps_5_0", defines, true, fallback, CreatePixelShader);
+}
+
+ComputeShaderHandle ShaderManager::LoadComputeShaderAsync(const char* path, const char* entryPoint, const D3D_SHADER_MACRO* defines, ComputeShaderHandle fallback)
+{
+    return LoadShader<ID3D11ComputeShader>(path, entryPoint, "cs_5_0", defines, true, fallback, CreateComputeShader);
+}
+
+InputLayoutHandle ShaderManager::CreateInputLayout(VertexShaderHandle vertexShader, const D3D11_INPUT_ELEMENT_DESC* elements, UINT numElements)
+{
+    WaitForShader(HandleCast<ID3D11DeviceChild>(vertexShader));
+    const auto bytecode{ vertexShaderBytecode.find(vertexShader.GetValue()) };
+    if (bytecode == vertexShaderBytecode.end() || !Get(vertexShader))
+    {
+        std::cerr << "ERROR::SHADER_MANAGER::CREATE_INPUT_LAYOUT::INVALID_VERTEX_SHADER" << std::endl;
+        return {};
+    }
+
+    //Semantic names are pointers, so each element is hashed field by field
+    UINT64 key{ HashBytes(&vertexShader, sizeof(vertexShader)) };
+    for (UINT i{ 0 }; i < numElements; ++i)
+    {
+        const D3D11_INPUT_ELEMENT_DESC& e{ elements[i] };
+        const UINT fields[6]{ e.SemanticIndex, static_cast<UINT>(e.Format), e.InputSlot, e.AlignedByteOffset, static_cast<UINT>(e.InputSlotClass), e.InstanceDataStepRate };
+        key = HashBytes(e.SemanticName, std::strlen(e.SemanticName) + 1, key);
+        key = HashBytes(fields, sizeof(fields), key);
+    }
+
+    const auto existing{ permutations.find(key) };
+    if (existing != permutations.end())
+    {
+        std::lock_guard<std::mutex> lock{ mutex };
+        ++statistics.reused;
+        return HandleCast<ID3D11InputLayout>(existing->second);
+    }
+
+    ID3D11InputLayout* inputLayout;
+    const HRESULT hr{ DeviceManager::device->CreateInputLayout(elements, numElements, bytecode->second.data(), bytecode->second.size(), &inputLayout) };
+    if (FAILED(hr))
+    {
+        std::cerr << "ERROR::SHADER_MANAGER::CREATE_INPUT_LAYOUT::FAILED_TO_CREATE_INPUT_LAYOUT" << std::endl;
+        return {};
+    }
+
+    const InputLayoutHandle handle{ shaders.Allocate(inputLayout) };
+    if (handle.IsNull())
+    {
+        DeviceManager::device->ReleaseObject(inputLayout);
+        return {};
+    }
+    permutations.emplace(key, HandleCast<ID3D11DeviceChild>(handle));
+    return handle;
+}
+
+ShaderStatistics ShaderManager::GetStatistics()
+{
+    std::lock_guard<std::mutex> lock{ mutex };
+    ShaderStatistics result{ statistics };
+    result.pending = static_cast<UINT>(pendingShaders.size());
+    result.cache = cache.GetStatistics();
+    return result;
+}
+//---------------------------------//
+//------End of Shader Loading------//
+//---------------------------------//
+
+
+
+//---------------------------------//
+//--------Utility Functions--------//
+//---------------------------------//
+template<typename T, typename CreateFunction>
+Handle<T> ShaderManager::LoadShader(const char* path, const char* entryPoint, const char* target, const D3D_SHADER_MACRO* defines, bool async, Handle<T> fallback, CreateFunction create)
+{
+    PROFILE_FUNCTION();
+    const UINT64 key{ HashPermutation(path, entryPoint, target, defines, HASH_BYTES_SEED) };
+    const auto existing{ permutations.find(key) };
+    if (existing != permutations.end())
+    {
+        if (!async) { WaitForShader(existing->second); }
+        std::lock_guard<std::mutex> lock{ mutex };
+        ++statistics.reused;
+        return HandleCast<T>(existing->second);
+    }
+
+    if (async && JobManager::GetThreadCount() > 1)
+    {
+        //The slot stays empty until the job's shader is published, with Get() returning the fallback's meanwhile
+        const Handle<T> handle{ shaders.Allocate<T>(nullptr) };
+        if (handle.IsNull()) { return {}; }
+        permutations.emplace(key, HandleCast<ID3D11DeviceChild>(handle));
+        fallbacks.emplace(handle.GetValue(), HandleCast<ID3D11DeviceChild>(fallback));
+
+        std::unique_ptr<PendingShader> pending{ std::make_unique<PendingShader>() };
+        pending->handle = HandleCast<ID3D11DeviceChild>(handle);
+        pending->keepBytecode = std::is_same_v<T, ID3D11VertexShader>;
+        pending->path = path;
+        pending->entryPoint = entryPoint;
+        for (const D3D_SHADER_MACRO* define{ defines }; define && define->Name; ++define)
+        {
+            pending->defineStrings.emplace_back(define->Name);
+            pending->defineStrings.emplace_back((define->Definition) ? (define->Definition) : (""));
+        }
+        for (size_t i{ 0 }; i < pending->defineStrings.size(); i += 2)
+        {
+            pending->defines.push_back(D3D_SHADER_MACRO{ pending->defineStrings[i].c_str(), pending->defineStrings[i + 1].c_str() });
+        }
+        pending->defines.push_back(D3D_SHADER_MACRO{ nullptr, nullptr });
+
+        PendingShader* request{ pending.get() };
+        JobManager::Schedule([request, target, create]()
+        {
+            T* shader{ nullptr };
+            if (GetBytecode(request->path.c_str(), request->entryPoint.c_str(), target, request->defines.data(), request->bytecode) && FAILED(create(request->bytecode, &shader)))
+            {
+                std::cerr << "ERROR::SHADER_MANAGER::LOAD_SHADER::FAILED_TO_CREATE_SHADER" << std::endl;
+                shader = nullptr;
+            }
+            request->shader = shader;
+            if (!shader)
+            {
+                std::lock_guard<std::mutex> lock{ mutex };
+                ++statistics.failures;
+            }
+        }, &request->counter);
+        pendingShaders.push_back(std::move(pending));
+        return handle;
+    }
+
+    std::vector<BYTE> bytecode;
+    T* shader{ nullptr };
+    if (!GetBytecode(path, entryPoint, target, defines, bytecode) || FAILED(create(bytecode, &shader)))
+    {
+        if (!bytecode.empty()) { std::cerr << "ERROR::SHADER_MANAGER::LOAD_SHADER::FAILED_TO_CREATE_SHADER" << std::endl; }
+        std::lock_guard<std::mutex> lock{ mutex };
+        ++statistics.failures;
+        return {};
+    }
+
+    const Handle<T> handle{ shaders.Allocate(shader) };
+    if (handle.IsNull())
+    {
+        DeviceManager::device->ReleaseObject(shader);
+        return {};
+    }
+    permutations.emplace(key, HandleCast<ID3D11DeviceChild>(handle));
+    if constexpr (std::is_same_v<T, ID3D11VertexShader>) { vertexShaderBytecode.emplace(handle.GetValue(), std::move(bytecode)); }
+    return handle;
+}
+
+bool ShaderManager::GetBytecode(const char* path, const char* entryPoint, const char* target, const D3D_SHADER_MACRO* defines, std::vector<BYTE>& bytecode)
+{
+    auto begin{ std::chrono::steady_clock::now() };
+    std::vector<char> source;
+    if (!ReadFile(path, source))
+    {
+        std::cerr << "ERROR::SHADER_MANAGER::GET_BYTECODE::FAILED_TO_READ_SOURCE::" << path << std::endl;
+        return false;
+    }
+
+    //Content addressed - the source itself is part of the key, and the entry records the includes it was compiled against
+    const UINT64 contentKey{ HashPermutation(path, entryPoint, target, defines, HashBytes(source.data(), source.size())) };
+    const bool loaded{ cache.Load(contentKey, bytecode) };
+    {
+        std::lock_guard<std::mutex> lock{ mutex };
+        statistics.loadMilliseconds += MillisecondsSince(begin);
+        if (loaded)
+        {
+            ++statistics.loaded;
+            return true;
+        }
+    }
+
+    begin = std::chrono::steady_clock::now();
+    ShaderInclude include{ path };
+    ID3DBlob* code{ nullptr };
+    ID3DBlob* errors{ nullptr };
+    const HRESULT hr{ D3DCompile(source.data(), source.size(), path, defines, &include, entryPoint, target, compileFlags, 0, &code, &errors) };
+    {
+        std::lock_guard<std::mutex> lock{ mutex };
+        statistics.compileMilliseconds += MillisecondsSince(begin);
+    }
+    if (FAILED(hr))
+    {
+        std::cerr << "ERROR::SHADER_MANAGER::GET_BYTECODE::FAILED_TO_COMPILE::" << path << "::" << entryPoint << std::endl;
+        if (errors) { std::cerr << static_cast<const char*>(errors->GetBufferPointer()) << std::endl; }
+    }
+    if (errors) { errors->Release(); }
+    if (FAILED(hr)) { return false; }
+
+    const BYTE* data{ static_cast<const BYTE*>(code->GetBufferPointer()) };
+    bytecode.assign(data, data + code->GetBufferSize());
+    code->Release();
+
+    std::lock_guard<std::mutex> lock{ mutex };
+    ++statistics.compiled;
+    cache.Store(contentKey, bytecode.data(), bytecode.size(), include.dependencies);
+    return true;
+}
+
+void ShaderManager::WaitForShader(Handle<ID3D11DeviceChild> handle)
+{
+    for (size_t i{ 0 }; i < pendingShaders.size(); ++i)
+    {
+        if (pendingShaders[i]->handle != handle) { continue; }
+        JobManager::Wait(pendingShaders[i]->counter);
+        Publish(*pendingShaders[i]);
+        pendingShaders[i] = std::move(pendingShaders.back());
+        pendingShaders.pop_back();
+        return;
+    }
+}
+
+void ShaderManager::Publish(PendingShader& pending)
+{
+    //A failed load keeps its fallback for good
+    if (!pending.shader) { return; }
+    shaders.Replace(pending.handle, pending.shader);
+    fallbacks.erase(pending.handle.GetValue());
+    if (pending.keepBytecode) { vertexShaderBytecode.emplace(pending.handle.GetValue(), std::move(pending.bytecode)); }
+}
+
+UINT64 ShaderManager::HashPermutation(const char* path, const char* entryPoint, const char* target, const D3D_SHADER_MACRO* defines, UINT64 seed)
+{
+    //Strings are hashed with their terminators, so adjacent strings can't run into each other
+    UINT64 hash{ HashBytes(&SHADER_CACHE_VERSION, sizeof(SHADER_CACHE_VERSION), seed) };
+    hash = HashBytes(&compileFlags, sizeof(compileFlags), hash);
+    hash = HashBytes(path, std::strlen(path) + 1, hash);
+    hash = HashBytes(entryPoint, std::strlen(entryPoint) + 1, hash);
+    hash = HashBytes(target, std::strlen(target) + 1, hash);
+    for (const D3D_SHADER_MACRO* define{ defines }; define && define->Name; ++define)
+    {
+        const char* definition{ (define->Definition) ? (define->Definition) : ("") };
+        hash = HashBytes(define->Name, std::strlen(define->Name) + 1, hash);
+        hash = HashBytes(definition, std::strlen(definition) + 1, hash);
+    }
+    return hash;
+}
+//---------------------------------//
+//-----End of Utility Functions----//
+//---------------------------------//
\ No newline at end of file
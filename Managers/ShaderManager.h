@@ -0,0 +1,133 @@
+﻿#pragma once
+#include <d3d11.h>
+#include <d3dcompiler.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "JobManager.h"
+#include "../Utility/Handle.h"
+#include "../Utility/ShaderCache.h"
+
+//Compiles HLSL permutations and keeps the resulting shader objects for the lifetime of the engine
+//A permutation is a source file, entry point and set of defines - the first request for one reads the source and either loads its
+//bytecode from the on-disk cache (keyed by a hash of the source, target, defines and flags) or compiles it and stores the result,
+//later requests for it return the same handle without touching the disk
+//
+//The LoadAsync*() variants hand out a handle straight away and compile (and create the shader object) in a job - until the
+//permutation is ready, Get() returns the fallback shader given with the request, so draws keep going with it instead of stalling
+//Finished permutations are swapped in at the start of the next frame
+//
+//Loading must only be done from the main thread - Get() may also be called from recording jobs
+
+
+using VertexShaderHandle = Handle<ID3D11VertexShader>;
+using PixelShaderHandle = Handle<ID3D11PixelShader>;
+using ComputeShaderHandle = Handle<ID3D11ComputeShader>;
+using InputLayoutHandle = Handle<ID3D11InputLayout>;
+
+constexpr const char* SHADER_DEFAULT_CACHE_DIRECTORY{ "ShaderCache" };
+
+struct ShaderDescription
+{
+    const char* cacheDirectory; //nullptr selects SHADER_DEFAULT_CACHE_DIRECTORY, "" disables the on-disk cache
+    UINT compileFlags;          //D3DCOMPILE_* flags - 0 selects optimisation level 3 (debug info and no optimisation in debug builds)
+};
+
+struct ShaderStatistics
+{
+    UINT64 compiled;          //Permutations compiled from source
+    UINT64 loaded;            //Permutations loaded from the on-disk cache
+    UINT64 reused;            //Requests for a permutation that was already loaded
+    UINT64 failures;
+    UINT pending;             //Asynchronous requests still compiling
+    double compileMilliseconds;
+    double loadMilliseconds;  //Reading sources and cache entries, excluding compilation
+    ShaderCacheStatistics cache;
+};
+
+
+class ShaderManager
+{
+    friend class EngineManager;
+
+public:
+    ShaderManager() = default;
+    ~ShaderManager() = default;
+
+    //defines is a null-terminated array as taken by D3DCompile(), or nullptr - includes are resolved relative to the including file
+    //Returns the null handle if the source can't be read or doesn't compile
+    [[nodiscard]] static VertexShaderHandle LoadVertexShader(const char* path, const char* entryPoint, const D3D_SHADER_MACRO* defines=nullptr);
+    [[nodiscard]] static PixelShaderHandle LoadPixelShader(const char* path, const char* entryPoint, const D3D_SHADER_MACRO* defines=nullptr);
+    [[nodiscard]] static ComputeShaderHandle LoadComputeShader(const char* path, const char* entryPoint, const D3D_SHADER_MACRO* defines=nullptr);
+    //As above, without waiting for the permutation - Get() returns the fallback's shader until it has finished (or if it fails)
+    //The fallback should be a permutation loaded synchronously, e.g. the same shader without optional features
+    //Loading a permutation synchronously while it is still compiling asynchronously waits for it
+    [[nodiscard]] static VertexShaderHandle LoadVertexShaderAsync(const char* path, const char* entryPoint, const D3D_SHADER_MACRO* defines, VertexShaderHandle fallback);
+    [[nodiscard]] static PixelShaderHandle LoadPixelShaderAsync(const char* path, const char* entryPoint, const D3D_SHADER_MACRO* defines, PixelShaderHandle fallback);
+    [[nodiscard]] static ComputeShaderHandle LoadComputeShaderAsync(const char* path, const char* entryPoint, const D3D_SHADER_MACRO* defines, ComputeShaderHandle fallback);
+    //Validated against the vertex shader's input signature - identical requests return the same layout
+    //Waits for the vertex shader if it is still compiling
+    [[nodiscard]] static InputLayoutHandle CreateInputLayout(VertexShaderHandle vertexShader, const D3D11_INPUT_ELEMENT_DESC* elements, UINT numElements);
+
+    //Object behind a handle for binding, the fallback's while an asynchronous load is in flight, or nullptr if the handle is null or stale
+    template<typename T>
+    [[nodiscard]] static T* Get(Handle<T> handle)
+    {
+        T* shader{ shaders.Get(handle) };
+        if (shader || fallbacks.empty()) { return shader; }
+        const auto fallback{ fallbacks.find(handle.GetValue()) };
+        return (fallback != fallbacks.end()) ? (shaders.Get(HandleCast<T>(fallback->second))) : (nullptr);
+    }
+    //False while an asynchronous load is in flight, and for handles whose load failed
+    template<typename T>
+    [[nodiscard]] static bool IsReady(Handle<T> handle) { return shaders.Get(handle) != nullptr; }
+
+    [[nodiscard]] static ShaderStatistics GetStatistics();
+
+private:
+    static void Initialise(const ShaderDescription& sd);
+    static void Shutdown();
+
+    //Swaps in the permutations that finished compiling since the last call
+    static void Update();
+
+    //Asynchronous request, owning copies of its strings since the caller's may not outlive the job
+    struct PendingShader
+    {
+        JobCounter counter;
+        Handle<ID3D11DeviceChild> handle;
+        std::string path;
+        std::string entryPoint;
+        std::vector<std::string> defineStrings; //Name and definition of each define in turn
+        std::vector<D3D_SHADER_MACRO> defines;  //Null-terminated, pointing into defineStrings
+        std::vector<BYTE> bytecode;
+        ID3D11DeviceChild* shader;              //Written by the job - null if the load failed
+        bool keepBytecode;                      //Vertex shaders keep theirs for creating input layouts
+    };
+
+    static UINT compileFlags;
+    static ShaderCache cache;
+    static HandlePool<ID3D11DeviceChild> shaders;
+    static std::unordered_map<UINT64, Handle<ID3D11DeviceChild>> permutations;       //By request (path, entry point, target, defines)
+    static std::unordered_map<UINT32, std::vector<BYTE>> vertexShaderBytecode;       //By handle value, for creating input layouts
+    static std::unordered_map<UINT32, Handle<ID3D11DeviceChild>> fallbacks;          //By handle value, for loads still in flight or failed
+    static std::vector<std::unique_ptr<PendingShader>> pendingShaders;
+    static std::mutex mutex;                                                          //Guards the statistics and cache stores, which jobs update
+    static ShaderStatistics statistics;
+
+
+    //Utility functions
+    //Finds or produces the bytecode of a permutation and hands it to create, which makes the shader object
+    //Asynchronous loads fall back to synchronous ones when there are no worker threads to compile on
+    template<typename T, typename CreateFunction>
+    [[nodiscard]] static Handle<T> LoadShader(const char* path, const char* entryPoint, const char* target, const D3D_SHADER_MACRO* defines, bool async, Handle<T> fallback, CreateFunction create);
+    //Thread safe
+    [[nodiscard]] static bool GetBytecode(const char* path, const char* entryPoint, const char* target, const D3D_SHADER_MACRO* defines, std::vector<BYTE>& bytecode);
+    //Waits for an asynchronous load of the handle if there is one in flight
+    static void WaitForShader(Handle<ID3D11DeviceChild> handle);
+    static void Publish(PendingShader& pending);
+    [[nodiscard]] static UINT64 HashPermutation(const char* path, const char* entryPoint, const char* target, const D3D_SHADER_MACRO* defines, UINT64 seed);
+};
\ No newline at end of file
@@ -0,0 +1,280 @@
+﻿#include "UploadManager.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "DeviceManager.h"
+#include "EngineManager.h"
+
+UploadManager::UploadRing UploadManager::vertexRing{};
+UploadManager::UploadRing UploadManager::indexRing{};
+UploadManager::UploadRing UploadManager::constantRing{};
+bool UploadManager::constantRingEnabled{};
+UploadManager::ConstantBufferPool UploadManager::constantPools[CONSTANT_POOL_SIZE_CLASSES]{};
+
+UploadStatistics UploadManager::frameStatistics{};
+UploadStatistics UploadManager::lastFrameStatistics{};
+
+
+void UploadManager::Initialise(const UploadDescription& ud)
+{
+    if (vertexRing.buffer != nullptr)
+    {
+        std::cerr << "ERROR::UPLOAD_MANAGER::INITIALISE::UPLOAD_MANAGER_ALREADY_INITIALISED" << std::endl;
+        return;
+    }
+
+    bool created{ true };
+
+    vertexRing.bindFlags = D3D11_BIND_VERTEX_BUFFER;
+    vertexRing.alignment = 16;
+    created = CreateRingBuffer(vertexRing, (ud.vertexRingSize != 0) ? (ud.vertexRingSize) : (4 * 1024 * 1024)) && created;
+
+    indexRing.bindFlags = D3D11_BIND_INDEX_BUFFER;
+    indexRing.alignment = 16;
+    created = CreateRingBuffer(indexRing, (ud.indexRingSize != 0) ? (ud.indexRingSize) : (1024 * 1024)) && created;
+
+    //Constant buffer windows must start on, and span a multiple of, 16 constants (256 bytes)
+    constantRingEnabled = DeviceManager::device->SupportsConstantBufferOffsets() && !ud.pooledConstantBuffers;
+    if (constantRingEnabled)
+    {
+        constantRing.bindFlags = D3D11_BIND_CONSTANT_BUFFER;
+        constantRing.alignment = 256;
+        created = CreateRingBuffer(constantRing, (ud.constantRingSize != 0) ? (ud.constantRingSize) : (2 * 1024 * 1024)) && created;
+    }
+
+    if (!created)
+    {
+        std::cerr << "ERROR::UPLOAD_MANAGER::INITIALISE::FAILED_TO_CREATE_RING_BUFFERS" << std::endl;
+    }
+
+    frameStatistics = {};
+    lastFrameStatistics = {};
+}
+
+void UploadManager::Shutdown()
+{
+    ReleaseRing(vertexRing);
+    ReleaseRing(indexRing);
+    ReleaseRing(constantRing);
+    for (ConstantBufferPool& pool : constantPools)
+    {
+        for (BufferHandle handle : pool.handles)
+        {
+            ResourceManager::Release(handle);
+        }
+        pool = {};
+    }
+}
+
+
+
+UploadAllocation UploadManager::UploadVertexData(const void* data, UINT size)
+{
+    return RingAllocate(vertexRing, data, size, "UPLOAD_VERTEX_DATA");
+}
+
+UploadAllocation UploadManager::UploadIndexData(const void* data, UINT size)
+{
+    return RingAllocate(indexRing, data, size, "UPLOAD_INDEX_DATA");
+}
+
+UploadAllocation UploadManager::UploadConstantData(const void* data, UINT size)
+{
+    if (size > D3D11_REQ_CONSTANT_BUFFER_ELEMENT_COUNT * 16)
+    {
+        std::cerr << "ERROR::UPLOAD_MANAGER::UPLOAD_CONSTANT_DATA::SIZE_EXCEEDS_MAXIMUM_CONSTANT_BUFFER_SIZE" << std::endl;
+        return {};
+    }
+    if (!constantRingEnabled)
+    {
+        return PoolAllocate(data, size);
+    }
+
+    UploadAllocation allocation{ RingAllocate(constantRing, data, size, "UPLOAD_CONSTANT_DATA") };
+    if (allocation.buffer)
+    {
+        allocation.firstConstant = allocation.offset / 16;
+        allocation.numConstants = ((size + 255) & ~255u) / 16;
+    }
+    return allocation;
+}
+
+void UploadManager::BindConstantData(PIPELINE_STAGE stage, UINT slot, const UploadAllocation& allocation)
+{
+    PipelineManager::BindConstantBufferRanges(stage, slot, 1, &allocation.buffer, &allocation.firstConstant, &allocation.numConstants);
+}
+
+bool UploadManager::UsingConstantRing()
+{
+    return constantRingEnabled;
+}
+
+UploadStatistics UploadManager::GetFrameStatistics()
+{
+    return lastFrameStatistics;
+}
+
+void UploadManager::EndFrame()
+{
+    //Every pooled buffer may be reused (with a fresh DISCARD) next frame - the rings carry on from where they are
+    EndRingFrame(vertexRing);
+    EndRingFrame(indexRing);
+    EndRingFrame(constantRing);
+    for (ConstantBufferPool& pool : constantPools)
+    {
+        pool.used = 0;
+    }
+    lastFrameStatistics = frameStatistics;
+    frameStatistics = {};
+}
+
+
+
+UploadAllocation UploadManager::RingAllocate(UploadRing& ring, const void* data, UINT size, const char* caller)
+{
+    if (!ring.buffer)
+    {
+        std::cerr << "ERROR::UPLOAD_MANAGER::" << caller << "::UPLOAD_MANAGER_NOT_INITIALISED" << std::endl;
+        return {};
+    }
+    if (size == 0)
+    {
+        std::cerr << "ERROR::UPLOAD_MANAGER::" << caller << "::SIZE_MUST_BE_NON_ZERO" << std::endl;
+        return {};
+    }
+    const UINT alignedSize{ (size + ring.alignment - 1) & ~(ring.alignment - 1) };
+
+    if (ring.head + alignedSize > ring.size)
+    {
+        if (ring.head == ring.frameStart && alignedSize <= ring.size)
+        {
+            //Nothing allocated yet this frame, so nothing still waiting to be drawn can be lost by the discard
+            ring.head = 0;
+            ring.frameStart = 0;
+            ring.discardNext = true;
+        }
+        else
+        {
+            //The ring keeps its current buffer if the larger one can't be created
+            const BufferHandle outgrown{ ring.handle };
+            if (!CreateRingBuffer(ring, (std::max)(ring.size * 2, alignedSize)))
+            {
+                std::cerr << "ERROR::UPLOAD_MANAGER::" << caller << "::FAILED_TO_GROW_RING_BUFFER" << std::endl;
+                return {};
+            }
+            ring.retired.push_back(outgrown);
+            ++frameStatistics.ringGrowths;
+        }
+    }
+    const D3D11_MAP mapType{ (ring.discardNext) ? (D3D11_MAP_WRITE_DISCARD) : (D3D11_MAP_WRITE_NO_OVERWRITE) };
+
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    HRESULT hr{ DeviceManager::context->Map(ring.buffer, 0, mapType, 0, &mapped) };
+    if (FAILED(hr))
+    {
+        std::cerr << "ERROR::UPLOAD_MANAGER::" << caller << "::FAILED_TO_MAP_RING_BUFFER" << std::endl;
+        return {};
+    }
+    std::memcpy(static_cast<BYTE*>(mapped.pData) + ring.head, data, size);
+    DeviceManager::context->Unmap(ring.buffer, 0);
+
+    if (ring.discardNext) { ++frameStatistics.discardMaps; }
+    else                  { ++frameStatistics.noOverwriteMaps; }
+    ++frameStatistics.allocations;
+    frameStatistics.bytesUploaded += size;
+
+    const UploadAllocation allocation{ ring.buffer, ring.head, 0, 0 };
+    ring.head += alignedSize;
+    ring.discardNext = false;
+    return allocation;
+}
+
+UploadAllocation UploadManager::PoolAllocate(const void* data, UINT size)
+{
+    UINT sizeClass{ 0 };
+    while ((CONSTANT_POOL_MIN_SIZE << sizeClass) < size) { ++sizeClass; }
+    ConstantBufferPool& pool{ constantPools[sizeClass] };
+
+    if (pool.used == pool.buffers.size())
+    {
+        BufferHandle handle{ ResourceManager::CreateConstantBuffer(CONSTANT_POOL_MIN_SIZE << sizeClass, true, false, nullptr) };
+        ID3D11Buffer* buffer{ ResourceManager::Get(handle) };
+        if (!buffer)
+        {
+            std::cerr << "ERROR::UPLOAD_MANAGER::UPLOAD_CONSTANT_DATA::FAILED_TO_CREATE_POOLED_CONSTANT_BUFFER" << std::endl;
+            return {};
+        }
+        pool.handles.push_back(handle);
+        pool.buffers.push_back(buffer);
+        ++frameStatistics.pooledBuffersCreated;
+    }
+    ID3D11Buffer* buffer{ pool.buffers[pool.used] };
+
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    HRESULT hr{ DeviceManager::context->Map(buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped) };
+    if (FAILED(hr))
+    {
+        std::cerr << "ERROR::UPLOAD_MANAGER::UPLOAD_CONSTANT_DATA::FAILED_TO_MAP_POOLED_CONSTANT_BUFFER" << std::endl;
+        return {};
+    }
+    std::memcpy(mapped.pData, data, size);
+    DeviceManager::context->Unmap(buffer, 0);
+    ++pool.used;
+
+    ++frameStatistics.discardMaps;
+    ++frameStatistics.allocations;
+    frameStatistics.bytesUploaded += size;
+    return UploadAllocation{ buffer, 0, 0, 0 };
+}
+
+bool UploadManager::CreateRingBuffer(UploadRing& ring, UINT size)
+{
+    BufferHandle handle{};
+    switch (ring.bindFlags)
+    {
+    case (D3D11_BIND_VERTEX_BUFFER):   handle = ResourceManager::CreateVertexBuffer(size, true, false, nullptr); break;
+    case (D3D11_BIND_INDEX_BUFFER):    handle = ResourceManager::CreateIndexBuffer(size, true, nullptr); break;
+    case (D3D11_BIND_CONSTANT_BUFFER): handle = ResourceManager::CreateConstantBuffer(size, true, false, nullptr); break;
+    default: break;
+    }
+    if (handle.IsNull()) { return false; }
+
+    ring.handle = handle;
+    ring.buffer = ResourceManager::Get(handle);
+    ring.size = size;
+    ring.head = 0;
+    ring.frameStart = 0;
+    ring.discardNext = true;
+    return true;
+}
+
+void UploadManager::EndRingFrame(UploadRing& ring)
+{
+    //The frame's draws have all been issued now, so outgrown buffers can go
+    for (BufferHandle handle : ring.retired)
+    {
+        ResourceManager::Release(handle);
+    }
+    ring.retired.clear();
+
+    //Wrap now, while it is safe, if next frame is unlikely to fit in what's left
+    const UINT frameBytes{ ring.head - ring.frameStart };
+    if (ring.head + frameBytes > ring.size)
+    {
+        ring.head = 0;
+        ring.discardNext = true;
+    }
+    ring.frameStart = ring.head;
+}
+
+void UploadManager::ReleaseRing(UploadRing& ring)
+{
+    for (BufferHandle handle : ring.retired)
+    {
+        ResourceManager::Release(handle);
+    }
+    ResourceManager::Release(ring.handle);
+    ring = {};
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+﻿#pragma once
+#include <d3d11.h>
+#include <vector>
+
+#include "PipelineManager.h"
+#include "ResourceManager.h"
+
+//Per-frame upload allocator for transient vertex, index and constant data
+//Data is sub-allocated linearly from one large dynamic buffer per kind, mapped with NO_OVERWRITE so the GPU can keep reading
+//earlier allocations - only when a ring is full does it wrap back to the start with a DISCARD map, which has the driver
+//hand out fresh memory while draws still in flight keep the old contents
+//A DISCARD would also hide this frame's earlier allocations from draws that haven't been issued yet (e.g. still in the DrawQueue),
+//so rings only wrap at frame boundaries - a frame that overflows a ring moves it to a buffer twice the size instead
+//
+//Constant data is only ringed when the device supports Direct3D 11.1 constant buffer offsetting, otherwise each allocation
+//gets its own buffer from a pool of dynamic constant buffers (one power-of-two size class per 256 bytes .. 64KB),
+//each buffer being used at most once per frame and DISCARD-mapped on every use
+//
+//Uploads map on the immediate context and so must be made on the main thread, before the draws using them are recorded -
+//the allocations themselves can then be bound from any recording job
+
+
+//Sub-allocation handed out by the UploadManager - valid until the end of the frame it was made in
+struct UploadAllocation
+{
+    ID3D11Buffer* buffer; //Null if the allocation failed
+    UINT offset;          //Byte offset of the data in buffer, to be passed as the vertex/index buffer offset
+
+    //Constant buffer window for PipelineManager::BindConstantBufferRanges/DrawItem - 0/0 (whole buffer) for pooled fallback allocations
+    UINT firstConstant;
+    UINT numConstants;
+};
+
+struct UploadDescription
+{
+    //Ring sizes in bytes - 0 selects the default
+    UINT vertexRingSize;
+    UINT indexRingSize;
+    UINT constantRingSize;
+
+    //Use the pooled constant buffer fallback even where the device supports constant buffer offsetting
+    bool pooledConstantBuffers;
+};
+
+//Counters accumulated over one frame
+struct UploadStatistics
+{
+    UINT allocations;
+    UINT64 bytesUploaded;
+    UINT discardMaps;      //Ring wraps and pooled buffer uses
+    UINT noOverwriteMaps;
+    UINT pooledBuffersCreated;
+    UINT ringGrowths;      //Rings that overflowed within the frame - the ring sizes in the UploadDescription are too small
+};
+
+
+class UploadManager
+{
+    friend class EngineManager;
+    friend class RenderManager;
+
+public:
+    UploadManager() = default;
+    ~UploadManager() = default;
+
+    [[nodiscard]] static UploadAllocation UploadVertexData(const void* data, UINT size);
+    [[nodiscard]] static UploadAllocation UploadIndexData(const void* data, UINT size);
+    //size is rounded up to a multiple of 256 bytes (16 constants)
+    [[nodiscard]] static UploadAllocation UploadConstantData(const void* data, UINT size);
+
+    static void BindConstantData(PIPELINE_STAGE stage, UINT slot, const UploadAllocation& allocation);
+
+    //True if constant data is sub-allocated from a ring, false if the pooled fallback is in use
+    [[nodiscard]] static bool UsingConstantRing();
+    //Counters for the last completed frame
+    [[nodiscard]] static UploadStatistics GetFrameStatistics();
+
+private:
+    static void Initialise(const UploadDescription& ud);
+    static void Shutdown();
+
+    static void EndFrame();
+
+
+    struct UploadRing
+    {
+        BufferHandle handle;
+        ID3D11Buffer* buffer;
+        UINT bindFlags;
+        UINT size;
+        UINT alignment;
+        UINT head;
+        UINT frameStart;  //head at the start of the frame
+        bool discardNext; //The first map of a new buffer and the first map after a wrap must discard
+        std::vector<BufferHandle> retired; //Outgrown buffers, kept alive until the frame's draws have been issued
+    };
+
+    //Pooled fallback for constant data, one list of buffers per size class
+    static constexpr UINT CONSTANT_POOL_MIN_SIZE{ 256 };
+    static constexpr UINT CONSTANT_POOL_SIZE_CLASSES{ 9 }; //256 bytes .. 64KB
+
+    struct ConstantBufferPool
+    {
+        std::vector<BufferHandle> handles;
+        std::vector<ID3D11Buffer*> buffers;
+        UINT used; //Buffers handed out this frame
+    };
+
+    static UploadRing vertexRing;
+    static UploadRing indexRing;
+    static UploadRing constantRing;
+    static bool constantRingEnabled;
+    static ConstantBufferPool constantPools[CONSTANT_POOL_SIZE_CLASSES];
+
+    static UploadStatistics frameStatistics;
+    static UploadStatistics lastFrameStatistics;
+
+
+    //Utility functions
+    [[nodiscard]] static UploadAllocation RingAllocate(UploadRing& ring, const void* data, UINT size, const char* caller);
+    [[nodiscard]] static UploadAllocation PoolAllocate(const void* data, UINT size);
+    //Points the ring at a new, empty buffer of the size - the ring is left untouched if it can't be created
+    static bool CreateRingBuffer(UploadRing& ring, UINT size);
+    static void EndRingFrame(UploadRing& ring);
+    static void ReleaseRing(UploadRing& ring);
+};
\ No newline at end of file
@@ -1,76 +1,92 @@
 ﻿#include "WindowManager.h"
 
 #include <iostream>
+#include <thread>
 
 #include "DeviceManager.h"
 #include "EngineManager.h"
+#include "RenderManager.h"
+#include "../Utility/CpuProfiler.h"
 
 //Forward declarations
+#ifdef _WIN32
 static LRESULT CALLBACK WindowProcedure(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
 static HWND WindowSetup(UINT width, UINT height);
+#endif
 
 
 UINT WindowManager::width{};
 UINT WindowManager::height{};
     
 HWND WindowManager::hwnd{};
-IDXGISwapChain* WindowManager::swapChain{};
+GraphicsSwapChain* WindowManager::swapChain{};
+UINT WindowManager::swapChainFlags{};
+bool WindowManager::tearing{};
+UINT WindowManager::syncInterval{};
 
+bool WindowManager::resizePending{};
+UINT WindowManager::pendingWidth{};
+UINT WindowManager::pendingHeight{};
 
-void WindowManager::Initialise(const UINT _width, const UINT _height)
+FRAME_PACING_MODE WindowManager::pacingMode{};
+HANDLE WindowManager::frameLatencyWaitableObject{};
+std::chrono::steady_clock::duration WindowManager::framePeriod{};
+std::chrono::steady_clock::time_point WindowManager::nextFrameTime{};
+std::chrono::steady_clock::time_point WindowManager::lastFrameStart{};
+FramePacingStatistics WindowManager::statistics{};
+
+
+void WindowManager::Initialise(const WindowDescription& wd)
 {
-    if (hwnd != NULL)
+    if (swapChain != nullptr)
     {
         std::cerr << "ERROR::WINDOW_MANAGER::INITIALISE::WINDOW_ALREADY_INITIALISED" << std::endl;
         return;
     }
     
-    width = _width;
-    height = _height;
+    width = wd.winWidth;
+    height = wd.winHeight;
+
+    pacingMode = wd.pacingMode;
+    if (pacingMode == FRAME_PACING_MODE::FRAME_PACING_FIXED_RATE)
+    {
+        if (wd.targetFrameRate == 0)
+        {
+            std::cerr << "ERROR::WINDOW_MANAGER::INITIALISE::FIXED_RATE_PACING_REQUIRES_A_TARGET_FRAME_RATE::FALLING_BACK_TO_UNCAPPED" << std::endl;
+            pacingMode = FRAME_PACING_MODE::FRAME_PACING_UNCAPPED;
+        }
+        framePeriod = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / ((wd.targetFrameRate != 0) ? (wd.targetFrameRate) : (1))));
+    }
+    nextFrameTime = {};
+    statistics = {};
     
-    ID3D11Device* device{ DeviceManager::device };
+    GraphicsDevice* device{ DeviceManager::device };
     
     //Setup Window
-    UINT WIN_WIDTH{ 800 };
-    UINT WIN_HEIGHT{ 800 };
-    hwnd = WindowSetup(WIN_WIDTH, WIN_HEIGHT);
-    if (hwnd == NULL) {
-        std::cerr << "ERROR::WINDOW_MANAGER::INITIALISE::FAILED_TO_CREATE_WINDOW" << std::endl;
-        return;
+    if (device->GetBackend() != GRAPHICS_BACKEND::NULL_BACKEND)
+    {
+#ifdef _WIN32
+        hwnd = WindowSetup(width, height);
+#endif
+        if (hwnd == NULL) {
+            std::cerr << "ERROR::WINDOW_MANAGER::INITIALISE::FAILED_TO_CREATE_WINDOW" << std::endl;
+            return;
+        }
     }
 
 
-    //Setup DXGI Factory
-    IDXGIDevice* dxgiDevice;
-    HRESULT hr{ device->QueryInterface(IID_PPV_ARGS(&dxgiDevice) ) };
-    if (FAILED(hr))
-    {
-        std::cerr << "ERROR::WINDOW_MANAGER::INITIALISE::FAILED_TO_GET_DXGI_DEVICE" << std::endl;
-        return;
-    }
-    IDXGIAdapter* dxgiAdapter;
-    hr = dxgiDevice->GetAdapter(&dxgiAdapter);
-    if (FAILED(hr))
-    {
-        std::cerr << "ERROR::WINDOW_MANAGER::INITIALISE::FAILED_TO_GET_DXGI_ADAPTER" << std::endl;
-        dxgiDevice->Release();
-        return;
-    }
-    IDXGIFactory* dxgiFactory;
-    hr = dxgiAdapter->GetParent(IID_PPV_ARGS(&dxgiFactory));
-    if (FAILED(hr))
+    //Setup Swapchain
+    const bool flipModel{ wd.swapEffect == DXGI_SWAP_EFFECT_FLIP_DISCARD || wd.swapEffect == DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL || pacingMode == FRAME_PACING_MODE::FRAME_PACING_WAITABLE_SWAPCHAIN };
+    tearing = wd.allowTearing && flipModel && device->SupportsTearing();
+    if (wd.allowTearing && !tearing)
     {
-        std::cerr << "ERROR::WINDOW_MANAGER::INITIALISE::FAILED_TO_GET_DXGI_FACTORY" << std::endl;
-        dxgiDevice->Release();
-        dxgiAdapter->Release();
-        return;
+        std::cerr << "ERROR::WINDOW_MANAGER::INITIALISE::TEARING_UNSUPPORTED_OR_REQUIRES_FLIP_MODEL::PRESENTING_WITHOUT_TEARING" << std::endl;
     }
+    syncInterval = (wd.syncInterval != 0) ? (wd.syncInterval) : (1);
 
-
-    //Setup Swapchain
     DXGI_MODE_DESC bufferDesc{
-        WIN_WIDTH,
-        WIN_HEIGHT,
+        width,
+        height,
         DXGI_RATIONAL{60, 1},
         DXGI_FORMAT_R8G8B8A8_UNORM,
         DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED,
@@ -80,40 +96,191 @@ void WindowManager::Initialise(const UINT _width, const UINT _height)
         bufferDesc,
         DXGI_SAMPLE_DESC{1,0},
         DXGI_USAGE_RENDER_TARGET_OUTPUT,
-        2,
+        (wd.bufferCount != 0) ? (wd.bufferCount) : (2),
         hwnd,
         true,
-        DXGI_SWAP_EFFECT_DISCARD,
-        NULL
+        wd.swapEffect,
+        0
     };
-    hr = dxgiFactory->CreateSwapChain(dxgiDevice, &swapChainDesc, &swapChain);
-    dxgiFactory->Release();
-    dxgiAdapter->Release();
-    dxgiDevice->Release();
+    if (pacingMode == FRAME_PACING_MODE::FRAME_PACING_WAITABLE_SWAPCHAIN)
+    {
+        //Waitable objects are only available on flip model swapchains
+        if (!flipModel || wd.swapEffect != DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL) { swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD; }
+        swapChainDesc.Flags |= DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+    }
+    if (tearing)
+    {
+        swapChainDesc.Flags |= DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
+    }
+    swapChainFlags = swapChainDesc.Flags;
+    HRESULT hr{ device->CreateSwapChain(hwnd, &swapChainDesc, &swapChain) };
     if (FAILED(hr))
     {
         std::cerr << "ERROR::WINDOW_MANAGER::INITIALISE::FAILED_TO_CREATE_SWAP_CHAIN" << std::endl;
         return;
     }
+
+    //Setup Frame Latency
+    const UINT maxFramesInFlight{ (wd.maxFramesInFlight != 0) ? (wd.maxFramesInFlight) : (2) };
+    if (pacingMode == FRAME_PACING_MODE::FRAME_PACING_WAITABLE_SWAPCHAIN)
+    {
+        frameLatencyWaitableObject = swapChain->GetFrameLatencyWaitableObject();
+        if (frameLatencyWaitableObject == nullptr || FAILED(swapChain->SetMaximumFrameLatency(maxFramesInFlight)))
+        {
+            if (device->GetBackend() != GRAPHICS_BACKEND::NULL_BACKEND)
+            {
+                std::cerr << "ERROR::WINDOW_MANAGER::INITIALISE::WAITABLE_SWAP_CHAIN_UNAVAILABLE::FALLING_BACK_TO_VSYNC" << std::endl;
+            }
+            pacingMode = FRAME_PACING_MODE::FRAME_PACING_VSYNC;
+        }
+    }
+    if (pacingMode != FRAME_PACING_MODE::FRAME_PACING_WAITABLE_SWAPCHAIN && FAILED(device->SetMaximumFrameLatency(maxFramesInFlight)))
+    {
+        std::cerr << "ERROR::WINDOW_MANAGER::INITIALISE::FAILED_TO_SET_MAXIMUM_FRAME_LATENCY" << std::endl;
+    }
 }
 
 void WindowManager::Update()
 {
+    PROFILE_FUNCTION();
+    //Messages are handled after the wait so the frame sees the most recent input
+    WaitForNextFrame();
+
+    //Headless - there is no window to pump messages for, the caller decides when to stop
+    if (hwnd == NULL)
+    {
+        ApplyResize();
+        return;
+    }
+
+#ifdef _WIN32
     MSG msg;
-    BOOL msgReceived{ GetMessage(&msg, NULL, 0, 0) };
-    if (msgReceived)
+    while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
     {
+        if (msg.message == WM_QUIT)
+        {
+            EngineManager::applicationRunning = false;
+            continue;
+        }
         TranslateMessage(&msg);
         DispatchMessage(&msg);
     }
-    EngineManager::applicationRunning = msgReceived;
+#endif
+    ApplyResize();
 }
 
 void WindowManager::Shutdown()
 {
-    swapChain->Release();
+#ifdef _WIN32
+    if (frameLatencyWaitableObject) { CloseHandle(frameLatencyWaitableObject); }
+#endif
+    frameLatencyWaitableObject = nullptr;
+
+    delete swapChain;
+    swapChain = nullptr;
 }
 
+FramePacingStatistics WindowManager::GetFramePacingStatistics()
+{
+    return statistics;
+}
+
+void WindowManager::Resize(UINT _width, UINT _height)
+{
+    //A drag produces a stream of WM_SIZE messages - only the last one each frame is applied
+    pendingWidth = _width;
+    pendingHeight = _height;
+    resizePending = true;
+}
+
+
+
+void WindowManager::WaitForNextFrame()
+{
+    PROFILE_FUNCTION();
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point waitStart{ Clock::now() };
+
+    switch (pacingMode)
+    {
+    case (FRAME_PACING_MODE::FRAME_PACING_WAITABLE_SWAPCHAIN):
+    {
+#ifdef _WIN32
+        //Time out rather than hang if the swapchain stops signalling (e.g. the window is occluded)
+        WaitForSingleObjectEx(frameLatencyWaitableObject, 1000, TRUE);
+#endif
+        break;
+    }
+    case (FRAME_PACING_MODE::FRAME_PACING_FIXED_RATE):
+    {
+        //Deadlines advance by whole periods so rounding errors don't accumulate - a frame that overran by more than a period
+        //restarts the schedule rather than having the following frames rush to catch up
+        if (waitStart > nextFrameTime + framePeriod)
+        {
+            nextFrameTime = waitStart;
+        }
+        else
+        {
+            //OS sleeps can overshoot by a scheduler quantum, so only sleep until shortly before the deadline and yield the rest
+            constexpr std::chrono::milliseconds sleepMargin{ 2 };
+            if (nextFrameTime - waitStart > sleepMargin)
+            {
+                std::this_thread::sleep_until(nextFrameTime - sleepMargin);
+            }
+            while (Clock::now() < nextFrameTime)
+            {
+                std::this_thread::yield();
+            }
+        }
+        nextFrameTime += framePeriod;
+        break;
+    }
+    default: break;
+    }
+
+    const Clock::time_point frameStart{ Clock::now() };
+    statistics.waitTime = std::chrono::duration<double, std::milli>(frameStart - waitStart).count();
+    statistics.frameTime = (statistics.frameCount != 0) ? (std::chrono::duration<double, std::milli>(frameStart - lastFrameStart).count()) : (0.0);
+    ++statistics.frameCount;
+    lastFrameStart = frameStart;
+}
+
+void WindowManager::ApplyResize()
+{
+    if (!resizePending) { return; }
+    resizePending = false;
+
+    //Minimised windows report a zero size, and there is nothing to do if the size hasn't actually changed
+    if (pendingWidth == 0 || pendingHeight == 0 || (pendingWidth == width && pendingHeight == height) || !swapChain) { return; }
+
+    RenderManager::ReleaseSwapChainViews();
+    HRESULT hr{ swapChain->ResizeBuffers(0, pendingWidth, pendingHeight, DXGI_FORMAT_UNKNOWN, swapChainFlags) };
+    if (FAILED(hr))
+    {
+        std::cerr << "ERROR::WINDOW_MANAGER::APPLY_RESIZE::FAILED_TO_RESIZE_SWAP_CHAIN_BUFFERS" << std::endl;
+    }
+    else
+    {
+        width = pendingWidth;
+        height = pendingHeight;
+    }
+    RenderManager::CreateSwapChainViews();
+}
+
+UINT WindowManager::GetPresentSyncInterval()
+{
+    return (pacingMode == FRAME_PACING_MODE::FRAME_PACING_VSYNC || pacingMode == FRAME_PACING_MODE::FRAME_PACING_WAITABLE_SWAPCHAIN) ? (syncInterval) : (0);
+}
+
+UINT WindowManager::GetPresentFlags()
+{
+    //Tearing is only allowed for presents that don't wait for the vertical blank
+    return (tearing && GetPresentSyncInterval() == 0) ? (DXGI_PRESENT_ALLOW_TEARING) : (0);
+}
+
+
+#ifdef _WIN32
+
 
 LRESULT CALLBACK WindowProcedure(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 {
@@ -122,6 +289,9 @@ LRESULT CALLBACK WindowProcedure(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
     case WM_DESTROY:
         PostQuitMessage(0); //Posts a quit message to the message queue
         break;
+    case WM_SIZE:
+        if (wParam != SIZE_MINIMIZED) { WindowManager::Resize(LOWORD(lParam), HIWORD(lParam)); }
+        break;
     default:
         return DefWindowProc(hwnd, msg, wParam, lParam); //Default window procedure for this message
     }
@@ -139,7 +309,11 @@ HWND WindowSetup(UINT width, UINT height)
         return NULL;
     }
 
-    HWND hwnd{ CreateWindow(wc.lpszClassName, L"Neki", WS_OVERLAPPEDWINDOW, CW_USEDEFAULT, CW_USEDEFAULT, width, height, NULL, NULL, wc.hInstance, NULL) };
+    //The requested size is the client area the swapchain covers, so grow the window by its borders and title bar
+    RECT rect{ 0, 0, static_cast<LONG>(width), static_cast<LONG>(height) };
+    AdjustWindowRect(&rect, WS_OVERLAPPEDWINDOW, FALSE);
+
+    HWND hwnd{ CreateWindow(wc.lpszClassName, L"Neki", WS_OVERLAPPEDWINDOW, CW_USEDEFAULT, CW_USEDEFAULT, rect.right - rect.left, rect.bottom - rect.top, NULL, NULL, wc.hInstance, NULL) };
 
     if (!hwnd) {
         MessageBox(NULL, L"Window Creation Failed!", L"Error", MB_ICONERROR);
@@ -149,4 +323,5 @@ HWND WindowSetup(UINT width, UINT height)
     ShowWindow(hwnd, SW_SHOW);
 
     return hwnd;
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
@@ -2,6 +2,44 @@
 
 #include <dxgi.h>
 #include <d3d11.h>
+#include <chrono>
+
+class GraphicsSwapChain;
+
+
+//How the start of each frame is paced against the display
+enum FRAME_PACING_MODE
+{
+    FRAME_PACING_UNCAPPED,           //Frames start and present as fast as possible
+    FRAME_PACING_VSYNC,              //Present waits for the vertical blank
+    FRAME_PACING_FIXED_RATE,         //Frames start at WindowDescription::targetFrameRate and present without waiting
+    FRAME_PACING_WAITABLE_SWAPCHAIN, //Vsync, with each frame held back until the swapchain can take it - input is read as late as possible
+};
+
+struct WindowDescription
+{
+    UINT winWidth;  //Client area size
+    UINT winHeight;
+
+    //Swapchain
+    DXGI_SWAP_EFFECT swapEffect; //DXGI_SWAP_EFFECT_FLIP_DISCARD is recommended - cheaper to compose and lower latency in a window
+    UINT bufferCount;            //0 for 2 - flip model swapchains need at least 2
+    bool allowTearing;           //Frames presented without vsync may tear (or drive a variable refresh rate display) - flip model only
+    UINT syncInterval;           //Vertical blanks each present waits for in the vsync pacing modes - 0 for 1
+
+    FRAME_PACING_MODE pacingMode;
+    UINT targetFrameRate;   //Frames per second for FRAME_PACING_FIXED_RATE
+    UINT maxFramesInFlight; //Frames the CPU may queue ahead of the display - 0 for 2, 1 gives the lowest latency
+};
+
+//Timings for the last frame
+struct FramePacingStatistics
+{
+    double frameTime; //Milliseconds between the starts of the last two frames
+    double waitTime;  //Milliseconds the frame spent held back by the pacer
+    UINT64 frameCount;
+};
+
 
 class WindowManager
 {
@@ -12,15 +50,41 @@ class WindowManager
 public:
     WindowManager() = default;
     ~WindowManager() = default;
+
+    [[nodiscard]] static FramePacingStatistics GetFramePacingStatistics();
+
+    //Resize the swapchain at the start of the next frame - called automatically when the window is resized, or by hand when headless
+    //Only the back buffer views are recreated, and the frame graph is rebuilt to resize its transient textures
+    static void Resize(UINT _width, UINT _height);
     
 private:
-    static void Initialise(const UINT _width, const UINT _height);
+    static void Initialise(const WindowDescription& wd);
+    //Paces the frame, then handles every message that has arrived since the last frame without blocking
     static void Update();
     static void Shutdown();
 
+    static void WaitForNextFrame();
+    static void ApplyResize();
+    [[nodiscard]] static UINT GetPresentSyncInterval();
+    [[nodiscard]] static UINT GetPresentFlags();
+
     static UINT width;
     static UINT height;
     
     static HWND hwnd;
-    static IDXGISwapChain* swapChain;
+    static GraphicsSwapChain* swapChain;
+    static UINT swapChainFlags;
+    static bool tearing;
+    static UINT syncInterval;
+
+    static bool resizePending;
+    static UINT pendingWidth;
+    static UINT pendingHeight;
+
+    static FRAME_PACING_MODE pacingMode;
+    static HANDLE frameLatencyWaitableObject;
+    static std::chrono::steady_clock::duration framePeriod;
+    static std::chrono::steady_clock::time_point nextFrameTime;
+    static std::chrono::steady_clock::time_point lastFrameStart;
+    static FramePacingStatistics statistics;
 };
\ No newline at end of file
@@ -0,0 +1,262 @@
+﻿#include "DrawQueue.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "../Managers/PipelineManager.h"
+#include "../Managers/UploadManager.h"
+#include "../Utility/Hash.h"
+
+UINT64 DrawQueue::MakeSortKey(UINT pass, UINT shader, UINT material, float depth, bool backToFront)
+{
+    depth = (std::clamp)(depth, 0.0f, 1.0f);
+    UINT64 quantisedDepth{ static_cast<UINT64>(depth * static_cast<float>(0xFFFFFF)) };
+    if (backToFront) { quantisedDepth = 0xFFFFFF - quantisedDepth; }
+
+    return (static_cast<UINT64>(pass & 0xFF) << 56)
+         | (static_cast<UINT64>(shader & 0xFFF) << 44)
+         | (static_cast<UINT64>(material & 0xFFFFF) << 24)
+         | quantisedDepth;
+}
+
+bool DrawQueue::MeshKey::operator==(const MeshKey& other) const
+{
+    return vertexBuffer == other.vertexBuffer && indexBuffer == other.indexBuffer && vertexOffset == other.vertexOffset
+        && count == other.count && startLocation == other.startLocation && baseVertexLocation == other.baseVertexLocation;
+}
+
+size_t DrawQueue::MeshKey::Hash() const
+{
+    static_assert(sizeof(MeshKey) == 2 * sizeof(ID3D11Buffer*) + 4 * sizeof(UINT), "MeshKey is hashed bytewise, so it must not have padding");
+    return static_cast<size_t>(HashBytes(this, sizeof(MeshKey)));
+}
+
+//Whether two instanced items can be drawn by the same instanced draw - everything but their depth and instance data has to match
+static bool CanInstance(const DrawItem& a, const DrawItem& b)
+{
+    return a.vertexShader == b.vertexShader && a.pixelShader == b.pixelShader && a.inputLayout == b.inputLayout && a.primitiveTopology == b.primitiveTopology
+        && a.vertexBuffer == b.vertexBuffer && a.vertexStride == b.vertexStride && a.vertexOffset == b.vertexOffset
+        && a.indexBuffer == b.indexBuffer && (!a.indexBuffer || a.indexFormat == b.indexFormat)
+        && std::equal(std::begin(a.constantBuffers), std::end(a.constantBuffers), std::begin(b.constantBuffers))
+        && std::equal(std::begin(a.constantBufferFirstConstants), std::end(a.constantBufferFirstConstants), std::begin(b.constantBufferFirstConstants))
+        && std::equal(std::begin(a.constantBufferNumConstants), std::end(a.constantBufferNumConstants), std::begin(b.constantBufferNumConstants))
+        && std::equal(std::begin(a.shaderResourceViews), std::end(a.shaderResourceViews), std::begin(b.shaderResourceViews))
+        && std::equal(std::begin(a.samplerStates), std::end(a.samplerStates), std::begin(b.samplerStates))
+        && a.count == b.count && a.startLocation == b.startLocation && a.baseVertexLocation == b.baseVertexLocation
+        && a.instanceDataSize == b.instanceDataSize;
+}
+
+void DrawQueue::Submit(const DrawItem& item)
+{
+    records.push_back(SortRecord{ item.sortKey, items.size() });
+    items.push_back(item);
+    //The caller's instance data only has to outlive this call
+    items.back().instanceData = nullptr;
+    instanceDataOffsets.push_back(instanceData.size());
+    if (item.instanceData && item.instanceDataSize > 0)
+    {
+        const BYTE* const data{ static_cast<const BYTE*>(item.instanceData) };
+        instanceData.insert(instanceData.end(), data, data + item.instanceDataSize);
+
+        //Mesh above depth, so the instances of one mesh sort together however they interleave with other meshes in depth
+        //Ids wrap after 2048 meshes, which only costs merging - CanInstance() still keeps different meshes apart
+        const MeshKey meshKey{ item.vertexBuffer, item.indexBuffer, item.vertexOffset, item.count, item.startLocation, item.baseVertexLocation };
+        const UINT meshId{ meshIds.try_emplace(meshKey, static_cast<UINT>(meshIds.size())).first->second };
+        records.back().key = (item.sortKey & ~0xFFFFFFull) | 0x800000 | (static_cast<UINT64>(meshId & 0x7FF) << 12) | ((item.sortKey & 0xFFFFFF) >> 12);
+    }
+    else
+    {
+        items.back().instanceDataSize = 0;
+        //Below every instanced item of the same material, so none of them can split a run
+        records.back().key = (item.sortKey & ~0xFFFFFFull) | ((item.sortKey & 0xFFFFFF) >> 1);
+    }
+}
+
+void DrawQueue::Clear()
+{
+    items.clear();
+    records.clear();
+    instanceData.clear();
+    instanceDataOffsets.clear();
+    draws.clear();
+    //Mesh ids are kept from frame to frame, so a steady scene doesn't allocate - only forgotten once they start wrapping
+    if (meshIds.size() > 0x7FF) { meshIds.clear(); }
+}
+
+void DrawQueue::Reserve(size_t count)
+{
+    items.reserve(count);
+    records.reserve(count);
+    scratch.reserve(count);
+    instanceDataOffsets.reserve(count);
+    draws.reserve(count);
+}
+
+void DrawQueue::Sort()
+{
+    //LSD radix sort on 8-bit digits
+    //All eight histograms are built in a single pass over the keys, and any digit that is identical across every key
+    //(typically most of the pass and shader bytes) is skipped entirely
+    const size_t n{ records.size() };
+    if (n < 2)
+    {
+        BuildDraws();
+        return;
+    }
+
+    UINT histograms[8][256];
+    std::memset(histograms, 0, sizeof(histograms));
+    for (const SortRecord& r : records)
+    {
+        for (UINT d{ 0 }; d < 8; ++d)
+        {
+            ++histograms[d][(r.key >> (d * 8)) & 0xFF];
+        }
+    }
+
+    scratch.resize(n);
+    SortRecord* src{ records.data() };
+    SortRecord* dst{ scratch.data() };
+    for (UINT d{ 0 }; d < 8; ++d)
+    {
+        UINT* histogram{ histograms[d] };
+        if (histogram[(src[0].key >> (d * 8)) & 0xFF] == n) { continue; }
+
+        //Exclusive prefix sum gives each bucket's first output position
+        UINT offset{ 0 };
+        for (UINT b{ 0 }; b < 256; ++b)
+        {
+            const UINT count{ histogram[b] };
+            histogram[b] = offset;
+            offset += count;
+        }
+
+        for (size_t i{ 0 }; i < n; ++i)
+        {
+            dst[histogram[(src[i].key >> (d * 8)) & 0xFF]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != records.data())
+    {
+        records.swap(scratch);
+    }
+    BuildDraws();
+}
+
+void DrawQueue::Execute() const
+{
+    ExecuteDrawRecords(draws.data(), draws.data() + draws.size());
+}
+
+void DrawQueue::ExecutePasses(UINT firstPass, UINT lastPass) const
+{
+    size_t begin;
+    size_t end;
+    FindPasses(firstPass, lastPass, begin, end);
+    ExecuteRange(begin, end);
+}
+
+void DrawQueue::FindPasses(UINT firstPass, UINT lastPass, size_t& begin, size_t& end) const
+{
+    begin = 0;
+    end = 0;
+    if (firstPass > lastPass || firstPass > 0xFF) { return; }
+    lastPass = (std::min)(lastPass, 0xFFu);
+
+    //The pass is the key's top byte, so once sorted each pass range is one contiguous run of draws (batches never span passes)
+    const UINT64 firstKey{ static_cast<UINT64>(firstPass) << 56 };
+    const auto first{ std::lower_bound(draws.begin(), draws.end(), firstKey, [](const DrawRecord& d, UINT64 key) { return d.key < key; }) };
+    const auto last{ std::find_if(first, draws.end(), [lastPass](const DrawRecord& d) { return (d.key >> 56) > lastPass; }) };
+    begin = static_cast<size_t>(first - draws.begin());
+    end = static_cast<size_t>(last - draws.begin());
+}
+
+void DrawQueue::ExecuteRange(size_t begin, size_t end) const
+{
+    end = (std::min)(end, draws.size());
+    if (begin >= end) { return; }
+    ExecuteDrawRecords(draws.data() + begin, draws.data() + end);
+}
+
+void DrawQueue::BuildDraws()
+{
+    //Only adjacent items are merged, and only those sharing the key's pass, shader and material fields, so batching never reorders the queue
+    draws.clear();
+    const size_t n{ records.size() };
+    for (size_t i{ 0 }; i < n;)
+    {
+        const DrawItem& item{ items[records[i].index] };
+        if (item.instanceDataSize == 0)
+        {
+            draws.push_back(DrawRecord{ records[i].key, static_cast<UINT>(i), 0, nullptr, 0 });
+            ++i;
+            continue;
+        }
+
+        size_t end{ i + 1 };
+        while (end < n && (records[end].key >> 24) == (records[i].key >> 24) && CanInstance(item, items[records[end].index])) { ++end; }
+
+        //The batch's instance data is gathered in sorted order, so each instance sits at its position in the batch
+        const size_t size{ item.instanceDataSize };
+        instanceScratch.resize((end - i) * size);
+        for (size_t r{ i }; r < end; ++r)
+        {
+            std::memcpy(instanceScratch.data() + (r - i) * size, instanceData.data() + instanceDataOffsets[records[r].index], size);
+        }
+        const UploadAllocation allocation{ UploadManager::UploadVertexData(instanceScratch.data(), static_cast<UINT>(instanceScratch.size())) };
+        if (allocation.buffer)
+        {
+            draws.push_back(DrawRecord{ records[i].key, static_cast<UINT>(i), static_cast<UINT>(end - i), allocation.buffer, allocation.offset });
+        }
+        else
+        {
+            std::cerr << "ERROR::DRAW_QUEUE::BUILD_DRAWS::FAILED_TO_UPLOAD_INSTANCE_DATA" << std::endl;
+        }
+        i = end;
+    }
+}
+
+void DrawQueue::ExecuteDrawRecords(const DrawRecord* begin, const DrawRecord* end) const
+{
+    static_assert(DRAW_ITEM_INSTANCE_SLOT == 1, "The instance stream is bound along with the vertex buffer in slot 0");
+    for (const DrawRecord* d{ begin }; d != end; ++d)
+    {
+        const DrawItem& item{ items[records[d->first].index] };
+
+        //Every call goes through the binding cache, which drops whatever the previous item already bound
+        PipelineManager::BindVertexShader(item.vertexShader);
+        PipelineManager::BindPixelShader(item.pixelShader);
+        PipelineManager::BindInputLayout(item.inputLayout);
+        PipelineManager::BindPrimitiveTopology(item.primitiveTopology);
+        if (d->instanceCount > 0)
+        {
+            ID3D11Buffer* const vertexBuffers[2]{ item.vertexBuffer, d->instanceBuffer };
+            const UINT strides[2]{ item.vertexStride, item.instanceDataSize };
+            const UINT offsets[2]{ item.vertexOffset, d->instanceOffset };
+            PipelineManager::BindVertexBuffers(vertexBuffers, 0, 2, strides, offsets);
+        }
+        else
+        {
+            PipelineManager::BindVertexBuffers(&item.vertexBuffer, 0, 1, item.vertexStride, item.vertexOffset);
+        }
+        PipelineManager::BindConstantBufferRanges(PIPELINE_STAGE::VERTEX_SHADER, 0, DRAW_ITEM_MAX_CONSTANT_BUFFERS, item.constantBuffers, item.constantBufferFirstConstants, item.constantBufferNumConstants);
+        PipelineManager::BindConstantBufferRanges(PIPELINE_STAGE::PIXEL_SHADER, 0, DRAW_ITEM_MAX_CONSTANT_BUFFERS, item.constantBuffers, item.constantBufferFirstConstants, item.constantBufferNumConstants);
+        PipelineManager::BindShaderResourceViews(item.shaderResourceViews, PIPELINE_STAGE::PIXEL_SHADER, 0, DRAW_ITEM_MAX_SHADER_RESOURCE_VIEWS);
+        PipelineManager::BindSamplerStates(item.samplerStates, PIPELINE_STAGE::PIXEL_SHADER, 0, DRAW_ITEM_MAX_SAMPLER_STATES);
+
+        if (item.indexBuffer)
+        {
+            PipelineManager::BindIndexBuffer(item.indexBuffer, item.indexFormat);
+            if (d->instanceCount > 0) { PipelineManager::DrawIndexedInstanced(item.count, d->instanceCount, item.startLocation, item.baseVertexLocation); }
+            else                      { PipelineManager::DrawIndexed(item.count, item.startLocation, item.baseVertexLocation); }
+        }
+        else
+        {
+            if (d->instanceCount > 0) { PipelineManager::DrawInstanced(item.count, d->instanceCount, item.startLocation); }
+            else                      { PipelineManager::Draw(item.count, item.startLocation); }
+        }
+    }
+}
\ No newline at end of file
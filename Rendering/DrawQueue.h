@@ -0,0 +1,148 @@
+﻿#pragma once
+#include <d3d11.h>
+#include <unordered_map>
+#include <vector>
+
+//Queue of draw items ordered by a packed 64-bit sort key
+//Items are submitted in any order, radix sorted once per frame on their keys, then translated into PipelineManager calls
+//so that draws sharing a pass/shader/material end up adjacent and the binding cache can drop the redundant state changes
+//
+//Key layout (most significant first):
+//  [63:56] pass      - coarse ordering (e.g. depth prepass, opaque, transparent)
+//  [55:44] shader    - program id
+//  [43:24] material  - resource set id (textures, samplers, material constants)
+//  [23:0]  depth     - quantised view depth, front-to-back (or back-to-front when requested)
+//
+//Items carrying instance data are batched after sorting: a run of them that differ only in depth and instance data becomes
+//one instanced draw, with their instance data packed into a per-instance vertex stream (e.g. foliage or crowds sharing a mesh and material)
+//So that instances of different meshes interleaved in depth still form runs, the queue rewrites the depth field on submission:
+//  [23]    instanced - 0 for items drawn on their own, which keep the top 23 bits of their depth in [22:0]
+//  [22:12] mesh      - id of an instanced item's vertex/index range, assigned per queue in first submission order
+//  [11:0]  depth     - the top 12 bits of an instanced item's depth, so each batch is still roughly depth ordered
+//Within a material, items drawn on their own therefore go first and each mesh's instances follow as one run - blended
+//geometry that relies on back-to-front order across meshes should be submitted without instance data
+
+
+//Maximum resources a single draw item can carry per stage
+constexpr UINT DRAW_ITEM_MAX_CONSTANT_BUFFERS{ 4 };
+constexpr UINT DRAW_ITEM_MAX_SHADER_RESOURCE_VIEWS{ 8 };
+constexpr UINT DRAW_ITEM_MAX_SAMPLER_STATES{ 4 };
+//Vertex buffer slot the packed instance data of instanced items is bound to
+constexpr UINT DRAW_ITEM_INSTANCE_SLOT{ 1 };
+
+
+struct DrawItem
+{
+    UINT64 sortKey;
+
+    ID3D11VertexShader* vertexShader;
+    ID3D11PixelShader* pixelShader;
+    ID3D11InputLayout* inputLayout;
+    D3D11_PRIMITIVE_TOPOLOGY primitiveTopology;
+
+    ID3D11Buffer* vertexBuffer;
+    UINT vertexStride;
+    UINT vertexOffset;
+    ID3D11Buffer* indexBuffer; //Null for non-indexed draws
+    DXGI_FORMAT indexFormat;
+
+    //Bound to both the vertex and pixel shader from slot 0, null entries unbind their slot
+    ID3D11Buffer* constantBuffers[DRAW_ITEM_MAX_CONSTANT_BUFFERS];
+    //Window of each constant buffer to bind (see PipelineManager::BindConstantBufferRanges), e.g. from UploadManager::UploadConstantData - 0 constants binds the whole buffer
+    UINT constantBufferFirstConstants[DRAW_ITEM_MAX_CONSTANT_BUFFERS];
+    UINT constantBufferNumConstants[DRAW_ITEM_MAX_CONSTANT_BUFFERS];
+    //Bound to the pixel shader from slot 0, null entries unbind their slot
+    ID3D11ShaderResourceView* shaderResourceViews[DRAW_ITEM_MAX_SHADER_RESOURCE_VIEWS];
+    ID3D11SamplerState* samplerStates[DRAW_ITEM_MAX_SAMPLER_STATES];
+
+    UINT count;           //Vertex count, or index count for indexed draws
+    UINT startLocation;   //Start vertex, or start index for indexed draws
+    INT baseVertexLocation;
+
+    //Per-instance data (e.g. a world transform) read through D3D11_INPUT_PER_INSTANCE_DATA elements in slot DRAW_ITEM_INSTANCE_SLOT
+    //Copied on submission - null (and 0) for items drawn without instancing
+    const void* instanceData;
+    UINT instanceDataSize;
+};
+
+
+class DrawQueue
+{
+public:
+    DrawQueue() = default;
+    ~DrawQueue() = default;
+
+    //Packs the key fields - values wider than their field are truncated, depth is clamped to [0,1]
+    [[nodiscard]] static UINT64 MakeSortKey(UINT pass, UINT shader, UINT material, float depth, bool backToFront=false);
+
+    void Submit(const DrawItem& item);
+    //Removes all items, keeping the allocations for the next frame
+    void Clear();
+    void Reserve(size_t count);
+
+    //Orders the submitted items by sort key (stable, so equal keys keep their submission order), then batches instanced items
+    //and uploads their instance data through the UploadManager - main thread only
+    void Sort();
+    //Translates the draws into PipelineManager calls in sorted order - Sort() must have been called since the last Submit()
+    void Execute() const;
+    //As Execute(), but only for the draws whose key has a pass field in [firstPass, lastPass] (e.g. the draws of one frame graph pass)
+    void ExecutePasses(UINT firstPass, UINT lastPass) const;
+    //Sorted index range [begin, end) of the draws whose key has a pass field in [firstPass, lastPass]
+    void FindPasses(UINT firstPass, UINT lastPass, size_t& begin, size_t& end) const;
+    //As Execute(), but only for the sorted draws [begin, end) - safe to call from several threads at once on disjoint ranges
+    void ExecuteRange(size_t begin, size_t end) const;
+
+    [[nodiscard]] size_t GetCount() const { return items.size(); }
+    //Draw calls the sorted items were batched into
+    [[nodiscard]] size_t GetDrawCount() const { return draws.size(); }
+    [[nodiscard]] const DrawItem& GetSortedItem(size_t index) const { return items[records[index].index]; }
+
+private:
+    //Sort keys are stored separately from the (much larger) items, so the sort only moves 16-byte records
+    struct SortRecord
+    {
+        UINT64 key;
+        UINT64 index;
+    };
+
+    //Vertex/index range an instanced item draws - instanced items with different ranges can never share a draw
+    struct MeshKey
+    {
+        ID3D11Buffer* vertexBuffer;
+        ID3D11Buffer* indexBuffer;
+        UINT vertexOffset;
+        UINT count;
+        UINT startLocation;
+        INT baseVertexLocation;
+
+        [[nodiscard]] bool operator==(const MeshKey& other) const;
+        [[nodiscard]] size_t Hash() const;
+    };
+
+    struct MeshKeyHash
+    {
+        [[nodiscard]] size_t operator()(const MeshKey& key) const { return key.Hash(); }
+    };
+
+    //One draw call - a single sorted record, or a run of instanced records merged into one instanced draw
+    struct DrawRecord
+    {
+        UINT64 key;             //Of the first record
+        UINT first;             //Sorted record index
+        UINT instanceCount;     //0 for a non-instanced item
+        ID3D11Buffer* instanceBuffer;
+        UINT instanceOffset;
+    };
+
+    std::vector<DrawItem> items;
+    std::vector<SortRecord> records;
+    std::vector<SortRecord> scratch;
+    std::vector<BYTE> instanceData;           //Instance data of every item, in submission order
+    std::vector<size_t> instanceDataOffsets;  //Per item
+    std::vector<DrawRecord> draws;
+    std::vector<BYTE> instanceScratch;        //One batch's instance data in sorted order, for upload
+    std::unordered_map<MeshKey, UINT, MeshKeyHash> meshIds; //Of the instanced items submitted in recent frames
+
+    void BuildDraws();
+    void ExecuteDrawRecords(const DrawRecord* begin, const DrawRecord* end) const;
+};
\ No newline at end of file
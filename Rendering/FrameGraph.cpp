@@ -0,0 +1,671 @@
+﻿#include "FrameGraph.h"
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <queue>
+
+#include "GpuProfiler.h"
+#include "../Managers/PipelineManager.h"
+#include "../Utility/Format.h"
+
+constexpr UINT FRAME_GRAPH_NO_PHYSICAL_TEXTURE{ static_cast<UINT>(-1) };
+
+
+static bool IsDepthFormat(DXGI_FORMAT format)
+{
+    return format == DXGI_FORMAT_D32_FLOAT || format == DXGI_FORMAT_D24_UNORM_S8_UINT || format == DXGI_FORMAT_D16_UNORM;
+}
+
+//Depth textures that are also sampled have to be created typeless, with the depth and colour interpretations given by their views
+static DXGI_FORMAT GetDepthTypelessFormat(DXGI_FORMAT format)
+{
+    switch (format)
+    {
+    case (DXGI_FORMAT_D32_FLOAT):         return DXGI_FORMAT_R32_TYPELESS;
+    case (DXGI_FORMAT_D24_UNORM_S8_UINT): return DXGI_FORMAT_R24G8_TYPELESS;
+    case (DXGI_FORMAT_D16_UNORM):         return DXGI_FORMAT_R16_TYPELESS;
+    default:                              return format;
+    }
+}
+
+static DXGI_FORMAT GetDepthShaderResourceFormat(DXGI_FORMAT format)
+{
+    switch (format)
+    {
+    case (DXGI_FORMAT_D32_FLOAT):         return DXGI_FORMAT_R32_FLOAT;
+    case (DXGI_FORMAT_D24_UNORM_S8_UINT): return DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
+    case (DXGI_FORMAT_D16_UNORM):         return DXGI_FORMAT_R16_UNORM;
+    default:                              return format;
+    }
+}
+
+
+
+
+//-----------------------------------------------//
+//--------------------BUILDER--------------------//
+//-----------------------------------------------//
+FrameGraphResource FrameGraphBuilder::CreateTexture(const char* name, const FrameGraphTextureDescription& description)
+{
+    if (description.format == DXGI_FORMAT_UNKNOWN)
+    {
+        std::cerr << "ERROR::FRAME_GRAPH::CREATE_TEXTURE::FORMAT_MUST_BE_KNOWN" << std::endl;
+        return {};
+    }
+
+    FrameGraph::ResourceNode node{};
+    node.name = name;
+    node.description = description;
+    node.imported = false;
+    graph.resources.push_back(std::move(node));
+    graph.compiled = false;
+    return FrameGraphResource{ static_cast<UINT>(graph.resources.size() - 1) };
+}
+
+void FrameGraphBuilder::Read(FrameGraphResource resource)
+{
+    if (!graph.ValidateResource(resource, "READ")) { return; }
+    FrameGraph::PassNode& node{ graph.passes[pass] };
+    FrameGraph::ResourceNode& resourceNode{ graph.resources[resource.index] };
+
+    //A texture can't be bound as a shader resource and an output at the same time
+    if (std::find(node.renderTargets.begin(), node.renderTargets.end(), resource.index) != node.renderTargets.end() || node.depthStencil.index == resource.index)
+    {
+        std::cerr << "ERROR::FRAME_GRAPH::READ::PASS_CANNOT_READ_AND_WRITE_THE_SAME_RESOURCE::" << node.name << "::" << resourceNode.name << std::endl;
+        return;
+    }
+    if (std::find(node.reads.begin(), node.reads.end(), resource.index) != node.reads.end()) { return; }
+
+    node.reads.push_back(resource.index);
+    resourceNode.readers.push_back(pass);
+    resourceNode.bindFlags |= D3D11_BIND_SHADER_RESOURCE;
+}
+
+void FrameGraphBuilder::WriteRenderTarget(FrameGraphResource resource, bool clear)
+{
+    if (!graph.ValidateResource(resource, "WRITE_RENDER_TARGET")) { return; }
+    FrameGraph::PassNode& node{ graph.passes[pass] };
+    FrameGraph::ResourceNode& resourceNode{ graph.resources[resource.index] };
+
+    if (IsDepthFormat(resourceNode.description.format))
+    {
+        std::cerr << "ERROR::FRAME_GRAPH::WRITE_RENDER_TARGET::DEPTH_FORMAT_MUST_BE_WRITTEN_AS_DEPTH_STENCIL::" << node.name << "::" << resourceNode.name << std::endl;
+        return;
+    }
+    if (std::find(node.reads.begin(), node.reads.end(), resource.index) != node.reads.end())
+    {
+        std::cerr << "ERROR::FRAME_GRAPH::WRITE_RENDER_TARGET::PASS_CANNOT_READ_AND_WRITE_THE_SAME_RESOURCE::" << node.name << "::" << resourceNode.name << std::endl;
+        return;
+    }
+    if (std::find(node.renderTargets.begin(), node.renderTargets.end(), resource.index) != node.renderTargets.end()) { return; }
+    if (node.renderTargets.size() >= D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT)
+    {
+        std::cerr << "ERROR::FRAME_GRAPH::WRITE_RENDER_TARGET::TOO_MANY_RENDER_TARGETS::" << node.name << std::endl;
+        return;
+    }
+
+    node.renderTargets.push_back(resource.index);
+    node.clearRenderTargets.push_back(clear);
+    resourceNode.writers.push_back(pass);
+    resourceNode.bindFlags |= D3D11_BIND_RENDER_TARGET;
+}
+
+void FrameGraphBuilder::WriteDepthStencil(FrameGraphResource resource, bool clear)
+{
+    if (!graph.ValidateResource(resource, "WRITE_DEPTH_STENCIL")) { return; }
+    FrameGraph::PassNode& node{ graph.passes[pass] };
+    FrameGraph::ResourceNode& resourceNode{ graph.resources[resource.index] };
+
+    if (!resourceNode.imported && !IsDepthFormat(resourceNode.description.format))
+    {
+        std::cerr << "ERROR::FRAME_GRAPH::WRITE_DEPTH_STENCIL::RESOURCE_DOES_NOT_HAVE_A_DEPTH_FORMAT::" << node.name << "::" << resourceNode.name << std::endl;
+        return;
+    }
+    if (std::find(node.reads.begin(), node.reads.end(), resource.index) != node.reads.end())
+    {
+        std::cerr << "ERROR::FRAME_GRAPH::WRITE_DEPTH_STENCIL::PASS_CANNOT_READ_AND_WRITE_THE_SAME_RESOURCE::" << node.name << "::" << resourceNode.name << std::endl;
+        return;
+    }
+    if (node.depthStencil.IsValid())
+    {
+        std::cerr << "ERROR::FRAME_GRAPH::WRITE_DEPTH_STENCIL::PASS_ALREADY_HAS_A_DEPTH_STENCIL_TARGET::" << node.name << std::endl;
+        return;
+    }
+
+    node.depthStencil = resource;
+    node.clearDepthStencil = clear;
+    resourceNode.writers.push_back(pass);
+    resourceNode.bindFlags |= D3D11_BIND_DEPTH_STENCIL;
+}
+
+void FrameGraphBuilder::SetSideEffects()
+{
+    graph.passes[pass].sideEffects = true;
+}
+//-----------------------------------------------//
+//----------------END OF BUILDER-----------------//
+//-----------------------------------------------//
+
+
+
+//-----------------------------------------------//
+//----------------PASS RESOURCES-----------------//
+//-----------------------------------------------//
+ID3D11Texture2D* FrameGraphPassResources::GetTexture(FrameGraphResource resource) const
+{
+    return (IsDeclared(resource, "GET_TEXTURE")) ? (graph.GetTexture(resource.index)) : (nullptr);
+}
+
+ID3D11ShaderResourceView* FrameGraphPassResources::GetShaderResourceView(FrameGraphResource resource) const
+{
+    return (IsDeclared(resource, "GET_SHADER_RESOURCE_VIEW")) ? (graph.GetShaderResourceView(resource.index)) : (nullptr);
+}
+
+ID3D11RenderTargetView* FrameGraphPassResources::GetRenderTargetView(FrameGraphResource resource) const
+{
+    return (IsDeclared(resource, "GET_RENDER_TARGET_VIEW")) ? (graph.GetRenderTargetView(resource.index)) : (nullptr);
+}
+
+ID3D11DepthStencilView* FrameGraphPassResources::GetDepthStencilView(FrameGraphResource resource) const
+{
+    return (IsDeclared(resource, "GET_DEPTH_STENCIL_VIEW")) ? (graph.GetDepthStencilView(resource.index)) : (nullptr);
+}
+
+bool FrameGraphPassResources::IsDeclared(FrameGraphResource resource, const char* caller) const
+{
+    const FrameGraph::PassNode& node{ graph.passes[pass] };
+    const bool declared{ std::find(node.reads.begin(), node.reads.end(), resource.index) != node.reads.end()
+                      || std::find(node.renderTargets.begin(), node.renderTargets.end(), resource.index) != node.renderTargets.end()
+                      || (resource.IsValid() && node.depthStencil.index == resource.index) };
+    if (!declared)
+    {
+        std::cerr << "ERROR::FRAME_GRAPH::" << caller << "::RESOURCE_NOT_DECLARED_BY_PASS::" << node.name << std::endl;
+    }
+    return declared;
+}
+//-----------------------------------------------//
+//------------END OF PASS RESOURCES--------------//
+//-----------------------------------------------//
+
+
+
+//-----------------------------------------------//
+//-------------------BUILDING--------------------//
+//-----------------------------------------------//
+FrameGraphResource FrameGraph::ImportTexture(const char* name, const FrameGraphImportedTexture& texture)
+{
+    if (!texture.texture)
+    {
+        std::cerr << "ERROR::FRAME_GRAPH::IMPORT_TEXTURE::TEXTURE_IS_NULL::" << name << std::endl;
+        return {};
+    }
+
+    ResourceNode node{};
+    node.name = name;
+    node.imported = true;
+    node.importedTexture = texture;
+    node.description.width = texture.width;
+    node.description.height = texture.height;
+    std::copy_n(texture.clearColour, 4, node.description.clearColour);
+    node.description.clearDepth = texture.clearDepth;
+    node.description.clearStencil = texture.clearStencil;
+    resources.push_back(std::move(node));
+    compiled = false;
+    return FrameGraphResource{ static_cast<UINT>(resources.size() - 1) };
+}
+
+void FrameGraph::AddPass(const char* name, const FrameGraphSetupFunction& setup, const FrameGraphExecuteFunction& execute)
+{
+    PassNode node{};
+    node.name = name;
+    node.execute = execute;
+    passes.push_back(std::move(node));
+    compiled = false;
+
+    FrameGraphBuilder builder{ *this, static_cast<UINT>(passes.size() - 1) };
+    setup(builder);
+}
+
+void FrameGraph::Reset()
+{
+    resources.clear();
+    passes.clear();
+    executionOrder.clear();
+    compiled = false;
+}
+
+void FrameGraph::SetReferenceSize(UINT width, UINT height)
+{
+    if (width == referenceWidth && height == referenceHeight) { return; }
+    referenceWidth = width;
+    referenceHeight = height;
+    compiled = false;
+}
+//-----------------------------------------------//
+//---------------END OF BUILDING-----------------//
+//-----------------------------------------------//
+
+
+
+//-----------------------------------------------//
+//------------COMPILING AND EXECUTING------------//
+//-----------------------------------------------//
+bool FrameGraph::Compile()
+{
+    statistics = {};
+    statistics.passes = static_cast<UINT>(passes.size());
+    executionOrder.clear();
+
+    CullPasses();
+    if (!OrderPasses() || !AllocateTransientTextures())
+    {
+        executionOrder.clear();
+        return false;
+    }
+
+    compiled = true;
+    return true;
+}
+
+void FrameGraph::Execute()
+{
+    if (!compiled && !Compile()) { return; }
+
+    for (UINT p : executionOrder)
+    {
+        PassNode& node{ passes[p] };
+        const UINT scope{ (profiler) ? (profiler->BeginScope(node.name.c_str())) : (GPU_PROFILER_INVALID_SCOPE) };
+
+        //Bind the pass's targets, with the viewport covering the first of them
+        //A pass without targets (e.g. a compute pass) still unbinds the previous pass's, as it may access them through other views
+        passRenderTargetViews.clear();
+        for (UINT r : node.renderTargets)
+        {
+            passRenderTargetViews.push_back(GetRenderTargetView(r));
+        }
+        ID3D11DepthStencilView* depthStencilView{ (node.depthStencil.IsValid()) ? (GetDepthStencilView(node.depthStencil.index)) : (nullptr) };
+        PipelineManager::BindRenderTargetViews(passRenderTargetViews);
+        PipelineManager::BindDepthStencilView(depthStencilView);
+
+        if (!node.renderTargets.empty() || node.depthStencil.IsValid())
+        {
+            const ResourceNode& target{ resources[(!node.renderTargets.empty()) ? (node.renderTargets[0]) : (node.depthStencil.index)] };
+            PipelineManager::BindViewport(D3D11_VIEWPORT{ 0.0f, 0.0f, static_cast<FLOAT>(target.width), static_cast<FLOAT>(target.height), 0.0f, 1.0f });
+
+            for (size_t i{ 0 }; i < node.renderTargets.size(); ++i)
+            {
+                if (node.clearRenderTargets[i])
+                {
+                    PipelineManager::ClearRenderTargetView(passRenderTargetViews[i], resources[node.renderTargets[i]].description.clearColour);
+                }
+            }
+            if (node.clearDepthStencil)
+            {
+                const ResourceNode& depth{ resources[node.depthStencil.index] };
+                PipelineManager::ClearDepthStencilView(depthStencilView, depth.description.clearDepth, depth.description.clearStencil);
+            }
+        }
+
+        node.execute(FrameGraphPassResources{ *this, p });
+
+        //Textures read here may be written by a later pass, and the binding cache has to know they are no longer bound by then
+        for (UINT r : node.reads)
+        {
+            PipelineManager::UnbindShaderResourceView(GetShaderResourceView(r));
+        }
+
+        if (profiler) { profiler->EndScope(scope); }
+    }
+}
+
+void FrameGraph::ReleaseTransientTextures()
+{
+    for (PhysicalTexture& physical : physicalTextures)
+    {
+        ReleasePhysicalTexture(physical);
+    }
+    physicalTextures.clear();
+    for (ResourceNode& node : resources)
+    {
+        node.physicalTexture = FRAME_GRAPH_NO_PHYSICAL_TEXTURE;
+    }
+    compiled = false;
+}
+
+std::vector<const char*> FrameGraph::GetExecutionOrder() const
+{
+    std::vector<const char*> names;
+    names.reserve(executionOrder.size());
+    for (UINT p : executionOrder)
+    {
+        names.push_back(passes[p].name.c_str());
+    }
+    return names;
+}
+//-----------------------------------------------//
+//--------END OF COMPILING AND EXECUTING---------//
+//-----------------------------------------------//
+
+
+
+bool FrameGraph::ValidateResource(FrameGraphResource resource, const char* caller) const
+{
+    if (!resource.IsValid() || resource.index >= resources.size())
+    {
+        std::cerr << "ERROR::FRAME_GRAPH::" << caller << "::INVALID_RESOURCE" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void FrameGraph::CullPasses()
+{
+    //Reference counting from the unused resources back up the graph
+    //A pass is referenced by every resource it writes, a resource by every pass that reads it, and imported resources by the outside world
+    std::vector<UINT> unreferenced;
+    for (UINT r{ 0 }; r < resources.size(); ++r)
+    {
+        ResourceNode& node{ resources[r] };
+        node.referenceCount = static_cast<UINT>(node.readers.size()) + ((node.imported) ? (1) : (0));
+        if (node.referenceCount == 0) { unreferenced.push_back(r); }
+    }
+
+    const std::function<void(PassNode&)> cull{ [&](PassNode& pass)
+    {
+        pass.culled = true;
+        ++statistics.culledPasses;
+        for (UINT r : pass.reads)
+        {
+            if (--resources[r].referenceCount == 0) { unreferenced.push_back(r); }
+        }
+    } };
+
+    for (PassNode& pass : passes)
+    {
+        pass.referenceCount = static_cast<UINT>(pass.renderTargets.size()) + ((pass.depthStencil.IsValid()) ? (1) : (0));
+        pass.culled = false;
+    }
+    for (PassNode& pass : passes)
+    {
+        if (pass.referenceCount == 0 && !pass.sideEffects) { cull(pass); }
+    }
+
+    while (!unreferenced.empty())
+    {
+        const UINT r{ unreferenced.back() };
+        unreferenced.pop_back();
+        for (UINT w : resources[r].writers)
+        {
+            PassNode& writer{ passes[w] };
+            if (writer.culled || writer.referenceCount == 0) { continue; }
+            if (--writer.referenceCount == 0 && !writer.sideEffects) { cull(writer); }
+        }
+    }
+}
+
+bool FrameGraph::OrderPasses()
+{
+    //Each texture's writers run in the order they were added, and all of them before any of its readers
+    std::vector<std::vector<UINT>> successors(passes.size());
+    std::vector<UINT> predecessorCounts(passes.size(), 0);
+    const auto addEdge{ [&](UINT from, UINT to)
+    {
+        successors[from].push_back(to);
+        ++predecessorCounts[to];
+    } };
+
+    for (const ResourceNode& node : resources)
+    {
+        UINT previousWriter{ static_cast<UINT>(-1) };
+        bool written{ false };
+        for (UINT w : node.writers)
+        {
+            if (passes[w].culled) { continue; }
+            if (written) { addEdge(previousWriter, w); }
+            previousWriter = w;
+            written = true;
+            for (UINT r : node.readers)
+            {
+                if (!passes[r].culled) { addEdge(w, r); }
+            }
+        }
+
+        if (!written && !node.imported)
+        {
+            for (UINT r : node.readers)
+            {
+                if (!passes[r].culled)
+                {
+                    std::cerr << "ERROR::FRAME_GRAPH::COMPILE::RESOURCE_READ_BUT_NEVER_WRITTEN::" << node.name << "::" << passes[r].name << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+
+    //Kahn's algorithm, always taking the earliest-added pass that is ready
+    std::priority_queue<UINT, std::vector<UINT>, std::greater<UINT>> ready;
+    UINT livePasses{ 0 };
+    for (UINT p{ 0 }; p < passes.size(); ++p)
+    {
+        if (passes[p].culled) { continue; }
+        ++livePasses;
+        if (predecessorCounts[p] == 0) { ready.push(p); }
+    }
+
+    executionOrder.reserve(livePasses);
+    while (!ready.empty())
+    {
+        const UINT p{ ready.top() };
+        ready.pop();
+        executionOrder.push_back(p);
+        for (UINT s : successors[p])
+        {
+            if (--predecessorCounts[s] == 0) { ready.push(s); }
+        }
+    }
+
+    if (executionOrder.size() != livePasses)
+    {
+        std::cerr << "ERROR::FRAME_GRAPH::COMPILE::PASS_DEPENDENCIES_FORM_A_CYCLE" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool FrameGraph::AllocateTransientTextures()
+{
+    std::vector<UINT> positions(passes.size(), 0);
+    for (UINT i{ 0 }; i < executionOrder.size(); ++i)
+    {
+        positions[executionOrder[i]] = i;
+    }
+
+    //Work out each resource's size and lifetime in the execution order
+    std::vector<UINT> transients;
+    for (UINT r{ 0 }; r < resources.size(); ++r)
+    {
+        ResourceNode& node{ resources[r] };
+        node.physicalTexture = FRAME_GRAPH_NO_PHYSICAL_TEXTURE;
+        node.width = (node.description.width != 0) ? (node.description.width) : (referenceWidth);
+        node.height = (node.description.height != 0) ? (node.description.height) : (referenceHeight);
+
+        node.firstUse = static_cast<UINT>(-1);
+        node.lastUse = 0;
+        for (const std::vector<UINT>* users : { &node.writers, &node.readers })
+        {
+            for (UINT p : *users)
+            {
+                if (passes[p].culled) { continue; }
+                node.firstUse = (std::min)(node.firstUse, positions[p]);
+                node.lastUse = (std::max)(node.lastUse, positions[p]);
+            }
+        }
+        if (node.firstUse == static_cast<UINT>(-1)) { continue; }
+
+        if (node.imported)
+        {
+            //Imported textures only need the views the passes will use
+            const bool missingView{ ((node.bindFlags & D3D11_BIND_RENDER_TARGET) && !node.importedTexture.renderTargetView)
+                                 || ((node.bindFlags & D3D11_BIND_DEPTH_STENCIL) && !node.importedTexture.depthStencilView)
+                                 || ((node.bindFlags & D3D11_BIND_SHADER_RESOURCE) && !node.importedTexture.shaderResourceView) };
+            if (missingView)
+            {
+                std::cerr << "ERROR::FRAME_GRAPH::COMPILE::IMPORTED_TEXTURE_IS_MISSING_A_VIEW::" << node.name << std::endl;
+                return false;
+            }
+            continue;
+        }
+        if (node.width == 0 || node.height == 0)
+        {
+            std::cerr << "ERROR::FRAME_GRAPH::COMPILE::TEXTURE_HAS_NO_SIZE::" << node.name << std::endl;
+            return false;
+        }
+        transients.push_back(r);
+    }
+    std::stable_sort(transients.begin(), transients.end(), [this](UINT a, UINT b) { return resources[a].firstUse < resources[b].firstUse; });
+
+    //Greedily hand each resource the first matching physical texture that is free by the time it's first used,
+    //preferring textures this compile has already assigned (true aliasing) over ones left over from the last compile
+    for (PhysicalTexture& physical : physicalTextures)
+    {
+        physical.assigned = false;
+        physical.availableFrom = 0;
+    }
+    for (UINT r : transients)
+    {
+        ResourceNode& node{ resources[r] };
+        const auto matches{ [&](const PhysicalTexture& physical)
+        {
+            return physical.width == node.width && physical.height == node.height
+                && physical.format == node.description.format && physical.bindFlags == node.bindFlags;
+        } };
+
+        UINT chosen{ FRAME_GRAPH_NO_PHYSICAL_TEXTURE };
+        for (UINT i{ 0 }; i < physicalTextures.size(); ++i)
+        {
+            const PhysicalTexture& physical{ physicalTextures[i] };
+            if (!matches(physical)) { continue; }
+            if (physical.assigned && physical.availableFrom < node.firstUse) { chosen = i; break; }
+            if (!physical.assigned && chosen == FRAME_GRAPH_NO_PHYSICAL_TEXTURE) { chosen = i; }
+        }
+
+        if (chosen == FRAME_GRAPH_NO_PHYSICAL_TEXTURE)
+        {
+            PhysicalTexture physical{};
+            physical.width = node.width;
+            physical.height = node.height;
+            physical.format = node.description.format;
+            physical.bindFlags = node.bindFlags;
+            if (!CreatePhysicalTexture(physical))
+            {
+                std::cerr << "ERROR::FRAME_GRAPH::COMPILE::FAILED_TO_CREATE_TRANSIENT_TEXTURE::" << node.name << std::endl;
+                return false;
+            }
+            physicalTextures.push_back(physical);
+            chosen = static_cast<UINT>(physicalTextures.size() - 1);
+        }
+
+        PhysicalTexture& physical{ physicalTextures[chosen] };
+        physical.assigned = true;
+        physical.availableFrom = node.lastUse;
+        node.physicalTexture = chosen;
+
+        ++statistics.transientTextures;
+        statistics.transientBytes += static_cast<UINT64>(node.width) * node.height * GetBitsPerPixel(node.description.format) / 8;
+    }
+
+    //Release what the graph no longer needs and compact the survivors
+    std::vector<UINT> remap(physicalTextures.size(), FRAME_GRAPH_NO_PHYSICAL_TEXTURE);
+    UINT kept{ 0 };
+    for (UINT i{ 0 }; i < physicalTextures.size(); ++i)
+    {
+        if (!physicalTextures[i].assigned)
+        {
+            ReleasePhysicalTexture(physicalTextures[i]);
+            continue;
+        }
+        remap[i] = kept;
+        physicalTextures[kept++] = physicalTextures[i];
+    }
+    physicalTextures.resize(kept);
+    for (UINT r : transients)
+    {
+        resources[r].physicalTexture = remap[resources[r].physicalTexture];
+    }
+
+    statistics.physicalTextures = kept;
+    for (const PhysicalTexture& physical : physicalTextures)
+    {
+        statistics.physicalBytes += static_cast<UINT64>(physical.width) * physical.height * GetBitsPerPixel(physical.format) / 8;
+    }
+    return true;
+}
+
+bool FrameGraph::CreatePhysicalTexture(PhysicalTexture& physical)
+{
+    const bool sampledDepth{ IsDepthFormat(physical.format) && (physical.bindFlags & D3D11_BIND_SHADER_RESOURCE) };
+    physical.texture = ResourceManager::CreateRenderTexture2D(physical.width, physical.height, (sampledDepth) ? (GetDepthTypelessFormat(physical.format)) : (physical.format), physical.bindFlags);
+    if (physical.texture.IsNull()) { return false; }
+
+    bool created{ true };
+    if (physical.bindFlags & D3D11_BIND_RENDER_TARGET)
+    {
+        physical.renderTargetView = ResourceManager::CreateTexture2DRenderTargetView(physical.texture, 0, physical.format);
+        created = created && !physical.renderTargetView.IsNull();
+    }
+    if (physical.bindFlags & D3D11_BIND_DEPTH_STENCIL)
+    {
+        physical.depthStencilView = ResourceManager::CreateTexture2DDepthStencilView(physical.texture, 0, physical.format);
+        created = created && !physical.depthStencilView.IsNull();
+    }
+    if (physical.bindFlags & D3D11_BIND_SHADER_RESOURCE)
+    {
+        physical.shaderResourceView = ResourceManager::CreateTexture2DShaderResourceView(physical.texture, 0, 1, GetDepthShaderResourceFormat(physical.format));
+        created = created && !physical.shaderResourceView.IsNull();
+    }
+
+    if (!created) { ReleasePhysicalTexture(physical); }
+    return created;
+}
+
+void FrameGraph::ReleasePhysicalTexture(PhysicalTexture& physical)
+{
+    ResourceManager::Release(physical.renderTargetView);
+    ResourceManager::Release(physical.depthStencilView);
+    ResourceManager::Release(physical.shaderResourceView);
+    ResourceManager::Release(physical.texture);
+    physical.renderTargetView = {};
+    physical.depthStencilView = {};
+    physical.shaderResourceView = {};
+    physical.texture = {};
+}
+
+ID3D11Texture2D* FrameGraph::GetTexture(UINT resource) const
+{
+    const ResourceNode& node{ resources[resource] };
+    if (node.imported) { return node.importedTexture.texture; }
+    return (node.physicalTexture != FRAME_GRAPH_NO_PHYSICAL_TEXTURE) ? (ResourceManager::Get(physicalTextures[node.physicalTexture].texture)) : (nullptr);
+}
+
+ID3D11ShaderResourceView* FrameGraph::GetShaderResourceView(UINT resource) const
+{
+    const ResourceNode& node{ resources[resource] };
+    if (node.imported) { return node.importedTexture.shaderResourceView; }
+    return (node.physicalTexture != FRAME_GRAPH_NO_PHYSICAL_TEXTURE) ? (ResourceManager::Get(physicalTextures[node.physicalTexture].shaderResourceView)) : (nullptr);
+}
+
+ID3D11RenderTargetView* FrameGraph::GetRenderTargetView(UINT resource) const
+{
+    const ResourceNode& node{ resources[resource] };
+    if (node.imported) { return node.importedTexture.renderTargetView; }
+    return (node.physicalTexture != FRAME_GRAPH_NO_PHYSICAL_TEXTURE) ? (ResourceManager::Get(physicalTextures[node.physicalTexture].renderTargetView)) : (nullptr);
+}
+
+ID3D11DepthStencilView* FrameGraph::GetDepthStencilView(UINT resource) const
+{
+    const ResourceNode& node{ resources[resource] };
+    if (node.imported) { return node.importedTexture.depthStencilView; }
+    return (node.physicalTexture != FRAME_GRAPH_NO_PHYSICAL_TEXTURE) ? (ResourceManager::Get(physicalTextures[node.physicalTexture].depthStencilView)) : (nullptr);
+}
\ No newline at end of file
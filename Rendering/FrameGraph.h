@@ -0,0 +1,240 @@
+﻿#pragma once
+#include <d3d11.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../Managers/ResourceManager.h"
+
+//Render pass scheduler
+//Passes declare the textures they read and the targets they write when they are added; compiling the graph then
+//  - culls every pass whose output is never read (passes writing imported textures, or flagged with side effects, are always kept)
+//  - orders the remaining passes so each texture's writers run before its readers, otherwise keeping the order they were added in
+//  - allocates the transient textures, giving textures whose lifetimes (first to last use in the ordered passes) don't overlap
+//    the same physical texture when their descriptions match
+//Executing the graph binds each pass's render targets and viewport, applies the requested clears and calls the pass,
+//so passes only bind what they actually draw with - a pass without targets runs with none bound, and with a profiler
+//attached, each pass is also timed as a GPU scope named after it
+//
+//A transient texture's contents are undefined until its first writer clears or fully overwrites it, since the physical
+//texture behind it is shared with other transient textures
+
+
+struct FrameGraphResource
+{
+    UINT index{ static_cast<UINT>(-1) };
+
+    [[nodiscard]] bool IsValid() const { return index != static_cast<UINT>(-1); }
+};
+
+struct FrameGraphTextureDescription
+{
+    UINT width;  //0 for the graph's reference (back buffer) width
+    UINT height; //0 for the graph's reference (back buffer) height
+    DXGI_FORMAT format; //Depth formats (D32_FLOAT, D24_UNORM_S8_UINT, D16_UNORM) are written as depth stencil targets
+
+    //Used by writers that request a clear
+    FLOAT clearColour[4];
+    FLOAT clearDepth;
+    UINT8 clearStencil;
+};
+
+//Externally owned texture made available to the graph, e.g. the swapchain back buffer
+//Only the views the graph will need have to be provided
+struct FrameGraphImportedTexture
+{
+    ID3D11Texture2D* texture;
+    UINT width;
+    UINT height;
+    ID3D11RenderTargetView* renderTargetView;
+    ID3D11DepthStencilView* depthStencilView;
+    ID3D11ShaderResourceView* shaderResourceView;
+
+    FLOAT clearColour[4];
+    FLOAT clearDepth;
+    UINT8 clearStencil;
+};
+
+//Counters for the last compile
+struct FrameGraphStatistics
+{
+    UINT passes;
+    UINT culledPasses;
+    UINT transientTextures; //Transient textures used by the passes that weren't culled
+    UINT physicalTextures;  //Textures actually allocated for them
+    UINT64 transientBytes;  //Memory the transient textures would need without aliasing
+    UINT64 physicalBytes;   //Memory they need with it
+};
+
+
+class FrameGraph;
+class GpuProfiler;
+
+//Handed to a pass's setup function to declare what the pass does
+class FrameGraphBuilder
+{
+    friend class FrameGraph;
+
+public:
+    [[nodiscard]] FrameGraphResource CreateTexture(const char* name, const FrameGraphTextureDescription& description);
+
+    //Texture is sampled by the pass - its shader resource view is available while the pass executes
+    void Read(FrameGraphResource resource);
+    //Texture is bound to the next render target slot (in call order) while the pass executes
+    void WriteRenderTarget(FrameGraphResource resource, bool clear=false);
+    //Texture is bound as the depth stencil target while the pass executes
+    void WriteDepthStencil(FrameGraphResource resource, bool clear=false);
+    //The pass does work outside the graph (e.g. a readback) and must never be culled
+    void SetSideEffects();
+
+private:
+    FrameGraphBuilder(FrameGraph& _graph, UINT _pass) : graph{ _graph }, pass{ _pass } {}
+
+    FrameGraph& graph;
+    UINT pass;
+};
+
+//Handed to a pass's execute function to look up the views of the textures it declared
+class FrameGraphPassResources
+{
+    friend class FrameGraph;
+
+public:
+    [[nodiscard]] ID3D11Texture2D* GetTexture(FrameGraphResource resource) const;
+    [[nodiscard]] ID3D11ShaderResourceView* GetShaderResourceView(FrameGraphResource resource) const;
+    [[nodiscard]] ID3D11RenderTargetView* GetRenderTargetView(FrameGraphResource resource) const;
+    [[nodiscard]] ID3D11DepthStencilView* GetDepthStencilView(FrameGraphResource resource) const;
+
+private:
+    FrameGraphPassResources(const FrameGraph& _graph, UINT _pass) : graph{ _graph }, pass{ _pass } {}
+
+    [[nodiscard]] bool IsDeclared(FrameGraphResource resource, const char* caller) const;
+
+    const FrameGraph& graph;
+    UINT pass;
+};
+
+using FrameGraphSetupFunction = std::function<void(FrameGraphBuilder&)>;
+using FrameGraphExecuteFunction = std::function<void(const FrameGraphPassResources&)>;
+
+
+class FrameGraph
+{
+    friend class FrameGraphBuilder;
+    friend class FrameGraphPassResources;
+
+public:
+    FrameGraph() = default;
+    ~FrameGraph() = default;
+
+    FrameGraph(const FrameGraph&) = delete;
+    FrameGraph& operator=(const FrameGraph&) = delete;
+
+    //----Building----//
+    [[nodiscard]] FrameGraphResource ImportTexture(const char* name, const FrameGraphImportedTexture& texture);
+    //setup is called immediately, execute every time the graph is executed (unless the pass is culled)
+    void AddPass(const char* name, const FrameGraphSetupFunction& setup, const FrameGraphExecuteFunction& execute);
+    //Removes every pass and resource - physical textures are kept for the next compile to reuse
+    void Reset();
+
+    //Size that transient textures with a width/height of 0 take
+    void SetReferenceSize(UINT width, UINT height);
+
+
+    //----Compiling and Executing----//
+    //Called by Execute() whenever the graph has changed since the last compile
+    bool Compile();
+    void Execute();
+
+    //Releases every physical texture - must be called before the ResourceManager shuts down
+    void ReleaseTransientTextures();
+
+    //Null to stop timing passes
+    void SetProfiler(GpuProfiler* _profiler) { profiler = _profiler; }
+
+    [[nodiscard]] FrameGraphStatistics GetStatistics() const { return statistics; }
+    //Names of the passes that will execute, in execution order
+    [[nodiscard]] std::vector<const char*> GetExecutionOrder() const;
+
+private:
+    struct ResourceNode
+    {
+        std::string name;
+        FrameGraphTextureDescription description;
+        bool imported;
+        FrameGraphImportedTexture importedTexture;
+
+        UINT bindFlags;            //Union of every pass's use of the texture
+        std::vector<UINT> writers; //Passes in declaration order
+        std::vector<UINT> readers;
+
+        //Filled in by Compile()
+        UINT width;
+        UINT height;
+        UINT referenceCount;
+        UINT firstUse;
+        UINT lastUse;
+        UINT physicalTexture;
+    };
+
+    struct PassNode
+    {
+        std::string name;
+        FrameGraphExecuteFunction execute;
+
+        std::vector<UINT> reads;
+        std::vector<UINT> renderTargets;
+        std::vector<bool> clearRenderTargets;
+        FrameGraphResource depthStencil;
+        bool clearDepthStencil;
+        bool sideEffects;
+
+        //Filled in by Compile()
+        UINT referenceCount;
+        bool culled;
+    };
+
+    //Textures are shared between transient resources whose description and bind flags match exactly
+    struct PhysicalTexture
+    {
+        UINT width;
+        UINT height;
+        DXGI_FORMAT format;
+        UINT bindFlags;
+
+        Texture2DHandle texture;
+        RenderTargetViewHandle renderTargetView;
+        DepthStencilViewHandle depthStencilView;
+        ShaderResourceViewHandle shaderResourceView;
+
+        UINT availableFrom; //Position in the execution order after which the texture is free again
+        bool assigned;      //Used by the current compile
+    };
+
+    std::vector<ResourceNode> resources;
+    std::vector<PassNode> passes;
+    std::vector<UINT> executionOrder;
+    std::vector<PhysicalTexture> physicalTextures;
+
+    UINT referenceWidth{ 0 };
+    UINT referenceHeight{ 0 };
+    bool compiled{ false };
+    FrameGraphStatistics statistics{};
+    GpuProfiler* profiler{ nullptr };
+
+    std::vector<ID3D11RenderTargetView*> passRenderTargetViews; //Scratch for binding each pass's targets
+
+
+    //Utility functions
+    [[nodiscard]] bool ValidateResource(FrameGraphResource resource, const char* caller) const;
+    void CullPasses();
+    [[nodiscard]] bool OrderPasses();
+    [[nodiscard]] bool AllocateTransientTextures();
+    [[nodiscard]] bool CreatePhysicalTexture(PhysicalTexture& physical);
+    static void ReleasePhysicalTexture(PhysicalTexture& physical);
+
+    [[nodiscard]] ID3D11Texture2D* GetTexture(UINT resource) const;
+    [[nodiscard]] ID3D11ShaderResourceView* GetShaderResourceView(UINT resource) const;
+    [[nodiscard]] ID3D11RenderTargetView* GetRenderTargetView(UINT resource) const;
+    [[nodiscard]] ID3D11DepthStencilView* GetDepthStencilView(UINT resource) const;
+};
\ No newline at end of file
@@ -0,0 +1,270 @@
+﻿#include "GpuProfiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+
+
+bool GpuProfiler::Initialise(GraphicsDevice* _device, GraphicsContext* _context, UINT frameLatency, UINT _historyLength)
+{
+    if (!_device || !_context || frameLatency == 0 || _historyLength == 0)
+    {
+        std::cerr << "ERROR::GPU_PROFILER::INITIALISE::INVALID_ARGUMENTS" << std::endl;
+        return false;
+    }
+    device = _device;
+    context = _context;
+    historyLength = _historyLength;
+
+    frames.resize(frameLatency);
+    for (FrameQueries& frame : frames)
+    {
+        frame.disjoint = CreateQuery(D3D11_QUERY_TIMESTAMP_DISJOINT);
+        if (!frame.disjoint)
+        {
+            std::cerr << "ERROR::GPU_PROFILER::INITIALISE::FAILED_TO_CREATE_DISJOINT_QUERY" << std::endl;
+            Shutdown();
+            return false;
+        }
+    }
+    return true;
+}
+
+void GpuProfiler::Shutdown()
+{
+    if (!device) { return; }
+    for (FrameQueries& frame : frames)
+    {
+        device->ReleaseObject(frame.disjoint);
+        for (ID3D11Query* query : frame.timestamps)
+        {
+            device->ReleaseObject(query);
+        }
+    }
+    frames.clear();
+    timers.clear();
+    counters = {};
+    recordIndex = 0;
+    resolveIndex = 0;
+    recording = false;
+    depth = 0;
+    device = nullptr;
+    context = nullptr;
+}
+
+
+
+//-----------------------------------------------//
+//-------------------RECORDING-------------------//
+//-----------------------------------------------//
+void GpuProfiler::BeginFrame()
+{
+    if (!device) { return; }
+    Resolve();
+
+    FrameQueries& frame{ frames[recordIndex] };
+    if (frame.pending)
+    {
+        //Every slot is still in flight - waiting for it is exactly the stall the ring exists to avoid
+        ++counters.droppedFrames;
+        return;
+    }
+
+    recording = true;
+    depth = 0;
+    frame.scopeTimers.clear();
+    context->Begin(frame.disjoint);
+    frameScope = BeginScope("Frame");
+}
+
+void GpuProfiler::EndFrame()
+{
+    if (!recording) { return; }
+
+    EndScope(frameScope);
+    FrameQueries& frame{ frames[recordIndex] };
+    context->End(frame.disjoint);
+    frame.pending = true;
+    recordIndex = (recordIndex + 1) % static_cast<UINT>(frames.size());
+    recording = false;
+}
+
+UINT GpuProfiler::BeginScope(const char* name)
+{
+    if (!recording) { return GPU_PROFILER_INVALID_SCOPE; }
+
+    FrameQueries& frame{ frames[recordIndex] };
+    const UINT scope{ static_cast<UINT>(frame.scopeTimers.size()) };
+    if (scope == GPU_PROFILER_MAX_SCOPES_PER_FRAME) { return GPU_PROFILER_INVALID_SCOPE; }
+
+    //Grow the frame's pool of timestamps the first time it records this many scopes
+    while (frame.timestamps.size() < (scope + 1) * 2)
+    {
+        ID3D11Query* query{ CreateQuery(D3D11_QUERY_TIMESTAMP) };
+        if (!query)
+        {
+            std::cerr << "ERROR::GPU_PROFILER::BEGIN_SCOPE::FAILED_TO_CREATE_TIMESTAMP_QUERY" << std::endl;
+            return GPU_PROFILER_INVALID_SCOPE;
+        }
+        frame.timestamps.push_back(query);
+    }
+
+    const UINT timer{ FindTimer(name) };
+    if (timers[timer].count == 0) { timers[timer].depth = depth; }
+    frame.scopeTimers.push_back(timer);
+    ++depth;
+    context->End(frame.timestamps[scope * 2]);
+    return scope;
+}
+
+void GpuProfiler::EndScope(UINT scope)
+{
+    if (!recording || scope == GPU_PROFILER_INVALID_SCOPE) { return; }
+
+    FrameQueries& frame{ frames[recordIndex] };
+    if (scope >= frame.scopeTimers.size())
+    {
+        std::cerr << "ERROR::GPU_PROFILER::END_SCOPE::SCOPE_NOT_BEGUN_THIS_FRAME" << std::endl;
+        return;
+    }
+    --depth;
+    context->End(frame.timestamps[scope * 2 + 1]);
+}
+//-----------------------------------------------//
+//----------------END OF RECORDING---------------//
+//-----------------------------------------------//
+
+
+
+//-----------------------------------------------//
+//--------------------RESULTS--------------------//
+//-----------------------------------------------//
+std::vector<GpuScopeStatistics> GpuProfiler::GetStatistics() const
+{
+    std::vector<GpuScopeStatistics> statistics;
+    statistics.reserve(timers.size());
+    for (const Timer& timer : timers)
+    {
+        if (timer.count == 0) { continue; }
+        statistics.push_back(ComputeStatistics(timer));
+    }
+    return statistics;
+}
+
+bool GpuProfiler::GetStatistics(const char* name, GpuScopeStatistics& statistics) const
+{
+    for (const Timer& timer : timers)
+    {
+        if (timer.count == 0 || timer.name != name) { continue; }
+        statistics = ComputeStatistics(timer);
+        return true;
+    }
+    return false;
+}
+//-----------------------------------------------//
+//-----------------END OF RESULTS----------------//
+//-----------------------------------------------//
+
+
+
+//-----------------------------------------------//
+//---------------UTILITY FUNCTIONS---------------//
+//-----------------------------------------------//
+ID3D11Query* GpuProfiler::CreateQuery(D3D11_QUERY type) const
+{
+    const D3D11_QUERY_DESC desc{ type, 0 };
+    ID3D11Query* query;
+    if (FAILED(device->CreateQuery(&desc, &query))) { return nullptr; }
+    return query;
+}
+
+UINT GpuProfiler::FindTimer(const char* name)
+{
+    //Only a handful of scopes are ever live, so a linear search beats hashing (and allocating) the name every call
+    for (UINT i{ 0 }; i < timers.size(); ++i)
+    {
+        if (timers[i].name == name) { return i; }
+    }
+    Timer timer{};
+    timer.name = name;
+    timer.history.resize(historyLength);
+    timers.push_back(std::move(timer));
+    return static_cast<UINT>(timers.size() - 1);
+}
+
+void GpuProfiler::Resolve()
+{
+    //Frames finish in the order they were submitted, so stop at the first one the GPU hasn't finished
+    while (frames[resolveIndex].pending)
+    {
+        if (!ResolveFrame(frames[resolveIndex])) { return; }
+        frames[resolveIndex].pending = false;
+        resolveIndex = (resolveIndex + 1) % static_cast<UINT>(frames.size());
+    }
+}
+
+bool GpuProfiler::ResolveFrame(FrameQueries& frame)
+{
+    D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+    if (context->GetData(frame.disjoint, &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) { return false; }
+
+    ++counters.resolvedFrames;
+    if (disjoint.Disjoint || disjoint.Frequency == 0)
+    {
+        ++counters.disjointFrames;
+        return true;
+    }
+
+    //The disjoint query ends after every timestamp in the frame, so they're all available by now
+    const double millisecondsPerTick{ 1000.0 / static_cast<double>(disjoint.Frequency) };
+    for (size_t scope{ 0 }; scope < frame.scopeTimers.size(); ++scope)
+    {
+        UINT64 begin;
+        UINT64 end;
+        if (context->GetData(frame.timestamps[scope * 2], &begin, sizeof(begin), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+            context->GetData(frame.timestamps[scope * 2 + 1], &end, sizeof(end), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+            end < begin)
+        {
+            continue;
+        }
+
+        Timer& timer{ timers[frame.scopeTimers[scope]] };
+        timer.last = static_cast<double>(end - begin) * millisecondsPerTick;
+        timer.history[timer.next] = timer.last;
+        timer.next = (timer.next + 1) % historyLength;
+        timer.count = (std::min)(timer.count + 1, historyLength);
+    }
+    return true;
+}
+
+GpuScopeStatistics GpuProfiler::ComputeStatistics(const Timer& timer) const
+{
+    //The ring's order doesn't matter once the samples are sorted
+    std::vector<double> samples{ timer.history.begin(), timer.history.begin() + timer.count };
+    std::sort(samples.begin(), samples.end());
+
+    //Nearest rank
+    const auto percentile{ [&samples](double p)
+    {
+        const size_t rank{ static_cast<size_t>(std::ceil(p * static_cast<double>(samples.size()))) };
+        return samples[(std::max)(rank, size_t{ 1 }) - 1];
+    } };
+
+    GpuScopeStatistics statistics{};
+    statistics.name = timer.name;
+    statistics.depth = timer.depth;
+    statistics.samples = timer.count;
+    statistics.last = timer.last;
+    statistics.average = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+    statistics.minimum = samples.front();
+    statistics.maximum = samples.back();
+    statistics.median = percentile(0.5);
+    statistics.percentile95 = percentile(0.95);
+    statistics.percentile99 = percentile(0.99);
+    return statistics;
+}
+//-----------------------------------------------//
+//-----------END OF UTILITY FUNCTIONS------------//
+//-----------------------------------------------//
\ No newline at end of file
@@ -0,0 +1,116 @@
+﻿#pragma once
+#include <d3d11.h>
+#include <string>
+#include <vector>
+
+#include "../Backends/GraphicsDevice.h"
+
+//GPU timer built on timestamp queries
+//Each frame is bracketed by a TIMESTAMP_DISJOINT query and every scope by a pair of TIMESTAMP queries
+//The queries of the last frameLatency frames are kept in a ring and read back without flushing once the GPU has finished with them,
+//so profiling never stalls the CPU - a frame is simply not profiled if its slot in the ring is still waiting on the GPU
+//Results are kept per scope name over the last historyLength frames the scope appeared in
+//
+//Must only be used from the main thread, on the immediate context
+
+
+constexpr UINT GPU_PROFILER_INVALID_SCOPE{ static_cast<UINT>(-1) };
+constexpr UINT GPU_PROFILER_MAX_SCOPES_PER_FRAME{ 256 };
+
+//Timings in milliseconds over a scope's history
+struct GpuScopeStatistics
+{
+    std::string name;
+    UINT depth;   //Nesting depth - the whole frame is a scope named "Frame" at depth 0
+    UINT samples; //Frames in the history
+
+    double last;
+    double average;
+    double minimum;
+    double maximum;
+    double median;
+    double percentile95;
+    double percentile99;
+};
+
+struct GpuProfilerCounters
+{
+    UINT64 resolvedFrames; //Frames whose timings were read back
+    UINT64 droppedFrames;  //Frames not profiled because every slot of the ring was still waiting on the GPU
+    UINT64 disjointFrames; //Frames read back but discarded because the GPU clock was unreliable (e.g. its frequency changed)
+};
+
+
+class GpuProfiler
+{
+public:
+    GpuProfiler() = default;
+    ~GpuProfiler() = default;
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    //frameLatency has to cover how many frames the GPU runs behind the CPU, or frames will be dropped
+    bool Initialise(GraphicsDevice* _device, GraphicsContext* _context, UINT frameLatency=4, UINT _historyLength=120);
+    void Shutdown();
+    [[nodiscard]] bool IsInitialised() const { return device != nullptr; }
+
+    //----Recording----//
+    //Reads back whichever earlier frames the GPU has finished, then opens the "Frame" scope
+    void BeginFrame();
+    void EndFrame();
+    //Scopes nest, and must be ended in reverse order before the frame ends
+    //Returns GPU_PROFILER_INVALID_SCOPE (which EndScope() ignores) when the frame isn't being profiled
+    [[nodiscard]] UINT BeginScope(const char* name);
+    void EndScope(UINT scope);
+
+    //----Results----//
+    //Every scope seen so far, in the order they were first seen
+    [[nodiscard]] std::vector<GpuScopeStatistics> GetStatistics() const;
+    //False if the scope has no samples yet
+    [[nodiscard]] bool GetStatistics(const char* name, GpuScopeStatistics& statistics) const;
+    [[nodiscard]] GpuProfilerCounters GetCounters() const { return counters; }
+
+private:
+    //Queries for one frame in flight - timestamps are created on demand and kept, two per scope
+    struct FrameQueries
+    {
+        ID3D11Query* disjoint;
+        std::vector<ID3D11Query*> timestamps;
+        std::vector<UINT> scopeTimers; //Timer each of this frame's scopes resolves into
+        bool pending;                  //Ended and not yet read back
+    };
+
+    //History of one scope name
+    struct Timer
+    {
+        std::string name;
+        UINT depth;
+        std::vector<double> history; //Ring of the last historyLength samples
+        UINT next;
+        UINT count;
+        double last;
+    };
+
+    GraphicsDevice* device{ nullptr };
+    GraphicsContext* context{ nullptr };
+    UINT historyLength{ 0 };
+
+    std::vector<FrameQueries> frames;
+    UINT recordIndex{ 0 };  //Slot the current frame records into
+    UINT resolveIndex{ 0 }; //Oldest slot that may still be pending
+    bool recording{ false };
+    UINT frameScope{ GPU_PROFILER_INVALID_SCOPE };
+    UINT depth{ 0 };
+
+    std::vector<Timer> timers;
+    GpuProfilerCounters counters{};
+
+
+    //Utility functions
+    [[nodiscard]] ID3D11Query* CreateQuery(D3D11_QUERY type) const;
+    [[nodiscard]] UINT FindTimer(const char* name);
+    void Resolve();
+    [[nodiscard]] bool ResolveFrame(FrameQueries& frame);
+    [[nodiscard]] GpuScopeStatistics ComputeStatistics(const Timer& timer) const;
+};
\ No newline at end of file
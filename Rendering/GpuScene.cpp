@@ -0,0 +1,338 @@
+﻿#include "GpuScene.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#include "../Managers/PipelineManager.h"
+#include "../Managers/UploadManager.h"
+#include "../Utility/CpuProfiler.h"
+
+//Bytes per batch in the args buffer - the instanced (4 UINT) and indexed instanced (5 UINT) layouts both keep the instance count at +4
+constexpr UINT GPU_SCENE_ARGS_STRIDE{ 5 * sizeof(UINT) };
+constexpr UINT GPU_SCENE_ARGS_INSTANCE_COUNT_OFFSET{ sizeof(UINT) };
+
+
+void GpuScene::Initialise(GraphicsContext* _context, const char* _cullingShaderPath)
+{
+    context = _context;
+    cullingShaderPath = (_cullingShaderPath) ? (_cullingShaderPath) : (GPU_SCENE_DEFAULT_CULLING_SHADER);
+}
+
+void GpuScene::Reset()
+{
+    ReleaseBuffers();
+    batches.clear();
+    instances.clear();
+    capacity = 0;
+    buffersDirty = false;
+    instancesDirty = false;
+    cullDispatches = 0;
+    indirectDraws = 0;
+    //Shader objects belong to the ShaderManager, which keeps them for the lifetime of the engine
+    cullingShader = {};
+}
+
+
+
+//-----------------------------------------------//
+//--------------------BATCHES--------------------//
+//-----------------------------------------------//
+UINT GpuScene::AddBatch(const GpuBatchDescription& description)
+{
+    PROFILE_FUNCTION();
+    if (!context)
+    {
+        std::cerr << "ERROR::GPU_SCENE::ADD_BATCH::NOT_INITIALISED" << std::endl;
+        return GPU_SCENE_INVALID_BATCH;
+    }
+    if (description.maxInstances == 0 || description.count == 0 || !description.vertexShader)
+    {
+        std::cerr << "ERROR::GPU_SCENE::ADD_BATCH::INVALID_DESCRIPTION" << std::endl;
+        return GPU_SCENE_INVALID_BATCH;
+    }
+    if (cullingShader.IsNull())
+    {
+        static_assert(GPU_SCENE_CULL_THREAD_GROUP_SIZE == 64, "THREAD_GROUP_SIZE define is out of date");
+        const D3D_SHADER_MACRO defines[]{ { "THREAD_GROUP_SIZE", "64" }, { nullptr, nullptr } };
+        cullingShader = ShaderManager::LoadComputeShader(cullingShaderPath, "CullInstances", defines);
+        if (cullingShader.IsNull())
+        {
+            std::cerr << "ERROR::GPU_SCENE::ADD_BATCH::FAILED_TO_LOAD_CULLING_SHADER" << std::endl;
+            return GPU_SCENE_INVALID_BATCH;
+        }
+    }
+
+    Batch batch{};
+    batch.description = description;
+    batch.firstInstance = capacity;
+    batches.push_back(batch);
+    capacity += description.maxInstances;
+    instances.resize(capacity);
+    buffersDirty = true;
+    return static_cast<UINT>(batches.size() - 1);
+}
+
+void GpuScene::SetInstances(UINT batch, const GpuInstance* _instances, UINT count)
+{
+    PROFILE_FUNCTION();
+    if (batch >= batches.size() || (!_instances && count > 0))
+    {
+        std::cerr << "ERROR::GPU_SCENE::SET_INSTANCES::INVALID_BATCH_OR_INSTANCES" << std::endl;
+        return;
+    }
+    Batch& b{ batches[batch] };
+    if (count > b.description.maxInstances)
+    {
+        std::cerr << "ERROR::GPU_SCENE::SET_INSTANCES::COUNT_EXCEEDS_MAX_INSTANCES" << std::endl;
+        count = b.description.maxInstances;
+    }
+    if (count > 0) { std::memcpy(instances.data() + b.firstInstance, _instances, count * sizeof(GpuInstance)); }
+    b.instanceCount = count;
+    instancesDirty = true;
+}
+
+GpuSceneStatistics GpuScene::GetStatistics() const
+{
+    GpuSceneStatistics statistics{};
+    statistics.batches = static_cast<UINT>(batches.size());
+    for (const Batch& batch : batches) { statistics.instances += batch.instanceCount; }
+    statistics.capacity = capacity;
+    statistics.cullDispatches = cullDispatches;
+    statistics.indirectDraws = indirectDraws;
+    return statistics;
+}
+//-----------------------------------------------//
+//-----------------END OF BATCHES----------------//
+//-----------------------------------------------//
+
+
+
+//-----------------------------------------------//
+//-------------------RECORDING-------------------//
+//-----------------------------------------------//
+void GpuScene::Cull(const GpuCullDescription& description)
+{
+    PROFILE_FUNCTION();
+    cullDispatches = 0;
+    if (batches.empty() || !Prepare()) { return; }
+
+    ID3D11ComputeShader* const shader{ ShaderManager::Get(cullingShader) };
+    if (!shader)
+    {
+        std::cerr << "ERROR::GPU_SCENE::CULL::CULLING_SHADER_UNAVAILABLE" << std::endl;
+        return;
+    }
+
+    CullConstants constants{};
+    ExtractFrustumPlanes(description.viewProjection, constants.frustumPlanes);
+    std::memcpy(constants.viewProjection, description.viewProjection, sizeof(constants.viewProjection));
+    if (description.depthPyramid)
+    {
+        constants.occlusionMipCount = (std::max)(description.depthPyramidMipLevels, 1u);
+        constants.occlusionSize[0] = static_cast<float>(description.depthPyramidWidth);
+        constants.occlusionSize[1] = static_cast<float>(description.depthPyramidHeight);
+    }
+
+    ID3D11ShaderResourceView* const shaderResourceViews[2]{ ResourceManager::Get(instanceShaderResourceView), description.depthPyramid };
+    ID3D11Buffer* const args{ ResourceManager::Get(argsBuffer) };
+    PipelineManager::BindComputeShader(shader);
+    PipelineManager::BindShaderResourceViews(shaderResourceViews, PIPELINE_STAGE::COMPUTE_SHADER, 0, 2);
+
+    for (UINT i{ 0 }; i < batches.size(); ++i)
+    {
+        const Batch& batch{ batches[i] };
+        //Empty batches are skipped by Draw() as well, so their stale args are never read
+        if (batch.instanceCount == 0) { continue; }
+
+        constants.firstInstance = batch.firstInstance;
+        constants.instanceCount = batch.instanceCount;
+        const UploadAllocation allocation{ UploadManager::UploadConstantData(&constants, sizeof(constants)) };
+        if (!allocation.buffer)
+        {
+            std::cerr << "ERROR::GPU_SCENE::CULL::FAILED_TO_UPLOAD_CULL_CONSTANTS" << std::endl;
+            continue;
+        }
+        UploadManager::BindConstantData(PIPELINE_STAGE::COMPUTE_SHADER, 0, allocation);
+
+        //An initial count of 0 empties the batch's visible list before the dispatch appends to it
+        ID3D11UnorderedAccessView* const visible{ ResourceManager::Get(batch.visibleUnorderedAccessView) };
+        UINT initialCount{ 0 };
+        PipelineManager::BindUnorderedAccessViews(&visible, PIPELINE_STAGE::COMPUTE_SHADER, 0, 1, &initialCount);
+        PipelineManager::Dispatch((batch.instanceCount + GPU_SCENE_CULL_THREAD_GROUP_SIZE - 1) / GPU_SCENE_CULL_THREAD_GROUP_SIZE);
+        PipelineManager::CopyStructureCount(args, i * GPU_SCENE_ARGS_STRIDE + GPU_SCENE_ARGS_INSTANCE_COUNT_OFFSET, visible);
+        ++cullDispatches;
+    }
+}
+
+void GpuScene::Draw()
+{
+    PROFILE_FUNCTION();
+    indirectDraws = 0;
+    if (batches.empty() || !Prepare()) { return; }
+
+    ID3D11Buffer* const args{ ResourceManager::Get(argsBuffer) };
+    ID3D11ShaderResourceView* instanceViews[2]{ ResourceManager::Get(instanceShaderResourceView), nullptr };
+    for (UINT i{ 0 }; i < batches.size(); ++i)
+    {
+        const Batch& batch{ batches[i] };
+        if (batch.instanceCount == 0) { continue; }
+        const GpuBatchDescription& d{ batch.description };
+
+        PipelineManager::BindVertexShader(d.vertexShader);
+        PipelineManager::BindPixelShader(d.pixelShader);
+        PipelineManager::BindInputLayout(d.inputLayout);
+        PipelineManager::BindPrimitiveTopology(d.primitiveTopology);
+        PipelineManager::BindVertexBuffers(&d.vertexBuffer, 0, 1, d.vertexStride, d.vertexOffset);
+        PipelineManager::BindConstantBufferRanges(PIPELINE_STAGE::VERTEX_SHADER, 0, DRAW_ITEM_MAX_CONSTANT_BUFFERS, d.constantBuffers, d.constantBufferFirstConstants, d.constantBufferNumConstants);
+        PipelineManager::BindConstantBufferRanges(PIPELINE_STAGE::PIXEL_SHADER, 0, DRAW_ITEM_MAX_CONSTANT_BUFFERS, d.constantBuffers, d.constantBufferFirstConstants, d.constantBufferNumConstants);
+        PipelineManager::BindShaderResourceViews(d.shaderResourceViews, PIPELINE_STAGE::PIXEL_SHADER, 0, DRAW_ITEM_MAX_SHADER_RESOURCE_VIEWS);
+        PipelineManager::BindSamplerStates(d.samplerStates, PIPELINE_STAGE::PIXEL_SHADER, 0, DRAW_ITEM_MAX_SAMPLER_STATES);
+        //Binding the visible list for reading unbinds the culling pass's append view of it
+        instanceViews[GPU_SCENE_VISIBLE_INSTANCE_SLOT] = ResourceManager::Get(batch.visibleShaderResourceView);
+        PipelineManager::BindShaderResourceViews(instanceViews, PIPELINE_STAGE::VERTEX_SHADER, GPU_SCENE_INSTANCE_SLOT, 2);
+
+        if (d.indexBuffer)
+        {
+            PipelineManager::BindIndexBuffer(d.indexBuffer, d.indexFormat);
+            PipelineManager::DrawIndexedInstancedIndirect(args, i * GPU_SCENE_ARGS_STRIDE);
+        }
+        else
+        {
+            PipelineManager::DrawInstancedIndirect(args, i * GPU_SCENE_ARGS_STRIDE);
+        }
+        ++indirectDraws;
+    }
+}
+//-----------------------------------------------//
+//----------------END OF RECORDING---------------//
+//-----------------------------------------------//
+
+
+
+//-----------------------------------------------//
+//---------------UTILITY FUNCTIONS---------------//
+//-----------------------------------------------//
+bool GpuScene::Prepare()
+{
+    if (buffersDirty)
+    {
+        if (!BuildBuffers())
+        {
+            std::cerr << "ERROR::GPU_SCENE::PREPARE::FAILED_TO_BUILD_BUFFERS" << std::endl;
+            return false;
+        }
+        buffersDirty = false;
+        instancesDirty = true;
+    }
+    if (instancesDirty)
+    {
+        if (!UploadInstances()) { return false; }
+        instancesDirty = false;
+    }
+    return true;
+}
+
+bool GpuScene::BuildBuffers()
+{
+    PROFILE_FUNCTION();
+    ReleaseBuffers();
+
+    instanceBuffer = ResourceManager::CreateStructuredBuffer(capacity, sizeof(GpuInstance), true, false, nullptr);
+    instanceShaderResourceView = ResourceManager::CreateBufferShaderResourceView(instanceBuffer, 0, capacity, DXGI_FORMAT_UNKNOWN);
+    visibleBuffer = ResourceManager::CreateAppendConsumeBuffer(capacity, sizeof(UINT), nullptr);
+    if (instanceShaderResourceView.IsNull() || visibleBuffer.IsNull()) { return false; }
+
+    //Every count but the instance count is fixed per batch
+    std::vector<UINT> initialArgs(batches.size() * GPU_SCENE_ARGS_STRIDE / sizeof(UINT), 0);
+    for (size_t i{ 0 }; i < batches.size(); ++i)
+    {
+        Batch& batch{ batches[i] };
+        batch.visibleShaderResourceView = ResourceManager::CreateBufferShaderResourceView(visibleBuffer, batch.firstInstance, batch.description.maxInstances, DXGI_FORMAT_UNKNOWN);
+        batch.visibleUnorderedAccessView = ResourceManager::CreateBufferUnorderedAccessView(visibleBuffer, batch.firstInstance, batch.description.maxInstances, DXGI_FORMAT_UNKNOWN, D3D11_BUFFER_UAV_FLAG_APPEND);
+        if (batch.visibleShaderResourceView.IsNull() || batch.visibleUnorderedAccessView.IsNull()) { return false; }
+
+        UINT* const record{ initialArgs.data() + i * GPU_SCENE_ARGS_STRIDE / sizeof(UINT) };
+        record[0] = batch.description.count;
+        record[2] = batch.description.startLocation;
+        if (batch.description.indexBuffer) { record[3] = static_cast<UINT>(batch.description.baseVertexLocation); }
+    }
+
+    D3D11_SUBRESOURCE_DATA data{ initialArgs.data(), 0, 0 };
+    argsBuffer = ResourceManager::CreateIndirectArgsBuffer(static_cast<UINT>(initialArgs.size() * sizeof(UINT)), &data);
+    return !argsBuffer.IsNull();
+}
+
+void GpuScene::ReleaseBuffers()
+{
+    if (instanceBuffer.IsNull() && visibleBuffer.IsNull() && argsBuffer.IsNull()) { return; }
+
+    //Nothing may stay bound once released, or the binding cache could mistake a new view at the same address for it
+    if (!instanceShaderResourceView.IsNull()) { PipelineManager::UnbindShaderResourceView(ResourceManager::Get(instanceShaderResourceView)); }
+    for (Batch& batch : batches)
+    {
+        if (!batch.visibleShaderResourceView.IsNull()) { PipelineManager::UnbindShaderResourceView(ResourceManager::Get(batch.visibleShaderResourceView)); }
+        ResourceManager::Release(batch.visibleShaderResourceView);
+        ResourceManager::Release(batch.visibleUnorderedAccessView);
+        batch.visibleShaderResourceView = {};
+        batch.visibleUnorderedAccessView = {};
+    }
+    if (!visibleBuffer.IsNull())
+    {
+        ID3D11UnorderedAccessView* const nullView{ nullptr };
+        PipelineManager::BindUnorderedAccessViews(&nullView, PIPELINE_STAGE::COMPUTE_SHADER, 0, 1);
+    }
+    PipelineManager::FlushBindings();
+
+    ResourceManager::Release(instanceShaderResourceView);
+    ResourceManager::Release(instanceBuffer);
+    ResourceManager::Release(visibleBuffer);
+    ResourceManager::Release(argsBuffer);
+    instanceShaderResourceView = {};
+    instanceBuffer = {};
+    visibleBuffer = {};
+    argsBuffer = {};
+}
+
+bool GpuScene::UploadInstances()
+{
+    PROFILE_FUNCTION();
+    //Only the used part of each batch's range is meaningful, but the whole buffer is written since a DISCARD map loses the rest
+    ID3D11Buffer* const buffer{ ResourceManager::Get(instanceBuffer) };
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    HRESULT hr{ context->Map(buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped) };
+    if (FAILED(hr))
+    {
+        std::cerr << "ERROR::GPU_SCENE::UPLOAD_INSTANCES::FAILED_TO_MAP_INSTANCE_BUFFER" << std::endl;
+        return false;
+    }
+    std::memcpy(mapped.pData, instances.data(), instances.size() * sizeof(GpuInstance));
+    context->Unmap(buffer, 0);
+    return true;
+}
+
+void GpuScene::ExtractFrustumPlanes(const float m[16], float planes[6][4])
+{
+    //Gribb-Hartmann: for row vectors, clip = position * m, so each plane is a sum or difference of m's columns
+    //Left, right, bottom, top, near (z >= 0) and far (z <= w)
+    const int columns[6]{ 0, 0, 1, 1, 2, 2 };
+    const float signs[6]{ 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f };
+    for (UINT p{ 0 }; p < 6; ++p)
+    {
+        for (UINT r{ 0 }; r < 4; ++r)
+        {
+            const float w{ m[r * 4 + 3] };
+            const float c{ m[r * 4 + columns[p]] };
+            planes[p][r] = (p == 4) ? (c) : (w + signs[p] * c);
+        }
+        const float length{ std::sqrt(planes[p][0] * planes[p][0] + planes[p][1] * planes[p][1] + planes[p][2] * planes[p][2]) };
+        if (length > 0.0f)
+        {
+            for (UINT r{ 0 }; r < 4; ++r) { planes[p][r] /= length; }
+        }
+    }
+}
+//-----------------------------------------------//
+//------------END OF UTILITY FUNCTIONS-----------//
+//-----------------------------------------------//
\ No newline at end of file
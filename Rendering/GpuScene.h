@@ -0,0 +1,168 @@
+﻿#pragma once
+#include <d3d11.h>
+#include <vector>
+
+#include "DrawQueue.h"
+#include "../Backends/GraphicsDevice.h"
+#include "../Managers/ResourceManager.h"
+#include "../Managers/ShaderManager.h"
+
+//GPU-driven instanced batches
+//Each batch is one mesh and material drawn for up to maxInstances instances, whose transforms and bounding spheres live in a
+//single structured buffer shared by every batch - once a frame, a compute pass culls each batch's instances against the view
+//frustum (and optionally a depth pyramid), appending the survivors to the batch's range of a visible list, and the appended
+//count is copied into the instance count of the batch's indirect draw args, so the CPU cost of a frame depends on the number
+//of batches rather than the number of instances
+//
+//The batch's vertex shader finds its instance through the visible list:
+//  StructuredBuffer<GpuInstance> instances : register(t0);
+//  StructuredBuffer<uint> visibleInstances : register(t1);
+//  GpuInstance instance = instances[visibleInstances[instanceID]];
+//
+//Must only be used from the main thread, on the immediate context
+
+
+constexpr const char* GPU_SCENE_DEFAULT_CULLING_SHADER{ "Shaders/GpuCulling.hlsl" };
+constexpr UINT GPU_SCENE_INVALID_BATCH{ static_cast<UINT>(-1) };
+constexpr UINT GPU_SCENE_CULL_THREAD_GROUP_SIZE{ 64 };
+//Slots the batch's vertex shader reads its instances from
+constexpr UINT GPU_SCENE_INSTANCE_SLOT{ 0 };
+constexpr UINT GPU_SCENE_VISIBLE_INSTANCE_SLOT{ 1 };
+
+
+//Matches GpuInstance in Shaders/GpuCulling.hlsl
+struct GpuInstance
+{
+    float world[16];        //Row-major, as a DirectX::XMFLOAT4X4 - left to the batch's vertex shader
+    float boundsCentre[3];  //World space bounding sphere
+    float boundsRadius;
+};
+
+//As a DrawItem (see DrawQueue.h), minus the per-draw counts the GPU now supplies
+struct GpuBatchDescription
+{
+    ID3D11VertexShader* vertexShader;
+    ID3D11PixelShader* pixelShader;
+    ID3D11InputLayout* inputLayout;
+    D3D11_PRIMITIVE_TOPOLOGY primitiveTopology;
+
+    ID3D11Buffer* vertexBuffer;
+    UINT vertexStride;
+    UINT vertexOffset;
+    ID3D11Buffer* indexBuffer; //Null for non-indexed draws
+    DXGI_FORMAT indexFormat;
+
+    //Bound to both the vertex and pixel shader from slot 0
+    ID3D11Buffer* constantBuffers[DRAW_ITEM_MAX_CONSTANT_BUFFERS];
+    UINT constantBufferFirstConstants[DRAW_ITEM_MAX_CONSTANT_BUFFERS];
+    UINT constantBufferNumConstants[DRAW_ITEM_MAX_CONSTANT_BUFFERS];
+    //Bound to the pixel shader from slot 0
+    ID3D11ShaderResourceView* shaderResourceViews[DRAW_ITEM_MAX_SHADER_RESOURCE_VIEWS];
+    ID3D11SamplerState* samplerStates[DRAW_ITEM_MAX_SAMPLER_STATES];
+
+    UINT count;           //Vertex count, or index count for indexed draws, per instance
+    UINT startLocation;   //Start vertex, or start index for indexed draws
+    INT baseVertexLocation;
+
+    UINT maxInstances;
+};
+
+struct GpuCullDescription
+{
+    float viewProjection[16]; //Row-major, transforming row vectors as DirectXMath does - a depth range of [0,1] is assumed
+    //Optional occlusion culling against a mipmapped R32_FLOAT texture holding the farthest depth of each 2x2 block of the level
+    //above, e.g. built from last frame's depth buffer - null culls against the frustum only
+    ID3D11ShaderResourceView* depthPyramid;
+    UINT depthPyramidWidth;
+    UINT depthPyramidHeight;
+    UINT depthPyramidMipLevels;
+};
+
+struct GpuSceneStatistics
+{
+    UINT batches;
+    UINT instances;      //Instances submitted across every batch
+    UINT capacity;       //Sum of every batch's maxInstances
+    UINT cullDispatches; //In the last Cull()
+    UINT indirectDraws;  //In the last Draw()
+};
+
+
+class GpuScene
+{
+public:
+    GpuScene() = default;
+    ~GpuScene() = default;
+
+    GpuScene(const GpuScene&) = delete;
+    GpuScene& operator=(const GpuScene&) = delete;
+
+    //The culling shader isn't loaded until the first batch is added, so the source only has to exist when batches are used
+    void Initialise(GraphicsContext* _context, const char* _cullingShaderPath);
+    //Releases every batch and buffer
+    void Reset();
+
+    //----Batches----//
+    //Returns GPU_SCENE_INVALID_BATCH on failure - the buffers are rebuilt before the next Cull()/Draw() to make room for it
+    [[nodiscard]] UINT AddBatch(const GpuBatchDescription& description);
+    //Replaces the batch's instances - count is clamped to its maxInstances, and the data is uploaded before the next Cull()
+    void SetInstances(UINT batch, const GpuInstance* instances, UINT count);
+
+    //----Recording----//
+    //One dispatch per non-empty batch, writing the instance counts of the batches' indirect args
+    void Cull(const GpuCullDescription& description);
+    //One indirect draw per non-empty batch, into whatever render targets are bound
+    void Draw();
+
+    [[nodiscard]] bool IsEmpty() const { return batches.empty(); }
+    [[nodiscard]] GpuSceneStatistics GetStatistics() const;
+
+private:
+    struct Batch
+    {
+        GpuBatchDescription description;
+        UINT firstInstance; //Of the batch's range in the instance and visible buffers
+        UINT instanceCount;
+        ShaderResourceViewHandle visibleShaderResourceView;
+        UnorderedAccessViewHandle visibleUnorderedAccessView; //Append view
+    };
+
+    //Matches CullConstants in Shaders/GpuCulling.hlsl
+    struct CullConstants
+    {
+        float frustumPlanes[6][4]; //Inward facing, normalised
+        float viewProjection[16];
+        UINT firstInstance;
+        UINT instanceCount;
+        UINT occlusionMipCount;    //0 disables occlusion culling
+        UINT padding0;
+        float occlusionSize[2];
+        float padding1[2];
+    };
+
+    GraphicsContext* context{ nullptr };
+    const char* cullingShaderPath{ nullptr };
+    ComputeShaderHandle cullingShader{};
+
+    std::vector<Batch> batches;
+    std::vector<GpuInstance> instances; //CPU copy of the instance buffer
+    UINT capacity{ 0 };
+    bool buffersDirty{ false };   //Batches were added since the buffers were built
+    bool instancesDirty{ false }; //Instances changed since they were uploaded
+
+    BufferHandle instanceBuffer{};
+    ShaderResourceViewHandle instanceShaderResourceView{};
+    BufferHandle visibleBuffer{};
+    BufferHandle argsBuffer{}; //One D3D11_DRAW_INDEXED_INSTANCED_INDIRECT_ARGS sized record per batch
+
+    UINT cullDispatches{ 0 };
+    UINT indirectDraws{ 0 };
+
+
+    //Utility functions
+    [[nodiscard]] bool Prepare();
+    [[nodiscard]] bool BuildBuffers();
+    void ReleaseBuffers();
+    [[nodiscard]] bool UploadInstances();
+    static void ExtractFrustumPlanes(const float viewProjection[16], float planes[6][4]);
+};
\ No newline at end of file
@@ -0,0 +1,233 @@
+﻿#include "ReadbackQueue.h"
+
+#include <algorithm>
+#include <iostream>
+
+
+bool ReadbackQueue::Initialise(GraphicsDevice* _device, GraphicsContext* _context, UINT frameLatency)
+{
+    if (!_device || !_context)
+    {
+        std::cerr << "ERROR::READBACK_QUEUE::INITIALISE::INVALID_ARGUMENTS" << std::endl;
+        return false;
+    }
+    device = _device;
+    context = _context;
+
+    frames.resize((frameLatency == 0) ? (READBACK_QUEUE_DEFAULT_FRAME_LATENCY) : (frameLatency));
+    for (Frame& frame : frames)
+    {
+        const D3D11_QUERY_DESC desc{ D3D11_QUERY_EVENT, 0 };
+        if (FAILED(device->CreateQuery(&desc, &frame.event)))
+        {
+            std::cerr << "ERROR::READBACK_QUEUE::INITIALISE::FAILED_TO_CREATE_EVENT_QUERY" << std::endl;
+            frame.event = nullptr;
+            Shutdown();
+            return false;
+        }
+    }
+    return true;
+}
+
+void ReadbackQueue::Shutdown()
+{
+    if (!device) { return; }
+    for (Frame& frame : frames)
+    {
+        if (frame.event) { device->ReleaseObject(frame.event); }
+        for (Request& request : frame.requests) { ReleaseRequest(request); }
+    }
+    frames.clear();
+    recordIndex = 0;
+    resolveIndex = 0;
+    deliveredRequests = 0;
+    rejectedRequests = 0;
+    device = nullptr;
+    context = nullptr;
+}
+
+
+
+//-----------------------------------------------//
+//--------------------REQUESTS-------------------//
+//-----------------------------------------------//
+bool ReadbackQueue::ReadBuffer(ID3D11Buffer* source, UINT offset, UINT size, const ReadbackCallback& callback)
+{
+    if (!device || !source || size == 0 || !callback)
+    {
+        std::cerr << "ERROR::READBACK_QUEUE::READ_BUFFER::INVALID_ARGUMENTS" << std::endl;
+        return false;
+    }
+    //The runtime silently drops copies from outside the buffer, which would deliver garbage
+    D3D11_BUFFER_DESC bd;
+    device->GetBufferDesc(source, &bd);
+    if (offset > bd.ByteWidth || size > bd.ByteWidth - offset)
+    {
+        std::cerr << "ERROR::READBACK_QUEUE::READ_BUFFER::REGION_OUTSIDE_BUFFER" << std::endl;
+        return false;
+    }
+    if (!CanRecord()) { return false; }
+
+    Request request{};
+    request.buffer = ResourceManager::CreateStagingBuffer(size);
+    if (request.buffer.IsNull()) { return false; }
+    request.rowPitch = size;
+    request.callback = callback;
+    const D3D11_BOX box{ offset, 0, 0, offset + size, 1, 1 };
+    context->CopySubresourceRegion(ResourceManager::Get(request.buffer), 0, 0, 0, 0, source, 0, &box);
+    frames[recordIndex].requests.push_back(std::move(request));
+    return true;
+}
+
+bool ReadbackQueue::ReadTexture2D(ID3D11Texture2D* source, UINT subresource, UINT x, UINT y, UINT width, UINT height, const ReadbackCallback& callback)
+{
+    if (!device || !source || width == 0 || height == 0 || !callback)
+    {
+        std::cerr << "ERROR::READBACK_QUEUE::READ_TEXTURE_2D::INVALID_ARGUMENTS" << std::endl;
+        return false;
+    }
+    //As for buffers, the runtime silently drops copies it can't make - multisampled and depth stencil textures can only be
+    //copied whole, so a region of them can't be read back either
+    D3D11_TEXTURE2D_DESC td;
+    device->GetTexture2DDesc(source, &td);
+    if (td.SampleDesc.Count > 1)
+    {
+        std::cerr << "ERROR::READBACK_QUEUE::READ_TEXTURE_2D::MULTISAMPLED_TEXTURE" << std::endl;
+        return false;
+    }
+    if ((td.BindFlags & D3D11_BIND_DEPTH_STENCIL) || td.Format == DXGI_FORMAT_D16_UNORM || td.Format == DXGI_FORMAT_D24_UNORM_S8_UINT
+        || td.Format == DXGI_FORMAT_D32_FLOAT || td.Format == DXGI_FORMAT_D32_FLOAT_S8X24_UINT)
+    {
+        std::cerr << "ERROR::READBACK_QUEUE::READ_TEXTURE_2D::DEPTH_STENCIL_TEXTURE" << std::endl;
+        return false;
+    }
+    if (subresource >= td.MipLevels * td.ArraySize)
+    {
+        std::cerr << "ERROR::READBACK_QUEUE::READ_TEXTURE_2D::SUBRESOURCE_OUT_OF_RANGE" << std::endl;
+        return false;
+    }
+    const UINT mip{ subresource % td.MipLevels };
+    const UINT mipWidth{ (std::max)(1u, td.Width >> mip) };
+    const UINT mipHeight{ (std::max)(1u, td.Height >> mip) };
+    if (x > mipWidth || width > mipWidth - x || y > mipHeight || height > mipHeight - y)
+    {
+        std::cerr << "ERROR::READBACK_QUEUE::READ_TEXTURE_2D::REGION_OUTSIDE_SUBRESOURCE" << std::endl;
+        return false;
+    }
+    if (!CanRecord()) { return false; }
+
+    //The staging texture takes the source's format, as a copy between formats the runtime considers incompatible is dropped
+    Request request{};
+    request.texture = ResourceManager::CreateStagingTexture2D(width, height, td.Format);
+    if (request.texture.IsNull()) { return false; }
+    request.callback = callback;
+    const D3D11_BOX box{ x, y, 0, x + width, y + height, 1 };
+    context->CopySubresourceRegion(ResourceManager::Get(request.texture), 0, 0, 0, 0, source, subresource, &box);
+    frames[recordIndex].requests.push_back(std::move(request));
+    return true;
+}
+//-----------------------------------------------//
+//----------------END OF REQUESTS----------------//
+//-----------------------------------------------//
+
+
+
+//-----------------------------------------------//
+//---------------------FRAMES--------------------//
+//-----------------------------------------------//
+void ReadbackQueue::Update()
+{
+    if (!device) { return; }
+
+    //Frames finish in the order they were submitted, so stop at the first one the GPU hasn't finished
+    while (frames[resolveIndex].pending)
+    {
+        if (!DeliverFrame(frames[resolveIndex])) { return; }
+        frames[resolveIndex].pending = false;
+        resolveIndex = (resolveIndex + 1) % static_cast<UINT>(frames.size());
+    }
+}
+
+void ReadbackQueue::EndFrame()
+{
+    if (!device) { return; }
+
+    //Frames without requests don't take a slot, so an idle queue costs nothing
+    Frame& frame{ frames[recordIndex] };
+    if (frame.pending || frame.requests.empty()) { return; }
+    context->End(frame.event);
+    frame.pending = true;
+    recordIndex = (recordIndex + 1) % static_cast<UINT>(frames.size());
+}
+
+ReadbackQueueStatistics ReadbackQueue::GetStatistics() const
+{
+    ReadbackQueueStatistics statistics{};
+    for (const Frame& frame : frames)
+    {
+        statistics.pendingRequests += static_cast<UINT>(frame.requests.size()) - frame.delivered;
+        statistics.pendingFrames += (frame.pending) ? (1) : (0);
+    }
+    statistics.deliveredRequests = deliveredRequests;
+    statistics.rejectedRequests = rejectedRequests;
+    return statistics;
+}
+//-----------------------------------------------//
+//-----------------END OF FRAMES-----------------//
+//-----------------------------------------------//
+
+
+
+//-----------------------------------------------//
+//---------------UTILITY FUNCTIONS---------------//
+//-----------------------------------------------//
+bool ReadbackQueue::CanRecord()
+{
+    //Waiting for the slot to free up is exactly the stall the ring exists to avoid
+    if (!frames[recordIndex].pending) { return true; }
+    ++rejectedRequests;
+    return false;
+}
+
+bool ReadbackQueue::DeliverFrame(Frame& frame)
+{
+    BOOL done;
+    if (context->GetData(frame.event, &done, sizeof(done), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK || !done) { return false; }
+
+    for (; frame.delivered < frame.requests.size(); ++frame.delivered)
+    {
+        Request& request{ frame.requests[frame.delivered] };
+        const bool isBuffer{ !request.buffer.IsNull() };
+        ID3D11Resource* staging{ (isBuffer) ? (static_cast<ID3D11Resource*>(ResourceManager::Get(request.buffer))) : (ResourceManager::Get(request.texture)) };
+
+        //The event has signalled, so the copy is done - DO_NOT_WAIT only guards against a driver that disagrees
+        D3D11_MAPPED_SUBRESOURCE mapped;
+        const HRESULT hr{ context->Map(staging, 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped) };
+        if (hr == DXGI_ERROR_WAS_STILL_DRAWING) { return false; }
+        if (SUCCEEDED(hr))
+        {
+            request.callback(mapped.pData, (isBuffer) ? (request.rowPitch) : (mapped.RowPitch));
+            context->Unmap(staging, 0);
+            ++deliveredRequests;
+        }
+        else
+        {
+            std::cerr << "ERROR::READBACK_QUEUE::DELIVER_FRAME::FAILED_TO_MAP_STAGING_RESOURCE" << std::endl;
+        }
+        ReleaseRequest(request);
+    }
+    frame.requests.clear();
+    frame.delivered = 0;
+    return true;
+}
+
+void ReadbackQueue::ReleaseRequest(Request& request)
+{
+    //Back to the pool, for the next readback of the same size
+    ResourceManager::Release(request.buffer);
+    ResourceManager::Release(request.texture);
+    request = {};
+}
+//-----------------------------------------------//
+//-----------END OF UTILITY FUNCTIONS------------//
+//-----------------------------------------------//
\ No newline at end of file
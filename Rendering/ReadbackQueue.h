@@ -0,0 +1,98 @@
+﻿#pragma once
+#include <d3d11.h>
+#include <functional>
+#include <vector>
+
+#include "../Backends/GraphicsDevice.h"
+#include "../Managers/ResourceManager.h"
+
+//Reads GPU results back to the CPU without stalling, e.g. for picking, auto exposure histograms or compute output
+//
+//Each request copies its region straight away into a D3D11_USAGE_STAGING resource from the ResourceManager's pool, and the
+//requests of a frame share one D3D11_QUERY_EVENT, ended after the frame's work. Frames with requests go into a ring of
+//frameLatency slots, and Update() polls the oldest ones' events without flushing - a frame's staging resources are only
+//mapped once its event has signalled, so Map() never waits on the GPU. Results are handed to callbacks in request order,
+//usually a frame or two after the request
+//
+//While every slot of the ring is still in flight, requests are rejected rather than stalling until one frees up
+//
+//Must only be used from the main thread, on the immediate context
+
+
+constexpr UINT READBACK_QUEUE_DEFAULT_FRAME_LATENCY{ 4 };
+
+//data is only valid for the duration of the call - rowPitch is the bytes between rows of a texture region, or the size of a buffer region
+using ReadbackCallback = std::function<void(const void* data, UINT rowPitch)>;
+
+struct ReadbackQueueStatistics
+{
+    UINT pendingRequests;     //Copied, waiting on the GPU
+    UINT pendingFrames;
+    UINT64 deliveredRequests;
+    UINT64 rejectedRequests;  //Made while every slot of the ring was in flight
+};
+
+
+class ReadbackQueue
+{
+public:
+    ReadbackQueue() = default;
+    ~ReadbackQueue() = default;
+
+    ReadbackQueue(const ReadbackQueue&) = delete;
+    ReadbackQueue& operator=(const ReadbackQueue&) = delete;
+
+    //frameLatency is how many frames of requests may be waiting on the GPU at once - 0 selects READBACK_QUEUE_DEFAULT_FRAME_LATENCY
+    bool Initialise(GraphicsDevice* _device, GraphicsContext* _context, UINT frameLatency);
+    //Drops the requests in flight without calling their callbacks
+    void Shutdown();
+    [[nodiscard]] bool IsInitialised() const { return device != nullptr; }
+
+    //----Requests----//
+    //Reads size bytes from offset - false if the request was rejected or the copy couldn't be made
+    bool ReadBuffer(ID3D11Buffer* source, UINT offset, UINT size, const ReadbackCallback& callback);
+    //Reads the width x height region at (x, y) of one subresource, in the texture's own format
+    //The region has to lie within the subresource's mip, and the texture can't be multisampled or a depth stencil texture
+    bool ReadTexture2D(ID3D11Texture2D* source, UINT subresource, UINT x, UINT y, UINT width, UINT height, const ReadbackCallback& callback);
+
+    //----Frames----//
+    //Start of the frame - delivers the requests of every frame the GPU has finished
+    void Update();
+    //After the frame's work - ends the frame's event, if it has any requests
+    void EndFrame();
+    [[nodiscard]] ReadbackQueueStatistics GetStatistics() const;
+
+private:
+    struct Request
+    {
+        BufferHandle buffer;     //One of the two staging resources is set
+        Texture2DHandle texture;
+        UINT rowPitch;           //Of a buffer region - texture regions take theirs from the map
+        ReadbackCallback callback;
+    };
+
+    struct Frame
+    {
+        ID3D11Query* event;
+        std::vector<Request> requests;
+        UINT delivered; //Requests already handed to their callbacks
+        bool pending;   //Ended and not yet delivered
+    };
+
+    GraphicsDevice* device{ nullptr };
+    GraphicsContext* context{ nullptr };
+
+    std::vector<Frame> frames;
+    UINT recordIndex{ 0 };  //Slot the current frame's requests go into
+    UINT resolveIndex{ 0 }; //Oldest slot that may still be pending
+
+    UINT64 deliveredRequests{ 0 };
+    UINT64 rejectedRequests{ 0 };
+
+
+    //Utility functions
+    //False if the current frame's slot is still in flight
+    [[nodiscard]] bool CanRecord();
+    [[nodiscard]] bool DeliverFrame(Frame& frame);
+    static void ReleaseRequest(Request& request);
+};
\ No newline at end of file
@@ -0,0 +1,396 @@
+﻿#include "TextureStreamer.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "../Managers/PipelineManager.h"
+#include "../Utility/CpuProfiler.h"
+
+
+//D3D11 needs the top level of a block compressed texture to be a whole number of blocks
+static bool IsAllocatable(const DdsLayout& layout, UINT mip)
+{
+    return !layout.blockCompressed || (layout.mips[mip].width % 4 == 0 && layout.mips[mip].height % 4 == 0);
+}
+
+
+void TextureStreamer::Initialise(GraphicsContext* _context, UINT64 _budget)
+{
+    context = _context;
+    SetBudget(_budget);
+}
+
+void TextureStreamer::Reset()
+{
+    for (const std::unique_ptr<PendingRead>& read : pendingReads) { JobManager::Wait(read->counter); }
+    pendingReads.clear();
+    for (StreamedTexture& streamed : textures)
+    {
+        if (streamed.file) { ReleaseResources(streamed); }
+    }
+    textures.clear();
+    freeTextures.clear();
+    candidates.clear();
+    allocatedBytes = 0;
+    frame = 0;
+    mipsUploaded = 0;
+    mipsEvicted = 0;
+    reallocations = 0;
+}
+
+
+
+//----------------------------------------------//
+//-------------------TEXTURES-------------------//
+//----------------------------------------------//
+UINT TextureStreamer::Load(const char* path)
+{
+    PROFILE_FUNCTION();
+    if (!context)
+    {
+        std::cerr << "ERROR::TEXTURE_STREAMER::LOAD::NOT_INITIALISED" << std::endl;
+        return TEXTURE_STREAMER_INVALID_TEXTURE;
+    }
+    std::unique_ptr<MappedFile> file{ std::make_unique<MappedFile>() };
+    if (!path || !file->Open(path))
+    {
+        std::cerr << "ERROR::TEXTURE_STREAMER::LOAD::FAILED_TO_MAP_FILE" << std::endl;
+        return TEXTURE_STREAMER_INVALID_TEXTURE;
+    }
+    DdsLayout layout;
+    if (!ParseDds(file->GetData(), file->GetSize(), layout) || !IsAllocatable(layout, 0))
+    {
+        std::cerr << "ERROR::TEXTURE_STREAMER::LOAD::INVALID_OR_UNSUPPORTED_DDS_FILE" << std::endl;
+        return TEXTURE_STREAMER_INVALID_TEXTURE;
+    }
+
+    //The tail starts at the first level small enough, or the next finer one that can be allocated
+    UINT tailMip{ 0 };
+    while (tailMip + 1 < layout.mipCount && (std::max)(layout.mips[tailMip].width, layout.mips[tailMip].height) > TEXTURE_STREAMER_TAIL_SIZE) { ++tailMip; }
+    while (!IsAllocatable(layout, tailMip)) { --tailMip; }
+
+    UINT index;
+    if (freeTextures.empty())
+    {
+        index = static_cast<UINT>(textures.size());
+        textures.emplace_back();
+    }
+    else
+    {
+        index = freeTextures.back();
+        freeTextures.pop_back();
+    }
+    StreamedTexture& streamed{ textures[index] };
+    const UINT generation{ streamed.generation };
+    streamed = StreamedTexture{};
+    streamed.file = std::move(file);
+    streamed.layout = layout;
+    streamed.tailMip = tailMip;
+    streamed.allocatedMip = layout.mipCount;
+    streamed.residentMip = layout.mipCount;
+    streamed.lastUsedFrame = frame;
+    streamed.generation = generation;
+    if (!Reallocate(streamed, tailMip))
+    {
+        streamed.file.reset();
+        freeTextures.push_back(index);
+        return TEXTURE_STREAMER_INVALID_TEXTURE;
+    }
+
+    //The tail is a few kilobytes at most, so it is read here rather than waiting on a job
+    ID3D11Texture2D* const texture{ ResourceManager::Get(streamed.texture) };
+    for (UINT mip{ tailMip }; mip < layout.mipCount; ++mip)
+    {
+        const DdsMip& source{ layout.mips[mip] };
+        context->UpdateSubresource(texture, mip - tailMip, nullptr, streamed.file->GetData() + source.offset, source.rowPitch, static_cast<UINT>(source.size));
+    }
+    streamed.residentMip = tailMip;
+    context->SetResourceMinLOD(texture, 0.0f);
+    return index;
+}
+
+void TextureStreamer::Release(UINT texture)
+{
+    PROFILE_FUNCTION();
+    if (!IsValid(texture))
+    {
+        std::cerr << "ERROR::TEXTURE_STREAMER::RELEASE::INVALID_TEXTURE" << std::endl;
+        return;
+    }
+    StreamedTexture& streamed{ textures[texture] };
+    //Reads copy out of the mapping, so even the ones for an old allocation have to finish before the file is closed
+    for (const std::unique_ptr<PendingRead>& read : pendingReads)
+    {
+        if (read->texture == texture) { JobManager::Wait(read->counter); }
+    }
+    ReleaseResources(streamed);
+    allocatedBytes -= GetAllocationSize(streamed.layout, streamed.allocatedMip);
+    streamed.file.reset();
+    ++streamed.generation;
+    streamed.reading = false;
+    freeTextures.push_back(texture);
+}
+
+void TextureStreamer::Request(UINT texture, UINT mip)
+{
+    if (!IsValid(texture))
+    {
+        std::cerr << "ERROR::TEXTURE_STREAMER::REQUEST::INVALID_TEXTURE" << std::endl;
+        return;
+    }
+    textures[texture].requestedMip = mip;
+}
+
+ID3D11ShaderResourceView* TextureStreamer::GetView(UINT texture)
+{
+    if (!IsValid(texture))
+    {
+        std::cerr << "ERROR::TEXTURE_STREAMER::GET_VIEW::INVALID_TEXTURE" << std::endl;
+        return nullptr;
+    }
+    textures[texture].lastUsedFrame = frame;
+    return ResourceManager::Get(textures[texture].view);
+}
+
+UINT TextureStreamer::GetResidentMip(UINT texture) const
+{
+    if (!IsValid(texture))
+    {
+        std::cerr << "ERROR::TEXTURE_STREAMER::GET_RESIDENT_MIP::INVALID_TEXTURE" << std::endl;
+        return 0;
+    }
+    return textures[texture].residentMip;
+}
+//----------------------------------------------//
+//---------------END OF TEXTURES----------------//
+//----------------------------------------------//
+
+
+
+//-----------------------------------------------//
+//-------------------STREAMING-------------------//
+//-----------------------------------------------//
+void TextureStreamer::Update()
+{
+    PROFILE_FUNCTION();
+    mipsUploaded = 0;
+    mipsEvicted = 0;
+    reallocations = 0;
+
+    UploadFinishedReads();
+    Evict();
+    StartReads();
+    ++frame;
+}
+
+void TextureStreamer::SetBudget(UINT64 _budget)
+{
+    //Takes effect on the next Update()
+    budget = (_budget) ? (_budget) : (TEXTURE_STREAMER_DEFAULT_BUDGET);
+}
+
+TextureStreamerStatistics TextureStreamer::GetStatistics() const
+{
+    TextureStreamerStatistics statistics{};
+    statistics.textures = static_cast<UINT>(textures.size() - freeTextures.size());
+    statistics.budget = budget;
+    statistics.allocatedBytes = allocatedBytes;
+    for (const StreamedTexture& streamed : textures)
+    {
+        if (streamed.file) { statistics.residentBytes += GetAllocationSize(streamed.layout, streamed.residentMip); }
+    }
+    statistics.pendingReads = static_cast<UINT>(pendingReads.size());
+    statistics.mipsUploaded = mipsUploaded;
+    statistics.mipsEvicted = mipsEvicted;
+    statistics.reallocations = reallocations;
+    return statistics;
+}
+
+void TextureStreamer::UploadFinishedReads()
+{
+    for (size_t i{ 0 }; i < pendingReads.size();)
+    {
+        PendingRead& read{ *pendingReads[i] };
+        if (!read.counter.IsComplete())
+        {
+            ++i;
+            continue;
+        }
+
+        //Reads for a texture that has since been released or reallocated are dropped
+        if (IsValid(read.texture) && textures[read.texture].generation == read.generation)
+        {
+            StreamedTexture& streamed{ textures[read.texture] };
+            ID3D11Texture2D* const texture{ ResourceManager::Get(streamed.texture) };
+            const DdsMip& mip{ streamed.layout.mips[read.mip] };
+            context->UpdateSubresource(texture, read.mip - streamed.allocatedMip, nullptr, read.data.data(), mip.rowPitch, static_cast<UINT>(mip.size));
+            context->SetResourceMinLOD(texture, static_cast<FLOAT>(read.mip - streamed.allocatedMip));
+            streamed.residentMip = read.mip;
+            streamed.reading = false;
+            ++mipsUploaded;
+        }
+        pendingReads[i] = std::move(pendingReads.back());
+        pendingReads.pop_back();
+    }
+}
+
+void TextureStreamer::Evict()
+{
+    //Textures asked for coarser mips than they have give them up whatever the budget
+    for (StreamedTexture& streamed : textures)
+    {
+        if (!streamed.file || streamed.requestedMip <= streamed.allocatedMip) { continue; }
+        UINT mip{ (std::min)(streamed.requestedMip, streamed.tailMip) };
+        while (!IsAllocatable(streamed.layout, mip)) { --mip; }
+        if (mip > streamed.allocatedMip && !Reallocate(streamed, mip)) { return; }
+    }
+    EvictTo(budget, frame + 1);
+}
+
+void TextureStreamer::EvictTo(UINT64 target, UINT64 usedBefore)
+{
+    while (allocatedBytes > target)
+    {
+        //Least recently used first, then largest first
+        StreamedTexture* victim{ nullptr };
+        for (StreamedTexture& streamed : textures)
+        {
+            if (!streamed.file || streamed.allocatedMip >= streamed.tailMip || streamed.lastUsedFrame >= usedBefore) { continue; }
+            if (!victim || streamed.lastUsedFrame < victim->lastUsedFrame ||
+                (streamed.lastUsedFrame == victim->lastUsedFrame && GetAllocationSize(streamed.layout, streamed.allocatedMip) > GetAllocationSize(victim->layout, victim->allocatedMip)))
+            {
+                victim = &streamed;
+            }
+        }
+        if (!victim) { return; }
+
+        //Drop only as many levels as it takes to get under the target
+        const UINT64 victimSize{ GetAllocationSize(victim->layout, victim->allocatedMip) };
+        UINT mip{ victim->allocatedMip + 1 };
+        while (mip < victim->tailMip && (!IsAllocatable(victim->layout, mip) || allocatedBytes - victimSize + GetAllocationSize(victim->layout, mip) > target)) { ++mip; }
+        if (!Reallocate(*victim, mip)) { return; }
+    }
+}
+
+bool TextureStreamer::MakeRoom(UINT64 bytes, UINT64 usedBefore)
+{
+    if (allocatedBytes + bytes <= budget) { return true; }
+    if (bytes > budget) { return false; }
+
+    //Only evict if it frees enough, so textures aren't cut down for nothing
+    UINT64 evictable{ 0 };
+    for (const StreamedTexture& streamed : textures)
+    {
+        if (!streamed.file || streamed.lastUsedFrame >= usedBefore) { continue; }
+        evictable += GetAllocationSize(streamed.layout, streamed.allocatedMip) - GetAllocationSize(streamed.layout, streamed.tailMip);
+    }
+    if (allocatedBytes - evictable + bytes > budget) { return false; }
+    EvictTo(budget - bytes, usedBefore);
+    return allocatedBytes + bytes <= budget;
+}
+
+void TextureStreamer::StartReads()
+{
+    //Most recently used first, so what is on screen streams in ahead of what isn't
+    candidates.clear();
+    for (UINT i{ 0 }; i < textures.size(); ++i)
+    {
+        const StreamedTexture& streamed{ textures[i] };
+        if (streamed.file && !streamed.reading && streamed.residentMip > (std::min)(streamed.requestedMip, streamed.tailMip)) { candidates.push_back(i); }
+    }
+    std::stable_sort(candidates.begin(), candidates.end(), [this](UINT a, UINT b) { return textures[a].lastUsedFrame > textures[b].lastUsedFrame; });
+
+    for (const UINT index : candidates)
+    {
+        if (pendingReads.size() >= TEXTURE_STREAMER_MAX_PENDING_READS) { break; }
+        StreamedTexture& streamed{ textures[index] };
+
+        //Allocate as far down towards the requested mip as the budget allows, evicting textures used less recently to make room
+        if (streamed.residentMip == streamed.allocatedMip)
+        {
+            const UINT64 allocatedSize{ GetAllocationSize(streamed.layout, streamed.allocatedMip) };
+            UINT mip{ (std::min)(streamed.requestedMip, streamed.tailMip) };
+            while (mip < streamed.allocatedMip && (!IsAllocatable(streamed.layout, mip) || !MakeRoom(GetAllocationSize(streamed.layout, mip) - allocatedSize, streamed.lastUsedFrame))) { ++mip; }
+            if (mip == streamed.allocatedMip || !Reallocate(streamed, mip)) { continue; }
+        }
+
+        std::unique_ptr<PendingRead> read{ std::make_unique<PendingRead>() };
+        read->texture = index;
+        read->generation = streamed.generation;
+        read->mip = streamed.residentMip - 1;
+        read->source = streamed.file->GetData() + streamed.layout.mips[read->mip].offset;
+        const size_t size{ static_cast<size_t>(streamed.layout.mips[read->mip].size) };
+
+        //Copying out of the mapping is what faults the pages in, so it is the copy that goes to another thread
+        PendingRead* request{ read.get() };
+        const auto copy{ [request, size]() { request->data.assign(request->source, request->source + size); } };
+        if (JobManager::GetThreadCount() > 1) { JobManager::Schedule(copy, &request->counter); }
+        else { copy(); }
+        streamed.reading = true;
+        pendingReads.push_back(std::move(read));
+    }
+}
+
+bool TextureStreamer::Reallocate(StreamedTexture& streamed, UINT mip)
+{
+    PROFILE_FUNCTION();
+    const DdsLayout& layout{ streamed.layout };
+    const UINT mipLevels{ layout.mipCount - mip };
+    Texture2DHandle texture{ ResourceManager::CreateStreamingTexture2D(layout.mips[mip].width, layout.mips[mip].height, mipLevels, layout.format) };
+    ShaderResourceViewHandle view{ ResourceManager::CreateTexture2DShaderResourceView(texture, 0, mipLevels, layout.format) };
+    if (view.IsNull())
+    {
+        std::cerr << "ERROR::TEXTURE_STREAMER::REALLOCATE::FAILED_TO_CREATE_TEXTURE" << std::endl;
+        ResourceManager::Release(texture);
+        return false;
+    }
+
+    //Levels the new allocation still covers are copied across on the GPU, the rest are evicted
+    const UINT keep{ (std::max)(streamed.residentMip, mip) };
+    ID3D11Texture2D* const newTexture{ ResourceManager::Get(texture) };
+    ID3D11Texture2D* const oldTexture{ ResourceManager::Get(streamed.texture) };
+    for (UINT level{ keep }; oldTexture && level < layout.mipCount; ++level)
+    {
+        context->CopySubresourceRegion(newTexture, level - mip, 0, 0, 0, oldTexture, level - streamed.allocatedMip, nullptr);
+    }
+    context->SetResourceMinLOD(newTexture, static_cast<FLOAT>(keep - mip));
+
+    if (oldTexture)
+    {
+        mipsEvicted += keep - streamed.residentMip;
+        ++reallocations;
+    }
+    ReleaseResources(streamed);
+    allocatedBytes += GetAllocationSize(layout, mip) - GetAllocationSize(layout, streamed.allocatedMip);
+    streamed.texture = texture;
+    streamed.view = view;
+    streamed.allocatedMip = mip;
+    streamed.residentMip = keep;
+    ++streamed.generation;
+    streamed.reading = false;
+    return true;
+}
+
+void TextureStreamer::ReleaseResources(StreamedTexture& streamed)
+{
+    if (!streamed.view.IsNull()) { PipelineManager::UnbindShaderResourceView(ResourceManager::Get(streamed.view)); }
+    ResourceManager::Release(streamed.view);
+    ResourceManager::Release(streamed.texture);
+    streamed.view = {};
+    streamed.texture = {};
+}
+
+bool TextureStreamer::IsValid(UINT texture) const
+{
+    return texture < textures.size() && textures[texture].file;
+}
+
+UINT64 TextureStreamer::GetAllocationSize(const DdsLayout& layout, UINT mip)
+{
+    UINT64 size{ 0 };
+    for (UINT i{ mip }; i < layout.mipCount; ++i) { size += layout.mips[i].size; }
+    return size;
+}
+//-----------------------------------------------//
+//---------------END OF STREAMING----------------//
+//-----------------------------------------------//
\ No newline at end of file
@@ -0,0 +1,133 @@
+﻿#pragma once
+#include <d3d11.h>
+#include <memory>
+#include <vector>
+
+#include "../Backends/GraphicsDevice.h"
+#include "../Managers/JobManager.h"
+#include "../Managers/ResourceManager.h"
+#include "../Utility/DdsFormat.h"
+#include "../Utility/MappedFile.h"
+
+//Streams the mips of DDS textures (see DdsFormat.h) in and out under a memory budget
+//
+//Loading a texture only uploads its tail - the mips at most TEXTURE_STREAMER_TAIL_SIZE texels across - so there is always
+//something to sample. Finer mips are then read on JobManager threads one at a time, coarsest first, towards the mip each
+//texture was asked for. A texture is allocated down to the finest mip it is streaming towards, and the resource's min LOD
+//clamp (SetResourceMinLOD()) hides the levels that haven't arrived yet, dropping by a level as each one is uploaded
+//
+//When the allocations go over budget, the least recently used textures are reallocated without their finest mips (the
+//rest are copied across on the GPU), down to their tails at most. Reallocation changes a texture's view, so fetch it
+//with GetView() every frame rather than keeping it
+//
+//Must only be used from the main thread, on the immediate context
+
+
+constexpr UINT TEXTURE_STREAMER_INVALID_TEXTURE{ static_cast<UINT>(-1) };
+constexpr UINT64 TEXTURE_STREAMER_DEFAULT_BUDGET{ 256ull * 1024 * 1024 };
+constexpr UINT TEXTURE_STREAMER_TAIL_SIZE{ 64 };
+constexpr UINT TEXTURE_STREAMER_MAX_PENDING_READS{ 8 };
+
+
+struct TextureStreamerStatistics
+{
+    UINT textures;
+    UINT64 budget;
+    UINT64 allocatedBytes; //Across every texture's allocated mips, including ones still streaming in
+    UINT64 residentBytes;  //Across every texture's uploaded mips
+    UINT pendingReads;
+    //In the last Update()
+    UINT mipsUploaded;
+    UINT mipsEvicted;
+    UINT reallocations;
+};
+
+
+class TextureStreamer
+{
+public:
+    TextureStreamer() = default;
+    ~TextureStreamer() = default;
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    //A budget of 0 selects TEXTURE_STREAMER_DEFAULT_BUDGET
+    void Initialise(GraphicsContext* _context, UINT64 _budget);
+    //Waits for the reads in flight, then releases every texture
+    void Reset();
+
+    //----Textures----//
+    //Maps the file and uploads its tail - returns TEXTURE_STREAMER_INVALID_TEXTURE if the file is missing or unsupported
+    [[nodiscard]] UINT Load(const char* path);
+    //Waits for the texture's reads in flight, if any
+    void Release(UINT texture);
+    //Finest mip to stream in, e.g. from the texture's size on screen - 0 (the default) streams in every mip
+    //Asking for a coarser mip than is allocated frees the finer ones on the next Update()
+    void Request(UINT texture, UINT mip);
+    //Marks the texture as used this frame, which keeps it from being evicted ahead of textures that weren't
+    [[nodiscard]] ID3D11ShaderResourceView* GetView(UINT texture);
+    //Finest mip that has been uploaded, as a level of the file
+    [[nodiscard]] UINT GetResidentMip(UINT texture) const;
+
+    //----Streaming----//
+    //Once a frame - uploads the reads that have finished, evicts down to the budget, then starts new reads
+    void Update();
+    void SetBudget(UINT64 _budget);
+    [[nodiscard]] TextureStreamerStatistics GetStatistics() const;
+
+private:
+    struct StreamedTexture
+    {
+        std::unique_ptr<MappedFile> file; //Null for free slots
+        DdsLayout layout;
+        UINT tailMip;      //Coarsest level the texture may be allocated from
+        UINT allocatedMip; //Level of the file that is mip 0 of the texture
+        UINT residentMip;  //Finest level uploaded - the clamp hides [allocatedMip, residentMip)
+        UINT requestedMip;
+        UINT64 lastUsedFrame;
+        UINT generation;   //Bumped whenever the texture is reallocated or released, so reads for the old allocation are dropped
+        bool reading;
+        Texture2DHandle texture;
+        ShaderResourceViewHandle view;
+    };
+
+    struct PendingRead
+    {
+        UINT texture;
+        UINT generation;
+        UINT mip;
+        const BYTE* source; //Into the texture's mapping, which Release() keeps open until the read is done
+        std::vector<BYTE> data;
+        JobCounter counter;
+    };
+
+    GraphicsContext* context{ nullptr };
+    UINT64 budget{ TEXTURE_STREAMER_DEFAULT_BUDGET };
+    UINT64 frame{ 0 };
+
+    std::vector<StreamedTexture> textures;
+    std::vector<UINT> freeTextures;
+    std::vector<std::unique_ptr<PendingRead>> pendingReads;
+    std::vector<UINT> candidates; //Scratch for Update()
+
+    UINT64 allocatedBytes{ 0 };
+    UINT mipsUploaded{ 0 };
+    UINT mipsEvicted{ 0 };
+    UINT reallocations{ 0 };
+
+
+    //Utility functions
+    void UploadFinishedReads();
+    void Evict();
+    //Cuts down textures last used before usedBefore until the allocations fit in target bytes, or there are none left to cut
+    void EvictTo(UINT64 target, UINT64 usedBefore);
+    //Evicts textures last used before usedBefore to fit another bytes in the budget - false, evicting nothing, if they can't free enough
+    [[nodiscard]] bool MakeRoom(UINT64 bytes, UINT64 usedBefore);
+    void StartReads();
+    //Recreates the texture from level mip down, copying over the resident levels it keeps
+    [[nodiscard]] bool Reallocate(StreamedTexture& streamed, UINT mip);
+    void ReleaseResources(StreamedTexture& streamed);
+    [[nodiscard]] bool IsValid(UINT texture) const;
+    [[nodiscard]] static UINT64 GetAllocationSize(const DdsLayout& layout, UINT mip);
+};
\ No newline at end of file
@@ -0,0 +1,87 @@
+//Instance culling for the GPU scene (see Rendering/GpuScene.h) - one thread per instance of a batch
+//Instances inside the view frustum, and not hidden behind the depth pyramid when one is bound, have their index appended to the
+//batch's visible list, whose count GpuScene then copies into the instance count of the batch's indirect draw
+
+#ifndef THREAD_GROUP_SIZE
+#define THREAD_GROUP_SIZE 64
+#endif
+
+//Matches GpuInstance in Rendering/GpuScene.h
+struct GpuInstance
+{
+    row_major float4x4 world;
+    float3 boundsCentre;
+    float boundsRadius;
+};
+
+//Matches GpuScene::CullConstants
+cbuffer CullConstants : register(b0)
+{
+    float4 frustumPlanes[6];
+    row_major float4x4 viewProjection;
+    uint firstInstance;
+    uint instanceCount;
+    uint occlusionMipCount;
+    uint padding0;
+    float2 occlusionSize;
+    float2 padding1;
+};
+
+StructuredBuffer<GpuInstance> instances : register(t0);
+Texture2D<float> depthPyramid : register(t1);
+AppendStructuredBuffer<uint> visibleInstances : register(u0);
+
+
+bool IsOccluded(float3 centre, float radius)
+{
+    //Screen space rectangle and nearest depth of the sphere's bounding box
+    float2 minimum = float2(1.0f, 1.0f);
+    float2 maximum = float2(0.0f, 0.0f);
+    float nearest = 1.0f;
+    [unroll]
+    for (uint i = 0; i < 8; ++i)
+    {
+        float3 corner = centre + radius * float3((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f);
+        float4 clip = mul(float4(corner, 1.0f), viewProjection);
+        //Bounds crossing the near plane can't be tested
+        if (clip.w <= 0.0f) { return false; }
+        float3 ndc = clip.xyz / clip.w;
+        float2 uv = float2(ndc.x * 0.5f + 0.5f, 0.5f - ndc.y * 0.5f);
+        minimum = min(minimum, uv);
+        maximum = max(maximum, uv);
+        nearest = min(nearest, ndc.z);
+    }
+    minimum = saturate(minimum);
+    maximum = saturate(maximum);
+
+    //The finest mip at which the rectangle spans at most 2x2 texels
+    float2 extent = (maximum - minimum) * occlusionSize;
+    uint mip = min((uint)ceil(log2(max(max(extent.x, extent.y), 1.0f))), occlusionMipCount - 1);
+    uint2 mipSize = max(uint2(occlusionSize) >> mip, uint2(1, 1));
+    uint2 first = min(uint2(minimum * mipSize), mipSize - 1);
+    uint2 last = min(uint2(maximum * mipSize), mipSize - 1);
+    //Only possible when the pyramid has too few mips
+    if (any(last - first > 1)) { return false; }
+
+    float farthest = max(max(depthPyramid.Load(int3(first, mip)), depthPyramid.Load(int3(last.x, first.y, mip))),
+                         max(depthPyramid.Load(int3(first.x, last.y, mip)), depthPyramid.Load(int3(last, mip))));
+    return nearest > farthest;
+}
+
+[numthreads(THREAD_GROUP_SIZE, 1, 1)]
+void CullInstances(uint3 id : SV_DispatchThreadID)
+{
+    if (id.x >= instanceCount) { return; }
+    uint index = firstInstance + id.x;
+    GpuInstance instance = instances[index];
+
+    [unroll]
+    for (uint i = 0; i < 6; ++i)
+    {
+        if (dot(frustumPlanes[i].xyz, instance.boundsCentre) + frustumPlanes[i].w < -instance.boundsRadius) { return; }
+    }
+    if (occlusionMipCount > 0 && IsOccluded(instance.boundsCentre, instance.boundsRadius)) { return; }
+
+    //Absolute index, so the vertex shader doesn't need the batch's first instance
+    visibleInstances.Append(index);
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+﻿#pragma once
+#include "d3d11.h"
+
+//Stand-in for the Windows SDK header on platforms without it (see d3d11.h)
+
+
+struct ID3D11DeviceContext1 : ID3D11DeviceContext {};
\ No newline at end of file
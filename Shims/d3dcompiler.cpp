@@ -0,0 +1,34 @@
+﻿#include "d3dcompiler.h"
+
+#include <cstring>
+#include <vector>
+
+//Error message blob, so the failure reads the same as any other compile error
+class ShimBlob final : public ID3DBlob
+{
+public:
+    explicit ShimBlob(const char* message) : data(message, message + std::strlen(message) + 1) {}
+
+    HRESULT QueryInterface(REFIID, void**) override { return E_NOTIMPL; }
+    ULONG AddRef() override { return ++refCount; }
+    ULONG Release() override
+    {
+        const ULONG count{ --refCount };
+        if (count == 0) { delete this; }
+        return count;
+    }
+
+    LPVOID GetBufferPointer() override { return data.data(); }
+    SIZE_T GetBufferSize() override { return data.size(); }
+
+private:
+    std::vector<char> data;
+    ULONG refCount{ 1 };
+};
+
+HRESULT D3DCompile(LPCVOID, SIZE_T, LPCSTR, const D3D_SHADER_MACRO*, ID3DInclude*, LPCSTR, LPCSTR, UINT, UINT, ID3DBlob** ppCode, ID3DBlob** ppErrorMsgs)
+{
+    if (ppCode) { *ppCode = nullptr; }
+    if (ppErrorMsgs) { *ppErrorMsgs = new ShimBlob("D3DCompile is only available on Windows"); }
+    return E_NOTIMPL;
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+﻿#pragma once
+#include "d3d11.h"
+
+//Stand-in for the Windows SDK header on platforms without it
+//There is no HLSL compiler off Windows - D3DCompile() always fails, so shaders can only come from a populated shader cache
+
+
+#define D3DCOMPILE_DEBUG (1 << 0)
+#define D3DCOMPILE_SKIP_OPTIMIZATION (1 << 2)
+#define D3DCOMPILE_ENABLE_STRICTNESS (1 << 11)
+#define D3DCOMPILE_OPTIMIZATION_LEVEL3 (1 << 15)
+
+struct D3D_SHADER_MACRO
+{
+    LPCSTR Name;
+    LPCSTR Definition;
+};
+
+enum D3D_INCLUDE_TYPE
+{
+    D3D_INCLUDE_LOCAL = 0,
+    D3D_INCLUDE_SYSTEM = 1,
+};
+
+struct ID3DInclude
+{
+    virtual HRESULT __stdcall Open(D3D_INCLUDE_TYPE IncludeType, LPCSTR pFileName, LPCVOID pParentData, LPCVOID* ppData, UINT* pBytes) = 0;
+    virtual HRESULT __stdcall Close(LPCVOID pData) = 0;
+};
+
+struct ID3D10Blob : IUnknown
+{
+    virtual LPVOID GetBufferPointer() = 0;
+    virtual SIZE_T GetBufferSize() = 0;
+};
+typedef ID3D10Blob ID3DBlob;
+
+HRESULT D3DCompile(LPCVOID pSrcData, SIZE_T SrcDataSize, LPCSTR pSourceName, const D3D_SHADER_MACRO* pDefines, ID3DInclude* pInclude,
+                   LPCSTR pEntrypoint, LPCSTR pTarget, UINT Flags1, UINT Flags2, ID3DBlob** ppCode, ID3DBlob** ppErrorMsgs);
\ No newline at end of file
@@ -0,0 +1,8 @@
+﻿#pragma once
+#include "dxgi.h"
+
+//Stand-in for the Windows SDK header on platforms without it (see dxgi.h)
+
+
+struct IDXGISwapChain1 : IDXGISwapChain {};
+struct IDXGISwapChain2 : IDXGISwapChain1 {};
\ No newline at end of file
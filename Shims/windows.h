@@ -0,0 +1,91 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+//Stand-in for the Windows SDK header on platforms without it - only the base types and COM plumbing the engine's
+//platform independent code refers to (window, file and timer functions are only used under _WIN32)
+
+
+typedef int INT;
+typedef unsigned int UINT;
+typedef int BOOL;
+//Sized as on Windows, where long is 32 bits
+typedef int32_t LONG;
+typedef uint32_t ULONG;
+typedef uint32_t DWORD;
+typedef unsigned short WORD;
+typedef unsigned char BYTE;
+typedef unsigned char UINT8;
+typedef uint16_t UINT16;
+typedef uint32_t UINT32;
+typedef uint64_t UINT64;
+typedef int64_t INT64;
+typedef float FLOAT;
+typedef size_t SIZE_T;
+typedef intptr_t LONG_PTR;
+typedef uintptr_t UINT_PTR;
+typedef int32_t HRESULT;
+typedef void* HANDLE;
+typedef void* LPVOID;
+typedef const void* LPCVOID;
+typedef const char* LPCSTR;
+typedef const wchar_t* LPCWSTR;
+typedef struct HWND__* HWND;
+typedef struct HINSTANCE__* HINSTANCE;
+typedef HINSTANCE HMODULE;
+
+#define TRUE 1
+#define FALSE 0
+#define CALLBACK
+#define WINAPI
+#ifndef __stdcall
+#define __stdcall
+#endif
+
+#define INVALID_HANDLE_VALUE ((HANDLE)(LONG_PTR)-1)
+#define INFINITE 0xFFFFFFFF
+
+#define S_OK ((HRESULT)0L)
+#define S_FALSE ((HRESULT)1L)
+#define E_NOTIMPL ((HRESULT)0x80004001L)
+#define E_FAIL ((HRESULT)0x80004005L)
+#define E_OUTOFMEMORY ((HRESULT)0x8007000EL)
+#define E_INVALIDARG ((HRESULT)0x80070057L)
+#define FAILED(hr) (((HRESULT)(hr)) < 0)
+#define SUCCEEDED(hr) (((HRESULT)(hr)) >= 0)
+
+#define ARRAYSIZE(a) (sizeof(a) / sizeof((a)[0]))
+
+struct RECT
+{
+    LONG left, top, right, bottom;
+};
+
+
+//----COM----//
+struct GUID
+{
+    uint32_t Data1;
+    unsigned short Data2, Data3;
+    unsigned char Data4[8];
+};
+typedef GUID IID;
+typedef const IID& REFIID;
+
+//Interface ids are never compared off Windows, so every interface gets its own zeroed id
+template<typename T>
+const IID& ShimInterfaceId()
+{
+    static const IID id{};
+    return id;
+}
+#define __uuidof(x) ShimInterfaceId<std::remove_cv_t<std::remove_reference_t<decltype(x)>>>()
+#define IID_PPV_ARGS(pp) __uuidof(**(pp)), reinterpret_cast<void**>(pp)
+
+struct IUnknown
+{
+    virtual HRESULT QueryInterface(REFIID riid, void** object) = 0;
+    virtual ULONG AddRef() = 0;
+    virtual ULONG Release() = 0;
+};
\ No newline at end of file
@@ -0,0 +1,270 @@
+﻿//CpuProfiler capture and Chrome trace export - the trace is read back with a minimal JSON parser and its events checked
+//Returns non-zero if any check fails
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Utility/CpuProfiler.h"
+#include "TestHarness.h"
+
+
+//-----------------------------------------------//
+//-----------------JSON PARSING------------------//
+//-----------------------------------------------//
+//Enough JSON for a trace - objects, arrays, strings without escapes other than \" and \\, and numbers
+struct JsonValue
+{
+    enum TYPE { NUMBER, STRING, ARRAY, OBJECT } type;
+    double number;
+    std::string text;                       //The string, or a number's source text
+    std::vector<JsonValue> elements;
+    std::map<std::string, JsonValue> members;
+
+    [[nodiscard]] const JsonValue* Find(const char* key) const
+    {
+        const auto member{ members.find(key) };
+        return (member == members.end()) ? (nullptr) : (&member->second);
+    }
+};
+
+class JsonParser
+{
+public:
+    explicit JsonParser(const std::string& _json) : json{ _json }, p{ 0 } {}
+
+    //False if the whole input isn't exactly one value
+    bool Parse(JsonValue& value)
+    {
+        if (!ParseValue(value)) { return false; }
+        SkipSpace();
+        return p == json.size();
+    }
+
+private:
+    const std::string& json;
+    size_t p;
+
+    void SkipSpace()
+    {
+        while (p < json.size() && (json[p] == ' ' || json[p] == '\n' || json[p] == '\r' || json[p] == '\t')) { ++p; }
+    }
+
+    bool Expect(char c)
+    {
+        SkipSpace();
+        if (p >= json.size() || json[p] != c) { return false; }
+        ++p;
+        return true;
+    }
+
+    bool ParseString(std::string& string)
+    {
+        if (!Expect('"')) { return false; }
+        for (; p < json.size() && json[p] != '"'; ++p)
+        {
+            if (json[p] == '\\' && ++p >= json.size()) { return false; }
+            string += json[p];
+        }
+        return Expect('"');
+    }
+
+    bool ParseValue(JsonValue& value)
+    {
+        SkipSpace();
+        if (p >= json.size()) { return false; }
+        if (json[p] == '"')
+        {
+            value.type = JsonValue::STRING;
+            return ParseString(value.text);
+        }
+        if (json[p] == '[' || json[p] == '{')
+        {
+            const bool object{ json[p] == '{' };
+            const char close{ (object) ? ('}') : (']') };
+            value.type = (object) ? (JsonValue::OBJECT) : (JsonValue::ARRAY);
+            ++p;
+            if (Expect(close)) { return true; }
+            do
+            {
+                std::string key;
+                if (object && (!ParseString(key) || !Expect(':'))) { return false; }
+                JsonValue element{};
+                if (!ParseValue(element)) { return false; }
+                if (object) { value.members[key] = element; }
+                else { value.elements.push_back(element); }
+            } while (Expect(','));
+            return Expect(close);
+        }
+
+        const size_t begin{ p };
+        while (p < json.size() && std::strchr("+-.0123456789eE", json[p])) { ++p; }
+        value.type = JsonValue::NUMBER;
+        value.text = json.substr(begin, p - begin);
+        char* end{};
+        value.number = std::strtod(value.text.c_str(), &end);
+        return !value.text.empty() && *end == '\0';
+    }
+};
+//-----------------------------------------------//
+//--------------END OF JSON PARSING--------------//
+//-----------------------------------------------//
+
+
+
+struct TraceEvent
+{
+    std::string name;
+    std::string ts;
+    double begin;
+    double end;
+    UINT tid;
+};
+
+//Writes the finished capture out and reads back its complete events and thread names - false if the file isn't valid JSON
+static bool ReadTrace(std::vector<TraceEvent>& events, std::map<UINT, std::string>& threadNames)
+{
+    const char* const path{ "CpuProfilerTests.json" };
+    if (!CpuProfiler::WriteChromeTrace(path)) { return false; }
+    std::ifstream stream{ path, std::ios::binary };
+    const std::string json{ std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>() };
+    stream.close();
+    std::remove(path);
+
+    JsonValue trace{};
+    if (!JsonParser{ json }.Parse(trace) || trace.type != JsonValue::OBJECT) { return false; }
+    const JsonValue* traceEvents{ trace.Find("traceEvents") };
+    if (!traceEvents || traceEvents->type != JsonValue::ARRAY) { return false; }
+    for (const JsonValue& event : traceEvents->elements)
+    {
+        const JsonValue* ph{ event.Find("ph") };
+        const JsonValue* tid{ event.Find("tid") };
+        if (!ph || !tid) { return false; }
+        if (ph->text == "M")
+        {
+            const JsonValue* args{ event.Find("args") };
+            if (!args || !args->Find("name")) { return false; }
+            threadNames[static_cast<UINT>(tid->number)] = args->Find("name")->text;
+            continue;
+        }
+        const JsonValue* name{ event.Find("name") };
+        const JsonValue* ts{ event.Find("ts") };
+        const JsonValue* dur{ event.Find("dur") };
+        if (ph->text != "X" || !name || !ts || !dur) { return false; }
+        events.push_back(TraceEvent{ name->text, ts->text, ts->number, ts->number + dur->number, static_cast<UINT>(tid->number) });
+    }
+    return true;
+}
+
+static void Spin(std::chrono::microseconds duration)
+{
+    const auto end{ std::chrono::steady_clock::now() + duration };
+    while (std::chrono::steady_clock::now() < end) {}
+}
+
+//Nested zones nest in the trace, on the thread's named track, and zones outside a capture aren't recorded
+static void TestNestedZones()
+{
+    PROFILE_THREAD_NAME("Main \"Thread\"");
+    { PROFILE_ZONE("Before"); }
+    CpuProfiler::BeginCapture(64);
+    {
+        PROFILE_ZONE("Outer");
+        Spin(std::chrono::microseconds(50));
+        {
+            PROFILE_ZONE("Inner");
+            Spin(std::chrono::microseconds(50));
+        }
+        Spin(std::chrono::microseconds(50));
+    }
+    CpuProfiler::EndCapture();
+    { PROFILE_ZONE("After"); }
+
+    std::vector<TraceEvent> events;
+    std::map<UINT, std::string> threadNames;
+    CHECK(ReadTrace(events, threadNames));
+    CHECK(CpuProfiler::GetCounters().zones == 2);
+    CHECK(events.size() == 2);
+    if (events.size() != 2) { return; }
+    //Zones are recorded as they end, so the inner one comes first
+    CHECK(events[0].name == "Inner" && events[1].name == "Outer");
+    CHECK(events[1].begin < events[0].begin && events[0].end < events[1].end);
+    CHECK(events[0].end - events[0].begin >= 50.0);
+    CHECK(threadNames.count(events[0].tid) == 1 && threadNames[events[0].tid] == "Main \"Thread\"");
+}
+
+//A second into a capture, adjacent zones still get distinct timestamps written to the nanosecond
+static void TestTimestampPrecision()
+{
+    CpuProfiler::BeginCapture(64);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    { PROFILE_ZONE("First"); Spin(std::chrono::microseconds(2)); }
+    { PROFILE_ZONE("Second"); Spin(std::chrono::microseconds(2)); }
+    CpuProfiler::EndCapture();
+
+    std::vector<TraceEvent> events;
+    std::map<UINT, std::string> threadNames;
+    CHECK(ReadTrace(events, threadNames));
+    CHECK(events.size() == 2);
+    if (events.size() != 2) { return; }
+    CHECK(events[0].begin > 1.0e6);
+    CHECK(events[0].ts.find_first_of("eE") == std::string::npos);
+    CHECK(events[0].ts.size() > 4 && events[0].ts[events[0].ts.size() - 4] == '.');
+    CHECK(events[1].begin > events[0].begin);
+    CHECK(events[1].begin >= events[0].end);
+}
+
+//Each thread records to its own track, zones past a thread's capacity are dropped and counted, and a new capture with a
+//larger capacity keeps them all
+static void TestThreadsAndCapacity()
+{
+    CpuProfiler::BeginCapture(8);
+    std::thread worker{ []()
+    {
+        PROFILE_THREAD_NAME("Worker");
+        for (UINT i{ 0 }; i < 12; ++i) { PROFILE_ZONE("Work"); }
+    } };
+    worker.join();
+    { PROFILE_ZONE("Main"); }
+    CpuProfiler::EndCapture();
+
+    CpuProfilerCounters counters{ CpuProfiler::GetCounters() };
+    CHECK(counters.threads == 2);
+    CHECK(counters.zones == 8 + 1);
+    CHECK(counters.droppedZones == 4);
+    std::vector<TraceEvent> events;
+    std::map<UINT, std::string> threadNames;
+    CHECK(ReadTrace(events, threadNames));
+    CHECK(events.size() == 9);
+    UINT workerZones{ 0 };
+    for (const TraceEvent& event : events)
+    {
+        if (event.name == "Work") { ++workerZones; CHECK(threadNames[event.tid] == "Worker"); }
+        else { CHECK(threadNames[event.tid] != "Worker"); }
+    }
+    CHECK(workerZones == 8);
+
+    //The main thread's buffer is regrown by BeginCapture(), not by its first zone
+    CpuProfiler::BeginCapture(32);
+    for (UINT i{ 0 }; i < 20; ++i) { PROFILE_ZONE("Main"); }
+    CpuProfiler::EndCapture();
+    counters = CpuProfiler::GetCounters();
+    CHECK(counters.threads == 1);
+    CHECK(counters.zones == 20);
+    CHECK(counters.droppedZones == 0);
+}
+
+int main()
+{
+    TestNestedZones();
+    TestTimestampPrecision();
+    TestThreadsAndCapacity();
+
+    return FinishTests("CpuProfiler");
+}
\ No newline at end of file
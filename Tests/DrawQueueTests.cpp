@@ -0,0 +1,92 @@
+﻿//DrawQueue sorting and instanced batching, run headless against the null backend
+//Returns non-zero if any check fails
+
+#include "../Managers/ResourceManager.h"
+#include "../Rendering/DrawQueue.h"
+#include "TestHarness.h"
+
+static DrawItem MakeItem(ID3D11Buffer* vertexBuffer, UINT material, float depth, const float* transform)
+{
+    DrawItem item{};
+    item.sortKey = DrawQueue::MakeSortKey(0, 0, material, depth);
+    item.primitiveTopology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+    item.vertexBuffer = vertexBuffer;
+    item.vertexStride = 32;
+    item.count = 36;
+    if (transform)
+    {
+        item.instanceData = transform;
+        item.instanceDataSize = 16 * sizeof(float);
+    }
+    return item;
+}
+
+//Instances of two meshes sharing a material, submitted alternately in depth order, still make one instanced draw per mesh
+static void TestInterleavedMeshesMerge(ID3D11Buffer* meshA, ID3D11Buffer* meshB)
+{
+    const float transform[16]{};
+    DrawQueue queue;
+    for (UINT i{ 0 }; i < 8; ++i)
+    {
+        queue.Submit(MakeItem((i % 2 == 0) ? (meshA) : (meshB), 1, static_cast<float>(i) / 8.0f, transform));
+    }
+    queue.Sort();
+    CHECK(queue.GetCount() == 8);
+    CHECK(queue.GetDrawCount() == 2);
+
+    //Each mesh's instances stay in front-to-back order within its batch
+    for (size_t i{ 1 }; i < queue.GetCount(); ++i)
+    {
+        const DrawItem& previous{ queue.GetSortedItem(i - 1) };
+        const DrawItem& item{ queue.GetSortedItem(i) };
+        if (previous.vertexBuffer == item.vertexBuffer) { CHECK(previous.sortKey <= item.sortKey); }
+    }
+
+    const NullCommandLog& log{ GetHeadlessCommandLog() };
+    const UINT64 drawsBefore{ log.GetCount(NULL_COMMAND_DRAW_INSTANCED) };
+    queue.Execute();
+    CHECK(log.GetCount(NULL_COMMAND_DRAW_INSTANCED) - drawsBefore == 2);
+}
+
+//Different materials never share an instanced draw, and items without instance data are drawn one at a time
+static void TestBatchBoundaries(ID3D11Buffer* meshA, ID3D11Buffer* meshB)
+{
+    const float transform[16]{};
+    DrawQueue queue;
+    for (UINT i{ 0 }; i < 6; ++i)
+    {
+        queue.Submit(MakeItem(meshA, 1 + i % 3, static_cast<float>(i) / 6.0f, transform));
+    }
+    for (UINT i{ 0 }; i < 4; ++i)
+    {
+        queue.Submit(MakeItem(meshB, 1, static_cast<float>(i) / 4.0f, nullptr));
+    }
+    queue.Sort();
+    CHECK(queue.GetDrawCount() == 3 + 4);
+
+    //Mesh ids carry over a Clear(), and still group the next frame's instances
+    queue.Clear();
+    queue.Submit(MakeItem(meshB, 1, 0.5f, transform));
+    queue.Submit(MakeItem(meshA, 1, 0.25f, transform));
+    queue.Submit(MakeItem(meshB, 1, 0.75f, transform));
+    queue.Sort();
+    CHECK(queue.GetDrawCount() == 2);
+}
+
+int main()
+{
+    InitialiseHeadlessEngine();
+
+    const BYTE vertices[36 * 32]{};
+    D3D11_SUBRESOURCE_DATA data{ vertices, 0, 0 };
+    const BufferHandle meshA{ ResourceManager::CreateVertexBuffer(sizeof(vertices), false, false, &data) };
+    const BufferHandle meshB{ ResourceManager::CreateVertexBuffer(sizeof(vertices), false, false, &data) };
+    TestInterleavedMeshesMerge(ResourceManager::Get(meshA), ResourceManager::Get(meshB));
+    TestBatchBoundaries(ResourceManager::Get(meshA), ResourceManager::Get(meshB));
+    ResourceManager::Release(meshA);
+    ResourceManager::Release(meshB);
+
+    ShutdownHeadlessEngine();
+
+    return FinishTests("DrawQueue");
+}
\ No newline at end of file
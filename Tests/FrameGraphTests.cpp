@@ -0,0 +1,137 @@
+﻿//FrameGraph culling, transient texture aliasing and target binding, run headless against the null backend
+//Returns non-zero if any check fails
+
+#include <cstring>
+
+#include "../Managers/PipelineManager.h"
+#include "../Managers/ResourceManager.h"
+#include "../Rendering/FrameGraph.h"
+#include "TestHarness.h"
+
+static const FrameGraphTextureDescription colourDescription{ 0, 0, DXGI_FORMAT_R8G8B8A8_UNORM, { 0.0f, 0.0f, 0.0f, 1.0f }, 1.0f, 0 };
+static const FrameGraphTextureDescription depthDescription{ 0, 0, DXGI_FORMAT_D32_FLOAT, { 0.0f, 0.0f, 0.0f, 0.0f }, 1.0f, 0 };
+
+//A pass whose output is never read is culled, along with the passes only it depended on
+static void TestCulling(const FrameGraphImportedTexture& backBuffer)
+{
+    FrameGraph graph;
+    graph.SetReferenceSize(64, 64);
+    const FrameGraphResource output{ graph.ImportTexture("BackBuffer", backBuffer) };
+
+    FrameGraphResource unused{};
+    FrameGraphResource unusedInput{};
+    graph.AddPass("UnusedInput", [&](FrameGraphBuilder& builder) { unusedInput = builder.CreateTexture("UnusedInput", colourDescription); builder.WriteRenderTarget(unusedInput); }, [](const FrameGraphPassResources&) {});
+    graph.AddPass("Unused", [&](FrameGraphBuilder& builder) { builder.Read(unusedInput); unused = builder.CreateTexture("Unused", colourDescription); builder.WriteRenderTarget(unused); }, [](const FrameGraphPassResources&) {});
+    graph.AddPass("Final", [&](FrameGraphBuilder& builder) { builder.WriteRenderTarget(output); }, [](const FrameGraphPassResources&) {});
+    CHECK(graph.Compile());
+
+    const std::vector<const char*> order{ graph.GetExecutionOrder() };
+    CHECK(order.size() == 1 && std::strcmp(order[0], "Final") == 0);
+    CHECK(graph.GetStatistics().passes == 3);
+    CHECK(graph.GetStatistics().culledPasses == 2);
+    graph.ReleaseTransientTextures();
+}
+
+//Transient textures with matching descriptions and lifetimes that don't overlap share one physical texture
+static void TestAliasing(const FrameGraphImportedTexture& backBuffer)
+{
+    FrameGraph graph;
+    graph.SetReferenceSize(64, 64);
+    const FrameGraphResource output{ graph.ImportTexture("BackBuffer", backBuffer) };
+
+    FrameGraphResource a{};
+    FrameGraphResource b{};
+    FrameGraphResource c{};
+    graph.AddPass("A", [&](FrameGraphBuilder& builder) { a = builder.CreateTexture("A", colourDescription); builder.WriteRenderTarget(a, true); }, [](const FrameGraphPassResources&) {});
+    graph.AddPass("B", [&](FrameGraphBuilder& builder) { builder.Read(a); b = builder.CreateTexture("B", colourDescription); builder.WriteRenderTarget(b, true); }, [](const FrameGraphPassResources&) {});
+    graph.AddPass("C", [&](FrameGraphBuilder& builder) { builder.Read(b); c = builder.CreateTexture("C", colourDescription); builder.WriteRenderTarget(c, true); }, [](const FrameGraphPassResources&) {});
+    graph.AddPass("Final", [&](FrameGraphBuilder& builder) { builder.Read(c); builder.WriteRenderTarget(output); }, [](const FrameGraphPassResources&) {});
+    CHECK(graph.Compile());
+
+    //A is free again once B has read it, so C can take its texture
+    CHECK(graph.GetStatistics().transientTextures == 3);
+    CHECK(graph.GetStatistics().physicalTextures == 2);
+    CHECK(graph.GetStatistics().physicalBytes < graph.GetStatistics().transientBytes);
+    graph.ReleaseTransientTextures();
+}
+
+//A pass without targets (e.g. a compute pass) runs with the previous pass's targets unbound, and a later pass with
+//targets binds its own again
+static void TestPassWithoutTargetsUnbindsTargets(const FrameGraphImportedTexture& backBuffer)
+{
+    FrameGraph graph;
+    graph.SetReferenceSize(64, 64);
+    const FrameGraphResource output{ graph.ImportTexture("BackBuffer", backBuffer) };
+    NullCommandLog& log{ GetHeadlessCommandLog() };
+
+    FrameGraphResource colour{};
+    FrameGraphResource depth{};
+    bool sceneBound{ false };
+    bool computeUnbound{ false };
+    bool compositeBound{ false };
+    graph.AddPass("Scene", [&](FrameGraphBuilder& builder)
+    {
+        colour = builder.CreateTexture("Colour", colourDescription);
+        depth = builder.CreateTexture("Depth", depthDescription);
+        builder.WriteRenderTarget(colour, true);
+        builder.WriteDepthStencil(depth, true);
+    },
+    [&](const FrameGraphPassResources& resources)
+    {
+        sceneBound = PipelineManager::GetCurrentRenderTargetViews()[0] == resources.GetRenderTargetView(colour) && PipelineManager::GetCurrentDepthStencilView() == resources.GetDepthStencilView(depth);
+        PipelineManager::FlushBindings();
+    });
+    graph.AddPass("Compute", [&](FrameGraphBuilder& builder) { builder.SetSideEffects(); },
+    [&](const FrameGraphPassResources&)
+    {
+        computeUnbound = PipelineManager::GetCurrentRenderTargetViews()[0] == nullptr && PipelineManager::GetCurrentDepthStencilView() == nullptr;
+
+        //The unbind reaches the context as an output merger call with no targets
+        log.Clear();
+        PipelineManager::FlushBindings();
+        const std::vector<NullCommand>& commands{ log.GetCommands() };
+        CHECK(commands.size() == 1);
+        CHECK(commands.size() == 1 && commands[0].type == NULL_COMMAND_OM_SET_RENDER_TARGETS && commands[0].args[0] == 0 && commands[0].args[1] == 0);
+    });
+    graph.AddPass("Composite", [&](FrameGraphBuilder& builder) { builder.Read(colour); builder.WriteRenderTarget(output); },
+    [&](const FrameGraphPassResources& resources)
+    {
+        compositeBound = PipelineManager::GetCurrentRenderTargetViews()[0] == resources.GetRenderTargetView(output) && PipelineManager::GetCurrentDepthStencilView() == nullptr;
+    });
+
+    graph.Execute();
+    const std::vector<const char*> order{ graph.GetExecutionOrder() };
+    CHECK(order.size() == 3 && std::strcmp(order[1], "Compute") == 0);
+    CHECK(sceneBound);
+    CHECK(computeUnbound);
+    CHECK(compositeBound);
+
+    PipelineManager::BindRenderTargetViews({});
+    PipelineManager::FlushBindings();
+    graph.ReleaseTransientTextures();
+}
+
+int main()
+{
+    InitialiseHeadlessEngine();
+
+    //Stands in for the swapchain back buffer
+    const Texture2DHandle texture{ ResourceManager::CreateRenderTexture2D(64, 64, DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_RENDER_TARGET) };
+    const RenderTargetViewHandle renderTargetView{ ResourceManager::CreateTexture2DRenderTargetView(texture, 0, DXGI_FORMAT_R8G8B8A8_UNORM) };
+    FrameGraphImportedTexture backBuffer{};
+    backBuffer.texture = ResourceManager::Get(texture);
+    backBuffer.width = 64;
+    backBuffer.height = 64;
+    backBuffer.renderTargetView = ResourceManager::Get(renderTargetView);
+
+    TestCulling(backBuffer);
+    TestAliasing(backBuffer);
+    TestPassWithoutTargetsUnbindsTargets(backBuffer);
+
+    ResourceManager::Release(renderTargetView);
+    ResourceManager::Release(texture);
+
+    ShutdownHeadlessEngine();
+
+    return FinishTests("FrameGraph");
+}
\ No newline at end of file
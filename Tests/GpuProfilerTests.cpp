@@ -0,0 +1,121 @@
+﻿//GpuProfiler readback and statistics, fed by the null backend's synthetic timestamp clock
+//Returns non-zero if any check fails
+
+#include "../Rendering/GpuProfiler.h"
+#include "TestHarness.h"
+
+//Draws cost a millisecond of synthetic GPU time and everything else nothing, so a scope around n draws takes exactly n ms
+constexpr UINT64 MILLISECOND_TICKS{ NULL_TIMESTAMP_FREQUENCY / 1000 };
+
+static void RunFrame(GpuProfiler& profiler, NullGraphicsDevice& device, GraphicsSwapChain* swapChain, UINT draws)
+{
+    profiler.BeginFrame();
+    const UINT scope{ profiler.BeginScope("Work") };
+    for (UINT i{ 0 }; i < draws; ++i)
+    {
+        device.GetImmediateContext()->Draw(3, 0);
+    }
+    profiler.EndScope(scope);
+    profiler.EndFrame();
+    swapChain->Present(0, 0);
+}
+
+//Twenty frames of 1 to 20 ms, submitted out of order - nearest rank puts p95 on the 19th sample and p99 on the 20th
+static void TestPercentiles(NullGraphicsDevice& device, GraphicsSwapChain* swapChain)
+{
+    GpuProfiler profiler;
+    CHECK(profiler.Initialise(&device, device.GetImmediateContext(), 4, 20));
+    for (UINT i{ 0 }; i < 20; ++i)
+    {
+        RunFrame(profiler, device, swapChain, 1 + (i * 7) % 20);
+    }
+    //Reads back the last frame
+    profiler.BeginFrame();
+
+    GpuScopeStatistics statistics{};
+    CHECK(profiler.GetStatistics("Work", statistics));
+    CHECK(statistics.samples == 20);
+    CHECK(statistics.depth == 1);
+    CHECK(statistics.minimum == 1.0);
+    CHECK(statistics.maximum == 20.0);
+    CHECK(statistics.median == 10.0);
+    CHECK(statistics.percentile95 == 19.0);
+    CHECK(statistics.percentile99 == 20.0);
+    CHECK(statistics.last == 1.0 + (19 * 7) % 20);
+    CHECK(profiler.GetCounters().resolvedFrames == 20);
+    CHECK(profiler.GetCounters().droppedFrames == 0);
+    profiler.Shutdown();
+}
+
+//Frames whose clock was disjoint are read back but add no samples
+static void TestDisjointFramesSkipped(NullGraphicsDevice& device, GraphicsSwapChain* swapChain)
+{
+    GpuProfiler profiler;
+    CHECK(profiler.Initialise(&device, device.GetImmediateContext(), 4, 20));
+    RunFrame(profiler, device, swapChain, 2);
+    device.SetTimestampsDisjoint(true);
+    RunFrame(profiler, device, swapChain, 50);
+    RunFrame(profiler, device, swapChain, 50);
+    device.SetTimestampsDisjoint(false);
+    RunFrame(profiler, device, swapChain, 4);
+    profiler.BeginFrame();
+
+    GpuScopeStatistics statistics{};
+    CHECK(profiler.GetStatistics("Work", statistics));
+    CHECK(statistics.samples == 2);
+    CHECK(statistics.maximum == 4.0);
+    CHECK(profiler.GetCounters().resolvedFrames == 4);
+    CHECK(profiler.GetCounters().disjointFrames == 2);
+    profiler.Shutdown();
+}
+
+//With the GPU further behind than the ring is long, frames are dropped rather than waited on, and profiling resumes once a slot frees up
+static void TestRingOverflow(NullGraphicsDevice& device, GraphicsSwapChain* swapChain)
+{
+    GpuProfiler profiler;
+    CHECK(profiler.Initialise(&device, device.GetImmediateContext(), 4, 20));
+    device.SetQueryLatency(6);
+    for (UINT i{ 0 }; i < 4; ++i)
+    {
+        RunFrame(profiler, device, swapChain, 1);
+    }
+    CHECK(profiler.GetCounters().droppedFrames == 0);
+
+    //The oldest frame only becomes readable six presents after it ended
+    RunFrame(profiler, device, swapChain, 1);
+    RunFrame(profiler, device, swapChain, 1);
+    CHECK(profiler.GetCounters().droppedFrames == 2);
+    CHECK(profiler.GetCounters().resolvedFrames == 0);
+
+    RunFrame(profiler, device, swapChain, 1);
+    CHECK(profiler.GetCounters().droppedFrames == 2);
+    CHECK(profiler.GetCounters().resolvedFrames == 1);
+    device.SetQueryLatency(1);
+    profiler.Shutdown();
+}
+
+int main()
+{
+    NullGraphicsDevice device;
+    device.GetNullImmediateContext().GetCommandLog().SetSyntheticCosts(0, MILLISECOND_TICKS);
+
+    DXGI_SWAP_CHAIN_DESC desc{};
+    desc.BufferDesc.Width = 64;
+    desc.BufferDesc.Height = 64;
+    desc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    desc.SampleDesc.Count = 1;
+    desc.BufferCount = 2;
+    desc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+    GraphicsSwapChain* swapChain{};
+    CHECK(SUCCEEDED(device.CreateSwapChain(nullptr, &desc, &swapChain)));
+    if (swapChain)
+    {
+        TestPercentiles(device, swapChain);
+        TestDisjointFramesSkipped(device, swapChain);
+        TestRingOverflow(device, swapChain);
+        delete swapChain;
+    }
+    CHECK(device.GetLiveObjectCount() == 0);
+
+    return FinishTests("GpuProfiler");
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+﻿//JobManager stress tests - continuation ordering, ParallelFor coverage and waiting from inside jobs, run on the headless engine's
+//job workers
+//Returns non-zero if any check fails
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "../Managers/JobManager.h"
+#include "TestHarness.h"
+
+
+//Chains of stages where every job of a stage is held back until the whole of the stage before has finished - repeated, so the
+//continuations race the completions they depend on
+static void TestDependencyOrdering()
+{
+    constexpr UINT ROUNDS{ 200 };
+    constexpr UINT STAGES{ 6 };
+    constexpr UINT WIDTH{ 16 };
+
+    std::atomic<UINT> violations{ 0 };
+    for (UINT round{ 0 }; round < ROUNDS; ++round)
+    {
+        std::unique_ptr<JobCounter[]> counters{ std::make_unique<JobCounter[]>(STAGES) };
+        std::unique_ptr<std::atomic<UINT>[]> finished{ std::make_unique<std::atomic<UINT>[]>(STAGES) };
+        for (UINT stage{ 0 }; stage < STAGES; ++stage) { finished[stage] = 0; }
+
+        for (UINT stage{ 0 }; stage < STAGES; ++stage)
+        {
+            for (UINT job{ 0 }; job < WIDTH; ++job)
+            {
+                const auto function{ [&finished, &violations, stage]()
+                {
+                    if (stage > 0 && finished[stage - 1].load() != WIDTH) { ++violations; }
+                    ++finished[stage];
+                } };
+                if (stage == 0) { JobManager::Schedule(function, &counters[stage]); }
+                else            { JobManager::ScheduleAfter(counters[stage - 1], function, &counters[stage]); }
+            }
+        }
+        JobManager::Wait(counters[STAGES - 1]);
+        CHECK(finished[STAGES - 1] == WIDTH);
+        for (UINT stage{ 0 }; stage < STAGES; ++stage) { JobManager::Wait(counters[stage]); }
+    }
+    CHECK(violations == 0);
+
+    //A continuation of a counter that has already finished runs straight away
+    JobCounter done;
+    JobCounter after;
+    bool ran{ false };
+    JobManager::ScheduleAfter(done, [&ran]() { ran = true; }, &after);
+    JobManager::Wait(after);
+    CHECK(ran);
+}
+
+//Every index of the range is visited exactly once, whatever the batch size
+static void TestParallelFor()
+{
+    constexpr UINT COUNT{ 100000 };
+    const UINT threads{ JobManager::GetThreadCount() };
+    for (const UINT batchSize : { 0u, 1u, 37u, 1000u, COUNT + 1 })
+    {
+        std::unique_ptr<std::atomic<UINT>[]> visits{ std::make_unique<std::atomic<UINT>[]>(COUNT) };
+        for (UINT i{ 0 }; i < COUNT; ++i) { visits[i] = 0; }
+        std::atomic<UINT> badThreads{ 0 };
+        JobManager::ParallelFor(0, COUNT, batchSize, [&](UINT begin, UINT end)
+            {
+                if (JobManager::GetThreadIndex() >= threads) { ++badThreads; }
+                for (UINT i{ begin }; i < end; ++i) { ++visits[i]; }
+            });
+
+        UINT wrong{ 0 };
+        for (UINT i{ 0 }; i < COUNT; ++i) { wrong += (visits[i] != 1) ? (1) : (0); }
+        CHECK(wrong == 0);
+        CHECK(badThreads == 0);
+    }
+
+    bool called{ false };
+    JobManager::ParallelFor(10, 10, 4, [&called](UINT, UINT) { called = true; });
+    CHECK(!called);
+}
+
+//Jobs that wait on jobs of their own (more of them than there are threads) run queued work while they wait instead of starving the pool
+static void TestWaitInsideJobs()
+{
+    constexpr UINT OUTER{ 64 };
+    constexpr UINT INNER{ 32 };
+
+    std::unique_ptr<std::atomic<UINT>[]> sums{ std::make_unique<std::atomic<UINT>[]>(OUTER) };
+    for (UINT i{ 0 }; i < OUTER; ++i) { sums[i] = 0; }
+    std::atomic<UINT> incomplete{ 0 };
+    JobCounter outer;
+    for (UINT i{ 0 }; i < OUTER; ++i)
+    {
+        JobManager::Schedule([&sums, &incomplete, i]()
+            {
+                JobCounter inner;
+                for (UINT j{ 0 }; j < INNER; ++j)
+                {
+                    JobManager::Schedule([&sums, i, j]() { sums[i] += j; }, &inner);
+                }
+                JobManager::Wait(inner);
+                if (sums[i] != INNER * (INNER - 1) / 2) { ++incomplete; }
+
+                //Nested ParallelFor waits the same way
+                std::atomic<UINT> visited{ 0 };
+                JobManager::ParallelFor(0, INNER, 4, [&visited](UINT begin, UINT end) { visited += end - begin; });
+                if (visited != INNER) { ++incomplete; }
+            }, &outer);
+    }
+    JobManager::Wait(outer);
+    CHECK(incomplete == 0);
+    for (UINT i{ 0 }; i < OUTER; ++i) { CHECK(sums[i] == INNER * (INNER - 1) / 2); }
+}
+
+int main()
+{
+    EngineDescription ed{ HeadlessEngineDescription() };
+    ed.jd.workerCount = 3;
+    InitialiseHeadlessEngine(ed);
+
+    TestDependencyOrdering();
+    TestParallelFor();
+    TestWaitInsideJobs();
+
+    ShutdownHeadlessEngine();
+
+    return FinishTests("JobManager");
+}
\ No newline at end of file
@@ -0,0 +1,188 @@
+﻿//PipelineManager binding cache - elided rebinds, dirty range coalescing and read/write hazards - run headless against the null backend
+//Returns non-zero if any check fails
+
+#include "../Managers/PipelineManager.h"
+#include "../Managers/ResourceManager.h"
+#include "TestHarness.h"
+
+//Flushes the pending bindings and returns the calls it issued
+static std::vector<NullCommand> Flush()
+{
+    NullCommandLog& log{ GetHeadlessCommandLog() };
+    log.Clear();
+    PipelineManager::FlushBindings();
+    return log.GetCommands();
+}
+
+//Starts a test from nothing bound
+static void Reset()
+{
+    PipelineManager::BindRenderTargetViews({});
+    PipelineManager::BindDepthStencilView(nullptr);
+    ID3D11ShaderResourceView* const nullViews[16]{};
+    PipelineManager::BindShaderResourceViews(nullViews, PIXEL_SHADER, 0, 16);
+    ID3D11UnorderedAccessView* const nullUnorderedAccessViews[D3D11_PS_CS_UAV_REGISTER_COUNT]{};
+    PipelineManager::BindUnorderedAccessViews(nullUnorderedAccessViews, PIXEL_SHADER, 0, D3D11_PS_CS_UAV_REGISTER_COUNT);
+    PipelineManager::BindUnorderedAccessViews(nullUnorderedAccessViews, COMPUTE_SHADER, 0, D3D11_PS_CS_UAV_REGISTER_COUNT);
+    PipelineManager::FlushBindings();
+}
+
+//Binding what is already bound issues nothing
+static void TestElidedRebinds(ID3D11ShaderResourceView* view)
+{
+    Reset();
+    PipelineManager::BindShaderResourceViews(&view, PIXEL_SHADER, 0, 1);
+    CHECK(Flush().size() == 1);
+
+    PipelineManager::BindShaderResourceViews(&view, PIXEL_SHADER, 0, 1);
+    CHECK(Flush().empty());
+
+    //Changing a slot and changing it back before the flush issues nothing either
+    ID3D11ShaderResourceView* const nullView{ nullptr };
+    PipelineManager::BindShaderResourceViews(&nullView, PIXEL_SHADER, 0, 1);
+    PipelineManager::BindShaderResourceViews(&view, PIXEL_SHADER, 0, 1);
+    CHECK(Flush().empty());
+}
+
+//Contiguous dirty slots go out as one call, separated ones as one call each
+static void TestDirtyRangeCoalescing(ID3D11ShaderResourceView* view)
+{
+    Reset();
+    for (UINT slot{ 2 }; slot < 5; ++slot)
+    {
+        PipelineManager::BindShaderResourceViews(&view, PIXEL_SHADER, slot, 1);
+    }
+    std::vector<NullCommand> commands{ Flush() };
+    CHECK(commands.size() == 1);
+    CHECK(commands.size() == 1 && commands[0].type == NULL_COMMAND_SET_SHADER_RESOURCES && commands[0].args[0] == 2 && commands[0].args[1] == 3);
+
+    PipelineManager::BindShaderResourceViews(&view, PIXEL_SHADER, 6, 1);
+    PipelineManager::BindShaderResourceViews(&view, PIXEL_SHADER, 8, 1);
+    commands = Flush();
+    CHECK(commands.size() == 2);
+    CHECK(commands.size() == 2 && commands[0].args[0] == 6 && commands[0].args[1] == 1 && commands[1].args[0] == 8 && commands[1].args[1] == 1);
+}
+
+//A texture being read is unbound as an SRV when it is bound as a render target, with the SRV nulled before the render target is set
+static void TestRenderTargetUnbindsShaderResourceView(ID3D11ShaderResourceView* view, ID3D11RenderTargetView* renderTargetView)
+{
+    Reset();
+    PipelineManager::BindShaderResourceViews(&view, PIXEL_SHADER, 0, 1);
+    PipelineManager::FlushBindings();
+
+    PipelineManager::BindRenderTargetViews({ renderTargetView });
+    const std::vector<NullCommand> commands{ Flush() };
+    CHECK(commands.size() == 2);
+    CHECK(commands.size() == 2 && commands[0].type == NULL_COMMAND_SET_SHADER_RESOURCES && commands[0].object == nullptr);
+    CHECK(commands.size() == 2 && commands[1].type == NULL_COMMAND_OM_SET_RENDER_TARGETS && commands[1].object == renderTargetView);
+}
+
+//A texture being written is unbound as a render target when it is bound as an SRV, with the render target unset before the SRV is set
+static void TestShaderResourceViewUnbindsRenderTarget(ID3D11ShaderResourceView* view, ID3D11RenderTargetView* renderTargetView)
+{
+    Reset();
+    PipelineManager::BindRenderTargetViews({ renderTargetView });
+    PipelineManager::FlushBindings();
+
+    PipelineManager::BindShaderResourceViews(&view, PIXEL_SHADER, 0, 1);
+    CHECK(PipelineManager::GetCurrentRenderTargetViews()[0] == nullptr);
+    const std::vector<NullCommand> commands{ Flush() };
+    CHECK(commands.size() == 2);
+    CHECK(commands.size() == 2 && commands[0].type == NULL_COMMAND_OM_SET_RENDER_TARGETS && commands[0].args[0] == 0);
+    CHECK(commands.size() == 2 && commands[1].type == NULL_COMMAND_SET_SHADER_RESOURCES && commands[1].object == view);
+}
+
+//As above for a depth buffer and its depth stencil view
+static void TestDepthStencilViewHazards(ID3D11ShaderResourceView* view, ID3D11DepthStencilView* depthStencilView)
+{
+    Reset();
+    PipelineManager::BindShaderResourceViews(&view, PIXEL_SHADER, 3, 1);
+    PipelineManager::FlushBindings();
+
+    PipelineManager::BindDepthStencilView(depthStencilView);
+    std::vector<NullCommand> commands{ Flush() };
+    CHECK(commands.size() == 2);
+    CHECK(commands.size() == 2 && commands[0].type == NULL_COMMAND_SET_SHADER_RESOURCES && commands[0].object == nullptr && commands[0].args[0] == 3);
+    CHECK(commands.size() == 2 && commands[1].type == NULL_COMMAND_OM_SET_RENDER_TARGETS && commands[1].args[1] == 1);
+
+    PipelineManager::BindShaderResourceViews(&view, PIXEL_SHADER, 3, 1);
+    CHECK(PipelineManager::GetCurrentDepthStencilView() == nullptr);
+    commands = Flush();
+    CHECK(commands.size() == 2);
+    CHECK(commands.size() == 2 && commands[0].type == NULL_COMMAND_OM_SET_RENDER_TARGETS && commands[0].args[1] == 0);
+    CHECK(commands.size() == 2 && commands[1].type == NULL_COMMAND_SET_SHADER_RESOURCES && commands[1].object == view);
+}
+
+//Only the conflicting render target is unbound - the others keep their slots
+static void TestOtherRenderTargetsKept(ID3D11ShaderResourceView* view, ID3D11RenderTargetView* renderTargetView, ID3D11RenderTargetView* otherRenderTargetView)
+{
+    Reset();
+    PipelineManager::BindRenderTargetViews({ otherRenderTargetView, renderTargetView });
+    PipelineManager::FlushBindings();
+
+    PipelineManager::BindShaderResourceViews(&view, PIXEL_SHADER, 0, 1);
+    const std::vector<ID3D11RenderTargetView*> renderTargetViews{ PipelineManager::GetCurrentRenderTargetViews() };
+    CHECK(renderTargetViews[0] == otherRenderTargetView);
+    CHECK(renderTargetViews[1] == nullptr);
+    const std::vector<NullCommand> commands{ Flush() };
+    CHECK(commands.size() == 2 && commands[0].type == NULL_COMMAND_OM_SET_RENDER_TARGETS && commands[0].args[0] == 1);
+}
+
+//A pixel shader UAV in a render target's slot is dropped rather than issued, and the cache doesn't believe it is bound
+static void TestOverlappingUnorderedAccessViewDropped(ID3D11UnorderedAccessView* unorderedAccessView, ID3D11RenderTargetView* renderTargetView)
+{
+    Reset();
+    PipelineManager::BindUnorderedAccessViews(&unorderedAccessView, PIXEL_SHADER, 0, 1);
+    PipelineManager::BindRenderTargetViews({ renderTargetView });
+    std::vector<NullCommand> commands{ Flush() };
+    CHECK(commands.size() == 1);
+    CHECK(commands.size() == 1 && commands[0].type == NULL_COMMAND_OM_SET_RENDER_TARGETS);
+    PipelineManager::BindRenderTargetViews({ renderTargetView });
+    CHECK(Flush().empty());
+
+    //Binding it after the render targets works
+    PipelineManager::BindUnorderedAccessViews(&unorderedAccessView, PIXEL_SHADER, 1, 1);
+    commands = Flush();
+    CHECK(commands.size() == 1);
+    CHECK(commands.size() == 1 && commands[0].type == NULL_COMMAND_OM_SET_RENDER_TARGETS_AND_UNORDERED_ACCESS_VIEWS && commands[0].args[0] == 1 && commands[0].args[1] == 1);
+}
+
+int main()
+{
+    InitialiseHeadlessEngine();
+
+    const Texture2DHandle colour{ ResourceManager::CreateRenderTexture2D(64, 64, DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE) };
+    const Texture2DHandle otherColour{ ResourceManager::CreateRenderTexture2D(64, 64, DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE) };
+    const Texture2DHandle depth{ ResourceManager::CreateRenderTexture2D(64, 64, DXGI_FORMAT_R24G8_TYPELESS, D3D11_BIND_DEPTH_STENCIL | D3D11_BIND_SHADER_RESOURCE) };
+    const ShaderResourceViewHandle colourView{ ResourceManager::CreateTexture2DShaderResourceView(colour, 0, 1, DXGI_FORMAT_R8G8B8A8_UNORM) };
+    const RenderTargetViewHandle colourTarget{ ResourceManager::CreateTexture2DRenderTargetView(colour, 0, DXGI_FORMAT_R8G8B8A8_UNORM) };
+    const RenderTargetViewHandle otherColourTarget{ ResourceManager::CreateTexture2DRenderTargetView(otherColour, 0, DXGI_FORMAT_R8G8B8A8_UNORM) };
+    const ShaderResourceViewHandle depthView{ ResourceManager::CreateTexture2DShaderResourceView(depth, 0, 1, DXGI_FORMAT_R24_UNORM_X8_TYPELESS) };
+    const DepthStencilViewHandle depthTarget{ ResourceManager::CreateTexture2DDepthStencilView(depth, 0, DXGI_FORMAT_D24_UNORM_S8_UINT) };
+    const BufferHandle buffer{ ResourceManager::CreateStructuredBuffer(64, 16, false, true, nullptr) };
+    const UnorderedAccessViewHandle bufferView{ ResourceManager::CreateBufferUnorderedAccessView(buffer, 0, 64, DXGI_FORMAT_UNKNOWN) };
+
+    TestElidedRebinds(ResourceManager::Get(colourView));
+    TestDirtyRangeCoalescing(ResourceManager::Get(colourView));
+    TestRenderTargetUnbindsShaderResourceView(ResourceManager::Get(colourView), ResourceManager::Get(colourTarget));
+    TestShaderResourceViewUnbindsRenderTarget(ResourceManager::Get(colourView), ResourceManager::Get(colourTarget));
+    TestDepthStencilViewHazards(ResourceManager::Get(depthView), ResourceManager::Get(depthTarget));
+    TestOtherRenderTargetsKept(ResourceManager::Get(colourView), ResourceManager::Get(colourTarget), ResourceManager::Get(otherColourTarget));
+    TestOverlappingUnorderedAccessViewDropped(ResourceManager::Get(bufferView), ResourceManager::Get(colourTarget));
+
+    Reset();
+    ResourceManager::Release(bufferView);
+    ResourceManager::Release(buffer);
+    ResourceManager::Release(depthTarget);
+    ResourceManager::Release(depthView);
+    ResourceManager::Release(otherColourTarget);
+    ResourceManager::Release(colourTarget);
+    ResourceManager::Release(colourView);
+    ResourceManager::Release(depth);
+    ResourceManager::Release(otherColour);
+    ResourceManager::Release(colour);
+
+    ShutdownHeadlessEngine();
+
+    return FinishTests("PipelineManager");
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+﻿//RenderManager's readback queue - delivery order, the ring of in-flight frames and region validation, run headless against the null
+//backend, whose event queries signal a fixed number of presents after they end
+//Returns non-zero if any check fails
+
+#include <cstring>
+#include <vector>
+
+#include "../Managers/RenderManager.h"
+#include "TestHarness.h"
+
+
+constexpr UINT READBACK_LATENCY{ 2 };
+
+//Callbacks fire in request order, and only once the frame's event has signalled
+static void TestDeliveryOrder()
+{
+    UINT values[16];
+    for (UINT i{ 0 }; i < 16; ++i) { values[i] = i * 10; }
+    D3D11_SUBRESOURCE_DATA data{ values, 0, 0 };
+    const BufferHandle buffer{ ResourceManager::CreateVertexBuffer(sizeof(values), false, false, &data) };
+    const Texture2DHandle texture{ ResourceManager::CreateRenderTexture2D(16, 16, DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_SHADER_RESOURCE) };
+
+    std::vector<UINT> order;
+    UINT read[2]{};
+    UINT textureRowPitch{ 0 };
+    CHECK(RenderManager::ReadbackBuffer(buffer, 2 * sizeof(UINT), sizeof(read), [&](const void* result, UINT rowPitch)
+        {
+            order.push_back(0);
+            CHECK(rowPitch == sizeof(read));
+            std::memcpy(read, result, sizeof(read));
+        }));
+    CHECK(RenderManager::ReadbackTexture2D(texture, 0, 4, 4, 8, 8, [&](const void*, UINT rowPitch)
+        {
+            order.push_back(1);
+            textureRowPitch = rowPitch;
+        }));
+    CHECK(RenderManager::ReadbackBuffer(buffer, 0, sizeof(UINT), [&](const void*, UINT) { order.push_back(2); }));
+
+    //The event is ended after the first frame and signals READBACK_LATENCY presents later, to be seen at the start of the next frame
+    for (UINT frame{ 0 }; frame < READBACK_LATENCY; ++frame)
+    {
+        EngineManager::Update();
+        CHECK(order.empty());
+        CHECK(RenderManager::GetReadbackStatistics().pendingFrames == 1);
+    }
+    EngineManager::Update();
+    CHECK(order.size() == 3 && order[0] == 0 && order[1] == 1 && order[2] == 2);
+    CHECK(read[0] == 20 && read[1] == 30);
+    CHECK(textureRowPitch >= 8 * 4);
+
+    const ReadbackQueueStatistics statistics{ RenderManager::GetReadbackStatistics() };
+    CHECK(statistics.pendingRequests == 0);
+    CHECK(statistics.pendingFrames == 0);
+    CHECK(statistics.deliveredRequests == 3);
+
+    ResourceManager::Release(texture);
+    ResourceManager::Release(buffer);
+}
+
+//Once every slot of the ring is waiting on its event, requests are rejected rather than stalling until one frees up
+static void TestRejectedWhileRingFull()
+{
+    UINT value{ 7 };
+    D3D11_SUBRESOURCE_DATA data{ &value, 0, 0 };
+    const BufferHandle buffer{ ResourceManager::CreateVertexBuffer(sizeof(value), false, false, &data) };
+    UINT delivered{ 0 };
+    const ReadbackCallback callback{ [&](const void*, UINT) { ++delivered; } };
+    const UINT64 rejected{ RenderManager::GetReadbackStatistics().rejectedRequests };
+
+    for (UINT frame{ 0 }; frame < READBACK_LATENCY; ++frame)
+    {
+        CHECK(RenderManager::ReadbackBuffer(buffer, 0, sizeof(value), callback));
+        EngineManager::Update();
+    }
+    CHECK(RenderManager::GetReadbackStatistics().pendingFrames == READBACK_LATENCY);
+    CHECK(!RenderManager::ReadbackBuffer(buffer, 0, sizeof(value), callback));
+    CHECK(RenderManager::GetReadbackStatistics().rejectedRequests == rejected + 1);
+
+    //The start of the next frame delivers the oldest slot, which takes requests again
+    EngineManager::Update();
+    CHECK(delivered == 1);
+    CHECK(RenderManager::ReadbackBuffer(buffer, 0, sizeof(value), callback));
+    for (UINT frame{ 0 }; frame <= READBACK_LATENCY; ++frame) { EngineManager::Update(); }
+    CHECK(delivered == 3);
+
+    ResourceManager::Release(buffer);
+}
+
+//Regions outside the buffer or subresource are refused, as the runtime would silently drop the copy
+static void TestOutOfRangeRegions()
+{
+    UINT values[4]{};
+    D3D11_SUBRESOURCE_DATA data{ values, 0, 0 };
+    const BufferHandle buffer{ ResourceManager::CreateVertexBuffer(sizeof(values), false, false, &data) };
+    const Texture2DHandle texture{ ResourceManager::CreateRenderTexture2D(16, 16, DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_SHADER_RESOURCE) };
+    const ReadbackCallback callback{ [](const void*, UINT) {} };
+    const ReadbackQueueStatistics before{ RenderManager::GetReadbackStatistics() };
+
+    CHECK(!RenderManager::ReadbackBuffer(buffer, 0, sizeof(values) + 1, callback));
+    CHECK(!RenderManager::ReadbackBuffer(buffer, sizeof(values), 1, callback));
+    CHECK(!RenderManager::ReadbackBuffer(buffer, 0xFFFFFFFF, 2, callback));
+    CHECK(!RenderManager::ReadbackTexture2D(texture, 0, 8, 0, 9, 1, callback));
+    CHECK(!RenderManager::ReadbackTexture2D(texture, 0, 0, 16, 1, 1, callback));
+    CHECK(!RenderManager::ReadbackTexture2D(texture, 1, 0, 0, 1, 1, callback));
+
+    const ReadbackQueueStatistics after{ RenderManager::GetReadbackStatistics() };
+    CHECK(after.pendingRequests == before.pendingRequests);
+    CHECK(after.rejectedRequests == before.rejectedRequests);
+
+    //The edges themselves are in range
+    CHECK(RenderManager::ReadbackBuffer(buffer, sizeof(values) - 1, 1, callback));
+    CHECK(RenderManager::ReadbackTexture2D(texture, 0, 15, 15, 1, 1, callback));
+    for (UINT frame{ 0 }; frame <= READBACK_LATENCY; ++frame) { EngineManager::Update(); }
+
+    ResourceManager::Release(texture);
+    ResourceManager::Release(buffer);
+}
+
+int main()
+{
+    EngineDescription ed{ HeadlessEngineDescription() };
+    ed.rd.readbackLatency = READBACK_LATENCY;
+    InitialiseHeadlessEngine(ed);
+    GetHeadlessDevice().SetQueryLatency(READBACK_LATENCY);
+
+    TestDeliveryOrder();
+    TestRejectedWhileRingFull();
+    TestOutOfRangeRegions();
+
+    ShutdownHeadlessEngine();
+
+    return FinishTests("ReadbackQueue");
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+﻿//RenderManager::RecordParallel - deferred command lists replayed in job order, run headless against the null backend
+//Returns non-zero if any check fails
+
+#include <chrono>
+#include <thread>
+
+#include "../Managers/JobManager.h"
+#include "../Managers/PipelineManager.h"
+#include "../Managers/RenderManager.h"
+#include "../Managers/ResourceManager.h"
+#include "TestHarness.h"
+
+//Each job draws job + 1 vertices, with the earlier jobs finishing last, and the draws still reach the immediate context in job order
+static void TestReplayOrder(ID3D11RenderTargetView* renderTargetView)
+{
+    constexpr UINT jobCount{ 6 };
+    PipelineManager::BindRenderTargetViews({ renderTargetView });
+    PipelineManager::FlushBindings();
+
+    NullCommandLog& log{ GetHeadlessCommandLog() };
+    log.Clear();
+    RenderManager::RecordParallel(jobCount, [](UINT job)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2 * (jobCount - job)));
+        PipelineManager::Draw(job + 1);
+    });
+
+    UINT executed{ 0 };
+    UINT draws{ 0 };
+    bool inheritedTargets{ true };
+    const std::vector<NullCommand>& commands{ log.GetCommands() };
+    for (size_t i{ 0 }; i < commands.size(); ++i)
+    {
+        if (commands[i].type == NULL_COMMAND_EXECUTE_COMMAND_LIST)
+        {
+            ++executed;
+            //Each job starts with the caller's render targets bound
+            inheritedTargets = inheritedTargets && i + 1 < commands.size() && commands[i + 1].type == NULL_COMMAND_OM_SET_RENDER_TARGETS && commands[i + 1].object == renderTargetView;
+        }
+        if (commands[i].type == NULL_COMMAND_DRAW)
+        {
+            ++draws;
+            CHECK(commands[i].args[0] == draws);
+            CHECK(executed == draws);
+        }
+    }
+    CHECK(executed == jobCount);
+    CHECK(draws == jobCount);
+    CHECK(inheritedTargets);
+
+    PipelineManager::BindRenderTargetViews({});
+    PipelineManager::FlushBindings();
+}
+
+//Executing the command lists resets the immediate context, so what the main thread had bound is issued again by the next flush
+static void TestBindingCacheInvalidated(ID3D11ShaderResourceView* view)
+{
+    PipelineManager::BindShaderResourceViews(&view, PIXEL_SHADER, 0, 1);
+    PipelineManager::FlushBindings();
+
+    RenderManager::RecordParallel(2, [](UINT) { PipelineManager::Draw(3); });
+
+    NullCommandLog& log{ GetHeadlessCommandLog() };
+    log.Clear();
+    PipelineManager::FlushBindings();
+    bool reissued{ false };
+    for (const NullCommand& command : log.GetCommands())
+    {
+        reissued = reissued || (command.type == NULL_COMMAND_SET_SHADER_RESOURCES && command.object == view && command.stage == PIXEL_SHADER);
+    }
+    CHECK(reissued);
+
+    ID3D11ShaderResourceView* const nullView{ nullptr };
+    PipelineManager::BindShaderResourceViews(&nullView, PIXEL_SHADER, 0, 1);
+    PipelineManager::FlushBindings();
+}
+
+int main()
+{
+    EngineDescription ed{ HeadlessEngineDescription() };
+    ed.jd.workerCount = 3;
+    InitialiseHeadlessEngine(ed);
+
+    const Texture2DHandle texture{ ResourceManager::CreateRenderTexture2D(64, 64, DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE) };
+    const RenderTargetViewHandle renderTargetView{ ResourceManager::CreateTexture2DRenderTargetView(texture, 0, DXGI_FORMAT_R8G8B8A8_UNORM) };
+    const Texture2DHandle otherTexture{ ResourceManager::CreateRenderTexture2D(64, 64, DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_SHADER_RESOURCE) };
+    const ShaderResourceViewHandle shaderResourceView{ ResourceManager::CreateTexture2DShaderResourceView(otherTexture, 0, 1, DXGI_FORMAT_R8G8B8A8_UNORM) };
+
+    TestReplayOrder(ResourceManager::Get(renderTargetView));
+    TestBindingCacheInvalidated(ResourceManager::Get(shaderResourceView));
+
+    ResourceManager::Release(shaderResourceView);
+    ResourceManager::Release(otherTexture);
+    ResourceManager::Release(renderTargetView);
+    ResourceManager::Release(texture);
+
+    ShutdownHeadlessEngine();
+
+    return FinishTests("RecordParallel");
+}
\ No newline at end of file
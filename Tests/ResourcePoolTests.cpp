@@ -0,0 +1,137 @@
+﻿//ResourceManager's resource pool - descriptor-keyed reuse, the initial data rule, views holding resources back and budget
+//eviction, run headless against the null backend
+//Returns non-zero if any check fails
+
+#include "../Managers/ResourceManager.h"
+#include "TestHarness.h"
+
+
+static UINT64 GetCreateCount(NULL_COMMAND_TYPE type)
+{
+    return GetHeadlessDevice().GetCommandLog().GetCount(type);
+}
+
+//Released resources come back for an identical descriptor without the device creating anything, and only for an identical one
+static void TestDescriptorReuse()
+{
+    const UINT64 textures{ GetCreateCount(NULL_COMMAND_CREATE_TEXTURE_2D) };
+    const UINT64 buffers{ GetCreateCount(NULL_COMMAND_CREATE_BUFFER) };
+    const ResourcePoolStatistics before{ ResourceManager::GetPoolStatistics() };
+
+    Texture2DHandle texture{ ResourceManager::CreateRenderTexture2D(64, 64, DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_RENDER_TARGET) };
+    BufferHandle buffer{ ResourceManager::CreateStructuredBuffer(64, 16, false, true, nullptr) };
+    ID3D11Texture2D* const textureObject{ ResourceManager::Get(texture) };
+    ID3D11Buffer* const bufferObject{ ResourceManager::Get(buffer) };
+    CHECK(GetCreateCount(NULL_COMMAND_CREATE_TEXTURE_2D) == textures + 1);
+    CHECK(GetCreateCount(NULL_COMMAND_CREATE_BUFFER) == buffers + 1);
+    ResourceManager::Release(texture);
+    ResourceManager::Release(buffer);
+    CHECK(ResourceManager::GetPoolStatistics().resources == before.resources + 2);
+
+    texture = ResourceManager::CreateRenderTexture2D(64, 64, DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_RENDER_TARGET);
+    buffer = ResourceManager::CreateStructuredBuffer(64, 16, false, true, nullptr);
+    CHECK(GetCreateCount(NULL_COMMAND_CREATE_TEXTURE_2D) == textures + 1);
+    CHECK(GetCreateCount(NULL_COMMAND_CREATE_BUFFER) == buffers + 1);
+    CHECK(ResourceManager::Get(texture) == textureObject);
+    CHECK(ResourceManager::Get(buffer) == bufferObject);
+    CHECK(ResourceManager::GetPoolStatistics().hits == before.hits + 2);
+    CHECK(ResourceManager::GetPoolStatistics().resources == before.resources);
+
+    //Same size, different bind flags
+    const Texture2DHandle other{ ResourceManager::CreateRenderTexture2D(64, 64, DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_SHADER_RESOURCE) };
+    ResourceManager::Release(texture);
+    const Texture2DHandle different{ ResourceManager::CreateRenderTexture2D(64, 64, DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE) };
+    CHECK(GetCreateCount(NULL_COMMAND_CREATE_TEXTURE_2D) == textures + 3);
+    CHECK(ResourceManager::Get(different) != textureObject);
+
+    ResourceManager::Release(different);
+    ResourceManager::Release(other);
+    ResourceManager::Release(buffer);
+    ResourceManager::TrimPool();
+}
+
+//Resources created with initial data (immutable ones always are) keep it, so they are never pooled
+static void TestInitialDataNotPooled()
+{
+    const BYTE vertices[256]{};
+    D3D11_SUBRESOURCE_DATA data{ vertices, 0, 0 };
+    const UINT64 buffers{ GetCreateCount(NULL_COMMAND_CREATE_BUFFER) };
+    const UINT pooled{ ResourceManager::GetPoolStatistics().resources };
+
+    ResourceManager::Release(ResourceManager::CreateVertexBuffer(sizeof(vertices), false, false, &data));
+    ResourceManager::Release(ResourceManager::CreateVertexBuffer(sizeof(vertices), true, false, &data));
+    CHECK(ResourceManager::GetPoolStatistics().resources == pooled);
+
+    ResourceManager::Release(ResourceManager::CreateVertexBuffer(sizeof(vertices), false, false, &data));
+    CHECK(GetCreateCount(NULL_COMMAND_CREATE_BUFFER) == buffers + 3);
+}
+
+//A released resource with a live view goes to the pool with its last view, not before
+static void TestViewsHoldResourceBack()
+{
+    const UINT pooled{ ResourceManager::GetPoolStatistics().resources };
+    const Texture2DHandle texture{ ResourceManager::CreateRenderTexture2D(32, 32, DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_SHADER_RESOURCE) };
+    const ShaderResourceViewHandle view{ ResourceManager::CreateTexture2DShaderResourceView(texture, 0, 1, DXGI_FORMAT_R8G8B8A8_UNORM) };
+    ResourceManager::Release(texture);
+    CHECK(ResourceManager::GetPoolStatistics().resources == pooled);
+    ResourceManager::Release(view);
+    CHECK(ResourceManager::GetPoolStatistics().resources == pooled + 1);
+    ResourceManager::TrimPool();
+}
+
+//Past the budget the least recently released resources are destroyed, and lowering the budget evicts straight away
+static void TestBudgetEviction()
+{
+    ResourceManager::TrimPool();
+    //64x64, 32x32 and 64x32 RGBA8 are 16KB, 4KB and 8KB
+    ResourceManager::SetPoolBudget(24 * 1024);
+    const ResourcePoolStatistics before{ ResourceManager::GetPoolStatistics() };
+    const UINT64 releases{ GetCreateCount(NULL_COMMAND_RELEASE_OBJECT) };
+    const Texture2DHandle large{ ResourceManager::CreateRenderTexture2D(64, 64, DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_RENDER_TARGET) };
+    const Texture2DHandle small{ ResourceManager::CreateRenderTexture2D(32, 32, DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_RENDER_TARGET) };
+    const Texture2DHandle medium{ ResourceManager::CreateRenderTexture2D(64, 32, DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_RENDER_TARGET) };
+    ResourceManager::Release(large);
+    ResourceManager::Release(small);
+    CHECK(ResourceManager::GetPoolStatistics().bytes == 20 * 1024);
+    ResourceManager::Release(medium);
+
+    ResourcePoolStatistics statistics{ ResourceManager::GetPoolStatistics() };
+    CHECK(statistics.evictions == before.evictions + 1);
+    CHECK(statistics.resources == 2);
+    CHECK(statistics.bytes == 12 * 1024);
+    CHECK(GetCreateCount(NULL_COMMAND_RELEASE_OBJECT) == releases + 1);
+
+    //The large texture was the one evicted
+    const UINT64 textures{ GetCreateCount(NULL_COMMAND_CREATE_TEXTURE_2D) };
+    const Texture2DHandle smallAgain{ ResourceManager::CreateRenderTexture2D(32, 32, DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_RENDER_TARGET) };
+    CHECK(GetCreateCount(NULL_COMMAND_CREATE_TEXTURE_2D) == textures);
+    const Texture2DHandle largeAgain{ ResourceManager::CreateRenderTexture2D(64, 64, DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_RENDER_TARGET) };
+    CHECK(GetCreateCount(NULL_COMMAND_CREATE_TEXTURE_2D) == textures + 1);
+
+    //A resource bigger than the whole budget is destroyed rather than pooled
+    ResourceManager::SetPoolBudget(8 * 1024);
+    statistics = ResourceManager::GetPoolStatistics();
+    CHECK(statistics.resources == 1 && statistics.bytes == 8 * 1024);
+    ResourceManager::Release(largeAgain);
+    CHECK(ResourceManager::GetPoolStatistics().resources == 1);
+
+    ResourceManager::SetPoolBudget(0);
+    CHECK(ResourceManager::GetPoolStatistics().resources == 0);
+    ResourceManager::Release(smallAgain);
+    CHECK(ResourceManager::GetPoolStatistics().resources == 0);
+    ResourceManager::SetPoolBudget(RESOURCE_POOL_DEFAULT_BUDGET);
+}
+
+int main()
+{
+    InitialiseHeadlessEngine();
+
+    TestDescriptorReuse();
+    TestInitialDataNotPooled();
+    TestViewsHoldResourceBack();
+    TestBudgetEviction();
+
+    ShutdownHeadlessEngine();
+
+    return FinishTests("ResourcePool");
+}
\ No newline at end of file
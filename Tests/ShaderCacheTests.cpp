@@ -0,0 +1,160 @@
+﻿//ShaderCache - storing and loading entries, stale includes and writes going through a temporary file, run against a directory the
+//test creates and removes
+//Returns non-zero if any check fails
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../Utility/ShaderCache.h"
+#include "TestHarness.h"
+
+
+const std::filesystem::path CACHE_DIRECTORY{ "ShaderCacheTests.cache" };
+const std::filesystem::path INCLUDE_PATH{ "ShaderCacheTests.hlsli" };
+
+static void WriteFile(const std::filesystem::path& path, const std::string& contents)
+{
+    std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+    file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+}
+
+static std::filesystem::path GetEntryPath(UINT64 key)
+{
+    char name[24];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return CACHE_DIRECTORY / name;
+}
+
+static UINT CountTemporaryFiles()
+{
+    UINT count{ 0 };
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator{ CACHE_DIRECTORY })
+    {
+        if (entry.path().extension() == ".tmp") { ++count; }
+    }
+    return count;
+}
+
+//Stored bytecode loads back as it was, keys without an entry miss, and a disabled cache neither stores nor loads
+static void TestRoundTrip()
+{
+    ShaderCache cache;
+    CHECK(cache.Initialise(CACHE_DIRECTORY));
+    CHECK(cache.IsEnabled());
+
+    const std::vector<BYTE> bytecode{ 0x44, 0x58, 0x42, 0x43, 1, 2, 3, 4, 5 };
+    CHECK(cache.Store(1, bytecode.data(), bytecode.size(), {}));
+    std::vector<BYTE> loaded;
+    CHECK(cache.Load(1, loaded));
+    CHECK(loaded == bytecode);
+    CHECK(!cache.Load(2, loaded));
+
+    ShaderCacheStatistics statistics{ cache.GetStatistics() };
+    CHECK(statistics.hits == 1);
+    CHECK(statistics.misses == 1);
+    CHECK(statistics.stale == 0);
+    CHECK(statistics.writes == 1);
+
+    //Entries outlive the cache object
+    ShaderCache reopened;
+    CHECK(reopened.Initialise(CACHE_DIRECTORY));
+    CHECK(reopened.Load(1, loaded));
+    CHECK(loaded == bytecode);
+
+    ShaderCache disabled;
+    CHECK(disabled.Initialise(""));
+    CHECK(!disabled.IsEnabled());
+    CHECK(!disabled.Store(3, bytecode.data(), bytecode.size(), {}));
+    CHECK(!disabled.Load(1, loaded));
+    statistics = disabled.GetStatistics();
+    CHECK(statistics.misses == 0);
+    CHECK(statistics.writes == 0);
+}
+
+//An entry is stale once the contents of an include it was compiled against change, and valid again if they change back
+static void TestStaleIncludes()
+{
+    ShaderCache cache;
+    CHECK(cache.Initialise(CACHE_DIRECTORY));
+    WriteFile(INCLUDE_PATH, "float4 Tint() { return 1.0f; }");
+    CHECK(ShaderCache::HashFile(INCLUDE_PATH) != 0);
+
+    const std::vector<BYTE> bytecode{ 9, 8, 7, 6 };
+    const std::vector<ShaderCacheDependency> dependencies{ { INCLUDE_PATH.string(), ShaderCache::HashFile(INCLUDE_PATH) } };
+    CHECK(cache.Store(10, bytecode.data(), bytecode.size(), dependencies));
+    std::vector<BYTE> loaded;
+    CHECK(cache.Load(10, loaded));
+
+    WriteFile(INCLUDE_PATH, "float4 Tint() { return 0.5f; }");
+    CHECK(!cache.Load(10, loaded));
+    CHECK(cache.GetStatistics().stale == 1);
+
+    WriteFile(INCLUDE_PATH, "float4 Tint() { return 1.0f; }");
+    CHECK(cache.Load(10, loaded));
+    CHECK(loaded == bytecode);
+
+    std::filesystem::remove(INCLUDE_PATH);
+    CHECK(!cache.Load(10, loaded));
+    CHECK(cache.GetStatistics().stale == 2);
+}
+
+//Stores write a temporary file and rename it over the entry, so neither a left over temporary file nor a truncated entry is ever loaded
+static void TestTemporaryFiles()
+{
+    ShaderCache cache;
+    CHECK(cache.Initialise(CACHE_DIRECTORY));
+    const std::vector<BYTE> first{ 1, 1, 1, 1 };
+    const std::vector<BYTE> second{ 2, 2, 2, 2, 2, 2 };
+    CHECK(cache.Store(20, first.data(), first.size(), {}));
+    CHECK(CountTemporaryFiles() == 0);
+
+    //Storing over an entry replaces it
+    CHECK(cache.Store(20, second.data(), second.size(), {}));
+    CHECK(CountTemporaryFiles() == 0);
+    std::vector<BYTE> loaded;
+    CHECK(cache.Load(20, loaded));
+    CHECK(loaded == second);
+
+    //A write interrupted before its rename leaves the entry it would have replaced - or no entry at all - untouched
+    std::filesystem::path interrupted{ GetEntryPath(20) };
+    interrupted += ".tmp";
+    WriteFile(interrupted, "partial");
+    CHECK(cache.Load(20, loaded));
+    CHECK(loaded == second);
+    std::filesystem::path orphaned{ GetEntryPath(21) };
+    orphaned += ".tmp";
+    WriteFile(orphaned, "partial");
+    const UINT64 misses{ cache.GetStatistics().misses };
+    CHECK(!cache.Load(21, loaded));
+    CHECK(cache.GetStatistics().misses == misses + 1);
+
+    //The next store of the key writes over the left over file
+    CHECK(cache.Store(21, first.data(), first.size(), {}));
+    CHECK(!std::filesystem::exists(orphaned));
+    CHECK(cache.Load(21, loaded));
+    CHECK(loaded == first);
+
+    //An entry cut short (as a rename-less write could leave) is stale rather than loaded
+    std::filesystem::resize_file(GetEntryPath(21), std::filesystem::file_size(GetEntryPath(21)) - 2);
+    const UINT64 stale{ cache.GetStatistics().stale };
+    CHECK(!cache.Load(21, loaded));
+    CHECK(cache.GetStatistics().stale == stale + 1);
+    std::filesystem::remove(interrupted);
+}
+
+int main()
+{
+    std::filesystem::remove_all(CACHE_DIRECTORY);
+
+    TestRoundTrip();
+    TestStaleIncludes();
+    TestTemporaryFiles();
+
+    std::filesystem::remove_all(CACHE_DIRECTORY);
+    std::filesystem::remove(INCLUDE_PATH);
+
+    return FinishTests("ShaderCache");
+}
\ No newline at end of file
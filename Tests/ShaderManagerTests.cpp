@@ -0,0 +1,164 @@
+﻿//ShaderManager - asynchronous loads standing in their fallback until they are ready, run headless against the null backend
+//There is no HLSL compiler off Windows, so the permutations are put in the shader cache up front and the source is deliberately
+//not valid HLSL, making a permutation without a cache entry fail to compile on every platform
+//Returns non-zero if any check fails
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Managers/ShaderManager.h"
+#include "../Utility/Hash.h"
+#include "TestHarness.h"
+
+
+const char* const SOURCE_PATH{ "ShaderManagerTests.hlsl" };
+const char* const CACHE_DIRECTORY{ "ShaderManagerTests.cache" };
+const std::string SOURCE{ "Stands in for a shader - only ever loaded from the cache" };
+constexpr UINT COMPILE_FLAGS{ D3DCOMPILE_ENABLE_STRICTNESS | D3DCOMPILE_OPTIMIZATION_LEVEL3 };
+const D3D_SHADER_MACRO FEATURE_DEFINES[]{ { "FEATURE", "1" }, { nullptr, nullptr } };
+
+//The key ShaderManager stores a permutation of SOURCE under, as built by its HashPermutation()
+static UINT64 GetCacheKey(const char* entryPoint, const char* target, const D3D_SHADER_MACRO* defines)
+{
+    const UINT compileFlags{ COMPILE_FLAGS };
+    UINT64 hash{ HashBytes(&SHADER_CACHE_VERSION, sizeof(SHADER_CACHE_VERSION), HashBytes(SOURCE.data(), SOURCE.size())) };
+    hash = HashBytes(&compileFlags, sizeof(compileFlags), hash);
+    hash = HashBytes(SOURCE_PATH, std::strlen(SOURCE_PATH) + 1, hash);
+    hash = HashBytes(entryPoint, std::strlen(entryPoint) + 1, hash);
+    hash = HashBytes(target, std::strlen(target) + 1, hash);
+    for (const D3D_SHADER_MACRO* define{ defines }; define && define->Name; ++define)
+    {
+        hash = HashBytes(define->Name, std::strlen(define->Name) + 1, hash);
+        hash = HashBytes(define->Definition, std::strlen(define->Definition) + 1, hash);
+    }
+    return hash;
+}
+
+static bool PopulateCache()
+{
+    std::ofstream source{ SOURCE_PATH, std::ios::binary | std::ios::trunc };
+    source.write(SOURCE.data(), static_cast<std::streamsize>(SOURCE.size()));
+    source.close();
+
+    ShaderCache cache;
+    const BYTE bytecode[]{ 0x44, 0x58, 0x42, 0x43, 1, 2, 3, 4 };
+    return cache.Initialise(CACHE_DIRECTORY)
+        && cache.Store(GetCacheKey("VSMain", "vs_5_0", nullptr), bytecode, sizeof(bytecode), {})
+        && cache.Store(GetCacheKey("VSMain", "vs_5_0", FEATURE_DEFINES), bytecode, sizeof(bytecode), {});
+}
+
+//Keeps the job workers busy until released, so asynchronous loads stay pending
+class WorkerBlocker
+{
+public:
+    WorkerBlocker()
+    {
+        const UINT workers{ JobManager::GetThreadCount() - 1 };
+        for (UINT i{ 0 }; i < workers; ++i)
+        {
+            JobManager::Schedule([this]()
+                {
+                    ++blocked;
+                    while (!released) { std::this_thread::yield(); }
+                }, &counter);
+        }
+        while (blocked < workers) { std::this_thread::yield(); }
+    }
+    ~WorkerBlocker() { Release(); }
+
+    void Release()
+    {
+        released = true;
+        JobManager::Wait(counter);
+    }
+
+private:
+    std::atomic<UINT> blocked{ 0 };
+    std::atomic<bool> released{ false };
+    JobCounter counter;
+};
+
+//Runs frames until no asynchronous loads are pending
+static bool UpdateUntilLoaded()
+{
+    for (UINT attempt{ 0 }; attempt < 10000; ++attempt)
+    {
+        if (ShaderManager::GetStatistics().pending == 0) { return true; }
+        EngineManager::Update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+//Get() hands out the fallback's shader while the load is in flight, and the permutation's own once it has been swapped in
+static void TestFallbackWhilePending()
+{
+    const VertexShaderHandle fallback{ ShaderManager::LoadVertexShader(SOURCE_PATH, "VSMain") };
+    ID3D11VertexShader* const fallbackShader{ ShaderManager::Get(fallback) };
+    CHECK(fallbackShader != nullptr);
+    CHECK(ShaderManager::IsReady(fallback));
+
+    WorkerBlocker blocker;
+    const VertexShaderHandle handle{ ShaderManager::LoadVertexShaderAsync(SOURCE_PATH, "VSMain", FEATURE_DEFINES, fallback) };
+    CHECK(!handle.IsNull());
+    CHECK(handle != fallback);
+    CHECK(!ShaderManager::IsReady(handle));
+    CHECK(ShaderManager::Get(handle) == fallbackShader);
+    CHECK(ShaderManager::GetStatistics().pending == 1);
+
+    EngineManager::Update();
+    CHECK(!ShaderManager::IsReady(handle));
+    CHECK(ShaderManager::Get(handle) == fallbackShader);
+
+    //Requesting the permutation again while it is in flight hands out the same handle
+    CHECK(ShaderManager::LoadVertexShaderAsync(SOURCE_PATH, "VSMain", FEATURE_DEFINES, fallback) == handle);
+
+    blocker.Release();
+    CHECK(UpdateUntilLoaded());
+    CHECK(ShaderManager::IsReady(handle));
+    CHECK(ShaderManager::Get(handle) != nullptr);
+    CHECK(ShaderManager::Get(handle) != fallbackShader);
+    CHECK(ShaderManager::GetStatistics().loaded == 2);
+}
+
+//A permutation that fails to load keeps its fallback for good
+static void TestFailedLoadKeepsFallback()
+{
+    const VertexShaderHandle fallback{ ShaderManager::LoadVertexShader(SOURCE_PATH, "VSMain") };
+    const UINT64 failed{ ShaderManager::GetStatistics().failures };
+
+    const VertexShaderHandle handle{ ShaderManager::LoadVertexShaderAsync(SOURCE_PATH, "VSMissing", nullptr, fallback) };
+    CHECK(ShaderManager::Get(handle) == ShaderManager::Get(fallback));
+    CHECK(UpdateUntilLoaded());
+    CHECK(!ShaderManager::IsReady(handle));
+    CHECK(ShaderManager::Get(handle) == ShaderManager::Get(fallback));
+    CHECK(ShaderManager::GetStatistics().failures == failed + 1);
+}
+
+int main()
+{
+    std::filesystem::remove_all(CACHE_DIRECTORY);
+    CHECK(PopulateCache());
+
+    EngineDescription ed{ HeadlessEngineDescription() };
+    ed.sd.cacheDirectory = CACHE_DIRECTORY;
+    ed.sd.compileFlags = COMPILE_FLAGS;
+    ed.jd.workerCount = 2;
+    InitialiseHeadlessEngine(ed);
+
+    TestFallbackWhilePending();
+    TestFailedLoadKeepsFallback();
+
+    ShutdownHeadlessEngine();
+
+    std::filesystem::remove_all(CACHE_DIRECTORY);
+    std::filesystem::remove(SOURCE_PATH);
+
+    return FinishTests("ShaderManager");
+}
\ No newline at end of file
@@ -0,0 +1,159 @@
+﻿//ResourceManager's state cache - identical state descriptions sharing one refcounted object, run headless against the null backend
+//Returns non-zero if any check fails
+
+#include <cstring>
+
+#include "../Managers/ResourceManager.h"
+#include "TestHarness.h"
+
+
+//The descriptions are filled with a junk byte before their fields are set, so two equal descriptions differ in their padding
+//as uninitialised stack descriptions would
+template<typename Desc>
+static Desc MakeJunkDesc(unsigned char junk)
+{
+    Desc desc;
+    std::memset(&desc, junk, sizeof(desc));
+    return desc;
+}
+
+static D3D11_SAMPLER_DESC MakeSamplerDesc(unsigned char junk, D3D11_FILTER filter)
+{
+    D3D11_SAMPLER_DESC desc{ MakeJunkDesc<D3D11_SAMPLER_DESC>(junk) };
+    desc.Filter = filter;
+    desc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
+    desc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
+    desc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
+    desc.MipLODBias = 0.0f;
+    desc.MaxAnisotropy = 1;
+    desc.ComparisonFunc = D3D11_COMPARISON_NEVER;
+    desc.BorderColor[0] = desc.BorderColor[1] = desc.BorderColor[2] = desc.BorderColor[3] = 0.0f;
+    desc.MinLOD = 0.0f;
+    desc.MaxLOD = 1000.0f;
+    return desc;
+}
+
+static D3D11_BLEND_DESC MakeBlendDesc(unsigned char junk, BOOL blendEnable)
+{
+    D3D11_BLEND_DESC desc{ MakeJunkDesc<D3D11_BLEND_DESC>(junk) };
+    desc.AlphaToCoverageEnable = FALSE;
+    desc.IndependentBlendEnable = FALSE;
+    for (D3D11_RENDER_TARGET_BLEND_DESC& target : desc.RenderTarget)
+    {
+        target.BlendEnable = blendEnable;
+        target.SrcBlend = D3D11_BLEND_SRC_ALPHA;
+        target.DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
+        target.BlendOp = D3D11_BLEND_OP_ADD;
+        target.SrcBlendAlpha = D3D11_BLEND_ONE;
+        target.DestBlendAlpha = D3D11_BLEND_ZERO;
+        target.BlendOpAlpha = D3D11_BLEND_OP_ADD;
+        target.RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+    }
+    return desc;
+}
+
+static D3D11_RASTERIZER_DESC MakeRasterizerDesc(unsigned char junk, D3D11_CULL_MODE cullMode)
+{
+    D3D11_RASTERIZER_DESC desc{ MakeJunkDesc<D3D11_RASTERIZER_DESC>(junk) };
+    desc.FillMode = D3D11_FILL_SOLID;
+    desc.CullMode = cullMode;
+    desc.FrontCounterClockwise = FALSE;
+    desc.DepthBias = 0;
+    desc.DepthBiasClamp = 0.0f;
+    desc.SlopeScaledDepthBias = 0.0f;
+    desc.DepthClipEnable = TRUE;
+    desc.ScissorEnable = FALSE;
+    desc.MultisampleEnable = FALSE;
+    desc.AntialiasedLineEnable = FALSE;
+    return desc;
+}
+
+static D3D11_DEPTH_STENCIL_DESC MakeDepthStencilDesc(unsigned char junk, D3D11_COMPARISON_FUNC depthFunc)
+{
+    D3D11_DEPTH_STENCIL_DESC desc{ MakeJunkDesc<D3D11_DEPTH_STENCIL_DESC>(junk) };
+    desc.DepthEnable = TRUE;
+    desc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
+    desc.DepthFunc = depthFunc;
+    desc.StencilEnable = FALSE;
+    desc.StencilReadMask = 0xFF;
+    desc.StencilWriteMask = 0xFF;
+    desc.FrontFace.StencilFailOp = D3D11_STENCIL_OP_KEEP;
+    desc.FrontFace.StencilDepthFailOp = D3D11_STENCIL_OP_KEEP;
+    desc.FrontFace.StencilPassOp = D3D11_STENCIL_OP_KEEP;
+    desc.FrontFace.StencilFunc = D3D11_COMPARISON_ALWAYS;
+    desc.BackFace = desc.FrontFace;
+    return desc;
+}
+
+//Two equal descriptions share one object, which is only released with the last reference, and a different description gets its own
+template<typename Desc, typename Create>
+static void TestSharedState(const Desc& desc, const Desc& equalDesc, const Desc& otherDesc, Create create, NULL_COMMAND_TYPE createCommand)
+{
+    NullCommandLog& log{ GetHeadlessDevice().GetCommandLog() };
+    const UINT64 creates{ log.GetCount(createCommand) };
+    const UINT64 hits{ ResourceManager::GetStateCacheStatistics().hits };
+
+    const auto first{ create(desc) };
+    const auto second{ create(equalDesc) };
+    CHECK(first == second);
+    CHECK(log.GetCount(createCommand) == creates + 1);
+    CHECK(ResourceManager::GetStateCacheStatistics().hits == hits + 1);
+
+    const auto other{ create(otherDesc) };
+    CHECK(other != first);
+    CHECK(log.GetCount(createCommand) == creates + 2);
+
+    const UINT64 releases{ log.GetCount(NULL_COMMAND_RELEASE_OBJECT) };
+    ResourceManager::Release(first);
+    CHECK(ResourceManager::Get(second) != nullptr);
+    CHECK(log.GetCount(NULL_COMMAND_RELEASE_OBJECT) == releases);
+    ResourceManager::Release(second);
+    CHECK(ResourceManager::Get(second) == nullptr);
+    CHECK(log.GetCount(NULL_COMMAND_RELEASE_OBJECT) == releases + 1);
+
+    //With the last reference gone the same description creates a new object
+    const auto recreated{ create(desc) };
+    CHECK(log.GetCount(createCommand) == creates + 3);
+    CHECK(ResourceManager::Get(recreated) != nullptr);
+
+    ResourceManager::Release(recreated);
+    ResourceManager::Release(other);
+}
+
+static void TestSamplerStates()
+{
+    TestSharedState(MakeSamplerDesc(0x00, D3D11_FILTER_MIN_MAG_MIP_LINEAR), MakeSamplerDesc(0xCD, D3D11_FILTER_MIN_MAG_MIP_LINEAR),
+        MakeSamplerDesc(0x00, D3D11_FILTER_MIN_MAG_MIP_POINT), ResourceManager::CreateSamplerState, NULL_COMMAND_CREATE_SAMPLER_STATE);
+}
+
+static void TestBlendStates()
+{
+    TestSharedState(MakeBlendDesc(0x00, TRUE), MakeBlendDesc(0xCD, TRUE), MakeBlendDesc(0x00, FALSE), ResourceManager::CreateBlendState,
+        NULL_COMMAND_CREATE_BLEND_STATE);
+}
+
+static void TestRasterizerStates()
+{
+    TestSharedState(MakeRasterizerDesc(0x00, D3D11_CULL_BACK), MakeRasterizerDesc(0xCD, D3D11_CULL_BACK), MakeRasterizerDesc(0x00, D3D11_CULL_NONE),
+        ResourceManager::CreateRasterizerState, NULL_COMMAND_CREATE_RASTERIZER_STATE);
+}
+
+static void TestDepthStencilStates()
+{
+    TestSharedState(MakeDepthStencilDesc(0x00, D3D11_COMPARISON_LESS), MakeDepthStencilDesc(0xCD, D3D11_COMPARISON_LESS),
+        MakeDepthStencilDesc(0x00, D3D11_COMPARISON_GREATER), ResourceManager::CreateDepthStencilState, NULL_COMMAND_CREATE_DEPTH_STENCIL_STATE);
+}
+
+int main()
+{
+    InitialiseHeadlessEngine();
+
+    TestSamplerStates();
+    TestBlendStates();
+    TestRasterizerStates();
+    TestDepthStencilStates();
+
+    ShutdownHeadlessEngine();
+
+    return FinishTests("StateCache");
+}
\ No newline at end of file
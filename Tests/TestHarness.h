@@ -0,0 +1,63 @@
+﻿#pragma once
+//Shared by the test executables - CHECK records a failure and carries on, and main() returns FinishTests() once every test has run
+
+#include <cstdlib>
+#include <iostream>
+
+#include "../Backends/NullGraphicsDevice.h"
+#include "../Managers/DeviceManager.h"
+#include "../Managers/EngineManager.h"
+
+inline int failures{ 0 };
+
+#define CHECK(condition) \
+    do { if (!(condition)) { std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed" << std::endl; ++failures; } } while (0)
+
+
+//A 64x64 engine running headless against the null backend with the shader cache off - tests adjust it before InitialiseHeadlessEngine()
+inline EngineDescription HeadlessEngineDescription()
+{
+    static float clearColour[4]{ 0.0f, 0.0f, 0.0f, 1.0f };
+    EngineDescription ed{};
+    ed.wd.winWidth = 64;
+    ed.wd.winHeight = 64;
+    ed.wd.swapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+    ed.wd.bufferCount = 2;
+    ed.rd.clearColour = clearColour;
+    ed.dd.backend = NULL_BACKEND;
+    ed.sd.cacheDirectory = "";
+    return ed;
+}
+
+inline void InitialiseHeadlessEngine(const EngineDescription& ed = HeadlessEngineDescription())
+{
+    EngineManager::Initialise(ed);
+}
+
+inline void ShutdownHeadlessEngine()
+{
+    EngineManager::Shutdown();
+}
+
+inline NullGraphicsDevice& GetHeadlessDevice()
+{
+    return *static_cast<NullGraphicsDevice*>(DeviceManager::GetDevice());
+}
+
+//The calls the headless engine has issued to its immediate context - device calls (creation and release) are in GetHeadlessDevice().GetCommandLog()
+inline NullCommandLog& GetHeadlessCommandLog()
+{
+    return GetHeadlessDevice().GetNullImmediateContext().GetCommandLog();
+}
+
+//Reports the result of a test executable and returns its exit code
+inline int FinishTests(const char* name)
+{
+    if (failures > 0)
+    {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "All " << name << " tests passed" << std::endl;
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,245 @@
+﻿//TextureProcessing conversion, mip filtering and block compression, checked against reference decodes on the CPU
+//Returns non-zero if any check fails
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "../Utility/TextureProcessing.h"
+#include "TestHarness.h"
+
+
+//-----------------------------------------------//
+//-------------REFERENCE BLOCK DECODE------------//
+//-----------------------------------------------//
+static UINT16 ReadUint16(const BYTE* source)
+{
+    return static_cast<UINT16>(source[0] | (source[1] << 8));
+}
+
+static void UnpackRgb565(UINT16 packed, int colour[3])
+{
+    const int r{ (packed >> 11) & 31 };
+    const int g{ (packed >> 5) & 63 };
+    const int b{ packed & 31 };
+    colour[0] = (r << 3) | (r >> 2);
+    colour[1] = (g << 2) | (g >> 4);
+    colour[2] = (b << 3) | (b >> 2);
+}
+
+//BC1 colour block into RGBA8 - BC3 colour blocks are always four colour, BC1 ones are three colour with transparent black
+//when the first endpoint isn't above the second
+static void DecodeColourBlock(const BYTE* block, bool alwaysFourColour, BYTE texels[16][4])
+{
+    const UINT16 packed[2]{ ReadUint16(block), ReadUint16(block + 2) };
+    int palette[4][4]{};
+    UnpackRgb565(packed[0], palette[0]);
+    UnpackRgb565(packed[1], palette[1]);
+    const bool fourColour{ alwaysFourColour || packed[0] > packed[1] };
+    for (UINT c{ 0 }; c < 3; ++c)
+    {
+        palette[2][c] = (fourColour) ? ((2 * palette[0][c] + palette[1][c]) / 3) : ((palette[0][c] + palette[1][c]) / 2);
+        palette[3][c] = (fourColour) ? ((palette[0][c] + 2 * palette[1][c]) / 3) : (0);
+    }
+    palette[0][3] = palette[1][3] = palette[2][3] = 255;
+    palette[3][3] = (fourColour) ? (255) : (0);
+
+    UINT bits;
+    std::memcpy(&bits, block + 4, 4);
+    for (UINT i{ 0 }; i < 16; ++i)
+    {
+        for (UINT c{ 0 }; c < 4; ++c) { texels[i][c] = static_cast<BYTE>(palette[(bits >> (i * 2)) & 3][c]); }
+    }
+}
+
+//BC4 block into one channel of RGBA8 - signed values are mapped back from [-1,1] the way CompressBlocks() maps them in
+static void DecodeChannelBlock(const BYTE* block, bool isSigned, UINT channel, BYTE texels[16][4])
+{
+    const int first{ (isSigned) ? (static_cast<signed char>(block[0])) : (block[0]) };
+    const int second{ (isSigned) ? (static_cast<signed char>(block[1])) : (block[1]) };
+    float palette[8]{ static_cast<float>(first), static_cast<float>(second) };
+    if (first > second)
+    {
+        for (int i{ 1 }; i < 7; ++i) { palette[i + 1] = ((7 - i) * first + i * second) / 7.0f; }
+    }
+    else
+    {
+        for (int i{ 1 }; i < 5; ++i) { palette[i + 1] = ((5 - i) * first + i * second) / 5.0f; }
+        palette[6] = (isSigned) ? (-127.0f) : (0.0f);
+        palette[7] = (isSigned) ? (127.0f) : (255.0f);
+    }
+
+    UINT64 bits{ 0 };
+    for (UINT i{ 0 }; i < 6; ++i) { bits |= static_cast<UINT64>(block[2 + i]) << (i * 8); }
+    for (UINT i{ 0 }; i < 16; ++i)
+    {
+        const float value{ palette[(bits >> (i * 3)) & 7] };
+        texels[i][channel] = static_cast<BYTE>(std::lround((isSigned) ? ((value / 127.0f + 1.0f) / 2.0f * 255.0f) : (value)));
+    }
+}
+
+static void DecodeBlock(const BYTE* block, DXGI_FORMAT format, BYTE texels[16][4])
+{
+    std::memset(texels, 0, 16 * 4);
+    switch (format)
+    {
+    case (DXGI_FORMAT_BC1_UNORM):
+        DecodeColourBlock(block, false, texels);
+        break;
+    case (DXGI_FORMAT_BC3_UNORM):
+        DecodeColourBlock(block + 8, true, texels);
+        DecodeChannelBlock(block, false, 3, texels);
+        break;
+    case (DXGI_FORMAT_BC4_UNORM): case (DXGI_FORMAT_BC4_SNORM):
+        DecodeChannelBlock(block, format == DXGI_FORMAT_BC4_SNORM, 0, texels);
+        break;
+    default:
+        DecodeChannelBlock(block, format == DXGI_FORMAT_BC5_SNORM, 0, texels);
+        DecodeChannelBlock(block + 8, format == DXGI_FORMAT_BC5_SNORM, 1, texels);
+        break;
+    }
+}
+//-----------------------------------------------//
+//----------END OF REFERENCE BLOCK DECODE--------//
+//-----------------------------------------------//
+
+
+
+//Every byte decodes and encodes back to itself, in sRGB and linear
+static void TestRgba8RoundTrip()
+{
+    std::vector<BYTE> texels(256 * 4);
+    for (UINT i{ 0 }; i < 256; ++i) { std::fill_n(&texels[i * 4], 4, static_cast<BYTE>(i)); }
+    for (const bool srgb : { true, false })
+    {
+        LinearImage image{};
+        DecodeRgba8(texels.data(), 256, 1, 256 * 4, srgb, image);
+        std::vector<BYTE> encoded;
+        EncodeRgba8(image, srgb, encoded);
+        CHECK(encoded == texels);
+    }
+}
+
+static LinearImage MakeImage(UINT width, UINT height)
+{
+    LinearImage image{ width, height, std::vector<float>(static_cast<size_t>(width) * height * 4) };
+    return image;
+}
+
+//Filter weights sum to one, so a constant image stays constant down the whole chain, odd sizes included
+static void TestConstantImageStaysConstant()
+{
+    constexpr float colour[4]{ 0.25f, 0.5f, 0.75f, 1.0f };
+    for (const MIP_FILTER filter : { MIP_FILTER_BOX, MIP_FILTER_KAISER })
+    {
+        const UINT sizes[][2]{ { 5, 3 }, { 7, 7 }, { 1, 9 }, { 64, 17 } };
+        for (const auto& size : sizes)
+        {
+            LinearImage source{ MakeImage(size[0], size[1]) };
+            for (size_t i{ 0 }; i < source.texels.size(); ++i) { source.texels[i] = colour[i % 4]; }
+            std::vector<LinearImage> mips;
+            GenerateMips(source, filter, 0, mips);
+            CHECK(mips.size() + 1 == GetMipCount(size[0], size[1]));
+            CHECK(!mips.empty() && mips.back().width == 1 && mips.back().height == 1);
+            float error{ 0.0f };
+            for (const LinearImage& mip : mips)
+            {
+                for (size_t i{ 0 }; i < mip.texels.size(); ++i) { error = (std::max)(error, std::abs(mip.texels[i] - colour[i % 4])); }
+            }
+            CHECK(error < 1e-5f);
+        }
+    }
+}
+
+//The SSE and AVX2 filters give the same mips - on a CPU without AVX2 both runs take the SSE path
+static void TestSseMatchesAvx2()
+{
+    LinearImage source{ MakeImage(37, 23) };
+    UINT seed{ 12345 };
+    for (float& value : source.texels)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        value = static_cast<float>(seed >> 8) / static_cast<float>(1u << 24);
+    }
+    for (const MIP_FILTER filter : { MIP_FILTER_BOX, MIP_FILTER_KAISER })
+    {
+        std::vector<LinearImage> sse;
+        std::vector<LinearImage> avx2;
+        SetAvx2MipFiltersEnabled(false);
+        GenerateMips(source, filter, 0, sse);
+        SetAvx2MipFiltersEnabled(true);
+        GenerateMips(source, filter, 0, avx2);
+        CHECK(sse.size() == avx2.size());
+        float error{ 0.0f };
+        for (size_t m{ 0 }; m < sse.size() && m < avx2.size(); ++m)
+        {
+            CHECK(sse[m].texels.size() == avx2[m].texels.size());
+            for (size_t i{ 0 }; i < sse[m].texels.size() && i < avx2[m].texels.size(); ++i) { error = (std::max)(error, std::abs(sse[m].texels[i] - avx2[m].texels[i])); }
+        }
+        CHECK(error < 1e-5f);
+    }
+}
+
+//Compresses one 4x4 block and checks it decodes back to within tolerance of the source texels
+static void CheckBlockRoundTrip(const BYTE texels[16][4], DXGI_FORMAT format, int tolerance)
+{
+    std::vector<BYTE> blocks;
+    CHECK(CompressBlocks(&texels[0][0], 4, 4, format, blocks));
+    if (blocks.empty()) { return; }
+    BYTE decoded[16][4];
+    DecodeBlock(blocks.data(), format, decoded);
+
+    //Only the channels the format stores are compared
+    const bool hasColour{ format == DXGI_FORMAT_BC1_UNORM || format == DXGI_FORMAT_BC3_UNORM };
+    const UINT channels{ (hasColour) ? (4u) : ((format == DXGI_FORMAT_BC4_UNORM || format == DXGI_FORMAT_BC4_SNORM) ? (1u) : (2u)) };
+    int error{ 0 };
+    for (UINT i{ 0 }; i < 16; ++i)
+    {
+        for (UINT c{ 0 }; c < channels; ++c) { error = (std::max)(error, std::abs(decoded[i][c] - texels[i][c])); }
+    }
+    CHECK(error <= tolerance);
+}
+
+//Solid and two-colour blocks survive every format - 565 endpoints quantise colour to within 4, and BC4's eight value
+//mode (or the [-127,127] mapping of the signed formats) keeps a channel within 1
+static void TestBlockCompression()
+{
+    const DXGI_FORMAT formats[]{ DXGI_FORMAT_BC1_UNORM, DXGI_FORMAT_BC3_UNORM, DXGI_FORMAT_BC4_UNORM, DXGI_FORMAT_BC4_SNORM, DXGI_FORMAT_BC5_UNORM, DXGI_FORMAT_BC5_SNORM };
+    const BYTE colours[][2][4]{ { { 200, 100, 40, 255 }, { 200, 100, 40, 255 } }, { { 255, 0, 0, 255 }, { 0, 0, 255, 255 } }, { { 16, 240, 96, 255 }, { 230, 20, 180, 255 } } };
+    for (const DXGI_FORMAT format : formats)
+    {
+        const bool hasColour{ format == DXGI_FORMAT_BC1_UNORM || format == DXGI_FORMAT_BC3_UNORM };
+        for (const auto& pair : colours)
+        {
+            BYTE texels[16][4];
+            for (UINT i{ 0 }; i < 16; ++i) { std::memcpy(texels[i], pair[(i + i / 4) % 2], 4); }
+            CheckBlockRoundTrip(texels, format, (hasColour) ? (4) : (1));
+        }
+    }
+
+    //BC1 keeps transparent texels transparent, and BC3 keeps a two-level alpha
+    BYTE texels[16][4];
+    for (UINT i{ 0 }; i < 16; ++i)
+    {
+        const BYTE alpha{ static_cast<BYTE>((i % 3 == 0) ? (0) : (255)) };
+        const BYTE texel[4]{ static_cast<BYTE>((alpha) ? (120) : (0)), static_cast<BYTE>((alpha) ? (64) : (0)), static_cast<BYTE>((alpha) ? (8) : (0)), alpha };
+        std::memcpy(texels[i], texel, 4);
+    }
+    CheckBlockRoundTrip(texels, DXGI_FORMAT_BC1_UNORM, 4);
+    CheckBlockRoundTrip(texels, DXGI_FORMAT_BC3_UNORM, 4);
+}
+
+int main()
+{
+    //Filtering and compression are spread across the job threads
+    InitialiseHeadlessEngine();
+
+    TestRgba8RoundTrip();
+    TestConstantImageStaysConstant();
+    TestSseMatchesAvx2();
+    TestBlockCompression();
+
+    ShutdownHeadlessEngine();
+
+    return FinishTests("TextureProcessing");
+}
\ No newline at end of file
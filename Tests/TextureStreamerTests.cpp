@@ -0,0 +1,189 @@
+﻿//TextureStreamer - tail-first residency, least recently used eviction and dropping stale reads, run headless against the null backend
+//on DDS files generated by the test
+//Returns non-zero if any check fails
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include "../Rendering/TextureStreamer.h"
+#include "TestHarness.h"
+
+
+constexpr UINT TEXTURE_SIZE{ 256 };
+constexpr UINT TEXTURE_MIPS{ 9 };
+constexpr UINT TEXTURE_TAIL_MIP{ 2 }; //64x64, the first level no larger than TEXTURE_STREAMER_TAIL_SIZE
+
+//An 8-bit RGBA texture with a full mip chain, in a legacy header
+static bool WriteDds(const char* path)
+{
+    DdsHeader header{};
+    header.size = sizeof(DdsHeader);
+    header.flags = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000; //Caps, height, width, pixel format, mip count
+    header.height = TEXTURE_SIZE;
+    header.width = TEXTURE_SIZE;
+    header.pitchOrLinearSize = TEXTURE_SIZE * 4;
+    header.mipMapCount = TEXTURE_MIPS;
+    header.pixelFormat.size = sizeof(DdsPixelFormat);
+    header.pixelFormat.flags = DDS_PIXEL_FORMAT_RGB | 0x1; //Alpha pixels
+    header.pixelFormat.rgbBitCount = 32;
+    header.pixelFormat.redBitMask = 0x000000FF;
+    header.pixelFormat.greenBitMask = 0x0000FF00;
+    header.pixelFormat.blueBitMask = 0x00FF0000;
+    header.pixelFormat.alphaBitMask = 0xFF000000;
+    header.caps = 0x1000 | 0x400000 | 0x8; //Texture, mipmap, complex
+
+    std::vector<BYTE> texels;
+    for (UINT mip{ 0 }; mip < TEXTURE_MIPS; ++mip)
+    {
+        const UINT size{ TEXTURE_SIZE >> mip };
+        texels.resize(texels.size() + static_cast<size_t>(size) * size * 4, static_cast<BYTE>(mip));
+    }
+
+    std::ofstream stream{ path, std::ios::binary };
+    stream.write(reinterpret_cast<const char*>(&DDS_FILE_MAGIC), sizeof(DDS_FILE_MAGIC));
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.write(reinterpret_cast<const char*>(texels.data()), static_cast<std::streamsize>(texels.size()));
+    return stream.good();
+}
+
+//Reads run on JobManager threads, so Update() until a mip is uploaded - every mip in between must have been uploaded by its own
+//Update(), one level at a time per texture
+static bool UpdateUntilResident(TextureStreamer& streamer, UINT texture, UINT mip)
+{
+    for (UINT attempt{ 0 }; attempt < 10000; ++attempt)
+    {
+        const UINT before{ streamer.GetResidentMip(texture) };
+        if (before <= mip) { return true; }
+        streamer.Update();
+        const UINT after{ streamer.GetResidentMip(texture) };
+        CHECK(after == before || after == before - 1);
+        if (after == before) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+    }
+    return false;
+}
+
+//Loading uploads only the tail, and the finer mips then stream in coarsest first, one per Update()
+static void TestTailFirstResidency(const char* path)
+{
+    TextureStreamer streamer;
+    streamer.Initialise(&GetHeadlessDevice().GetNullImmediateContext(), 0);
+    const UINT texture{ streamer.Load(path) };
+    CHECK(texture != TEXTURE_STREAMER_INVALID_TEXTURE);
+    CHECK(streamer.GetResidentMip(texture) == TEXTURE_TAIL_MIP);
+    CHECK(streamer.GetView(texture) != nullptr);
+
+    //Asked for mip 1 only, streaming stops there
+    streamer.Request(texture, 1);
+    CHECK(UpdateUntilResident(streamer, texture, 1));
+    for (UINT frame{ 0 }; frame < 4; ++frame) { streamer.Update(); }
+    CHECK(streamer.GetResidentMip(texture) == 1);
+
+    streamer.Request(texture, 0);
+    CHECK(UpdateUntilResident(streamer, texture, 0));
+    const TextureStreamerStatistics statistics{ streamer.GetStatistics() };
+    CHECK(statistics.residentBytes == statistics.allocatedBytes);
+    CHECK(statistics.pendingReads == 0);
+
+    //Asking for a coarser mip frees the finer ones on the next Update()
+    streamer.Request(texture, TEXTURE_TAIL_MIP);
+    streamer.Update();
+    CHECK(streamer.GetResidentMip(texture) == TEXTURE_TAIL_MIP);
+    CHECK(streamer.GetStatistics().mipsEvicted == TEXTURE_TAIL_MIP);
+
+    streamer.Reset();
+}
+
+//Lowering the budget cuts down the least recently used texture first, and only by as many levels as it takes
+static void TestBudgetEvictsLeastRecentlyUsed(const char* path)
+{
+    TextureStreamer streamer;
+    streamer.Initialise(&GetHeadlessDevice().GetNullImmediateContext(), 0);
+    const UINT older{ streamer.Load(path) };
+    const UINT newer{ streamer.Load(path) };
+    CHECK(UpdateUntilResident(streamer, older, 0));
+    CHECK(UpdateUntilResident(streamer, newer, 0));
+
+    (void)streamer.GetView(older);
+    streamer.Update();
+    (void)streamer.GetView(newer);
+
+    streamer.SetBudget(streamer.GetStatistics().allocatedBytes - 1);
+    streamer.Update();
+    CHECK(streamer.GetResidentMip(older) == 1);
+    CHECK(streamer.GetResidentMip(newer) == 0);
+    TextureStreamerStatistics statistics{ streamer.GetStatistics() };
+    CHECK(statistics.mipsEvicted == 1);
+    CHECK(statistics.reallocations == 1);
+    CHECK(statistics.allocatedBytes <= statistics.budget);
+
+    //The older texture can't win its mip back from the newer one
+    streamer.Update();
+    CHECK(streamer.GetResidentMip(older) == 1);
+    CHECK(streamer.GetStatistics().pendingReads == 0);
+
+    streamer.Reset();
+}
+
+//A read that finishes after its texture has been reallocated belongs to the old allocation, so it is dropped rather than uploaded
+static void TestStaleReadDropped(const char* path)
+{
+    TextureStreamer streamer;
+    streamer.Initialise(&GetHeadlessDevice().GetNullImmediateContext(), 0);
+    const UINT texture{ streamer.Load(path) };
+
+    //Keeps every worker busy, so the read stays pending until the texture has been reallocated
+    std::atomic<UINT> blocked{ 0 };
+    std::atomic<bool> release{ false };
+    JobCounter blockers;
+    const UINT workers{ JobManager::GetThreadCount() - 1 };
+    for (UINT i{ 0 }; i < workers; ++i)
+    {
+        JobManager::Schedule([&]()
+            {
+                ++blocked;
+                while (!release) { std::this_thread::yield(); }
+            }, &blockers);
+    }
+    while (blocked < workers) { std::this_thread::yield(); }
+
+    streamer.Update();
+    CHECK(streamer.GetStatistics().pendingReads == 1);
+    streamer.Request(texture, TEXTURE_TAIL_MIP);
+    streamer.Update();
+    CHECK(streamer.GetStatistics().reallocations == 1);
+
+    release = true;
+    JobManager::Wait(blockers);
+    for (UINT attempt{ 0 }; attempt < 10000 && streamer.GetStatistics().pendingReads > 0; ++attempt)
+    {
+        streamer.Update();
+        CHECK(streamer.GetStatistics().mipsUploaded == 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(streamer.GetStatistics().pendingReads == 0);
+    CHECK(streamer.GetResidentMip(texture) == TEXTURE_TAIL_MIP);
+
+    streamer.Reset();
+}
+
+int main()
+{
+    EngineDescription ed{ HeadlessEngineDescription() };
+    ed.jd.workerCount = 2;
+    InitialiseHeadlessEngine(ed);
+
+    const char* const path{ "TextureStreamerTests.dds" };
+    CHECK(WriteDds(path));
+    TestTailFirstResidency(path);
+    TestBudgetEvictsLeastRecentlyUsed(path);
+    TestStaleReadDropped(path);
+    std::remove(path);
+
+    ShutdownHeadlessEngine();
+
+    return FinishTests("TextureStreamer");
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+﻿//UploadManager - ring growth, frame-boundary wraps and the pooled constant buffer fallback, run headless against the null backend
+//Returns non-zero if any check fails
+
+#include "../Managers/UploadManager.h"
+#include "TestHarness.h"
+
+
+//Maps of the buffer made with the map type since the log's command at start
+static UINT CountMaps(size_t start, const ID3D11Buffer* buffer, D3D11_MAP mapType)
+{
+    const std::vector<NullCommand>& commands{ GetHeadlessCommandLog().GetCommands() };
+    UINT count{ 0 };
+    for (size_t i{ start }; i < commands.size(); ++i)
+    {
+        if (commands[i].type == NULL_COMMAND_MAP && commands[i].object == buffer && commands[i].args[1] == static_cast<UINT>(mapType)) { ++count; }
+    }
+    return count;
+}
+
+//A ring that overflows within a frame moves to a larger buffer, keeping the outgrown one (and the frame's earlier allocations in it)
+//alive until the frame ends
+static void TestRingGrowth()
+{
+    BYTE data[160]{};
+    const UINT pooled{ ResourceManager::GetPoolStatistics().resources };
+
+    const UploadAllocation first{ UploadManager::UploadVertexData(data, sizeof(data)) };
+    const UploadAllocation second{ UploadManager::UploadVertexData(data, sizeof(data)) };
+    CHECK(first.buffer != nullptr);
+    CHECK(second.buffer != nullptr);
+    CHECK(second.buffer != first.buffer);
+    CHECK(second.offset == 0);
+    CHECK(ResourceManager::GetPoolStatistics().resources == pooled);
+
+    //The outgrown buffer goes back to the resource pool once the frame's draws have been issued
+    EngineManager::Update();
+    CHECK(UploadManager::GetFrameStatistics().ringGrowths == 1);
+    CHECK(ResourceManager::GetPoolStatistics().resources == pooled + 1);
+
+    //The grown ring holds both allocations without growing again
+    const UploadAllocation third{ UploadManager::UploadVertexData(data, sizeof(data)) };
+    const UploadAllocation fourth{ UploadManager::UploadVertexData(data, sizeof(data)) };
+    CHECK(third.buffer == second.buffer);
+    CHECK(fourth.buffer == second.buffer);
+    EngineManager::Update();
+    CHECK(UploadManager::GetFrameStatistics().ringGrowths == 0);
+}
+
+//A ring only wraps at a frame boundary - the first map after the wrap discards, and the rest of the frame's maps don't
+static void TestFrameBoundaryWrap()
+{
+    BYTE data[64]{};
+    const size_t start{ GetHeadlessCommandLog().GetCommands().size() };
+
+    //The first map of a new ring buffer discards
+    const UploadAllocation first{ UploadManager::UploadIndexData(data, sizeof(data)) };
+    (void)UploadManager::UploadIndexData(data, sizeof(data));
+    (void)UploadManager::UploadIndexData(data, sizeof(data));
+    ID3D11Buffer* const buffer{ first.buffer };
+    CHECK(first.offset == 0);
+    CHECK(CountMaps(start, buffer, D3D11_MAP_WRITE_DISCARD) == 1);
+    CHECK(CountMaps(start, buffer, D3D11_MAP_WRITE_NO_OVERWRITE) == 2);
+    EngineManager::Update();
+
+    //192 of the 256 bytes are used and another frame like it wouldn't fit, so the ring wraps at the end of the frame
+    const size_t wrap{ GetHeadlessCommandLog().GetCommands().size() };
+    const UploadAllocation wrapped{ UploadManager::UploadIndexData(data, sizeof(data)) };
+    (void)UploadManager::UploadIndexData(data, sizeof(data));
+    CHECK(wrapped.buffer == buffer);
+    CHECK(wrapped.offset == 0);
+    CHECK(CountMaps(wrap, buffer, D3D11_MAP_WRITE_DISCARD) == 1);
+    CHECK(CountMaps(wrap, buffer, D3D11_MAP_WRITE_NO_OVERWRITE) == 1);
+    EngineManager::Update();
+    CHECK(UploadManager::GetFrameStatistics().ringGrowths == 0);
+}
+
+//Ringed constant data is handed out as 256-byte aligned constant buffer windows
+static void TestConstantRing()
+{
+    BYTE data[100]{};
+    CHECK(UploadManager::UsingConstantRing());
+    const UploadAllocation first{ UploadManager::UploadConstantData(data, sizeof(data)) };
+    const UploadAllocation second{ UploadManager::UploadConstantData(data, sizeof(data)) };
+    CHECK(second.buffer == first.buffer);
+    CHECK(second.firstConstant == first.firstConstant + 16);
+    CHECK(second.numConstants == 16);
+    EngineManager::Update();
+}
+
+//Without constant buffer offsetting each constant upload gets a whole pooled buffer, used once per frame and reused the next
+static void TestPooledConstants()
+{
+    GetHeadlessDevice().SetConstantBufferOffsetsSupported(false);
+    CHECK(!UploadManager::UsingConstantRing());
+
+    BYTE data[100]{};
+    const UploadAllocation first{ UploadManager::UploadConstantData(data, sizeof(data)) };
+    const UploadAllocation second{ UploadManager::UploadConstantData(data, sizeof(data)) };
+    CHECK(first.buffer != nullptr);
+    CHECK(second.buffer != first.buffer);
+    CHECK(first.offset == 0);
+    CHECK(first.firstConstant == 0);
+    CHECK(first.numConstants == 0);
+
+    //Pooled allocations bind as whole buffers, which a device without offsetting accepts
+    NullCommandLog& log{ GetHeadlessCommandLog() };
+    const UINT64 binds{ log.GetCount(NULL_COMMAND_SET_CONSTANT_BUFFERS) };
+    UploadManager::BindConstantData(VERTEX_SHADER, 0, first);
+    PipelineManager::FlushBindings();
+    CHECK(log.GetCount(NULL_COMMAND_SET_CONSTANT_BUFFERS) == binds + 1);
+    EngineManager::Update();
+    UploadStatistics statistics{ UploadManager::GetFrameStatistics() };
+    CHECK(statistics.pooledBuffersCreated == 2);
+    CHECK(statistics.discardMaps == 2);
+    CHECK(statistics.noOverwriteMaps == 0);
+
+    const UploadAllocation reused{ UploadManager::UploadConstantData(data, sizeof(data)) };
+    CHECK(reused.buffer == first.buffer);
+    EngineManager::Update();
+    statistics = UploadManager::GetFrameStatistics();
+    CHECK(statistics.pooledBuffersCreated == 0);
+    CHECK(statistics.discardMaps == 1);
+}
+
+int main()
+{
+    EngineDescription ed{ HeadlessEngineDescription() };
+    ed.ud.vertexRingSize = 256;
+    ed.ud.indexRingSize = 256;
+    InitialiseHeadlessEngine(ed);
+
+    TestRingGrowth();
+    TestFrameBoundaryWrap();
+    TestConstantRing();
+
+    ShutdownHeadlessEngine();
+
+    //The fallback is chosen when the UploadManager is initialised
+    ed.ud.pooledConstantBuffers = true;
+    InitialiseHeadlessEngine(ed);
+
+    TestPooledConstants();
+
+    ShutdownHeadlessEngine();
+
+    return FinishTests("UploadManager");
+}
\ No newline at end of file
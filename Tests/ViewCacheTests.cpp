@@ -0,0 +1,77 @@
+﻿//ResourceManager's view cache - identical view requests sharing one view, and views going with their resource, run headless
+//against the null backend
+//Returns non-zero if any check fails
+
+#include "../Managers/ResourceManager.h"
+#include "TestHarness.h"
+
+
+static UINT64 GetViewCreateCount()
+{
+    return GetHeadlessDevice().GetCommandLog().GetCount(NULL_COMMAND_CREATE_SHADER_RESOURCE_VIEW);
+}
+
+//Identical (resource, description) requests share one view, which lives until each request's handle has been released
+static void TestIdenticalViewsShared()
+{
+    const Texture2DHandle texture{ ResourceManager::CreateRenderTexture2D(64, 64, DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_SHADER_RESOURCE) };
+    const UINT64 views{ GetViewCreateCount() };
+    const UINT cached{ ResourceManager::GetViewCacheStatistics().objects };
+    const ShaderResourceViewHandle first{ ResourceManager::CreateTexture2DShaderResourceView(texture, 0, 1, DXGI_FORMAT_R8G8B8A8_UNORM) };
+    const ShaderResourceViewHandle second{ ResourceManager::CreateTexture2DShaderResourceView(texture, 0, 1, DXGI_FORMAT_R8G8B8A8_UNORM) };
+    CHECK(first == second);
+    CHECK(GetViewCreateCount() == views + 1);
+
+    //Any difference in the description is a different view
+    const ShaderResourceViewHandle srgb{ ResourceManager::CreateTexture2DShaderResourceView(texture, 0, 1, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB) };
+    CHECK(srgb != first);
+    CHECK(GetViewCreateCount() == views + 2);
+
+    ResourceManager::Release(first);
+    CHECK(ResourceManager::Get(second) != nullptr);
+    ResourceManager::Release(second);
+    CHECK(ResourceManager::Get(second) == nullptr);
+    CHECK(ResourceManager::GetViewCacheStatistics().objects == cached + 1);
+
+    ResourceManager::Release(srgb);
+    ResourceManager::Release(texture);
+}
+
+//A view outlives a released resource until it is released itself, and once both have gone the cached view goes with them - a
+//resource recycled at the same address through the pool gets a new view rather than the dead one
+static void TestViewsGoWithTheirResource()
+{
+    Texture2DHandle texture{ ResourceManager::CreateRenderTexture2D(32, 32, DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_SHADER_RESOURCE) };
+    ID3D11Texture2D* const object{ ResourceManager::Get(texture) };
+    const ShaderResourceViewHandle view{ ResourceManager::CreateTexture2DShaderResourceView(texture, 0, 1, DXGI_FORMAT_R8G8B8A8_UNORM) };
+    const UINT cached{ ResourceManager::GetViewCacheStatistics().objects };
+
+    ResourceManager::Release(texture);
+    CHECK(ResourceManager::Get(view) != nullptr);
+    ResourceManager::Release(view);
+    CHECK(ResourceManager::Get(view) == nullptr);
+    CHECK(ResourceManager::GetViewCacheStatistics().objects == cached - 1);
+
+    texture = ResourceManager::CreateRenderTexture2D(32, 32, DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_SHADER_RESOURCE);
+    CHECK(ResourceManager::Get(texture) == object);
+    const UINT64 views{ GetViewCreateCount() };
+    const ShaderResourceViewHandle recycled{ ResourceManager::CreateTexture2DShaderResourceView(texture, 0, 1, DXGI_FORMAT_R8G8B8A8_UNORM) };
+    CHECK(GetViewCreateCount() == views + 1);
+    CHECK(recycled != view);
+    CHECK(ResourceManager::Get(recycled) != nullptr);
+
+    ResourceManager::Release(recycled);
+    ResourceManager::Release(texture);
+}
+
+int main()
+{
+    InitialiseHeadlessEngine();
+
+    TestIdenticalViewsShared();
+    TestViewsGoWithTheirResource();
+
+    ShutdownHeadlessEngine();
+
+    return FinishTests("ViewCache");
+}
\ No newline at end of file
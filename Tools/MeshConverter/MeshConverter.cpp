@@ -0,0 +1,435 @@
+﻿//Offline converter from Wavefront OBJ to the engine's binary mesh format (see Utility/MeshFormat.h)
+//Each input file becomes one LOD, most detailed first - faces are triangulated as fans, identical position/texcoord/normal
+//corners are merged into one vertex, and every LOD is split into meshlets for GPU culling
+//Texture coordinates are flipped vertically to Direct3D's top-left origin; positions and normals are written as they are
+//
+//Usage: MeshConverter output.mesh lod0.obj [lod1.obj ...]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../Utility/MeshFormat.h"
+
+
+//-----------------------------------------------//
+//------------------OBJ PARSING------------------//
+//-----------------------------------------------//
+struct ObjCorner
+{
+    int position;
+    int texcoord; //-1 if absent
+    int normal;   //-1 if absent
+
+    bool operator==(const ObjCorner& other) const { return position == other.position && texcoord == other.texcoord && normal == other.normal; }
+};
+
+struct ObjCornerHash
+{
+    size_t operator()(const ObjCorner& c) const
+    {
+        return (static_cast<size_t>(c.position) * 73856093u) ^ (static_cast<size_t>(c.texcoord) * 19349663u) ^ (static_cast<size_t>(c.normal) * 83492791u);
+    }
+};
+
+struct ObjMesh
+{
+    std::vector<float> positions; //3 per entry
+    std::vector<float> texcoords; //2 per entry
+    std::vector<float> normals;   //3 per entry
+    std::vector<ObjCorner> corners; //3 per triangle
+};
+
+static const char* SkipSpaces(const char* p, const char* end)
+{
+    while (p < end && (*p == ' ' || *p == '\t')) { ++p; }
+    return p;
+}
+
+static const char* NextLine(const char* p, const char* end)
+{
+    while (p < end && *p != '\n') { ++p; }
+    return (p < end) ? (p + 1) : (end);
+}
+
+static bool ParseFloats(const char*& p, const char* end, float* values, UINT count)
+{
+    for (UINT i{ 0 }; i < count; ++i)
+    {
+        p = SkipSpaces(p, end);
+        char* next{ nullptr };
+        values[i] = std::strtof(p, &next);
+        if (next == p) { return false; }
+        p = next;
+    }
+    return true;
+}
+
+//OBJ indices are 1-based, and negative ones count back from the last element defined so far
+static bool ResolveIndex(long index, size_t count, int& resolved)
+{
+    if (index > 0 && static_cast<size_t>(index) <= count)  { resolved = static_cast<int>(index - 1); return true; }
+    if (index < 0 && static_cast<size_t>(-index) <= count) { resolved = static_cast<int>(count + index); return true; }
+    return false;
+}
+
+static bool ParseCorner(const char*& p, const char* end, const ObjMesh& mesh, ObjCorner& corner)
+{
+    char* next{ nullptr };
+    const long position{ std::strtol(p, &next, 10) };
+    if (next == p || !ResolveIndex(position, mesh.positions.size() / 3, corner.position)) { return false; }
+    p = next;
+    corner.texcoord = -1;
+    corner.normal = -1;
+
+    if (p < end && *p == '/')
+    {
+        ++p;
+        if (p < end && *p != '/')
+        {
+            const long texcoord{ std::strtol(p, &next, 10) };
+            if (next == p || !ResolveIndex(texcoord, mesh.texcoords.size() / 2, corner.texcoord)) { return false; }
+            p = next;
+        }
+        if (p < end && *p == '/')
+        {
+            ++p;
+            const long normal{ std::strtol(p, &next, 10) };
+            if (next == p || !ResolveIndex(normal, mesh.normals.size() / 3, corner.normal)) { return false; }
+            p = next;
+        }
+    }
+    return true;
+}
+
+static bool ParseObj(const std::string& path, ObjMesh& mesh)
+{
+    std::ifstream file{ path, std::ios::binary };
+    if (!file)
+    {
+        std::cerr << "ERROR::MESH_CONVERTER::PARSE_OBJ::FAILED_TO_OPEN_FILE::" << path << std::endl;
+        return false;
+    }
+    const std::string text{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+    const char* p{ text.data() };
+    const char* const end{ text.data() + text.size() };
+
+    std::vector<ObjCorner> face;
+    UINT line{ 1 };
+    for (; p < end; p = NextLine(p, end), ++line)
+    {
+        p = SkipSpaces(p, end);
+        bool valid{ true };
+        if (end - p > 2 && p[0] == 'v' && (p[1] == ' ' || p[1] == '\t'))
+        {
+            float v[3];
+            p += 2;
+            valid = ParseFloats(p, end, v, 3);
+            mesh.positions.insert(mesh.positions.end(), v, v + 3);
+        }
+        else if (end - p > 3 && p[0] == 'v' && p[1] == 't' && (p[2] == ' ' || p[2] == '\t'))
+        {
+            float v[2];
+            p += 3;
+            valid = ParseFloats(p, end, v, 2);
+            mesh.texcoords.insert(mesh.texcoords.end(), v, v + 2);
+        }
+        else if (end - p > 3 && p[0] == 'v' && p[1] == 'n' && (p[2] == ' ' || p[2] == '\t'))
+        {
+            float v[3];
+            p += 3;
+            valid = ParseFloats(p, end, v, 3);
+            mesh.normals.insert(mesh.normals.end(), v, v + 3);
+        }
+        else if (end - p > 2 && p[0] == 'f' && (p[1] == ' ' || p[1] == '\t'))
+        {
+            p += 2;
+            face.clear();
+            for (p = SkipSpaces(p, end); valid && p < end && *p != '\n' && *p != '\r'; p = SkipSpaces(p, end))
+            {
+                ObjCorner corner;
+                valid = ParseCorner(p, end, mesh, corner);
+                face.push_back(corner);
+            }
+            valid = valid && face.size() >= 3;
+            for (size_t i{ 2 }; valid && i < face.size(); ++i)
+            {
+                mesh.corners.push_back(face[0]);
+                mesh.corners.push_back(face[i - 1]);
+                mesh.corners.push_back(face[i]);
+            }
+        }
+        //Anything else (comments, groups, materials, smoothing groups) doesn't affect the geometry
+
+        if (!valid)
+        {
+            std::cerr << "ERROR::MESH_CONVERTER::PARSE_OBJ::MALFORMED_LINE::" << path << "(" << line << ")" << std::endl;
+            return false;
+        }
+    }
+    if (mesh.corners.empty())
+    {
+        std::cerr << "ERROR::MESH_CONVERTER::PARSE_OBJ::NO_FACES::" << path << std::endl;
+        return false;
+    }
+    return true;
+}
+//-----------------------------------------------//
+//---------------END OF OBJ PARSING--------------//
+//-----------------------------------------------//
+
+
+
+//-----------------------------------------------//
+//-----------------MESH BUILDING-----------------//
+//-----------------------------------------------//
+struct MeshData
+{
+    UINT vertexAttributes{ 0 };
+    UINT vertexStride{ 0 };
+    std::vector<float> vertices;
+    std::vector<UINT> indices; //Relative to their LOD's base vertex
+    std::vector<MeshFileMeshlet> meshlets;
+    std::vector<UINT> meshletVertices;
+    std::vector<UINT> meshletTriangles;
+    std::vector<MeshFileLod> lods;
+};
+
+static void ComputeSphere(const float* vertices, UINT stride, const UINT* indices, size_t count, INT baseVertex, float centre[3], float& radius)
+{
+    float minimum[3]{ HUGE_VALF, HUGE_VALF, HUGE_VALF };
+    float maximum[3]{ -HUGE_VALF, -HUGE_VALF, -HUGE_VALF };
+    for (size_t i{ 0 }; i < count; ++i)
+    {
+        const float* position{ vertices + static_cast<size_t>(baseVertex + indices[i]) * stride };
+        for (UINT a{ 0 }; a < 3; ++a)
+        {
+            minimum[a] = (std::min)(minimum[a], position[a]);
+            maximum[a] = (std::max)(maximum[a], position[a]);
+        }
+    }
+    float radiusSquared{ 0.0f };
+    for (UINT a{ 0 }; a < 3; ++a) { centre[a] = (minimum[a] + maximum[a]) * 0.5f; }
+    for (size_t i{ 0 }; i < count; ++i)
+    {
+        const float* position{ vertices + static_cast<size_t>(baseVertex + indices[i]) * stride };
+        const float dx{ position[0] - centre[0] };
+        const float dy{ position[1] - centre[1] };
+        const float dz{ position[2] - centre[2] };
+        radiusSquared = (std::max)(radiusSquared, dx * dx + dy * dy + dz * dz);
+    }
+    radius = std::sqrt(radiusSquared);
+}
+
+//Greedy in index order - a meshlet is closed once the next triangle would take it past either limit
+static void BuildMeshlets(MeshData& data, MeshFileLod& lod)
+{
+    const UINT stride{ data.vertexStride / static_cast<UINT>(sizeof(float)) };
+    const UINT* const indices{ data.indices.data() + lod.startIndex };
+    std::vector<UINT> localIndex(lod.vertexCount, static_cast<UINT>(-1));
+    lod.startMeshlet = static_cast<UINT>(data.meshlets.size());
+
+    MeshFileMeshlet meshlet{};
+    meshlet.vertexOffset = static_cast<UINT>(data.meshletVertices.size());
+    meshlet.triangleOffset = static_cast<UINT>(data.meshletTriangles.size());
+    const auto close{ [&]()
+    {
+        if (meshlet.triangleCount == 0) { return; }
+        ComputeSphere(data.vertices.data(), stride, data.meshletVertices.data() + meshlet.vertexOffset, meshlet.vertexCount, lod.baseVertexLocation, meshlet.boundsCentre, meshlet.boundsRadius);
+        for (UINT v{ 0 }; v < meshlet.vertexCount; ++v) { localIndex[data.meshletVertices[meshlet.vertexOffset + v]] = static_cast<UINT>(-1); }
+        data.meshlets.push_back(meshlet);
+        meshlet = {};
+        meshlet.vertexOffset = static_cast<UINT>(data.meshletVertices.size());
+        meshlet.triangleOffset = static_cast<UINT>(data.meshletTriangles.size());
+    } };
+
+    for (UINT t{ 0 }; t < lod.indexCount; t += 3)
+    {
+        UINT newVertices{ 0 };
+        for (UINT c{ 0 }; c < 3; ++c) { newVertices += (localIndex[indices[t + c]] == static_cast<UINT>(-1)) ? (1u) : (0u); }
+        if (meshlet.vertexCount + newVertices > MESHLET_MAX_VERTICES || meshlet.triangleCount == MESHLET_MAX_TRIANGLES) { close(); }
+
+        UINT packed{ 0 };
+        for (UINT c{ 0 }; c < 3; ++c)
+        {
+            UINT& local{ localIndex[indices[t + c]] };
+            if (local == static_cast<UINT>(-1))
+            {
+                local = meshlet.vertexCount++;
+                data.meshletVertices.push_back(indices[t + c]);
+            }
+            packed |= local << (c * 8);
+        }
+        data.meshletTriangles.push_back(packed);
+        ++meshlet.triangleCount;
+    }
+    close();
+    lod.meshletCount = static_cast<UINT>(data.meshlets.size()) - lod.startMeshlet;
+}
+
+static void AddLod(MeshData& data, const ObjMesh& obj)
+{
+    MeshFileLod lod{};
+    lod.startIndex = static_cast<UINT>(data.indices.size());
+    lod.baseVertexLocation = static_cast<INT>(data.vertices.size() / (data.vertexStride / sizeof(float)));
+
+    std::unordered_map<ObjCorner, UINT, ObjCornerHash> vertexIndices;
+    vertexIndices.reserve(obj.corners.size());
+    for (const ObjCorner& corner : obj.corners)
+    {
+        const auto [it, inserted]{ vertexIndices.try_emplace(corner, lod.vertexCount) };
+        data.indices.push_back(it->second);
+        if (!inserted) { continue; }
+        ++lod.vertexCount;
+
+        //Attributes missing from this LOD's corner (but present in another LOD) are written as zeros
+        data.vertices.insert(data.vertices.end(), obj.positions.begin() + corner.position * 3, obj.positions.begin() + corner.position * 3 + 3);
+        if (data.vertexAttributes & MESH_VERTEX_NORMAL)
+        {
+            if (corner.normal >= 0) { data.vertices.insert(data.vertices.end(), obj.normals.begin() + corner.normal * 3, obj.normals.begin() + corner.normal * 3 + 3); }
+            else                    { data.vertices.insert(data.vertices.end(), 3, 0.0f); }
+        }
+        if (data.vertexAttributes & MESH_VERTEX_TEXCOORD)
+        {
+            if (corner.texcoord >= 0)
+            {
+                data.vertices.push_back(obj.texcoords[corner.texcoord * 2]);
+                data.vertices.push_back(1.0f - obj.texcoords[corner.texcoord * 2 + 1]);
+            }
+            else { data.vertices.insert(data.vertices.end(), 2, 0.0f); }
+        }
+    }
+    lod.indexCount = static_cast<UINT>(data.indices.size()) - lod.startIndex;
+    data.lods.push_back(lod);
+    BuildMeshlets(data, data.lods.back());
+}
+//-----------------------------------------------//
+//-------------END OF MESH BUILDING--------------//
+//-----------------------------------------------//
+
+
+
+//-----------------------------------------------//
+//------------------FILE WRITING-----------------//
+//-----------------------------------------------//
+static MeshFileStream PlaceStream(UINT64& offset, UINT64 size)
+{
+    offset = (offset + MESH_FILE_ALIGNMENT - 1) / MESH_FILE_ALIGNMENT * MESH_FILE_ALIGNMENT;
+    const MeshFileStream stream{ offset, size };
+    offset += size;
+    return stream;
+}
+
+static void WriteStream(std::ofstream& file, const MeshFileStream& stream, const void* data)
+{
+    //Pad up to the stream's aligned offset
+    static const char zeros[MESH_FILE_ALIGNMENT]{};
+    file.write(zeros, static_cast<std::streamsize>(stream.offset - static_cast<UINT64>(file.tellp())));
+    file.write(static_cast<const char*>(data), static_cast<std::streamsize>(stream.size));
+}
+
+static bool WriteMesh(const std::string& path, const MeshData& data)
+{
+    MeshFileHeader header{};
+    header.magic = MESH_FILE_MAGIC;
+    header.version = MESH_FILE_VERSION;
+    header.vertexAttributes = data.vertexAttributes;
+    header.vertexStride = data.vertexStride;
+    header.vertexCount = static_cast<UINT>(data.vertices.size() * sizeof(float) / data.vertexStride);
+    header.indexCount = static_cast<UINT>(data.indices.size());
+    header.meshletCount = static_cast<UINT>(data.meshlets.size());
+    header.meshletVertexCount = static_cast<UINT>(data.meshletVertices.size());
+    header.meshletTriangleCount = static_cast<UINT>(data.meshletTriangles.size());
+    header.lodCount = static_cast<UINT>(data.lods.size());
+    std::copy(data.lods.begin(), data.lods.end(), header.lods);
+
+    //16-bit indices whenever every LOD fits, halving the index stream
+    bool shortIndices{ true };
+    for (const MeshFileLod& lod : data.lods) { shortIndices = shortIndices && lod.vertexCount <= 0xFFFF; }
+    header.indexFormat = (shortIndices) ? (DXGI_FORMAT_R16_UINT) : (DXGI_FORMAT_R32_UINT);
+    std::vector<UINT16> shortIndexData;
+    if (shortIndices) { shortIndexData.assign(data.indices.begin(), data.indices.end()); }
+
+    //Bounds over every vertex of every LOD
+    std::vector<UINT> allVertices(header.vertexCount);
+    for (UINT i{ 0 }; i < header.vertexCount; ++i) { allVertices[i] = i; }
+    const UINT stride{ data.vertexStride / static_cast<UINT>(sizeof(float)) };
+    std::fill_n(header.boundsMin, 3, HUGE_VALF);
+    std::fill_n(header.boundsMax, 3, -HUGE_VALF);
+    for (UINT i{ 0 }; i < header.vertexCount; ++i)
+    {
+        for (UINT a{ 0 }; a < 3; ++a)
+        {
+            header.boundsMin[a] = (std::min)(header.boundsMin[a], data.vertices[i * stride + a]);
+            header.boundsMax[a] = (std::max)(header.boundsMax[a], data.vertices[i * stride + a]);
+        }
+    }
+    ComputeSphere(data.vertices.data(), stride, allVertices.data(), allVertices.size(), 0, header.boundsCentre, header.boundsRadius);
+
+    UINT64 offset{ sizeof(header) };
+    header.vertices = PlaceStream(offset, data.vertices.size() * sizeof(float));
+    header.indices = PlaceStream(offset, (shortIndices) ? (shortIndexData.size() * sizeof(UINT16)) : (data.indices.size() * sizeof(UINT)));
+    header.meshlets = PlaceStream(offset, data.meshlets.size() * sizeof(MeshFileMeshlet));
+    header.meshletVertices = PlaceStream(offset, data.meshletVertices.size() * sizeof(UINT));
+    header.meshletTriangles = PlaceStream(offset, data.meshletTriangles.size() * sizeof(UINT));
+
+    std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+    if (!file)
+    {
+        std::cerr << "ERROR::MESH_CONVERTER::WRITE_MESH::FAILED_TO_OPEN_FILE::" << path << std::endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    WriteStream(file, header.vertices, data.vertices.data());
+    WriteStream(file, header.indices, (shortIndices) ? (static_cast<const void*>(shortIndexData.data())) : (static_cast<const void*>(data.indices.data())));
+    WriteStream(file, header.meshlets, data.meshlets.data());
+    WriteStream(file, header.meshletVertices, data.meshletVertices.data());
+    WriteStream(file, header.meshletTriangles, data.meshletTriangles.data());
+    if (!file)
+    {
+        std::cerr << "ERROR::MESH_CONVERTER::WRITE_MESH::FAILED_TO_WRITE_FILE::" << path << std::endl;
+        return false;
+    }
+
+    std::cout << path << ": " << header.lodCount << " LODs, " << header.vertexCount << " vertices, " << header.indexCount / 3 << " triangles, "
+              << header.meshletCount << " meshlets" << std::endl;
+    return true;
+}
+//-----------------------------------------------//
+//--------------END OF FILE WRITING--------------//
+//-----------------------------------------------//
+
+
+
+int main(int argc, char** argv)
+{
+    if (argc < 3 || static_cast<UINT>(argc - 2) > MESH_MAX_LODS)
+    {
+        std::cerr << "Usage: MeshConverter output.mesh lod0.obj [lod1.obj ...] (up to " << MESH_MAX_LODS << " LODs)" << std::endl;
+        return 1;
+    }
+
+    std::vector<ObjMesh> objs(static_cast<size_t>(argc - 2));
+    MeshData data;
+    data.vertexAttributes = MESH_VERTEX_POSITION;
+    for (size_t i{ 0 }; i < objs.size(); ++i)
+    {
+        if (!ParseObj(argv[i + 2], objs[i])) { return 1; }
+        //Every LOD shares one vertex layout, so it holds whatever any of them has
+        if (!objs[i].normals.empty())   { data.vertexAttributes |= MESH_VERTEX_NORMAL; }
+        if (!objs[i].texcoords.empty()) { data.vertexAttributes |= MESH_VERTEX_TEXCOORD; }
+    }
+    data.vertexStride = 3 * sizeof(float);
+    if (data.vertexAttributes & MESH_VERTEX_NORMAL)   { data.vertexStride += 3 * sizeof(float); }
+    if (data.vertexAttributes & MESH_VERTEX_TEXCOORD) { data.vertexStride += 2 * sizeof(float); }
+
+    for (const ObjMesh& obj : objs) { AddLod(data, obj); }
+    return (WriteMesh(argv[1], data)) ? (0) : (1);
+}
\ No newline at end of file
@@ -0,0 +1,278 @@
+﻿//Offline converter from TGA (24 or 32-bit, uncompressed or RLE) or RGBA8/BGRA8 DDS to a DDS with a full mip chain, for the
+//texture streamer (see Rendering/TextureStreamer.h) or ResourceManager::CreateTexture2D()
+//Mips are filtered in linear space (see Utility/TextureProcessing.h) - colour is treated as sRGB unless --linear is given,
+//and the output format is the _SRGB variant to match. BC4 and BC5 hold data rather than colour, so are always linear
+//
+//Usage: TextureConverter input.tga|input.dds output.dds [--format rgba8|bc1|bc3|bc4|bc5] [--filter box|kaiser] [--linear] [--mips N]
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../../Managers/EngineManager.h"
+#include "../../Utility/DdsFormat.h"
+#include "../../Utility/TextureProcessing.h"
+
+
+struct Image
+{
+    UINT width;
+    UINT height;
+    std::vector<BYTE> texels; //RGBA8, rows tightly packed, top row first
+};
+
+
+//-----------------------------------------------//
+//-----------------IMAGE LOADING-----------------//
+//-----------------------------------------------//
+static bool LoadTga(const std::vector<BYTE>& file, Image& image)
+{
+    if (file.size() < 18)
+    {
+        std::cerr << "ERROR::TEXTURE_CONVERTER::LOAD_TGA::TRUNCATED_HEADER" << std::endl;
+        return false;
+    }
+    const UINT idLength{ file[0] };
+    const UINT imageType{ file[2] };
+    const UINT bitsPerTexel{ file[16] };
+    const bool topFirst{ (file[17] & 0x20) != 0 };
+    image.width = file[12] | (file[13] << 8);
+    image.height = file[14] | (file[15] << 8);
+    if (file[1] != 0 || (imageType != 2 && imageType != 10) || (bitsPerTexel != 24 && bitsPerTexel != 32) || image.width == 0 || image.height == 0)
+    {
+        std::cerr << "ERROR::TEXTURE_CONVERTER::LOAD_TGA::UNSUPPORTED_IMAGE_TYPE" << std::endl;
+        return false;
+    }
+
+    //Texels are BGR(A), and run-length encoded in packets of up to 128 for image type 10
+    const UINT texelSize{ bitsPerTexel / 8 };
+    const size_t count{ static_cast<size_t>(image.width) * image.height };
+    std::vector<BYTE> bgra(count * 4);
+    size_t p{ 18 + static_cast<size_t>(idLength) };
+    size_t i{ 0 };
+    while (i < count)
+    {
+        bool repeat{ false };
+        size_t run{ 1 };
+        if (imageType == 10)
+        {
+            if (p >= file.size()) { break; }
+            repeat = (file[p] & 0x80) != 0;
+            run = (file[p] & 0x7F) + 1u;
+            ++p;
+        }
+        for (size_t r{ 0 }; r < run && i < count; ++r, ++i)
+        {
+            if (r == 0 || !repeat) { p += texelSize; }
+            if (p > file.size()) { break; }
+            std::memcpy(&bgra[i * 4], &file[p - texelSize], texelSize);
+            if (texelSize == 3) { bgra[i * 4 + 3] = 255; }
+        }
+        if (p > file.size())
+        {
+            std::cerr << "ERROR::TEXTURE_CONVERTER::LOAD_TGA::TRUNCATED_TEXELS" << std::endl;
+            return false;
+        }
+    }
+    //An RLE file can also run out of packets before the image is filled
+    if (i < count)
+    {
+        std::cerr << "ERROR::TEXTURE_CONVERTER::LOAD_TGA::TRUNCATED_TEXELS" << std::endl;
+        return false;
+    }
+
+    image.texels.resize(count * 4);
+    for (UINT y{ 0 }; y < image.height; ++y)
+    {
+        const BYTE* source{ &bgra[static_cast<size_t>((topFirst) ? (y) : (image.height - 1 - y)) * image.width * 4] };
+        BYTE* destination{ &image.texels[static_cast<size_t>(y) * image.width * 4] };
+        for (UINT x{ 0 }; x < image.width; ++x)
+        {
+            destination[x * 4 + 0] = source[x * 4 + 2];
+            destination[x * 4 + 1] = source[x * 4 + 1];
+            destination[x * 4 + 2] = source[x * 4 + 0];
+            destination[x * 4 + 3] = source[x * 4 + 3];
+        }
+    }
+    return true;
+}
+
+//Only the top mip is read - the chain is regenerated
+static bool LoadDds(const std::vector<BYTE>& file, Image& image)
+{
+    DdsLayout layout;
+    if (!ParseDds(file.data(), file.size(), layout) || layout.blockCompressed)
+    {
+        std::cerr << "ERROR::TEXTURE_CONVERTER::LOAD_DDS::UNSUPPORTED_FILE" << std::endl;
+        return false;
+    }
+    const bool bgra{ layout.format == DXGI_FORMAT_B8G8R8A8_UNORM || layout.format == DXGI_FORMAT_B8G8R8A8_UNORM_SRGB };
+    image.width = layout.width;
+    image.height = layout.height;
+    image.texels.assign(file.begin() + layout.mips[0].offset, file.begin() + layout.mips[0].offset + layout.mips[0].size);
+    for (size_t i{ 0 }; bgra && i < image.texels.size(); i += 4) { std::swap(image.texels[i], image.texels[i + 2]); }
+    return true;
+}
+
+static bool LoadImage(const std::string& path, Image& image)
+{
+    std::ifstream stream{ path, std::ios::binary };
+    if (!stream)
+    {
+        std::cerr << "ERROR::TEXTURE_CONVERTER::LOAD_IMAGE::FAILED_TO_OPEN_FILE::" << path << std::endl;
+        return false;
+    }
+    const std::vector<BYTE> file{ std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>() };
+    UINT magic{ 0 };
+    if (file.size() >= sizeof(magic)) { std::memcpy(&magic, file.data(), sizeof(magic)); }
+    return (magic == DDS_FILE_MAGIC) ? (LoadDds(file, image)) : (LoadTga(file, image));
+}
+//-----------------------------------------------//
+//--------------END OF IMAGE LOADING-------------//
+//-----------------------------------------------//
+
+
+
+//-----------------------------------------------//
+//------------------FILE WRITING-----------------//
+//-----------------------------------------------//
+static bool WriteDds(const std::string& path, DXGI_FORMAT format, UINT width, UINT height, const std::vector<std::vector<BYTE>>& mips)
+{
+    DdsHeader header{};
+    header.size = sizeof(DdsHeader);
+    header.flags = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000; //Caps, height, width, pixel format, mip count
+    header.height = height;
+    header.width = width;
+    header.pitchOrLinearSize = static_cast<UINT>(mips[0].size());
+    header.mipMapCount = static_cast<UINT>(mips.size());
+    header.pixelFormat.size = sizeof(DdsPixelFormat);
+    header.pixelFormat.flags = DDS_PIXEL_FORMAT_FOURCC;
+    header.pixelFormat.fourCC = MakeDdsFourCC('D', 'X', '1', '0');
+    header.caps = 0x1000 | 0x400000 | 0x8; //Texture, mip map, complex
+
+    DdsHeaderDxt10 dxt10{};
+    dxt10.dxgiFormat = format;
+    dxt10.resourceDimension = D3D11_RESOURCE_DIMENSION_TEXTURE2D;
+    dxt10.arraySize = 1;
+
+    std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+    if (!file)
+    {
+        std::cerr << "ERROR::TEXTURE_CONVERTER::WRITE_DDS::FAILED_TO_OPEN_FILE::" << path << std::endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&DDS_FILE_MAGIC), sizeof(DDS_FILE_MAGIC));
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(&dxt10), sizeof(dxt10));
+    size_t bytes{ 0 };
+    for (const std::vector<BYTE>& mip : mips)
+    {
+        file.write(reinterpret_cast<const char*>(mip.data()), static_cast<std::streamsize>(mip.size()));
+        bytes += mip.size();
+    }
+    if (!file)
+    {
+        std::cerr << "ERROR::TEXTURE_CONVERTER::WRITE_DDS::FAILED_TO_WRITE_FILE::" << path << std::endl;
+        return false;
+    }
+
+    std::cout << path << ": " << width << "x" << height << ", " << mips.size() << " mips, " << bytes << " bytes" << std::endl;
+    return true;
+}
+//-----------------------------------------------//
+//--------------END OF FILE WRITING--------------//
+//-----------------------------------------------//
+
+
+
+static bool Convert(const std::string& input, const std::string& output, const std::string& formatName, MIP_FILTER filter, bool srgb, UINT mipCount)
+{
+    DXGI_FORMAT format;
+    if      (formatName == "rgba8") { format = (srgb) ? (DXGI_FORMAT_R8G8B8A8_UNORM_SRGB) : (DXGI_FORMAT_R8G8B8A8_UNORM); }
+    else if (formatName == "bc1")   { format = (srgb) ? (DXGI_FORMAT_BC1_UNORM_SRGB) : (DXGI_FORMAT_BC1_UNORM); }
+    else if (formatName == "bc3")   { format = (srgb) ? (DXGI_FORMAT_BC3_UNORM_SRGB) : (DXGI_FORMAT_BC3_UNORM); }
+    else if (formatName == "bc4")   { format = DXGI_FORMAT_BC4_UNORM; srgb = false; }
+    else if (formatName == "bc5")   { format = DXGI_FORMAT_BC5_UNORM; srgb = false; }
+    else
+    {
+        std::cerr << "ERROR::TEXTURE_CONVERTER::CONVERT::UNKNOWN_FORMAT::" << formatName << std::endl;
+        return false;
+    }
+
+    Image image;
+    if (!LoadImage(input, image)) { return false; }
+    if (mipCount > DDS_MAX_MIPS || GetMipCount(image.width, image.height) > DDS_MAX_MIPS)
+    {
+        std::cerr << "ERROR::TEXTURE_CONVERTER::CONVERT::TOO_MANY_MIPS" << std::endl;
+        return false;
+    }
+
+    LinearImage top;
+    DecodeRgba8(image.texels.data(), image.width, image.height, image.width * 4, srgb, top);
+    std::vector<LinearImage> levels;
+    GenerateMips(top, filter, mipCount, levels);
+
+    std::vector<std::vector<BYTE>> mips(levels.size() + 1);
+    for (size_t i{ 0 }; i < mips.size(); ++i)
+    {
+        std::vector<BYTE> texels;
+        UINT width{ image.width };
+        UINT height{ image.height };
+        if (i == 0) { texels = image.texels; }
+        else
+        {
+            EncodeRgba8(levels[i - 1], srgb, texels);
+            width = levels[i - 1].width;
+            height = levels[i - 1].height;
+        }
+
+        if (format == DXGI_FORMAT_R8G8B8A8_UNORM || format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB) { mips[i] = std::move(texels); }
+        else if (!CompressBlocks(texels.data(), width, height, format, mips[i])) { return false; }
+    }
+    return WriteDds(output, format, image.width, image.height, mips);
+}
+
+int main(int argc, char** argv)
+{
+    std::string format{ "bc1" };
+    MIP_FILTER filter{ MIP_FILTER_KAISER };
+    bool srgb{ true };
+    UINT mipCount{ 0 };
+    bool valid{ argc >= 3 };
+    for (int i{ 3 }; valid && i < argc; ++i)
+    {
+        const std::string option{ argv[i] };
+        if      (option == "--format" && i + 1 < argc) { format = argv[++i]; }
+        else if (option == "--filter" && i + 1 < argc)
+        {
+            const std::string name{ argv[++i] };
+            valid = name == "box" || name == "kaiser";
+            filter = (name == "box") ? (MIP_FILTER_BOX) : (MIP_FILTER_KAISER);
+        }
+        else if (option == "--linear")                 { srgb = false; }
+        else if (option == "--mips" && i + 1 < argc)   { mipCount = static_cast<UINT>(std::strtoul(argv[++i], nullptr, 10)); }
+        else                                           { valid = false; }
+    }
+    if (!valid)
+    {
+        std::cerr << "Usage: TextureConverter input.tga|input.dds output.dds [--format rgba8|bc1|bc3|bc4|bc5] [--filter box|kaiser] [--linear] [--mips N]" << std::endl;
+        return 1;
+    }
+
+    //Headless, only for the job threads that filtering and compression are spread across
+    EngineDescription ed{};
+    ed.wd.winWidth = 1;
+    ed.wd.winHeight = 1;
+    ed.wd.swapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+    ed.wd.bufferCount = 2;
+    ed.dd.backend = NULL_BACKEND;
+    ed.sd.cacheDirectory = "";
+    EngineManager::Initialise(ed);
+    const bool converted{ Convert(argv[1], argv[2], format, filter, srgb, mipCount) };
+    EngineManager::Shutdown();
+    return (converted) ? (0) : (1);
+}
\ No newline at end of file
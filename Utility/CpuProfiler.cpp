@@ -0,0 +1,189 @@
+﻿#include "CpuProfiler.h"
+
+#ifdef ENGINE_CPU_PROFILING
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+std::atomic<bool> CpuProfiler::capturing{ false };
+std::atomic<UINT64> CpuProfiler::generation{ 0 };
+std::atomic<UINT> CpuProfiler::zoneCapacity{ CPU_PROFILER_DEFAULT_ZONES_PER_THREAD };
+INT64 CpuProfiler::captureBegin{ 0 };
+
+std::mutex CpuProfiler::threadsMutex{};
+std::vector<std::unique_ptr<CpuProfiler::ThreadBuffer>> CpuProfiler::threads{};
+thread_local CpuProfiler::ThreadBuffer* CpuProfiler::threadBuffer{ nullptr };
+
+
+//Chrome trace names are JSON strings
+static void WriteEscaped(std::ofstream& file, const char* string)
+{
+    for (const char* c{ string }; *c; ++c)
+    {
+        if (*c == '"' || *c == '\\') { file << '\\'; }
+        if (static_cast<unsigned char>(*c) >= 0x20) { file << *c; }
+    }
+}
+
+
+
+void CpuProfiler::BeginCapture(UINT _zoneCapacity)
+{
+    if (capturing.load()) { return; }
+    const UINT capacity{ (_zoneCapacity > 0) ? (_zoneCapacity) : (1) };
+    zoneCapacity.store(capacity);
+
+    //Buffers of the new size are allocated here rather than by each thread's first zone, which would stall it mid-capture
+    //The owners only swap them in once they see the new generation
+    (void)GetThreadBuffer();
+    {
+        std::lock_guard<std::mutex> lock{ threadsMutex };
+        for (const std::unique_ptr<ThreadBuffer>& buffer : threads)
+        {
+            buffer->nextZones = (buffer->capacity != capacity) ? (AllocateZones(capacity)) : (nullptr);
+            buffer->nextCapacity = capacity;
+        }
+    }
+
+    captureBegin = Now();
+    generation.fetch_add(1);
+    capturing.store(true);
+}
+
+void CpuProfiler::EndCapture()
+{
+    capturing.store(false);
+}
+
+bool CpuProfiler::WriteChromeTrace(const char* path)
+{
+    if (capturing.load())
+    {
+        std::cerr << "ERROR::CPU_PROFILER::WRITE_CHROME_TRACE::CAPTURE_STILL_RUNNING" << std::endl;
+        return false;
+    }
+
+    std::ofstream file{ path, std::ios::binary };
+    if (!file)
+    {
+        std::cerr << "ERROR::CPU_PROFILER::WRITE_CHROME_TRACE::FAILED_TO_OPEN_FILE" << std::endl;
+        return false;
+    }
+
+    //Complete ("X") events with microsecond timestamps relative to the start of the capture, one track per thread
+    //Fixed to the nanosecond - the default six significant digits would round everything after the first second to 10us
+    const UINT64 currentGeneration{ generation.load() };
+    bool first{ true };
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    std::lock_guard<std::mutex> lock{ threadsMutex };
+    for (const std::unique_ptr<ThreadBuffer>& buffer : threads)
+    {
+        if (buffer->generation.load(std::memory_order_acquire) != currentGeneration) { continue; }
+
+        if (!buffer->name.empty())
+        {
+            file << ((first) ? ("\n") : (",\n")) << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->threadId << ",\"args\":{\"name\":\"";
+            WriteEscaped(file, buffer->name.c_str());
+            file << "\"}}";
+            first = false;
+        }
+
+        const UINT count{ buffer->count.load(std::memory_order_acquire) };
+        for (UINT i{ 0 }; i < count; ++i)
+        {
+            const Zone& zone{ buffer->zones[i] };
+            file << ((first) ? ("\n") : (",\n")) << "{\"name\":\"";
+            WriteEscaped(file, zone.name);
+            file << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->threadId
+                 << ",\"ts\":" << static_cast<double>(zone.begin - captureBegin) / 1000.0
+                 << ",\"dur\":" << static_cast<double>(zone.end - zone.begin) / 1000.0 << "}";
+            first = false;
+        }
+    }
+    file << "\n]}\n";
+    return static_cast<bool>(file);
+}
+
+CpuProfilerCounters CpuProfiler::GetCounters()
+{
+    CpuProfilerCounters counters{};
+    const UINT64 currentGeneration{ generation.load() };
+    std::lock_guard<std::mutex> lock{ threadsMutex };
+    for (const std::unique_ptr<ThreadBuffer>& buffer : threads)
+    {
+        if (buffer->generation.load(std::memory_order_acquire) != currentGeneration) { continue; }
+        counters.zones += buffer->count.load(std::memory_order_acquire);
+        counters.droppedZones += buffer->dropped.load(std::memory_order_relaxed);
+        ++counters.threads;
+    }
+    return counters;
+}
+
+void CpuProfiler::SetThreadName(const char* name)
+{
+    ThreadBuffer* buffer{ GetThreadBuffer() };
+    std::lock_guard<std::mutex> lock{ threadsMutex };
+    buffer->name = name;
+}
+
+
+
+INT64 CpuProfiler::Now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+CpuProfiler::ThreadBuffer* CpuProfiler::GetThreadBuffer()
+{
+    if (threadBuffer) { return threadBuffer; }
+
+    //Buffers outlive their threads so a capture can still be exported after e.g. the job workers have exited
+    std::lock_guard<std::mutex> lock{ threadsMutex };
+    threads.push_back(std::make_unique<ThreadBuffer>());
+    threadBuffer = threads.back().get();
+    threadBuffer->capacity = zoneCapacity.load();
+    threadBuffer->zones = AllocateZones(threadBuffer->capacity);
+    threadBuffer->threadId = static_cast<UINT>(threads.size() - 1);
+    return threadBuffer;
+}
+
+std::unique_ptr<CpuProfiler::Zone[]> CpuProfiler::AllocateZones(UINT capacity)
+{
+    return std::unique_ptr<Zone[]>{ new Zone[capacity] };
+}
+
+void CpuProfiler::Record(const char* name, INT64 begin, INT64 end)
+{
+    //Zones still open when the capture ended are dropped
+    if (!capturing.load(std::memory_order_relaxed)) { return; }
+
+    ThreadBuffer* buffer{ GetThreadBuffer() };
+    const UINT64 currentGeneration{ generation.load(std::memory_order_acquire) };
+    if (buffer->generation.load(std::memory_order_relaxed) != currentGeneration)
+    {
+        //First zone this thread records in the capture - the buffer is only published once it has been reset
+        //The old buffer is kept in nextZones rather than freed here, and goes with the next BeginCapture()
+        if (buffer->nextZones)
+        {
+            std::swap(buffer->zones, buffer->nextZones);
+            buffer->capacity = buffer->nextCapacity;
+        }
+        buffer->count.store(0, std::memory_order_relaxed);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+        buffer->generation.store(currentGeneration, std::memory_order_release);
+    }
+
+    const UINT count{ buffer->count.load(std::memory_order_relaxed) };
+    if (count == buffer->capacity)
+    {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer->zones[count] = Zone{ name, begin, end };
+    buffer->count.store(count + 1, std::memory_order_release);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,121 @@
+﻿#pragma once
+#include <d3d11.h>
+
+//Scoped CPU zone profiler
+//PROFILE_ZONE("Name") and PROFILE_FUNCTION() time the rest of the enclosing scope while a capture is running, on any thread
+//Each thread appends its finished zones to a buffer only it writes to, so recording a zone never takes a lock - zones that
+//don't fit in the buffer are dropped (and counted) rather than growing it mid-capture
+//Buffers are allocated when a thread registers (by naming itself or starting a capture) and by BeginCapture(), so a thread's
+//first zone doesn't allocate unless the thread had never been seen before
+//A finished capture can be written out as Chrome trace event JSON, for chrome://tracing or ui.perfetto.dev
+//
+//Everything here compiles to nothing unless ENGINE_CPU_PROFILING is defined, so the macros can be left in hot paths
+
+
+#ifdef ENGINE_CPU_PROFILING
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+constexpr UINT CPU_PROFILER_DEFAULT_ZONES_PER_THREAD{ 1u << 18 };
+
+struct CpuProfilerCounters
+{
+    UINT64 zones;        //Zones recorded in the last capture
+    UINT64 droppedZones; //Zones that didn't fit in their thread's buffer
+    UINT threads;        //Threads that recorded zones
+};
+
+
+class CpuProfiler
+{
+    friend class CpuProfileZone;
+
+public:
+    //Discards the previous capture - zoneCapacity is per thread, at 24 bytes a zone
+    static void BeginCapture(UINT zoneCapacity=CPU_PROFILER_DEFAULT_ZONES_PER_THREAD);
+    static void EndCapture();
+    [[nodiscard]] static bool IsCapturing() { return capturing.load(std::memory_order_relaxed); }
+
+    //Must not be called while capturing
+    static bool WriteChromeTrace(const char* path);
+    [[nodiscard]] static CpuProfilerCounters GetCounters();
+
+    //Label for the calling thread's track in the trace (the name is copied)
+    static void SetThreadName(const char* name);
+
+private:
+    CpuProfiler() = default;
+    ~CpuProfiler() = default;
+
+    struct Zone
+    {
+        const char* name; //Zone names must outlive the capture (string literals, __FUNCTION__)
+        INT64 begin;      //Nanoseconds
+        INT64 end;
+    };
+
+    //Only its own thread writes to a buffer - a new capture is noticed through the generation and the buffer is reset by its owner,
+    //so the exporter only ever reads zones that have been published through count
+    struct ThreadBuffer
+    {
+        std::unique_ptr<Zone[]> zones;
+        UINT capacity;
+        std::unique_ptr<Zone[]> nextZones; //Set by BeginCapture() when the capacity changes, for the owner to swap in
+        UINT nextCapacity;
+        std::atomic<UINT> count;
+        std::atomic<UINT> dropped;
+        std::atomic<UINT64> generation;
+        UINT threadId;
+        std::string name;
+    };
+
+    [[nodiscard]] static INT64 Now();
+    [[nodiscard]] static ThreadBuffer* GetThreadBuffer();
+    //Left uninitialised - only the zones published through count are ever read
+    [[nodiscard]] static std::unique_ptr<Zone[]> AllocateZones(UINT capacity);
+    static void Record(const char* name, INT64 begin, INT64 end);
+
+    static std::atomic<bool> capturing;
+    static std::atomic<UINT64> generation;
+    static std::atomic<UINT> zoneCapacity;
+    static INT64 captureBegin;
+
+    static std::mutex threadsMutex; //Taken the first time each thread records, and by the exporter - never per zone
+    static std::vector<std::unique_ptr<ThreadBuffer>> threads;
+    static thread_local ThreadBuffer* threadBuffer;
+};
+
+
+class CpuProfileZone
+{
+public:
+    explicit CpuProfileZone(const char* _name) : name{ _name }, active{ CpuProfiler::IsCapturing() }, begin{ (active) ? (CpuProfiler::Now()) : (0) } {}
+    ~CpuProfileZone() { if (active) { CpuProfiler::Record(name, begin, CpuProfiler::Now()); } }
+
+    CpuProfileZone(const CpuProfileZone&) = delete;
+    CpuProfileZone& operator=(const CpuProfileZone&) = delete;
+
+private:
+    const char* name;
+    bool active;
+    INT64 begin;
+};
+
+
+#define PROFILE_CONCATENATE_INNER(a, b) a##b
+#define PROFILE_CONCATENATE(a, b) PROFILE_CONCATENATE_INNER(a, b)
+#define PROFILE_ZONE(name) const CpuProfileZone PROFILE_CONCATENATE(cpuProfileZone, __LINE__){ name }
+#define PROFILE_FUNCTION() PROFILE_ZONE(__FUNCTION__)
+#define PROFILE_THREAD_NAME(name) CpuProfiler::SetThreadName(name)
+
+#else
+
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#define PROFILE_THREAD_NAME(name) ((void)0)
+
+#endif
\ No newline at end of file
@@ -0,0 +1,115 @@
+﻿#include "DdsFormat.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+//Bytes per 4x4 block for block compressed formats, bytes per texel otherwise - 0 if the format isn't supported
+//Typeless formats aren't, as the file has to say how its texels are sampled
+static UINT GetDdsElementSize(DXGI_FORMAT format, bool& blockCompressed)
+{
+    blockCompressed = true;
+    switch (format)
+    {
+    case (DXGI_FORMAT_BC1_UNORM): case (DXGI_FORMAT_BC1_UNORM_SRGB): case (DXGI_FORMAT_BC4_UNORM): case (DXGI_FORMAT_BC4_SNORM):
+        return 8;
+    case (DXGI_FORMAT_BC2_UNORM): case (DXGI_FORMAT_BC2_UNORM_SRGB): case (DXGI_FORMAT_BC3_UNORM): case (DXGI_FORMAT_BC3_UNORM_SRGB):
+    case (DXGI_FORMAT_BC5_UNORM): case (DXGI_FORMAT_BC5_SNORM): case (DXGI_FORMAT_BC6H_UF16): case (DXGI_FORMAT_BC6H_SF16):
+    case (DXGI_FORMAT_BC7_UNORM): case (DXGI_FORMAT_BC7_UNORM_SRGB):
+        return 16;
+    case (DXGI_FORMAT_R8G8B8A8_UNORM): case (DXGI_FORMAT_R8G8B8A8_UNORM_SRGB): case (DXGI_FORMAT_B8G8R8A8_UNORM): case (DXGI_FORMAT_B8G8R8A8_UNORM_SRGB):
+        blockCompressed = false;
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+//Legacy headers name their format through a fourCC or channel masks
+static DXGI_FORMAT GetLegacyDdsFormat(const DdsPixelFormat& pf)
+{
+    if (pf.flags & DDS_PIXEL_FORMAT_FOURCC)
+    {
+        switch (pf.fourCC)
+        {
+        case (MakeDdsFourCC('D', 'X', 'T', '1')):
+            return DXGI_FORMAT_BC1_UNORM;
+        case (MakeDdsFourCC('D', 'X', 'T', '2')): case (MakeDdsFourCC('D', 'X', 'T', '3')):
+            return DXGI_FORMAT_BC2_UNORM;
+        case (MakeDdsFourCC('D', 'X', 'T', '4')): case (MakeDdsFourCC('D', 'X', 'T', '5')):
+            return DXGI_FORMAT_BC3_UNORM;
+        case (MakeDdsFourCC('A', 'T', 'I', '1')): case (MakeDdsFourCC('B', 'C', '4', 'U')):
+            return DXGI_FORMAT_BC4_UNORM;
+        case (MakeDdsFourCC('B', 'C', '4', 'S')):
+            return DXGI_FORMAT_BC4_SNORM;
+        case (MakeDdsFourCC('A', 'T', 'I', '2')): case (MakeDdsFourCC('B', 'C', '5', 'U')):
+            return DXGI_FORMAT_BC5_UNORM;
+        case (MakeDdsFourCC('B', 'C', '5', 'S')):
+            return DXGI_FORMAT_BC5_SNORM;
+        default:
+            return DXGI_FORMAT_UNKNOWN;
+        }
+    }
+    if ((pf.flags & DDS_PIXEL_FORMAT_RGB) && pf.rgbBitCount == 32)
+    {
+        if (pf.redBitMask == 0x000000FF && pf.greenBitMask == 0x0000FF00 && pf.blueBitMask == 0x00FF0000 && pf.alphaBitMask == 0xFF000000) { return DXGI_FORMAT_R8G8B8A8_UNORM; }
+        if (pf.redBitMask == 0x00FF0000 && pf.greenBitMask == 0x0000FF00 && pf.blueBitMask == 0x000000FF && pf.alphaBitMask == 0xFF000000) { return DXGI_FORMAT_B8G8R8A8_UNORM; }
+    }
+    return DXGI_FORMAT_UNKNOWN;
+}
+
+
+bool ParseDds(const BYTE* data, UINT64 size, DdsLayout& layout)
+{
+    layout = {};
+    UINT magic;
+    DdsHeader header;
+    if (!data || size < sizeof(magic) + sizeof(header)) { return false; }
+    //Copied out, since nothing guarantees the data suits the headers' alignment
+    std::memcpy(&magic, data, sizeof(magic));
+    std::memcpy(&header, data + sizeof(magic), sizeof(header));
+    if (magic != DDS_FILE_MAGIC || header.size != sizeof(DdsHeader) || header.pixelFormat.size != sizeof(DdsPixelFormat)) { return false; }
+    if ((header.flags & DDS_HEADER_FLAGS_VOLUME) || (header.caps2 & DDS_CAPS2_CUBEMAP)) { return false; }
+
+    UINT64 offset{ sizeof(magic) + sizeof(header) };
+    DXGI_FORMAT format;
+    if ((header.pixelFormat.flags & DDS_PIXEL_FORMAT_FOURCC) && header.pixelFormat.fourCC == MakeDdsFourCC('D', 'X', '1', '0'))
+    {
+        DdsHeaderDxt10 dxt10;
+        if (size < offset + sizeof(dxt10)) { return false; }
+        std::memcpy(&dxt10, data + offset, sizeof(dxt10));
+        offset += sizeof(dxt10);
+        if (dxt10.resourceDimension != D3D11_RESOURCE_DIMENSION_TEXTURE2D || dxt10.arraySize != 1 || (dxt10.miscFlag & D3D11_RESOURCE_MISC_TEXTURECUBE)) { return false; }
+        format = static_cast<DXGI_FORMAT>(dxt10.dxgiFormat);
+    }
+    else
+    {
+        format = GetLegacyDdsFormat(header.pixelFormat);
+    }
+
+    bool blockCompressed;
+    const UINT elementSize{ GetDdsElementSize(format, blockCompressed) };
+    const UINT mipCount{ (std::max)(header.mipMapCount, 1u) };
+    if (elementSize == 0 || header.width == 0 || header.height == 0 || mipCount > DDS_MAX_MIPS) { return false; }
+    //A chain can't go on past 1x1
+    if (mipCount > 1 && ((std::max)(header.width, header.height) >> (mipCount - 1)) == 0) { return false; }
+
+    layout.format = format;
+    layout.width = header.width;
+    layout.height = header.height;
+    layout.mipCount = mipCount;
+    layout.blockCompressed = blockCompressed;
+    for (UINT i{ 0 }; i < mipCount; ++i)
+    {
+        DdsMip& mip{ layout.mips[i] };
+        mip.width = (std::max)(header.width >> i, 1u);
+        mip.height = (std::max)(header.height >> i, 1u);
+        const UINT columns{ (blockCompressed) ? ((mip.width + 3) / 4) : (mip.width) };
+        const UINT rows{ (blockCompressed) ? ((mip.height + 3) / 4) : (mip.height) };
+        mip.rowPitch = columns * elementSize;
+        mip.offset = offset;
+        mip.size = static_cast<UINT64>(mip.rowPitch) * rows;
+        offset += mip.size;
+    }
+    return offset <= size;
+}
\ No newline at end of file
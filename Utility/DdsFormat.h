@@ -0,0 +1,87 @@
+﻿#pragma once
+#include <d3d11.h>
+
+//DirectDraw Surface container, as written by texconv and most texture tools
+//
+//File layout: DDS_FILE_MAGIC, DdsHeader, an optional DdsHeaderDxt10 (when the pixel format's fourCC is "DX10"), then every mip
+//of every array slice, finest first, tightly packed - block compressed mips are stored as rows of 4x4 blocks
+//
+//Only what the texture streamer (see TextureStreamer.h) loads is accepted: single 2D textures (no arrays, cubemaps or volumes)
+//in a typed BC1-BC7 format, or in 8-bit RGBA/BGRA
+
+
+constexpr UINT DDS_FILE_MAGIC{ 0x20534444 }; //"DDS "
+constexpr UINT DDS_MAX_MIPS{ 16 };
+
+constexpr UINT DDS_PIXEL_FORMAT_FOURCC{ 0x4 };
+constexpr UINT DDS_PIXEL_FORMAT_RGB{ 0x40 };
+constexpr UINT DDS_HEADER_FLAGS_VOLUME{ 0x800000 };
+constexpr UINT DDS_CAPS2_CUBEMAP{ 0x200 };
+
+constexpr UINT MakeDdsFourCC(char a, char b, char c, char d)
+{
+    return static_cast<UINT>(static_cast<BYTE>(a)) | (static_cast<UINT>(static_cast<BYTE>(b)) << 8) | (static_cast<UINT>(static_cast<BYTE>(c)) << 16) | (static_cast<UINT>(static_cast<BYTE>(d)) << 24);
+}
+
+struct DdsPixelFormat
+{
+    UINT size;
+    UINT flags;         //DDS_PIXEL_FORMAT flags
+    UINT fourCC;
+    UINT rgbBitCount;
+    UINT redBitMask;
+    UINT greenBitMask;
+    UINT blueBitMask;
+    UINT alphaBitMask;
+};
+
+struct DdsHeader
+{
+    UINT size;
+    UINT flags;
+    UINT height;
+    UINT width;
+    UINT pitchOrLinearSize;
+    UINT depth;
+    UINT mipMapCount;   //0 or 1 for a single mip
+    UINT reserved1[11];
+    DdsPixelFormat pixelFormat;
+    UINT caps;
+    UINT caps2;
+    UINT caps3;
+    UINT caps4;
+    UINT reserved2;
+};
+
+struct DdsHeaderDxt10
+{
+    UINT dxgiFormat;
+    UINT resourceDimension; //D3D11_RESOURCE_DIMENSION
+    UINT miscFlag;
+    UINT arraySize;
+    UINT miscFlags2;
+};
+
+struct DdsMip
+{
+    UINT64 offset;  //Bytes from the start of the file
+    UINT64 size;    //Bytes
+    UINT width;
+    UINT height;
+    UINT rowPitch;  //Bytes per row of texels, or of 4x4 blocks
+};
+
+//Where every mip of a parsed file lives, ready for UpdateSubresource()
+struct DdsLayout
+{
+    DXGI_FORMAT format;
+    UINT width;
+    UINT height;
+    UINT mipCount;
+    bool blockCompressed;
+    DdsMip mips[DDS_MAX_MIPS];
+};
+
+
+//False if the file is malformed, truncated or of a kind listed above as unsupported
+[[nodiscard]] bool ParseDds(const BYTE* data, UINT64 size, DdsLayout& layout);
\ No newline at end of file
@@ -0,0 +1,34 @@
+﻿#pragma once
+#include <d3d11.h>
+
+//Bits per texel - for block compressed formats, the average over a 4x4 block
+//Used for memory estimates, so formats not listed are counted as 32 bits
+inline UINT GetBitsPerPixel(DXGI_FORMAT format)
+{
+    switch (format)
+    {
+    case (DXGI_FORMAT_R32G32B32A32_TYPELESS): case (DXGI_FORMAT_R32G32B32A32_FLOAT): case (DXGI_FORMAT_R32G32B32A32_UINT): case (DXGI_FORMAT_R32G32B32A32_SINT):
+        return 128;
+    case (DXGI_FORMAT_R32G32B32_TYPELESS): case (DXGI_FORMAT_R32G32B32_FLOAT): case (DXGI_FORMAT_R32G32B32_UINT): case (DXGI_FORMAT_R32G32B32_SINT):
+        return 96;
+    case (DXGI_FORMAT_R16G16B16A16_TYPELESS): case (DXGI_FORMAT_R16G16B16A16_FLOAT): case (DXGI_FORMAT_R16G16B16A16_UNORM): case (DXGI_FORMAT_R16G16B16A16_UINT):
+    case (DXGI_FORMAT_R16G16B16A16_SNORM): case (DXGI_FORMAT_R16G16B16A16_SINT): case (DXGI_FORMAT_R32G32_TYPELESS): case (DXGI_FORMAT_R32G32_FLOAT):
+    case (DXGI_FORMAT_R32G32_UINT): case (DXGI_FORMAT_R32G32_SINT): case (DXGI_FORMAT_R32G8X24_TYPELESS): case (DXGI_FORMAT_D32_FLOAT_S8X24_UINT):
+        return 64;
+    case (DXGI_FORMAT_R16_TYPELESS): case (DXGI_FORMAT_R16_FLOAT): case (DXGI_FORMAT_R16_UNORM): case (DXGI_FORMAT_R16_UINT): case (DXGI_FORMAT_R16_SNORM):
+    case (DXGI_FORMAT_R16_SINT): case (DXGI_FORMAT_D16_UNORM): case (DXGI_FORMAT_R8G8_TYPELESS): case (DXGI_FORMAT_R8G8_UNORM): case (DXGI_FORMAT_R8G8_UINT):
+    case (DXGI_FORMAT_R8G8_SNORM): case (DXGI_FORMAT_R8G8_SINT): case (DXGI_FORMAT_B5G6R5_UNORM): case (DXGI_FORMAT_B5G5R5A1_UNORM):
+        return 16;
+    case (DXGI_FORMAT_R8_TYPELESS): case (DXGI_FORMAT_R8_UNORM): case (DXGI_FORMAT_R8_UINT): case (DXGI_FORMAT_R8_SNORM): case (DXGI_FORMAT_R8_SINT):
+    case (DXGI_FORMAT_A8_UNORM): case (DXGI_FORMAT_BC2_TYPELESS): case (DXGI_FORMAT_BC2_UNORM): case (DXGI_FORMAT_BC2_UNORM_SRGB):
+    case (DXGI_FORMAT_BC3_TYPELESS): case (DXGI_FORMAT_BC3_UNORM): case (DXGI_FORMAT_BC3_UNORM_SRGB): case (DXGI_FORMAT_BC5_TYPELESS):
+    case (DXGI_FORMAT_BC5_UNORM): case (DXGI_FORMAT_BC5_SNORM): case (DXGI_FORMAT_BC6H_TYPELESS): case (DXGI_FORMAT_BC6H_UF16):
+    case (DXGI_FORMAT_BC6H_SF16): case (DXGI_FORMAT_BC7_TYPELESS): case (DXGI_FORMAT_BC7_UNORM): case (DXGI_FORMAT_BC7_UNORM_SRGB):
+        return 8;
+    case (DXGI_FORMAT_BC1_TYPELESS): case (DXGI_FORMAT_BC1_UNORM): case (DXGI_FORMAT_BC1_UNORM_SRGB): case (DXGI_FORMAT_BC4_TYPELESS):
+    case (DXGI_FORMAT_BC4_UNORM): case (DXGI_FORMAT_BC4_SNORM):
+        return 4;
+    default:
+        return 32;
+    }
+}
\ No newline at end of file
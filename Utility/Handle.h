@@ -0,0 +1,174 @@
+﻿#pragma once
+#include <d3d11.h>
+#include <vector>
+
+//32-bit generational handle to an object of type T stored in a HandlePool
+//The low 20 bits index the pool's slot array, the high 12 bits hold the slot's generation at the time the handle was issued
+//Freeing a slot bumps its generation, so any handle still referring to the old object is detected as stale rather than aliasing the slot's next occupant
+//A value of 0 is never issued and represents the null handle
+
+constexpr UINT32 HANDLE_INDEX_BITS{ 20 };
+constexpr UINT32 HANDLE_GENERATION_BITS{ 12 };
+constexpr UINT32 HANDLE_INDEX_MASK{ (1u << HANDLE_INDEX_BITS) - 1 };
+constexpr UINT32 HANDLE_GENERATION_MASK{ (1u << HANDLE_GENERATION_BITS) - 1 };
+constexpr UINT32 HANDLE_MAX_SLOTS{ 1u << HANDLE_INDEX_BITS };
+
+
+template<typename Base>
+class HandlePool;
+
+template<typename T>
+class Handle;
+
+//Reinterprets a handle as one to a related type in the same pool (e.g. ID3D11RenderTargetView and ID3D11View)
+//The caller vouches that the object behind it really is a To
+template<typename To, typename From>
+[[nodiscard]] constexpr Handle<To> HandleCast(Handle<From> handle);
+
+template<typename T>
+class Handle
+{
+    template<typename Base>
+    friend class HandlePool;
+    template<typename To, typename From>
+    friend constexpr Handle<To> HandleCast(Handle<From> handle);
+
+public:
+    constexpr Handle() = default;
+
+    [[nodiscard]] constexpr bool IsNull() const { return value == 0; }
+    [[nodiscard]] constexpr UINT32 GetValue() const { return value; }
+    [[nodiscard]] constexpr UINT32 GetIndex() const { return value & HANDLE_INDEX_MASK; }
+    [[nodiscard]] constexpr UINT32 GetGeneration() const { return value >> HANDLE_INDEX_BITS; }
+
+    constexpr bool operator==(const Handle& other) const { return value == other.value; }
+    constexpr bool operator!=(const Handle& other) const { return value != other.value; }
+
+private:
+    constexpr Handle(UINT32 index, UINT32 generation) : value{ (generation << HANDLE_INDEX_BITS) | index } {}
+
+    UINT32 value{ 0 };
+};
+
+template<typename To, typename From>
+constexpr Handle<To> HandleCast(Handle<From> handle)
+{
+    Handle<To> cast;
+    cast.value = handle.value;
+    return cast;
+}
+
+
+//Slot array backing a family of handles
+//Objects are stored as Base* (e.g. ID3D11Resource*) and handed out through handles typed on the derived interface (e.g. ID3D11Buffer),
+//so one pool serves every resource type while a buffer handle still can't be passed where a texture handle is expected
+//Allocation, lookup and freeing are all O(1) - freed slots go on a free list and are reused by later allocations
+template<typename Base>
+class HandlePool
+{
+public:
+    HandlePool() = default;
+    ~HandlePool() = default;
+
+    //Returns the null handle if every slot is in use
+    //The object may be null, for a handle whose object is filled in later with Replace()
+    template<typename T>
+    [[nodiscard]] Handle<T> Allocate(T* object)
+    {
+        UINT32 index;
+        if (!freeList.empty())
+        {
+            index = freeList.back();
+            freeList.pop_back();
+        }
+        else
+        {
+            if (slots.size() >= HANDLE_MAX_SLOTS) { return {}; }
+            index = static_cast<UINT32>(slots.size());
+            slots.push_back(Slot{ nullptr, 1 });
+        }
+        slots[index].object = object;
+        ++liveCount;
+        return Handle<T>{ index, slots[index].generation };
+    }
+
+    //Returns nullptr for null and stale handles
+    template<typename T>
+    [[nodiscard]] T* Get(Handle<T> handle) const
+    {
+        if (!IsLive(handle)) { return nullptr; }
+        return static_cast<T*>(slots[handle.GetIndex()].object);
+    }
+
+    //Swaps the object behind a live handle, returning the previous one - the handle and its copies stay valid
+    template<typename T>
+    Base* Replace(Handle<T> handle, T* object)
+    {
+        if (!IsLive(handle)) { return nullptr; }
+        Slot& slot{ slots[handle.GetIndex()] };
+        Base* previous{ slot.object };
+        slot.object = object;
+        return previous;
+    }
+
+    //Empties the slot and returns the object it held so the caller can release it, or nullptr for null and stale handles
+    template<typename T>
+    Base* Free(Handle<T> handle)
+    {
+        if (!IsLive(handle)) { return nullptr; }
+
+        Slot& slot{ slots[handle.GetIndex()] };
+        Base* object{ slot.object };
+        slot.object = nullptr;
+        //Generation 0 is skipped so a live handle can never have the value 0
+        slot.generation = (slot.generation >= HANDLE_GENERATION_MASK) ? (1) : (slot.generation + 1);
+        freeList.push_back(handle.GetIndex());
+        --liveCount;
+        return object;
+    }
+
+    //Calls function(Base*) for every live object
+    template<typename Function>
+    void ForEach(Function function) const
+    {
+        for (const Slot& slot : slots)
+        {
+            if (slot.object) { function(slot.object); }
+        }
+    }
+
+    //Forgets every object (without releasing them) and invalidates all outstanding handles
+    void Clear()
+    {
+        freeList.clear();
+        for (UINT32 i{ static_cast<UINT32>(slots.size()) }; i-- > 0;)
+        {
+            Slot& slot{ slots[i] };
+            slot.object = nullptr;
+            slot.generation = (slot.generation >= HANDLE_GENERATION_MASK) ? (1) : (slot.generation + 1);
+            freeList.push_back(i);
+        }
+        liveCount = 0;
+    }
+
+    [[nodiscard]] size_t GetLiveCount() const { return liveCount; }
+
+private:
+    struct Slot
+    {
+        Base* object;
+        UINT32 generation;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<UINT32> freeList;
+    size_t liveCount{ 0 };
+
+
+    template<typename T>
+    [[nodiscard]] bool IsLive(Handle<T> handle) const
+    {
+        const UINT32 index{ handle.GetIndex() };
+        return !handle.IsNull() && index < slots.size() && slots[index].generation == handle.GetGeneration();
+    }
+};
\ No newline at end of file
@@ -0,0 +1,17 @@
+﻿#pragma once
+#include <d3d11.h>
+
+constexpr UINT64 HASH_BYTES_SEED{ 14695981039346656037ull };
+
+//FNV-1a over raw bytes - for keys built from zero-initialised plain structs (e.g. D3D11 descriptions), so padding never varies
+//Passing the previous result as the seed hashes several buffers as if they were one
+[[nodiscard]] inline UINT64 HashBytes(const void* data, size_t size, UINT64 seed=HASH_BYTES_SEED)
+{
+    const unsigned char* bytes{ static_cast<const unsigned char*>(data) };
+    UINT64 hash{ seed };
+    for (size_t i{ 0 }; i < size; ++i)
+    {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
\ No newline at end of file
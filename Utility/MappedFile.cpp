@@ -0,0 +1,88 @@
+﻿#include "MappedFile.h"
+
+#include <iostream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+bool MappedFile::Open(const std::filesystem::path& path)
+{
+    Close();
+
+#ifdef _WIN32
+    //Sequential scan lets the cache manager read ahead of the device's copy
+    file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        std::cerr << "ERROR::MAPPED_FILE::OPEN::FAILED_TO_OPEN_FILE" << std::endl;
+        return false;
+    }
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0)
+    {
+        std::cerr << "ERROR::MAPPED_FILE::OPEN::FILE_IS_EMPTY_OR_UNREADABLE" << std::endl;
+        Close();
+        return false;
+    }
+    mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == NULL)
+    {
+        std::cerr << "ERROR::MAPPED_FILE::OPEN::FAILED_TO_CREATE_FILE_MAPPING" << std::endl;
+        Close();
+        return false;
+    }
+    data = static_cast<const BYTE*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!data)
+    {
+        std::cerr << "ERROR::MAPPED_FILE::OPEN::FAILED_TO_MAP_VIEW_OF_FILE" << std::endl;
+        Close();
+        return false;
+    }
+    size = static_cast<UINT64>(fileSize.QuadPart);
+#else
+    const int descriptor{ open(path.c_str(), O_RDONLY) };
+    if (descriptor < 0)
+    {
+        std::cerr << "ERROR::MAPPED_FILE::OPEN::FAILED_TO_OPEN_FILE" << std::endl;
+        return false;
+    }
+    struct stat status{};
+    if (fstat(descriptor, &status) != 0 || status.st_size <= 0)
+    {
+        std::cerr << "ERROR::MAPPED_FILE::OPEN::FILE_IS_EMPTY_OR_UNREADABLE" << std::endl;
+        close(descriptor);
+        return false;
+    }
+    void* const view{ mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0) };
+    //The mapping keeps the file referenced on its own
+    close(descriptor);
+    if (view == MAP_FAILED)
+    {
+        std::cerr << "ERROR::MAPPED_FILE::OPEN::FAILED_TO_MAP_FILE" << std::endl;
+        return false;
+    }
+    data = static_cast<const BYTE*>(view);
+    size = static_cast<UINT64>(status.st_size);
+#endif
+    return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+    if (data) { UnmapViewOfFile(data); }
+    if (mapping != NULL) { CloseHandle(mapping); }
+    if (file != INVALID_HANDLE_VALUE) { CloseHandle(file); }
+    mapping = NULL;
+    file = INVALID_HANDLE_VALUE;
+#else
+    if (data) { munmap(const_cast<BYTE*>(data), static_cast<size_t>(size)); }
+#endif
+    data = nullptr;
+    size = 0;
+}
\ No newline at end of file
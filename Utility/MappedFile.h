@@ -0,0 +1,36 @@
+﻿#pragma once
+#include <d3d11.h>
+#include <filesystem>
+
+//Read-only view of a whole file through the OS's memory mapping, so its contents can be handed to the device (e.g. as
+//D3D11_SUBRESOURCE_DATA) straight from the page cache without being read into an intermediate buffer
+//The view is page aligned, so data the file lays out at aligned offsets stays aligned in memory
+//
+//Not thread safe
+
+
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    //Closes any file already open - empty files can't be mapped and fail to open
+    bool Open(const std::filesystem::path& path);
+    void Close();
+
+    [[nodiscard]] bool IsOpen() const { return data != nullptr; }
+    [[nodiscard]] const BYTE* GetData() const { return data; }
+    [[nodiscard]] UINT64 GetSize() const { return size; }
+
+private:
+    const BYTE* data{ nullptr };
+    UINT64 size{ 0 };
+#ifdef _WIN32
+    HANDLE file{ INVALID_HANDLE_VALUE };
+    HANDLE mapping{ NULL };
+#endif
+};
\ No newline at end of file
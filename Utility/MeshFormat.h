@@ -0,0 +1,85 @@
+﻿#pragma once
+#include <d3d11.h>
+
+//Binary mesh container, written offline by Tools/MeshConverter and memory-mapped at load (see ResourceManager::LoadMesh())
+//
+//File layout: MeshFileHeader, then the streams it points at, each starting at a multiple of MESH_FILE_ALIGNMENT bytes
+//  vertices         - vertexCount * vertexStride bytes, interleaved in MESH_VERTEX_ATTRIBUTE order
+//  indices          - indexCount 16 or 32-bit indices, relative to the base vertex of their LOD
+//  meshlets         - meshletCount MeshFileMeshlet
+//  meshletVertices  - UINT vertex indices, relative to the base vertex of their LOD
+//  meshletTriangles - one UINT per triangle, three 8-bit indices into the meshlet's vertices
+//Every LOD has its own range of each stream, so a LOD can be drawn (or culled meshlet by meshlet) on its own
+//
+//The streams are laid out exactly as the GPU buffers want them, so loading never touches the data
+
+
+constexpr UINT MESH_FILE_MAGIC{ 0x4853454D }; //"MESH"
+constexpr UINT MESH_FILE_VERSION{ 1 };         //Bump whenever the layout changes - older files then fail to load
+constexpr UINT MESH_FILE_ALIGNMENT{ 16 };
+constexpr UINT MESH_MAX_LODS{ 8 };
+constexpr UINT MESHLET_MAX_VERTICES{ 64 };
+constexpr UINT MESHLET_MAX_TRIANGLES{ 124 };
+
+enum MESH_VERTEX_ATTRIBUTE : UINT
+{
+    MESH_VERTEX_POSITION = 1 << 0, //float3
+    MESH_VERTEX_NORMAL   = 1 << 1, //float3
+    MESH_VERTEX_TEXCOORD = 1 << 2, //float2
+};
+
+struct MeshFileStream
+{
+    UINT64 offset; //Bytes from the start of the file
+    UINT64 size;   //Bytes
+};
+
+struct MeshFileLod
+{
+    UINT startIndex;
+    UINT indexCount;
+    INT baseVertexLocation;
+    UINT vertexCount;
+    UINT startMeshlet;
+    UINT meshletCount;
+};
+
+struct MeshFileMeshlet
+{
+    UINT vertexOffset;   //Into meshletVertices
+    UINT vertexCount;
+    UINT triangleOffset; //Into meshletTriangles
+    UINT triangleCount;
+    float boundsCentre[3];
+    float boundsRadius;
+};
+
+struct MeshFileHeader
+{
+    UINT magic;
+    UINT version;
+    UINT vertexAttributes; //MESH_VERTEX_ATTRIBUTE flags
+    UINT vertexStride;
+    UINT vertexCount;
+    UINT indexCount;
+    UINT indexFormat;      //DXGI_FORMAT_R16_UINT or DXGI_FORMAT_R32_UINT
+    UINT meshletCount;
+    UINT meshletVertexCount;
+    UINT meshletTriangleCount;
+    UINT lodCount;         //LOD 0 is the most detailed
+    UINT padding;
+
+    //Object space bounds over every LOD
+    float boundsMin[3];
+    float boundsMax[3];
+    float boundsCentre[3];
+    float boundsRadius;
+
+    MeshFileLod lods[MESH_MAX_LODS];
+
+    MeshFileStream vertices;
+    MeshFileStream indices;
+    MeshFileStream meshlets;
+    MeshFileStream meshletVertices;
+    MeshFileStream meshletTriangles;
+};
\ No newline at end of file
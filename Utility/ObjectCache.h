@@ -0,0 +1,92 @@
+﻿#pragma once
+#include <d3d11.h>
+#include <unordered_map>
+
+#include "Handle.h"
+
+//Live objects keyed by everything that went into creating them, so identical creation requests share one object
+//Each request takes a reference on the shared handle, and the object is only freed once every one of them has been released
+//Key must be a plain struct with operator== and Hash()
+//
+//Not thread safe - the ResourceManager only uses it from the main thread
+
+
+struct ObjectCacheStatistics
+{
+    UINT64 hits;   //Requests served by an existing object
+    UINT64 misses; //Requests that had to create an object
+    UINT objects;  //Live cached objects
+};
+
+
+template<typename Key, typename Base>
+class ObjectCache
+{
+public:
+    ObjectCache() = default;
+    ~ObjectCache() = default;
+
+    ObjectCache(const ObjectCache&) = delete;
+    ObjectCache& operator=(const ObjectCache&) = delete;
+
+    //Handle of the live object matching the key with another reference taken on it, or the null handle (counted as a miss)
+    [[nodiscard]] Handle<Base> Acquire(const Key& key)
+    {
+        const auto entry{ entries.find(key) };
+        if (entry == entries.end())
+        {
+            ++misses;
+            return {};
+        }
+        ++entry->second.references;
+        ++hits;
+        return entry->second.handle;
+    }
+
+    //Shares a newly created object, holding its creator's reference
+    void Add(const Key& key, Handle<Base> handle, Base* object)
+    {
+        entries.emplace(key, Entry{ handle, 1 });
+        keys.emplace(object, key);
+    }
+
+    //Drops a reference - returns true once the last one has gone (or the object was never cached), when the object should be freed
+    [[nodiscard]] bool Release(Base* object)
+    {
+        const auto key{ keys.find(object) };
+        if (key == keys.end()) { return true; }
+
+        const auto entry{ entries.find(key->second) };
+        if (--entry->second.references > 0) { return false; }
+        entries.erase(entry);
+        keys.erase(key);
+        return true;
+    }
+
+    //Forgets every object, without releasing them
+    void Clear()
+    {
+        entries.clear();
+        keys.clear();
+    }
+
+    [[nodiscard]] ObjectCacheStatistics GetStatistics() const { return ObjectCacheStatistics{ hits, misses, static_cast<UINT>(entries.size()) }; }
+
+private:
+    struct Entry
+    {
+        Handle<Base> handle;
+        UINT references;
+    };
+
+    struct KeyHash
+    {
+        [[nodiscard]] size_t operator()(const Key& key) const { return key.Hash(); }
+    };
+
+    std::unordered_map<Key, Entry, KeyHash> entries;
+    std::unordered_map<Base*, Key> keys; //Reverse lookup for Release()
+
+    UINT64 hits{ 0 };
+    UINT64 misses{ 0 };
+};
\ No newline at end of file
@@ -0,0 +1,183 @@
+﻿#include "ResourcePool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#include "Format.h"
+#include "Hash.h"
+
+
+//-----------------------------------------------//
+//----------------------KEY----------------------//
+//-----------------------------------------------//
+ResourcePoolKey ResourcePoolKey::Make(const D3D11_BUFFER_DESC& desc)
+{
+    ResourcePoolKey key;
+    std::memset(&key, 0, sizeof(key));
+    key.type = RESOURCE_POOL_BUFFER;
+    key.buffer = desc;
+    return key;
+}
+
+ResourcePoolKey ResourcePoolKey::Make(const D3D11_TEXTURE1D_DESC& desc)
+{
+    ResourcePoolKey key;
+    std::memset(&key, 0, sizeof(key));
+    key.type = RESOURCE_POOL_TEXTURE_1D;
+    key.texture1D = desc;
+    return key;
+}
+
+ResourcePoolKey ResourcePoolKey::Make(const D3D11_TEXTURE2D_DESC& desc)
+{
+    ResourcePoolKey key;
+    std::memset(&key, 0, sizeof(key));
+    key.type = RESOURCE_POOL_TEXTURE_2D;
+    key.texture2D = desc;
+    return key;
+}
+
+ResourcePoolKey ResourcePoolKey::Make(const D3D11_TEXTURE3D_DESC& desc)
+{
+    ResourcePoolKey key;
+    std::memset(&key, 0, sizeof(key));
+    key.type = RESOURCE_POOL_TEXTURE_3D;
+    key.texture3D = desc;
+    return key;
+}
+
+bool ResourcePoolKey::operator==(const ResourcePoolKey& other) const
+{
+    return std::memcmp(this, &other, sizeof(ResourcePoolKey)) == 0;
+}
+
+size_t ResourcePoolKey::Hash() const
+{
+    return static_cast<size_t>(HashBytes(this, sizeof(ResourcePoolKey)));
+}
+
+UINT64 ResourcePoolKey::GetSize() const
+{
+    UINT width, height, depth, mipLevels, arraySize;
+    DXGI_FORMAT format;
+    switch (type)
+    {
+    case (RESOURCE_POOL_BUFFER):
+        return buffer.ByteWidth;
+    case (RESOURCE_POOL_TEXTURE_1D):
+        width = texture1D.Width; height = 1; depth = 1;
+        mipLevels = texture1D.MipLevels; arraySize = texture1D.ArraySize; format = texture1D.Format;
+        break;
+    case (RESOURCE_POOL_TEXTURE_2D):
+        width = texture2D.Width; height = texture2D.Height; depth = 1;
+        mipLevels = texture2D.MipLevels; arraySize = texture2D.ArraySize * (std::max)(texture2D.SampleDesc.Count, 1u); format = texture2D.Format;
+        break;
+    default:
+        width = texture3D.Width; height = texture3D.Height; depth = texture3D.Depth;
+        mipLevels = texture3D.MipLevels; arraySize = 1; format = texture3D.Format;
+        break;
+    }
+
+    //0 mip levels asks for the full chain
+    if (mipLevels == 0)
+    {
+        const UINT largest{ (std::max)({ width, height, depth, 1u }) };
+        mipLevels = 1;
+        while ((largest >> mipLevels) > 0) { ++mipLevels; }
+    }
+
+    UINT64 texels{ 0 };
+    for (UINT mip{ 0 }; mip < mipLevels; ++mip)
+    {
+        texels += static_cast<UINT64>((std::max)(width >> mip, 1u)) * (std::max)(height >> mip, 1u) * (std::max)(depth >> mip, 1u);
+    }
+    return texels * arraySize * GetBitsPerPixel(format) / 8;
+}
+//-----------------------------------------------//
+//------------------END OF KEY-------------------//
+//-----------------------------------------------//
+
+
+
+void ResourcePool::Initialise(GraphicsDevice* _device, UINT64 _budget)
+{
+    device = _device;
+    budget = _budget;
+}
+
+void ResourcePool::Shutdown()
+{
+    Trim(0);
+    device = nullptr;
+}
+
+void ResourcePool::SetBudget(UINT64 _budget)
+{
+    budget = _budget;
+    Trim(budget);
+}
+
+void ResourcePool::Trim(UINT64 targetBytes)
+{
+    while (bytes > targetBytes && !entries.empty())
+    {
+        const EntryList::iterator oldest{ std::prev(entries.end()) };
+        device->ReleaseObject(oldest->resource);
+        Remove(oldest);
+        ++evictions;
+    }
+}
+
+ID3D11Resource* ResourcePool::Acquire(const ResourcePoolKey& key)
+{
+    const size_t hash{ key.Hash() };
+    const auto [first, last] { lookup.equal_range(hash) };
+    for (auto it{ first }; it != last; ++it)
+    {
+        if (it->second->key == key)
+        {
+            ID3D11Resource* resource{ it->second->resource };
+            Remove(it->second);
+            ++hits;
+            return resource;
+        }
+    }
+    ++misses;
+    return nullptr;
+}
+
+void ResourcePool::Add(const ResourcePoolKey& key, ID3D11Resource* resource)
+{
+    const UINT64 size{ key.GetSize() };
+    if (size > budget)
+    {
+        device->ReleaseObject(resource);
+        return;
+    }
+
+    entries.push_front(Entry{ key, key.Hash(), size, resource });
+    lookup.emplace(entries.front().hash, entries.begin());
+    bytes += size;
+    Trim(budget);
+}
+
+ResourcePoolStatistics ResourcePool::GetStatistics() const
+{
+    return ResourcePoolStatistics{ hits, misses, evictions, static_cast<UINT>(entries.size()), bytes, budget };
+}
+
+void ResourcePool::Remove(EntryList::iterator entry)
+{
+    const auto [first, last] { lookup.equal_range(entry->hash) };
+    for (auto it{ first }; it != last; ++it)
+    {
+        if (it->second == entry)
+        {
+            lookup.erase(it);
+            break;
+        }
+    }
+    bytes -= entry->size;
+    entries.erase(entry);
+}
\ No newline at end of file
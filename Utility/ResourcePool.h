@@ -0,0 +1,109 @@
+﻿#pragma once
+#include <d3d11.h>
+#include <list>
+#include <unordered_map>
+
+#include "../Backends/GraphicsDevice.h"
+
+//Released resources kept for reuse, keyed by their full creation descriptor
+//A resource is only handed back out for a request with an identical descriptor, so it is interchangeable with a newly created one
+//apart from its contents, which are undefined
+//Pooled resources count against a byte budget (estimated from the descriptor) - the least recently released are destroyed once it is exceeded
+//
+//Not thread safe - the ResourceManager only uses it from the main thread
+
+
+constexpr UINT64 RESOURCE_POOL_DEFAULT_BUDGET{ 256ull * 1024 * 1024 };
+
+enum RESOURCE_POOL_TYPE
+{
+    RESOURCE_POOL_BUFFER,
+    RESOURCE_POOL_TEXTURE_1D,
+    RESOURCE_POOL_TEXTURE_2D,
+    RESOURCE_POOL_TEXTURE_3D,
+};
+
+struct ResourcePoolKey
+{
+    RESOURCE_POOL_TYPE type;
+    union
+    {
+        D3D11_BUFFER_DESC buffer;
+        D3D11_TEXTURE1D_DESC texture1D;
+        D3D11_TEXTURE2D_DESC texture2D;
+        D3D11_TEXTURE3D_DESC texture3D;
+    };
+
+    //Keys are compared bytewise, so every byte past the end of the smaller descriptors is zeroed
+    [[nodiscard]] static ResourcePoolKey Make(const D3D11_BUFFER_DESC& desc);
+    [[nodiscard]] static ResourcePoolKey Make(const D3D11_TEXTURE1D_DESC& desc);
+    [[nodiscard]] static ResourcePoolKey Make(const D3D11_TEXTURE2D_DESC& desc);
+    [[nodiscard]] static ResourcePoolKey Make(const D3D11_TEXTURE3D_DESC& desc);
+
+    [[nodiscard]] bool operator==(const ResourcePoolKey& other) const;
+    [[nodiscard]] size_t Hash() const;
+    //Estimated bytes of video memory, including every mip and array slice
+    [[nodiscard]] UINT64 GetSize() const;
+};
+
+struct ResourcePoolStatistics
+{
+    UINT64 hits;      //Requests served by a pooled resource
+    UINT64 misses;    //Requests that had to create a resource
+    UINT64 evictions; //Pooled resources destroyed to stay within the budget
+    UINT resources;   //Currently pooled
+    UINT64 bytes;     //Estimated size of the pooled resources
+    UINT64 budget;
+};
+
+
+class ResourcePool
+{
+public:
+    ResourcePool() = default;
+    ~ResourcePool() = default;
+
+    ResourcePool(const ResourcePool&) = delete;
+    ResourcePool& operator=(const ResourcePool&) = delete;
+
+    void Initialise(GraphicsDevice* _device, UINT64 _budget);
+    //Destroys every pooled resource
+    void Shutdown();
+
+    //A budget of 0 disables pooling - lowering the budget evicts immediately
+    void SetBudget(UINT64 _budget);
+    //Evict the least recently released resources until at most targetBytes remain pooled
+    void Trim(UINT64 targetBytes);
+
+    //Takes a pooled resource matching the key out of the pool, or returns nullptr (counted as a miss)
+    [[nodiscard]] ID3D11Resource* Acquire(const ResourcePoolKey& key);
+    //Takes over the caller's reference - the resource is destroyed straight away if it doesn't fit the budget
+    void Add(const ResourcePoolKey& key, ID3D11Resource* resource);
+
+    [[nodiscard]] ResourcePoolStatistics GetStatistics() const;
+
+private:
+    struct Entry
+    {
+        ResourcePoolKey key;
+        size_t hash;
+        UINT64 size;
+        ID3D11Resource* resource;
+    };
+    using EntryList = std::list<Entry>;
+
+    GraphicsDevice* device{ nullptr };
+    UINT64 budget{ 0 };
+    UINT64 bytes{ 0 };
+
+    EntryList entries; //Most recently released first
+    std::unordered_multimap<size_t, EntryList::iterator> lookup;
+
+    UINT64 hits{ 0 };
+    UINT64 misses{ 0 };
+    UINT64 evictions{ 0 };
+
+
+    //Utility functions
+    void Remove(EntryList::iterator entry);
+};
\ No newline at end of file
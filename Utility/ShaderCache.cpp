@@ -0,0 +1,163 @@
+﻿#include "ShaderCache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#include "Hash.h"
+
+//Entry layout: header, then per dependency its path length, path and content hash, then the bytecode
+static constexpr UINT SHADER_CACHE_MAGIC{ 0x43534844 }; //"DHSC"
+
+struct ShaderCacheHeader
+{
+    UINT magic;
+    UINT version;
+    UINT64 key;
+    UINT dependencyCount;
+    UINT bytecodeLength;
+};
+
+
+template<typename T>
+static bool ReadValue(std::ifstream& file, T& value)
+{
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+template<typename T>
+static void WriteValue(std::ofstream& file, const T& value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+
+
+bool ShaderCache::Initialise(const std::filesystem::path& _directory)
+{
+    directory.clear();
+    hits = 0;
+    misses = 0;
+    stale = 0;
+    writes = 0;
+    if (_directory.empty()) { return true; }
+
+    std::error_code error;
+    std::filesystem::create_directories(_directory, error);
+    if (error || !std::filesystem::is_directory(_directory, error))
+    {
+        std::cerr << "ERROR::SHADER_CACHE::INITIALISE::FAILED_TO_CREATE_DIRECTORY" << std::endl;
+        return false;
+    }
+    directory = _directory;
+    return true;
+}
+
+void ShaderCache::Shutdown()
+{
+    directory.clear();
+}
+
+bool ShaderCache::Load(UINT64 key, std::vector<BYTE>& bytecode)
+{
+    if (!IsEnabled()) { return false; }
+
+    std::ifstream file{ GetEntryPath(key), std::ios::binary };
+    if (!file)
+    {
+        ++misses;
+        return false;
+    }
+
+    ShaderCacheHeader header;
+    if (!ReadValue(file, header) || header.magic != SHADER_CACHE_MAGIC || header.version != SHADER_CACHE_VERSION || header.key != key)
+    {
+        ++stale;
+        return false;
+    }
+
+    //Any include that has changed (or gone) since the entry was written invalidates it
+    std::string path;
+    for (UINT i{ 0 }; i < header.dependencyCount; ++i)
+    {
+        UINT pathLength;
+        UINT64 hash;
+        if (!ReadValue(file, pathLength) || pathLength > 32768) { ++stale; return false; }
+        path.resize(pathLength);
+        if (!file.read(path.data(), pathLength) || !ReadValue(file, hash) || HashFile(path) != hash)
+        {
+            ++stale;
+            return false;
+        }
+    }
+
+    bytecode.resize(header.bytecodeLength);
+    if (header.bytecodeLength == 0 || !file.read(reinterpret_cast<char*>(bytecode.data()), header.bytecodeLength))
+    {
+        bytecode.clear();
+        ++stale;
+        return false;
+    }
+    ++hits;
+    return true;
+}
+
+bool ShaderCache::Store(UINT64 key, const void* bytecode, size_t bytecodeLength, const std::vector<ShaderCacheDependency>& dependencies)
+{
+    if (!IsEnabled()) { return false; }
+
+    const std::filesystem::path entryPath{ GetEntryPath(key) };
+    std::filesystem::path temporaryPath{ entryPath };
+    temporaryPath += ".tmp";
+    {
+        std::ofstream file{ temporaryPath, std::ios::binary | std::ios::trunc };
+        if (!file)
+        {
+            std::cerr << "ERROR::SHADER_CACHE::STORE::FAILED_TO_OPEN_FILE" << std::endl;
+            return false;
+        }
+
+        WriteValue(file, ShaderCacheHeader{ SHADER_CACHE_MAGIC, SHADER_CACHE_VERSION, key, static_cast<UINT>(dependencies.size()), static_cast<UINT>(bytecodeLength) });
+        for (const ShaderCacheDependency& dependency : dependencies)
+        {
+            WriteValue(file, static_cast<UINT>(dependency.path.size()));
+            file.write(dependency.path.data(), dependency.path.size());
+            WriteValue(file, dependency.hash);
+        }
+        file.write(static_cast<const char*>(bytecode), bytecodeLength);
+        if (!file)
+        {
+            std::cerr << "ERROR::SHADER_CACHE::STORE::FAILED_TO_WRITE_FILE" << std::endl;
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, entryPath, error);
+    if (error)
+    {
+        std::filesystem::remove(temporaryPath, error);
+        std::cerr << "ERROR::SHADER_CACHE::STORE::FAILED_TO_RENAME_FILE" << std::endl;
+        return false;
+    }
+    ++writes;
+    return true;
+}
+
+UINT64 ShaderCache::HashFile(const std::filesystem::path& path)
+{
+    std::ifstream file{ path, std::ios::binary };
+    if (!file) { return 0; }
+    const std::vector<char> contents{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+    return HashBytes(contents.data(), contents.size());
+}
+
+
+
+std::filesystem::path ShaderCache::GetEntryPath(UINT64 key) const
+{
+    char name[24];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return directory / name;
+}
\ No newline at end of file
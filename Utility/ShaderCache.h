@@ -0,0 +1,67 @@
+﻿#pragma once
+#include <d3d11.h>
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+//Content-addressed on-disk store of compiled shader bytecode
+//Each permutation is keyed by a hash of everything that affects its compilation (source, entry point, target, defines and flags)
+//and lives in its own file named after the key, together with the content hashes of the files it included -
+//an entry whose includes have changed since it was written counts as stale and is recompiled
+//Entries are written to a temporary file first and renamed into place, so an interrupted write never leaves a corrupt entry
+//
+//Load() may be called from several threads at once, everything else is not thread safe
+
+
+constexpr UINT SHADER_CACHE_VERSION{ 1 }; //Bump to invalidate every existing entry, e.g. after changing the compiler
+
+struct ShaderCacheDependency
+{
+    std::string path; //Resolved path of an included file
+    UINT64 hash;      //HashBytes() of its contents when the entry was compiled
+};
+
+struct ShaderCacheStatistics
+{
+    UINT64 hits;   //Loads served from disk
+    UINT64 misses; //Loads with no entry for the key
+    UINT64 stale;  //Loads whose entry was unreadable, or whose includes have changed
+    UINT64 writes;
+};
+
+
+class ShaderCache
+{
+public:
+    ShaderCache() = default;
+    ~ShaderCache() = default;
+
+    ShaderCache(const ShaderCache&) = delete;
+    ShaderCache& operator=(const ShaderCache&) = delete;
+
+    //Creates the directory if it doesn't exist yet - an empty path disables the cache, so every Load() misses and Store() does nothing
+    bool Initialise(const std::filesystem::path& _directory);
+    void Shutdown();
+
+    //True if a valid, up to date entry was found for the key
+    [[nodiscard]] bool Load(UINT64 key, std::vector<BYTE>& bytecode);
+    bool Store(UINT64 key, const void* bytecode, size_t bytecodeLength, const std::vector<ShaderCacheDependency>& dependencies);
+
+    [[nodiscard]] bool IsEnabled() const { return !directory.empty(); }
+    [[nodiscard]] ShaderCacheStatistics GetStatistics() const { return ShaderCacheStatistics{ hits, misses, stale, writes }; }
+
+    //Hash of a file's contents as stored in a dependency, or 0 if it can't be read
+    [[nodiscard]] static UINT64 HashFile(const std::filesystem::path& path);
+
+private:
+    std::filesystem::path directory;
+    std::atomic<UINT64> hits{ 0 };
+    std::atomic<UINT64> misses{ 0 };
+    std::atomic<UINT64> stale{ 0 };
+    std::atomic<UINT64> writes{ 0 };
+
+
+    //Utility functions
+    [[nodiscard]] std::filesystem::path GetEntryPath(UINT64 key) const;
+};
\ No newline at end of file
@@ -0,0 +1,98 @@
+﻿#include "StateCache.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Hash.h"
+
+
+//The descriptions are copied field by field - copying them whole would bring along the caller's padding bytes (after the
+//stencil masks of a depth stencil description and each render target write mask of a blend description), which are never initialised
+static StateCacheKey MakeZeroedKey(STATE_CACHE_TYPE type)
+{
+    StateCacheKey key;
+    std::memset(&key, 0, sizeof(key));
+    key.type = type;
+    return key;
+}
+
+StateCacheKey StateCacheKey::Make(const D3D11_SAMPLER_DESC& desc)
+{
+    StateCacheKey key{ MakeZeroedKey(STATE_CACHE_SAMPLER) };
+    D3D11_SAMPLER_DESC& d{ key.sampler };
+    d.Filter = desc.Filter;
+    d.AddressU = desc.AddressU;
+    d.AddressV = desc.AddressV;
+    d.AddressW = desc.AddressW;
+    d.MipLODBias = desc.MipLODBias;
+    d.MaxAnisotropy = desc.MaxAnisotropy;
+    d.ComparisonFunc = desc.ComparisonFunc;
+    std::copy_n(desc.BorderColor, 4, d.BorderColor);
+    d.MinLOD = desc.MinLOD;
+    d.MaxLOD = desc.MaxLOD;
+    return key;
+}
+
+StateCacheKey StateCacheKey::Make(const D3D11_BLEND_DESC& desc)
+{
+    StateCacheKey key{ MakeZeroedKey(STATE_CACHE_BLEND) };
+    D3D11_BLEND_DESC& d{ key.blend };
+    d.AlphaToCoverageEnable = desc.AlphaToCoverageEnable;
+    d.IndependentBlendEnable = desc.IndependentBlendEnable;
+    for (UINT i{ 0 }; i < D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT; ++i)
+    {
+        const D3D11_RENDER_TARGET_BLEND_DESC& source{ desc.RenderTarget[i] };
+        D3D11_RENDER_TARGET_BLEND_DESC& target{ d.RenderTarget[i] };
+        target.BlendEnable = source.BlendEnable;
+        target.SrcBlend = source.SrcBlend;
+        target.DestBlend = source.DestBlend;
+        target.BlendOp = source.BlendOp;
+        target.SrcBlendAlpha = source.SrcBlendAlpha;
+        target.DestBlendAlpha = source.DestBlendAlpha;
+        target.BlendOpAlpha = source.BlendOpAlpha;
+        target.RenderTargetWriteMask = source.RenderTargetWriteMask;
+    }
+    return key;
+}
+
+StateCacheKey StateCacheKey::Make(const D3D11_RASTERIZER_DESC& desc)
+{
+    StateCacheKey key{ MakeZeroedKey(STATE_CACHE_RASTERIZER) };
+    D3D11_RASTERIZER_DESC& d{ key.rasterizer };
+    d.FillMode = desc.FillMode;
+    d.CullMode = desc.CullMode;
+    d.FrontCounterClockwise = desc.FrontCounterClockwise;
+    d.DepthBias = desc.DepthBias;
+    d.DepthBiasClamp = desc.DepthBiasClamp;
+    d.SlopeScaledDepthBias = desc.SlopeScaledDepthBias;
+    d.DepthClipEnable = desc.DepthClipEnable;
+    d.ScissorEnable = desc.ScissorEnable;
+    d.MultisampleEnable = desc.MultisampleEnable;
+    d.AntialiasedLineEnable = desc.AntialiasedLineEnable;
+    return key;
+}
+
+StateCacheKey StateCacheKey::Make(const D3D11_DEPTH_STENCIL_DESC& desc)
+{
+    StateCacheKey key{ MakeZeroedKey(STATE_CACHE_DEPTH_STENCIL) };
+    D3D11_DEPTH_STENCIL_DESC& d{ key.depthStencil };
+    d.DepthEnable = desc.DepthEnable;
+    d.DepthWriteMask = desc.DepthWriteMask;
+    d.DepthFunc = desc.DepthFunc;
+    d.StencilEnable = desc.StencilEnable;
+    d.StencilReadMask = desc.StencilReadMask;
+    d.StencilWriteMask = desc.StencilWriteMask;
+    d.FrontFace = desc.FrontFace; //D3D11_DEPTH_STENCILOP_DESC is four enums, so has no padding of its own
+    d.BackFace = desc.BackFace;
+    return key;
+}
+
+bool StateCacheKey::operator==(const StateCacheKey& other) const
+{
+    return std::memcmp(this, &other, sizeof(StateCacheKey)) == 0;
+}
+
+size_t StateCacheKey::Hash() const
+{
+    return static_cast<size_t>(HashBytes(this, sizeof(StateCacheKey)));
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+﻿#pragma once
+#include <d3d11.h>
+
+#include "ObjectCache.h"
+
+//Key of a state object in the state cache - its full description
+//Direct3D 11 caps each state type at 4096 unique objects per device, so identical descriptions must share one object
+
+
+enum STATE_CACHE_TYPE
+{
+    STATE_CACHE_SAMPLER,
+    STATE_CACHE_BLEND,
+    STATE_CACHE_RASTERIZER,
+    STATE_CACHE_DEPTH_STENCIL,
+};
+
+struct StateCacheKey
+{
+    STATE_CACHE_TYPE type;
+    union
+    {
+        D3D11_SAMPLER_DESC sampler;
+        D3D11_BLEND_DESC blend;
+        D3D11_RASTERIZER_DESC rasterizer;
+        D3D11_DEPTH_STENCIL_DESC depthStencil;
+    };
+
+    //Keys are compared bytewise, so every byte the description doesn't cover is zeroed
+    [[nodiscard]] static StateCacheKey Make(const D3D11_SAMPLER_DESC& desc);
+    [[nodiscard]] static StateCacheKey Make(const D3D11_BLEND_DESC& desc);
+    [[nodiscard]] static StateCacheKey Make(const D3D11_RASTERIZER_DESC& desc);
+    [[nodiscard]] static StateCacheKey Make(const D3D11_DEPTH_STENCIL_DESC& desc);
+
+    [[nodiscard]] bool operator==(const StateCacheKey& other) const;
+    [[nodiscard]] size_t Hash() const;
+};
+
+//Sampler, blend, rasterizer and depth stencil states shared between identical Create*State() requests
+using StateCache = ObjectCache<StateCacheKey, ID3D11DeviceChild>;
\ No newline at end of file
@@ -0,0 +1,660 @@
+﻿#include "TextureProcessing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "../Managers/JobManager.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TEXTURE_PROCESSING_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TEXTURE_PROCESSING_AVX2 //MSVC emits AVX2 intrinsics whatever /arch is set to
+#else
+#define TEXTURE_PROCESSING_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+constexpr float KAISER_RADIUS{ 1.5f }; //In texels of the mip
+constexpr float KAISER_ALPHA{ 4.0f };
+constexpr UINT TEXELS_PER_JOB{ 64 * 1024 };
+constexpr UINT SRGB_GUESS_SIZE{ 4096 };
+
+static bool avx2MipFiltersEnabled{ true };
+
+
+UINT GetMipCount(UINT width, UINT height)
+{
+    UINT count{ 1 };
+    for (UINT size{ (std::max)(width, height) }; size > 1; size /= 2) { ++count; }
+    return count;
+}
+
+//Rows per ParallelFor() batch, so every job gets about the same amount of work whatever the width
+static UINT GetRowsPerJob(UINT width)
+{
+    return (std::max)(TEXELS_PER_JOB / (std::max)(width, 1u), 1u);
+}
+
+
+
+//-----------------------------------------------//
+//------------------CONVERSION-------------------//
+//-----------------------------------------------//
+struct SrgbTables
+{
+    float decode[256];
+    float thresholds[255];         //Linear value halfway (in sRGB space) between each byte and the next
+    BYTE guess[SRGB_GUESS_SIZE];   //Highest byte whose threshold is at or below each step of [0,1], to start the search from
+};
+
+static float SrgbToLinear(float c)
+{
+    return (c <= 0.04045f) ? (c / 12.92f) : (std::pow((c + 0.055f) / 1.055f, 2.4f));
+}
+
+static const SrgbTables& GetSrgbTables()
+{
+    static const SrgbTables tables{ []()
+    {
+        SrgbTables t{};
+        for (UINT i{ 0 }; i < 256; ++i) { t.decode[i] = SrgbToLinear(i / 255.0f); }
+        for (UINT i{ 0 }; i < 255; ++i) { t.thresholds[i] = SrgbToLinear((i + 0.5f) / 255.0f); }
+        UINT b{ 0 };
+        for (UINT i{ 0 }; i < SRGB_GUESS_SIZE; ++i)
+        {
+            const float v{ static_cast<float>(i) / (SRGB_GUESS_SIZE - 1) };
+            while (b < 255 && v >= t.thresholds[b]) { ++b; }
+            t.guess[i] = static_cast<BYTE>(b);
+        }
+        return t;
+    }() };
+    return tables;
+}
+
+static BYTE EncodeLinear(float v)
+{
+    return static_cast<BYTE>(std::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+static BYTE EncodeSrgb(const SrgbTables& tables, float v)
+{
+    if (!(v > 0.0f)) { return 0; }
+    if (v >= 1.0f) { return 255; }
+    UINT b{ tables.guess[static_cast<UINT>(v * (SRGB_GUESS_SIZE - 1))] };
+    while (b < 255 && v >= tables.thresholds[b]) { ++b; }
+    while (b > 0 && v < tables.thresholds[b - 1]) { --b; }
+    return static_cast<BYTE>(b);
+}
+
+void DecodeRgba8(const BYTE* texels, UINT width, UINT height, UINT rowPitch, bool srgb, LinearImage& image)
+{
+    image.width = width;
+    image.height = height;
+    image.texels.resize(static_cast<size_t>(width) * height * 4);
+    const SrgbTables& tables{ GetSrgbTables() };
+    JobManager::ParallelFor(0, height, GetRowsPerJob(width), [&](UINT begin, UINT end)
+    {
+        for (UINT y{ begin }; y < end; ++y)
+        {
+            const BYTE* source{ texels + static_cast<size_t>(y) * rowPitch };
+            float* destination{ image.texels.data() + static_cast<size_t>(y) * width * 4 };
+            for (UINT x{ 0 }; x < width * 4; ++x)
+            {
+                destination[x] = (srgb && x % 4 != 3) ? (tables.decode[source[x]]) : (source[x] / 255.0f);
+            }
+        }
+    });
+}
+
+void EncodeRgba8(const LinearImage& image, bool srgb, std::vector<BYTE>& texels)
+{
+    texels.resize(static_cast<size_t>(image.width) * image.height * 4);
+    const SrgbTables& tables{ GetSrgbTables() };
+    JobManager::ParallelFor(0, image.height, GetRowsPerJob(image.width), [&](UINT begin, UINT end)
+    {
+        const size_t first{ static_cast<size_t>(begin) * image.width * 4 };
+        const size_t last{ static_cast<size_t>(end) * image.width * 4 };
+        for (size_t i{ first }; i < last; ++i)
+        {
+            texels[i] = (srgb && i % 4 != 3) ? (EncodeSrgb(tables, image.texels[i])) : (EncodeLinear(image.texels[i]));
+        }
+    });
+}
+//-----------------------------------------------//
+//--------------END OF CONVERSION----------------//
+//-----------------------------------------------//
+
+
+
+//-----------------------------------------------//
+//-------------------FILTERING-------------------//
+//-----------------------------------------------//
+//Taps of a 1D filter from a source axis to a mip axis
+struct FilterAxis
+{
+    UINT tapCount;              //Same for every mip texel - shorter filters are padded with zero weights
+    std::vector<UINT> indices;  //tapCount per mip texel, clamped to the source
+    std::vector<float> weights; //Normalised
+};
+
+//Modified Bessel function of the first kind, order 0
+static double BesselI0(double x)
+{
+    double sum{ 1.0 };
+    double term{ 1.0 };
+    for (UINT k{ 1 }; k < 32 && term > sum * 1e-12; ++k)
+    {
+        const double t{ x / (2.0 * k) };
+        term *= t * t;
+        sum += term;
+    }
+    return sum;
+}
+
+static float KaiserSinc(float t)
+{
+    const double window{ BesselI0(KAISER_ALPHA * std::sqrt((std::max)(1.0 - (t / KAISER_RADIUS) * (t / KAISER_RADIUS), 0.0))) / BesselI0(KAISER_ALPHA) };
+    const double pt{ 3.14159265358979323846 * t };
+    return static_cast<float>(((std::abs(pt) < 1e-6) ? (1.0) : (std::sin(pt) / pt)) * window);
+}
+
+static FilterAxis BuildFilterAxis(UINT sourceSize, UINT mipSize, MIP_FILTER filter)
+{
+    std::vector<std::vector<std::pair<UINT, float>>> taps(mipSize);
+    const float scale{ static_cast<float>(sourceSize) / mipSize };
+    for (UINT x{ 0 }; x < mipSize; ++x)
+    {
+        if (sourceSize == mipSize)
+        {
+            taps[x].emplace_back(x, 1.0f);
+            continue;
+        }
+        const float centre{ (x + 0.5f) * scale };
+        const float reach{ (filter == MIP_FILTER_KAISER) ? (KAISER_RADIUS * scale) : (0.5f * scale) };
+        const int first{ static_cast<int>(std::floor(centre - reach)) };
+        const int last{ static_cast<int>(std::ceil(centre + reach)) };
+        float total{ 0.0f };
+        for (int i{ first }; i < last; ++i)
+        {
+            //Box weights are the overlap of the texel with the mip texel's footprint
+            const float weight{ (filter == MIP_FILTER_KAISER) ? (KaiserSinc((i + 0.5f - centre) / scale)) :
+                                ((std::max)((std::min)(i + 1.0f, centre + reach) - (std::max)(static_cast<float>(i), centre - reach), 0.0f)) };
+            if (weight == 0.0f) { continue; }
+            taps[x].emplace_back(static_cast<UINT>(std::clamp(i, 0, static_cast<int>(sourceSize) - 1)), weight);
+            total += weight;
+        }
+        for (auto& tap : taps[x]) { tap.second /= total; }
+    }
+
+    FilterAxis axis{};
+    for (const auto& texel : taps) { axis.tapCount = (std::max)(axis.tapCount, static_cast<UINT>(texel.size())); }
+    axis.indices.reserve(static_cast<size_t>(mipSize) * axis.tapCount);
+    axis.weights.reserve(static_cast<size_t>(mipSize) * axis.tapCount);
+    for (const auto& texel : taps)
+    {
+        for (UINT k{ 0 }; k < axis.tapCount; ++k)
+        {
+            axis.indices.push_back((k < texel.size()) ? (texel[k].first) : (texel.back().first));
+            axis.weights.push_back((k < texel.size()) ? (texel[k].second) : (0.0f));
+        }
+    }
+    return axis;
+}
+
+static bool SupportsAvx2()
+{
+#if defined(TEXTURE_PROCESSING_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) { return false; }
+    __cpuid(info, 1);
+    //The OS has to save the upper halves of the registers as well
+    const bool osxsave{ (info[2] & (1 << 27)) != 0 };
+    const bool avx{ (info[2] & (1 << 28)) != 0 };
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) { return false; }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif defined(TEXTURE_PROCESSING_X86)
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+#ifdef TEXTURE_PROCESSING_X86
+//destination[i] = sum of weights[k] * rows[k][i] - count is a multiple of 4
+static void FilterRowsSse(const float* const* rows, const float* weights, UINT tapCount, UINT count, float* destination)
+{
+    for (UINT i{ 0 }; i < count; i += 4)
+    {
+        __m128 sum{ _mm_setzero_ps() };
+        for (UINT k{ 0 }; k < tapCount; ++k) { sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(rows[k] + i))); }
+        _mm_storeu_ps(destination + i, sum);
+    }
+}
+
+TEXTURE_PROCESSING_AVX2 static void FilterRowsAvx2(const float* const* rows, const float* weights, UINT tapCount, UINT count, float* destination)
+{
+    UINT i{ 0 };
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 sum{ _mm256_setzero_ps() };
+        for (UINT k{ 0 }; k < tapCount; ++k) { sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(weights[k]), _mm256_loadu_ps(rows[k] + i))); }
+        _mm256_storeu_ps(destination + i, sum);
+    }
+    for (; i < count; i += 4)
+    {
+        __m128 sum{ _mm_setzero_ps() };
+        for (UINT k{ 0 }; k < tapCount; ++k) { sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(rows[k] + i))); }
+        _mm_storeu_ps(destination + i, sum);
+    }
+}
+
+//One RGBA texel per SSE register
+static void FilterTexelsSse(const float* row, const FilterAxis& axis, UINT count, float* destination)
+{
+    const UINT* indices{ axis.indices.data() };
+    const float* weights{ axis.weights.data() };
+    for (UINT x{ 0 }; x < count; ++x, indices += axis.tapCount, weights += axis.tapCount)
+    {
+        __m128 sum{ _mm_setzero_ps() };
+        for (UINT k{ 0 }; k < axis.tapCount; ++k) { sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(row + indices[k] * 4))); }
+        _mm_storeu_ps(destination + x * 4, sum);
+    }
+}
+
+//Two mip texels per AVX register, one in each half
+TEXTURE_PROCESSING_AVX2 static void FilterTexelsAvx2(const float* row, const FilterAxis& axis, UINT count, float* destination)
+{
+    const UINT taps{ axis.tapCount };
+    UINT x{ 0 };
+    for (; x + 2 <= count; x += 2)
+    {
+        const UINT* indices{ axis.indices.data() + x * taps };
+        const float* weights{ axis.weights.data() + x * taps };
+        __m256 sum{ _mm256_setzero_ps() };
+        for (UINT k{ 0 }; k < taps; ++k)
+        {
+            const __m256 texels{ _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(row + indices[k] * 4)), _mm_loadu_ps(row + indices[taps + k] * 4), 1) };
+            const __m256 weight{ _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(weights[k])), _mm_set1_ps(weights[taps + k]), 1) };
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(weight, texels));
+        }
+        _mm256_storeu_ps(destination + x * 4, sum);
+    }
+    if (x < count)
+    {
+        const UINT* indices{ axis.indices.data() + x * taps };
+        const float* weights{ axis.weights.data() + x * taps };
+        __m128 sum{ _mm_setzero_ps() };
+        for (UINT k{ 0 }; k < taps; ++k) { sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(row + indices[k] * 4))); }
+        _mm_storeu_ps(destination + x * 4, sum);
+    }
+}
+#else
+static void FilterRowsScalar(const float* const* rows, const float* weights, UINT tapCount, UINT count, float* destination)
+{
+    for (UINT i{ 0 }; i < count; ++i)
+    {
+        float sum{ 0.0f };
+        for (UINT k{ 0 }; k < tapCount; ++k) { sum += weights[k] * rows[k][i]; }
+        destination[i] = sum;
+    }
+}
+
+static void FilterTexelsScalar(const float* row, const FilterAxis& axis, UINT count, float* destination)
+{
+    for (UINT x{ 0 }; x < count; ++x)
+    {
+        for (UINT c{ 0 }; c < 4; ++c)
+        {
+            float sum{ 0.0f };
+            for (UINT k{ 0 }; k < axis.tapCount; ++k) { sum += axis.weights[x * axis.tapCount + k] * row[axis.indices[x * axis.tapCount + k] * 4 + c]; }
+            destination[x * 4 + c] = sum;
+        }
+    }
+}
+#endif
+
+static void Downsample(const LinearImage& source, MIP_FILTER filter, LinearImage& mip)
+{
+    mip.width = (std::max)(source.width / 2, 1u);
+    mip.height = (std::max)(source.height / 2, 1u);
+    mip.texels.resize(static_cast<size_t>(mip.width) * mip.height * 4);
+    const FilterAxis columns{ BuildFilterAxis(source.width, mip.width, filter) };
+    const FilterAxis rows{ BuildFilterAxis(source.height, mip.height, filter) };
+    static const bool supportsAvx2{ SupportsAvx2() };
+    const bool avx2{ supportsAvx2 && avx2MipFiltersEnabled };
+
+    //Vertical pass over whole source rows into scratch, then horizontal pass from scratch into the mip row
+    JobManager::ParallelFor(0, mip.height, GetRowsPerJob(source.width), [&](UINT begin, UINT end)
+    {
+        const UINT rowFloats{ source.width * 4 };
+        std::vector<float> filtered(rowFloats);
+        std::vector<const float*> taps(rows.tapCount);
+        for (UINT y{ begin }; y < end; ++y)
+        {
+            for (UINT k{ 0 }; k < rows.tapCount; ++k) { taps[k] = source.texels.data() + static_cast<size_t>(rows.indices[y * rows.tapCount + k]) * rowFloats; }
+            const float* weights{ rows.weights.data() + y * rows.tapCount };
+            float* destination{ mip.texels.data() + static_cast<size_t>(y) * mip.width * 4 };
+#ifdef TEXTURE_PROCESSING_X86
+            if (avx2)
+            {
+                FilterRowsAvx2(taps.data(), weights, rows.tapCount, rowFloats, filtered.data());
+                FilterTexelsAvx2(filtered.data(), columns, mip.width, destination);
+            }
+            else
+            {
+                FilterRowsSse(taps.data(), weights, rows.tapCount, rowFloats, filtered.data());
+                FilterTexelsSse(filtered.data(), columns, mip.width, destination);
+            }
+#else
+            FilterRowsScalar(taps.data(), weights, rows.tapCount, rowFloats, filtered.data());
+            FilterTexelsScalar(filtered.data(), columns, mip.width, destination);
+#endif
+        }
+    });
+}
+
+void GenerateMips(const LinearImage& source, MIP_FILTER filter, UINT mipCount, std::vector<LinearImage>& mips)
+{
+    const UINT fullCount{ GetMipCount(source.width, source.height) };
+    mipCount = (mipCount == 0) ? (fullCount) : ((std::min)(mipCount, fullCount));
+    mips.resize(mipCount - 1);
+    //Each level is filtered from the one above, so the work halves with every level
+    for (UINT i{ 0 }; i + 1 < mipCount; ++i)
+    {
+        Downsample((i == 0) ? (source) : (mips[i - 1]), filter, mips[i]);
+    }
+}
+
+void SetAvx2MipFiltersEnabled(bool enabled)
+{
+    avx2MipFiltersEnabled = enabled;
+}
+//-----------------------------------------------//
+//---------------END OF FILTERING----------------//
+//-----------------------------------------------//
+
+
+
+//-----------------------------------------------//
+//---------------BLOCK COMPRESSION---------------//
+//-----------------------------------------------//
+static UINT16 PackRgb565(const float colour[3])
+{
+    const UINT r{ static_cast<UINT>(std::clamp(colour[0], 0.0f, 255.0f) * 31.0f / 255.0f + 0.5f) };
+    const UINT g{ static_cast<UINT>(std::clamp(colour[1], 0.0f, 255.0f) * 63.0f / 255.0f + 0.5f) };
+    const UINT b{ static_cast<UINT>(std::clamp(colour[2], 0.0f, 255.0f) * 31.0f / 255.0f + 0.5f) };
+    return static_cast<UINT16>((r << 11) | (g << 5) | b);
+}
+
+static void UnpackRgb565(UINT16 packed, int colour[3])
+{
+    const int r{ (packed >> 11) & 31 };
+    const int g{ (packed >> 5) & 63 };
+    const int b{ packed & 31 };
+    colour[0] = (r << 3) | (r >> 2);
+    colour[1] = (g << 2) | (g >> 4);
+    colour[2] = (b << 3) | (b >> 2);
+}
+
+static void WriteUint16(BYTE* destination, UINT16 value)
+{
+    destination[0] = static_cast<BYTE>(value & 0xFF);
+    destination[1] = static_cast<BYTE>(value >> 8);
+}
+
+//Endpoints from the extremes of the colours along their principal axis, so the line through the block fits its spread
+static void FindColourEndpoints(const BYTE texels[16][4], const bool used[16], float endpoints[2][3])
+{
+    float mean[3]{};
+    UINT count{ 0 };
+    for (UINT i{ 0 }; i < 16; ++i)
+    {
+        if (!used[i]) { continue; }
+        for (UINT c{ 0 }; c < 3; ++c) { mean[c] += texels[i][c]; }
+        ++count;
+    }
+    for (UINT c{ 0 }; c < 3; ++c) { mean[c] /= count; }
+
+    float covariance[6]{}; //rr, rg, rb, gg, gb, bb
+    for (UINT i{ 0 }; i < 16; ++i)
+    {
+        if (!used[i]) { continue; }
+        const float d[3]{ texels[i][0] - mean[0], texels[i][1] - mean[1], texels[i][2] - mean[2] };
+        covariance[0] += d[0] * d[0]; covariance[1] += d[0] * d[1]; covariance[2] += d[0] * d[2];
+        covariance[3] += d[1] * d[1]; covariance[4] += d[1] * d[2]; covariance[5] += d[2] * d[2];
+    }
+    //Power iteration, seeded with the covariance column of the channel that varies most - a fixed seed such as grey can be
+    //orthogonal to the axis (red against blue is), and would leave both endpoints on the mean
+    const UINT seed{ (covariance[0] >= covariance[3] && covariance[0] >= covariance[5]) ? (0u) : ((covariance[3] >= covariance[5]) ? (1u) : (2u)) };
+    constexpr UINT columns[3][3]{ { 0, 1, 2 }, { 1, 3, 4 }, { 2, 4, 5 } };
+    float axis[3]{ covariance[columns[seed][0]], covariance[columns[seed][1]], covariance[columns[seed][2]] };
+    for (UINT iteration{ 0 }; iteration < 8; ++iteration)
+    {
+        const float next[3]{ covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2],
+                             covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2],
+                             covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2] };
+        const float length{ std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2]) };
+        if (length < 1e-6f) { break; }
+        for (UINT c{ 0 }; c < 3; ++c) { axis[c] = next[c] / length; }
+    }
+
+    float lowest{ 0.0f };
+    float highest{ 0.0f };
+    for (UINT i{ 0 }; i < 16; ++i)
+    {
+        if (!used[i]) { continue; }
+        const float t{ (texels[i][0] - mean[0]) * axis[0] + (texels[i][1] - mean[1]) * axis[1] + (texels[i][2] - mean[2]) * axis[2] };
+        lowest = (std::min)(lowest, t);
+        highest = (std::max)(highest, t);
+    }
+    for (UINT c{ 0 }; c < 3; ++c)
+    {
+        endpoints[0][c] = mean[c] + axis[c] * highest;
+        endpoints[1][c] = mean[c] + axis[c] * lowest;
+    }
+}
+
+//Nearest palette entry for each used texel - returns the squared error
+static UINT PickColourIndices(const BYTE texels[16][4], const bool used[16], const int palette[4][3], UINT paletteSize, BYTE indices[16])
+{
+    UINT error{ 0 };
+    for (UINT i{ 0 }; i < 16; ++i)
+    {
+        if (!used[i]) { continue; }
+        UINT best{ ~0u };
+        for (UINT p{ 0 }; p < paletteSize; ++p)
+        {
+            const int dr{ texels[i][0] - palette[p][0] };
+            const int dg{ texels[i][1] - palette[p][1] };
+            const int db{ texels[i][2] - palette[p][2] };
+            const UINT distance{ static_cast<UINT>(dr * dr + dg * dg + db * db) };
+            if (distance < best)
+            {
+                best = distance;
+                indices[i] = static_cast<BYTE>(p);
+            }
+        }
+        error += best;
+    }
+    return error;
+}
+
+//BC1 colour block - BC3 colour blocks are the same, minus the transparent mode
+static void CompressColourBlock(const BYTE texels[16][4], bool allowTransparency, BYTE* block)
+{
+    bool used[16];
+    bool transparent{ false };
+    for (UINT i{ 0 }; i < 16; ++i)
+    {
+        used[i] = !allowTransparency || texels[i][3] >= 128;
+        transparent = transparent || !used[i];
+    }
+    if (transparent && std::none_of(used, used + 16, [](bool u) { return u; }))
+    {
+        //Every texel is index 3 of the three colour mode, which is transparent black
+        std::memset(block, 0, 4);
+        std::memset(block + 4, 0xFF, 4);
+        return;
+    }
+
+    float endpoints[2][3];
+    FindColourEndpoints(texels, used, endpoints);
+    UINT16 packed[2]{ PackRgb565(endpoints[0]), PackRgb565(endpoints[1]) };
+    BYTE indices[16]{};
+    for (UINT pass{ 0 }; pass < 2; ++pass)
+    {
+        //Four colour mode needs the first endpoint above the second, three colour (transparent) mode the reverse
+        if ((!transparent && packed[0] < packed[1]) || (transparent && packed[0] > packed[1])) { std::swap(packed[0], packed[1]); }
+        int palette[4][3];
+        UnpackRgb565(packed[0], palette[0]);
+        UnpackRgb565(packed[1], palette[1]);
+        const bool fourColour{ !transparent && packed[0] != packed[1] };
+        for (UINT c{ 0 }; c < 3; ++c)
+        {
+            palette[2][c] = (fourColour) ? ((2 * palette[0][c] + palette[1][c]) / 3) : ((palette[0][c] + palette[1][c]) / 2);
+            palette[3][c] = (fourColour) ? ((palette[0][c] + 2 * palette[1][c]) / 3) : (0);
+        }
+        PickColourIndices(texels, used, palette, (fourColour) ? (4u) : (3u), indices);
+        if (pass == 1 || !fourColour) { break; }
+
+        //Refit the endpoints to the chosen indices by least squares, and keep the result if it's no worse
+        constexpr float weightOfFirst[4]{ 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+        float aa{ 0.0f }, ab{ 0.0f }, bb{ 0.0f };
+        float ax[3]{}, bx[3]{};
+        for (UINT i{ 0 }; i < 16; ++i)
+        {
+            const float a{ weightOfFirst[indices[i]] };
+            const float b{ 1.0f - a };
+            aa += a * a; ab += a * b; bb += b * b;
+            for (UINT c{ 0 }; c < 3; ++c) { ax[c] += a * texels[i][c]; bx[c] += b * texels[i][c]; }
+        }
+        const float determinant{ aa * bb - ab * ab };
+        if (std::abs(determinant) < 1e-6f) { break; }
+        float refit[2][3];
+        for (UINT c{ 0 }; c < 3; ++c)
+        {
+            refit[0][c] = (ax[c] * bb - bx[c] * ab) / determinant;
+            refit[1][c] = (bx[c] * aa - ax[c] * ab) / determinant;
+        }
+        const UINT16 refitPacked[2]{ PackRgb565(refit[0]), PackRgb565(refit[1]) };
+        if (refitPacked[0] == refitPacked[1]) { break; }
+
+        int refitPalette[4][3];
+        UnpackRgb565((std::max)(refitPacked[0], refitPacked[1]), refitPalette[0]);
+        UnpackRgb565((std::min)(refitPacked[0], refitPacked[1]), refitPalette[1]);
+        for (UINT c{ 0 }; c < 3; ++c)
+        {
+            refitPalette[2][c] = (2 * refitPalette[0][c] + refitPalette[1][c]) / 3;
+            refitPalette[3][c] = (refitPalette[0][c] + 2 * refitPalette[1][c]) / 3;
+        }
+        BYTE refitIndices[16]{};
+        if (PickColourIndices(texels, used, refitPalette, 4, refitIndices) > PickColourIndices(texels, used, palette, 4, indices)) { break; }
+        packed[0] = refitPacked[0];
+        packed[1] = refitPacked[1];
+    }
+
+    WriteUint16(block, packed[0]);
+    WriteUint16(block + 2, packed[1]);
+    UINT bits{ 0 };
+    for (UINT i{ 0 }; i < 16; ++i) { bits |= static_cast<UINT>((used[i]) ? (indices[i]) : (3)) << (i * 2); }
+    std::memcpy(block + 4, &bits, 4);
+}
+
+//BC4 block, as used for BC3 alpha and each BC5 channel - signed values are in [-127,127], unsigned in [0,255]
+static void CompressSingleChannelBlock(const int values[16], bool isSigned, BYTE* block)
+{
+    const int highest{ *std::max_element(values, values + 16) };
+    const int lowest{ *std::min_element(values, values + 16) };
+    //Eight value mode, with the first endpoint above the second
+    int palette[8]{ highest, lowest };
+    for (int i{ 1 }; i < 7; ++i) { palette[i + 1] = ((7 - i) * highest + i * lowest + 3) / 7; }
+
+    UINT64 bits{ 0 };
+    for (UINT i{ 0 }; i < 16; ++i)
+    {
+        UINT best{ 0 };
+        for (UINT p{ 1 }; p < 8 && highest != lowest; ++p)
+        {
+            if (std::abs(values[i] - palette[p]) < std::abs(values[i] - palette[best])) { best = p; }
+        }
+        bits |= static_cast<UINT64>(best) << (i * 3);
+    }
+    block[0] = static_cast<BYTE>((isSigned) ? (static_cast<signed char>(highest)) : (highest));
+    block[1] = static_cast<BYTE>((isSigned) ? (static_cast<signed char>(lowest)) : (lowest));
+    for (UINT i{ 0 }; i < 6; ++i) { block[2 + i] = static_cast<BYTE>(bits >> (i * 8)); }
+}
+
+static void CompressChannel(const BYTE texels[16][4], UINT channel, bool isSigned, BYTE* block)
+{
+    int values[16];
+    for (UINT i{ 0 }; i < 16; ++i)
+    {
+        //Unsigned bytes map to [-1,1] the way normal maps store them
+        values[i] = (isSigned) ? (static_cast<int>(std::lround((texels[i][channel] / 255.0f * 2.0f - 1.0f) * 127.0f))) : (texels[i][channel]);
+    }
+    CompressSingleChannelBlock(values, isSigned, block);
+}
+
+bool CompressBlocks(const BYTE* texels, UINT width, UINT height, DXGI_FORMAT format, std::vector<BYTE>& blocks)
+{
+    UINT blockSize;
+    switch (format)
+    {
+    case (DXGI_FORMAT_BC1_UNORM): case (DXGI_FORMAT_BC1_UNORM_SRGB): case (DXGI_FORMAT_BC4_UNORM): case (DXGI_FORMAT_BC4_SNORM):
+        blockSize = 8;
+        break;
+    case (DXGI_FORMAT_BC3_UNORM): case (DXGI_FORMAT_BC3_UNORM_SRGB): case (DXGI_FORMAT_BC5_UNORM): case (DXGI_FORMAT_BC5_SNORM):
+        blockSize = 16;
+        break;
+    default:
+        return false;
+    }
+
+    const UINT blocksWide{ (width + 3) / 4 };
+    const UINT blocksHigh{ (height + 3) / 4 };
+    blocks.resize(static_cast<size_t>(blocksWide) * blocksHigh * blockSize);
+    JobManager::ParallelFor(0, blocksHigh, GetRowsPerJob(width * 4), [&](UINT begin, UINT end)
+    {
+        for (UINT by{ begin }; by < end; ++by)
+        {
+            for (UINT bx{ 0 }; bx < blocksWide; ++bx)
+            {
+                BYTE block[16][4];
+                for (UINT i{ 0 }; i < 16; ++i)
+                {
+                    const UINT x{ (std::min)(bx * 4 + i % 4, width - 1) };
+                    const UINT y{ (std::min)(by * 4 + i / 4, height - 1) };
+                    std::memcpy(block[i], texels + (static_cast<size_t>(y) * width + x) * 4, 4);
+                }
+
+                BYTE* destination{ blocks.data() + (static_cast<size_t>(by) * blocksWide + bx) * blockSize };
+                switch (format)
+                {
+                case (DXGI_FORMAT_BC1_UNORM): case (DXGI_FORMAT_BC1_UNORM_SRGB):
+                    CompressColourBlock(block, true, destination);
+                    break;
+                case (DXGI_FORMAT_BC3_UNORM): case (DXGI_FORMAT_BC3_UNORM_SRGB):
+                    CompressChannel(block, 3, false, destination);
+                    CompressColourBlock(block, false, destination + 8);
+                    break;
+                case (DXGI_FORMAT_BC4_UNORM): case (DXGI_FORMAT_BC4_SNORM):
+                    CompressChannel(block, 0, format == DXGI_FORMAT_BC4_SNORM, destination);
+                    break;
+                default:
+                    CompressChannel(block, 0, format == DXGI_FORMAT_BC5_SNORM, destination);
+                    CompressChannel(block, 1, format == DXGI_FORMAT_BC5_SNORM, destination + 8);
+                    break;
+                }
+            }
+        }
+    });
+    return true;
+}
+//-----------------------------------------------//
+//-----------END OF BLOCK COMPRESSION------------//
+//-----------------------------------------------//
\ No newline at end of file
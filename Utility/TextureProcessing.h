@@ -0,0 +1,48 @@
+﻿#pragma once
+#include <d3d11.h>
+#include <vector>
+
+//CPU texture processing for the content pipeline (see Tools/TextureConverter) - mip chains are generated once at import and
+//shipped in the file, rather than regenerated on the GPU every load
+//
+//Filtering happens on linear float RGBA: sRGB colour channels are decoded first and encoded again afterwards, so mips keep
+//the brightness of the level above instead of darkening. Filters are separable, with a vertical pass over whole rows and a
+//horizontal pass over texels, both in SSE, or AVX2 where the CPU has it - rows are spread across the JobManager's threads,
+//as are the 4x4 blocks of the block compressors
+
+
+enum MIP_FILTER
+{
+    MIP_FILTER_BOX,    //Average of the texels each mip texel covers - cheap, but soft and prone to aliasing
+    MIP_FILTER_KAISER, //Kaiser-windowed sinc over 1.5 texels of the mip either side - sharper, with little aliasing or ringing
+};
+
+//Texels are RGBA, 4 floats each, in linear space
+struct LinearImage
+{
+    UINT width;
+    UINT height;
+    std::vector<float> texels; //width * height * 4, rows tightly packed
+};
+
+
+//Levels in a full chain down to 1x1
+[[nodiscard]] UINT GetMipCount(UINT width, UINT height);
+
+//----Conversion----//
+//From RGBA8 - the colour channels are decoded from sRGB if srgb is set, alpha is always linear
+void DecodeRgba8(const BYTE* texels, UINT width, UINT height, UINT rowPitch, bool srgb, LinearImage& image);
+//To tightly packed RGBA8, rounding to nearest (in sRGB space for the colour channels if srgb is set)
+void EncodeRgba8(const LinearImage& image, bool srgb, std::vector<BYTE>& texels);
+
+//----Mips----//
+//Levels 1 to mipCount-1 of the chain starting at source - 0 for a full chain
+void GenerateMips(const LinearImage& source, MIP_FILTER filter, UINT mipCount, std::vector<LinearImage>& mips);
+//On by default - off keeps the filters on SSE where the CPU has AVX2, so the two paths can be compared
+void SetAvx2MipFiltersEnabled(bool enabled);
+
+//----Block Compression----//
+//From tightly packed RGBA8 to rows of 4x4 blocks, edge texels repeated to fill partial blocks
+//BC1 (RGB, with 1-bit alpha if any texel's alpha is below 128), BC3 (RGBA), BC4 (R) and BC5 (RG), in any of their typed variants
+//Encoding is the same for _SRGB formats, which hold sRGB values just as RGBA8_UNORM_SRGB does - false for other formats
+[[nodiscard]] bool CompressBlocks(const BYTE* texels, UINT width, UINT height, DXGI_FORMAT format, std::vector<BYTE>& blocks);
\ No newline at end of file
@@ -0,0 +1,48 @@
+﻿#include "ViewCache.h"
+
+#include <cstring>
+
+#include "Hash.h"
+
+
+template<typename Desc>
+static ViewCacheKey MakeKey(ID3D11Resource* resource, VIEW_CACHE_TYPE type, const Desc* desc)
+{
+    ViewCacheKey key;
+    std::memset(&key, 0, sizeof(key));
+    key.resource = resource;
+    key.type = type;
+    key.defaultDescription = (desc == nullptr);
+    if (desc) { std::memcpy(&key.shaderResource, desc, sizeof(Desc)); }
+    return key;
+}
+
+ViewCacheKey ViewCacheKey::Make(ID3D11Resource* resource, const D3D11_SHADER_RESOURCE_VIEW_DESC* desc)
+{
+    return MakeKey(resource, VIEW_CACHE_SHADER_RESOURCE, desc);
+}
+
+ViewCacheKey ViewCacheKey::Make(ID3D11Resource* resource, const D3D11_UNORDERED_ACCESS_VIEW_DESC* desc)
+{
+    return MakeKey(resource, VIEW_CACHE_UNORDERED_ACCESS, desc);
+}
+
+ViewCacheKey ViewCacheKey::Make(ID3D11Resource* resource, const D3D11_RENDER_TARGET_VIEW_DESC* desc)
+{
+    return MakeKey(resource, VIEW_CACHE_RENDER_TARGET, desc);
+}
+
+ViewCacheKey ViewCacheKey::Make(ID3D11Resource* resource, const D3D11_DEPTH_STENCIL_VIEW_DESC* desc)
+{
+    return MakeKey(resource, VIEW_CACHE_DEPTH_STENCIL, desc);
+}
+
+bool ViewCacheKey::operator==(const ViewCacheKey& other) const
+{
+    return std::memcmp(this, &other, sizeof(ViewCacheKey)) == 0;
+}
+
+size_t ViewCacheKey::Hash() const
+{
+    return static_cast<size_t>(HashBytes(this, sizeof(ViewCacheKey)));
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+﻿#pragma once
+#include <d3d11.h>
+
+#include "ObjectCache.h"
+
+//Key of a view in the view cache - its resource and full view description
+//An entry can't outlive its resource, since the view keeps the resource alive - it is removed when the view's last reference goes,
+//before the resource (and its address) can be destroyed or recycled
+
+
+enum VIEW_CACHE_TYPE
+{
+    VIEW_CACHE_SHADER_RESOURCE,
+    VIEW_CACHE_UNORDERED_ACCESS,
+    VIEW_CACHE_RENDER_TARGET,
+    VIEW_CACHE_DEPTH_STENCIL,
+};
+
+//Description type of each view interface
+template<typename T>
+struct ViewDescription;
+template<>
+struct ViewDescription<ID3D11ShaderResourceView> { using Type = D3D11_SHADER_RESOURCE_VIEW_DESC; };
+template<>
+struct ViewDescription<ID3D11UnorderedAccessView> { using Type = D3D11_UNORDERED_ACCESS_VIEW_DESC; };
+template<>
+struct ViewDescription<ID3D11RenderTargetView> { using Type = D3D11_RENDER_TARGET_VIEW_DESC; };
+template<>
+struct ViewDescription<ID3D11DepthStencilView> { using Type = D3D11_DEPTH_STENCIL_VIEW_DESC; };
+
+struct ViewCacheKey
+{
+    ID3D11Resource* resource;
+    VIEW_CACHE_TYPE type;
+    BOOL defaultDescription; //Created with a null description, i.e. a view of the whole resource in its own format
+    union
+    {
+        D3D11_SHADER_RESOURCE_VIEW_DESC shaderResource;
+        D3D11_UNORDERED_ACCESS_VIEW_DESC unorderedAccess;
+        D3D11_RENDER_TARGET_VIEW_DESC renderTarget;
+        D3D11_DEPTH_STENCIL_VIEW_DESC depthStencil;
+    };
+
+    //Keys are compared bytewise, so every byte the description doesn't cover is zeroed
+    [[nodiscard]] static ViewCacheKey Make(ID3D11Resource* resource, const D3D11_SHADER_RESOURCE_VIEW_DESC* desc);
+    [[nodiscard]] static ViewCacheKey Make(ID3D11Resource* resource, const D3D11_UNORDERED_ACCESS_VIEW_DESC* desc);
+    [[nodiscard]] static ViewCacheKey Make(ID3D11Resource* resource, const D3D11_RENDER_TARGET_VIEW_DESC* desc);
+    [[nodiscard]] static ViewCacheKey Make(ID3D11Resource* resource, const D3D11_DEPTH_STENCIL_VIEW_DESC* desc);
+
+    [[nodiscard]] bool operator==(const ViewCacheKey& other) const;
+    [[nodiscard]] size_t Hash() const;
+};
+
+//Views shared between identical Create*View() requests
+using ViewCache = ObjectCache<ViewCacheKey, ID3D11View>;
\ No newline at end of file